@@ -0,0 +1,755 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include "esp_timer.h"
+#include "uart_host.h"
+#include "esp32_driver_nextion/nextion.h"
+#include "esp32_driver_nextion/component.h"
+#include "esp32_driver_nextion/system.h"
+#include "esp32_driver_nextion/drawing.h"
+#include "esp32_driver_nextion/display_list.h"
+#include "esp32_driver_nextion/waveform.h"
+#include "esp32_driver_nextion/eeprom.h"
+#include "esp32_driver_nextion/rgb565/rgb565.h"
+#include "nextion_emulator/emulator.h"
+#include "nextion_emulator/pty.h"
+#include "nextion_emulator/test_hmi.h"
+
+#define BENCH_MAX_OPERATIONS 1000
+#define BENCH_MIN_OPERATIONS 3
+#define BENCH_MAX_BAUD_RATES 8
+#define BENCH_BLOCK_SIZE 16
+#define BENCH_SERIES_SIZE (NEX_WAVEFORM_STREAM_MAX_VALUES + BENCH_BLOCK_SIZE)
+#define BENCH_WAVEFORM_ID 7
+#define BENCH_EEPROM_ADDRESS 0
+#define BENCH_LIST_LINES 8
+#define BENCH_PIXELS 4096
+
+/**
+ * @typedef bench_operation_t
+ * @brief One measured operation.
+ * @param handle Nextion context pointer.
+ * @param iteration Operation index, starting at 0.
+ * @return NEX_OK if success, otherwise any other value.
+ */
+typedef nex_err_t (*bench_operation_t)(nextion_t *handle, size_t iteration);
+
+/**
+ * @struct bench_scenario_t
+ * @brief A named operation.
+ */
+typedef struct
+{
+    const char *name;            /** @brief Name, as written in the results. */
+    bench_operation_t operation; /** @brief Operation. */
+    bool is_gated;               /** @brief If a baseline rate drop fails the run; false for CPU-only kernels, whose rate depends on the host. */
+} bench_scenario_t;
+
+/**
+ * @struct bench_result_t
+ * @brief Measures of a scenario at a baud rate.
+ */
+typedef struct
+{
+    const char *name;       /** @brief Scenario name. */
+    bool is_gated;          /** @brief If it is compared with the baseline. */
+    uint32_t baud_rate;     /** @brief Baud rate of the link. */
+    size_t operations;      /** @brief How many operations were measured. */
+    double ops_per_sec;     /** @brief Operations per second. */
+    double commands_per_op; /** @brief Commands the display executed per operation. */
+    double bytes_per_op;    /** @brief Bytes on the wire, both ways, per operation. */
+    int64_t p50_us;         /** @brief Median latency. */
+    int64_t p99_us;         /** @brief 99th percentile latency. */
+    int64_t max_us;         /** @brief Worst latency. */
+} bench_result_t;
+
+/**
+ * @struct bench_t
+ * @brief Benchmark context.
+ */
+typedef struct
+{
+    nextion_t *handle;                       /** @brief Driver under test. */
+    nextion_emulator_pty_t *pty;             /** @brief Emulated display. */
+    int64_t time_budget_us;                  /** @brief Time spent on each scenario. */
+    int64_t latencies[BENCH_MAX_OPERATIONS]; /** @brief Latency of each operation of the current scenario. */
+} bench_t;
+
+static nex_err_t bench_component_set_value(nextion_t *handle, size_t iteration);
+static nex_err_t bench_component_get_text(nextion_t *handle, size_t iteration);
+static nex_err_t bench_system_get_number(nextion_t *handle, size_t iteration);
+static nex_err_t bench_draw_text(nextion_t *handle, size_t iteration);
+static nex_err_t bench_draw_display_list(nextion_t *handle, size_t iteration);
+static nex_err_t bench_waveform_add(nextion_t *handle, size_t iteration);
+static nex_err_t bench_waveform_addt(nextion_t *handle, size_t iteration);
+static nex_err_t bench_waveform_series(nextion_t *handle, size_t iteration);
+static nex_err_t bench_eeprom_rept(nextion_t *handle, size_t iteration);
+static nex_err_t bench_eeprom_wept(nextion_t *handle, size_t iteration);
+static nex_err_t bench_rgb565_per_pixel(nextion_t *handle, size_t iteration);
+static nex_err_t bench_rgb565_buffer(nextion_t *handle, size_t iteration);
+static nex_err_t bench_rgb565_buffer_dither(nextion_t *handle, size_t iteration);
+static nex_err_t bench_rgb565_buffer_hsv(nextion_t *handle, size_t iteration);
+static const uint8_t *bench_rgb565_source(void);
+static bool bench_run(bench_t *bench, const bench_scenario_t *scenario, uint32_t baud_rate, bench_result_t *result);
+static void bench_stats_get(bench_t *bench, nextion_emulator_stats_t *stats);
+static int bench_latency_compare(const void *a, const void *b);
+static void bench_results_write(FILE *file, const nextion_emulator_config_t *config, const bench_result_t *results, size_t count);
+static int bench_results_compare(const char *baseline_path, double tolerance, const bench_result_t *results, size_t count);
+static bool bench_json_find(const char *json, const char *name, uint32_t baud_rate, const char **begin, const char **end);
+static bool bench_json_number(const char *begin, const char *end, const char *key, double *value);
+
+/**
+ * @brief Last converted color read, so the conversions are not optimized away.
+ */
+static volatile rgb565_t bench_rgb565_sink;
+
+static const bench_scenario_t BENCH_SCENARIOS[] = {
+    {"component_set_value", bench_component_set_value, true},
+    {"component_get_text", bench_component_get_text, true},
+    {"system_get_number", bench_system_get_number, true},
+    {"draw_text", bench_draw_text, true},
+    {"draw_display_list", bench_draw_display_list, true},
+    {"waveform_add", bench_waveform_add, true},
+    {"waveform_addt", bench_waveform_addt, true},
+    {"waveform_series", bench_waveform_series, true},
+    {"eeprom_rept", bench_eeprom_rept, true},
+    {"eeprom_wept", bench_eeprom_wept, true},
+    {"rgb565_per_pixel", bench_rgb565_per_pixel, false},
+    {"rgb565_buffer", bench_rgb565_buffer, false},
+    {"rgb565_buffer_dither", bench_rgb565_buffer_dither, false},
+    {"rgb565_buffer_hsv", bench_rgb565_buffer_hsv, false}};
+
+#define BENCH_SCENARIO_COUNT (sizeof(BENCH_SCENARIOS) / sizeof(BENCH_SCENARIOS[0]))
+
+static void usage(const char *program)
+{
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "  --baud-rates LIST  comma separated baud rates (default 9600,115200,921600)\n"
+            "  --time-ms MS       time spent on each scenario and baud rate (default 1000)\n"
+            "  --latency-us US    display time to execute any command (default 0)\n"
+            "  --pixel-ns NS      display extra time per pixel drawn (default 0)\n"
+            "  --output PATH      write the JSON results to a file instead of stdout\n"
+            "  --baseline PATH    fail if the results are worse than a stored run\n"
+            "  --tolerance RATIO  how much slower than the baseline is accepted (default 0.25)\n",
+            program);
+}
+
+int main(int argc, char **argv)
+{
+    static const struct option options[] = {
+        {"baud-rates", required_argument, NULL, 'b'},
+        {"time-ms", required_argument, NULL, 't'},
+        {"latency-us", required_argument, NULL, 'l'},
+        {"pixel-ns", required_argument, NULL, 'p'},
+        {"output", required_argument, NULL, 'o'},
+        {"baseline", required_argument, NULL, 'c'},
+        {"tolerance", required_argument, NULL, 'r'},
+        {"help", no_argument, NULL, 'h'},
+        {NULL, 0, NULL, 0}};
+
+    nextion_emulator_config_t config = *nextion_emulator_test_hmi();
+    const nextion_emulator_pty_config_t line = NEXTION_EMULATOR_PTY_CONFIG_DEFAULT();
+    uint32_t baud_rates[BENCH_MAX_BAUD_RATES] = {9600, 115200, 921600};
+    size_t baud_rate_count = 3;
+    const char *output_path = NULL;
+    const char *baseline_path = NULL;
+    double tolerance = 0.25;
+    static bench_t bench = {.time_budget_us = 1000000};
+    int option;
+
+    while ((option = getopt_long(argc, argv, "h", options, NULL)) != -1)
+    {
+        switch (option)
+        {
+        case 'b':
+            baud_rate_count = 0;
+
+            for (char *item = strtok(optarg, ","); item != NULL && baud_rate_count < BENCH_MAX_BAUD_RATES; item = strtok(NULL, ","))
+            {
+                baud_rates[baud_rate_count++] = (uint32_t)strtoul(item, NULL, 10);
+            }
+            break;
+        case 't':
+            bench.time_budget_us = (int64_t)strtoul(optarg, NULL, 10) * 1000;
+            break;
+        case 'l':
+            config.command_latency_us = (uint32_t)strtoul(optarg, NULL, 10);
+            break;
+        case 'p':
+            config.pixel_time_ns = (uint32_t)strtoul(optarg, NULL, 10);
+            break;
+        case 'o':
+            output_path = optarg;
+            break;
+        case 'c':
+            baseline_path = optarg;
+            break;
+        case 'r':
+            tolerance = strtod(optarg, NULL);
+            break;
+        default:
+            usage(argv[0]);
+            return option == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    nextion_emulator_t *emulator = nextion_emulator_create(&config);
+    bench.pty = emulator == NULL ? NULL : nextion_emulator_pty_start(emulator, &line);
+
+    if (bench.pty == NULL || uart_host_set_device(UART_NUM_1, nextion_emulator_pty_get_path(bench.pty)) != ESP_OK)
+    {
+        fprintf(stderr, "failed starting the emulator\n");
+        return EXIT_FAILURE;
+    }
+
+    bench.handle = nextion_driver_install(UART_NUM_1, config.baud_rate, GPIO_NUM_NC, GPIO_NUM_NC);
+
+    if (bench.handle == NULL || nextion_init(bench.handle) != NEX_OK)
+    {
+        fprintf(stderr, "failed initializing the driver\n");
+        return EXIT_FAILURE;
+    }
+
+    static bench_result_t results[BENCH_MAX_BAUD_RATES * BENCH_SCENARIO_COUNT];
+    size_t result_count = 0;
+    int status = EXIT_SUCCESS;
+
+    for (size_t b = 0; b < baud_rate_count && status == EXIT_SUCCESS; b++)
+    {
+        if (nextion_baud_rate_set(bench.handle, baud_rates[b]) != NEX_OK)
+        {
+            fprintf(stderr, "failed changing the baud rate to %lu\n", (unsigned long)baud_rates[b]);
+            status = EXIT_FAILURE;
+            break;
+        }
+
+        for (size_t s = 0; s < BENCH_SCENARIO_COUNT; s++)
+        {
+            if (!bench_run(&bench, &BENCH_SCENARIOS[s], baud_rates[b], &results[result_count]))
+            {
+                fprintf(stderr, "%s failed at %lu\n", BENCH_SCENARIOS[s].name, (unsigned long)baud_rates[b]);
+                status = EXIT_FAILURE;
+                break;
+            }
+
+            result_count++;
+        }
+    }
+
+    nextion_driver_delete(bench.handle);
+    nextion_emulator_pty_stop(bench.pty);
+    nextion_emulator_delete(emulator);
+
+    FILE *output = output_path == NULL ? stdout : fopen(output_path, "w");
+
+    if (output == NULL)
+    {
+        fprintf(stderr, "failed opening %s\n", output_path);
+        return EXIT_FAILURE;
+    }
+
+    bench_results_write(output, &config, results, result_count);
+
+    if (output != stdout)
+    {
+        fclose(output);
+    }
+
+    if (status == EXIT_SUCCESS && baseline_path != NULL && bench_results_compare(baseline_path, tolerance, results, result_count) != 0)
+    {
+        status = EXIT_FAILURE;
+    }
+
+    return status;
+}
+
+/**
+ * @brief Set a number; it alternates, so the component cache never skips it.
+ */
+static nex_err_t bench_component_set_value(nextion_t *handle, size_t iteration)
+{
+    return nextion_component_set_value(handle, "n0", (iteration % 2) == 0 ? 100 : 200);
+}
+
+/**
+ * @brief Get a text.
+ */
+static nex_err_t bench_component_get_text(nextion_t *handle, size_t iteration)
+{
+    char text[16];
+    size_t length = sizeof(text) - 1;
+
+    return nextion_component_get_text(handle, "t0", text, &length);
+}
+
+/**
+ * @brief Get a system variable.
+ */
+static nex_err_t bench_system_get_number(nextion_t *handle, size_t iteration)
+{
+    int32_t number;
+
+    return nextion_system_get_number(handle, "get dim", &number);
+}
+
+/**
+ * @brief Draw a short text.
+ */
+static nex_err_t bench_draw_text(nextion_t *handle, size_t iteration)
+{
+    const area_t area = {.upper_left = {.x = 0, .y = 0}, .bottom_right = {.x = 100, .y = 20}};
+    const font_t font = {.id = 0, .color = RGB565_COLOR_WHITE};
+    const background_t background = {.fill_mode = BACKG_FILL_COLOR, .picture_id = 0, .color = RGB565_COLOR_BLACK};
+    const text_alignment_t alignment = {.horizontal = HORZ_ALIGN_LEFT, .vertical = VERT_ALIGN_CENTER};
+
+    return nextion_draw_text(handle, area, font, background, alignment, "Benchmark");
+}
+
+/**
+ * @brief Replay a recorded grid: a background and a few lines.
+ */
+static nex_err_t bench_draw_display_list(nextion_t *handle, size_t iteration)
+{
+    static uint8_t buffer[128];
+    static nextion_display_list_t list;
+
+    if (iteration == 0)
+    {
+        nextion_display_list_init(&list, buffer, sizeof(buffer));
+        nextion_display_list_fill_screen(&list, RGB565_COLOR_BLACK);
+
+        for (uint16_t i = 0; i < BENCH_LIST_LINES; i++)
+        {
+            const area_t line = {.upper_left = {.x = 0, .y = i * 20}, .bottom_right = {.x = 319, .y = i * 20}};
+
+            nextion_display_list_line(&list, line, RGB565_COLOR_GREEN);
+        }
+    }
+
+    return nextion_display_list_replay(handle, list.buffer, list.length);
+}
+
+/**
+ * @brief Add a block of samples, one "add" each.
+ */
+static nex_err_t bench_waveform_add(nextion_t *handle, size_t iteration)
+{
+    for (size_t i = 0; i < BENCH_BLOCK_SIZE; i++)
+    {
+        nex_err_t code = nextion_waveform_add_value(handle, BENCH_WAVEFORM_ID, 0, (uint8_t)(i * 8));
+
+        if (code != NEX_OK)
+        {
+            return code;
+        }
+    }
+
+    return NEX_OK;
+}
+
+/**
+ * @brief Add a block of samples with a single "addt".
+ */
+static nex_err_t bench_waveform_addt(nextion_t *handle, size_t iteration)
+{
+    uint8_t values[BENCH_BLOCK_SIZE];
+
+    for (size_t i = 0; i < BENCH_BLOCK_SIZE; i++)
+    {
+        values[i] = (uint8_t)(i * 8);
+    }
+
+    nex_err_t code = nextion_waveform_stream_begin(handle, BENCH_WAVEFORM_ID, 0, BENCH_BLOCK_SIZE);
+
+    if (code != NEX_OK)
+    {
+        return code;
+    }
+
+    code = nextion_waveform_stream_write_buffer(handle, values, BENCH_BLOCK_SIZE);
+    nex_err_t end_code = nextion_waveform_stream_end(handle);
+
+    return code != NEX_OK ? code : end_code;
+}
+
+/**
+ * @brief Push a series spanning two "addt" transactions.
+ */
+static nex_err_t bench_waveform_series(nextion_t *handle, size_t iteration)
+{
+    static uint8_t values[BENCH_SERIES_SIZE];
+
+    for (size_t i = 0; i < BENCH_SERIES_SIZE; i++)
+    {
+        values[i] = (uint8_t)(i + iteration);
+    }
+
+    return nextion_waveform_push_series(handle, BENCH_WAVEFORM_ID, 0, values, BENCH_SERIES_SIZE);
+}
+
+/**
+ * @brief Read a block of EEPROM bytes with "rept".
+ */
+static nex_err_t bench_eeprom_rept(nextion_t *handle, size_t iteration)
+{
+    uint8_t buffer[BENCH_BLOCK_SIZE];
+
+    return nextion_eeprom_read_bytes(handle, BENCH_EEPROM_ADDRESS, buffer, sizeof(buffer));
+}
+
+/**
+ * @brief Write a block of EEPROM bytes with "wept".
+ */
+static nex_err_t bench_eeprom_wept(nextion_t *handle, size_t iteration)
+{
+    uint8_t values[BENCH_BLOCK_SIZE];
+
+    memset(values, (int)(iteration & 0xFF), sizeof(values));
+
+    nex_err_t code = nextion_eeprom_stream_begin(handle, BENCH_EEPROM_ADDRESS, BENCH_BLOCK_SIZE);
+
+    if (code != NEX_OK)
+    {
+        return code;
+    }
+
+    code = nextion_eeprom_stream_write_buffer(handle, values, BENCH_BLOCK_SIZE);
+    nex_err_t end_code = nextion_eeprom_stream_end(handle);
+
+    return code != NEX_OK ? code : end_code;
+}
+
+/**
+ * @brief Convert pixels one call each; the display is not used.
+ */
+static nex_err_t bench_rgb565_per_pixel(nextion_t *handle, size_t iteration)
+{
+    static rgb565_t colors[BENCH_PIXELS];
+    const uint8_t *rgb = bench_rgb565_source();
+
+    for (size_t i = 0; i < BENCH_PIXELS; i++)
+    {
+        colors[i] = rgb565_convert_from_888(rgb[i * 3], rgb[i * 3 + 1], rgb[i * 3 + 2]);
+    }
+
+    bench_rgb565_sink = colors[iteration % BENCH_PIXELS];
+
+    return NEX_OK;
+}
+
+/**
+ * @brief Convert pixels in a buffer; the display is not used.
+ */
+static nex_err_t bench_rgb565_buffer(nextion_t *handle, size_t iteration)
+{
+    static rgb565_t colors[BENCH_PIXELS];
+
+    rgb565_convert_buffer_from_888(bench_rgb565_source(), colors, BENCH_PIXELS, NULL);
+    bench_rgb565_sink = colors[iteration % BENCH_PIXELS];
+
+    return NEX_OK;
+}
+
+/**
+ * @brief Convert pixels in a buffer, with gamma and ordered dithering; the display is not used.
+ */
+static nex_err_t bench_rgb565_buffer_dither(nextion_t *handle, size_t iteration)
+{
+    static rgb565_t colors[BENCH_PIXELS];
+    const rgb565_convert_config_t config = {.dither = RGB565_DITHER_ORDERED, .width = 64, .gamma = RGB565_GAMMA_22};
+
+    rgb565_convert_buffer_from_888(bench_rgb565_source(), colors, BENCH_PIXELS, &config);
+    bench_rgb565_sink = colors[iteration % BENCH_PIXELS];
+
+    return NEX_OK;
+}
+
+/**
+ * @brief Convert HSV pixels in a buffer; the display is not used.
+ */
+static nex_err_t bench_rgb565_buffer_hsv(nextion_t *handle, size_t iteration)
+{
+    static rgb565_t colors[BENCH_PIXELS];
+
+    rgb565_convert_buffer_from_hsv(bench_rgb565_source(), colors, BENCH_PIXELS, NULL);
+    bench_rgb565_sink = colors[iteration % BENCH_PIXELS];
+
+    return NEX_OK;
+}
+
+/**
+ * @brief Get the pixels the conversions start from, 3 bytes each.
+ * @return Pixels.
+ */
+static const uint8_t *bench_rgb565_source(void)
+{
+    static uint8_t pixels[BENCH_PIXELS * 3];
+    static bool is_filled = false;
+
+    if (!is_filled)
+    {
+        for (size_t i = 0; i < sizeof(pixels); i++)
+        {
+            pixels[i] = (uint8_t)((i * 7) ^ (i >> 5));
+        }
+
+        is_filled = true;
+    }
+
+    return pixels;
+}
+
+/**
+ * @brief Run a scenario until the time budget is spent.
+ * @details One unmeasured run comes first, so every measured one starts on a warm link.
+ * @param bench Benchmark context.
+ * @param scenario Scenario.
+ * @param baud_rate Current baud rate.
+ * @param result Location where the measures will be stored.
+ * @return True if every operation succeeded, otherwise false.
+ */
+static bool bench_run(bench_t *bench, const bench_scenario_t *scenario, uint32_t baud_rate, bench_result_t *result)
+{
+    if (scenario->operation(bench->handle, 0) != NEX_OK)
+    {
+        return false;
+    }
+
+    nextion_emulator_stats_t before;
+    nextion_emulator_stats_t after;
+    size_t count = 0;
+
+    bench_stats_get(bench, &before);
+
+    const int64_t started_at = esp_timer_get_time();
+    int64_t now = started_at;
+
+    while (count < BENCH_MAX_OPERATIONS && (count < BENCH_MIN_OPERATIONS || now - started_at < bench->time_budget_us))
+    {
+        if (scenario->operation(bench->handle, count + 1) != NEX_OK)
+        {
+            return false;
+        }
+
+        int64_t finished_at = esp_timer_get_time();
+
+        bench->latencies[count++] = finished_at - now;
+        now = finished_at;
+    }
+
+    // Asynchronous commands are part of the operations that queued them.
+    if (nextion_command_wait_all(bench->handle) != NEX_OK)
+    {
+        return false;
+    }
+
+    now = esp_timer_get_time();
+    bench_stats_get(bench, &after);
+
+    qsort(bench->latencies, count, sizeof(bench->latencies[0]), bench_latency_compare);
+
+    result->name = scenario->name;
+    result->is_gated = scenario->is_gated;
+    result->baud_rate = baud_rate;
+    result->operations = count;
+    result->ops_per_sec = (double)count * 1000000.0 / (double)(now - started_at);
+    result->commands_per_op = (double)(after.commands - before.commands) / (double)count;
+    result->bytes_per_op = (double)((after.bytes_received - before.bytes_received) + (after.bytes_sent - before.bytes_sent)) / (double)count;
+    result->p50_us = bench->latencies[(count - 1) / 2];
+    result->p99_us = bench->latencies[(count - 1) * 99 / 100];
+    result->max_us = bench->latencies[count - 1];
+
+    return true;
+}
+
+/**
+ * @brief Get the display counters.
+ * @param bench Benchmark context.
+ * @param stats Location where the counters will be stored.
+ */
+static void bench_stats_get(bench_t *bench, nextion_emulator_stats_t *stats)
+{
+    nextion_emulator_get_stats(nextion_emulator_pty_lock(bench->pty), stats);
+    nextion_emulator_pty_unlock(bench->pty);
+}
+
+static int bench_latency_compare(const void *a, const void *b)
+{
+    int64_t first = *(const int64_t *)a;
+    int64_t second = *(const int64_t *)b;
+
+    return (first > second) - (first < second);
+}
+
+/**
+ * @brief Write the results as JSON.
+ * @param file Destination.
+ * @param config Emulated display.
+ * @param results Results.
+ * @param count How many results there are.
+ */
+static void bench_results_write(FILE *file, const nextion_emulator_config_t *config, const bench_result_t *results, size_t count)
+{
+    fprintf(file,
+            "{\n"
+            "  \"display\": {\"command_latency_us\": %lu, \"pixel_time_ns\": %lu},\n"
+            "  \"results\": [\n",
+            (unsigned long)config->command_latency_us,
+            (unsigned long)config->pixel_time_ns);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        const bench_result_t *result = &results[i];
+
+        fprintf(file,
+                "    {\"name\": \"%s\", \"baud_rate\": %lu, \"operations\": %zu, \"ops_per_sec\": %.2f, "
+                "\"commands_per_op\": %.2f, \"bytes_per_op\": %.1f, \"p50_us\": %lld, \"p99_us\": %lld, \"max_us\": %lld}%s\n",
+                result->name,
+                (unsigned long)result->baud_rate,
+                result->operations,
+                result->ops_per_sec,
+                result->commands_per_op,
+                result->bytes_per_op,
+                (long long)result->p50_us,
+                (long long)result->p99_us,
+                (long long)result->max_us,
+                i + 1 < count ? "," : "");
+    }
+
+    fprintf(file, "  ]\n}\n");
+}
+
+/**
+ * @brief Compare the results with a stored run.
+ * @details A result regresses when its rate drops more than the tolerance,
+ * or when it puts more bytes on the wire; results missing from the baseline are new
+ * and only reported. CPU-only kernels are not compared: their rate is the host speed.
+ * @param baseline_path Stored results, as written by bench_results_write.
+ * @param tolerance Accepted rate drop, as a ratio.
+ * @param results Results.
+ * @param count How many results there are.
+ * @return How many results regressed, or -1 if the baseline could not be read.
+ */
+static int bench_results_compare(const char *baseline_path, double tolerance, const bench_result_t *results, size_t count)
+{
+    FILE *file = fopen(baseline_path, "r");
+
+    if (file == NULL)
+    {
+        fprintf(stderr, "failed opening %s\n", baseline_path);
+        return -1;
+    }
+
+    char *json = NULL;
+    size_t json_size = 0;
+    ssize_t read = getdelim(&json, &json_size, '\0', file);
+
+    fclose(file);
+
+    if (read <= 0)
+    {
+        free(json);
+        fprintf(stderr, "failed reading %s\n", baseline_path);
+        return -1;
+    }
+
+    int regressions = 0;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        const bench_result_t *result = &results[i];
+        const char *begin;
+        const char *end;
+        double ops_per_sec;
+        double bytes_per_op;
+
+        if (!result->is_gated)
+        {
+            continue;
+        }
+
+        if (!bench_json_find(json, result->name, result->baud_rate, &begin, &end) ||
+            !bench_json_number(begin, end, "ops_per_sec", &ops_per_sec) ||
+            !bench_json_number(begin, end, "bytes_per_op", &bytes_per_op))
+        {
+            fprintf(stderr, "%s at %lu: not in the baseline\n", result->name, (unsigned long)result->baud_rate);
+            continue;
+        }
+
+        // Bytes on the wire do not depend on the host; half a byte absorbs the rounding.
+
+        if (result->ops_per_sec < ops_per_sec * (1.0 - tolerance))
+        {
+            fprintf(stderr, "%s at %lu: %.1f ops/s, baseline %.1f\n", result->name, (unsigned long)result->baud_rate, result->ops_per_sec, ops_per_sec);
+            regressions++;
+        }
+        else if (result->bytes_per_op > bytes_per_op + 0.5)
+        {
+            fprintf(stderr, "%s at %lu: %.1f bytes/op, baseline %.1f\n", result->name, (unsigned long)result->baud_rate, result->bytes_per_op, bytes_per_op);
+            regressions++;
+        }
+    }
+
+    free(json);
+
+    return regressions;
+}
+
+/**
+ * @brief Find the result object of a scenario at a baud rate.
+ * @param json Results, as written by bench_results_write.
+ * @param name Scenario name.
+ * @param baud_rate Baud rate.
+ * @param begin Location where the object start will be stored.
+ * @param end Location where the object end will be stored.
+ * @return True if found, otherwise false.
+ */
+static bool bench_json_find(const char *json, const char *name, uint32_t baud_rate, const char **begin, const char **end)
+{
+    char pattern[64];
+
+    snprintf(pattern, sizeof(pattern), "\"name\": \"%s\"", name);
+
+    for (const char *found = strstr(json, pattern); found != NULL; found = strstr(found + 1, pattern))
+    {
+        const char *object_end = strchr(found, '}');
+        double value;
+
+        if (object_end != NULL && bench_json_number(found, object_end, "baud_rate", &value) && (uint32_t)value == baud_rate)
+        {
+            *begin = found;
+            *end = object_end;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Get a number member of a flat JSON object.
+ * @param begin Object start.
+ * @param end Object end.
+ * @param key Member name.
+ * @param value Location where the value will be stored.
+ * @return True if found, otherwise false.
+ */
+static bool bench_json_number(const char *begin, const char *end, const char *key, double *value)
+{
+    char pattern[64];
+    size_t pattern_length = (size_t)snprintf(pattern, sizeof(pattern), "\"%s\":", key);
+
+    for (const char *cursor = begin; cursor + pattern_length < end; cursor++)
+    {
+        if (memcmp(cursor, pattern, pattern_length) == 0)
+        {
+            *value = strtod(cursor + pattern_length, NULL);
+            return true;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,247 @@
+#ifndef __NEXTION_EMULATOR_EMULATOR_H__
+#define __NEXTION_EMULATOR_EMULATOR_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @struct nextion_emulator_area_t
+     * @brief Screen area, in pixels.
+     */
+    typedef struct
+    {
+        uint16_t x;      /** @brief Left coordinate. */
+        uint16_t y;      /** @brief Top coordinate. */
+        uint16_t width;  /** @brief Width. */
+        uint16_t height; /** @brief Height. */
+    } nextion_emulator_area_t;
+
+    /**
+     * @struct nextion_emulator_component_t
+     * @brief A component as placed in the editor.
+     */
+    typedef struct
+    {
+        const char *name;             /** @brief Object name. */
+        uint8_t id;                   /** @brief Object id; 0 is the page itself. */
+        bool has_value;               /** @brief If it has the "val" attribute. */
+        int32_t value;                /** @brief Initial "val". */
+        const char *text;             /** @brief Initial "txt", or NULL if it has no "txt" attribute. */
+        uint16_t text_max_length;     /** @brief The "txt_maxl" attribute. */
+        uint8_t channel_count;        /** @brief Waveform channels; 0 if not a waveform. */
+        nextion_emulator_area_t area; /** @brief Placement. */
+    } nextion_emulator_component_t;
+
+    /**
+     * @struct nextion_emulator_page_t
+     * @brief A page as designed in the editor.
+     */
+    typedef struct
+    {
+        const char *name;                               /** @brief Page name. */
+        const nextion_emulator_component_t *components; /** @brief Components. */
+        size_t component_count;                         /** @brief How many components there are. */
+    } nextion_emulator_page_t;
+
+    /**
+     * @struct nextion_emulator_resource_t
+     * @brief Picture or font stored in the HMI file.
+     */
+    typedef struct
+    {
+        uint16_t width;  /** @brief Width; for fonts, of one character. */
+        uint16_t height; /** @brief Height. */
+    } nextion_emulator_resource_t;
+
+    /**
+     * @struct nextion_emulator_config_t
+     * @brief The HMI file and the device characteristics.
+     */
+    typedef struct
+    {
+        uint16_t width;                                /** @brief Screen width. */
+        uint16_t height;                               /** @brief Screen height. */
+        const nextion_emulator_page_t *pages;          /** @brief Pages, by id. */
+        size_t page_count;                             /** @brief How many pages there are. */
+        const nextion_emulator_resource_t *pictures;   /** @brief Pictures, by id. */
+        size_t picture_count;                          /** @brief How many pictures there are. */
+        const nextion_emulator_resource_t *fonts;      /** @brief Fonts, by id. */
+        size_t font_count;                             /** @brief How many fonts there are. */
+        uint32_t baud_rate;                            /** @brief Power-on baud rate ("bauds"). */
+        uint32_t command_latency_us;                   /** @brief Time to execute any command. */
+        uint32_t pixel_time_ns;                        /** @brief Extra time per pixel drawn. */
+    } nextion_emulator_config_t;
+
+    /**
+     * @struct nextion_emulator_stats_t
+     * @brief Counters since the emulator was created.
+     */
+    typedef struct
+    {
+        uint64_t commands;       /** @brief Commands executed. */
+        uint64_t failures;       /** @brief Commands that failed. */
+        uint64_t bytes_received; /** @brief Bytes accepted from the serial line. */
+        uint64_t bytes_sent;     /** @brief Bytes queued for the serial line. */
+        uint64_t pixels_drawn;   /** @brief Pixels written to the frame buffer. */
+        uint64_t events;         /** @brief Touch and sleep events sent. */
+    } nextion_emulator_stats_t;
+
+    /**
+     * @typedef nextion_emulator_t
+     * @brief Emulated display.
+     */
+    typedef struct nextion_emulator_t nextion_emulator_t;
+
+    /**
+     * @brief Create a powered on display.
+     * @param config HMI and device configuration; must outlive the emulator.
+     * @return Emulator pointer, or NULL on failure.
+     */
+    nextion_emulator_t *nextion_emulator_create(const nextion_emulator_config_t *config);
+
+    /**
+     * @brief Delete an emulator.
+     * @param emulator Emulator pointer.
+     */
+    void nextion_emulator_delete(nextion_emulator_t *emulator);
+
+    /**
+     * @brief Feed bytes received from the serial line.
+     * @details Commands are executed one after another; each one starts when the
+     * previous one finishes, and its responses are ready when it finishes.
+     * @param emulator Emulator pointer.
+     * @param data Received bytes.
+     * @param length How many bytes.
+     * @param now_us When the last byte was received, in microseconds.
+     */
+    void nextion_emulator_receive(nextion_emulator_t *emulator, const uint8_t *data, size_t length, uint64_t now_us);
+
+    /**
+     * @brief Advance the timers that do not depend on input, as the automatic sleep.
+     * @param emulator Emulator pointer.
+     * @param now_us Current time, in microseconds.
+     */
+    void nextion_emulator_update(nextion_emulator_t *emulator, uint64_t now_us);
+
+    /**
+     * @brief Get when something happens without input: output ready or a timer expiring.
+     * @param emulator Emulator pointer.
+     * @return Time in microseconds, or UINT64_MAX if nothing is scheduled.
+     */
+    uint64_t nextion_emulator_next_event_time(const nextion_emulator_t *emulator);
+
+    /**
+     * @brief Take the oldest output that is ready.
+     * @param emulator Emulator pointer.
+     * @param now_us Current time, in microseconds.
+     * @param buffer Location where the bytes will be stored.
+     * @param capacity Buffer length.
+     * @param baud_rate Location where the baud rate it was sent at will be stored.
+     * @param ready_at_us Location where the time it became ready will be stored.
+     * @return How many bytes were taken; 0 if nothing is ready.
+     */
+    size_t nextion_emulator_transmit(nextion_emulator_t *emulator,
+                                     uint64_t now_us,
+                                     uint8_t *buffer,
+                                     size_t capacity,
+                                     uint32_t *baud_rate,
+                                     uint64_t *ready_at_us);
+
+    /**
+     * @brief Touch the screen.
+     * @param emulator Emulator pointer.
+     * @param x X coordinate.
+     * @param y Y coordinate.
+     * @param is_pressed True when pressing, false when releasing.
+     * @param now_us Current time, in microseconds.
+     */
+    void nextion_emulator_touch(nextion_emulator_t *emulator, uint16_t x, uint16_t y, bool is_pressed, uint64_t now_us);
+
+    /**
+     * @brief Touch the center of a component of the current page.
+     * @param emulator Emulator pointer.
+     * @param component_id Component id.
+     * @param is_pressed True when pressing, false when releasing.
+     * @param now_us Current time, in microseconds.
+     * @return True if the component exists, otherwise false.
+     */
+    bool nextion_emulator_touch_component(nextion_emulator_t *emulator, uint8_t component_id, bool is_pressed, uint64_t now_us);
+
+    /**
+     * @brief Get the baud rate the display is listening at.
+     * @param emulator Emulator pointer.
+     * @return Baud rate.
+     */
+    uint32_t nextion_emulator_get_baud_rate(const nextion_emulator_t *emulator);
+
+    /**
+     * @brief Get the current page id.
+     * @param emulator Emulator pointer.
+     * @return Page id.
+     */
+    uint8_t nextion_emulator_get_page(const nextion_emulator_t *emulator);
+
+    /**
+     * @brief Check if the display is sleeping.
+     * @param emulator Emulator pointer.
+     * @return True if sleeping, otherwise false.
+     */
+    bool nextion_emulator_is_sleeping(const nextion_emulator_t *emulator);
+
+    /**
+     * @brief Get the counters.
+     * @param emulator Emulator pointer.
+     * @param stats Location where the counters will be stored.
+     */
+    void nextion_emulator_get_stats(const nextion_emulator_t *emulator, nextion_emulator_stats_t *stats);
+
+    /**
+     * @brief Get the frame buffer, in RGB565, row after row.
+     * @param emulator Emulator pointer.
+     * @return Frame buffer of width x height pixels.
+     */
+    const uint16_t *nextion_emulator_get_framebuffer(const nextion_emulator_t *emulator);
+
+    /**
+     * @brief Get the EEPROM contents.
+     * @param emulator Emulator pointer.
+     * @return EEPROM of NEX_DVC_EEPROM_SIZE bytes.
+     */
+    const uint8_t *nextion_emulator_get_eeprom(const nextion_emulator_t *emulator);
+
+    /**
+     * @brief Get the "val" of a component of the current page.
+     * @param emulator Emulator pointer.
+     * @param component_name Component name.
+     * @param value Location where the value will be stored.
+     * @return True if the component has a "val", otherwise false.
+     */
+    bool nextion_emulator_get_value(const nextion_emulator_t *emulator, const char *component_name, int32_t *value);
+
+    /**
+     * @brief Get the "txt" of a component of the current page.
+     * @param emulator Emulator pointer.
+     * @param component_name Component name.
+     * @return Text, or NULL if the component has no "txt".
+     */
+    const char *nextion_emulator_get_text(const nextion_emulator_t *emulator, const char *component_name);
+
+    /**
+     * @brief Get how many samples were added to a waveform channel of the current page.
+     * @param emulator Emulator pointer.
+     * @param component_id Waveform id.
+     * @param channel Channel.
+     * @return Sample count.
+     */
+    uint64_t nextion_emulator_get_sample_count(const nextion_emulator_t *emulator, uint8_t component_id, uint8_t channel);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,80 @@
+#ifndef __NEXTION_EMULATOR_PTY_H__
+#define __NEXTION_EMULATOR_PTY_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "nextion_emulator/emulator.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @struct nextion_emulator_pty_config_t
+     * @brief Serial line behaviour.
+     */
+    typedef struct
+    {
+        uint8_t frame_bits;         /** @brief Bits a byte takes on the line: start, data, parity and stop bits. */
+        bool ignore_line_baud_rate; /** @brief If bytes go through whatever the baud rate the other side set. */
+    } nextion_emulator_pty_config_t;
+
+    /**
+     * @brief Default configuration: 8N1 and matching baud rates required.
+     */
+#define NEXTION_EMULATOR_PTY_CONFIG_DEFAULT() {.frame_bits = 10, .ignore_line_baud_rate = false}
+
+    /**
+     * @typedef nextion_emulator_pty_t
+     * @brief An emulator wired to a pseudo-terminal.
+     */
+    typedef struct nextion_emulator_pty_t nextion_emulator_pty_t;
+
+    /**
+     * @brief Create a pseudo-terminal and serve the emulator on it from a thread.
+     * @details The pseudo-terminal carries no signal, so the line is emulated: bytes are paced
+     * at the baud rate and, unless configured otherwise, bytes sent while the baud rate set
+     * on the other side differs from the emulator one are lost, as garbage would be.
+     * @param emulator Emulator; it is owned by the caller and must outlive the runner.
+     * @param config Line configuration.
+     * @return Runner pointer, or NULL on failure.
+     */
+    nextion_emulator_pty_t *nextion_emulator_pty_start(nextion_emulator_t *emulator, const nextion_emulator_pty_config_t *config);
+
+    /**
+     * @brief Stop serving and close the pseudo-terminal.
+     * @param pty Runner pointer.
+     */
+    void nextion_emulator_pty_stop(nextion_emulator_pty_t *pty);
+
+    /**
+     * @brief Get the path of the terminal to open, as a serial port.
+     * @param pty Runner pointer.
+     * @return Path.
+     */
+    const char *nextion_emulator_pty_get_path(const nextion_emulator_pty_t *pty);
+
+    /**
+     * @brief Get exclusive access to the emulator, e.g. to touch it or read its state.
+     * @param pty Runner pointer.
+     * @return Emulator pointer.
+     */
+    nextion_emulator_t *nextion_emulator_pty_lock(nextion_emulator_pty_t *pty);
+
+    /**
+     * @brief Release the emulator and let the runner send what became ready.
+     * @param pty Runner pointer.
+     */
+    void nextion_emulator_pty_unlock(nextion_emulator_pty_t *pty);
+
+    /**
+     * @brief Get the time base used by the runner.
+     * @return Monotonic time in microseconds.
+     */
+    uint64_t nextion_emulator_pty_clock_us(void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,22 @@
+#ifndef __NEXTION_EMULATOR_TEST_HMI_H__
+#define __NEXTION_EMULATOR_TEST_HMI_H__
+
+#include "nextion_emulator/emulator.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief Get the HMI the driver tests were written against (test/hmi).
+     * @details 480x272, two pages; page 0 holds t0, n0, c0, b0, x0, r0 and the waveform s0 (id 7, 4 channels).
+     * Pictures and the font have the sizes of the files in test/hmi. Power-on baud rate is 9600.
+     * @return Configuration.
+     */
+    const nextion_emulator_config_t *nextion_emulator_test_hmi(void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,1991 @@
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <limits.h>
+#include "esp32_driver_nextion/base/codes.h"
+#include "esp32_driver_nextion/base/constants.h"
+#include "nextion_emulator/emulator.h"
+
+/**
+ * @brief Longest command accepted; longer ones are discarded.
+ */
+#define NEX_EMU_COMMAND_MAX_LENGTH 1024U
+
+/**
+ * @brief Maximum number of arguments of a command.
+ */
+#define NEX_EMU_ARGUMENT_MAX_COUNT 16U
+
+/**
+ * @brief Time the display takes to start after a reset, in microseconds.
+ */
+#define NEX_EMU_RESET_TIME_US 50000U
+
+/**
+ * @brief Time the display takes to enter the "Transparent Data" mode, in microseconds.
+ */
+#define NEX_EMU_TRANSPARENT_DATA_WAIT_TIME_US (NEX_DVC_TRANSPARENT_DATA_WAIT_TIME_MS * 1000U)
+
+/**
+ * @brief Internal code meaning "nothing to acknowledge".
+ */
+#define NEX_EMU_SILENT 0xFFU
+
+/**
+ * @brief Maximum value of "dim" and "dims".
+ */
+#define NEX_EMU_BRIGHTNESS_MAX 100
+
+/**
+ * @brief Baud rates accepted by "baud" and "bauds".
+ */
+static const uint32_t NEX_EMU_BAUD_RATES[] = {2400, 4800, 9600, 19200, 31250, 38400, 57600, 115200, 230400, 250000, 256000, 512000, 921600};
+
+/**
+ * @enum nextion_emulator_system_t
+ * @brief System variables.
+ */
+typedef enum
+{
+    NEX_EMU_SYS_DIM,
+    NEX_EMU_SYS_DIMS,
+    NEX_EMU_SYS_BKCMD,
+    NEX_EMU_SYS_THSP,
+    NEX_EMU_SYS_USSP,
+    NEX_EMU_SYS_THUP,
+    NEX_EMU_SYS_USUP,
+    NEX_EMU_SYS_SENDXY,
+    NEX_EMU_SYS_SLEEP,
+    NEX_EMU_SYS_BAUD,
+    NEX_EMU_SYS_BAUDS,
+    NEX_EMU_SYS_DP,
+    NEX_EMU_SYS_SYS0,
+    NEX_EMU_SYS_SYS1,
+    NEX_EMU_SYS_SYS2,
+    NEX_EMU_SYS_COUNT
+} nextion_emulator_system_t;
+
+static const char *const NEX_EMU_SYSTEM_NAMES[NEX_EMU_SYS_COUNT] = {
+    "dim", "dims", "bkcmd", "thsp", "ussp", "thup", "usup", "sendxy", "sleep", "baud", "bauds", "dp", "sys0", "sys1", "sys2"};
+
+/**
+ * @brief Numeric attributes every component accepts besides "val", "txt", "id" and "txt_maxl".
+ */
+static const char *const NEX_EMU_ATTRIBUTE_NAMES[] = {
+    "x", "y", "w", "h", "pco", "bco", "pco2", "bco2", "font", "pic", "pic2", "picc", "picc2",
+    "xcen", "ycen", "sta", "style", "en", "tim", "dis", "wid", "hig", "dir", "pw", "spax", "spay", "isbr"};
+
+#define NEX_EMU_ATTRIBUTE_COUNT (sizeof(NEX_EMU_ATTRIBUTE_NAMES) / sizeof(NEX_EMU_ATTRIBUTE_NAMES[0]))
+
+/**
+ * @struct nextion_emulator_output_t
+ * @brief Bytes waiting to be sent.
+ */
+typedef struct nextion_emulator_output_t
+{
+    struct nextion_emulator_output_t *next; /** @brief Next output. */
+    uint64_t ready_at_us;                   /** @brief When it can be sent. */
+    uint32_t baud_rate;                     /** @brief Baud rate it is sent at. */
+    size_t length;                          /** @brief How many bytes. */
+    size_t offset;                          /** @brief How many bytes were already taken. */
+    uint8_t data[];                         /** @brief Bytes. */
+} nextion_emulator_output_t;
+
+/**
+ * @struct nextion_emulator_object_t
+ * @brief Runtime state of a component.
+ */
+typedef struct
+{
+    const nextion_emulator_component_t *definition; /** @brief Component as designed. */
+    int32_t value;                                  /** @brief The "val" attribute. */
+    char *text;                                     /** @brief The "txt" attribute, or NULL. */
+    bool is_visible;                                /** @brief If it is shown. */
+    bool is_touchable;                              /** @brief If it reacts to touch. */
+    int32_t attributes[NEX_EMU_ATTRIBUTE_COUNT];    /** @brief Other numeric attributes. */
+    uint64_t *sample_counts;                        /** @brief Samples added per waveform channel. */
+} nextion_emulator_object_t;
+
+/**
+ * @enum nextion_emulator_reference_kind_t
+ * @brief What a variable name refers to.
+ */
+typedef enum
+{
+    NEX_EMU_REF_SYSTEM,
+    NEX_EMU_REF_VALUE,
+    NEX_EMU_REF_TEXT,
+    NEX_EMU_REF_ID,
+    NEX_EMU_REF_TEXT_MAX_LENGTH,
+    NEX_EMU_REF_ATTRIBUTE
+} nextion_emulator_reference_kind_t;
+
+/**
+ * @struct nextion_emulator_reference_t
+ * @brief A resolved variable.
+ */
+typedef struct
+{
+    nextion_emulator_reference_kind_t kind; /** @brief What it refers to. */
+    nextion_emulator_object_t *object;      /** @brief Component, if any. */
+    size_t index;                           /** @brief System variable or attribute index. */
+} nextion_emulator_reference_t;
+
+/**
+ * @struct nextion_emulator_value_t
+ * @brief An evaluated argument.
+ */
+typedef struct
+{
+    bool is_text;     /** @brief If it is a text, otherwise a number. */
+    int32_t number;   /** @brief Number. */
+    const char *text; /** @brief Null-terminated text. */
+} nextion_emulator_value_t;
+
+/**
+ * @enum nextion_emulator_transparent_t
+ * @brief What the "Transparent Data" mode bytes are for.
+ */
+typedef enum
+{
+    NEX_EMU_TRANSPARENT_NONE,
+    NEX_EMU_TRANSPARENT_EEPROM,
+    NEX_EMU_TRANSPARENT_WAVEFORM
+} nextion_emulator_transparent_t;
+
+struct nextion_emulator_t
+{
+    const nextion_emulator_config_t *config;            /** @brief HMI and device configuration. */
+    nextion_emulator_object_t **objects;                /** @brief Components, per page. */
+    uint16_t *framebuffer;                              /** @brief Screen. */
+    uint8_t eeprom[NEX_DVC_EEPROM_SIZE];                /** @brief EEPROM. */
+    int32_t system[NEX_EMU_SYS_COUNT];                  /** @brief System variables. */
+    bool is_refresh_stopped;                            /** @brief If "ref_stop" is in effect. */
+    char command[NEX_EMU_COMMAND_MAX_LENGTH + 1];       /** @brief Command being received. */
+    size_t command_length;                              /** @brief Command length. */
+    bool is_command_overflowed;                         /** @brief If the command was longer than the buffer. */
+    uint8_t end_count;                                  /** @brief How many 0xFF were received in a row. */
+    char texts[NEX_EMU_COMMAND_MAX_LENGTH + NEX_EMU_ARGUMENT_MAX_COUNT]; /** @brief Decoded string arguments. */
+    size_t texts_length;                                /** @brief Used length of the decoded string arguments. */
+    nextion_emulator_transparent_t transparent;         /** @brief Current "Transparent Data" mode use. */
+    uint8_t transparent_data[NEX_DVC_TRANSPARENT_DATA_MAX_DATA_SIZE]; /** @brief Bytes received in "Transparent Data" mode. */
+    size_t transparent_expected;                        /** @brief How many bytes are expected. */
+    size_t transparent_received;                        /** @brief How many bytes were received. */
+    uint16_t transparent_address;                       /** @brief EEPROM address. */
+    nextion_emulator_object_t *transparent_waveform;    /** @brief Waveform. */
+    uint8_t transparent_channel;                        /** @brief Waveform channel. */
+    uint64_t busy_until_us;                             /** @brief When the last command finishes. */
+    uint64_t reset_until_us;                            /** @brief When the display is started after a reset. */
+    uint64_t last_touch_us;                             /** @brief Last touch, for "thsp". */
+    uint64_t last_serial_us;                            /** @brief Last byte received, for "ussp". */
+    uint64_t pixels;                                    /** @brief Pixels drawn by the command being executed. */
+    uint64_t delay_us;                                  /** @brief Pause asked by the command being executed, with "delay". */
+    bool in_command;                                    /** @brief If a command is being executed. */
+    nextion_emulator_output_t *staged;                  /** @brief Output of the command being executed. */
+    nextion_emulator_output_t *outputs;                 /** @brief Output waiting to be sent, by ready time. */
+    nextion_emulator_stats_t stats;                     /** @brief Counters. */
+};
+
+static void nextion_emulator_power_on(nextion_emulator_t *emulator);
+static void nextion_emulator_page_load(nextion_emulator_t *emulator, uint8_t page_id);
+static void nextion_emulator_receive_byte(nextion_emulator_t *emulator, uint8_t byte, uint64_t now_us);
+static void nextion_emulator_transparent_receive(nextion_emulator_t *emulator, uint8_t byte, uint64_t now_us);
+static void nextion_emulator_command_run(nextion_emulator_t *emulator, uint64_t now_us);
+static uint8_t nextion_emulator_command_execute(nextion_emulator_t *emulator, char *command);
+static uint8_t nextion_emulator_assign(nextion_emulator_t *emulator, char *target, char *expression);
+static uint8_t nextion_emulator_system_set(nextion_emulator_t *emulator, size_t index, int32_t number);
+static size_t nextion_emulator_split(char *arguments, char **tokens, size_t capacity);
+static char *nextion_emulator_trim(char *text);
+static uint8_t nextion_emulator_evaluate(nextion_emulator_t *emulator, char *token, nextion_emulator_value_t *value);
+static uint8_t nextion_emulator_number(nextion_emulator_t *emulator, char *token, int32_t *number);
+static bool nextion_emulator_parse_integer(const char *token, int32_t *number);
+static uint8_t nextion_emulator_resolve(nextion_emulator_t *emulator, char *name, nextion_emulator_reference_t *reference);
+static nextion_emulator_object_t *nextion_emulator_object_find(nextion_emulator_t *emulator, uint8_t page_id, const char *name);
+static nextion_emulator_object_t *nextion_emulator_object_by_id(nextion_emulator_t *emulator, uint8_t page_id, int32_t id);
+static nextion_emulator_object_t *nextion_emulator_waveform_find(nextion_emulator_t *emulator, int32_t id, int32_t channel);
+static void nextion_emulator_acknowledge(nextion_emulator_t *emulator, uint8_t code);
+static void nextion_emulator_emit(nextion_emulator_t *emulator, uint64_t at_us, const uint8_t *data, size_t length);
+static void nextion_emulator_emit_code(nextion_emulator_t *emulator, uint64_t at_us, uint8_t code);
+static void nextion_emulator_output_insert(nextion_emulator_t *emulator, nextion_emulator_output_t *output);
+static void nextion_emulator_output_clear(nextion_emulator_output_t **list);
+static void nextion_emulator_fill(nextion_emulator_t *emulator, int32_t x, int32_t y, int32_t width, int32_t height, uint16_t color);
+static void nextion_emulator_plot(nextion_emulator_t *emulator, int32_t x, int32_t y, uint16_t color);
+static void nextion_emulator_line(nextion_emulator_t *emulator, int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint16_t color);
+static void nextion_emulator_circle(nextion_emulator_t *emulator, int32_t cx, int32_t cy, int32_t radius, uint16_t color, bool is_filled);
+static uint16_t nextion_emulator_picture_color(int32_t picture_id);
+static bool nextion_emulator_is_asleep_wakeable(const nextion_emulator_t *emulator);
+
+nextion_emulator_t *nextion_emulator_create(const nextion_emulator_config_t *config)
+{
+    if (config == NULL || config->width == 0 || config->height == 0 || config->page_count == 0)
+    {
+        return NULL;
+    }
+
+    nextion_emulator_t *emulator = (nextion_emulator_t *)calloc(1, sizeof(nextion_emulator_t));
+
+    if (emulator == NULL)
+    {
+        return NULL;
+    }
+
+    emulator->config = config;
+    emulator->framebuffer = (uint16_t *)calloc((size_t)config->width * config->height, sizeof(uint16_t));
+    emulator->objects = (nextion_emulator_object_t **)calloc(config->page_count, sizeof(nextion_emulator_object_t *));
+
+    for (size_t page = 0; page < config->page_count; page++)
+    {
+        const nextion_emulator_page_t *definition = &config->pages[page];
+
+        emulator->objects[page] = (nextion_emulator_object_t *)calloc(definition->component_count + 1, sizeof(nextion_emulator_object_t));
+
+        for (size_t i = 0; i < definition->component_count; i++)
+        {
+            const nextion_emulator_component_t *component = &definition->components[i];
+            nextion_emulator_object_t *object = &emulator->objects[page][i];
+
+            object->definition = component;
+
+            if (component->text != NULL)
+            {
+                object->text = (char *)calloc((size_t)component->text_max_length + 1, sizeof(char));
+            }
+
+            if (component->channel_count > 0)
+            {
+                object->sample_counts = (uint64_t *)calloc(component->channel_count, sizeof(uint64_t));
+            }
+        }
+    }
+
+    emulator->system[NEX_EMU_SYS_DIMS] = NEX_EMU_BRIGHTNESS_MAX;
+    emulator->system[NEX_EMU_SYS_BAUDS] = (int32_t)config->baud_rate;
+
+    memset(emulator->eeprom, 0xFF, sizeof(emulator->eeprom));
+
+    nextion_emulator_power_on(emulator);
+
+    return emulator;
+}
+
+void nextion_emulator_delete(nextion_emulator_t *emulator)
+{
+    if (emulator == NULL)
+    {
+        return;
+    }
+
+    for (size_t page = 0; page < emulator->config->page_count; page++)
+    {
+        for (size_t i = 0; i < emulator->config->pages[page].component_count; i++)
+        {
+            free(emulator->objects[page][i].text);
+            free(emulator->objects[page][i].sample_counts);
+        }
+
+        free(emulator->objects[page]);
+    }
+
+    nextion_emulator_output_clear(&emulator->staged);
+    nextion_emulator_output_clear(&emulator->outputs);
+
+    free(emulator->objects);
+    free(emulator->framebuffer);
+    free(emulator);
+}
+
+void nextion_emulator_receive(nextion_emulator_t *emulator, const uint8_t *data, size_t length, uint64_t now_us)
+{
+    for (size_t i = 0; i < length; i++)
+    {
+        nextion_emulator_receive_byte(emulator, data[i], now_us);
+    }
+}
+
+void nextion_emulator_update(nextion_emulator_t *emulator, uint64_t now_us)
+{
+    if (emulator->system[NEX_EMU_SYS_SLEEP] || now_us < emulator->reset_until_us)
+    {
+        return;
+    }
+
+    uint64_t touch_deadline = emulator->last_touch_us + (uint64_t)emulator->system[NEX_EMU_SYS_THSP] * 1000000U;
+    uint64_t serial_deadline = emulator->last_serial_us + (uint64_t)emulator->system[NEX_EMU_SYS_USSP] * 1000000U;
+
+    if ((emulator->system[NEX_EMU_SYS_THSP] > 0 && now_us >= touch_deadline) ||
+        (emulator->system[NEX_EMU_SYS_USSP] > 0 && now_us >= serial_deadline))
+    {
+        emulator->system[NEX_EMU_SYS_SLEEP] = 1;
+        emulator->stats.events++;
+
+        nextion_emulator_emit_code(emulator, now_us, NEX_DVC_EVT_HARDWARE_AUTO_SLEEP);
+    }
+}
+
+uint64_t nextion_emulator_next_event_time(const nextion_emulator_t *emulator)
+{
+    uint64_t next = emulator->outputs != NULL ? emulator->outputs->ready_at_us : UINT64_MAX;
+
+    if (emulator->system[NEX_EMU_SYS_SLEEP])
+    {
+        return next;
+    }
+
+    if (emulator->system[NEX_EMU_SYS_THSP] > 0)
+    {
+        uint64_t deadline = emulator->last_touch_us + (uint64_t)emulator->system[NEX_EMU_SYS_THSP] * 1000000U;
+
+        next = deadline < next ? deadline : next;
+    }
+
+    if (emulator->system[NEX_EMU_SYS_USSP] > 0)
+    {
+        uint64_t deadline = emulator->last_serial_us + (uint64_t)emulator->system[NEX_EMU_SYS_USSP] * 1000000U;
+
+        next = deadline < next ? deadline : next;
+    }
+
+    return next;
+}
+
+size_t nextion_emulator_transmit(nextion_emulator_t *emulator,
+                                 uint64_t now_us,
+                                 uint8_t *buffer,
+                                 size_t capacity,
+                                 uint32_t *baud_rate,
+                                 uint64_t *ready_at_us)
+{
+    nextion_emulator_output_t *output = emulator->outputs;
+
+    if (output == NULL || output->ready_at_us > now_us || capacity == 0)
+    {
+        return 0;
+    }
+
+    size_t count = output->length - output->offset;
+
+    count = count < capacity ? count : capacity;
+
+    memcpy(buffer, output->data + output->offset, count);
+
+    *baud_rate = output->baud_rate;
+    *ready_at_us = output->ready_at_us;
+
+    output->offset += count;
+
+    if (output->offset == output->length)
+    {
+        emulator->outputs = output->next;
+
+        free(output);
+    }
+
+    return count;
+}
+
+void nextion_emulator_touch(nextion_emulator_t *emulator, uint16_t x, uint16_t y, bool is_pressed, uint64_t now_us)
+{
+    if (now_us < emulator->reset_until_us)
+    {
+        return;
+    }
+
+    emulator->last_touch_us = now_us;
+
+    const uint8_t coordinates[] = {(uint8_t)(x >> 8), (uint8_t)x, (uint8_t)(y >> 8), (uint8_t)y, is_pressed};
+
+    if (emulator->system[NEX_EMU_SYS_SLEEP])
+    {
+        if (emulator->system[NEX_EMU_SYS_SENDXY])
+        {
+            const uint8_t event[] = {NEX_DVC_EVT_TOUCH_COORDINATE_ASLEEP, coordinates[0], coordinates[1], coordinates[2], coordinates[3], coordinates[4], NEX_DVC_CMD_END_SEQUENCE};
+
+            emulator->stats.events++;
+
+            nextion_emulator_emit(emulator, now_us, event, sizeof(event));
+        }
+
+        if (emulator->system[NEX_EMU_SYS_THUP])
+        {
+            emulator->system[NEX_EMU_SYS_SLEEP] = 0;
+            emulator->stats.events++;
+
+            nextion_emulator_emit_code(emulator, now_us, NEX_DVC_EVT_HARDWARE_AUTO_WAKE);
+        }
+
+        return;
+    }
+
+    if (emulator->system[NEX_EMU_SYS_SENDXY])
+    {
+        const uint8_t event[] = {NEX_DVC_EVT_TOUCH_COORDINATE_AWAKE, coordinates[0], coordinates[1], coordinates[2], coordinates[3], coordinates[4], NEX_DVC_CMD_END_SEQUENCE};
+
+        emulator->stats.events++;
+
+        nextion_emulator_emit(emulator, now_us, event, sizeof(event));
+    }
+
+    // The last placed component is on top.
+
+    uint8_t page = (uint8_t)emulator->system[NEX_EMU_SYS_DP];
+    const nextion_emulator_page_t *definition = &emulator->config->pages[page];
+
+    for (size_t i = definition->component_count; i > 0; i--)
+    {
+        const nextion_emulator_object_t *object = &emulator->objects[page][i - 1];
+        const nextion_emulator_area_t *area = &object->definition->area;
+
+        if (object->is_visible && object->is_touchable &&
+            x >= area->x && x < area->x + area->width && y >= area->y && y < area->y + area->height)
+        {
+            const uint8_t event[] = {NEX_DVC_EVT_TOUCH_OCCURRED, page, object->definition->id, is_pressed, NEX_DVC_CMD_END_SEQUENCE};
+
+            emulator->stats.events++;
+
+            nextion_emulator_emit(emulator, now_us, event, sizeof(event));
+
+            return;
+        }
+    }
+}
+
+bool nextion_emulator_touch_component(nextion_emulator_t *emulator, uint8_t component_id, bool is_pressed, uint64_t now_us)
+{
+    nextion_emulator_object_t *object = nextion_emulator_object_by_id(emulator, (uint8_t)emulator->system[NEX_EMU_SYS_DP], component_id);
+
+    if (object == NULL)
+    {
+        return false;
+    }
+
+    const nextion_emulator_area_t *area = &object->definition->area;
+
+    nextion_emulator_touch(emulator, (uint16_t)(area->x + area->width / 2), (uint16_t)(area->y + area->height / 2), is_pressed, now_us);
+
+    return true;
+}
+
+uint32_t nextion_emulator_get_baud_rate(const nextion_emulator_t *emulator)
+{
+    return (uint32_t)emulator->system[NEX_EMU_SYS_BAUD];
+}
+
+uint8_t nextion_emulator_get_page(const nextion_emulator_t *emulator)
+{
+    return (uint8_t)emulator->system[NEX_EMU_SYS_DP];
+}
+
+bool nextion_emulator_is_sleeping(const nextion_emulator_t *emulator)
+{
+    return emulator->system[NEX_EMU_SYS_SLEEP] != 0;
+}
+
+void nextion_emulator_get_stats(const nextion_emulator_t *emulator, nextion_emulator_stats_t *stats)
+{
+    *stats = emulator->stats;
+}
+
+const uint16_t *nextion_emulator_get_framebuffer(const nextion_emulator_t *emulator)
+{
+    return emulator->framebuffer;
+}
+
+const uint8_t *nextion_emulator_get_eeprom(const nextion_emulator_t *emulator)
+{
+    return emulator->eeprom;
+}
+
+bool nextion_emulator_get_value(const nextion_emulator_t *emulator, const char *component_name, int32_t *value)
+{
+    nextion_emulator_object_t *object = nextion_emulator_object_find((nextion_emulator_t *)emulator, (uint8_t)emulator->system[NEX_EMU_SYS_DP], component_name);
+
+    if (object == NULL || !object->definition->has_value)
+    {
+        return false;
+    }
+
+    *value = object->value;
+
+    return true;
+}
+
+const char *nextion_emulator_get_text(const nextion_emulator_t *emulator, const char *component_name)
+{
+    nextion_emulator_object_t *object = nextion_emulator_object_find((nextion_emulator_t *)emulator, (uint8_t)emulator->system[NEX_EMU_SYS_DP], component_name);
+
+    return object == NULL ? NULL : object->text;
+}
+
+uint64_t nextion_emulator_get_sample_count(const nextion_emulator_t *emulator, uint8_t component_id, uint8_t channel)
+{
+    nextion_emulator_object_t *object = nextion_emulator_waveform_find((nextion_emulator_t *)emulator, component_id, channel);
+
+    return object == NULL ? 0 : object->sample_counts[channel];
+}
+
+/**
+ * @brief Bring the display to its power-on state; EEPROM, "dims" and "bauds" are kept.
+ * @param emulator Emulator pointer.
+ */
+static void nextion_emulator_power_on(nextion_emulator_t *emulator)
+{
+    int32_t dims = emulator->system[NEX_EMU_SYS_DIMS];
+    int32_t bauds = emulator->system[NEX_EMU_SYS_BAUDS];
+
+    memset(emulator->system, 0, sizeof(emulator->system));
+
+    emulator->system[NEX_EMU_SYS_DIM] = dims;
+    emulator->system[NEX_EMU_SYS_DIMS] = dims;
+    emulator->system[NEX_EMU_SYS_BKCMD] = 2;
+    emulator->system[NEX_EMU_SYS_BAUD] = bauds;
+    emulator->system[NEX_EMU_SYS_BAUDS] = bauds;
+
+    emulator->is_refresh_stopped = false;
+    emulator->command_length = 0;
+    emulator->is_command_overflowed = false;
+    emulator->end_count = 0;
+    emulator->transparent = NEX_EMU_TRANSPARENT_NONE;
+
+    nextion_emulator_page_load(emulator, 0);
+}
+
+/**
+ * @brief Show a page, with its components as designed.
+ * @param emulator Emulator pointer.
+ * @param page_id Page id.
+ */
+static void nextion_emulator_page_load(nextion_emulator_t *emulator, uint8_t page_id)
+{
+    const nextion_emulator_page_t *definition = &emulator->config->pages[page_id];
+
+    emulator->system[NEX_EMU_SYS_DP] = page_id;
+
+    for (size_t i = 0; i < definition->component_count; i++)
+    {
+        nextion_emulator_object_t *object = &emulator->objects[page_id][i];
+        const nextion_emulator_component_t *component = object->definition;
+
+        object->value = component->value;
+        object->is_visible = true;
+        object->is_touchable = true;
+
+        memset(object->attributes, 0, sizeof(object->attributes));
+
+        object->attributes[0] = component->area.x;
+        object->attributes[1] = component->area.y;
+        object->attributes[2] = component->area.width;
+        object->attributes[3] = component->area.height;
+
+        if (object->text != NULL)
+        {
+            strncpy(object->text, component->text, component->text_max_length);
+            object->text[component->text_max_length] = '\0';
+        }
+
+        if (object->sample_counts != NULL)
+        {
+            memset(object->sample_counts, 0, component->channel_count * sizeof(uint64_t));
+        }
+    }
+
+    nextion_emulator_fill(emulator, 0, 0, emulator->config->width, emulator->config->height, 0xFFFFU);
+}
+
+static void nextion_emulator_receive_byte(nextion_emulator_t *emulator, uint8_t byte, uint64_t now_us)
+{
+    if (now_us < emulator->reset_until_us)
+    {
+        return;
+    }
+
+    emulator->stats.bytes_received++;
+    emulator->last_serial_us = now_us;
+
+    if (nextion_emulator_is_asleep_wakeable(emulator))
+    {
+        emulator->system[NEX_EMU_SYS_SLEEP] = 0;
+        emulator->stats.events++;
+
+        nextion_emulator_emit_code(emulator, now_us, NEX_DVC_EVT_HARDWARE_AUTO_WAKE);
+    }
+
+    if (emulator->transparent != NEX_EMU_TRANSPARENT_NONE)
+    {
+        nextion_emulator_transparent_receive(emulator, byte, now_us);
+
+        return;
+    }
+
+    if (byte == NEX_DVC_CMD_END_VALUE)
+    {
+        if (++emulator->end_count == NEX_DVC_CMD_END_LENGTH)
+        {
+            nextion_emulator_command_run(emulator, now_us);
+        }
+
+        return;
+    }
+
+    // Lone 0xFF are part of the command.
+    for (; emulator->end_count > 0; emulator->end_count--)
+    {
+        if (emulator->command_length < NEX_EMU_COMMAND_MAX_LENGTH)
+        {
+            emulator->command[emulator->command_length++] = (char)NEX_DVC_CMD_END_VALUE;
+        }
+    }
+
+    if (emulator->command_length < NEX_EMU_COMMAND_MAX_LENGTH)
+    {
+        emulator->command[emulator->command_length++] = (char)byte;
+    }
+    else
+    {
+        emulator->is_command_overflowed = true;
+    }
+}
+
+/**
+ * @brief Receive a byte while in "Transparent Data" mode; the last one runs the operation.
+ * @param emulator Emulator pointer.
+ * @param byte Received byte.
+ * @param now_us Time in microseconds.
+ */
+static void nextion_emulator_transparent_receive(nextion_emulator_t *emulator, uint8_t byte, uint64_t now_us)
+{
+    emulator->transparent_data[emulator->transparent_received++] = byte;
+
+    if (emulator->transparent_received < emulator->transparent_expected)
+    {
+        return;
+    }
+
+    uint64_t start = now_us > emulator->busy_until_us ? now_us : emulator->busy_until_us;
+
+    if (emulator->transparent == NEX_EMU_TRANSPARENT_EEPROM)
+    {
+        memcpy(emulator->eeprom + emulator->transparent_address, emulator->transparent_data, emulator->transparent_expected);
+    }
+    else
+    {
+        const nextion_emulator_area_t *area = &emulator->transparent_waveform->definition->area;
+
+        emulator->transparent_waveform->sample_counts[emulator->transparent_channel] += emulator->transparent_expected;
+
+        if (!emulator->is_refresh_stopped)
+        {
+            emulator->pixels += (uint64_t)area->height * (emulator->transparent_expected < area->width ? emulator->transparent_expected : area->width);
+        }
+    }
+
+    emulator->busy_until_us = start + emulator->config->command_latency_us + emulator->pixels * emulator->config->pixel_time_ns / 1000U;
+    emulator->stats.pixels_drawn += emulator->pixels;
+    emulator->pixels = 0;
+    emulator->transparent = NEX_EMU_TRANSPARENT_NONE;
+
+    nextion_emulator_emit_code(emulator, emulator->busy_until_us, NEX_DVC_RSP_TRANSPARENT_DATA_FINISHED);
+}
+
+/**
+ * @brief Execute the received command once the previous one has finished, and schedule its output.
+ * @param emulator Emulator pointer.
+ * @param now_us When the command was received, in microseconds.
+ */
+static void nextion_emulator_command_run(nextion_emulator_t *emulator, uint64_t now_us)
+{
+    uint64_t start = now_us > emulator->busy_until_us ? now_us : emulator->busy_until_us;
+
+    emulator->command[emulator->command_length] = '\0';
+    emulator->texts_length = 0;
+    emulator->pixels = 0;
+    emulator->delay_us = 0;
+    emulator->in_command = true;
+
+    uint8_t code = emulator->is_command_overflowed ? NEX_DVC_INSTRUCTION_FAIL : nextion_emulator_command_execute(emulator, emulator->command);
+
+    emulator->command_length = 0;
+    emulator->is_command_overflowed = false;
+    emulator->end_count = 0;
+    emulator->stats.commands++;
+
+    if (code != NEX_DVC_INSTRUCTION_OK && code != NEX_EMU_SILENT)
+    {
+        emulator->stats.failures++;
+    }
+
+    nextion_emulator_acknowledge(emulator, code);
+
+    uint64_t finish = start + emulator->config->command_latency_us + emulator->pixels * emulator->config->pixel_time_ns / 1000U + emulator->delay_us;
+
+    emulator->busy_until_us = finish;
+    emulator->stats.pixels_drawn += emulator->pixels;
+    emulator->pixels = 0;
+    emulator->delay_us = 0;
+    emulator->in_command = false;
+
+    // Output is ready when the command finishes.
+
+    while (emulator->staged != NULL)
+    {
+        nextion_emulator_output_t *output = emulator->staged;
+
+        emulator->staged = output->next;
+        output->ready_at_us += finish;
+
+        nextion_emulator_output_insert(emulator, output);
+    }
+
+    if (emulator->reset_until_us == UINT64_MAX)
+    {
+        emulator->reset_until_us = finish + NEX_EMU_RESET_TIME_US;
+    }
+}
+
+/**
+ * @brief Execute a command.
+ * @param emulator Emulator pointer.
+ * @param command Null-terminated command; it is modified.
+ * @return Response code, or NEX_EMU_SILENT if there is nothing to acknowledge.
+ */
+static uint8_t nextion_emulator_command_execute(nextion_emulator_t *emulator, char *command)
+{
+    char *space = strchr(command, NEX_DVC_CMD_PARAMS_DIVISOR);
+    char *equal = strchr(command, '=');
+
+    if (equal != NULL && (space == NULL || equal < space))
+    {
+        *equal = '\0';
+
+        char *name = nextion_emulator_trim(command);
+        char *value = nextion_emulator_trim(equal + 1);
+
+        // The display pauses, then acknowledges.
+        if (strcmp(name, "delay") == 0)
+        {
+            int32_t delay_ms = 0;
+            uint8_t code = nextion_emulator_number(emulator, value, &delay_ms);
+
+            emulator->delay_us = delay_ms > 0 ? (uint64_t)delay_ms * 1000U : 0;
+
+            return code;
+        }
+
+        return nextion_emulator_assign(emulator, name, value);
+    }
+
+    char *tokens[NEX_EMU_ARGUMENT_MAX_COUNT];
+    size_t count = 0;
+
+    if (space != NULL)
+    {
+        *space = '\0';
+
+        count = nextion_emulator_split(space + 1, tokens, NEX_EMU_ARGUMENT_MAX_COUNT);
+    }
+
+    int32_t numbers[NEX_EMU_ARGUMENT_MAX_COUNT] = {0};
+    uint8_t code = NEX_DVC_INSTRUCTION_OK;
+    uint8_t page = (uint8_t)emulator->system[NEX_EMU_SYS_DP];
+    const nextion_emulator_config_t *config = emulator->config;
+
+#define NEX_EMU_EXPECT_ARGUMENTS(expected)                          \
+    if (count != (expected))                                        \
+    {                                                               \
+        return NEX_DVC_ERR_INVALID_INSTRUCTION_PARAMETERS_COUNT;    \
+    }
+#define NEX_EMU_EXPECT_NUMBERS(first, last)                                                \
+    for (size_t i = (first); i <= (last); i++)                                             \
+    {                                                                                      \
+        if ((code = nextion_emulator_number(emulator, tokens[i], &numbers[i])) != NEX_DVC_INSTRUCTION_OK) \
+        {                                                                                  \
+            return code;                                                                   \
+        }                                                                                  \
+    }
+
+    if (strcmp(command, "page") == 0)
+    {
+        NEX_EMU_EXPECT_ARGUMENTS(1)
+
+        int32_t id = -1;
+
+        if (!nextion_emulator_parse_integer(tokens[0], &id))
+        {
+            for (size_t i = 0; i < config->page_count; i++)
+            {
+                if (strcmp(config->pages[i].name, tokens[0]) == 0)
+                {
+                    id = (int32_t)i;
+                }
+            }
+        }
+
+        if (id < 0 || (size_t)id >= config->page_count)
+        {
+            return NEX_DVC_ERR_INVALID_PAGE;
+        }
+
+        nextion_emulator_page_load(emulator, (uint8_t)id);
+
+        return NEX_DVC_INSTRUCTION_OK;
+    }
+
+    if (strcmp(command, "ref") == 0 || strcmp(command, "vis") == 0 || strcmp(command, "tsw") == 0)
+    {
+        bool is_ref = command[0] == 'r';
+
+        NEX_EMU_EXPECT_ARGUMENTS(is_ref ? 1U : 2U)
+
+        if (!is_ref)
+        {
+            NEX_EMU_EXPECT_NUMBERS(1, 1)
+        }
+
+        int32_t id = -1;
+        nextion_emulator_object_t *object = NULL;
+
+        if (nextion_emulator_parse_integer(tokens[0], &id))
+        {
+            object = nextion_emulator_object_by_id(emulator, page, id);
+        }
+        else
+        {
+            object = nextion_emulator_object_find(emulator, page, tokens[0]);
+        }
+
+        bool is_all = !is_ref && id == 255;
+
+        if (object == NULL && id != 0 && !is_all)
+        {
+            return NEX_DVC_ERR_INVALID_COMPONENT;
+        }
+
+        for (size_t i = 0; i < config->pages[page].component_count; i++)
+        {
+            nextion_emulator_object_t *current = &emulator->objects[page][i];
+
+            if (!is_all && current != object)
+            {
+                continue;
+            }
+
+            if (command[0] == 'v')
+            {
+                current->is_visible = numbers[1] != 0;
+            }
+            else if (command[0] == 't')
+            {
+                current->is_touchable = numbers[1] != 0;
+            }
+
+            if (command[0] != 't')
+            {
+                emulator->pixels += (uint64_t)current->definition->area.width * current->definition->area.height;
+            }
+        }
+
+        if (is_ref && object == NULL)
+        {
+            emulator->pixels += (uint64_t)config->width * config->height;
+        }
+
+        return NEX_DVC_INSTRUCTION_OK;
+    }
+
+    if (strcmp(command, "ref_star") == 0 || strcmp(command, "ref_stop") == 0)
+    {
+        NEX_EMU_EXPECT_ARGUMENTS(0)
+
+        emulator->is_refresh_stopped = strcmp(command, "ref_stop") == 0;
+
+        return NEX_DVC_INSTRUCTION_OK;
+    }
+
+    if (strcmp(command, "get") == 0)
+    {
+        NEX_EMU_EXPECT_ARGUMENTS(1)
+
+        nextion_emulator_value_t value;
+
+        if ((code = nextion_emulator_evaluate(emulator, tokens[0], &value)) != NEX_DVC_INSTRUCTION_OK)
+        {
+            return code;
+        }
+
+        if (value.is_text)
+        {
+            size_t length = strnlen(value.text, NEX_EMU_COMMAND_MAX_LENGTH);
+            uint8_t response[NEX_EMU_COMMAND_MAX_LENGTH + NEX_DVC_CMD_ACK_LENGTH];
+
+            response[0] = NEX_DVC_RSP_GET_STRING;
+
+            memcpy(response + 1, value.text, length);
+            memset(response + 1 + length, NEX_DVC_CMD_END_VALUE, NEX_DVC_CMD_END_LENGTH);
+
+            nextion_emulator_emit(emulator, 0, response, length + NEX_DVC_CMD_ACK_LENGTH);
+        }
+        else
+        {
+            uint32_t number = (uint32_t)value.number;
+            const uint8_t response[] = {NEX_DVC_RSP_GET_NUMBER, (uint8_t)number, (uint8_t)(number >> 8), (uint8_t)(number >> 16), (uint8_t)(number >> 24), NEX_DVC_CMD_END_SEQUENCE};
+
+            nextion_emulator_emit(emulator, 0, response, sizeof(response));
+        }
+
+        return NEX_EMU_SILENT;
+    }
+
+    if (strcmp(command, "sendme") == 0)
+    {
+        NEX_EMU_EXPECT_ARGUMENTS(0)
+
+        const uint8_t response[] = {NEX_DVC_RSP_SENDME_RESULT, page, NEX_DVC_CMD_END_SEQUENCE};
+
+        nextion_emulator_emit(emulator, 0, response, sizeof(response));
+
+        return NEX_EMU_SILENT;
+    }
+
+    if (strcmp(command, "rest") == 0)
+    {
+        NEX_EMU_EXPECT_ARGUMENTS(0)
+
+        // Responses of the previous commands are lost with the reset.
+        nextion_emulator_output_clear(&emulator->staged);
+
+        nextion_emulator_power_on(emulator);
+
+        const uint8_t started[] = {NEX_DVC_EVT_HARDWARE_START_RESET, 0x00, 0x00, NEX_DVC_CMD_END_SEQUENCE};
+        const uint8_t ready[] = {NEX_DVC_EVT_HARDWARE_READY, NEX_DVC_CMD_END_SEQUENCE};
+
+        nextion_emulator_emit(emulator, NEX_EMU_RESET_TIME_US, started, sizeof(started));
+        nextion_emulator_emit(emulator, NEX_EMU_RESET_TIME_US, ready, sizeof(ready));
+
+        // Input is ignored until started; the actual time is set once the command finishes.
+        emulator->reset_until_us = UINT64_MAX;
+
+        return NEX_EMU_SILENT;
+    }
+
+    if (strcmp(command, "cls") == 0)
+    {
+        NEX_EMU_EXPECT_ARGUMENTS(1)
+        NEX_EMU_EXPECT_NUMBERS(0, 0)
+
+        nextion_emulator_fill(emulator, 0, 0, config->width, config->height, (uint16_t)numbers[0]);
+
+        return NEX_DVC_INSTRUCTION_OK;
+    }
+
+    if (strcmp(command, "fill") == 0)
+    {
+        NEX_EMU_EXPECT_ARGUMENTS(5)
+        NEX_EMU_EXPECT_NUMBERS(0, 4)
+
+        nextion_emulator_fill(emulator, numbers[0], numbers[1], numbers[2], numbers[3], (uint16_t)numbers[4]);
+
+        return NEX_DVC_INSTRUCTION_OK;
+    }
+
+    if (strcmp(command, "line") == 0 || strcmp(command, "draw") == 0)
+    {
+        NEX_EMU_EXPECT_ARGUMENTS(5)
+        NEX_EMU_EXPECT_NUMBERS(0, 4)
+
+        uint16_t color = (uint16_t)numbers[4];
+
+        if (command[0] == 'l')
+        {
+            nextion_emulator_line(emulator, numbers[0], numbers[1], numbers[2], numbers[3], color);
+        }
+        else
+        {
+            nextion_emulator_line(emulator, numbers[0], numbers[1], numbers[2], numbers[1], color);
+            nextion_emulator_line(emulator, numbers[2], numbers[1], numbers[2], numbers[3], color);
+            nextion_emulator_line(emulator, numbers[2], numbers[3], numbers[0], numbers[3], color);
+            nextion_emulator_line(emulator, numbers[0], numbers[3], numbers[0], numbers[1], color);
+        }
+
+        return NEX_DVC_INSTRUCTION_OK;
+    }
+
+    if (strcmp(command, "cir") == 0 || strcmp(command, "cirs") == 0)
+    {
+        NEX_EMU_EXPECT_ARGUMENTS(4)
+        NEX_EMU_EXPECT_NUMBERS(0, 3)
+
+        nextion_emulator_circle(emulator, numbers[0], numbers[1], numbers[2], (uint16_t)numbers[3], command[3] == 's');
+
+        return NEX_DVC_INSTRUCTION_OK;
+    }
+
+    if (strcmp(command, "pic") == 0)
+    {
+        NEX_EMU_EXPECT_ARGUMENTS(3)
+        NEX_EMU_EXPECT_NUMBERS(0, 2)
+
+        if (numbers[2] < 0 || (size_t)numbers[2] >= config->picture_count)
+        {
+            return NEX_DVC_ERR_INVALID_PICTURE;
+        }
+
+        const nextion_emulator_resource_t *picture = &config->pictures[numbers[2]];
+
+        nextion_emulator_fill(emulator, numbers[0], numbers[1], picture->width, picture->height, nextion_emulator_picture_color(numbers[2]));
+
+        return NEX_DVC_INSTRUCTION_OK;
+    }
+
+    if (strcmp(command, "xpic") == 0)
+    {
+        NEX_EMU_EXPECT_ARGUMENTS(7)
+        NEX_EMU_EXPECT_NUMBERS(0, 6)
+
+        if (numbers[6] < 0 || (size_t)numbers[6] >= config->picture_count)
+        {
+            return NEX_DVC_ERR_INVALID_PICTURE;
+        }
+
+        // Only the part of the crop area that is inside the picture is drawn.
+
+        const nextion_emulator_resource_t *picture = &config->pictures[numbers[6]];
+        int32_t width = numbers[4] + numbers[2] > picture->width ? picture->width - numbers[4] : numbers[2];
+        int32_t height = numbers[5] + numbers[3] > picture->height ? picture->height - numbers[5] : numbers[3];
+
+        nextion_emulator_fill(emulator, numbers[0], numbers[1], width, height, nextion_emulator_picture_color(numbers[6]));
+
+        return NEX_DVC_INSTRUCTION_OK;
+    }
+
+    if (strcmp(command, "xstr") == 0)
+    {
+        NEX_EMU_EXPECT_ARGUMENTS(11)
+        NEX_EMU_EXPECT_NUMBERS(0, 9)
+
+        nextion_emulator_value_t text;
+
+        if ((code = nextion_emulator_evaluate(emulator, tokens[10], &text)) != NEX_DVC_INSTRUCTION_OK)
+        {
+            return code;
+        }
+
+        if (!text.is_text)
+        {
+            return NEX_DVC_ERR_INVALID_ATTRIBUTE_ASSIGNMENT;
+        }
+
+        if (numbers[4] < 0 || (size_t)numbers[4] >= config->font_count)
+        {
+            return NEX_DVC_ERR_INVALID_FONT;
+        }
+
+        bool is_picture = numbers[9] == 0 || numbers[9] == 2;
+
+        if (is_picture && (numbers[6] < 0 || (size_t)numbers[6] >= config->picture_count))
+        {
+            return NEX_DVC_ERR_INVALID_PICTURE;
+        }
+
+        if (numbers[9] != 3)
+        {
+            uint16_t background = is_picture ? nextion_emulator_picture_color(numbers[6]) : (uint16_t)numbers[6];
+
+            nextion_emulator_fill(emulator, numbers[0], numbers[1], numbers[2], numbers[3], background);
+        }
+
+        // Characters are drawn as solid cells, left to right, clipped to the area.
+
+        const nextion_emulator_resource_t *font = &config->fonts[numbers[4]];
+        int32_t columns = font->width > 0 ? numbers[2] / font->width : 0;
+        int32_t length = (int32_t)strlen(text.text);
+        int32_t height = font->height < numbers[3] ? font->height : numbers[3];
+
+        for (int32_t i = 0; i < length && i < columns; i++)
+        {
+            nextion_emulator_fill(emulator, numbers[0] + i * font->width, numbers[1], font->width, height, (uint16_t)numbers[5]);
+        }
+
+        return NEX_DVC_INSTRUCTION_OK;
+    }
+
+    if (strcmp(command, "add") == 0 || strcmp(command, "addt") == 0 || strcmp(command, "cle") == 0)
+    {
+        bool is_clear = command[0] == 'c';
+
+        NEX_EMU_EXPECT_ARGUMENTS(is_clear ? 2U : 3U)
+        NEX_EMU_EXPECT_NUMBERS(0, count - 1)
+
+        bool is_all = is_clear && numbers[1] == 255;
+        nextion_emulator_object_t *object = nextion_emulator_waveform_find(emulator, numbers[0], is_all ? 0 : numbers[1]);
+
+        if (object == NULL)
+        {
+            return NEX_DVC_ERR_INVALID_WAVEFORM;
+        }
+
+        const nextion_emulator_area_t *area = &object->definition->area;
+
+        if (is_clear)
+        {
+            for (uint8_t channel = 0; channel < object->definition->channel_count; channel++)
+            {
+                if (is_all || channel == numbers[1])
+                {
+                    object->sample_counts[channel] = 0;
+                }
+            }
+
+            emulator->pixels += (uint64_t)area->width * area->height;
+
+            return NEX_DVC_INSTRUCTION_OK;
+        }
+
+        if (command[3] == 't')
+        {
+            if (numbers[2] <= 0 || numbers[2] >= (int32_t)NEX_DVC_TRANSPARENT_DATA_MAX_DATA_SIZE)
+            {
+                return NEX_DVC_ERR_INVALID_WAVEFORM;
+            }
+
+            emulator->transparent = NEX_EMU_TRANSPARENT_WAVEFORM;
+            emulator->transparent_expected = (size_t)numbers[2];
+            emulator->transparent_received = 0;
+            emulator->transparent_waveform = object;
+            emulator->transparent_channel = (uint8_t)numbers[1];
+
+            nextion_emulator_emit_code(emulator, NEX_EMU_TRANSPARENT_DATA_WAIT_TIME_US, NEX_DVC_RSP_TRANSPARENT_DATA_READY);
+
+            return NEX_EMU_SILENT;
+        }
+
+        object->sample_counts[numbers[1]]++;
+
+        if (!emulator->is_refresh_stopped)
+        {
+            emulator->pixels += area->height;
+        }
+
+        // "add" is only acknowledged when it fails.
+        return NEX_EMU_SILENT;
+    }
+
+    if (strcmp(command, "wepo") == 0)
+    {
+        NEX_EMU_EXPECT_ARGUMENTS(2)
+        NEX_EMU_EXPECT_NUMBERS(1, 1)
+
+        nextion_emulator_value_t value;
+
+        if ((code = nextion_emulator_evaluate(emulator, tokens[0], &value)) != NEX_DVC_INSTRUCTION_OK)
+        {
+            return code;
+        }
+
+        uint8_t bytes[NEX_DVC_EEPROM_SIZE + 1];
+        size_t length = 4;
+
+        if (value.is_text)
+        {
+            length = strlen(value.text) + 1;
+
+            memcpy(bytes, value.text, length < sizeof(bytes) ? length : sizeof(bytes));
+        }
+        else
+        {
+            uint32_t number = (uint32_t)value.number;
+
+            bytes[0] = (uint8_t)number;
+            bytes[1] = (uint8_t)(number >> 8);
+            bytes[2] = (uint8_t)(number >> 16);
+            bytes[3] = (uint8_t)(number >> 24);
+        }
+
+        if (numbers[1] < 0 || (size_t)numbers[1] + length > NEX_DVC_EEPROM_SIZE)
+        {
+            return NEX_DVC_ERR_EEPROM_OPERATION_FAILED;
+        }
+
+        memcpy(emulator->eeprom + numbers[1], bytes, length);
+
+        return NEX_DVC_INSTRUCTION_OK;
+    }
+
+    if (strcmp(command, "wept") == 0 || strcmp(command, "rept") == 0)
+    {
+        NEX_EMU_EXPECT_ARGUMENTS(2)
+        NEX_EMU_EXPECT_NUMBERS(0, 1)
+
+        if (numbers[0] < 0 || numbers[1] <= 0 || (size_t)numbers[0] + (size_t)numbers[1] > NEX_DVC_EEPROM_SIZE ||
+            numbers[1] >= (int32_t)NEX_DVC_TRANSPARENT_DATA_MAX_DATA_SIZE)
+        {
+            return NEX_DVC_ERR_EEPROM_OPERATION_FAILED;
+        }
+
+        if (command[0] == 'r')
+        {
+            // The bytes come as they are; no code nor termination.
+            nextion_emulator_emit(emulator, 0, emulator->eeprom + numbers[0], (size_t)numbers[1]);
+
+            return NEX_EMU_SILENT;
+        }
+
+        emulator->transparent = NEX_EMU_TRANSPARENT_EEPROM;
+        emulator->transparent_expected = (size_t)numbers[1];
+        emulator->transparent_received = 0;
+        emulator->transparent_address = (uint16_t)numbers[0];
+
+        nextion_emulator_emit_code(emulator, NEX_EMU_TRANSPARENT_DATA_WAIT_TIME_US, NEX_DVC_RSP_TRANSPARENT_DATA_READY);
+
+        return NEX_EMU_SILENT;
+    }
+
+#undef NEX_EMU_EXPECT_ARGUMENTS
+#undef NEX_EMU_EXPECT_NUMBERS
+
+    return NEX_DVC_INSTRUCTION_FAIL;
+}
+
+/**
+ * @brief Execute an assignment.
+ * @param emulator Emulator pointer.
+ * @param target Variable name.
+ * @param expression Value.
+ * @return Response code.
+ */
+static uint8_t nextion_emulator_assign(nextion_emulator_t *emulator, char *target, char *expression)
+{
+    nextion_emulator_reference_t reference;
+    nextion_emulator_value_t value;
+    uint8_t code = nextion_emulator_resolve(emulator, target, &reference);
+
+    if (code != NEX_DVC_INSTRUCTION_OK)
+    {
+        return code;
+    }
+
+    if ((code = nextion_emulator_evaluate(emulator, expression, &value)) != NEX_DVC_INSTRUCTION_OK)
+    {
+        return code;
+    }
+
+    bool is_text = reference.kind == NEX_EMU_REF_TEXT;
+
+    if (value.is_text != is_text)
+    {
+        return NEX_DVC_ERR_INVALID_ATTRIBUTE_ASSIGNMENT;
+    }
+
+    nextion_emulator_object_t *object = reference.object;
+
+    switch (reference.kind)
+    {
+    case NEX_EMU_REF_SYSTEM:
+        return nextion_emulator_system_set(emulator, reference.index, value.number);
+    case NEX_EMU_REF_VALUE:
+        object->value = value.number;
+        break;
+    case NEX_EMU_REF_TEXT:
+        // Longer texts are truncated to "txt_maxl".
+        strncpy(object->text, value.text, object->definition->text_max_length);
+        object->text[object->definition->text_max_length] = '\0';
+        break;
+    case NEX_EMU_REF_ATTRIBUTE:
+        object->attributes[reference.index] = value.number;
+        break;
+    default:
+        return NEX_DVC_ERR_INVALID_ATTRIBUTE_ASSIGNMENT;
+    }
+
+    if (object->is_visible && !emulator->is_refresh_stopped)
+    {
+        emulator->pixels += (uint64_t)object->definition->area.width * object->definition->area.height;
+    }
+
+    return NEX_DVC_INSTRUCTION_OK;
+}
+
+/**
+ * @brief Set a system variable, applying its side effects.
+ * @param emulator Emulator pointer.
+ * @param index System variable.
+ * @param number Value.
+ * @return Response code.
+ */
+static uint8_t nextion_emulator_system_set(nextion_emulator_t *emulator, size_t index, int32_t number)
+{
+    switch (index)
+    {
+    case NEX_EMU_SYS_DIMS:
+    case NEX_EMU_SYS_DIM:
+        number = number < 0 ? 0 : (number > NEX_EMU_BRIGHTNESS_MAX ? NEX_EMU_BRIGHTNESS_MAX : number);
+
+        emulator->system[NEX_EMU_SYS_DIM] = number;
+        break;
+    case NEX_EMU_SYS_BKCMD:
+        if (number < 0 || number > 3)
+        {
+            return NEX_DVC_ERR_INVALID_ATTRIBUTE_ASSIGNMENT;
+        }
+        break;
+    case NEX_EMU_SYS_THSP:
+    case NEX_EMU_SYS_USSP:
+        // 0 disables it; otherwise at least 3 seconds.
+        number = number <= 0 ? 0 : (number < 3 ? 3 : (number > UINT16_MAX ? UINT16_MAX : number));
+
+        emulator->last_touch_us = emulator->busy_until_us;
+        emulator->last_serial_us = emulator->busy_until_us;
+        break;
+    case NEX_EMU_SYS_BAUD:
+    case NEX_EMU_SYS_BAUDS:
+    {
+        bool is_supported = false;
+
+        for (size_t i = 0; i < sizeof(NEX_EMU_BAUD_RATES) / sizeof(NEX_EMU_BAUD_RATES[0]); i++)
+        {
+            is_supported = is_supported || NEX_EMU_BAUD_RATES[i] == (uint32_t)number;
+        }
+
+        if (!is_supported)
+        {
+            return NEX_DVC_ERR_INVALID_BAUD_RATE;
+        }
+
+        // Acknowledged at the previous baud rate.
+        nextion_emulator_acknowledge(emulator, NEX_DVC_INSTRUCTION_OK);
+
+        emulator->system[NEX_EMU_SYS_BAUD] = number;
+        emulator->system[index] = number;
+
+        return NEX_EMU_SILENT;
+    }
+    case NEX_EMU_SYS_DP:
+        if (number < 0 || (size_t)number >= emulator->config->page_count)
+        {
+            return NEX_DVC_ERR_INVALID_PAGE;
+        }
+
+        nextion_emulator_page_load(emulator, (uint8_t)number);
+
+        return NEX_DVC_INSTRUCTION_OK;
+    case NEX_EMU_SYS_SLEEP:
+    case NEX_EMU_SYS_THUP:
+    case NEX_EMU_SYS_USUP:
+    case NEX_EMU_SYS_SENDXY:
+        number = number != 0;
+        break;
+    default:
+        break;
+    }
+
+    emulator->system[index] = number;
+
+    return NEX_DVC_INSTRUCTION_OK;
+}
+
+/**
+ * @brief Split arguments on the commas that are not inside quotes.
+ * @param arguments Null-terminated arguments; it is modified.
+ * @param tokens Location where the trimmed arguments will be stored.
+ * @param capacity Tokens length.
+ * @return How many arguments there are, or capacity + 1 if there are too many.
+ */
+static size_t nextion_emulator_split(char *arguments, char **tokens, size_t capacity)
+{
+    size_t count = 0;
+    bool is_quoted = false;
+    char *start = arguments;
+
+    for (char *current = arguments;; current++)
+    {
+        if (*current == '\\' && is_quoted && current[1] != '\0')
+        {
+            current++;
+            continue;
+        }
+
+        if (*current == '"')
+        {
+            is_quoted = !is_quoted;
+        }
+
+        if ((*current == NEX_DVC_CMD_PARAMS_SEPARATOR && !is_quoted) || *current == '\0')
+        {
+            bool is_end = *current == '\0';
+
+            *current = '\0';
+
+            if (count == capacity)
+            {
+                return capacity + 1;
+            }
+
+            tokens[count++] = nextion_emulator_trim(start);
+            start = current + 1;
+
+            if (is_end)
+            {
+                return count;
+            }
+        }
+    }
+}
+
+static char *nextion_emulator_trim(char *text)
+{
+    while (*text == ' ')
+    {
+        text++;
+    }
+
+    size_t length = strlen(text);
+
+    while (length > 0 && text[length - 1] == ' ')
+    {
+        text[--length] = '\0';
+    }
+
+    return text;
+}
+
+/**
+ * @brief Evaluate an argument: a number, a quoted text or a variable.
+ * @param emulator Emulator pointer.
+ * @param token Argument; it is modified.
+ * @param value Location where the value will be stored.
+ * @return Response code.
+ */
+static uint8_t nextion_emulator_evaluate(nextion_emulator_t *emulator, char *token, nextion_emulator_value_t *value)
+{
+    value->is_text = false;
+    value->number = 0;
+    value->text = NULL;
+
+    if (token[0] == '"')
+    {
+        size_t length = strlen(token);
+
+        if (length < 2 || token[length - 1] != '"')
+        {
+            return NEX_DVC_INSTRUCTION_FAIL;
+        }
+
+        char *text = emulator->texts + emulator->texts_length;
+        size_t size = 0;
+
+        for (size_t i = 1; i < length - 1; i++)
+        {
+            char character = token[i];
+
+            if (character == '\\')
+            {
+                switch (token[++i])
+                {
+                case '"':
+                case '\\':
+                    character = token[i];
+                    break;
+                case 'r':
+                    text[size++] = '\r';
+                    character = '\n';
+                    break;
+                default:
+                    return NEX_DVC_ERR_INVALID_ESCAPE_CHARACTER;
+                }
+            }
+
+            text[size++] = character;
+        }
+
+        text[size] = '\0';
+
+        emulator->texts_length += size + 1;
+
+        value->is_text = true;
+        value->text = text;
+
+        return NEX_DVC_INSTRUCTION_OK;
+    }
+
+    if (nextion_emulator_parse_integer(token, &value->number))
+    {
+        return NEX_DVC_INSTRUCTION_OK;
+    }
+
+    nextion_emulator_reference_t reference;
+    uint8_t code = nextion_emulator_resolve(emulator, token, &reference);
+
+    if (code != NEX_DVC_INSTRUCTION_OK)
+    {
+        return code;
+    }
+
+    switch (reference.kind)
+    {
+    case NEX_EMU_REF_SYSTEM:
+        value->number = emulator->system[reference.index];
+        break;
+    case NEX_EMU_REF_VALUE:
+        value->number = reference.object->value;
+        break;
+    case NEX_EMU_REF_TEXT:
+        value->is_text = true;
+        value->text = reference.object->text;
+        break;
+    case NEX_EMU_REF_ID:
+        value->number = reference.object->definition->id;
+        break;
+    case NEX_EMU_REF_TEXT_MAX_LENGTH:
+        value->number = reference.object->definition->text_max_length;
+        break;
+    case NEX_EMU_REF_ATTRIBUTE:
+        value->number = reference.object->attributes[reference.index];
+        break;
+    }
+
+    return NEX_DVC_INSTRUCTION_OK;
+}
+
+/**
+ * @brief Evaluate an argument that must be a number.
+ * @param emulator Emulator pointer.
+ * @param token Argument; it is modified.
+ * @param number Location where the number will be stored.
+ * @return Response code.
+ */
+static uint8_t nextion_emulator_number(nextion_emulator_t *emulator, char *token, int32_t *number)
+{
+    nextion_emulator_value_t value;
+    uint8_t code = nextion_emulator_evaluate(emulator, token, &value);
+
+    if (code != NEX_DVC_INSTRUCTION_OK)
+    {
+        return code;
+    }
+
+    if (value.is_text)
+    {
+        return NEX_DVC_ERR_INVALID_ATTRIBUTE_ASSIGNMENT;
+    }
+
+    *number = value.number;
+
+    return NEX_DVC_INSTRUCTION_OK;
+}
+
+static bool nextion_emulator_parse_integer(const char *token, int32_t *number)
+{
+    const char *digits = token[0] == '-' ? token + 1 : token;
+
+    if (digits[0] == '\0')
+    {
+        return false;
+    }
+
+    int64_t result = 0;
+
+    for (const char *current = digits; *current != '\0'; current++)
+    {
+        if (!isdigit((unsigned char)*current))
+        {
+            return false;
+        }
+
+        // Wraps around as 32-bit arithmetic on the display.
+        result = (int64_t)(int32_t)(uint32_t)(result * 10 + (*current - '0'));
+    }
+
+    *number = (int32_t)(token[0] == '-' ? -result : result);
+
+    return true;
+}
+
+/**
+ * @brief Find what a variable name refers to: "sysvar", "[page.]object.attribute", with object as a name or "b[id]".
+ * @param emulator Emulator pointer.
+ * @param name Variable name; it is modified.
+ * @param reference Location where the reference will be stored.
+ * @return NEX_DVC_INSTRUCTION_OK, otherwise NEX_DVC_ERR_INVALID_VARIABLE_OR_ATTRIBUTE.
+ */
+static uint8_t nextion_emulator_resolve(nextion_emulator_t *emulator, char *name, nextion_emulator_reference_t *reference)
+{
+    char *parts[3];
+    size_t count = 0;
+
+    for (char *current = name; count < 3;)
+    {
+        parts[count++] = current;
+
+        current = strchr(current, NEX_DVC_CMD_ATTRIBUTE_SEPARATOR);
+
+        if (current == NULL)
+        {
+            break;
+        }
+
+        *current++ = '\0';
+    }
+
+    reference->object = NULL;
+    reference->index = 0;
+
+    if (count == 1)
+    {
+        for (size_t i = 0; i < NEX_EMU_SYS_COUNT; i++)
+        {
+            if (strcmp(parts[0], NEX_EMU_SYSTEM_NAMES[i]) == 0)
+            {
+                reference->kind = NEX_EMU_REF_SYSTEM;
+                reference->index = i;
+
+                return NEX_DVC_INSTRUCTION_OK;
+            }
+        }
+
+        return NEX_DVC_ERR_INVALID_VARIABLE_OR_ATTRIBUTE;
+    }
+
+    uint8_t page = (uint8_t)emulator->system[NEX_EMU_SYS_DP];
+
+    if (count == 3)
+    {
+        int32_t id = -1;
+
+        if (!nextion_emulator_parse_integer(parts[0], &id))
+        {
+            for (size_t i = 0; i < emulator->config->page_count; i++)
+            {
+                if (strcmp(emulator->config->pages[i].name, parts[0]) == 0)
+                {
+                    id = (int32_t)i;
+                }
+            }
+        }
+
+        if (id < 0 || (size_t)id >= emulator->config->page_count)
+        {
+            return NEX_DVC_ERR_INVALID_VARIABLE_OR_ATTRIBUTE;
+        }
+
+        page = (uint8_t)id;
+    }
+
+    const char *object_name = parts[count - 2];
+    const char *attribute = parts[count - 1];
+    int32_t id = -1;
+
+    if (strncmp(object_name, "b[", 2) == 0 && object_name[strlen(object_name) - 1] == ']')
+    {
+        char digits[8] = {0};
+        size_t length = strlen(object_name) - 3;
+
+        if (length == 0 || length >= sizeof(digits))
+        {
+            return NEX_DVC_ERR_INVALID_VARIABLE_OR_ATTRIBUTE;
+        }
+
+        memcpy(digits, object_name + 2, length);
+
+        if (nextion_emulator_parse_integer(digits, &id))
+        {
+            reference->object = nextion_emulator_object_by_id(emulator, page, id);
+        }
+    }
+    else
+    {
+        reference->object = nextion_emulator_object_find(emulator, page, object_name);
+    }
+
+    if (reference->object == NULL)
+    {
+        return NEX_DVC_ERR_INVALID_VARIABLE_OR_ATTRIBUTE;
+    }
+
+    const nextion_emulator_component_t *component = reference->object->definition;
+
+    if (strcmp(attribute, "val") == 0 && component->has_value)
+    {
+        reference->kind = NEX_EMU_REF_VALUE;
+    }
+    else if (strcmp(attribute, "txt") == 0 && component->text != NULL)
+    {
+        reference->kind = NEX_EMU_REF_TEXT;
+    }
+    else if (strcmp(attribute, "id") == 0)
+    {
+        reference->kind = NEX_EMU_REF_ID;
+    }
+    else if (strcmp(attribute, "txt_maxl") == 0 && component->text != NULL)
+    {
+        reference->kind = NEX_EMU_REF_TEXT_MAX_LENGTH;
+    }
+    else
+    {
+        reference->kind = NEX_EMU_REF_ATTRIBUTE;
+
+        for (reference->index = 0; reference->index < NEX_EMU_ATTRIBUTE_COUNT; reference->index++)
+        {
+            if (strcmp(attribute, NEX_EMU_ATTRIBUTE_NAMES[reference->index]) == 0)
+            {
+                return NEX_DVC_INSTRUCTION_OK;
+            }
+        }
+
+        return NEX_DVC_ERR_INVALID_VARIABLE_OR_ATTRIBUTE;
+    }
+
+    return NEX_DVC_INSTRUCTION_OK;
+}
+
+static nextion_emulator_object_t *nextion_emulator_object_find(nextion_emulator_t *emulator, uint8_t page_id, const char *name)
+{
+    const nextion_emulator_page_t *page = &emulator->config->pages[page_id];
+
+    for (size_t i = 0; i < page->component_count; i++)
+    {
+        if (strcmp(page->components[i].name, name) == 0)
+        {
+            return &emulator->objects[page_id][i];
+        }
+    }
+
+    return NULL;
+}
+
+static nextion_emulator_object_t *nextion_emulator_object_by_id(nextion_emulator_t *emulator, uint8_t page_id, int32_t id)
+{
+    const nextion_emulator_page_t *page = &emulator->config->pages[page_id];
+
+    for (size_t i = 0; i < page->component_count; i++)
+    {
+        if (page->components[i].id == id)
+        {
+            return &emulator->objects[page_id][i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Find a waveform channel of the current page.
+ * @param emulator Emulator pointer.
+ * @param id Waveform id.
+ * @param channel Channel.
+ * @return Waveform, or NULL if either the waveform or the channel does not exist.
+ */
+static nextion_emulator_object_t *nextion_emulator_waveform_find(nextion_emulator_t *emulator, int32_t id, int32_t channel)
+{
+    nextion_emulator_object_t *object = nextion_emulator_object_by_id(emulator, (uint8_t)emulator->system[NEX_EMU_SYS_DP], id);
+
+    if (object == NULL || channel < 0 || channel >= object->definition->channel_count)
+    {
+        return NULL;
+    }
+
+    return object;
+}
+
+/**
+ * @brief Send a response code if "bkcmd" asks for it.
+ * @param emulator Emulator pointer.
+ * @param code Response code.
+ */
+static void nextion_emulator_acknowledge(nextion_emulator_t *emulator, uint8_t code)
+{
+    if (code == NEX_EMU_SILENT)
+    {
+        return;
+    }
+
+    int32_t level = emulator->system[NEX_EMU_SYS_BKCMD];
+    bool is_success = code == NEX_DVC_INSTRUCTION_OK;
+
+    if ((is_success && (level == 1 || level == 3)) || (!is_success && level >= 2))
+    {
+        nextion_emulator_emit_code(emulator, 0, code);
+    }
+}
+
+/**
+ * @brief Queue bytes at the current baud rate.
+ * @details While a command is executed, the time is relative to when it finishes.
+ * @param emulator Emulator pointer.
+ * @param at_us When the bytes are ready, in microseconds.
+ * @param data Bytes.
+ * @param length How many bytes.
+ */
+static void nextion_emulator_emit(nextion_emulator_t *emulator, uint64_t at_us, const uint8_t *data, size_t length)
+{
+    nextion_emulator_output_t *output = (nextion_emulator_output_t *)malloc(sizeof(nextion_emulator_output_t) + length);
+
+    if (output == NULL)
+    {
+        return;
+    }
+
+    output->next = NULL;
+    output->ready_at_us = at_us;
+    output->baud_rate = (uint32_t)emulator->system[NEX_EMU_SYS_BAUD];
+    output->length = length;
+    output->offset = 0;
+
+    memcpy(output->data, data, length);
+
+    emulator->stats.bytes_sent += length;
+
+    if (!emulator->in_command)
+    {
+        nextion_emulator_output_insert(emulator, output);
+
+        return;
+    }
+
+    nextion_emulator_output_t **tail = &emulator->staged;
+
+    while (*tail != NULL)
+    {
+        tail = &(*tail)->next;
+    }
+
+    *tail = output;
+}
+
+static void nextion_emulator_emit_code(nextion_emulator_t *emulator, uint64_t at_us, uint8_t code)
+{
+    const uint8_t frame[] = {code, NEX_DVC_CMD_END_SEQUENCE};
+
+    nextion_emulator_emit(emulator, at_us, frame, sizeof(frame));
+}
+
+/**
+ * @brief Insert an output after every output ready before or at the same time.
+ * @param emulator Emulator pointer.
+ * @param output Output.
+ */
+static void nextion_emulator_output_insert(nextion_emulator_t *emulator, nextion_emulator_output_t *output)
+{
+    nextion_emulator_output_t **position = &emulator->outputs;
+
+    while (*position != NULL && (*position)->ready_at_us <= output->ready_at_us)
+    {
+        position = &(*position)->next;
+    }
+
+    output->next = *position;
+    *position = output;
+}
+
+static void nextion_emulator_output_clear(nextion_emulator_output_t **list)
+{
+    while (*list != NULL)
+    {
+        nextion_emulator_output_t *next = (*list)->next;
+
+        free(*list);
+
+        *list = next;
+    }
+}
+
+/**
+ * @brief Fill a rectangle, clipped to the screen.
+ * @param emulator Emulator pointer.
+ * @param x Left coordinate.
+ * @param y Top coordinate.
+ * @param width Width.
+ * @param height Height.
+ * @param color RGB565 color.
+ */
+static void nextion_emulator_fill(nextion_emulator_t *emulator, int32_t x, int32_t y, int32_t width, int32_t height, uint16_t color)
+{
+    int32_t left = x < 0 ? 0 : x;
+    int32_t top = y < 0 ? 0 : y;
+    int32_t right = x + width > emulator->config->width ? emulator->config->width : x + width;
+    int32_t bottom = y + height > emulator->config->height ? emulator->config->height : y + height;
+
+    for (int32_t row = top; row < bottom; row++)
+    {
+        for (int32_t column = left; column < right; column++)
+        {
+            emulator->framebuffer[row * emulator->config->width + column] = color;
+        }
+    }
+
+    if (right > left && bottom > top)
+    {
+        emulator->pixels += (uint64_t)(right - left) * (uint64_t)(bottom - top);
+    }
+}
+
+static void nextion_emulator_plot(nextion_emulator_t *emulator, int32_t x, int32_t y, uint16_t color)
+{
+    if (x >= 0 && y >= 0 && x < emulator->config->width && y < emulator->config->height)
+    {
+        emulator->framebuffer[y * emulator->config->width + x] = color;
+        emulator->pixels++;
+    }
+}
+
+static void nextion_emulator_line(nextion_emulator_t *emulator, int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint16_t color)
+{
+    int32_t dx = abs(x1 - x0);
+    int32_t dy = -abs(y1 - y0);
+    int32_t sx = x0 < x1 ? 1 : -1;
+    int32_t sy = y0 < y1 ? 1 : -1;
+    int32_t error = dx + dy;
+
+    for (;;)
+    {
+        nextion_emulator_plot(emulator, x0, y0, color);
+
+        if (x0 == x1 && y0 == y1)
+        {
+            return;
+        }
+
+        int32_t doubled = 2 * error;
+
+        if (doubled >= dy)
+        {
+            error += dy;
+            x0 += sx;
+        }
+
+        if (doubled <= dx)
+        {
+            error += dx;
+            y0 += sy;
+        }
+    }
+}
+
+static void nextion_emulator_circle(nextion_emulator_t *emulator, int32_t cx, int32_t cy, int32_t radius, uint16_t color, bool is_filled)
+{
+    for (int32_t y = -radius; y <= radius; y++)
+    {
+        for (int32_t x = -radius; x <= radius; x++)
+        {
+            int32_t distance = x * x + y * y;
+
+            // The outline is the ring between radius - 1 and radius.
+            if (distance <= radius * radius && (is_filled || distance > (radius - 1) * (radius - 1)))
+            {
+                nextion_emulator_plot(emulator, cx + x, cy + y, color);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Color pictures are drawn with; every picture is a solid color.
+ * @param picture_id Picture id.
+ * @return RGB565 color.
+ */
+static uint16_t nextion_emulator_picture_color(int32_t picture_id)
+{
+    return (uint16_t)(0x0841U * (uint32_t)(picture_id + 1));
+}
+
+static bool nextion_emulator_is_asleep_wakeable(const nextion_emulator_t *emulator)
+{
+    return emulator->system[NEX_EMU_SYS_SLEEP] && emulator->system[NEX_EMU_SYS_USUP];
+}
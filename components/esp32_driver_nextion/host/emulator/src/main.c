@@ -0,0 +1,158 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <unistd.h>
+#include "nextion_emulator/emulator.h"
+#include "nextion_emulator/pty.h"
+#include "nextion_emulator/test_hmi.h"
+
+static void usage(const char *program)
+{
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "  --baud RATE        power-on baud rate (default 9600)\n"
+            "  --latency-us US    time to execute any command (default 0)\n"
+            "  --pixel-ns NS      extra time per pixel drawn (default 0)\n"
+            "  --frame-bits BITS  bits per byte on the line (default 10, 8N1)\n"
+            "  --any-baud         accept bytes whatever the baud rate of the line\n"
+            "  --link PATH        create a symbolic link to the terminal\n"
+            "commands on stdin:\n"
+            "  touch ID 0|1       touch a component of the current page\n"
+            "  touchxy X Y 0|1    touch a point\n"
+            "  stats              print the counters\n"
+            "  quit\n",
+            program);
+}
+
+int main(int argc, char **argv)
+{
+    static const struct option options[] = {
+        {"baud", required_argument, NULL, 'b'},
+        {"latency-us", required_argument, NULL, 'l'},
+        {"pixel-ns", required_argument, NULL, 'p'},
+        {"frame-bits", required_argument, NULL, 'f'},
+        {"any-baud", no_argument, NULL, 'a'},
+        {"link", required_argument, NULL, 'k'},
+        {"help", no_argument, NULL, 'h'},
+        {NULL, 0, NULL, 0}};
+
+    nextion_emulator_config_t config = *nextion_emulator_test_hmi();
+    nextion_emulator_pty_config_t line = NEXTION_EMULATOR_PTY_CONFIG_DEFAULT();
+    const char *link = NULL;
+    int option;
+
+    while ((option = getopt_long(argc, argv, "h", options, NULL)) != -1)
+    {
+        switch (option)
+        {
+        case 'b':
+            config.baud_rate = (uint32_t)strtoul(optarg, NULL, 10);
+            break;
+        case 'l':
+            config.command_latency_us = (uint32_t)strtoul(optarg, NULL, 10);
+            break;
+        case 'p':
+            config.pixel_time_ns = (uint32_t)strtoul(optarg, NULL, 10);
+            break;
+        case 'f':
+            line.frame_bits = (uint8_t)strtoul(optarg, NULL, 10);
+            break;
+        case 'a':
+            line.ignore_line_baud_rate = true;
+            break;
+        case 'k':
+            link = optarg;
+            break;
+        default:
+            usage(argv[0]);
+            return option == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    nextion_emulator_t *emulator = nextion_emulator_create(&config);
+    nextion_emulator_pty_t *pty = emulator == NULL ? NULL : nextion_emulator_pty_start(emulator, &line);
+
+    if (pty == NULL)
+    {
+        fprintf(stderr, "failed starting the emulator\n");
+        return EXIT_FAILURE;
+    }
+
+    if (link != NULL)
+    {
+        unlink(link);
+
+        if (symlink(nextion_emulator_pty_get_path(pty), link) != 0)
+        {
+            perror("symlink");
+        }
+    }
+
+    printf("%s\n", nextion_emulator_pty_get_path(pty));
+    fflush(stdout);
+
+    char input[128];
+
+    while (fgets(input, sizeof(input), stdin) != NULL)
+    {
+        unsigned int x = 0;
+        unsigned int y = 0;
+        unsigned int pressed = 0;
+
+        if (strncmp(input, "quit", 4) == 0)
+        {
+            break;
+        }
+
+        nextion_emulator_t *locked = nextion_emulator_pty_lock(pty);
+        uint64_t now = nextion_emulator_pty_clock_us();
+
+        if (sscanf(input, "touch %u %u", &x, &pressed) == 2)
+        {
+            if (!nextion_emulator_touch_component(locked, (uint8_t)x, pressed != 0, now))
+            {
+                fprintf(stderr, "no component %u\n", x);
+            }
+        }
+        else if (sscanf(input, "touchxy %u %u %u", &x, &y, &pressed) == 3)
+        {
+            nextion_emulator_touch(locked, (uint16_t)x, (uint16_t)y, pressed != 0, now);
+        }
+        else if (strncmp(input, "stats", 5) == 0)
+        {
+            nextion_emulator_stats_t stats;
+
+            nextion_emulator_get_stats(locked, &stats);
+
+            printf("baud %u page %u sleeping %d commands %llu failures %llu received %llu sent %llu pixels %llu events %llu\n",
+                   nextion_emulator_get_baud_rate(locked),
+                   nextion_emulator_get_page(locked),
+                   nextion_emulator_is_sleeping(locked),
+                   (unsigned long long)stats.commands,
+                   (unsigned long long)stats.failures,
+                   (unsigned long long)stats.bytes_received,
+                   (unsigned long long)stats.bytes_sent,
+                   (unsigned long long)stats.pixels_drawn,
+                   (unsigned long long)stats.events);
+            fflush(stdout);
+        }
+        else
+        {
+            fprintf(stderr, "unknown command\n");
+        }
+
+        nextion_emulator_pty_unlock(pty);
+    }
+
+    nextion_emulator_pty_stop(pty);
+    nextion_emulator_delete(emulator);
+
+    if (link != NULL)
+    {
+        unlink(link);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,363 @@
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#include <limits.h>
+#include <pthread.h>
+#include "serial_line.h"
+#include "nextion_emulator/pty.h"
+
+/**
+ * @brief How many bytes are read from the line at once.
+ */
+#define NEX_EMU_PTY_READ_SIZE 4096U
+
+/**
+ * @brief How many bytes of output are taken from the emulator at once.
+ */
+#define NEX_EMU_PTY_WRITE_SIZE 4096U
+
+/**
+ * @brief Wait before retrying when the other side does not read, in microseconds.
+ */
+#define NEX_EMU_PTY_RETRY_TIME_US 1000U
+
+struct nextion_emulator_pty_t
+{
+    nextion_emulator_t *emulator;            /** @brief Emulator. */
+    nextion_emulator_pty_config_t config;    /** @brief Line configuration. */
+    char path[PATH_MAX];                     /** @brief Slave path. */
+    int master;                              /** @brief Master side. */
+    int slave;                               /** @brief Slave side, kept open so its settings persist. */
+    int wake[2];                             /** @brief Pipe to wake the runner. */
+    pthread_t thread;                        /** @brief Runner thread. */
+    pthread_mutex_t lock;                    /** @brief Guards the emulator and the fields below. */
+    bool stop;                               /** @brief If the runner must stop. */
+    uint64_t rx_clock_us;                    /** @brief When the last received byte ended. */
+    uint64_t tx_clock_us;                    /** @brief When the last sent byte ends. */
+    uint8_t output[NEX_EMU_PTY_WRITE_SIZE];  /** @brief Output being sent. */
+    size_t output_length;                    /** @brief Output length. */
+    size_t output_sent;                      /** @brief How many bytes of the output were sent. */
+    uint64_t output_start_us;                /** @brief When the output started. */
+    uint64_t output_byte_time_ns;            /** @brief Time a byte of the output takes. */
+};
+
+static void *nextion_emulator_pty_run(void *argument);
+static uint64_t nextion_emulator_pty_transmit(nextion_emulator_pty_t *pty, uint64_t now_us);
+static void nextion_emulator_pty_receive(nextion_emulator_pty_t *pty, const uint8_t *data, size_t length, uint64_t now_us);
+static bool nextion_emulator_pty_is_line_at(const nextion_emulator_pty_t *pty, uint32_t baud_rate);
+static uint64_t nextion_emulator_pty_byte_time_ns(const nextion_emulator_pty_t *pty, uint32_t baud_rate);
+
+nextion_emulator_pty_t *nextion_emulator_pty_start(nextion_emulator_t *emulator, const nextion_emulator_pty_config_t *config)
+{
+    if (emulator == NULL || config == NULL || config->frame_bits == 0)
+    {
+        return NULL;
+    }
+
+    nextion_emulator_pty_t *pty = (nextion_emulator_pty_t *)calloc(1, sizeof(nextion_emulator_pty_t));
+
+    if (pty == NULL)
+    {
+        return NULL;
+    }
+
+    pty->emulator = emulator;
+    pty->config = *config;
+    pty->slave = -1;
+    pty->wake[0] = -1;
+    pty->wake[1] = -1;
+    pty->master = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+
+    if (pty->master < 0 || grantpt(pty->master) != 0 || unlockpt(pty->master) != 0 ||
+        ptsname_r(pty->master, pty->path, sizeof(pty->path)) != 0)
+    {
+        goto fail;
+    }
+
+    // Raw on both sides: every byte goes through untouched.
+
+    pty->slave = open(pty->path, O_RDWR | O_NOCTTY | O_NONBLOCK);
+
+    if (pty->slave < 0 || !serial_line_set_raw(pty->master) || !serial_line_set_raw(pty->slave) ||
+        !serial_line_set_baud_rate(pty->slave, nextion_emulator_get_baud_rate(emulator)))
+    {
+        goto fail;
+    }
+
+    if (pipe2(pty->wake, O_NONBLOCK | O_CLOEXEC) != 0)
+    {
+        goto fail;
+    }
+
+    pthread_mutex_init(&pty->lock, NULL);
+
+    if (pthread_create(&pty->thread, NULL, nextion_emulator_pty_run, pty) != 0)
+    {
+        pthread_mutex_destroy(&pty->lock);
+
+        goto fail;
+    }
+
+    return pty;
+
+fail:
+    for (int i = 0; i < 2; i++)
+    {
+        if (pty->wake[i] >= 0)
+        {
+            close(pty->wake[i]);
+        }
+    }
+
+    if (pty->slave >= 0)
+    {
+        close(pty->slave);
+    }
+
+    if (pty->master >= 0)
+    {
+        close(pty->master);
+    }
+
+    free(pty);
+
+    return NULL;
+}
+
+void nextion_emulator_pty_stop(nextion_emulator_pty_t *pty)
+{
+    if (pty == NULL)
+    {
+        return;
+    }
+
+    pthread_mutex_lock(&pty->lock);
+
+    pty->stop = true;
+
+    pthread_mutex_unlock(&pty->lock);
+
+    const uint8_t signal = 0;
+
+    (void)!write(pty->wake[1], &signal, 1);
+
+    pthread_join(pty->thread, NULL);
+    pthread_mutex_destroy(&pty->lock);
+
+    close(pty->wake[0]);
+    close(pty->wake[1]);
+    close(pty->slave);
+    close(pty->master);
+
+    free(pty);
+}
+
+const char *nextion_emulator_pty_get_path(const nextion_emulator_pty_t *pty)
+{
+    return pty->path;
+}
+
+nextion_emulator_t *nextion_emulator_pty_lock(nextion_emulator_pty_t *pty)
+{
+    pthread_mutex_lock(&pty->lock);
+
+    return pty->emulator;
+}
+
+void nextion_emulator_pty_unlock(nextion_emulator_pty_t *pty)
+{
+    pthread_mutex_unlock(&pty->lock);
+
+    const uint8_t signal = 0;
+
+    (void)!write(pty->wake[1], &signal, 1);
+}
+
+uint64_t nextion_emulator_pty_clock_us(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint64_t)now.tv_sec * 1000000U + (uint64_t)now.tv_nsec / 1000U;
+}
+
+static void *nextion_emulator_pty_run(void *argument)
+{
+    nextion_emulator_pty_t *pty = (nextion_emulator_pty_t *)argument;
+    uint8_t buffer[NEX_EMU_PTY_READ_SIZE];
+
+    for (;;)
+    {
+        pthread_mutex_lock(&pty->lock);
+
+        if (pty->stop)
+        {
+            pthread_mutex_unlock(&pty->lock);
+
+            return NULL;
+        }
+
+        uint64_t now = nextion_emulator_pty_clock_us();
+
+        nextion_emulator_update(pty->emulator, now);
+
+        uint64_t next = nextion_emulator_pty_transmit(pty, now);
+        uint64_t scheduled = nextion_emulator_next_event_time(pty->emulator);
+
+        next = scheduled < next ? scheduled : next;
+
+        pthread_mutex_unlock(&pty->lock);
+
+        struct pollfd descriptors[] = {{.fd = pty->master, .events = POLLIN}, {.fd = pty->wake[0], .events = POLLIN}};
+        struct timespec timeout = {0};
+        struct timespec *timeout_pointer = NULL;
+
+        if (next != UINT64_MAX)
+        {
+            uint64_t wait = next > now ? next - now : 0;
+
+            timeout.tv_sec = (time_t)(wait / 1000000U);
+            timeout.tv_nsec = (long)(wait % 1000000U) * 1000L;
+            timeout_pointer = &timeout;
+        }
+
+        if (ppoll(descriptors, 2, timeout_pointer, NULL) <= 0)
+        {
+            continue;
+        }
+
+        if (descriptors[1].revents & POLLIN)
+        {
+            while (read(pty->wake[0], buffer, sizeof(buffer)) > 0)
+            {
+            }
+        }
+
+        if (descriptors[0].revents & POLLIN)
+        {
+            ssize_t count = read(pty->master, buffer, sizeof(buffer));
+
+            if (count > 0)
+            {
+                pthread_mutex_lock(&pty->lock);
+
+                nextion_emulator_pty_receive(pty, buffer, (size_t)count, nextion_emulator_pty_clock_us());
+
+                pthread_mutex_unlock(&pty->lock);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Send every output byte whose transmission has ended by now.
+ * @param pty Runner pointer.
+ * @param now_us Current time, in microseconds.
+ * @return When to send the next byte, or UINT64_MAX if there is nothing to send.
+ */
+static uint64_t nextion_emulator_pty_transmit(nextion_emulator_pty_t *pty, uint64_t now_us)
+{
+    for (;;)
+    {
+        if (pty->output_sent == pty->output_length)
+        {
+            uint32_t baud_rate = 0;
+            uint64_t ready_at = 0;
+
+            pty->output_length = nextion_emulator_transmit(pty->emulator, now_us, pty->output, sizeof(pty->output), &baud_rate, &ready_at);
+            pty->output_sent = 0;
+
+            if (pty->output_length == 0)
+            {
+                return UINT64_MAX;
+            }
+
+            // Sent at another baud rate it would be garbage.
+            if (!nextion_emulator_pty_is_line_at(pty, baud_rate))
+            {
+                pty->output_length = 0;
+                continue;
+            }
+
+            pty->output_start_us = ready_at > pty->tx_clock_us ? ready_at : pty->tx_clock_us;
+            pty->output_byte_time_ns = nextion_emulator_pty_byte_time_ns(pty, baud_rate);
+        }
+
+        // A byte is delivered once its last bit is on the line.
+
+        uint64_t elapsed_ns = now_us > pty->output_start_us ? (now_us - pty->output_start_us) * 1000U : 0;
+        size_t due = (size_t)(elapsed_ns / pty->output_byte_time_ns);
+
+        due = due < pty->output_length ? due : pty->output_length;
+
+        if (due > pty->output_sent)
+        {
+            ssize_t written = write(pty->master, pty->output + pty->output_sent, due - pty->output_sent);
+
+            if (written < 0)
+            {
+                return errno == EAGAIN || errno == EINTR ? now_us + NEX_EMU_PTY_RETRY_TIME_US : UINT64_MAX;
+            }
+
+            pty->output_sent += (size_t)written;
+        }
+
+        if (pty->output_sent < pty->output_length)
+        {
+            return pty->output_start_us + ((pty->output_sent + 1) * pty->output_byte_time_ns + 999U) / 1000U;
+        }
+
+        pty->tx_clock_us = pty->output_start_us + (pty->output_length * pty->output_byte_time_ns + 999U) / 1000U;
+    }
+}
+
+/**
+ * @brief Feed received bytes to the emulator, each one at the time its transmission ends.
+ * @param pty Runner pointer.
+ * @param data Received bytes.
+ * @param length How many bytes.
+ * @param now_us When they were read, in microseconds.
+ */
+static void nextion_emulator_pty_receive(nextion_emulator_pty_t *pty, const uint8_t *data, size_t length, uint64_t now_us)
+{
+    uint32_t baud_rate = nextion_emulator_get_baud_rate(pty->emulator);
+    bool is_audible = nextion_emulator_pty_is_line_at(pty, baud_rate);
+    uint64_t byte_time_ns = nextion_emulator_pty_byte_time_ns(pty, baud_rate);
+    uint64_t start_ns = (pty->rx_clock_us > now_us ? pty->rx_clock_us : now_us) * 1000U;
+
+    for (size_t i = 0; i < length; i++)
+    {
+        pty->rx_clock_us = (start_ns + (i + 1) * byte_time_ns) / 1000U;
+
+        if (!is_audible)
+        {
+            continue;
+        }
+
+        nextion_emulator_receive(pty->emulator, &data[i], 1, pty->rx_clock_us);
+
+        // "baud" changes the rate for the bytes that follow.
+        if (nextion_emulator_get_baud_rate(pty->emulator) != baud_rate)
+        {
+            nextion_emulator_pty_receive(pty, data + i + 1, length - i - 1, pty->rx_clock_us);
+
+            return;
+        }
+    }
+}
+
+static bool nextion_emulator_pty_is_line_at(const nextion_emulator_pty_t *pty, uint32_t baud_rate)
+{
+    return pty->config.ignore_line_baud_rate || serial_line_get_baud_rate(pty->master) == baud_rate;
+}
+
+static uint64_t nextion_emulator_pty_byte_time_ns(const nextion_emulator_pty_t *pty, uint32_t baud_rate)
+{
+    return (uint64_t)pty->config.frame_bits * 1000000000U / (baud_rate > 0 ? baud_rate : 1U);
+}
@@ -0,0 +1,38 @@
+#include "nextion_emulator/test_hmi.h"
+
+static const nextion_emulator_component_t NEX_TEST_HMI_PAGE0[] = {
+    {.name = "t0", .id = 1, .text = "test text", .text_max_length = 10, .area = {10, 10, 120, 30}},
+    {.name = "n0", .id = 2, .has_value = true, .value = 50, .area = {10, 50, 80, 30}},
+    {.name = "c0", .id = 3, .has_value = true, .value = 1, .area = {100, 50, 30, 30}},
+    {.name = "b0", .id = 4, .text = "newtxt", .text_max_length = 10, .area = {140, 10, 100, 40}},
+    {.name = "x0", .id = 5, .has_value = true, .value = 0, .area = {140, 60, 80, 30}},
+    {.name = "r0", .id = 6, .has_value = true, .value = 0, .area = {230, 60, 30, 30}},
+    {.name = "s0", .id = 7, .channel_count = 4, .area = {10, 100, 460, 160}},
+};
+
+static const nextion_emulator_page_t NEX_TEST_HMI_PAGES[] = {
+    {.name = "page0", .components = NEX_TEST_HMI_PAGE0, .component_count = sizeof(NEX_TEST_HMI_PAGE0) / sizeof(NEX_TEST_HMI_PAGE0[0])},
+    {.name = "page1", .components = NULL, .component_count = 0},
+};
+
+static const nextion_emulator_resource_t NEX_TEST_HMI_PICTURES[] = {{170, 97}, {42, 42}, {42, 42}};
+
+static const nextion_emulator_resource_t NEX_TEST_HMI_FONTS[] = {{8, 16}};
+
+static const nextion_emulator_config_t NEX_TEST_HMI = {
+    .width = 480,
+    .height = 272,
+    .pages = NEX_TEST_HMI_PAGES,
+    .page_count = sizeof(NEX_TEST_HMI_PAGES) / sizeof(NEX_TEST_HMI_PAGES[0]),
+    .pictures = NEX_TEST_HMI_PICTURES,
+    .picture_count = sizeof(NEX_TEST_HMI_PICTURES) / sizeof(NEX_TEST_HMI_PICTURES[0]),
+    .fonts = NEX_TEST_HMI_FONTS,
+    .font_count = sizeof(NEX_TEST_HMI_FONTS) / sizeof(NEX_TEST_HMI_FONTS[0]),
+    .baud_rate = 9600,
+    .command_latency_us = 0,
+    .pixel_time_ns = 0};
+
+const nextion_emulator_config_t *nextion_emulator_test_hmi(void)
+{
+    return &NEX_TEST_HMI;
+}
@@ -0,0 +1,62 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "esp32_driver_nextion/font_metrics.h"
+
+#define FONT_TABLE_MAX_FILE (1024 * 1024)
+#define FONT_TABLE_PER_LINE 16
+
+static void usage(const char *program)
+{
+    fprintf(stderr,
+            "usage: %s NAME FILE\n"
+            "Prints the metrics of the \".zi\" font FILE as a flash table named\n"
+            "NEX_FONT_METRICS_NAME, for \"src/font_metrics_tables.c\".\n",
+            program);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc != 3)
+    {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    FILE *file = fopen(argv[2], "rb");
+
+    if (file == NULL)
+    {
+        perror(argv[2]);
+        return EXIT_FAILURE;
+    }
+
+    static uint8_t zi[FONT_TABLE_MAX_FILE];
+    size_t length = fread(zi, 1, sizeof(zi), file);
+
+    fclose(file);
+
+    static uint8_t widths[NEX_FONT_METRICS_MAX_CHARACTERS];
+    nextion_font_metrics_t metrics;
+
+    if (nextion_font_metrics_parse(zi, length, widths, sizeof(widths), &metrics) != NEX_OK)
+    {
+        fprintf(stderr, "%s: not a supported font\n", argv[2]);
+        return EXIT_FAILURE;
+    }
+
+    printf("static const uint8_t NEX_FONT_METRICS_%s_WIDTHS[] = {", argv[1]);
+
+    for (uint16_t i = 0; i < metrics.count; i++)
+    {
+        printf("%s%u,", i % FONT_TABLE_PER_LINE == 0 ? "\n    " : " ", metrics.widths[i]);
+    }
+
+    printf("\n};\n\n");
+    printf("const nextion_font_metrics_t NEX_FONT_METRICS_%s = {\n", argv[1]);
+    printf("    .height = %u,\n", metrics.height);
+    printf("    .first = 0x%02X,\n", metrics.first);
+    printf("    .count = sizeof(NEX_FONT_METRICS_%s_WIDTHS),\n", argv[1]);
+    printf("    .widths = NEX_FONT_METRICS_%s_WIDTHS};\n", argv[1]);
+
+    return EXIT_SUCCESS;
+}
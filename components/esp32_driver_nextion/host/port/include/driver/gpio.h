@@ -0,0 +1,40 @@
+#ifndef __NEXTION_HOST_DRIVER_GPIO_H__
+#define __NEXTION_HOST_DRIVER_GPIO_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    typedef enum
+    {
+        GPIO_NUM_NC = -1,
+        GPIO_NUM_0 = 0,
+        GPIO_NUM_1,
+        GPIO_NUM_2,
+        GPIO_NUM_3,
+        GPIO_NUM_4,
+        GPIO_NUM_5,
+        GPIO_NUM_6,
+        GPIO_NUM_7,
+        GPIO_NUM_8,
+        GPIO_NUM_9,
+        GPIO_NUM_10,
+        GPIO_NUM_11,
+        GPIO_NUM_12,
+        GPIO_NUM_13,
+        GPIO_NUM_14,
+        GPIO_NUM_15,
+        GPIO_NUM_16,
+        GPIO_NUM_17,
+        GPIO_NUM_18,
+        GPIO_NUM_19,
+        GPIO_NUM_20,
+        GPIO_NUM_21,
+        GPIO_NUM_MAX
+    } gpio_num_t;
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,43 @@
+#ifndef __NEXTION_HOST_ESP_LOG_H__
+#define __NEXTION_HOST_ESP_LOG_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    typedef enum
+    {
+        ESP_LOG_NONE = 0,
+        ESP_LOG_ERROR = 1,
+        ESP_LOG_WARN = 2,
+        ESP_LOG_INFO = 3,
+        ESP_LOG_DEBUG = 4,
+        ESP_LOG_VERBOSE = 5
+    } esp_log_level_t;
+
+    /**
+     * @brief Set the highest level logged. Only the global level ("*") is kept.
+     * @note The initial level is read from NEXTION_HOST_LOG_LEVEL (E, W, I, D or V); it defaults to W.
+     */
+    void esp_log_level_set(const char *tag, esp_log_level_t level);
+
+    void esp_log_write(esp_log_level_t level, const char *tag, const char *format, ...) __attribute__((format(printf, 3, 4)));
+    void esp_log_buffer_hexdump_internal(const char *tag, const void *buffer, uint16_t length, esp_log_level_t level);
+    void esp_log_buffer_char_internal(const char *tag, const void *buffer, uint16_t length, esp_log_level_t level);
+
+#define ESP_LOGE(tag, format, ...) esp_log_write(ESP_LOG_ERROR, tag, format, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...) esp_log_write(ESP_LOG_WARN, tag, format, ##__VA_ARGS__)
+#define ESP_LOGI(tag, format, ...) esp_log_write(ESP_LOG_INFO, tag, format, ##__VA_ARGS__)
+#define ESP_LOGD(tag, format, ...) esp_log_write(ESP_LOG_DEBUG, tag, format, ##__VA_ARGS__)
+#define ESP_LOGV(tag, format, ...) esp_log_write(ESP_LOG_VERBOSE, tag, format, ##__VA_ARGS__)
+#define ESP_LOG_BUFFER_HEXDUMP(tag, buffer, length, level) esp_log_buffer_hexdump_internal(tag, buffer, length, level)
+#define ESP_LOG_BUFFER_CHAR_LEVEL(tag, buffer, length, level) esp_log_buffer_char_internal(tag, buffer, length, level)
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,20 @@
+#ifndef __NEXTION_HOST_ESP_TIMER_H__
+#define __NEXTION_HOST_ESP_TIMER_H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief Get the time since the process started.
+     * @return Time in microseconds.
+     */
+    int64_t esp_timer_get_time(void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,73 @@
+#ifndef __NEXTION_HOST_FREERTOS_H__
+#define __NEXTION_HOST_FREERTOS_H__
+
+// FreeRTOS API subset used by the driver, on top of POSIX threads.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <pthread.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    typedef int BaseType_t;
+    typedef unsigned int UBaseType_t;
+    typedef uint32_t TickType_t;
+
+#define pdFALSE ((BaseType_t)0)
+#define pdTRUE ((BaseType_t)1)
+#define pdPASS pdTRUE
+#define pdFAIL pdFALSE
+
+#define configTICK_RATE_HZ 1000
+#define portTICK_PERIOD_MS ((TickType_t)1000 / configTICK_RATE_HZ)
+#define portMAX_DELAY ((TickType_t)0xFFFFFFFFUL)
+#define pdMS_TO_TICKS(ms) ((TickType_t)(((uint64_t)(ms) * configTICK_RATE_HZ) / 1000U))
+
+    /**
+     * @typedef portMUX_TYPE
+     * @brief Critical section lock. Nested critical sections are allowed, as on the target.
+     */
+    typedef struct
+    {
+        pthread_mutex_t mutex; /** @brief Recursive mutex. */
+    } portMUX_TYPE;
+
+    /**
+     * @brief Initialize a critical section lock.
+     * @param[in] mux Lock pointer.
+     */
+    void vPortHostMuxInitialize(portMUX_TYPE *mux);
+
+    /**
+     * @brief Enter a critical section.
+     * @param[in] mux Lock pointer.
+     */
+    void vPortHostMuxEnter(portMUX_TYPE *mux);
+
+    /**
+     * @brief Exit a critical section.
+     * @param[in] mux Lock pointer.
+     */
+    void vPortHostMuxExit(portMUX_TYPE *mux);
+
+/**
+ * @brief Initializer of a statically allocated critical section lock.
+ * @note Unlike the target one, it cannot be nested.
+ */
+#define portMUX_INITIALIZER_UNLOCKED {.mutex = PTHREAD_MUTEX_INITIALIZER}
+
+#define portMUX_INITIALIZE(mux) vPortHostMuxInitialize(mux)
+#define portENTER_CRITICAL(mux) vPortHostMuxEnter(mux)
+#define portEXIT_CRITICAL(mux) vPortHostMuxExit(mux)
+#define portENTER_CRITICAL_ISR(mux) vPortHostMuxEnter(mux)
+#define portEXIT_CRITICAL_ISR(mux) vPortHostMuxExit(mux)
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,47 @@
+#ifndef __NEXTION_HOST_FREERTOS_QUEUE_H__
+#define __NEXTION_HOST_FREERTOS_QUEUE_H__
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @typedef QueueHandle_t
+     * @brief A queue of fixed size items. Semaphores are queues of empty items, as in FreeRTOS.
+     */
+    typedef struct QueueDefinition *QueueHandle_t;
+
+    /**
+     * @typedef QueueSetHandle_t
+     * @brief A queue of the member queues that received an item, one entry per item.
+     */
+    typedef struct QueueDefinition *QueueSetHandle_t;
+
+    /**
+     * @typedef QueueSetMemberHandle_t
+     * @brief A queue that belongs to a queue set.
+     */
+    typedef struct QueueDefinition *QueueSetMemberHandle_t;
+
+    QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size);
+    QueueHandle_t xQueueCreateCountingSemaphore(UBaseType_t max_count, UBaseType_t initial_count);
+    BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticks_to_wait);
+    BaseType_t xQueueReceive(QueueHandle_t queue, void *buffer, TickType_t ticks_to_wait);
+    BaseType_t xQueueReset(QueueHandle_t queue);
+    UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue);
+    void vQueueDelete(QueueHandle_t queue);
+    QueueSetHandle_t xQueueCreateSet(UBaseType_t event_queue_length);
+    BaseType_t xQueueAddToSet(QueueSetMemberHandle_t member, QueueSetHandle_t set);
+    BaseType_t xQueueRemoveFromSet(QueueSetMemberHandle_t member, QueueSetHandle_t set);
+    QueueSetMemberHandle_t xQueueSelectFromSet(QueueSetHandle_t set, TickType_t ticks_to_wait);
+
+#define xQueueSendToBack(queue, item, ticks_to_wait) xQueueSend(queue, item, ticks_to_wait)
+
+#ifdef __cplusplus
+}
+#endif
+#endif
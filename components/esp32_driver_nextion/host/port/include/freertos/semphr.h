@@ -0,0 +1,24 @@
+#ifndef __NEXTION_HOST_FREERTOS_SEMPHR_H__
+#define __NEXTION_HOST_FREERTOS_SEMPHR_H__
+
+#include "freertos/queue.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    typedef QueueHandle_t SemaphoreHandle_t;
+
+#define xSemaphoreCreateBinary() xQueueCreateCountingSemaphore(1, 0)
+#define xSemaphoreCreateCounting(max_count, initial_count) xQueueCreateCountingSemaphore(max_count, initial_count)
+#define xSemaphoreCreateMutex() xQueueCreateCountingSemaphore(1, 1)
+#define xSemaphoreTake(semaphore, ticks_to_wait) xQueueReceive(semaphore, NULL, ticks_to_wait)
+#define xSemaphoreGive(semaphore) xQueueSend(semaphore, NULL, 0)
+#define uxSemaphoreGetCount(semaphore) uxQueueMessagesWaiting(semaphore)
+#define vSemaphoreDelete(semaphore) vQueueDelete(semaphore)
+
+#ifdef __cplusplus
+}
+#endif
+#endif
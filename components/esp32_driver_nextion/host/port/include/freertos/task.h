@@ -0,0 +1,45 @@
+#ifndef __NEXTION_HOST_FREERTOS_TASK_H__
+#define __NEXTION_HOST_FREERTOS_TASK_H__
+
+#include "freertos/FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @typedef TaskHandle_t
+     * @brief A task; each one is a thread.
+     * @details Suspension and deletion of another task are cooperative: they
+     * take effect when that task blocks, which is where the driver tasks spend
+     * their time.
+     */
+    typedef struct tskTaskControlBlock *TaskHandle_t;
+
+    typedef void (*TaskFunction_t)(void *);
+
+    /**
+     * @brief Create a task. Returns once the new task first blocks, as if it had a higher priority.
+     * @note The stack depth and the priority are ignored.
+     */
+    BaseType_t xTaskCreate(TaskFunction_t task_code,
+                           const char *name,
+                           uint32_t stack_depth,
+                           void *parameters,
+                           UBaseType_t priority,
+                           TaskHandle_t *created_task);
+
+    void vTaskDelete(TaskHandle_t task);
+    void vTaskDelay(TickType_t ticks_to_delay);
+    void vTaskSuspend(TaskHandle_t task);
+    void vTaskResume(TaskHandle_t task);
+    TaskHandle_t xTaskGetCurrentTaskHandle(void);
+    TickType_t xTaskGetTickCount(void);
+    BaseType_t xTaskNotifyGive(TaskHandle_t task);
+    uint32_t ulTaskNotifyTake(BaseType_t clear_count_on_exit, TickType_t ticks_to_wait);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
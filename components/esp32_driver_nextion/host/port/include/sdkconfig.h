@@ -0,0 +1,40 @@
+#ifndef __NEXTION_HOST_SDKCONFIG_H__
+#define __NEXTION_HOST_SDKCONFIG_H__
+
+// What "idf.py menuconfig" generates with the component Kconfig defaults.
+
+#define CONFIG_NEX_UART_MUTEX_WAIT_TIME_MS 500
+#define CONFIG_NEX_UART_RECV_WAIT_TIME_MS 200
+#define CONFIG_NEX_UART_TRANS_WAIT_TIME_MS 200
+#define CONFIG_NEX_UART_RECV_BUFFER_SIZE 256
+#define CONFIG_NEX_UART_RECV_READ_SIZE 128
+#define CONFIG_NEX_UART_RECV_FRAME_BUFFER_SIZE 128
+#define CONFIG_NEX_UART_TRANS_COMMAND_FORMAT_BUFFER_SIZE 128
+#define CONFIG_NEX_UART_COMMAND_QUEUE_SIZE 16
+#define CONFIG_NEX_UART_BATCH_BUFFER_SIZE 512
+#define CONFIG_NEX_COMPONENT_CACHE_SIZE 16
+#define CONFIG_NEX_COMPONENT_CACHE_TEXT_SIZE 24
+#define CONFIG_NEX_UART_TASK_PRIORITY 1
+#define CONFIG_NEX_EVENT_QUEUE_SIZE 16
+#define CONFIG_NEX_EVENT_TASK_PRIORITY 1
+#define CONFIG_NEX_EVENT_TASK_STACK_SIZE 2048
+#define CONFIG_NEX_WAVEFORM_PUMP_TASK_PRIORITY 1
+#define CONFIG_NEX_WAVEFORM_PUMP_TASK_STACK_SIZE 3072
+#define CONFIG_NEX_ANIMATION_TASK_PRIORITY 1
+#define CONFIG_NEX_ANIMATION_TASK_STACK_SIZE 3072
+
+// Not defaults: the host build negotiates the baud rate so the link
+// switch is tested, captures so it can be tested and replayed, caches
+// part of the EEPROM so replacing blocks is tested too, and serves its
+// displays from one UART task so the queue set is tested too.
+
+#define CONFIG_NEX_UART_BAUD_RATE_NEGOTIATE 1
+#define CONFIG_NEX_UART_BAUD_RATE_TARGET 921600
+
+#define CONFIG_NEX_WIRE_CAPTURE_SIZE 8192
+#define CONFIG_NEX_EEPROM_CACHE_BLOCKS 8
+#define CONFIG_NEX_EEPROM_CACHE_FLUSH_DELAY_MS 200
+#define CONFIG_NEX_UART_SHARED_TASK 1
+#define CONFIG_NEX_UART_SHARED_TASK_MAX_DISPLAYS 2
+
+#endif
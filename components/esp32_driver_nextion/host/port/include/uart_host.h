@@ -0,0 +1,24 @@
+#ifndef __NEXTION_HOST_UART_HOST_H__
+#define __NEXTION_HOST_UART_HOST_H__
+
+#include "driver/uart.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief Choose the terminal device a UART port is wired to, e.g. a pseudo-terminal
+     * of the emulator or a USB serial adapter.
+     * @note Must be called before "uart_driver_install".
+     * @param[in] uart_num UART port number.
+     * @param[in] path Device path.
+     * @return ESP_OK if success, otherwise ESP_ERR_INVALID_ARG.
+     */
+    esp_err_t uart_host_set_device(uart_port_t uart_num, const char *path);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
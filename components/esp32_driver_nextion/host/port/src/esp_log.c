@@ -0,0 +1,123 @@
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include "esp_log.h"
+#include "host_port.h"
+
+static pthread_once_t esp_log_once = PTHREAD_ONCE_INIT;
+static esp_log_level_t esp_log_level = ESP_LOG_WARN;
+
+static void esp_log_init(void);
+static bool esp_log_is_enabled(esp_log_level_t level);
+
+void esp_log_level_set(const char *tag, esp_log_level_t level)
+{
+    (void)tag;
+
+    pthread_once(&esp_log_once, esp_log_init);
+
+    esp_log_level = level;
+}
+
+void esp_log_write(esp_log_level_t level, const char *tag, const char *format, ...)
+{
+    static const char LETTERS[] = {'N', 'E', 'W', 'I', 'D', 'V'};
+
+    if (!esp_log_is_enabled(level))
+    {
+        return;
+    }
+
+    va_list args;
+    va_start(args, format);
+
+    // One write per line, so lines of different threads are not mixed.
+    char line[512];
+    int length = snprintf(line, sizeof(line), "%c (%lu) %s: ", LETTERS[level], (unsigned long)(host_port_clock_us() / 1000U), tag);
+
+    if (length >= 0 && (size_t)length < sizeof(line))
+    {
+        vsnprintf(line + length, sizeof(line) - (size_t)length, format, args);
+    }
+
+    va_end(args);
+
+    fprintf(stderr, "%s\n", line);
+}
+
+void esp_log_buffer_hexdump_internal(const char *tag, const void *buffer, uint16_t length, esp_log_level_t level)
+{
+    const uint8_t *bytes = (const uint8_t *)buffer;
+
+    if (!esp_log_is_enabled(level))
+    {
+        return;
+    }
+
+    for (uint16_t offset = 0; offset < length; offset += 16)
+    {
+        char line[16 * 3 + 1] = {0};
+        int used = 0;
+
+        for (uint16_t i = offset; i < length && i < offset + 16; i++)
+        {
+            used += snprintf(line + used, sizeof(line) - (size_t)used, "%02x ", bytes[i]);
+        }
+
+        esp_log_write(level, tag, "0x%04x   %s", offset, line);
+    }
+}
+
+void esp_log_buffer_char_internal(const char *tag, const void *buffer, uint16_t length, esp_log_level_t level)
+{
+    const char *characters = (const char *)buffer;
+
+    for (uint16_t offset = 0; offset < length; offset += 16)
+    {
+        int count = length - offset < 16 ? length - offset : 16;
+
+        esp_log_write(level, tag, "%.*s", count, characters + offset);
+    }
+}
+
+static void esp_log_init(void)
+{
+    const char *value = getenv("NEXTION_HOST_LOG_LEVEL");
+
+    if (value == NULL)
+    {
+        return;
+    }
+
+    switch (value[0])
+    {
+    case 'N':
+        esp_log_level = ESP_LOG_NONE;
+        break;
+    case 'E':
+        esp_log_level = ESP_LOG_ERROR;
+        break;
+    case 'W':
+        esp_log_level = ESP_LOG_WARN;
+        break;
+    case 'I':
+        esp_log_level = ESP_LOG_INFO;
+        break;
+    case 'D':
+        esp_log_level = ESP_LOG_DEBUG;
+        break;
+    case 'V':
+        esp_log_level = ESP_LOG_VERBOSE;
+        break;
+    default:
+        break;
+    }
+}
+
+static bool esp_log_is_enabled(esp_log_level_t level)
+{
+    pthread_once(&esp_log_once, esp_log_init);
+
+    return level != ESP_LOG_NONE && level <= esp_log_level;
+}
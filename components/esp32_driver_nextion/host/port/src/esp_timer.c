@@ -0,0 +1,7 @@
+#include "esp_timer.h"
+#include "host_port.h"
+
+int64_t esp_timer_get_time(void)
+{
+    return (int64_t)host_port_clock_us();
+}
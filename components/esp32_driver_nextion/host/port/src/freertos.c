@@ -0,0 +1,676 @@
+#define _GNU_SOURCE
+#include <string.h>
+#include <time.h>
+#include <sched.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "host_port.h"
+
+/**
+ * @brief Longest uninterrupted wait; a task checks if it was deleted or suspended this often.
+ */
+#define HOST_PORT_WAIT_SLICE_US 10000U
+
+struct tskTaskControlBlock
+{
+    pthread_t thread;         /** @brief Thread running the task. */
+    TaskFunction_t code;      /** @brief Task function. */
+    void *parameters;         /** @brief Task function argument. */
+    pthread_mutex_t lock;     /** @brief Recursive; guards the fields below. */
+    pthread_cond_t changed;   /** @brief Signaled when a field below changes. */
+    uint32_t notification;    /** @brief Notification value. */
+    bool *started;            /** @brief Set once the task first blocks; owned by its creator. */
+    bool is_suspended;        /** @brief If it must stop at its next blocking point. */
+    bool is_deleted;          /** @brief If it must exit at its next blocking point. */
+    bool is_foreign;          /** @brief If the thread was not created by "xTaskCreate", e.g. the main thread. */
+};
+
+struct QueueDefinition
+{
+    pthread_mutex_t lock;   /** @brief Guards the fields below. */
+    pthread_cond_t changed; /** @brief Signaled when an item is added or removed. */
+    uint8_t *storage;       /** @brief Items; NULL for semaphores. */
+    UBaseType_t length;     /** @brief Maximum item count. */
+    UBaseType_t item_size;  /** @brief Item size; zero for semaphores. */
+    UBaseType_t count;      /** @brief Current item count. */
+    UBaseType_t head;       /** @brief Index of the oldest item. */
+    QueueSetHandle_t set;   /** @brief Queue set it belongs to, or NULL. */
+};
+
+static __thread TaskHandle_t host_current_task = NULL;
+static pthread_mutex_t host_start_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t host_start_changed = PTHREAD_COND_INITIALIZER;
+static pthread_once_t host_clock_once = PTHREAD_ONCE_INIT;
+static struct timespec host_clock_origin;
+
+static void host_clock_init(void);
+static struct timespec host_clock_timespec(uint64_t time_us);
+static TaskHandle_t host_task_alloc(void);
+static void host_task_free(TaskHandle_t task);
+static TaskHandle_t host_task_self(void);
+static void host_task_mark_started(TaskHandle_t task);
+static void host_task_checkpoint(TaskHandle_t task);
+static void host_task_exit(TaskHandle_t task) __attribute__((noreturn));
+static void *host_task_entry(void *argument);
+
+/* ======================
+ *      Port Helpers
+ *======================= */
+
+uint64_t host_port_clock_us(void)
+{
+    pthread_once(&host_clock_once, host_clock_init);
+
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint64_t)(now.tv_sec - host_clock_origin.tv_sec) * 1000000U + (uint64_t)(now.tv_nsec / 1000) - (uint64_t)(host_clock_origin.tv_nsec / 1000);
+}
+
+uint64_t host_port_deadline(TickType_t ticks)
+{
+    if (ticks == portMAX_DELAY)
+    {
+        return HOST_PORT_FOREVER;
+    }
+
+    return host_port_clock_us() + (uint64_t)ticks * 1000000U / configTICK_RATE_HZ;
+}
+
+void host_port_cond_init(pthread_cond_t *cond)
+{
+    pthread_condattr_t attributes;
+
+    pthread_condattr_init(&attributes);
+    pthread_condattr_setclock(&attributes, CLOCK_MONOTONIC);
+    pthread_cond_init(cond, &attributes);
+    pthread_condattr_destroy(&attributes);
+}
+
+bool host_port_wait(pthread_cond_t *cond, pthread_mutex_t *mutex, uint64_t deadline_us)
+{
+    uint64_t now = host_port_clock_us();
+
+    if (now >= deadline_us)
+    {
+        return false;
+    }
+
+    TaskHandle_t self = host_task_self();
+
+    host_task_mark_started(self);
+
+    uint64_t wake_up = deadline_us - now > HOST_PORT_WAIT_SLICE_US ? now + HOST_PORT_WAIT_SLICE_US : deadline_us;
+    struct timespec until = host_clock_timespec(wake_up);
+
+    pthread_cond_timedwait(cond, mutex, &until);
+
+    if (!self->is_foreign)
+    {
+        pthread_mutex_unlock(mutex);
+
+        host_task_checkpoint(self);
+
+        pthread_mutex_lock(mutex);
+    }
+
+    return host_port_clock_us() < deadline_us;
+}
+
+void host_port_sleep_until(uint64_t deadline_us)
+{
+    struct timespec until = host_clock_timespec(deadline_us);
+
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &until, NULL) != 0)
+    {
+    }
+}
+
+/* ======================
+ *   Critical Sections
+ *======================= */
+
+void vPortHostMuxInitialize(portMUX_TYPE *mux)
+{
+    pthread_mutexattr_t attributes;
+
+    pthread_mutexattr_init(&attributes);
+    pthread_mutexattr_settype(&attributes, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&mux->mutex, &attributes);
+    pthread_mutexattr_destroy(&attributes);
+}
+
+void vPortHostMuxEnter(portMUX_TYPE *mux)
+{
+    pthread_mutex_lock(&mux->mutex);
+}
+
+void vPortHostMuxExit(portMUX_TYPE *mux)
+{
+    pthread_mutex_unlock(&mux->mutex);
+}
+
+/* ======================
+ *         Tasks
+ *======================= */
+
+BaseType_t xTaskCreate(TaskFunction_t task_code,
+                       const char *name,
+                       uint32_t stack_depth,
+                       void *parameters,
+                       UBaseType_t priority,
+                       TaskHandle_t *created_task)
+{
+    (void)name;
+    (void)stack_depth;
+    (void)priority;
+
+    TaskHandle_t task = host_task_alloc();
+    bool started = false;
+
+    if (task == NULL)
+    {
+        return pdFAIL;
+    }
+
+    task->code = task_code;
+    task->parameters = parameters;
+    task->started = &started;
+
+    // As in FreeRTOS, the handle is set before the task runs.
+    if (created_task != NULL)
+    {
+        *created_task = task;
+    }
+
+    if (pthread_create(&task->thread, NULL, host_task_entry, task) != 0)
+    {
+        host_task_free(task);
+
+        return pdFAIL;
+    }
+
+    // The task memory might be gone once it has started; only the flag is read.
+    pthread_mutex_lock(&host_start_lock);
+
+    while (!started)
+    {
+        pthread_cond_wait(&host_start_changed, &host_start_lock);
+    }
+
+    pthread_mutex_unlock(&host_start_lock);
+
+    return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+    TaskHandle_t self = host_task_self();
+
+    if (task == NULL || task == self)
+    {
+        host_task_exit(self);
+    }
+
+    if (task->is_foreign)
+    {
+        return;
+    }
+
+    pthread_mutex_lock(&task->lock);
+
+    task->is_deleted = true;
+
+    pthread_cond_broadcast(&task->changed);
+    pthread_mutex_unlock(&task->lock);
+
+    // It exits at its next blocking point.
+    pthread_join(task->thread, NULL);
+
+    host_task_free(task);
+}
+
+void vTaskDelay(TickType_t ticks_to_delay)
+{
+    if (ticks_to_delay == 0)
+    {
+        sched_yield();
+
+        return;
+    }
+
+    TaskHandle_t self = host_task_self();
+    uint64_t deadline = host_port_deadline(ticks_to_delay);
+
+    pthread_mutex_lock(&self->lock);
+
+    while (host_port_wait(&self->changed, &self->lock, deadline))
+    {
+    }
+
+    pthread_mutex_unlock(&self->lock);
+}
+
+void vTaskSuspend(TaskHandle_t task)
+{
+    TaskHandle_t self = host_task_self();
+
+    if (task == NULL)
+    {
+        task = self;
+    }
+
+    pthread_mutex_lock(&task->lock);
+
+    task->is_suspended = true;
+
+    pthread_mutex_unlock(&task->lock);
+
+    if (task == self)
+    {
+        host_task_mark_started(self);
+        host_task_checkpoint(self);
+    }
+}
+
+void vTaskResume(TaskHandle_t task)
+{
+    pthread_mutex_lock(&task->lock);
+
+    task->is_suspended = false;
+
+    pthread_cond_broadcast(&task->changed);
+    pthread_mutex_unlock(&task->lock);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return host_task_self();
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return (TickType_t)(host_port_clock_us() * configTICK_RATE_HZ / 1000000U);
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+    pthread_mutex_lock(&task->lock);
+
+    task->notification++;
+
+    pthread_cond_broadcast(&task->changed);
+    pthread_mutex_unlock(&task->lock);
+
+    return pdPASS;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_count_on_exit, TickType_t ticks_to_wait)
+{
+    TaskHandle_t self = host_task_self();
+    uint64_t deadline = host_port_deadline(ticks_to_wait);
+
+    pthread_mutex_lock(&self->lock);
+
+    while (self->notification == 0 && host_port_wait(&self->changed, &self->lock, deadline))
+    {
+    }
+
+    uint32_t value = self->notification;
+
+    if (value > 0)
+    {
+        self->notification = clear_count_on_exit ? 0 : value - 1;
+    }
+
+    pthread_mutex_unlock(&self->lock);
+
+    return value;
+}
+
+/* ======================
+ *         Queues
+ *======================= */
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size)
+{
+    QueueHandle_t queue = (QueueHandle_t)calloc(1, sizeof(struct QueueDefinition));
+
+    if (queue == NULL)
+    {
+        return NULL;
+    }
+
+    if (item_size > 0)
+    {
+        queue->storage = (uint8_t *)calloc(length, item_size);
+
+        if (queue->storage == NULL)
+        {
+            free(queue);
+
+            return NULL;
+        }
+    }
+
+    queue->length = length;
+    queue->item_size = item_size;
+
+    pthread_mutex_init(&queue->lock, NULL);
+    host_port_cond_init(&queue->changed);
+
+    return queue;
+}
+
+QueueHandle_t xQueueCreateCountingSemaphore(UBaseType_t max_count, UBaseType_t initial_count)
+{
+    QueueHandle_t queue = xQueueCreate(max_count, 0);
+
+    if (queue != NULL)
+    {
+        queue->count = initial_count;
+    }
+
+    return queue;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticks_to_wait)
+{
+    uint64_t deadline = host_port_deadline(ticks_to_wait);
+
+    pthread_mutex_lock(&queue->lock);
+
+    while (queue->count == queue->length)
+    {
+        if (!host_port_wait(&queue->changed, &queue->lock, deadline) && queue->count == queue->length)
+        {
+            pthread_mutex_unlock(&queue->lock);
+
+            return pdFALSE;
+        }
+    }
+
+    if (queue->item_size > 0)
+    {
+        size_t index = (queue->head + queue->count) % queue->length;
+
+        memcpy(queue->storage + index * queue->item_size, item, queue->item_size);
+    }
+
+    queue->count++;
+
+    // As in FreeRTOS, the set gets an entry per item; a full set loses it.
+    if (queue->set != NULL)
+    {
+        xQueueSend(queue->set, &queue, 0);
+    }
+
+    pthread_cond_broadcast(&queue->changed);
+    pthread_mutex_unlock(&queue->lock);
+
+    return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *buffer, TickType_t ticks_to_wait)
+{
+    uint64_t deadline = host_port_deadline(ticks_to_wait);
+
+    pthread_mutex_lock(&queue->lock);
+
+    while (queue->count == 0)
+    {
+        if (!host_port_wait(&queue->changed, &queue->lock, deadline) && queue->count == 0)
+        {
+            pthread_mutex_unlock(&queue->lock);
+
+            return pdFALSE;
+        }
+    }
+
+    if (queue->item_size > 0 && buffer != NULL)
+    {
+        memcpy(buffer, queue->storage + queue->head * queue->item_size, queue->item_size);
+    }
+
+    queue->head = (queue->head + 1) % queue->length;
+    queue->count--;
+
+    pthread_cond_broadcast(&queue->changed);
+    pthread_mutex_unlock(&queue->lock);
+
+    return pdTRUE;
+}
+
+BaseType_t xQueueReset(QueueHandle_t queue)
+{
+    pthread_mutex_lock(&queue->lock);
+
+    queue->head = 0;
+    queue->count = 0;
+
+    pthread_cond_broadcast(&queue->changed);
+    pthread_mutex_unlock(&queue->lock);
+
+    return pdPASS;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue)
+{
+    pthread_mutex_lock(&queue->lock);
+
+    UBaseType_t count = queue->count;
+
+    pthread_mutex_unlock(&queue->lock);
+
+    return count;
+}
+
+void vQueueDelete(QueueHandle_t queue)
+{
+    pthread_mutex_destroy(&queue->lock);
+    pthread_cond_destroy(&queue->changed);
+
+    free(queue->storage);
+    free(queue);
+}
+
+/* ======================
+ *       Queue Sets
+ *======================= */
+
+QueueSetHandle_t xQueueCreateSet(UBaseType_t event_queue_length)
+{
+    return xQueueCreate(event_queue_length, sizeof(QueueSetMemberHandle_t));
+}
+
+BaseType_t xQueueAddToSet(QueueSetMemberHandle_t member, QueueSetHandle_t set)
+{
+    BaseType_t result = pdFAIL;
+
+    pthread_mutex_lock(&member->lock);
+
+    // Items already there would have no entry in the set.
+    if (member->set == NULL && member->count == 0)
+    {
+        member->set = set;
+        result = pdPASS;
+    }
+
+    pthread_mutex_unlock(&member->lock);
+
+    return result;
+}
+
+BaseType_t xQueueRemoveFromSet(QueueSetMemberHandle_t member, QueueSetHandle_t set)
+{
+    BaseType_t result = pdFAIL;
+
+    pthread_mutex_lock(&member->lock);
+
+    if (member->set == set && member->count == 0)
+    {
+        member->set = NULL;
+        result = pdPASS;
+    }
+
+    pthread_mutex_unlock(&member->lock);
+
+    return result;
+}
+
+QueueSetMemberHandle_t xQueueSelectFromSet(QueueSetHandle_t set, TickType_t ticks_to_wait)
+{
+    QueueSetMemberHandle_t member = NULL;
+
+    return xQueueReceive(set, &member, ticks_to_wait) == pdTRUE ? member : NULL;
+}
+
+/* ======================
+ *     Core Methods
+ *======================= */
+
+static void host_clock_init(void)
+{
+    clock_gettime(CLOCK_MONOTONIC, &host_clock_origin);
+}
+
+static struct timespec host_clock_timespec(uint64_t time_us)
+{
+    pthread_once(&host_clock_once, host_clock_init);
+
+    uint64_t nanoseconds = (uint64_t)host_clock_origin.tv_nsec + (time_us % 1000000U) * 1000U;
+    struct timespec result = {
+        .tv_sec = host_clock_origin.tv_sec + (time_t)(time_us / 1000000U) + (time_t)(nanoseconds / 1000000000U),
+        .tv_nsec = (long)(nanoseconds % 1000000000U)};
+
+    return result;
+}
+
+static TaskHandle_t host_task_alloc(void)
+{
+    TaskHandle_t task = (TaskHandle_t)calloc(1, sizeof(struct tskTaskControlBlock));
+
+    if (task == NULL)
+    {
+        return NULL;
+    }
+
+    // A task waits on its own lock and checks its flags under it, nested.
+    pthread_mutexattr_t attributes;
+
+    pthread_mutexattr_init(&attributes);
+    pthread_mutexattr_settype(&attributes, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&task->lock, &attributes);
+    pthread_mutexattr_destroy(&attributes);
+
+    host_port_cond_init(&task->changed);
+
+    return task;
+}
+
+static void host_task_free(TaskHandle_t task)
+{
+    pthread_mutex_destroy(&task->lock);
+    pthread_cond_destroy(&task->changed);
+
+    free(task);
+}
+
+/**
+ * @brief Get the running task, creating one for threads that are not tasks.
+ * @return Task handle.
+ */
+static TaskHandle_t host_task_self(void)
+{
+    if (host_current_task == NULL)
+    {
+        host_current_task = host_task_alloc();
+
+        if (host_current_task == NULL)
+        {
+            abort();
+        }
+
+        host_current_task->thread = pthread_self();
+        host_current_task->is_foreign = true;
+    }
+
+    return host_current_task;
+}
+
+/**
+ * @brief Let the creator of a task return from "xTaskCreate".
+ * @param task Task handle.
+ */
+static void host_task_mark_started(TaskHandle_t task)
+{
+    pthread_mutex_lock(&host_start_lock);
+
+    if (task->started != NULL)
+    {
+        *task->started = true;
+        task->started = NULL;
+
+        pthread_cond_broadcast(&host_start_changed);
+    }
+
+    pthread_mutex_unlock(&host_start_lock);
+}
+
+/**
+ * @brief Exit if the task was deleted, or wait while it is suspended.
+ * @param task Running task.
+ */
+static void host_task_checkpoint(TaskHandle_t task)
+{
+    pthread_mutex_lock(&task->lock);
+
+    while (task->is_suspended && !task->is_deleted)
+    {
+        pthread_cond_wait(&task->changed, &task->lock);
+    }
+
+    bool is_deleted = task->is_deleted;
+
+    pthread_mutex_unlock(&task->lock);
+
+    if (is_deleted)
+    {
+        // Whoever deleted it is joining the thread and frees the task.
+        pthread_exit(NULL);
+    }
+}
+
+/**
+ * @brief End the running task, which deleted itself or returned.
+ * @param task Running task.
+ */
+static void host_task_exit(TaskHandle_t task)
+{
+    host_task_mark_started(task);
+
+    host_current_task = NULL;
+
+    if (!task->is_foreign)
+    {
+        pthread_detach(pthread_self());
+    }
+
+    host_task_free(task);
+
+    pthread_exit(NULL);
+}
+
+static void *host_task_entry(void *argument)
+{
+    TaskHandle_t task = (TaskHandle_t)argument;
+
+    host_current_task = task;
+
+    task->code(task->parameters);
+
+    // FreeRTOS tasks must not return; take it as a deletion.
+    host_task_exit(task);
+}
@@ -0,0 +1,50 @@
+#ifndef __NEXTION_HOST_PORT_H__
+#define __NEXTION_HOST_PORT_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include "freertos/FreeRTOS.h"
+
+/**
+ * @brief Deadline meaning "wait forever".
+ */
+#define HOST_PORT_FOREVER UINT64_MAX
+
+/**
+ * @brief Get the monotonic time since the process started.
+ * @return Time in microseconds.
+ */
+uint64_t host_port_clock_us(void);
+
+/**
+ * @brief Convert a wait in ticks into a deadline.
+ * @param ticks Ticks to wait; portMAX_DELAY waits forever.
+ * @return Deadline in microseconds, or HOST_PORT_FOREVER.
+ */
+uint64_t host_port_deadline(TickType_t ticks);
+
+/**
+ * @brief Initialize a condition variable on the monotonic clock.
+ * @param cond Condition variable.
+ */
+void host_port_cond_init(pthread_cond_t *cond);
+
+/**
+ * @brief Wait on a condition variable for a while, as a task blocking point.
+ * @details A deleted task exits here and a suspended task stays here until
+ * resumed, with the mutex released.
+ * @param cond Condition variable.
+ * @param mutex Locked mutex.
+ * @param deadline_us When to give up.
+ * @return False if the deadline has passed, otherwise true; the caller checks its condition again.
+ */
+bool host_port_wait(pthread_cond_t *cond, pthread_mutex_t *mutex, uint64_t deadline_us);
+
+/**
+ * @brief Sleep until a given time, without being a blocking point.
+ * @param deadline_us Wake up time in microseconds.
+ */
+void host_port_sleep_until(uint64_t deadline_us);
+
+#endif
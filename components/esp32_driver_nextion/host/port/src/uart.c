@@ -0,0 +1,457 @@
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <limits.h>
+#include <stdatomic.h>
+#include "driver/uart.h"
+#include "uart_host.h"
+#include "serial_line.h"
+#include "host_port.h"
+
+/**
+ * @brief How often the reader thread checks if it must stop.
+ */
+#define HOST_UART_POLL_TIME_MS 10
+
+/**
+ * @struct host_uart_t
+ * @brief A UART port wired to a terminal device.
+ * @details A reader thread plays the role of the RX interrupt: it moves
+ * received bytes into the RX ring and posts UART_DATA events. Writes are
+ * paced at the baud rate, as the hardware would send them.
+ */
+typedef struct
+{
+    char device[PATH_MAX];   /** @brief Terminal device path. */
+    uart_config_t config;    /** @brief Line configuration. */
+    int fd;                  /** @brief Terminal file descriptor. */
+    pthread_t reader;        /** @brief Reader thread. */
+    atomic_bool stop;        /** @brief If the reader thread must stop. */
+    pthread_mutex_t lock;    /** @brief Guards the fields below. */
+    pthread_cond_t changed;  /** @brief Signaled when the RX ring changes. */
+    uint8_t *rx;             /** @brief RX ring. */
+    size_t rx_capacity;      /** @brief RX ring length. */
+    size_t rx_head;          /** @brief Index of the oldest byte. */
+    size_t rx_count;         /** @brief How many bytes are in the RX ring. */
+    bool rx_full_reported;   /** @brief If UART_BUFFER_FULL was posted for the current overflow. */
+    QueueHandle_t queue;     /** @brief Event queue, or NULL. */
+    uint64_t tx_done_at_us;  /** @brief When the last written byte leaves the line. */
+    bool is_installed;       /** @brief If the driver was installed. */
+} host_uart_t;
+
+static host_uart_t host_uarts[UART_NUM_MAX];
+
+static bool host_uart_is_valid(uart_port_t uart_num);
+static uint64_t host_uart_byte_time_ns(const host_uart_t *uart);
+static void host_uart_post(host_uart_t *uart, uart_event_type_t type, size_t size);
+static void *host_uart_reader(void *argument);
+
+esp_err_t uart_host_set_device(uart_port_t uart_num, const char *path)
+{
+    if (!host_uart_is_valid(uart_num) || path == NULL || strlen(path) >= PATH_MAX)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    strcpy(host_uarts[uart_num].device, path);
+
+    return ESP_OK;
+}
+
+esp_err_t uart_param_config(uart_port_t uart_num, const uart_config_t *uart_config)
+{
+    if (!host_uart_is_valid(uart_num) || uart_config == NULL || uart_config->baud_rate <= 0)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    host_uarts[uart_num].config = *uart_config;
+
+    return ESP_OK;
+}
+
+esp_err_t uart_set_pin(uart_port_t uart_num, int tx_io_num, int rx_io_num, int rts_io_num, int cts_io_num)
+{
+    (void)tx_io_num;
+    (void)rx_io_num;
+    (void)rts_io_num;
+    (void)cts_io_num;
+
+    return host_uart_is_valid(uart_num) ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t uart_driver_install(uart_port_t uart_num,
+                              int rx_buffer_size,
+                              int tx_buffer_size,
+                              int queue_size,
+                              QueueHandle_t *uart_queue,
+                              int intr_alloc_flags)
+{
+    (void)tx_buffer_size;
+    (void)intr_alloc_flags;
+
+    if (!host_uart_is_valid(uart_num) || rx_buffer_size <= 0)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    host_uart_t *uart = &host_uarts[uart_num];
+
+    if (uart->is_installed || uart->device[0] == '\0' || uart->config.baud_rate <= 0)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    uart->fd = open(uart->device, O_RDWR | O_NOCTTY | O_NONBLOCK);
+
+    if (uart->fd < 0)
+    {
+        return ESP_FAIL;
+    }
+
+    if (!serial_line_set_raw(uart->fd) || !serial_line_set_baud_rate(uart->fd, (uint32_t)uart->config.baud_rate))
+    {
+        close(uart->fd);
+
+        return ESP_FAIL;
+    }
+
+    uart->rx = (uint8_t *)malloc((size_t)rx_buffer_size);
+    uart->rx_capacity = (size_t)rx_buffer_size;
+    uart->rx_head = 0;
+    uart->rx_count = 0;
+    uart->rx_full_reported = false;
+    uart->tx_done_at_us = 0;
+    uart->queue = NULL;
+
+    if (uart_queue != NULL && queue_size > 0)
+    {
+        uart->queue = xQueueCreate((UBaseType_t)queue_size, sizeof(uart_event_t));
+        *uart_queue = uart->queue;
+    }
+
+    pthread_mutex_init(&uart->lock, NULL);
+    host_port_cond_init(&uart->changed);
+    atomic_store(&uart->stop, false);
+
+    if (pthread_create(&uart->reader, NULL, host_uart_reader, uart) != 0)
+    {
+        close(uart->fd);
+        free(uart->rx);
+
+        return ESP_FAIL;
+    }
+
+    uart->is_installed = true;
+
+    return ESP_OK;
+}
+
+esp_err_t uart_driver_delete(uart_port_t uart_num)
+{
+    if (!host_uart_is_valid(uart_num) || !host_uarts[uart_num].is_installed)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    host_uart_t *uart = &host_uarts[uart_num];
+
+    atomic_store(&uart->stop, true);
+
+    pthread_join(uart->reader, NULL);
+
+    close(uart->fd);
+
+    if (uart->queue != NULL)
+    {
+        vQueueDelete(uart->queue);
+    }
+
+    pthread_mutex_destroy(&uart->lock);
+    pthread_cond_destroy(&uart->changed);
+
+    free(uart->rx);
+
+    uart->is_installed = false;
+
+    return ESP_OK;
+}
+
+esp_err_t uart_set_baudrate(uart_port_t uart_num, uint32_t baudrate)
+{
+    if (!host_uart_is_valid(uart_num) || baudrate == 0)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    host_uart_t *uart = &host_uarts[uart_num];
+
+    if (uart->is_installed && !serial_line_set_baud_rate(uart->fd, baudrate))
+    {
+        return ESP_FAIL;
+    }
+
+    uart->config.baud_rate = (int)baudrate;
+
+    return ESP_OK;
+}
+
+esp_err_t uart_get_baudrate(uart_port_t uart_num, uint32_t *baudrate)
+{
+    if (!host_uart_is_valid(uart_num) || baudrate == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    *baudrate = (uint32_t)host_uarts[uart_num].config.baud_rate;
+
+    return ESP_OK;
+}
+
+int uart_write_bytes(uart_port_t uart_num, const void *src, size_t size)
+{
+    if (!host_uart_is_valid(uart_num) || !host_uarts[uart_num].is_installed || src == NULL)
+    {
+        return -1;
+    }
+
+    host_uart_t *uart = &host_uarts[uart_num];
+    const uint8_t *bytes = (const uint8_t *)src;
+
+    for (size_t written = 0; written < size;)
+    {
+        ssize_t result = write(uart->fd, bytes + written, size - written);
+
+        if (result > 0)
+        {
+            written += (size_t)result;
+        }
+        else if (result < 0 && errno != EAGAIN && errno != EINTR)
+        {
+            return -1;
+        }
+        else
+        {
+            struct pollfd descriptor = {.fd = uart->fd, .events = POLLOUT};
+
+            poll(&descriptor, 1, HOST_UART_POLL_TIME_MS);
+        }
+    }
+
+    // The bytes are on the line one after another, after whatever was still being sent.
+
+    uint64_t byte_time_ns = host_uart_byte_time_ns(uart);
+    uint64_t now = host_port_clock_us();
+    uint64_t start = uart->tx_done_at_us > now ? uart->tx_done_at_us : now;
+
+    uart->tx_done_at_us = start + size * byte_time_ns / 1000U;
+
+    // Without a TX buffer, the call returns once the rest fits in the hardware FIFO.
+    uint64_t fifo_time_us = UART_HW_FIFO_LEN(uart_num) * byte_time_ns / 1000U;
+
+    if (uart->tx_done_at_us > now + fifo_time_us)
+    {
+        host_port_sleep_until(uart->tx_done_at_us - fifo_time_us);
+    }
+
+    return (int)size;
+}
+
+esp_err_t uart_wait_tx_done(uart_port_t uart_num, TickType_t ticks_to_wait)
+{
+    if (!host_uart_is_valid(uart_num) || !host_uarts[uart_num].is_installed)
+    {
+        return ESP_FAIL;
+    }
+
+    uint64_t done_at = host_uarts[uart_num].tx_done_at_us;
+    uint64_t deadline = host_port_deadline(ticks_to_wait);
+
+    if (done_at > deadline)
+    {
+        host_port_sleep_until(deadline);
+
+        return ESP_ERR_TIMEOUT;
+    }
+
+    host_port_sleep_until(done_at);
+
+    return ESP_OK;
+}
+
+int uart_read_bytes(uart_port_t uart_num, void *buf, uint32_t length, TickType_t ticks_to_wait)
+{
+    if (!host_uart_is_valid(uart_num) || !host_uarts[uart_num].is_installed || buf == NULL)
+    {
+        return -1;
+    }
+
+    host_uart_t *uart = &host_uarts[uart_num];
+    uint8_t *bytes = (uint8_t *)buf;
+    uint64_t deadline = host_port_deadline(ticks_to_wait);
+
+    pthread_mutex_lock(&uart->lock);
+
+    while (uart->rx_count < length && host_port_wait(&uart->changed, &uart->lock, deadline))
+    {
+    }
+
+    size_t count = uart->rx_count < length ? uart->rx_count : length;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        bytes[i] = uart->rx[uart->rx_head];
+        uart->rx_head = (uart->rx_head + 1) % uart->rx_capacity;
+    }
+
+    uart->rx_count -= count;
+
+    pthread_cond_broadcast(&uart->changed);
+    pthread_mutex_unlock(&uart->lock);
+
+    return (int)count;
+}
+
+esp_err_t uart_get_buffered_data_len(uart_port_t uart_num, size_t *size)
+{
+    if (!host_uart_is_valid(uart_num) || !host_uarts[uart_num].is_installed || size == NULL)
+    {
+        return ESP_FAIL;
+    }
+
+    host_uart_t *uart = &host_uarts[uart_num];
+
+    pthread_mutex_lock(&uart->lock);
+
+    *size = uart->rx_count;
+
+    pthread_mutex_unlock(&uart->lock);
+
+    return ESP_OK;
+}
+
+esp_err_t uart_flush_input(uart_port_t uart_num)
+{
+    if (!host_uart_is_valid(uart_num) || !host_uarts[uart_num].is_installed)
+    {
+        return ESP_FAIL;
+    }
+
+    host_uart_t *uart = &host_uarts[uart_num];
+
+    pthread_mutex_lock(&uart->lock);
+
+    uart->rx_head = 0;
+    uart->rx_count = 0;
+
+    pthread_cond_broadcast(&uart->changed);
+    pthread_mutex_unlock(&uart->lock);
+
+    return ESP_OK;
+}
+
+esp_err_t uart_flush(uart_port_t uart_num)
+{
+    return uart_flush_input(uart_num);
+}
+
+static bool host_uart_is_valid(uart_port_t uart_num)
+{
+    return uart_num >= 0 && uart_num < UART_NUM_MAX;
+}
+
+/**
+ * @brief Time a byte takes on the line: start bit, data bits, parity and stop bits.
+ * @param uart UART pointer.
+ * @return Time in nanoseconds.
+ */
+static uint64_t host_uart_byte_time_ns(const host_uart_t *uart)
+{
+    uint64_t bits = 1U + 5U + (uint64_t)uart->config.data_bits;
+
+    bits += uart->config.parity == UART_PARITY_DISABLE ? 0U : 1U;
+    bits += uart->config.stop_bits == UART_STOP_BITS_1 ? 1U : 2U;
+
+    return bits * 1000000000U / (uint64_t)uart->config.baud_rate;
+}
+
+/**
+ * @brief Post an event, dropping it if the queue is full, as from an interrupt.
+ * @param uart UART pointer.
+ * @param type Event type.
+ * @param size Received bytes count.
+ */
+static void host_uart_post(host_uart_t *uart, uart_event_type_t type, size_t size)
+{
+    if (uart->queue == NULL)
+    {
+        return;
+    }
+
+    uart_event_t event = {.type = type, .size = size, .timeout_flag = false};
+
+    xQueueSend(uart->queue, &event, 0);
+}
+
+static void *host_uart_reader(void *argument)
+{
+    host_uart_t *uart = (host_uart_t *)argument;
+    uint8_t buffer[256];
+
+    while (!atomic_load(&uart->stop))
+    {
+        pthread_mutex_lock(&uart->lock);
+
+        size_t room = uart->rx_capacity - uart->rx_count;
+
+        if (room == 0 && !uart->rx_full_reported)
+        {
+            uart->rx_full_reported = true;
+
+            host_uart_post(uart, UART_BUFFER_FULL, 0);
+        }
+
+        pthread_mutex_unlock(&uart->lock);
+
+        // Bytes that do not fit wait in the terminal until the ring is drained.
+        struct pollfd descriptor = {.fd = uart->fd, .events = POLLIN};
+
+        if (room == 0 || poll(&descriptor, 1, HOST_UART_POLL_TIME_MS) <= 0 || (descriptor.revents & POLLIN) == 0)
+        {
+            if (room == 0)
+            {
+                host_port_sleep_until(host_port_clock_us() + HOST_UART_POLL_TIME_MS * 1000U);
+            }
+
+            continue;
+        }
+
+        ssize_t count = read(uart->fd, buffer, room < sizeof(buffer) ? room : sizeof(buffer));
+
+        if (count <= 0)
+        {
+            continue;
+        }
+
+        pthread_mutex_lock(&uart->lock);
+
+        for (ssize_t i = 0; i < count; i++)
+        {
+            uart->rx[(uart->rx_head + uart->rx_count) % uart->rx_capacity] = buffer[i];
+            uart->rx_count++;
+        }
+
+        uart->rx_full_reported = false;
+
+        pthread_cond_broadcast(&uart->changed);
+        pthread_mutex_unlock(&uart->lock);
+
+        host_uart_post(uart, UART_DATA, (size_t)count);
+    }
+
+    return NULL;
+}
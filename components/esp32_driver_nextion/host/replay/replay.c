@@ -0,0 +1,746 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <time.h>
+#include "esp32_driver_nextion/base/constants.h"
+#include "esp32_driver_nextion/base/codes.h"
+#include "frame_parser.h"
+
+#define REPLAY_TAG "nexcap "
+#define REPLAY_MAX_LINE 512
+#define REPLAY_MAX_COMMAND 96
+#define REPLAY_QUEUE_SIZE 64
+#define REPLAY_CODE_COUNT 256
+
+/**
+ * @typedef replay_expect_t
+ * @brief What a command waits for, as the driver registers it.
+ */
+typedef enum
+{
+    REPLAY_EXPECT_ACK = 0,     /** @brief A simple response (ACK). */
+    REPLAY_EXPECT_DATA = 1,    /** @brief A response carrying data; "get" and "sendme". */
+    REPLAY_EXPECT_RAW = 2,     /** @brief A number of bytes without code or termination; "rept". */
+    REPLAY_EXPECT_SILENT = 3,  /** @brief A simple response on failure only; "add". A timeout is a success. */
+    REPLAY_EXPECT_FINISHED = 4 /** @brief The end of "Transparent Data Mode", once its data was written. */
+} replay_expect_t;
+
+/**
+ * @struct replay_record_t
+ * @brief A captured run of bytes.
+ */
+typedef struct
+{
+    int64_t timestamp_us; /** @brief When the bytes were written or read. */
+    bool is_rx;           /** @brief If the bytes were read; otherwise written. */
+    size_t length;        /** @brief How many bytes there are. */
+    uint8_t *bytes;       /** @brief Bytes. */
+} replay_record_t;
+
+/**
+ * @struct replay_command_t
+ * @brief A command waiting for its response.
+ */
+typedef struct
+{
+    char text[REPLAY_MAX_COMMAND]; /** @brief Command, printable. */
+    replay_expect_t expect;        /** @brief What it waits for. */
+    size_t raw_length;             /** @brief How many raw bytes it waits for. */
+    size_t raw_received;           /** @brief How many raw bytes it received. */
+    int64_t written_at;            /** @brief When it was written. */
+    int64_t deadline;              /** @brief When it times out; restarted when it reaches the queue head. */
+    bool is_armed;                 /** @brief If it can time out; the end of "Transparent Data Mode" waits for its data. */
+} replay_command_t;
+
+/**
+ * @struct replay_t
+ * @brief Replay state and results.
+ */
+typedef struct
+{
+    // Settings.
+    int64_t wait_us;                           /** @brief Response wait time. */
+    bool is_verbose;                           /** @brief If every command is printed. */
+
+    // Matcher.
+    nextion_frame_parser_t parser;             /** @brief Parser of received frames. */
+    replay_command_t queue[REPLAY_QUEUE_SIZE]; /** @brief Commands waiting for a response, in the order they were written. */
+    size_t queue_head;                         /** @brief Index of the oldest command. */
+    size_t queue_count;                        /** @brief How many commands wait. */
+    uint8_t command[REPLAY_MAX_COMMAND];       /** @brief Command being written. */
+    size_t command_length;                     /** @brief How many bytes of the command were written. */
+    size_t command_ends;                       /** @brief How many termination bytes were written in a row. */
+    size_t transparent_remaining;              /** @brief Bytes of "Transparent Data Mode" still to be written. */
+
+    // Results.
+    size_t commands;                           /** @brief Commands written. */
+    size_t bytes_tx;                           /** @brief Bytes written. */
+    size_t bytes_rx;                           /** @brief Bytes read. */
+    size_t acks[REPLAY_CODE_COUNT];            /** @brief Simple responses, by code. */
+    size_t data;                               /** @brief Responses carrying data. */
+    size_t unexpected;                         /** @brief Responses received while no command waited. */
+    size_t timeouts;                           /** @brief Commands without response in time. */
+    size_t silent;                             /** @brief "add" commands that succeeded silently. */
+    size_t overflowed;                         /** @brief Commands not tracked because too many waited. */
+    size_t events;                             /** @brief Events received. */
+    size_t events_on_command_path;             /** @brief Events received while a command waited. */
+    size_t unanswered;                         /** @brief Commands still waiting at the end of the capture. */
+    int64_t *latencies;                        /** @brief Response latency of each answered command. */
+    size_t latency_count;                      /** @brief How many latencies there are. */
+    size_t latency_capacity;                   /** @brief How many latencies fit. */
+} replay_t;
+
+static bool replay_load(FILE *file, replay_record_t **records, size_t *count, char *summary, size_t summary_size);
+static void replay_reset(replay_t *replay);
+static void replay_run(replay_t *replay, const replay_record_t *records, size_t count);
+static void replay_tx(replay_t *replay, int64_t timestamp_us, const uint8_t *bytes, size_t length);
+static void replay_rx(replay_t *replay, int64_t timestamp_us, const uint8_t *bytes, size_t length);
+static void replay_frame(replay_t *replay, int64_t timestamp_us);
+static void replay_command_written(replay_t *replay, int64_t timestamp_us);
+static replay_command_t *replay_push(replay_t *replay, replay_expect_t expect, int64_t timestamp_us, const char *text);
+static replay_command_t *replay_head(replay_t *replay);
+static void replay_complete(replay_t *replay, int64_t timestamp_us, const char *result, bool is_answered);
+static void replay_expire(replay_t *replay, int64_t timestamp_us);
+static void replay_report(const replay_t *replay, const char *summary, const replay_record_t *records, size_t count);
+static int replay_latency_compare(const void *a, const void *b);
+
+static void usage(const char *program)
+{
+    fprintf(stderr,
+            "usage: %s [options] [CAPTURE]\n"
+            "Replays the last \"nextion_capture_dump\" found in CAPTURE, or stdin, through\n"
+            "the driver frame parser and a model of its command matcher.\n"
+            "  --wait-ms MS   response wait time (default %d)\n"
+            "  --verbose      print every command with its response and latency\n"
+            "  --repeat N     replay N times and print the replay rate\n",
+            program, CONFIG_NEX_UART_RECV_WAIT_TIME_MS);
+}
+
+int main(int argc, char **argv)
+{
+    static const struct option options[] = {
+        {"wait-ms", required_argument, NULL, 'w'},
+        {"verbose", no_argument, NULL, 'v'},
+        {"repeat", required_argument, NULL, 'r'},
+        {"help", no_argument, NULL, 'h'},
+        {NULL, 0, NULL, 0}};
+
+    static replay_t replay = {.wait_us = CONFIG_NEX_UART_RECV_WAIT_TIME_MS * 1000LL};
+    size_t repeat = 0;
+    int option;
+
+    while ((option = getopt_long(argc, argv, "hv", options, NULL)) != -1)
+    {
+        switch (option)
+        {
+        case 'w':
+            replay.wait_us = (int64_t)strtoul(optarg, NULL, 10) * 1000;
+            break;
+        case 'v':
+            replay.is_verbose = true;
+            break;
+        case 'r':
+            repeat = (size_t)strtoul(optarg, NULL, 10);
+            break;
+        default:
+            usage(argv[0]);
+            return option == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    FILE *file = optind < argc ? fopen(argv[optind], "r") : stdin;
+
+    if (file == NULL)
+    {
+        perror(argv[optind]);
+        return EXIT_FAILURE;
+    }
+
+    replay_record_t *records = NULL;
+    size_t count = 0;
+    char summary[64] = "";
+    bool is_loaded = replay_load(file, &records, &count, summary, sizeof(summary));
+
+    if (file != stdin)
+    {
+        fclose(file);
+    }
+
+    if (!is_loaded)
+    {
+        fprintf(stderr, "no capture found; expected a \"nexcap begin\" line\n");
+        return EXIT_FAILURE;
+    }
+
+    replay_run(&replay, records, count);
+    replay_report(&replay, summary, records, count);
+
+    if (repeat > 0)
+    {
+        struct timespec started;
+        struct timespec finished;
+        size_t bytes = replay.bytes_tx + replay.bytes_rx;
+
+        replay.is_verbose = false;
+
+        clock_gettime(CLOCK_MONOTONIC, &started);
+
+        for (size_t i = 0; i < repeat; i++)
+        {
+            replay_run(&replay, records, count);
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &finished);
+
+        double seconds = (double)(finished.tv_sec - started.tv_sec) + (double)(finished.tv_nsec - started.tv_nsec) / 1e9;
+
+        printf("replay rate: %.1f MB/s over %zu runs (%.3f s)\n", (double)bytes * (double)repeat / seconds / 1e6, repeat, seconds);
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        free(records[i].bytes);
+    }
+
+    free(records);
+    free(replay.latencies);
+
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Load the records of the last dump in a file.
+ * @details Anything before the tag on a line, as a console log prefix, is ignored.
+ * @param file File.
+ * @param records Location where the records will be stored.
+ * @param count Location where the record count will be stored.
+ * @param summary Location where the dump counters ("end" line) will be stored.
+ * @param summary_size Summary size.
+ * @return True if a dump was found, otherwise false.
+ */
+static bool replay_load(FILE *file, replay_record_t **records, size_t *count, char *summary, size_t summary_size)
+{
+    char line[REPLAY_MAX_LINE];
+    size_t capacity = 0;
+    bool is_found = false;
+
+    *records = NULL;
+    *count = 0;
+
+    while (fgets(line, sizeof(line), file) != NULL)
+    {
+        char *tag = strstr(line, REPLAY_TAG);
+
+        if (tag == NULL)
+        {
+            continue;
+        }
+
+        char *body = tag + strlen(REPLAY_TAG);
+
+        body[strcspn(body, "\r\n")] = '\0';
+
+        if (strncmp(body, "begin", 5) == 0)
+        {
+            // A later dump replaces the earlier ones.
+            for (size_t i = 0; i < *count; i++)
+            {
+                free((*records)[i].bytes);
+            }
+
+            *count = 0;
+            summary[0] = '\0';
+            is_found = true;
+            continue;
+        }
+
+        if (strncmp(body, "end", 3) == 0)
+        {
+            snprintf(summary, summary_size, "%s", body + 3);
+            continue;
+        }
+
+        char direction[3];
+        long long timestamp;
+        int consumed = 0;
+
+        if (!is_found || sscanf(body, "%lld %2s %n", &timestamp, direction, &consumed) != 2)
+        {
+            continue;
+        }
+
+        const char *hex = body + consumed;
+        size_t length = strlen(hex) / 2;
+
+        if (*count == capacity)
+        {
+            capacity = capacity == 0 ? 256 : capacity * 2;
+            *records = realloc(*records, capacity * sizeof(replay_record_t));
+        }
+
+        replay_record_t *record = &(*records)[(*count)++];
+
+        record->timestamp_us = timestamp;
+        record->is_rx = strcmp(direction, "rx") == 0;
+        record->length = length;
+        record->bytes = malloc(length > 0 ? length : 1);
+
+        for (size_t i = 0; i < length; i++)
+        {
+            unsigned int byte = 0;
+
+            sscanf(hex + i * 2, "%2x", &byte);
+            record->bytes[i] = (uint8_t)byte;
+        }
+    }
+
+    return is_found;
+}
+
+/**
+ * @brief Start over, keeping the settings.
+ * @param replay Replay pointer.
+ */
+static void replay_reset(replay_t *replay)
+{
+    int64_t wait_us = replay->wait_us;
+    bool is_verbose = replay->is_verbose;
+    int64_t *latencies = replay->latencies;
+    size_t latency_capacity = replay->latency_capacity;
+
+    memset(replay, 0, sizeof(replay_t));
+
+    replay->wait_us = wait_us;
+    replay->is_verbose = is_verbose;
+    replay->latencies = latencies;
+    replay->latency_capacity = latency_capacity;
+
+    nextion_frame_parser_reset(&replay->parser);
+}
+
+/**
+ * @brief Replay records in order, as the UART task would see them.
+ * @param replay Replay pointer.
+ * @param records Records.
+ * @param count How many records there are.
+ */
+static void replay_run(replay_t *replay, const replay_record_t *records, size_t count)
+{
+    replay_reset(replay);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        const replay_record_t *record = &records[i];
+
+        replay_expire(replay, record->timestamp_us);
+
+        if (record->is_rx)
+        {
+            replay_rx(replay, record->timestamp_us, record->bytes, record->length);
+        }
+        else
+        {
+            replay_tx(replay, record->timestamp_us, record->bytes, record->length);
+        }
+    }
+
+    replay->unanswered = replay->queue_count;
+}
+
+/**
+ * @brief Split written bytes into commands and "Transparent Data Mode" data.
+ * @param replay Replay pointer.
+ * @param timestamp_us When the bytes were written.
+ * @param bytes Bytes.
+ * @param length How many bytes there are.
+ */
+static void replay_tx(replay_t *replay, int64_t timestamp_us, const uint8_t *bytes, size_t length)
+{
+    replay->bytes_tx += length;
+
+    for (size_t i = 0; i < length; i++)
+    {
+        if (replay->transparent_remaining > 0)
+        {
+            if (--replay->transparent_remaining == 0)
+            {
+                // The end is expected once the last data byte is written.
+                for (size_t q = 0; q < replay->queue_count; q++)
+                {
+                    replay_command_t *command = &replay->queue[(replay->queue_head + q) % REPLAY_QUEUE_SIZE];
+
+                    if (command->expect == REPLAY_EXPECT_FINISHED && !command->is_armed)
+                    {
+                        command->is_armed = true;
+                        command->deadline = timestamp_us + replay->wait_us;
+                    }
+                }
+            }
+
+            continue;
+        }
+
+        if (replay->command_length < sizeof(replay->command) - 1)
+        {
+            replay->command[replay->command_length++] = bytes[i];
+        }
+
+        replay->command_ends = bytes[i] == NEX_DVC_CMD_END_VALUE ? replay->command_ends + 1 : 0;
+
+        if (replay->command_ends == NEX_DVC_CMD_END_LENGTH)
+        {
+            replay_command_written(replay, timestamp_us);
+
+            replay->command_length = 0;
+            replay->command_ends = 0;
+        }
+    }
+}
+
+/**
+ * @brief Register a written command with what it waits for.
+ * @param replay Replay pointer.
+ * @param timestamp_us When it was written.
+ */
+static void replay_command_written(replay_t *replay, int64_t timestamp_us)
+{
+    char text[REPLAY_MAX_COMMAND];
+    size_t length = replay->command_length >= NEX_DVC_CMD_END_LENGTH ? replay->command_length - NEX_DVC_CMD_END_LENGTH : 0;
+    unsigned long first = 0;
+    unsigned long second = 0;
+    unsigned long third = 0;
+
+    for (size_t i = 0; i < length; i++)
+    {
+        uint8_t byte = replay->command[i];
+
+        text[i] = byte >= 0x20 && byte < 0x7F ? (char)byte : '?';
+    }
+
+    text[length] = '\0';
+
+    replay->commands++;
+
+    if (strncmp(text, "baud=", 5) == 0)
+    {
+        // Answered at the new baud rate by the probe that follows.
+        return;
+    }
+
+    if (strncmp(text, "get ", 4) == 0 || strcmp(text, "sendme") == 0)
+    {
+        replay_push(replay, REPLAY_EXPECT_DATA, timestamp_us, text);
+    }
+    else if (sscanf(text, "rept %lu,%lu", &first, &second) == 2)
+    {
+        replay_command_t *command = replay_push(replay, REPLAY_EXPECT_RAW, timestamp_us, text);
+
+        if (command != NULL)
+        {
+            command->raw_length = second;
+        }
+    }
+    else if (sscanf(text, "wept %lu,%lu", &first, &second) == 2 || sscanf(text, "addt %lu,%lu,%lu", &first, &third, &second) == 3)
+    {
+        // The data bytes follow the command; its end is waited for after them.
+        replay_push(replay, REPLAY_EXPECT_ACK, timestamp_us, text);
+        replay_push(replay, REPLAY_EXPECT_FINISHED, timestamp_us, text);
+
+        replay->transparent_remaining = second;
+    }
+    else if (strncmp(text, "add ", 4) == 0)
+    {
+        replay_push(replay, REPLAY_EXPECT_SILENT, timestamp_us, text);
+    }
+    else
+    {
+        replay_push(replay, REPLAY_EXPECT_ACK, timestamp_us, text);
+    }
+}
+
+/**
+ * @brief Add a command to the queue.
+ * @param replay Replay pointer.
+ * @param expect What it waits for.
+ * @param timestamp_us When it was written.
+ * @param text Command, printable.
+ * @return The command, or NULL if the queue is full.
+ */
+static replay_command_t *replay_push(replay_t *replay, replay_expect_t expect, int64_t timestamp_us, const char *text)
+{
+    if (replay->queue_count == REPLAY_QUEUE_SIZE)
+    {
+        replay->overflowed++;
+
+        return NULL;
+    }
+
+    replay_command_t *command = &replay->queue[(replay->queue_head + replay->queue_count) % REPLAY_QUEUE_SIZE];
+
+    memset(command, 0, sizeof(replay_command_t));
+
+    snprintf(command->text, sizeof(command->text), "%s%s", expect == REPLAY_EXPECT_FINISHED ? "(end) " : "", text);
+
+    command->expect = expect;
+    command->written_at = timestamp_us;
+    command->is_armed = expect != REPLAY_EXPECT_FINISHED;
+    command->deadline = timestamp_us + replay->wait_us;
+
+    replay->queue_count++;
+
+    return command;
+}
+
+/**
+ * @brief Get the oldest waiting command.
+ * @param replay Replay pointer.
+ * @return The command, or NULL if none waits.
+ */
+static replay_command_t *replay_head(replay_t *replay)
+{
+    return replay->queue_count > 0 ? &replay->queue[replay->queue_head] : NULL;
+}
+
+/**
+ * @brief Complete the oldest waiting command.
+ * @param replay Replay pointer.
+ * @param timestamp_us When it completed.
+ * @param result What completed it, printable.
+ * @param is_answered If a response arrived; only then its latency is kept.
+ */
+static void replay_complete(replay_t *replay, int64_t timestamp_us, const char *result, bool is_answered)
+{
+    replay_command_t *command = replay_head(replay);
+    int64_t latency = timestamp_us - command->written_at;
+
+    if (replay->is_verbose)
+    {
+        printf("%12lld %+9lld us  %-40s %s\n", (long long)command->written_at, (long long)latency, command->text, result);
+    }
+
+    if (is_answered)
+    {
+        if (replay->latency_count == replay->latency_capacity)
+        {
+            replay->latency_capacity = replay->latency_capacity == 0 ? 256 : replay->latency_capacity * 2;
+            replay->latencies = realloc(replay->latencies, replay->latency_capacity * sizeof(int64_t));
+        }
+
+        replay->latencies[replay->latency_count++] = latency;
+    }
+
+    replay->queue_head = (replay->queue_head + 1) % REPLAY_QUEUE_SIZE;
+    replay->queue_count--;
+
+    // The next command waits from now on, as in the driver.
+    command = replay_head(replay);
+
+    if (command != NULL && command->is_armed && command->deadline < timestamp_us + replay->wait_us)
+    {
+        command->deadline = timestamp_us + replay->wait_us;
+    }
+}
+
+/**
+ * @brief Time out the oldest commands whose deadline passed.
+ * @param replay Replay pointer.
+ * @param timestamp_us Current time.
+ */
+static void replay_expire(replay_t *replay, int64_t timestamp_us)
+{
+    replay_command_t *command;
+
+    while ((command = replay_head(replay)) != NULL && command->is_armed && timestamp_us > command->deadline)
+    {
+        int64_t deadline = command->deadline;
+
+        if (command->expect == REPLAY_EXPECT_SILENT)
+        {
+            replay->silent++;
+            replay_complete(replay, deadline, "ok (silent)", false);
+        }
+        else if (command->expect == REPLAY_EXPECT_RAW && command->raw_received > 0)
+        {
+            replay->data++;
+            replay_complete(replay, deadline, "raw (short)", true);
+        }
+        else
+        {
+            replay->timeouts++;
+            replay_complete(replay, deadline, "TIMEOUT", false);
+        }
+
+        // Bytes of a frame still arriving belonged to the abandoned command.
+        if (nextion_frame_parser_is_busy(&replay->parser))
+        {
+            replay->parser.discarded += replay->parser.length;
+
+            nextion_frame_parser_reset(&replay->parser);
+        }
+    }
+}
+
+/**
+ * @brief Feed read bytes to the parser, or to a command waiting for raw bytes.
+ * @param replay Replay pointer.
+ * @param timestamp_us When the bytes were read.
+ * @param bytes Bytes.
+ * @param length How many bytes there are.
+ */
+static void replay_rx(replay_t *replay, int64_t timestamp_us, const uint8_t *bytes, size_t length)
+{
+    replay->bytes_rx += length;
+
+    for (size_t i = 0; i < length; i++)
+    {
+        replay_command_t *head = replay_head(replay);
+
+        if (head != NULL && head->expect == REPLAY_EXPECT_RAW && !nextion_frame_parser_is_busy(&replay->parser))
+        {
+            if (++head->raw_received >= head->raw_length)
+            {
+                replay->data++;
+                replay_complete(replay, timestamp_us, "raw", true);
+            }
+
+            continue;
+        }
+
+        if (nextion_frame_parser_feed(&replay->parser, bytes[i]))
+        {
+            replay_frame(replay, timestamp_us);
+        }
+    }
+
+    // A response still arriving is not late.
+    replay_command_t *head = replay_head(replay);
+
+    if (head != NULL && head->is_armed && nextion_frame_parser_is_busy(&replay->parser))
+    {
+        head->deadline = timestamp_us + replay->wait_us;
+    }
+}
+
+/**
+ * @brief Handle a parsed frame as the driver does: an event, or the response of the oldest command.
+ * @param replay Replay pointer.
+ * @param timestamp_us When the frame completed.
+ */
+static void replay_frame(replay_t *replay, int64_t timestamp_us)
+{
+    const uint8_t *frame = replay->parser.frame;
+    const size_t length = replay->parser.length;
+    replay_command_t *head = replay_head(replay);
+    char result[32];
+
+    if (NEX_DVC_CODE_IS_EVENT(frame[0], length))
+    {
+        replay->events++;
+
+        if (head != NULL)
+        {
+            replay->events_on_command_path++;
+        }
+
+        if (replay->is_verbose)
+        {
+            printf("%12lld %12s  event 0x%02X (%zu bytes)\n", (long long)timestamp_us, "", frame[0], length);
+        }
+
+        return;
+    }
+
+    if (head == NULL)
+    {
+        if (frame[0] != NEX_DVC_RSP_SENDME_RESULT)
+        {
+            replay->unexpected++;
+
+            if (replay->is_verbose)
+            {
+                printf("%12lld %12s  unexpected 0x%02X (%zu bytes)\n", (long long)timestamp_us, "", frame[0], length);
+            }
+        }
+
+        return;
+    }
+
+    if (head->expect == REPLAY_EXPECT_DATA)
+    {
+        replay->data++;
+
+        snprintf(result, sizeof(result), "data 0x%02X (%zu bytes)", frame[0], length);
+    }
+    else
+    {
+        replay->acks[frame[0]]++;
+
+        snprintf(result, sizeof(result), "ack 0x%02X", frame[0]);
+    }
+
+    replay_complete(replay, timestamp_us, result, true);
+}
+
+/**
+ * @brief Print the results.
+ * @param replay Replay pointer.
+ * @param summary Dump counters, as in its "end" line.
+ * @param records Records.
+ * @param count How many records there are.
+ */
+static void replay_report(const replay_t *replay, const char *summary, const replay_record_t *records, size_t count)
+{
+    unsigned long dumped = 0;
+    unsigned long overwritten = 0;
+    unsigned long skipped = 0;
+    double span = count > 1 ? (double)(records[count - 1].timestamp_us - records[0].timestamp_us) / 1e6 : 0.0;
+    size_t acks = 0;
+
+    sscanf(summary, "%lu %lu %lu", &dumped, &overwritten, &skipped);
+
+    printf("capture: %zu records over %.3f s, %lu overwritten, %lu skipped\n", count, span, overwritten, skipped);
+    printf("tx: %zu commands, %zu bytes\n", replay->commands, replay->bytes_tx);
+    printf("rx: %zu bytes, %zu discarded\n", replay->bytes_rx, replay->parser.discarded);
+
+    printf("acks:");
+
+    for (size_t code = 0; code < REPLAY_CODE_COUNT; code++)
+    {
+        if (replay->acks[code] > 0)
+        {
+            printf(" 0x%02zX=%zu", code, replay->acks[code]);
+            acks += replay->acks[code];
+        }
+    }
+
+    printf("%s\n", acks == 0 ? " none" : "");
+    printf("responses: %zu acks, %zu data, %zu unexpected\n", acks, replay->data, replay->unexpected);
+    printf("timeouts: %zu, silent adds: %zu, unanswered at end: %zu, untracked: %zu\n",
+           replay->timeouts, replay->silent, replay->unanswered, replay->overflowed);
+    printf("events: %zu, %zu while a command waited\n", replay->events, replay->events_on_command_path);
+
+    if (replay->latency_count > 0)
+    {
+        int64_t *sorted = malloc(replay->latency_count * sizeof(int64_t));
+
+        memcpy(sorted, replay->latencies, replay->latency_count * sizeof(int64_t));
+        qsort(sorted, replay->latency_count, sizeof(int64_t), replay_latency_compare);
+
+        printf("latency: p50 %lld us, p99 %lld us, max %lld us\n",
+               (long long)sorted[replay->latency_count / 2],
+               (long long)sorted[replay->latency_count * 99 / 100],
+               (long long)sorted[replay->latency_count - 1]);
+
+        free(sorted);
+    }
+}
+
+static int replay_latency_compare(const void *a, const void *b)
+{
+    int64_t left = *(const int64_t *)a;
+    int64_t right = *(const int64_t *)b;
+
+    return (left > right) - (left < right);
+}
@@ -0,0 +1,38 @@
+#ifndef __NEXTION_HOST_SERIAL_LINE_H__
+#define __NEXTION_HOST_SERIAL_LINE_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief Put a terminal in raw mode: no echo, no line editing and no byte translation.
+     * @param[in] fd Terminal file descriptor.
+     * @return True if success, otherwise false.
+     */
+    bool serial_line_set_raw(int fd);
+
+    /**
+     * @brief Set the baud rate of a terminal; any rate is accepted, not only the standard ones.
+     * @param[in] fd Terminal file descriptor.
+     * @param[in] baud_rate Baud rate.
+     * @return True if success, otherwise false.
+     */
+    bool serial_line_set_baud_rate(int fd, uint32_t baud_rate);
+
+    /**
+     * @brief Get the baud rate of a terminal.
+     * @note On a pseudo-terminal master it is the baud rate set on the slave side.
+     * @param[in] fd Terminal file descriptor.
+     * @return Baud rate, or 0 if it could not be read.
+     */
+    uint32_t serial_line_get_baud_rate(int fd);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
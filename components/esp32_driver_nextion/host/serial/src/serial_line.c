@@ -0,0 +1,58 @@
+// The "termios2" interface is used instead of <termios.h> to carry baud rates
+// like 512000 or 31250, which have no "Bxxx" constant. Both cannot be included
+// in the same file.
+#include <asm/termbits.h>
+#include <asm/ioctls.h>
+#include "serial_line.h"
+
+int ioctl(int fd, unsigned long request, ...);
+
+bool serial_line_set_raw(int fd)
+{
+    struct termios2 options;
+
+    if (ioctl(fd, TCGETS2, &options) != 0)
+    {
+        return false;
+    }
+
+    // Same as "cfmakeraw".
+    options.c_iflag &= ~(IGNBRK | BRKINT | PARMRK | ISTRIP | INLCR | IGNCR | ICRNL | IXON);
+    options.c_oflag &= ~OPOST;
+    options.c_lflag &= ~(ECHO | ECHONL | ICANON | ISIG | IEXTEN);
+    options.c_cflag &= ~(CSIZE | PARENB);
+    options.c_cflag |= CS8 | CREAD | CLOCAL;
+    options.c_cc[VMIN] = 1;
+    options.c_cc[VTIME] = 0;
+
+    return ioctl(fd, TCSETS2, &options) == 0;
+}
+
+bool serial_line_set_baud_rate(int fd, uint32_t baud_rate)
+{
+    struct termios2 options;
+
+    if (ioctl(fd, TCGETS2, &options) != 0)
+    {
+        return false;
+    }
+
+    options.c_cflag &= ~(CBAUD | (CBAUD << IBSHIFT));
+    options.c_cflag |= BOTHER | (BOTHER << IBSHIFT);
+    options.c_ispeed = baud_rate;
+    options.c_ospeed = baud_rate;
+
+    return ioctl(fd, TCSETS2, &options) == 0;
+}
+
+uint32_t serial_line_get_baud_rate(int fd)
+{
+    struct termios2 options;
+
+    if (ioctl(fd, TCGETS2, &options) != 0)
+    {
+        return 0;
+    }
+
+    return options.c_ospeed;
+}
@@ -0,0 +1,52 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "unity.h"
+#include "uart_host.h"
+#include "esp32_driver_nextion/nextion.h"
+#include "nextion_emulator/emulator.h"
+#include "nextion_emulator/pty.h"
+#include "nextion_emulator/test_hmi.h"
+
+/**
+ * @brief Handle shared by the driver tests, as on the target.
+ */
+nextion_t *handle = NULL;
+
+int main(int argc, char **argv)
+{
+    const nextion_emulator_pty_config_t line = NEXTION_EMULATOR_PTY_CONFIG_DEFAULT();
+    nextion_emulator_t *emulator = nextion_emulator_create(nextion_emulator_test_hmi());
+    nextion_emulator_pty_t *pty = emulator == NULL ? NULL : nextion_emulator_pty_start(emulator, &line);
+
+    if (pty == NULL || uart_host_set_device(UART_NUM_1, nextion_emulator_pty_get_path(pty)) != ESP_OK)
+    {
+        fprintf(stderr, "failed starting the emulator\n");
+        return EXIT_FAILURE;
+    }
+
+    handle = nextion_driver_install(UART_NUM_1, 9600, GPIO_NUM_NC, GPIO_NUM_NC);
+
+    if (handle == NULL || nextion_init(handle) != NEX_OK)
+    {
+        fprintf(stderr, "failed initializing the driver\n");
+        return EXIT_FAILURE;
+    }
+
+    int failures = unity_host_run(argc > 1 ? argv[1] : NULL);
+
+    // The last traffic of the run, for "nextion_replay".
+    const char *capture_path = getenv("NEXTION_HOST_CAPTURE");
+    FILE *capture = capture_path == NULL ? NULL : fopen(capture_path, "w");
+
+    if (capture != NULL)
+    {
+        nextion_capture_dump(handle, capture);
+        fclose(capture);
+    }
+
+    nextion_driver_delete(handle);
+    nextion_emulator_pty_stop(pty);
+    nextion_emulator_delete(emulator);
+
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
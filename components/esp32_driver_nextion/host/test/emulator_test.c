@@ -0,0 +1,252 @@
+#include <string.h>
+#include "unity.h"
+#include "esp32_driver_nextion/base/codes.h"
+#include "esp32_driver_nextion/base/constants.h"
+#include "nextion_emulator/emulator.h"
+#include "nextion_emulator/test_hmi.h"
+
+/**
+ * @brief Send a command and collect everything it answers.
+ * @return How many bytes were answered.
+ */
+static size_t emulator_send(nextion_emulator_t *emulator, const char *command, uint8_t *response, size_t capacity)
+{
+    static const uint8_t end[] = {NEX_DVC_CMD_END_SEQUENCE};
+    size_t length = 0;
+    uint32_t baud_rate = 0;
+    uint64_t ready_at = 0;
+
+    nextion_emulator_receive(emulator, (const uint8_t *)command, strlen(command), 0);
+    nextion_emulator_receive(emulator, end, sizeof(end), 0);
+
+    for (size_t count; (count = nextion_emulator_transmit(emulator, UINT64_MAX - 1, response + length, capacity - length, &baud_rate, &ready_at)) > 0;)
+    {
+        length += count;
+    }
+
+    return length;
+}
+
+static nextion_emulator_t *emulator_create(void)
+{
+    nextion_emulator_t *emulator = nextion_emulator_create(nextion_emulator_test_hmi());
+    uint8_t response[16];
+
+    emulator_send(emulator, "bkcmd=3", response, sizeof(response));
+
+    return emulator;
+}
+
+TEST_CASE("Acknowledge by bkcmd level", "[emulator]")
+{
+    nextion_emulator_t *emulator = nextion_emulator_create(nextion_emulator_test_hmi());
+    uint8_t response[16];
+
+    TEST_ASSERT_EQUAL_UINT(0, emulator_send(emulator, "page 0", response, sizeof(response)));
+    TEST_ASSERT_EQUAL_UINT(4, emulator_send(emulator, "page 9", response, sizeof(response)));
+    TEST_ASSERT_EQUAL_UINT8(NEX_DVC_ERR_INVALID_PAGE, response[0]);
+    TEST_ASSERT_EQUAL_UINT(4, emulator_send(emulator, "bkcmd=1", response, sizeof(response)));
+    TEST_ASSERT_EQUAL_UINT8(NEX_DVC_INSTRUCTION_OK, response[0]);
+    TEST_ASSERT_EQUAL_UINT(0, emulator_send(emulator, "page 9", response, sizeof(response)));
+
+    nextion_emulator_delete(emulator);
+}
+
+TEST_CASE("Get number and text", "[emulator]")
+{
+    nextion_emulator_t *emulator = emulator_create();
+    uint8_t response[32];
+    const uint8_t number[] = {NEX_DVC_RSP_GET_NUMBER, 50, 0, 0, 0, NEX_DVC_CMD_END_SEQUENCE};
+    const uint8_t text[] = {NEX_DVC_RSP_GET_STRING, 'a', '"', 'b', NEX_DVC_CMD_END_SEQUENCE};
+
+    TEST_ASSERT_EQUAL_UINT(sizeof(number), emulator_send(emulator, "get n0.val", response, sizeof(response)));
+    TEST_ASSERT_EQUAL_MEMORY(number, response, sizeof(number));
+    TEST_ASSERT_EQUAL_UINT(4, emulator_send(emulator, "t0.txt=\"a\\\"b\"", response, sizeof(response)));
+    TEST_ASSERT_EQUAL_UINT(sizeof(text), emulator_send(emulator, "get t0.txt", response, sizeof(response)));
+    TEST_ASSERT_EQUAL_MEMORY(text, response, sizeof(text));
+    TEST_ASSERT_EQUAL_UINT(4, emulator_send(emulator, "get n99.val", response, sizeof(response)));
+    TEST_ASSERT_EQUAL_UINT8(NEX_DVC_ERR_INVALID_VARIABLE_OR_ATTRIBUTE, response[0]);
+
+    nextion_emulator_delete(emulator);
+}
+
+TEST_CASE("Reject invalid assignments", "[emulator]")
+{
+    nextion_emulator_t *emulator = emulator_create();
+    uint8_t response[16];
+
+    emulator_send(emulator, "n0.val=\"text\"", response, sizeof(response));
+    TEST_ASSERT_EQUAL_UINT8(NEX_DVC_ERR_INVALID_ATTRIBUTE_ASSIGNMENT, response[0]);
+    emulator_send(emulator, "t0.txt=\"\\q\"", response, sizeof(response));
+    TEST_ASSERT_EQUAL_UINT8(NEX_DVC_ERR_INVALID_ESCAPE_CHARACTER, response[0]);
+    emulator_send(emulator, "baud=1234", response, sizeof(response));
+    TEST_ASSERT_EQUAL_UINT8(NEX_DVC_ERR_INVALID_BAUD_RATE, response[0]);
+    emulator_send(emulator, "fill 0,0,10", response, sizeof(response));
+    TEST_ASSERT_EQUAL_UINT8(NEX_DVC_ERR_INVALID_INSTRUCTION_PARAMETERS_COUNT, response[0]);
+    emulator_send(emulator, "nonsense", response, sizeof(response));
+    TEST_ASSERT_EQUAL_UINT8(NEX_DVC_INSTRUCTION_FAIL, response[0]);
+
+    nextion_emulator_delete(emulator);
+}
+
+TEST_CASE("Truncate text to txt_maxl", "[emulator]")
+{
+    nextion_emulator_t *emulator = emulator_create();
+    uint8_t response[16];
+
+    emulator_send(emulator, "b0.txt=\"0123456789abc\"", response, sizeof(response));
+
+    TEST_ASSERT_EQUAL_STRING("0123456789", nextion_emulator_get_text(emulator, "b0"));
+
+    nextion_emulator_delete(emulator);
+}
+
+TEST_CASE("Acknowledge baud change at the previous rate", "[emulator]")
+{
+    nextion_emulator_t *emulator = emulator_create();
+    uint8_t response[16];
+    uint32_t baud_rate = 0;
+    uint64_t ready_at = 0;
+
+    nextion_emulator_receive(emulator, (const uint8_t *)"baud=115200\xFF\xFF\xFF", 14, 0);
+
+    TEST_ASSERT_EQUAL_UINT(4, nextion_emulator_transmit(emulator, 0, response, sizeof(response), &baud_rate, &ready_at));
+    TEST_ASSERT_EQUAL_UINT32(9600, baud_rate);
+    TEST_ASSERT_EQUAL_UINT32(115200, nextion_emulator_get_baud_rate(emulator));
+
+    nextion_emulator_delete(emulator);
+}
+
+TEST_CASE("Reset restores power-on state", "[emulator]")
+{
+    nextion_emulator_t *emulator = emulator_create();
+    uint8_t response[16];
+    const uint8_t started[] = {NEX_DVC_EVT_HARDWARE_START_RESET, 0, 0, NEX_DVC_CMD_END_SEQUENCE, NEX_DVC_EVT_HARDWARE_READY, NEX_DVC_CMD_END_SEQUENCE};
+
+    emulator_send(emulator, "baud=115200", response, sizeof(response));
+    emulator_send(emulator, "dims=30", response, sizeof(response));
+
+    TEST_ASSERT_EQUAL_UINT(sizeof(started), emulator_send(emulator, "rest", response, sizeof(response)));
+    TEST_ASSERT_EQUAL_MEMORY(started, response, sizeof(started));
+    TEST_ASSERT_EQUAL_UINT32(9600, nextion_emulator_get_baud_rate(emulator));
+
+    // Input is ignored while starting.
+    TEST_ASSERT_EQUAL_UINT(0, emulator_send(emulator, "page 9", response, sizeof(response)));
+
+    nextion_emulator_delete(emulator);
+}
+
+TEST_CASE("Add to waveform only answers failures", "[emulator]")
+{
+    nextion_emulator_t *emulator = emulator_create();
+    uint8_t response[16];
+
+    TEST_ASSERT_EQUAL_UINT(0, emulator_send(emulator, "add 7,0,10", response, sizeof(response)));
+    TEST_ASSERT_EQUAL_UINT(4, emulator_send(emulator, "add 7,4,10", response, sizeof(response)));
+    TEST_ASSERT_EQUAL_UINT8(NEX_DVC_ERR_INVALID_WAVEFORM, response[0]);
+    TEST_ASSERT_EQUAL_UINT(1, nextion_emulator_get_sample_count(emulator, 7, 0));
+
+    nextion_emulator_delete(emulator);
+}
+
+TEST_CASE("Write and read EEPROM in transparent data mode", "[emulator]")
+{
+    nextion_emulator_t *emulator = emulator_create();
+    uint8_t response[16];
+    const uint8_t data[] = {1, 0xFF, 0xFF, 0xFF, 5};
+
+    TEST_ASSERT_EQUAL_UINT(4, emulator_send(emulator, "wept 10,5", response, sizeof(response)));
+    TEST_ASSERT_EQUAL_UINT8(NEX_DVC_RSP_TRANSPARENT_DATA_READY, response[0]);
+
+    nextion_emulator_receive(emulator, data, sizeof(data), 0);
+
+    TEST_ASSERT_EQUAL_UINT(5, emulator_send(emulator, "rept 10,5", response, sizeof(response)) - 4);
+    TEST_ASSERT_EQUAL_UINT8(NEX_DVC_RSP_TRANSPARENT_DATA_FINISHED, response[0]);
+    TEST_ASSERT_EQUAL_MEMORY(data, response + 4, sizeof(data));
+
+    nextion_emulator_delete(emulator);
+}
+
+TEST_CASE("Touch sends component event", "[emulator]")
+{
+    nextion_emulator_t *emulator = emulator_create();
+    uint8_t response[16];
+    uint32_t baud_rate = 0;
+    uint64_t ready_at = 0;
+    const uint8_t event[] = {NEX_DVC_EVT_TOUCH_OCCURRED, 0, 4, 1, NEX_DVC_CMD_END_SEQUENCE};
+
+    TEST_ASSERT_TRUE(nextion_emulator_touch_component(emulator, 4, true, 0));
+    TEST_ASSERT_EQUAL_UINT(sizeof(event), nextion_emulator_transmit(emulator, 0, response, sizeof(response), &baud_rate, &ready_at));
+    TEST_ASSERT_EQUAL_MEMORY(event, response, sizeof(event));
+
+    emulator_send(emulator, "tsw b0,0", response, sizeof(response));
+    nextion_emulator_touch_component(emulator, 4, true, 0);
+
+    TEST_ASSERT_EQUAL_UINT(0, nextion_emulator_transmit(emulator, 0, response, sizeof(response), &baud_rate, &ready_at));
+
+    nextion_emulator_delete(emulator);
+}
+
+TEST_CASE("Sleep automatically without touch", "[emulator]")
+{
+    nextion_emulator_t *emulator = emulator_create();
+    uint8_t response[16];
+    uint32_t baud_rate = 0;
+    uint64_t ready_at = 0;
+
+    emulator_send(emulator, "thsp=3", response, sizeof(response));
+    emulator_send(emulator, "thup=1", response, sizeof(response));
+
+    nextion_emulator_update(emulator, 3000000);
+
+    TEST_ASSERT_TRUE(nextion_emulator_is_sleeping(emulator));
+    TEST_ASSERT_EQUAL_UINT(4, nextion_emulator_transmit(emulator, 3000000, response, sizeof(response), &baud_rate, &ready_at));
+    TEST_ASSERT_EQUAL_UINT8(NEX_DVC_EVT_HARDWARE_AUTO_SLEEP, response[0]);
+
+    nextion_emulator_touch(emulator, 1, 1, true, 3100000);
+
+    TEST_ASSERT_FALSE(nextion_emulator_is_sleeping(emulator));
+    TEST_ASSERT_EQUAL_UINT(4, nextion_emulator_transmit(emulator, 3100000, response, sizeof(response), &baud_rate, &ready_at));
+    TEST_ASSERT_EQUAL_UINT8(NEX_DVC_EVT_HARDWARE_AUTO_WAKE, response[0]);
+
+    nextion_emulator_delete(emulator);
+}
+
+TEST_CASE("Responses are ready when the command finishes", "[emulator]")
+{
+    nextion_emulator_config_t config = *nextion_emulator_test_hmi();
+    uint8_t response[16];
+    uint32_t baud_rate = 0;
+    uint64_t ready_at = 0;
+
+    config.command_latency_us = 100;
+    config.pixel_time_ns = 10;
+
+    nextion_emulator_t *emulator = nextion_emulator_create(&config);
+
+    nextion_emulator_receive(emulator, (const uint8_t *)"bkcmd=3\xFF\xFF\xFF", 10, 0);
+    nextion_emulator_transmit(emulator, UINT64_MAX - 1, response, sizeof(response), &baud_rate, &ready_at);
+    nextion_emulator_receive(emulator, (const uint8_t *)"fill 0,0,100,100,0\xFF\xFF\xFF", 21, 1000);
+
+    // 100 us + 10000 pixels x 10 ns.
+    TEST_ASSERT_EQUAL_UINT(0, nextion_emulator_transmit(emulator, 1199, response, sizeof(response), &baud_rate, &ready_at));
+    TEST_ASSERT_EQUAL_UINT(4, nextion_emulator_transmit(emulator, 1200, response, sizeof(response), &baud_rate, &ready_at));
+
+    nextion_emulator_delete(emulator);
+}
+
+TEST_CASE("Acknowledge delay once it is over", "[emulator]")
+{
+    nextion_emulator_t *emulator = emulator_create();
+    uint8_t response[16];
+    uint32_t baud_rate = 0;
+    uint64_t ready_at = 0;
+
+    nextion_emulator_receive(emulator, (const uint8_t *)"delay=5\xFF\xFF\xFF", 10, 1000);
+
+    TEST_ASSERT_EQUAL_UINT(0, nextion_emulator_transmit(emulator, 5999, response, sizeof(response), &baud_rate, &ready_at));
+    TEST_ASSERT_EQUAL_UINT(4, nextion_emulator_transmit(emulator, 6000, response, sizeof(response), &baud_rate, &ready_at));
+    TEST_ASSERT_EQUAL_UINT8(NEX_DVC_INSTRUCTION_OK, response[0]);
+
+    nextion_emulator_delete(emulator);
+}
@@ -0,0 +1,7 @@
+#include <stdlib.h>
+#include "unity.h"
+
+int main(int argc, char **argv)
+{
+    return unity_host_run(argc > 1 ? argv[1] : NULL) == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,77 @@
+#include <stdatomic.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "uart_host.h"
+#include "nextion_emulator/emulator.h"
+#include "nextion_emulator/pty.h"
+#include "nextion_emulator/test_hmi.h"
+#include "esp32_driver_nextion/component.h"
+#include "common_infra_test.h"
+
+// More than the event queue holds, but fewer bytes than the UART buffer.
+#define EVENT_QUEUE_TEST_EVENTS (CONFIG_NEX_EVENT_QUEUE_SIZE + 8)
+#define EVENT_QUEUE_TEST_CALLBACK_MS 20
+#define EVENT_QUEUE_TEST_WAIT_MS (EVENT_QUEUE_TEST_EVENTS * EVENT_QUEUE_TEST_CALLBACK_MS + 2000)
+
+static atomic_int event_queue_test_touches = 0;
+
+static void event_queue_test_on_touch(nextion_on_touch_event_t event)
+{
+    (void)event;
+
+    vTaskDelay(pdMS_TO_TICKS(EVENT_QUEUE_TEST_CALLBACK_MS));
+
+    atomic_fetch_add(&event_queue_test_touches, 1);
+}
+
+TEST_CASE("Events wait for room in a full event queue", "[event]")
+{
+    const nextion_emulator_pty_config_t line = NEXTION_EMULATOR_PTY_CONFIG_DEFAULT();
+    nextion_emulator_t *emulator = nextion_emulator_create(nextion_emulator_test_hmi());
+    nextion_emulator_pty_t *pty = emulator == NULL ? NULL : nextion_emulator_pty_start(emulator, &line);
+
+    CHECK_NOT_NULL(pty);
+    CHECK_TRUE(uart_host_set_device(UART_NUM_0, nextion_emulator_pty_get_path(pty)) == ESP_OK);
+
+    nextion_t *display = nextion_driver_install(UART_NUM_0, 9600, GPIO_NUM_NC, GPIO_NUM_NC);
+
+    CHECK_NOT_NULL(display);
+    CHECK_NEX_OK(nextion_init(display));
+
+    nextion_stats_t before;
+    nextion_stats_t after;
+    int32_t value = 0;
+
+    nextion_event_callback_set_on_touch(display, event_queue_test_on_touch);
+    CHECK_NEX_OK(nextion_stats_get(display, &before));
+
+    // Sent at once; the callbacks take much longer than the line.
+    nextion_emulator_t *locked = nextion_emulator_pty_lock(pty);
+
+    for (int i = 0; i < EVENT_QUEUE_TEST_EVENTS; i++)
+    {
+        CHECK_TRUE(nextion_emulator_touch_component(locked, 4, true, nextion_emulator_pty_clock_us()));
+    }
+
+    nextion_emulator_pty_unlock(pty);
+
+    for (uint32_t waited = 0; atomic_load(&event_queue_test_touches) < EVENT_QUEUE_TEST_EVENTS && waited < EVENT_QUEUE_TEST_WAIT_MS; waited += 10)
+    {
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+
+    LONGS_EQUAL(EVENT_QUEUE_TEST_EVENTS, atomic_load(&event_queue_test_touches));
+
+    CHECK_NEX_OK(nextion_stats_get(display, &after));
+    SIZET_EQUAL(0, after.events_dropped - before.events_dropped);
+
+    // Reading resumed with the queue.
+    CHECK_NEX_OK(nextion_component_get_value(display, "n0", &value));
+
+    nextion_event_callback_set_on_touch(display, NULL);
+
+    CHECK_TRUE(nextion_driver_delete(display));
+
+    nextion_emulator_pty_stop(pty);
+    nextion_emulator_delete(emulator);
+}
@@ -0,0 +1,93 @@
+#include <stdatomic.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "uart_host.h"
+#include "nextion_emulator/emulator.h"
+#include "nextion_emulator/pty.h"
+#include "nextion_emulator/test_hmi.h"
+#include "esp32_driver_nextion/component.h"
+#include "common_infra_test.h"
+
+#define SHARED_TASK_TEST_COMMANDS 10
+#define SHARED_TASK_TEST_WAIT_MS 2000
+
+static _Atomic(nextion_t *) shared_task_test_touched = NULL;
+
+static void shared_task_test_on_touch(nextion_on_touch_event_t event)
+{
+    atomic_store(&shared_task_test_touched, event.handle);
+}
+
+static void shared_task_test_stats_get(nextion_emulator_pty_t *pty, nextion_emulator_stats_t *stats)
+{
+    nextion_emulator_get_stats(nextion_emulator_pty_lock(pty), stats);
+    nextion_emulator_pty_unlock(pty);
+}
+
+TEST_CASE("Two displays share the UART task", "[shared_task]")
+{
+    const nextion_emulator_pty_config_t line = NEXTION_EMULATOR_PTY_CONFIG_DEFAULT();
+    nextion_emulator_t *emulator = nextion_emulator_create(nextion_emulator_test_hmi());
+    nextion_emulator_pty_t *pty = emulator == NULL ? NULL : nextion_emulator_pty_start(emulator, &line);
+
+    CHECK_NOT_NULL(pty);
+    CHECK_TRUE(uart_host_set_device(UART_NUM_0, nextion_emulator_pty_get_path(pty)) == ESP_OK);
+
+    nextion_t *second = nextion_driver_install(UART_NUM_0, 9600, GPIO_NUM_NC, GPIO_NUM_NC);
+
+    CHECK_NOT_NULL(second);
+    CHECK_NEX_OK(nextion_init(second));
+
+    nextion_stats_t before;
+    nextion_stats_t after;
+    nextion_emulator_stats_t display_before;
+    nextion_emulator_stats_t display_after;
+    int32_t initial = 0;
+    int32_t value = 0;
+
+    CHECK_NEX_OK(nextion_component_get_value(handle, "n0", &initial));
+    CHECK_NEX_OK(nextion_stats_get(second, &before));
+    shared_task_test_stats_get(pty, &display_before);
+
+    // Interleaved, each on its own pipeline.
+    for (int32_t i = 1; i <= SHARED_TASK_TEST_COMMANDS; i++)
+    {
+        CHECK_NEX_OK(nextion_component_set_value(second, "n0", i));
+        CHECK_NEX_OK(nextion_component_set_value(handle, "n0", -i));
+    }
+
+    CHECK_NEX_OK(nextion_stats_get(second, &after));
+    shared_task_test_stats_get(pty, &display_after);
+
+    SIZET_EQUAL(SHARED_TASK_TEST_COMMANDS, after.commands_sent - before.commands_sent);
+    SIZET_EQUAL(SHARED_TASK_TEST_COMMANDS, display_after.commands - display_before.commands);
+
+    CHECK_NEX_OK(nextion_component_get_value(second, "n0", &value));
+    LONGS_EQUAL(SHARED_TASK_TEST_COMMANDS, value);
+    CHECK_NEX_OK(nextion_component_get_value(handle, "n0", &value));
+    LONGS_EQUAL(-SHARED_TASK_TEST_COMMANDS, value);
+
+    // Events reach the display they came from.
+    nextion_event_callback_set_on_touch(handle, shared_task_test_on_touch);
+    nextion_event_callback_set_on_touch(second, shared_task_test_on_touch);
+
+    CHECK_TRUE(nextion_emulator_touch_component(nextion_emulator_pty_lock(pty), 4, true, nextion_emulator_pty_clock_us()));
+    nextion_emulator_pty_unlock(pty);
+
+    for (uint32_t waited = 0; atomic_load(&shared_task_test_touched) == NULL && waited < SHARED_TASK_TEST_WAIT_MS; waited += 10)
+    {
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+
+    CHECK_TRUE(atomic_load(&shared_task_test_touched) == second);
+
+    nextion_event_callback_set_on_touch(handle, NULL);
+
+    CHECK_TRUE(nextion_driver_delete(second));
+
+    nextion_emulator_pty_stop(pty);
+    nextion_emulator_delete(emulator);
+
+    // The task still serves the other display.
+    CHECK_NEX_OK(nextion_component_set_value(handle, "n0", initial));
+}
@@ -0,0 +1,90 @@
+#ifndef __NEXTION_HOST_UNITY_H__
+#define __NEXTION_HOST_UNITY_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @typedef unity_host_test_t
+     * @brief A test case body.
+     */
+    typedef void (*unity_host_test_t)(void);
+
+    /**
+     * @brief Register a test case; done by TEST_CASE before main runs.
+     * @param name Test name.
+     * @param tags Test tags, as "[tag1][tag2]".
+     * @param test Test body.
+     * @param file Source file.
+     * @param line Source line.
+     */
+    void unity_host_register(const char *name, const char *tags, unity_host_test_t test, const char *file, int line);
+
+    /**
+     * @brief Run the registered tests, in source order.
+     * @param filter Tag (as "[tag]") or test name to run; NULL runs all.
+     * @return How many tests failed.
+     */
+    int unity_host_run(const char *filter);
+
+    /**
+     * @brief Fail the running test.
+     * @param file Source file.
+     * @param line Source line.
+     * @param message Failure message.
+     */
+    void unity_host_fail(const char *file, int line, const char *message) __attribute__((noreturn));
+
+    void unity_host_assert_equal_int(int64_t expected, int64_t actual, const char *file, int line);
+    void unity_host_assert_equal_uint(uint64_t expected, uint64_t actual, const char *file, int line);
+    void unity_host_assert_equal_string(const char *expected, const char *actual, const char *file, int line);
+    void unity_host_assert_equal_memory(const void *expected, const void *actual, size_t length, const char *file, int line);
+
+#define UNITY_HOST_CONCAT_(a, b) a##b
+#define UNITY_HOST_CONCAT(a, b) UNITY_HOST_CONCAT_(a, b)
+
+#define TEST_CASE_(name, tags, function)                                                                                    \
+    static void function(void);                                                                                             \
+    static void __attribute__((constructor)) UNITY_HOST_CONCAT(function, _register)(void)                                   \
+    {                                                                                                                       \
+        unity_host_register(name, tags, function, __FILE__, __LINE__);                                                      \
+    }                                                                                                                       \
+    static void function(void)
+
+#define TEST_CASE(name, tags) TEST_CASE_(name, tags, UNITY_HOST_CONCAT(unity_host_test_, __LINE__))
+
+#define TEST_FAIL_MESSAGE(message) unity_host_fail(__FILE__, __LINE__, message)
+#define TEST_ASSERT_MESSAGE(condition, message) \
+    do                                          \
+    {                                           \
+        if (!(condition))                       \
+        {                                       \
+            TEST_FAIL_MESSAGE(message);         \
+        }                                       \
+    } while (0)
+#define TEST_ASSERT(condition) TEST_ASSERT_MESSAGE(condition, "Expression evaluated to FALSE: " #condition)
+#define TEST_ASSERT_TRUE(condition) TEST_ASSERT_MESSAGE(condition, "Expected TRUE was FALSE: " #condition)
+#define TEST_ASSERT_FALSE(condition) TEST_ASSERT_MESSAGE(!(condition), "Expected FALSE was TRUE: " #condition)
+#define TEST_ASSERT_NULL(pointer) TEST_ASSERT_MESSAGE((pointer) == NULL, "Expected NULL: " #pointer)
+#define TEST_ASSERT_NOT_NULL(pointer) TEST_ASSERT_MESSAGE((pointer) != NULL, "Expected not NULL: " #pointer)
+
+#define TEST_ASSERT_EQUAL_INT(expected, actual) unity_host_assert_equal_int((int64_t)(expected), (int64_t)(actual), __FILE__, __LINE__)
+#define TEST_ASSERT_EQUAL_INT32(expected, actual) unity_host_assert_equal_int((int32_t)(expected), (int32_t)(actual), __FILE__, __LINE__)
+#define TEST_ASSERT_EQUAL_UINT(expected, actual) unity_host_assert_equal_uint((unsigned int)(expected), (unsigned int)(actual), __FILE__, __LINE__)
+#define TEST_ASSERT_EQUAL_UINT8(expected, actual) unity_host_assert_equal_uint((uint8_t)(expected), (uint8_t)(actual), __FILE__, __LINE__)
+#define TEST_ASSERT_EQUAL_UINT16(expected, actual) unity_host_assert_equal_uint((uint16_t)(expected), (uint16_t)(actual), __FILE__, __LINE__)
+#define TEST_ASSERT_EQUAL_UINT32(expected, actual) unity_host_assert_equal_uint((uint32_t)(expected), (uint32_t)(actual), __FILE__, __LINE__)
+#define TEST_ASSERT_EQUAL_STRING(expected, actual) unity_host_assert_equal_string(expected, actual, __FILE__, __LINE__)
+#define TEST_ASSERT_EQUAL_MEMORY(expected, actual, length) unity_host_assert_equal_memory(expected, actual, length, __FILE__, __LINE__)
+#define TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, actual, count) unity_host_assert_equal_memory(expected, actual, count, __FILE__, __LINE__)
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,157 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <setjmp.h>
+#include "unity.h"
+
+/**
+ * @struct unity_host_case_t
+ * @brief A registered test case.
+ */
+typedef struct
+{
+    const char *name;       /** @brief Test name. */
+    const char *tags;       /** @brief Test tags. */
+    unity_host_test_t test; /** @brief Test body. */
+    const char *file;       /** @brief Source file. */
+    int line;               /** @brief Source line. */
+} unity_host_case_t;
+
+static unity_host_case_t *unity_host_cases = NULL;
+static size_t unity_host_case_count = 0;
+static jmp_buf unity_host_abort;
+
+static int unity_host_compare(const void *a, const void *b);
+static bool unity_host_matches(const unity_host_case_t *test_case, const char *filter);
+
+void unity_host_register(const char *name, const char *tags, unity_host_test_t test, const char *file, int line)
+{
+    unity_host_case_t *cases = (unity_host_case_t *)realloc(unity_host_cases,
+                                                            (unity_host_case_count + 1) * sizeof(unity_host_case_t));
+
+    if (cases == NULL)
+    {
+        abort();
+    }
+
+    unity_host_cases = cases;
+    unity_host_cases[unity_host_case_count++] = (unity_host_case_t){name, tags, test, file, line};
+}
+
+int unity_host_run(const char *filter)
+{
+    size_t run = 0;
+    int failures = 0;
+
+    qsort(unity_host_cases, unity_host_case_count, sizeof(unity_host_case_t), unity_host_compare);
+
+    for (size_t i = 0; i < unity_host_case_count; i++)
+    {
+        const unity_host_case_t *test_case = &unity_host_cases[i];
+
+        if (!unity_host_matches(test_case, filter))
+        {
+            continue;
+        }
+
+        run++;
+
+        printf("Running %s...\n", test_case->name);
+        fflush(stdout);
+
+        if (setjmp(unity_host_abort) == 0)
+        {
+            test_case->test();
+
+            printf("%s:%d:%s:PASS\n", test_case->file, test_case->line, test_case->name);
+        }
+        else
+        {
+            printf("%s:%d:%s:FAIL\n", test_case->file, test_case->line, test_case->name);
+
+            failures++;
+        }
+
+        fflush(stdout);
+    }
+
+    printf("\n-----------------------\n%zu Tests %d Failures 0 Ignored\n%s\n", run, failures, failures == 0 ? "OK" : "FAIL");
+
+    free(unity_host_cases);
+    unity_host_cases = NULL;
+    unity_host_case_count = 0;
+
+    return failures;
+}
+
+void unity_host_fail(const char *file, int line, const char *message)
+{
+    printf("%s:%d: %s\n", file, line, message);
+
+    longjmp(unity_host_abort, 1);
+}
+
+void unity_host_assert_equal_int(int64_t expected, int64_t actual, const char *file, int line)
+{
+    if (expected != actual)
+    {
+        char message[96];
+
+        snprintf(message, sizeof(message), "Expected %" PRId64 " Was %" PRId64, expected, actual);
+
+        unity_host_fail(file, line, message);
+    }
+}
+
+void unity_host_assert_equal_uint(uint64_t expected, uint64_t actual, const char *file, int line)
+{
+    if (expected != actual)
+    {
+        char message[96];
+
+        snprintf(message, sizeof(message), "Expected %" PRIu64 " Was %" PRIu64, expected, actual);
+
+        unity_host_fail(file, line, message);
+    }
+}
+
+void unity_host_assert_equal_string(const char *expected, const char *actual, const char *file, int line)
+{
+    if (expected == NULL || actual == NULL || strcmp(expected, actual) != 0)
+    {
+        char message[256];
+
+        snprintf(message, sizeof(message), "Expected '%s' Was '%s'",
+                 expected == NULL ? "(null)" : expected, actual == NULL ? "(null)" : actual);
+
+        unity_host_fail(file, line, message);
+    }
+}
+
+void unity_host_assert_equal_memory(const void *expected, const void *actual, size_t length, const char *file, int line)
+{
+    if (expected == NULL || actual == NULL || memcmp(expected, actual, length) != 0)
+    {
+        unity_host_fail(file, line, "Memory Mismatch");
+    }
+}
+
+static int unity_host_compare(const void *a, const void *b)
+{
+    const unity_host_case_t *first = (const unity_host_case_t *)a;
+    const unity_host_case_t *second = (const unity_host_case_t *)b;
+    int file = strcmp(first->file, second->file);
+
+    return file != 0 ? file : first->line - second->line;
+}
+
+static bool unity_host_matches(const unity_host_case_t *test_case, const char *filter)
+{
+    if (filter == NULL || filter[0] == '\0')
+    {
+        return true;
+    }
+
+    return strcmp(test_case->name, filter) == 0 || (filter[0] == '[' && strstr(test_case->tags, filter) != NULL);
+}
@@ -0,0 +1,114 @@
+#ifndef __ESP32_DRIVER_NEXTION_ANIMATION_H__
+#define __ESP32_DRIVER_NEXTION_ANIMATION_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "base/codes.h"
+#include "base/types.h"
+#include "drawing.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * An animation plays the frames of a sprite sheet, a picture holding
+     * them in a grid, by cropping each one to the same place with "xpic".
+     *
+     * Frames follow the clock, not the link: a task wakes every frame
+     * period, works out the frame due, and sends it only when the previous
+     * one was acknowledged and the bytes fit the budget of the current baud
+     * rate. Otherwise the frame is dropped; the next one sent is whichever
+     * is due then, so a slow link shows fewer frames instead of a backlog.
+     * Commands are sent without waiting for their response, keeping the
+     * driver free for the tasks that need it on time.
+     */
+
+    /**
+     * @typedef nextion_animation_t
+     * @brief Animation.
+     */
+    typedef struct nextion_animation_t nextion_animation_t;
+
+    /**
+     * @typedef nextion_animation_config_t
+     * @brief Animation configuration.
+     */
+    typedef struct
+    {
+        uint8_t picture_id;       /** @brief Sprite sheet picture id. */
+        point_t origin;           /** @brief Upper left position of the first frame in the sheet. */
+        uint16_t frame_width;     /** @brief Frame width. */
+        uint16_t frame_height;    /** @brief Frame height. */
+        uint16_t columns;         /** @brief Frames in a row of the sheet; they are read row by row. */
+        uint16_t frame_count;     /** @brief How many frames there are. */
+        point_t destination;      /** @brief Upper left position of the frames on the screen. */
+        uint32_t frame_period_ms; /** @brief How long each frame is shown. */
+        bool is_looping;          /** @brief If it starts over after the last frame; otherwise it stops there. */
+    } nextion_animation_config_t;
+
+    /**
+     * @typedef nextion_animation_stats_t
+     * @brief Animation counters.
+     */
+    typedef struct
+    {
+        uint32_t frames_sent;           /** @brief Frames sent. */
+        uint32_t frames_dropped_busy;   /** @brief Frames due while the previous one was not acknowledged. */
+        uint32_t frames_dropped_budget; /** @brief Frames due while the byte budget was spent. */
+        uint32_t frames_failed;         /** @brief Frames not sent or acknowledged with an error. */
+        uint32_t bytes_per_period;      /** @brief Byte budget of a frame period, at the current link rate. */
+    } nextion_animation_stats_t;
+
+    /**
+     * @brief Create a stopped animation and start its task.
+     * @note The driver must outlive the animation.
+     * @param[in] handle Nextion context pointer.
+     * @param[in] config Configuration.
+     * @return Animation pointer, or NULL on failure.
+     */
+    nextion_animation_t *nextion_animation_create(nextion_t *handle, const nextion_animation_config_t *config);
+
+    /**
+     * @brief Stop the animation task, once its last frame is acknowledged, and free the animation.
+     * @param[in] animation Animation pointer.
+     * @return True if success, otherwise false.
+     */
+    bool nextion_animation_delete(nextion_animation_t *animation);
+
+    /**
+     * @brief Play from the first frame. Never blocks.
+     * @param[in] animation Animation pointer.
+     * @return NEX_OK if success, otherwise NEX_FAIL.
+     */
+    nex_err_t nextion_animation_start(nextion_animation_t *animation);
+
+    /**
+     * @brief Stop playing, leaving the last frame sent on the screen. Never blocks.
+     * @note A frame already sent can still be drawn after it returns.
+     * @param[in] animation Animation pointer.
+     * @return NEX_OK if success, otherwise NEX_FAIL.
+     */
+    nex_err_t nextion_animation_stop(nextion_animation_t *animation);
+
+    /**
+     * @brief Check if the animation plays.
+     * @param[in] animation Animation pointer.
+     * @return True if playing, otherwise false; a non-looping animation stops after its last frame.
+     */
+    bool nextion_animation_is_playing(nextion_animation_t *animation);
+
+    /**
+     * @brief Get a copy of the animation counters.
+     * @param[in] animation Animation pointer.
+     * @param[out] stats Location where the counters will be stored.
+     * @return True if success, otherwise false.
+     */
+    bool nextion_animation_stats_get(nextion_animation_t *animation, nextion_animation_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
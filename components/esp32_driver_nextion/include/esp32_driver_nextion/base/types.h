@@ -1,6 +1,8 @@
 #ifndef __ESP32_DRIVER_NEXTION_BASE_TYPES_H__
 #define __ESP32_DRIVER_NEXTION_BASE_TYPES_H__
 
+#include "codes.h"
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -33,6 +35,116 @@ extern "C"
         NEXTION_BAUD_RATE_921600 = 921600U
     } nextion_baud_rate_t;
 
+    /**
+     * @typedef command_callback_on_complete
+     * @brief Callback for when an asynchronous command receives its response.
+     * @note Runs on the UART task, which completes every command: it must return
+     * quickly and cannot send commands; those fail with NEX_FAIL.
+     */
+    typedef void (*command_callback_on_complete)(nextion_t *handle, nex_err_t code, void *context);
+
+    /**
+     * @typedef nextion_component_cache_stats_t
+     * @brief Component property cache counters.
+     */
+    typedef struct
+    {
+        uint32_t hits;          /*!< Writes skipped because the value was already set. */
+        uint32_t misses;        /*!< Writes sent to the device. */
+        uint32_t evictions;     /*!< Entries replaced because the cache was full. */
+        uint32_t invalidations; /*!< Times the whole cache was discarded. */
+    } nextion_component_cache_stats_t;
+
+    /**
+     * @typedef nextion_eeprom_cache_stats_t
+     * @brief EEPROM block cache counters.
+     */
+    typedef struct
+    {
+        uint32_t hits;           /*!< Reads served without asking the device. */
+        uint32_t misses;         /*!< Reads that needed bytes from the device. */
+        uint32_t fetches;        /*!< "rept" commands sent to fill the cache. */
+        uint32_t flushes;        /*!< "wept" streams sent to write dirty bytes back. */
+        uint32_t flush_failures; /*!< Flushes that failed; their bytes stay dirty. */
+        uint32_t evictions;      /*!< Blocks replaced because the cache was full. */
+    } nextion_eeprom_cache_stats_t;
+
+    /**
+     * @typedef nextion_link_info_t
+     * @brief Serial link state.
+     */
+    typedef struct
+    {
+        uint32_t baud_rate;  /*!< Current baud rate. */
+        uint32_t throughput; /*!< Effective throughput last measured, in bytes per second; zero if never measured. */
+    } nextion_link_info_t;
+
+/**
+ * @brief How many buckets a latency histogram has.
+ */
+#define NEXTION_STATS_HISTOGRAM_BUCKET_COUNT 16U
+
+/**
+ * @brief Upper bound of the first bucket of a latency histogram, in microseconds.
+ */
+#define NEXTION_STATS_HISTOGRAM_FIRST_BOUND_US 128U
+
+/**
+ * @brief How many simple response (ACK) codes are counted apart; the last one counts any other code.
+ */
+#define NEXTION_STATS_ACK_CODE_COUNT (NEX_DVC_ERR_REFERENCE_NAME_TOO_LONG + 2U)
+
+    /**
+     * @typedef nextion_stats_event_type_t
+     * @brief Event types, as dispatched to the callbacks.
+     */
+    typedef enum
+    {
+        NEXTION_STATS_EVENT_TOUCH = 0,       /*!< Component touch; 'on touch' callback. */
+        NEXTION_STATS_EVENT_TOUCH_COORD = 1, /*!< Touch with coordinates; 'on touch coord' callback. */
+        NEXTION_STATS_EVENT_DEVICE = 2,      /*!< Anything else; 'on device' callback. */
+        NEXTION_STATS_EVENT_TYPE_COUNT = 3   /*!< How many types there are. */
+    } nextion_stats_event_type_t;
+
+    /**
+     * @typedef nextion_stats_histogram_t
+     * @brief Latency histogram with exponential buckets.
+     * @details Bucket 0 counts values below NEXTION_STATS_HISTOGRAM_FIRST_BOUND_US; each
+     * following bucket doubles the bound of the previous one, and the last counts everything above.
+     */
+    typedef struct
+    {
+        uint32_t buckets[NEXTION_STATS_HISTOGRAM_BUCKET_COUNT]; /*!< Values counted per bucket. */
+        uint32_t count;                                         /*!< Values counted. */
+        uint32_t max_us;                                        /*!< Highest value. */
+        uint64_t total_us;                                      /*!< Sum of the values. */
+    } nextion_stats_histogram_t;
+
+    /**
+     * @typedef nextion_stats_t
+     * @brief Transport counters since the driver was installed or the counters were reset.
+     */
+    typedef struct
+    {
+        uint32_t commands_sent;                                     /*!< Commands written. */
+        uint32_t bytes_sent;                                        /*!< Bytes written, transparent data included. */
+        uint32_t bytes_received;                                    /*!< Bytes read. */
+        uint32_t acks[NEXTION_STATS_ACK_CODE_COUNT];                /*!< Simple responses (ACK) matched to a command, by code. */
+        uint32_t data_responses;                                    /*!< Responses carrying data (texts, numbers, raw bytes) matched to a command. */
+        uint32_t unexpected_responses;                              /*!< Responses received while no command was waiting. */
+        uint32_t timeouts;                                          /*!< Commands completed with NEX_TIMEOUT. */
+        uint32_t events_parsed_on_command_path;                     /*!< Events received while a command was waiting for its response. */
+        uint32_t events_dispatched[NEXTION_STATS_EVENT_TYPE_COUNT]; /*!< Events handed to the callbacks, by type. */
+        uint32_t events_dropped;                                    /*!< Events dropped because the event queue was full; only with CONFIG_NEX_EVENT_DROP_WHEN_FULL. */
+        uint32_t uart_fifo_overflows;                               /*!< UART_FIFO_OVF occurrences. */
+        uint32_t uart_buffer_full;                                  /*!< UART_BUFFER_FULL occurrences. */
+        uint32_t bytes_flushed;                                     /*!< Received bytes discarded by "uart_flush_input". */
+        uint32_t bytes_discarded;                                   /*!< Received bytes discarded as corrupted or incomplete frames. */
+        uint32_t sync_timeouts;                                     /*!< Times the command mutex could not be acquired. */
+        nextion_stats_histogram_t command_latency;                  /*!< Time from queueing a command to its response; timeouts excluded. */
+        nextion_stats_histogram_t sync_wait;                        /*!< Time waited for the command mutex. */
+    } nextion_stats_t;
+
 #ifdef __cplusplus
 }
 #endif
@@ -4,6 +4,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <stddef.h>
+#include "base/constants.h"
 #include "base/codes.h"
 #include "base/types.h"
 
@@ -12,6 +13,22 @@ extern "C"
 {
 #endif
 
+    /**
+     * @typedef nextion_component_t
+     * @brief A component resolved once by "nextion_component_bind".
+     * @details Holds the shortest way to address the component on the wire; the
+     * component property cache is still keyed by its name, so bound and named
+     * calls can be mixed.
+     */
+    typedef struct
+    {
+        char name[NEX_DVC_COMPONENT_MAX_NAME_LENGTH + 1];      /*!< Component name. */
+        char page[NEX_DVC_PAGE_MAX_NAME_LENGTH + 1];           /*!< Page name or id given when bound; empty for the page current then. */
+        char reference[NEX_DVC_REFERENCE_MAX_LENGTH + 1];      /*!< Property prefix: the shortest of the name and "b[id]", or "page.name" when bound to a page. */
+        char object[NEX_DVC_COMPONENT_MAX_NAME_LENGTH + 1];    /*!< Shortest object reference: the name or the id; empty when bound to a page. */
+        uint8_t id;                                            /*!< Component id, resolved from the display. */
+    } nextion_component_t;
+
     /**
      * @brief Refresh a component, bringing it to front.
      * @param[in] handle Nextion context pointer.
@@ -196,6 +213,162 @@ extern "C"
                                                     const char *property_name,
                                                     int32_t number);
 
+    /**
+     * @brief Resolve a component once, so later calls skip name handling.
+     * @details Its id is read from the display with "get <page>.<component>.id".
+     * @note Without a page, the component is addressed on whatever page is current,
+     * like named components: use it only while its page is shown. With a page, its
+     * properties are addressed as "page.name", which the display only allows for
+     * components other than those of the current page when they are global; its
+     * visibility cannot be set, since "vis" only reaches the current page.
+     * @param[in] handle Nextion context pointer.
+     * @param[in] page_name A null-terminated string with the page name or id; NULL for the current page.
+     * @param[in] component_name A null-terminated string with the component name.
+     * @param[out] component Location where the bound component will be stored.
+     * @return NEX_OK or NEX_FAIL | NEX_DVC_ERR_INVALID_VARIABLE_OR_ATTRIBUTE | NEX_DVC_ERR_INVALID_COMPONENT.
+     */
+    nex_err_t nextion_component_bind(nextion_t *handle,
+                                     const char *page_name,
+                                     const char *component_name,
+                                     nextion_component_t *component);
+
+    /**
+     * @brief Set a bound component visibility.
+     * @note Fails for a component bound to a page.
+     * @param[in] handle Nextion context pointer.
+     * @param[in] component Bound component.
+     * @param[in] is_visible True make it visible; false make it invisible.
+     * @return NEX_OK or NEX_FAIL | NEX_DVC_ERR_INVALID_COMPONENT.
+     */
+    nex_err_t nextion_component_bound_set_visibility(nextion_t *handle,
+                                                     const nextion_component_t *component,
+                                                     bool is_visible);
+
+    /**
+     * @brief Get a text from a bound component property.
+     * @param[in] handle Nextion context pointer.
+     * @param[in] component Bound component.
+     * @param[in] property_name A null-terminated string with the property name to retrieve the text from.
+     * @param[out] buffer Location where the retrieved text will be stored. Must take the null-terminator into account.
+     * @param[in] expected_length Expected text length that might be retrieved. Will be update with the retrieved text length.
+     * @return NEX_OK or NEX_FAIL | NEX_DVC_ERR_INVALID_VARIABLE_OR_ATTRIBUTE | NEX_DVC_ERR_INVALID_COMPONENT.
+     */
+    nex_err_t nextion_component_bound_get_property_text(nextion_t *handle,
+                                                        const nextion_component_t *component,
+                                                        const char *property_name,
+                                                        char *buffer,
+                                                        size_t *expected_length);
+
+    /**
+     * @brief Get a number from a bound component property.
+     * @param[in] handle Nextion context pointer.
+     * @param[in] component Bound component.
+     * @param[in] property_name A null-terminated string with the property name to retrieve the number from.
+     * @param[out] number Location where the retrieved number will be stored.
+     * @return NEX_OK or NEX_FAIL | NEX_DVC_ERR_INVALID_VARIABLE_OR_ATTRIBUTE | NEX_DVC_ERR_INVALID_COMPONENT.
+     */
+    nex_err_t nextion_component_bound_get_property_number(nextion_t *handle,
+                                                          const nextion_component_t *component,
+                                                          const char *property_name,
+                                                          int32_t *number);
+
+    /**
+     * @brief Set a bound component property with text.
+     * @param[in] handle Nextion context pointer.
+     * @param[in] component Bound component.
+     * @param[in] property_name A null-terminated string with the property name to set the text.
+     * @param[in] text A null-terminated string with the text.
+     * @return NEX_OK or NEX_FAIL | NEX_DVC_ERR_INVALID_VARIABLE_OR_ATTRIBUTE | NEX_DVC_ERR_INVALID_COMPONENT.
+     */
+    nex_err_t nextion_component_bound_set_property_text(nextion_t *handle,
+                                                        const nextion_component_t *component,
+                                                        const char *property_name,
+                                                        const char *text);
+
+    /**
+     * @brief Set a bound component property with number.
+     * @param[in] handle Nextion context pointer.
+     * @param[in] component Bound component.
+     * @param[in] property_name A null-terminated string with the property name to set the value.
+     * @param[in] number Value to be sent.
+     * @return NEX_OK or NEX_FAIL | NEX_DVC_ERR_INVALID_VARIABLE_OR_ATTRIBUTE | NEX_DVC_ERR_INVALID_COMPONENT.
+     */
+    nex_err_t nextion_component_bound_set_property_number(nextion_t *handle,
+                                                          const nextion_component_t *component,
+                                                          const char *property_name,
+                                                          int32_t number);
+
+    /**
+     * @brief Get a bound component ".txt" value.
+     * @note Shorthand for "nextion_component_bound_get_property_text" using "txt" property.
+     * @param[in] handle Nextion context pointer.
+     * @param[in] component Bound component.
+     * @param[out] buffer Location where the retrieved text will be stored. Must take the null-terminator into account.
+     * @param[in] expected_length Expected text length that might be retrieved. Will be update with the retrieved text length.
+     * @return NEX_OK or NEX_FAIL | NEX_DVC_ERR_INVALID_VARIABLE_OR_ATTRIBUTE | NEX_DVC_ERR_INVALID_COMPONENT.
+     */
+    nex_err_t nextion_component_bound_get_text(nextion_t *handle,
+                                               const nextion_component_t *component,
+                                               char *buffer,
+                                               size_t *expected_length);
+
+    /**
+     * @brief Get a bound component ".val" value.
+     * @note Shorthand for "nextion_component_bound_get_property_number" using "val" property.
+     * @param[in] handle Nextion context pointer.
+     * @param[in] component Bound component.
+     * @param[out] number Location where the retrieved number will be stored.
+     * @return NEX_OK or NEX_FAIL | NEX_DVC_ERR_INVALID_VARIABLE_OR_ATTRIBUTE | NEX_DVC_ERR_INVALID_COMPONENT.
+     */
+    nex_err_t nextion_component_bound_get_value(nextion_t *handle,
+                                                const nextion_component_t *component,
+                                                int32_t *number);
+
+    /**
+     * @brief Set a bound component ".txt" value.
+     * @note Shorthand for "nextion_component_bound_set_property_text" using "txt" property.
+     * @param[in] handle Nextion context pointer.
+     * @param[in] component Bound component.
+     * @param[in] text A null-terminated string with the text.
+     * @return NEX_OK or NEX_FAIL | NEX_DVC_ERR_INVALID_VARIABLE_OR_ATTRIBUTE | NEX_DVC_ERR_INVALID_COMPONENT.
+     */
+    nex_err_t nextion_component_bound_set_text(nextion_t *handle,
+                                               const nextion_component_t *component,
+                                               const char *text);
+
+    /**
+     * @brief Set a bound component ".val" value.
+     * @note Shorthand for "nextion_component_bound_set_property_number" using "val" property.
+     * @param[in] handle Nextion context pointer.
+     * @param[in] component Bound component.
+     * @param[in] number Value to be sent.
+     * @return NEX_OK or NEX_FAIL | NEX_DVC_ERR_INVALID_VARIABLE_OR_ATTRIBUTE | NEX_DVC_ERR_INVALID_COMPONENT.
+     */
+    nex_err_t nextion_component_bound_set_value(nextion_t *handle,
+                                                const nextion_component_t *component,
+                                                int32_t number);
+
+    /**
+     * @brief Discard the component property cache.
+     * @details Writing a visibility, text or number that is already set returns NEX_OK without
+     * sending anything. Values are kept by component name and page, so "name" and "page.name"
+     * share them; writes through an id ("3" or "b[3]") are never skipped and make the property
+     * be sent again for every component. The cache is discarded on page change and device
+     * reset; call this when the display changes a property or the page by itself (e.g. from
+     * its own touch code).
+     * @param[in] handle Nextion context pointer.
+     * @return NEX_OK or NEX_FAIL.
+     */
+    nex_err_t nextion_component_cache_clear(nextion_t *handle);
+
+    /**
+     * @brief Get the component property cache counters.
+     * @param[in] handle Nextion context pointer.
+     * @param[out] stats Location where the counters will be stored.
+     * @return NEX_OK or NEX_FAIL.
+     */
+    nex_err_t nextion_component_cache_get_stats(nextion_t *handle, nextion_component_cache_stats_t *stats);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,165 @@
+#ifndef __ESP32_DRIVER_NEXTION_DISPLAY_LIST_H__
+#define __ESP32_DRIVER_NEXTION_DISPLAY_LIST_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "rgb565/rgb565.h"
+#include "base/codes.h"
+#include "base/types.h"
+#include "drawing.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * A display list records drawing calls as compact bytes, to be replayed
+     * later in a single batch. The bytes do not depend on the driver nor on
+     * where they are stored, so a list recorded once can be kept as a
+     * "const" array in flash and replayed from there:
+     *
+     *   uint8_t buffer[256];
+     *   nextion_display_list_t list;
+     *
+     *   nextion_display_list_init(&list, buffer, sizeof(buffer));
+     *   nextion_display_list_fill_screen(&list, RGB565_COLOR_BLACK);
+     *   nextion_display_list_fill_area(&list, area, RGB565_COLOR_GREEN);
+     *
+     *   nextion_display_list_replay(handle, list.buffer, list.length);
+     *
+     * While recording, calls that add nothing to the picture are merged:
+     * filling the screen drops everything recorded before, a fill abutting
+     * the previous one of the same color extends it, and a primitive
+     * repeating the previous one is dropped.
+     */
+
+    /**
+     * @typedef nextion_display_list_t
+     * @brief Display list being recorded.
+     */
+    typedef struct
+    {
+        uint8_t *buffer; /** @brief Recorded bytes. */
+        size_t capacity; /** @brief How many bytes the buffer holds. */
+        size_t length;   /** @brief How many bytes were recorded. */
+        size_t last;     /** @brief Where the last primitive starts; merges look at it. */
+    } nextion_display_list_t;
+
+    /**
+     * @brief Start an empty list.
+     * @param[out] list List pointer.
+     * @param[in] buffer Buffer the list is recorded into.
+     * @param[in] capacity How many bytes the buffer holds.
+     * @return NEX_OK or NEX_FAIL.
+     */
+    nex_err_t nextion_display_list_init(nextion_display_list_t *list, uint8_t *buffer, size_t capacity);
+
+    /**
+     * @brief Record "nextion_draw_fill_screen".
+     * @param[in] list List pointer.
+     * @param[in] color Color used to fill.
+     * @return NEX_OK, or NEX_FAIL when there is no room left.
+     */
+    nex_err_t nextion_display_list_fill_screen(nextion_display_list_t *list, rgb565_t color);
+
+    /**
+     * @brief Record "nextion_draw_fill_area".
+     * @param[in] list List pointer.
+     * @param[in] area Area.
+     * @param[in] color Color used to fill.
+     * @return NEX_OK, or NEX_FAIL when there is no room left.
+     */
+    nex_err_t nextion_display_list_fill_area(nextion_display_list_t *list, area_t area, rgb565_t color);
+
+    /**
+     * @brief Record "nextion_draw_fill_circle".
+     * @param[in] list List pointer.
+     * @param[in] center Center position.
+     * @param[in] radius Radius, in pixels.
+     * @param[in] color Color used to fill.
+     * @return NEX_OK, or NEX_FAIL when there is no room left.
+     */
+    nex_err_t nextion_display_list_fill_circle(nextion_display_list_t *list, point_t center, uint16_t radius, rgb565_t color);
+
+    /**
+     * @brief Record "nextion_draw_line".
+     * @param[in] list List pointer.
+     * @param[in] area Line ends.
+     * @param[in] color Line color.
+     * @return NEX_OK, or NEX_FAIL when there is no room left.
+     */
+    nex_err_t nextion_display_list_line(nextion_display_list_t *list, area_t area, rgb565_t color);
+
+    /**
+     * @brief Record "nextion_draw_rectangle".
+     * @param[in] list List pointer.
+     * @param[in] area Area.
+     * @param[in] color Line color.
+     * @return NEX_OK, or NEX_FAIL when there is no room left.
+     */
+    nex_err_t nextion_display_list_rectangle(nextion_display_list_t *list, area_t area, rgb565_t color);
+
+    /**
+     * @brief Record "nextion_draw_circle".
+     * @param[in] list List pointer.
+     * @param[in] center Center position.
+     * @param[in] radius Radius, in pixels.
+     * @param[in] color Line color.
+     * @return NEX_OK, or NEX_FAIL when there is no room left.
+     */
+    nex_err_t nextion_display_list_circle(nextion_display_list_t *list, point_t center, uint16_t radius, rgb565_t color);
+
+    /**
+     * @brief Record "nextion_draw_picture".
+     * @param[in] list List pointer.
+     * @param[in] picture_id Picture id.
+     * @param[in] origin Upper left position.
+     * @return NEX_OK, or NEX_FAIL when there is no room left.
+     */
+    nex_err_t nextion_display_list_picture(nextion_display_list_t *list, uint8_t picture_id, point_t origin);
+
+    /**
+     * @brief Record "nextion_draw_crop_picture".
+     * @param[in] list List pointer.
+     * @param[in] picture_id Picture id.
+     * @param[in] crop_area Area of the picture.
+     * @param[in] destination Upper left position on the screen.
+     * @return NEX_OK, or NEX_FAIL when there is no room left.
+     */
+    nex_err_t nextion_display_list_crop_picture(nextion_display_list_t *list, uint8_t picture_id, area_t crop_area, point_t destination);
+
+    /**
+     * @brief Record "nextion_draw_text".
+     * @note Text is never merged: drawn twice without a background, anti-aliased
+     * edges would not look the same.
+     * @param[in] list List pointer.
+     * @param[in] area Area.
+     * @param[in] font Font.
+     * @param[in] background Background.
+     * @param[in] alignment Alignment.
+     * @param[in] text Text; up to 255 characters.
+     * @return NEX_OK, or NEX_FAIL when there is no room left.
+     */
+    nex_err_t nextion_display_list_text(nextion_display_list_t *list,
+                                        area_t area,
+                                        font_t font,
+                                        background_t background,
+                                        text_alignment_t alignment,
+                                        const char *text);
+
+    /**
+     * @brief Draw a recorded list, in a single batch.
+     * @note Cannot be called inside a batch.
+     * @param[in] handle Nextion context pointer.
+     * @param[in] bytes Recorded bytes; can be in flash.
+     * @param[in] length How many bytes there are.
+     * @return NEX_OK if success, otherwise NEX_FAIL or the first NEX_DVC_ERR_* value received.
+     */
+    nex_err_t nextion_display_list_replay(nextion_t *handle, const uint8_t *bytes, size_t length);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
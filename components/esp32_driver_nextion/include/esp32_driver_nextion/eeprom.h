@@ -3,6 +3,7 @@
 
 #include <stdint.h>
 #include <stddef.h>
+#include "base/constants.h"
 #include "base/codes.h"
 #include "base/types.h"
 
@@ -11,13 +12,35 @@ extern "C"
 {
 #endif
 
+/**
+ * @brief Most bytes a single EEPROM stream takes; the "wept" command must fit in the device buffer with them.
+ */
+#define NEX_EEPROM_STREAM_MAX_VALUES (NEX_DVC_TRANSPARENT_DATA_MAX_DATA_SIZE - 21U)
+
+    /**
+     * When CONFIG_NEX_EEPROM_CACHE_BLOCKS is not zero, reads and writes go
+     * through a RAM cache of EEPROM blocks. Reads it holds send nothing; a
+     * miss fetches whole blocks. Writes stay in the cache until flushed,
+     * explicitly or CONFIG_NEX_EEPROM_CACHE_FLUSH_DELAY_MS after the first
+     * one, with nearby written ranges joined in a single "wept" stream.
+     *
+     * Writes are then deferred: NEX_OK from a write means the bytes are in
+     * RAM, not on the device, and they are lost on a reset or power cut
+     * before the flush. Call nextion_eeprom_flush() whenever the data must
+     * be persisted, and check its result. A timed flush that fails keeps
+     * the bytes for the next try; its error is returned by the next write.
+     */
+
     /**
      * @brief Write a text on the device EEPROM.
+     * @note With the EEPROM cache enabled, the text is only kept in RAM until flushed;
+     * see nextion_eeprom_flush().
      * @param[in] handle Nextion context pointer.
      * @param[in] address Starting address to write the text. Range: 0-NEX_DVC_EEPROM_MAX_ADDRESS
      * @param[in] text Text to be written.
      * @param[in] text_length Text length.
-     * @return NEX_OK if success, otherwise NEX_FAIL.
+     * @return NEX_OK if success; otherwise NEX_FAIL, or the error of a timed flush
+     * that failed since the last write, when the text is kept anyway.
      */
     nex_err_t nextion_eeprom_write_text(nextion_t *handle,
                                         uint16_t address,
@@ -26,10 +49,13 @@ extern "C"
 
     /**
      * @brief Write a number on the device EEPROM.
+     * @note With the EEPROM cache enabled, the number is only kept in RAM until flushed;
+     * see nextion_eeprom_flush().
      * @param[in] handle Nextion context pointer.
      * @param[in] address Starting address to write the text. Range: 0-NEX_DVC_EEPROM_MAX_ADDRESS
      * @param[in] value Number to be written.
-     * @return NEX_OK if success, otherwise NEX_FAIL.
+     * @return NEX_OK if success; otherwise NEX_FAIL, or the error of a timed flush
+     * that failed since the last write, when the number is kept anyway.
      */
     nex_err_t nextion_eeprom_write_number(nextion_t *handle,
                                           uint16_t address,
@@ -74,10 +100,36 @@ extern "C"
                                         uint8_t *buffer,
                                         size_t buffer_length);
 
+    /**
+     * @brief Write the bytes kept in the EEPROM cache to the device.
+     * @note Does nothing when the cache is disabled. Otherwise, it is the only
+     * way to know written bytes are persisted; on failure they stay in the cache.
+     * @param[in] handle Nextion context pointer.
+     * @return NEX_OK if success, otherwise NEX_FAIL or any NEX_DVC_ERR_* value.
+     */
+    nex_err_t nextion_eeprom_flush(nextion_t *handle);
+
+    /**
+     * @brief Discard the EEPROM cache, e.g. when the EEPROM was changed by the HMI project.
+     * @note Writes not flushed yet are lost.
+     * @param[in] handle Nextion context pointer.
+     * @return NEX_OK if success, otherwise NEX_FAIL.
+     */
+    nex_err_t nextion_eeprom_cache_clear(nextion_t *handle);
+
+    /**
+     * @brief Get the EEPROM cache counters.
+     * @param[in] handle Nextion context pointer.
+     * @param[out] stats Location where the counters will be stored.
+     * @return NEX_OK if success, otherwise NEX_FAIL.
+     */
+    nex_err_t nextion_eeprom_cache_get_stats(nextion_t *handle, nextion_eeprom_cache_stats_t *stats);
+
     /**
      * @brief Begin the EEPROM data streaming.
      * @note When in this mode, the device will "hang" until all
      * data is sent; no event or other commands will be processed.
+     * The EEPROM cache forgets the range, written bytes included.
      * @param[in] handle Nextion context pointer.
      * @param[in] address Starting address to write the bytes. Range: 0-NEX_DVC_EEPROM_MAX_ADDRESS
      * @param[in] value_count How many values will be written. "value_count < (NEX_DVC_TRANSPARENT_DATA_MAX_DATA_SIZE - 20)"
@@ -93,6 +145,15 @@ extern "C"
      */
     nex_err_t nextion_eeprom_stream_write(nextion_t *handle, uint8_t value);
 
+    /**
+     * @brief Write many values onto the EEPROM stream at once.
+     * @param[in] handle Nextion context pointer.
+     * @param[in] values Values to be written.
+     * @param[in] length How many values will be written.
+     * @return NEX_OK if success, otherwise NEX_FAIL.
+     */
+    nex_err_t nextion_eeprom_stream_write_buffer(nextion_t *handle, const uint8_t *values, size_t length);
+
     /**
      * @brief End the EEPROM streaming.
      * @param[in] handle Nextion context pointer.
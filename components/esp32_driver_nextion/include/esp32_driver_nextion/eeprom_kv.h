@@ -0,0 +1,129 @@
+#ifndef __ESP32_DRIVER_NEXTION_EEPROM_KV_H__
+#define __ESP32_DRIVER_NEXTION_EEPROM_KV_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "base/codes.h"
+#include "base/types.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Longest key, terminator excluded.
+ */
+#define NEX_EEPROM_KV_MAX_KEY_LENGTH 15U
+
+/**
+ * @brief Longest value.
+ */
+#define NEX_EEPROM_KV_MAX_VALUE_LENGTH 64U
+
+/**
+ * @brief Most keys a store holds.
+ */
+#define NEX_EEPROM_KV_MAX_KEYS 32U
+
+/**
+ * @brief Smallest area a store takes.
+ */
+#define NEX_EEPROM_KV_MIN_SIZE 64U
+
+    /**
+     * A key/value store kept on the display EEPROM, so settings travel
+     * with the panel. The area is split in two halves; one holds the log,
+     * where every change is appended as a record checked by a CRC. When the
+     * log is full, the live records are compacted into the other half,
+     * whose header is written last: an interrupted write loses at most the
+     * change being made.
+     *
+     * Mounting reads the whole area once and keeps a copy in RAM; lookups
+     * are served from it and never reach the display. Only changes send
+     * commands, one "wept" stream each, or two when compacting.
+     *
+     *   nextion_eeprom_kv_t *kv = nextion_eeprom_kv_mount(handle, 512, 512);
+     *
+     *   nextion_eeprom_kv_set(kv, "exposure", &exposure, sizeof(exposure));
+     *   nextion_eeprom_kv_get(kv, "exposure", &exposure, sizeof(exposure), NULL);
+     */
+
+    /**
+     * @typedef nextion_eeprom_kv_t
+     * @brief EEPROM key/value store.
+     */
+    typedef struct nextion_eeprom_kv_t nextion_eeprom_kv_t;
+
+    /**
+     * @brief Mount a store, reading its area.
+     * @note An area holding no store mounts empty; nothing is written until the first change.
+     * The driver must outlive the store, and no one else should write the area.
+     * A store is not meant to be used by many tasks at once.
+     * @param[in] handle Nextion context pointer.
+     * @param[in] address Starting address of the area. Range: 0-NEX_DVC_EEPROM_MAX_ADDRESS
+     * @param[in] size Area size; even and at least NEX_EEPROM_KV_MIN_SIZE.
+     * @return Store pointer, or NULL on failure.
+     */
+    nextion_eeprom_kv_t *nextion_eeprom_kv_mount(nextion_t *handle, uint16_t address, size_t size);
+
+    /**
+     * @brief Free a store. What was written stays on the device.
+     * @param[in] kv Store pointer.
+     * @return True if success, otherwise false.
+     */
+    bool nextion_eeprom_kv_unmount(nextion_eeprom_kv_t *kv);
+
+    /**
+     * @brief Get the value of a key. Sends nothing.
+     * @param[in] kv Store pointer.
+     * @param[in] key Key.
+     * @param[out] value Location where the value will be stored.
+     * @param[in] value_capacity How many bytes "value" holds.
+     * @param[out] value_length Location where the value length will be stored; can be NULL.
+     * @return NEX_OK if success, otherwise NEX_FAIL; also when the key is missing or the value does not fit.
+     */
+    nex_err_t nextion_eeprom_kv_get(nextion_eeprom_kv_t *kv,
+                                    const char *key,
+                                    void *value,
+                                    size_t value_capacity,
+                                    size_t *value_length);
+
+    /**
+     * @brief Set the value of a key. Setting the value it already has sends nothing.
+     * @param[in] kv Store pointer.
+     * @param[in] key Key; up to NEX_EEPROM_KV_MAX_KEY_LENGTH characters.
+     * @param[in] value Value.
+     * @param[in] value_length Value length; up to NEX_EEPROM_KV_MAX_VALUE_LENGTH.
+     * @return NEX_OK if success, otherwise NEX_FAIL; also when the store is full.
+     */
+    nex_err_t nextion_eeprom_kv_set(nextion_eeprom_kv_t *kv, const char *key, const void *value, size_t value_length);
+
+    /**
+     * @brief Remove a key. Removing a missing key sends nothing.
+     * @param[in] kv Store pointer.
+     * @param[in] key Key.
+     * @return NEX_OK if success, otherwise NEX_FAIL.
+     */
+    nex_err_t nextion_eeprom_kv_erase(nextion_eeprom_kv_t *kv, const char *key);
+
+    /**
+     * @brief Compact the live records into the other half, giving the log all its room back.
+     * @note Changes compact when needed; this is for doing it at a convenient time.
+     * @param[in] kv Store pointer.
+     * @return NEX_OK if success, otherwise NEX_FAIL.
+     */
+    nex_err_t nextion_eeprom_kv_compact(nextion_eeprom_kv_t *kv);
+
+    /**
+     * @brief Get how many keys the store holds.
+     * @param[in] kv Store pointer.
+     * @return Key count.
+     */
+    size_t nextion_eeprom_kv_count(nextion_eeprom_kv_t *kv);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,144 @@
+#ifndef __ESP32_DRIVER_NEXTION_FONT_METRICS_H__
+#define __ESP32_DRIVER_NEXTION_FONT_METRICS_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "base/codes.h"
+#include "drawing.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Most characters a single-byte font holds.
+ */
+#define NEX_FONT_METRICS_MAX_CHARACTERS 256U
+
+    /**
+     * Metrics let texts be measured locally, with the widths the display
+     * uses to lay out "xstr": the exact area a text covers, where to wrap
+     * it and where to cut it, without oversized boxes nor a round trip.
+     *
+     * Metrics come from the ".zi" font files: the ones shipped with the
+     * project are tables in flash, and other fonts can be parsed from a
+     * ".zi" file embedded in the firmware. Texts are measured byte by byte,
+     * as a single-byte font encodes them (ASCII or ISO-8859-*).
+     */
+
+    /**
+     * @typedef nextion_font_metrics_t
+     * @brief Metrics of a font.
+     */
+    typedef struct
+    {
+        uint8_t height;        /** @brief Line height. */
+        uint8_t first;         /** @brief Code of the first character. */
+        uint16_t count;        /** @brief How many characters follow it. */
+        const uint8_t *widths; /** @brief Width of each character; 0 when the font lacks it. */
+    } nextion_font_metrics_t;
+
+    /**
+     * @brief "Sans Serif 16.zi", ISO-8859-1.
+     */
+    extern const nextion_font_metrics_t NEX_FONT_METRICS_SANS_SERIF_16;
+
+    /**
+     * @brief "Sans Serif 32.zi", ISO-8859-1.
+     */
+    extern const nextion_font_metrics_t NEX_FONT_METRICS_SANS_SERIF_32;
+
+    /**
+     * @brief "arial.zi" of the test HMI, ASCII.
+     */
+    extern const nextion_font_metrics_t NEX_FONT_METRICS_ARIAL_16;
+
+    /**
+     * @brief Read the metrics of a ".zi" font file.
+     * @note Only single-byte encodings are supported.
+     * @param[in] zi File bytes; can be in flash.
+     * @param[in] length How many bytes there are.
+     * @param[out] widths Location where the character widths will be stored; the metrics point to it.
+     * @param[in] capacity How many widths fit; NEX_FONT_METRICS_MAX_CHARACTERS always does.
+     * @param[out] metrics Location where the metrics will be stored.
+     * @return NEX_OK, or NEX_FAIL when the file is not a supported font.
+     */
+    nex_err_t nextion_font_metrics_parse(const uint8_t *zi,
+                                         size_t length,
+                                         uint8_t *widths,
+                                         size_t capacity,
+                                         nextion_font_metrics_t *metrics);
+
+    /**
+     * @brief Get the width of a line of text.
+     * @param[in] metrics Font metrics.
+     * @param[in] text Text.
+     * @return Width, in pixels.
+     */
+    uint16_t nextion_font_metrics_text_width(const nextion_font_metrics_t *metrics, const char *text);
+
+    /**
+     * @brief Get the height of a text wrapped as "nextion_font_metrics_wrap" does.
+     * @param[in] metrics Font metrics.
+     * @param[in] text Text.
+     * @param[in] max_width Line width, in pixels.
+     * @return Height, in pixels.
+     */
+    uint16_t nextion_font_metrics_text_height(const nextion_font_metrics_t *metrics, const char *text, uint16_t max_width);
+
+    /**
+     * @brief Get how many characters of a text fit in a line.
+     * @param[in] metrics Font metrics.
+     * @param[in] text Text.
+     * @param[in] max_width Line width, in pixels.
+     * @return Characters.
+     */
+    size_t nextion_font_metrics_fit(const nextion_font_metrics_t *metrics, const char *text, uint16_t max_width);
+
+    /**
+     * @brief Get the first line of a text wrapped at spaces.
+     * @details Lines break after the last word that fits, at a '\n', or inside
+     * a word longer than a line. Spaces at the break are skipped.
+     * @param[in] metrics Font metrics.
+     * @param[in] text Text.
+     * @param[in] max_width Line width, in pixels.
+     * @param[out] next Location where the index of the next line will be stored; the text length at the end.
+     * @return How many characters the line draws.
+     */
+    size_t nextion_font_metrics_wrap(const nextion_font_metrics_t *metrics, const char *text, uint16_t max_width, size_t *next);
+
+    /**
+     * @brief Copy a line of text, cut with "..." when it does not fit.
+     * @param[in] metrics Font metrics.
+     * @param[in] text Text.
+     * @param[in] max_width Line width, in pixels.
+     * @param[out] buffer Location where the text will be stored, terminated.
+     * @param[in] capacity Buffer length, in bytes.
+     * @return Length of the stored text.
+     */
+    size_t nextion_font_metrics_truncate(const nextion_font_metrics_t *metrics,
+                                         const char *text,
+                                         uint16_t max_width,
+                                         char *buffer,
+                                         size_t capacity);
+
+    /**
+     * @brief Get the pixels "nextion_draw_text" covers for a line of text.
+     * @details Without a background, this is all that changes on the screen.
+     * @param[in] metrics Font metrics.
+     * @param[in] area Area the text is drawn in.
+     * @param[in] alignment Alignment.
+     * @param[in] text Text.
+     * @return Area, inside "area"; empty when the text is.
+     */
+    area_t nextion_font_metrics_text_area(const nextion_font_metrics_t *metrics,
+                                          area_t area,
+                                          text_alignment_t alignment,
+                                          const char *text);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -2,6 +2,7 @@
 #define __ESP32_DRIVER_NEXTION_NEXTION_H__
 
 #include <stdint.h>
+#include <stdio.h>
 #include "driver/gpio.h"
 #include "driver/uart.h"
 #include "base/constants.h"
@@ -19,7 +20,7 @@ extern "C"
      * @note UART ISR handler will be attached to the same CPU core that this function is running on.
      * @note It will call "nextion_create".
      * @param[in] uart_num UART port number; any uart_port_t value.
-     * @param[in] baud_rate UART baud rate, between NEX_UART_BAUD_RATE_MIN and NEX_UART_BAUD_RATE_MAX.
+     * @param[in] baud_rate UART baud rate, between NEX_SERIAL_BAUD_RATE_MIN and NEX_SERIAL_BAUD_RATE_MAX.
      * @param[in] tx_io_num UART TX pin GPIO number.
      * @param[in] rx_io_num UART RX pin GPIO number.
      * @return Pointer to a Nextion context or NULL.
@@ -38,16 +39,92 @@ extern "C"
 
     /**
      * @brief Initialize a Nextion context.
+     * @details If the display does not answer at the installed baud rate, every
+     * supported baud rate is tried. When CONFIG_NEX_UART_BAUD_RATE_NEGOTIATE is set,
+     * the link is then moved to the fastest baud rate it sustains, up to
+     * CONFIG_NEX_UART_BAUD_RATE_TARGET, and its throughput is measured; it is off by default.
      * @note Will turn the display on.
      * @param[in] handle Nextion context pointer.
      * @return NEX_OK if success, otherwise NEX_FAIL.
      */
     nex_err_t nextion_init(nextion_t *handle);
 
+    /**
+     * @brief Change the baud rate of both the display and the UART.
+     * @details The display is asked to change with "baud", which does not persist
+     * across display resets, and must answer a probe at the new baud rate; otherwise
+     * the previous baud rate is restored.
+     * @note Cannot be called inside a batch or while asynchronous commands are pending.
+     * @param[in] handle Nextion context pointer.
+     * @param[in] baud_rate Any nextion_baud_rate_t value.
+     * @return NEX_OK if success, otherwise NEX_FAIL.
+     */
+    nex_err_t nextion_baud_rate_set(nextion_t *handle, uint32_t baud_rate);
+
+    /**
+     * @brief Get the current baud rate and the effective throughput last measured.
+     * @details The throughput is measured with command round trips when the baud rate
+     * changes, and when the driver is initialized if CONFIG_NEX_UART_BAUD_RATE_NEGOTIATE is set.
+     * @param[in] handle Nextion context pointer.
+     * @param[out] info Location where the link information will be stored.
+     * @return NEX_OK if success, otherwise NEX_FAIL.
+     */
+    nex_err_t nextion_link_get_info(nextion_t *handle, nextion_link_info_t *info);
+
+    /**
+     * @brief Get the transport counters: commands, bytes, responses by code, events,
+     * UART overflows and latency histograms.
+     * @details Counters accumulate since the driver was installed or last reset.
+     * @param[in] handle Nextion context pointer.
+     * @param[out] stats Location where the counters will be stored.
+     * @return NEX_OK if success, otherwise NEX_FAIL.
+     */
+    nex_err_t nextion_stats_get(nextion_t *handle, nextion_stats_t *stats);
+
+    /**
+     * @brief Zero the transport counters.
+     * @param[in] handle Nextion context pointer.
+     * @return NEX_OK if success, otherwise NEX_FAIL.
+     */
+    nex_err_t nextion_stats_reset(nextion_t *handle);
+
+    /**
+     * @brief Print the wire capture, from the oldest bytes written or read.
+     * @details Prints a "nexcap begin" line, one "nexcap TIMESTAMP tx|rx HEX" line per
+     * run of up to 32 bytes, then "nexcap end RECORDS OVERWRITTEN SKIPPED". The host tool
+     * "nextion_replay" reads it back, even from a console log. Bytes exchanged while
+     * printing are not captured.
+     * @note Requires CONFIG_NEX_WIRE_CAPTURE_SIZE greater than zero.
+     * @param[in] handle Nextion context pointer.
+     * @param[in] stream Where to print; stdout for the console.
+     * @return NEX_OK if success, otherwise NEX_FAIL.
+     */
+    nex_err_t nextion_capture_dump(nextion_t *handle, FILE *stream);
+
+    /**
+     * @brief Discard the wire capture.
+     * @param[in] handle Nextion context pointer.
+     * @return NEX_OK if success, otherwise NEX_FAIL.
+     */
+    nex_err_t nextion_capture_clear(nextion_t *handle);
+
+    /**
+     * Commands are printf formats. Every conversion but "%n" is taken; those other
+     * than "%s", "%d", "%i", "%u", "%c" and "%%" (with an optional "l") go through
+     * snprintf and must fit in 63 characters, or the command fails.
+     *
+     * A "%s" written between double quotes, as in "t0.txt=\"%s\"", is a string
+     * literal: its double quotes are escaped and its line breaks become "\r".
+     * Backslash sequences in the argument are sent as they are, so text already
+     * escaped by the caller is not escaped twice. Any other "%s" is sent verbatim.
+     */
+
     /**
      * @brief Send a command that waits for a simple response (ACK).
+     * @details A response arriving shortly after the timeout is dropped instead
+     * of being taken for the next command's, as responses do not tell their command.
      * @param[in] handle Nextion context pointer.
-     * @param[in] command Command to be sent (null-terminated).
+     * @param[in] command Command to be sent (null-terminated); a format, quoting "%s" as told above.
      * @param[in] ... Command format arguments.
      * @return NEX_OK if success, NEX_TIMEOUT if timeout or any NEX_DVC_ERR_* value.
      */
@@ -56,7 +133,7 @@ extern "C"
     /**
      * @brief Send a command that waits for a simple response (ACK). Variadic version.
      * @param[in] handle Nextion context pointer.
-     * @param[in] command Command to be sent (null-terminated).
+     * @param[in] command Command to be sent (null-terminated); a format, quoting "%s" as told above.
      * @param[in] args Command format arguments.
      * @return NEX_OK if success, NEX_TIMEOUT if timeout or any NEX_DVC_ERR_* value.
      */
@@ -64,18 +141,89 @@ extern "C"
 
     /**
      * @brief Send a command that returns bytes.
+     * @details The buffer receives the whole response frame, including
+     * its code and termination. Frames longer than the buffer are truncated.
      * @param[in] handle Nextion context pointer.
      * @param[in] buffer Location where the bytes will be stored.
      * @param[in] legth Buffer length. Will be updated with the retrieved bytes count.
-     * @param[in] command Command to be sent (null-terminated).
+     * @param[in] command Command to be sent (null-terminated); a format, quoting "%s" as told above.
      * @param[in] ... Command format arguments.
      * @return NEX_OK if success, otherwise any NEX_DVC_ERR_* value.
      */
     nex_err_t nextion_command_send_get_bytes(nextion_t *handle, uint8_t *buffer, size_t *length, const char *command, ...);
 
+    /**
+     * @brief Send a command that returns raw bytes, without code or termination (e.g. "rept").
+     * @details Exactly "length" bytes are expected; if fewer arrive before the
+     * response wait time expires, the ones received are returned.
+     * @param[in] handle Nextion context pointer.
+     * @param[in] buffer Location where the bytes will be stored.
+     * @param[in] legth Buffer length. Will be updated with the retrieved bytes count.
+     * @param[in] command Command to be sent (null-terminated); a format, quoting "%s" as told above.
+     * @param[in] ... Command format arguments.
+     * @return NEX_OK if success, NEX_TIMEOUT if nothing was received, otherwise NEX_FAIL.
+     */
+    nex_err_t nextion_command_send_get_raw_bytes(nextion_t *handle, uint8_t *buffer, size_t *length, const char *command, ...);
+
+    /**
+     * @brief Send a command without waiting for its simple response (ACK).
+     * @details Responses are matched to commands, in the order they were sent,
+     * by the UART task. Up to CONFIG_NEX_UART_COMMAND_QUEUE_SIZE commands can be
+     * in flight; when the queue is full it blocks until a response arrives.
+     * @note Commands that only respond on failure (e.g. "add") hold the queue
+     * until the response wait time expires and are completed with NEX_TIMEOUT.
+     * @note The callback runs on the UART task, so no command can be sent from it:
+     * waiting for a response there would never end, and such calls fail with NEX_FAIL.
+     * Hand the work to another task instead.
+     * @param[in] handle Nextion context pointer.
+     * @param[in] callback Called from the UART task when the response arrives. Can be NULL.
+     * @param[in] context Pointer passed to the callback.
+     * @param[in] command Command to be sent (null-terminated); a format, quoting "%s" as told above.
+     * @param[in] ... Command format arguments.
+     * @return NEX_OK if the command was sent, otherwise NEX_FAIL.
+     */
+    nex_err_t nextion_command_send_async(nextion_t *handle,
+                                         command_callback_on_complete callback,
+                                         void *context,
+                                         const char *command,
+                                         ...);
+
+    /**
+     * @brief Wait until all commands sent with "nextion_command_send_async" receive their response.
+     * @param[in] handle Nextion context pointer.
+     * @return NEX_OK if all of them succeeded, otherwise the first failure code
+     * (NEX_FAIL, NEX_TIMEOUT or any NEX_DVC_ERR_* value) received since the last call.
+     */
+    nex_err_t nextion_command_wait_all(nextion_t *handle);
+
+    /**
+     * @brief Begin a batch of commands.
+     * @details Until "nextion_batch_end" is called, commands sent from the calling
+     * task are formatted back-to-back into one buffer instead of being written one
+     * by one, and return NEX_OK without waiting for their response. Other tasks
+     * sending commands block until the batch ends.
+     * @note Commands that return data (e.g. "get") write the batch so far and
+     * wait for their own response as usual.
+     * @note The batch is written early when its buffer or the command queue is full.
+     * @param[in] handle Nextion context pointer.
+     * @return NEX_OK if success, otherwise NEX_FAIL.
+     */
+    nex_err_t nextion_batch_begin(nextion_t *handle);
+
+    /**
+     * @brief End a batch of commands, writing them at once and waiting for all responses.
+     * @param[in] handle Nextion context pointer.
+     * @return NEX_OK if all commands succeeded, otherwise the first failure code
+     * (NEX_FAIL, NEX_TIMEOUT or any NEX_DVC_ERR_* value).
+     */
+    nex_err_t nextion_batch_end(nextion_t *handle);
+
     /**
      * @brief Set a callback for when a component is touched; 'on touch' events.
      * @note Only the last registration will be called; you cannot register more then one callback.
+     * @note Callbacks run on the event task, in the order events were received; they can send commands.
+     * @note While the event queue is full, the UART is not read and responses wait behind the events;
+     * events are lost only with CONFIG_NEX_EVENT_DROP_WHEN_FULL.
      * @param[in] handle Nextion context pointer.
      * @param[in] callback Callback function.
      * @return True if success, otherwise false.
@@ -85,6 +233,9 @@ extern "C"
     /**
      * @brief Set a callback for when something is touched and "sendxy=1"; 'on touch with coordinates' events.
      * @note Only the last registration will be called; you cannot register more then one callback.
+     * @note Callbacks run on the event task, in the order events were received; they can send commands.
+     * @note While the event queue is full, the UART is not read and responses wait behind the events;
+     * events are lost only with CONFIG_NEX_EVENT_DROP_WHEN_FULL.
      * @param[in] handle Nextion context pointer.
      * @param[in] callback Callback function.
      * @return True if success, otherwise false.
@@ -94,6 +245,9 @@ extern "C"
     /**
      * @brief Set a callback for when a device event happens; 'on device' events.
      * @note Only the last registration will be called; you cannot register more then one callback.
+     * @note Callbacks run on the event task, in the order events were received; they can send commands.
+     * @note While the event queue is full, the UART is not read and responses wait behind the events;
+     * events are lost only with CONFIG_NEX_EVENT_DROP_WHEN_FULL.
      * @param[in] handle Nextion context pointer.
      * @param[in] callback Callback function.
      * @return True if success, otherwise false.
@@ -106,7 +260,7 @@ extern "C"
      * data is sent; no event or other commands will be processed.
      * @param[in] handle Nextion context pointer.
      * @param[in] data_size How many bytes will be written. "(command_length + NEX_DVC_CMD_END_LENGTH + data_size) < NEX_DVC_TRANSPARENT_DATA_MAX_DATA_SIZE"
-     * @param[in] command Command that will start it.
+     * @param[in] command Command that will start it; a format, quoting "%s" as told above.
      * @param[in] ... Command format arguments.
      * @return NEX_OK if success, otherwise any NEX_DVC_ERR_* value.
      */
@@ -120,10 +274,24 @@ extern "C"
      * @note Use only when in "Transparent Data Mode".
      * @param[in] handle Nextion context pointer.
      * @param[in] byte Value to be written.
-     * @return NEX_OK if success, otherwise NEX_FAIL.
+     * @return NEX_OK if success, otherwise as "nextion_transparent_data_mode_write_buffer".
      */
     nex_err_t nextion_transparent_data_mode_write(nextion_t *handle, uint8_t value);
 
+    /**
+     * @brief Write many values onto the device serial buffer at once.
+     * @details All values are pushed to the UART before waiting for the transmission to end.
+     * @note Use only when in "Transparent Data Mode".
+     * @param[in] handle Nextion context pointer.
+     * @param[in] buffer Values to be written.
+     * @param[in] length How many values will be written; no more than what is left to be written.
+     * @return NEX_OK if success, otherwise NEX_FAIL or NEX_TIMEOUT. When the values could not be written,
+     * the mode is left: the transaction is filled up with zeros, so the display takes the next command
+     * as such, and NEX_FAIL is returned. NEX_TIMEOUT means the display did not confirm it left the
+     * mode and might still take the next command as data.
+     */
+    nex_err_t nextion_transparent_data_mode_write_buffer(nextion_t *handle, const uint8_t *buffer, size_t length);
+
     /**
      * @brief End the "Transparent Data Mode".
      * @param[in] handle Nextion context pointer.
@@ -131,6 +299,28 @@ extern "C"
      */
     nex_err_t nextion_transparent_data_mode_end(nextion_t *handle);
 
+    /**
+     * @brief End the "Transparent Data Mode" and begin it again with another command,
+     * without a round trip in between.
+     * @details The command is written right after the last data, while the display still
+     * processes it; then the end of the previous transaction and the ready response of the
+     * new one are waited for. If the display accepts the new command, the previous transaction
+     * is taken as ended even if its end response was lost.
+     * @param[in] handle Nextion context pointer.
+     * @param[out] end_code Location where the end of the previous transaction is stored;
+     * NEX_OK if it ended, otherwise NEX_FAIL and its data might not have been applied.
+     * @param[in] data_size How many bytes will be written in the new transaction; as in "nextion_transparent_data_mode_begin".
+     * @param[in] command Command that will start it; a format, quoting "%s" as told above.
+     * @param[in] ... Command format arguments.
+     * @return NEX_OK if the new transaction began, otherwise NEX_FAIL or any NEX_DVC_ERR_* value;
+     * in that case the mode is left.
+     */
+    nex_err_t nextion_transparent_data_mode_restart(nextion_t *handle,
+                                                    nex_err_t *end_code,
+                                                    size_t data_size,
+                                                    const char *command,
+                                                    ...);
+
 #ifdef __cplusplus
 }
 #endif
@@ -20,6 +20,8 @@ extern "C"
 
     /**
      * @brief Change to another page.
+     * @note A page given by name is followed by "sendme", so the component
+     * cache knows its id.
      * @param[in] handle Nextion context pointer.
      * @param[in] page_name_or_id Page's name or id.
      * @return NEX_OK or NEX_DVC_ERR_INVALID_PAGE.
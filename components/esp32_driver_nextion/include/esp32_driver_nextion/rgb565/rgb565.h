@@ -2,6 +2,7 @@
 #define __ESP32_DRIVER_NEXTION_RGB565_H__
 
 #include <stdint.h>
+#include <stddef.h>
 
 #ifdef __cplusplus
 extern "C"
@@ -34,6 +35,65 @@ extern "C"
 #define RGB565_COLOR_YELLOW ((rgb565_t)0b1111111111100000)
 #define RGB565_COLOR_WHITE ((rgb565_t)0b1111111111111111)
 
+/**
+ * @brief Convert a 24 bits RGB color into RGB565, as a constant expression.
+ */
+#define RGB565_FROM_888(red, green, blue) \
+    ((rgb565_t)((((red) & 0b11111000) << 8) | (((green) & 0b11111100) << 3) | (((blue) & 0xFF) >> 3)))
+
+/**
+ * @brief Color at a step of a linear ramp between two 24 bits RGB colors, as a constant expression.
+ */
+#define RGB565_RAMP_STEP(from_red, from_green, from_blue, to_red, to_green, to_blue, step, steps) \
+    RGB565_FROM_888((from_red) + ((to_red) - (from_red)) * (step) / ((steps) - 1),                \
+                    (from_green) + ((to_green) - (from_green)) * (step) / ((steps) - 1),          \
+                    (from_blue) + ((to_blue) - (from_blue)) * (step) / ((steps) - 1))
+
+/**
+ * @brief Initializer of a 16 colors ramp, from and to the given 24 bits RGB colors.
+ *
+ * The table is computed by the compiler, so a const one stays in flash:
+ * static const rgb565_t PROGRESS[] = RGB565_RAMP_16(0, 255, 0, 255, 0, 0);
+ */
+#define RGB565_RAMP_16(fr, fg, fb, tr, tg, tb)                                                              \
+    {                                                                                                       \
+        RGB565_RAMP_STEP(fr, fg, fb, tr, tg, tb, 0, 16), RGB565_RAMP_STEP(fr, fg, fb, tr, tg, tb, 1, 16),   \
+        RGB565_RAMP_STEP(fr, fg, fb, tr, tg, tb, 2, 16), RGB565_RAMP_STEP(fr, fg, fb, tr, tg, tb, 3, 16),   \
+        RGB565_RAMP_STEP(fr, fg, fb, tr, tg, tb, 4, 16), RGB565_RAMP_STEP(fr, fg, fb, tr, tg, tb, 5, 16),   \
+        RGB565_RAMP_STEP(fr, fg, fb, tr, tg, tb, 6, 16), RGB565_RAMP_STEP(fr, fg, fb, tr, tg, tb, 7, 16),   \
+        RGB565_RAMP_STEP(fr, fg, fb, tr, tg, tb, 8, 16), RGB565_RAMP_STEP(fr, fg, fb, tr, tg, tb, 9, 16),   \
+        RGB565_RAMP_STEP(fr, fg, fb, tr, tg, tb, 10, 16), RGB565_RAMP_STEP(fr, fg, fb, tr, tg, tb, 11, 16), \
+        RGB565_RAMP_STEP(fr, fg, fb, tr, tg, tb, 12, 16), RGB565_RAMP_STEP(fr, fg, fb, tr, tg, tb, 13, 16), \
+        RGB565_RAMP_STEP(fr, fg, fb, tr, tg, tb, 14, 16), RGB565_RAMP_STEP(fr, fg, fb, tr, tg, tb, 15, 16)  \
+    }
+
+    /**
+     * @typedef rgb565_dither_t
+     * @brief How the bits lost converting to RGB565 are spread.
+     */
+    typedef enum
+    {
+        RGB565_DITHER_NONE = 0,      /** @brief Truncated; smooth gradients show bands. */
+        RGB565_DITHER_ORDERED = 1,   /** @brief 4x4 Bayer matrix, by position; stable across frames. */
+        RGB565_DITHER_DIFFUSION = 2, /** @brief Error carried to the next pixel of the row. */
+    } rgb565_dither_t;
+
+    /**
+     * @typedef rgb565_convert_config_t
+     * @brief Buffer conversion options.
+     */
+    typedef struct
+    {
+        rgb565_dither_t dither; /** @brief Dithering. */
+        uint16_t width;         /** @brief Pixels in a row of the buffer, for dithering; 0 when it is a single row. */
+        const uint8_t *gamma;   /** @brief Applied to each channel before converting, 256 entries; NULL for none. */
+    } rgb565_convert_config_t;
+
+    /**
+     * @brief Gamma 2.2 table, for rgb565_convert_config_t.
+     */
+    extern const uint8_t RGB565_GAMMA_22[256];
+
     /**
      * @brief Convert a 24 bits RGB color into RGB565.
      * @param[in] red Red value, from 0 to 255.
@@ -43,6 +103,34 @@ extern "C"
      */
     rgb565_t rgb565_convert_from_888(uint8_t red, uint8_t green, uint8_t blue);
 
+    /**
+     * @brief Convert packed 24 bits RGB pixels into RGB565.
+     * @param[in] rgb Pixels, 3 bytes each: red, green and blue.
+     * @param[out] colors Location where the colors will be stored.
+     * @param[in] count How many pixels there are.
+     * @param[in] config Options; NULL to only truncate.
+     */
+    void rgb565_convert_buffer_from_888(const uint8_t *rgb, rgb565_t *colors, size_t count, const rgb565_convert_config_t *config);
+
+    /**
+     * @brief Convert packed HSV pixels into RGB565.
+     * @param[in] hsv Pixels, 3 bytes each: hue (a full turn is 256), saturation and value.
+     * @param[out] colors Location where the colors will be stored.
+     * @param[in] count How many pixels there are.
+     * @param[in] config Options; NULL to only truncate.
+     */
+    void rgb565_convert_buffer_from_hsv(const uint8_t *hsv, rgb565_t *colors, size_t count, const rgb565_convert_config_t *config);
+
+    /**
+     * @brief Fill a buffer with a linear ramp between two 24 bits RGB colors.
+     * @param[in] from First color, as 0xRRGGBB.
+     * @param[in] to Last color, as 0xRRGGBB.
+     * @param[out] colors Location where the colors will be stored.
+     * @param[in] count How many colors there are.
+     * @param[in] config Options; NULL to only truncate.
+     */
+    void rgb565_ramp(uint32_t from, uint32_t to, rgb565_t *colors, size_t count, const rgb565_convert_config_t *config);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,162 @@
+#ifndef __ESP32_DRIVER_NEXTION_SCENE_H__
+#define __ESP32_DRIVER_NEXTION_SCENE_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "rgb565/rgb565.h"
+#include "base/codes.h"
+#include "base/types.h"
+#include "drawing.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Longest text an object keeps, terminator excluded.
+ */
+#define NEX_SCENE_MAX_TEXT_LENGTH 47U
+
+/**
+ * @brief Most separate areas redrawn in a frame; more are merged.
+ */
+#define NEX_SCENE_MAX_DIRTY_AREAS 8U
+
+    /**
+     * A scene keeps the shapes, texts and pictures of a custom-drawn page,
+     * so a frame only redraws what changed instead of clearing the screen.
+     * Changing an object marks its old and new bounds; rendering restores
+     * the background there, with "fill" or "xpic", and redraws the objects
+     * overlapping it, in id order, all in a single batch.
+     *
+     * The display does not clip, so an object is always drawn whole; the
+     * redrawn areas grow to hold every object they touch, keeping the
+     * objects above them intact.
+     */
+
+    /**
+     * @typedef nextion_scene_t
+     * @brief Scene.
+     */
+    typedef struct nextion_scene_t nextion_scene_t;
+
+    /**
+     * @typedef nextion_scene_object_kind_t
+     * @brief What an object draws; the matching "nextion_draw_*" function.
+     */
+    typedef enum
+    {
+        NEX_SCENE_OBJECT_FILL_AREA = 0,    /** @brief Filled rectangle over "area". */
+        NEX_SCENE_OBJECT_FILL_CIRCLE = 1,  /** @brief Filled circle at "position", with "radius". */
+        NEX_SCENE_OBJECT_LINE = 2,         /** @brief Line between the corners of "area". */
+        NEX_SCENE_OBJECT_RECTANGLE = 3,    /** @brief Rectangle outline over "area". */
+        NEX_SCENE_OBJECT_CIRCLE = 4,       /** @brief Circle outline at "position", with "radius". */
+        NEX_SCENE_OBJECT_PICTURE = 5,      /** @brief Picture "picture_id" over "area"; it must be the picture size. */
+        NEX_SCENE_OBJECT_CROP_PICTURE = 6, /** @brief Part "area" of picture "picture_id", drawn at "position". */
+        NEX_SCENE_OBJECT_TEXT = 7          /** @brief Text over "area". */
+    } nextion_scene_object_kind_t;
+
+    /**
+     * @typedef nextion_scene_object_t
+     * @brief Object of a scene; only the fields its kind uses are read.
+     */
+    typedef struct
+    {
+        nextion_scene_object_kind_t kind; /** @brief What it draws. */
+        area_t area;                      /** @brief Area; see the kinds. */
+        point_t position;                 /** @brief Position; see the kinds. */
+        uint16_t radius;                  /** @brief Circle radius. */
+        rgb565_t color;                   /** @brief Shape color. */
+        uint8_t picture_id;               /** @brief Picture id. */
+        font_t font;                      /** @brief Text font. */
+        background_t background;          /** @brief Text background. */
+        text_alignment_t alignment;       /** @brief Text alignment. */
+        const char *text;                 /** @brief Text; copied, up to NEX_SCENE_MAX_TEXT_LENGTH characters. */
+    } nextion_scene_object_t;
+
+    /**
+     * @typedef nextion_scene_config_t
+     * @brief Scene configuration.
+     */
+    typedef struct
+    {
+        uint16_t width;                   /** @brief Screen width. */
+        uint16_t height;                  /** @brief Screen height. */
+        size_t max_objects;               /** @brief How many objects it holds. */
+        background_fill_mode_t fill_mode; /** @brief BACKG_FILL_COLOR or BACKG_FILL_IMAGE. */
+        rgb565_t color;                   /** @brief Background color, when filled with a color. */
+        uint8_t picture_id;               /** @brief Full screen background picture, when filled with an image. */
+    } nextion_scene_config_t;
+
+    /**
+     * @brief Create an empty scene.
+     * @note The first render draws the whole screen.
+     * @param[in] handle Nextion context pointer.
+     * @param[in] config Configuration.
+     * @return Scene pointer, or NULL on failure.
+     */
+    nextion_scene_t *nextion_scene_create(nextion_t *handle, const nextion_scene_config_t *config);
+
+    /**
+     * @brief Free a scene. The screen is left as it is.
+     * @param[in] scene Scene pointer.
+     * @return True if success, otherwise false.
+     */
+    bool nextion_scene_delete(nextion_scene_t *scene);
+
+    /**
+     * @brief Add a visible object, drawn above the objects with a lower id.
+     * @param[in] scene Scene pointer.
+     * @param[in] object Object.
+     * @param[out] id Location where the object id will be stored; ids of removed objects are reused.
+     * @return NEX_OK if success, otherwise NEX_FAIL.
+     */
+    nex_err_t nextion_scene_add(nextion_scene_t *scene, const nextion_scene_object_t *object, size_t *id);
+
+    /**
+     * @brief Replace an object. Nothing is redrawn when it is the same.
+     * @param[in] scene Scene pointer.
+     * @param[in] id Object id.
+     * @param[in] object Object.
+     * @return NEX_OK if success, otherwise NEX_FAIL.
+     */
+    nex_err_t nextion_scene_update(nextion_scene_t *scene, size_t id, const nextion_scene_object_t *object);
+
+    /**
+     * @brief Show or hide an object.
+     * @param[in] scene Scene pointer.
+     * @param[in] id Object id.
+     * @param[in] is_visible If it is drawn.
+     * @return NEX_OK if success, otherwise NEX_FAIL.
+     */
+    nex_err_t nextion_scene_set_visibility(nextion_scene_t *scene, size_t id, bool is_visible);
+
+    /**
+     * @brief Remove an object.
+     * @param[in] scene Scene pointer.
+     * @param[in] id Object id.
+     * @return NEX_OK if success, otherwise NEX_FAIL.
+     */
+    nex_err_t nextion_scene_remove(nextion_scene_t *scene, size_t id);
+
+    /**
+     * @brief Redraw the whole screen on the next render, e.g. after the page changed.
+     * @param[in] scene Scene pointer.
+     * @return NEX_OK if success, otherwise NEX_FAIL.
+     */
+    nex_err_t nextion_scene_invalidate(nextion_scene_t *scene);
+
+    /**
+     * @brief Redraw what changed since the last render, in a single batch.
+     * @note Cannot be called inside a batch. On failure, the changes are redrawn by the next render.
+     * @param[in] scene Scene pointer.
+     * @return NEX_OK if success, otherwise NEX_FAIL or the first NEX_DVC_ERR_* value received.
+     */
+    nex_err_t nextion_scene_render(nextion_scene_t *scene);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
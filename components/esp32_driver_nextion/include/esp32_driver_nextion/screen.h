@@ -0,0 +1,91 @@
+#ifndef __ESP32_DRIVER_NEXTION_SCREEN_H__
+#define __ESP32_DRIVER_NEXTION_SCREEN_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "base/codes.h"
+#include "base/types.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @typedef nextion_screen_item_kind_t
+     * @brief What a screen item sets.
+     */
+    typedef enum
+    {
+        NEX_SCREEN_ITEM_VISIBILITY = 0, /** @brief Component visibility. */
+        NEX_SCREEN_ITEM_NUMBER = 1,     /** @brief Numeric property. */
+        NEX_SCREEN_ITEM_TEXT = 2        /** @brief Text property. */
+    } nextion_screen_item_kind_t;
+
+    /**
+     * @typedef nextion_screen_item_t
+     * @brief Desired state of a component property.
+     */
+    typedef struct
+    {
+        const char *component;           /** @brief Component name or id. */
+        const char *property;            /** @brief Property name; not used for visibility. */
+        nextion_screen_item_kind_t kind; /** @brief What the item sets. */
+        bool is_visible;                 /** @brief Visibility, when it is a visibility item. */
+        int32_t number;                  /** @brief Value, when it is a number item. */
+        const char *text;                /** @brief Value, when it is a text item. */
+    } nextion_screen_item_t;
+
+    /**
+     * @typedef nextion_screen_t
+     * @brief Desired state of a page.
+     */
+    typedef struct
+    {
+        const char *page;                   /** @brief Page name or id; NULL keeps the current page. */
+        const nextion_screen_item_t *items; /** @brief Desired component properties. */
+        size_t item_count;                  /** @brief How many items there are. */
+    } nextion_screen_t;
+
+/**
+ * @brief Screen item for a component visibility.
+ */
+#define NEXTION_SCREEN_VISIBILITY(component_name, visible) \
+    {.component = (component_name), .property = NULL, .kind = NEX_SCREEN_ITEM_VISIBILITY, .is_visible = (visible)}
+
+/**
+ * @brief Screen item for a numeric component property.
+ */
+#define NEXTION_SCREEN_NUMBER(component_name, property_name, value) \
+    {.component = (component_name), .property = (property_name), .kind = NEX_SCREEN_ITEM_NUMBER, .number = (value)}
+
+/**
+ * @brief Screen item for a text component property.
+ */
+#define NEXTION_SCREEN_TEXT(component_name, property_name, value) \
+    {.component = (component_name), .property = (property_name), .kind = NEX_SCREEN_ITEM_TEXT, .text = (value)}
+
+    /**
+     * @brief Bring the display to a desired state, sending only what changed.
+     * @details Items are compared with the values last written through the component
+     * functions, kept by the component cache; only the ones that differ are sent, all
+     * in a single batch. Changing the page discards the values last written, so every
+     * item is sent. A page is the same whether given by id or by name, e.g. "0" and
+     * "page0", once it was set by name.
+     * @note The cache must hold the whole screen: at most CONFIG_NEX_COMPONENT_CACHE_SIZE
+     * items, given by name (not by id), with texts shorter than
+     * CONFIG_NEX_COMPONENT_CACHE_TEXT_SIZE. Properties written elsewhere in between can
+     * push items out of the cache; those are sent again.
+     * @note Cannot be called inside a batch.
+     * @param[in] handle Nextion context pointer.
+     * @param[in] desired Desired state.
+     * @return NEX_OK if success, otherwise NEX_FAIL (also when the cache cannot hold the
+     * screen) or the first NEX_DVC_ERR_* value received.
+     */
+    nex_err_t nextion_screen_apply(nextion_t *handle, const nextion_screen_t *desired);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
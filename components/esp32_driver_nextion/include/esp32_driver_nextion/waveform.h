@@ -3,6 +3,7 @@
 
 #include <stdint.h>
 #include <stddef.h>
+#include "base/constants.h"
 #include "base/codes.h"
 #include "base/types.h"
 
@@ -11,6 +12,16 @@ extern "C"
 {
 #endif
 
+/**
+ * @brief Most values a single waveform stream takes; the "addt" command must fit in the device buffer with them.
+ */
+#define NEX_WAVEFORM_STREAM_MAX_VALUES (NEX_DVC_TRANSPARENT_DATA_MAX_DATA_SIZE - 21U)
+
+/**
+ * @brief How many times a transaction of "nextion_waveform_push_series" is tried.
+ */
+#define NEX_WAVEFORM_PUSH_ATTEMPTS 3U
+
     /**
      * @brief Start default waveform refreshing (refresh on data point add).
      * @param[in] handle Nextion context pointer.
@@ -80,6 +91,15 @@ extern "C"
      */
     nex_err_t nextion_waveform_stream_write(nextion_t *handle, uint8_t value);
 
+    /**
+     * @brief Write many values onto the waveform stream at once.
+     * @param[in] handle Nextion context pointer.
+     * @param[in] values Values to be written.
+     * @param[in] length How many values will be written.
+     * @return NEX_OK if success, otherwise NEX_FAIL.
+     */
+    nex_err_t nextion_waveform_stream_write_buffer(nextion_t *handle, const uint8_t *values, size_t length);
+
     /**
      * @brief End the waveform streaming.
      * @param[in] handle Nextion context pointer.
@@ -87,6 +107,28 @@ extern "C"
      */
     nex_err_t nextion_waveform_stream_end(nextion_t *handle);
 
+    /**
+     * @brief Add a series of values of any length to a waveform channel.
+     * @details The series is split in "addt" transactions of up to NEX_WAVEFORM_STREAM_MAX_VALUES
+     * values. Each transaction is begun right after the data of the previous one is written, so
+     * the display never waits for a round trip. A transaction that fails without a device error
+     * is tried again from its first value not yet applied, up to NEX_WAVEFORM_PUSH_ATTEMPTS times.
+     * A transaction whose values could not all be written is filled up with zeros first, which
+     * the display draws; if the display does not confirm it left the mode, nothing is tried again.
+     * @note The device "hangs" while receiving; no event or other commands will be processed.
+     * @param[in] handle Nextion context pointer.
+     * @param[in] waveform_id Waveform id.
+     * @param[in] channel_id Channel id to add data on.
+     * @param[in] values Values to be added.
+     * @param[in] length How many values there are.
+     * @return NEX_OK if success, otherwise NEX_FAIL, NEX_TIMEOUT or any NEX_DVC_ERR_* value.
+     */
+    nex_err_t nextion_waveform_push_series(nextion_t *handle,
+                                           uint8_t waveform_id,
+                                           uint8_t channel_id,
+                                           const uint8_t *values,
+                                           size_t length);
+
 #ifdef __cplusplus
 }
 #endif
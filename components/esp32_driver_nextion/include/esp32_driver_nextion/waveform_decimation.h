@@ -0,0 +1,111 @@
+#ifndef __ESP32_DRIVER_NEXTION_WAVEFORM_DECIMATION_H__
+#define __ESP32_DRIVER_NEXTION_WAVEFORM_DECIMATION_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * A waveform shows one value per pixel column, so samples beyond its
+     * width only cost bandwidth. Decimation reduces them to one column each,
+     * keeping the lowest and highest sample of the column so peaks survive:
+     *
+     *   nextion_waveform_column_t columns[320];
+     *   uint8_t values[320];
+     *
+     *   size_t count = nextion_waveform_decimate_i16(samples, 10000, NULL, columns, 320);
+     *
+     *   nextion_waveform_columns_trace(columns, count, previous, values);
+     *   nextion_waveform_push_series(handle, waveform_id, channel_id, values, count);
+     */
+
+    /**
+     * @typedef nextion_waveform_scale_t
+     * @brief Maps sample values to the 0..255 range of a waveform.
+     * @details Values outside the range are clamped. A "low" above "high" draws the signal upside down.
+     */
+    typedef struct
+    {
+        float low;  /** @brief Sample value drawn at 0. */
+        float high; /** @brief Sample value drawn at 255. */
+    } nextion_waveform_scale_t;
+
+    /**
+     * @typedef nextion_waveform_column_t
+     * @brief Envelope of the samples falling on a pixel column, already scaled.
+     */
+    typedef struct
+    {
+        uint8_t min; /** @brief Lowest scaled sample. */
+        uint8_t max; /** @brief Highest scaled sample. */
+    } nextion_waveform_column_t;
+
+    /**
+     * @brief Reduce 8 bits samples to a min/max envelope per pixel column.
+     * @param[in] samples Samples, from the oldest.
+     * @param[in] length How many samples there are.
+     * @param[in] scale Scale; when NULL, 0..255.
+     * @param[out] columns Location where the columns will be stored.
+     * @param[in] width How many columns there is room for; usually the waveform width.
+     * @return How many columns were stored; "width", or "length" when there are fewer samples. Zero on error.
+     */
+    size_t nextion_waveform_decimate_u8(const uint8_t *samples,
+                                        size_t length,
+                                        const nextion_waveform_scale_t *scale,
+                                        nextion_waveform_column_t *columns,
+                                        size_t width);
+
+    /**
+     * @brief Reduce signed 16 bits samples to a min/max envelope per pixel column.
+     * @param[in] samples Samples, from the oldest.
+     * @param[in] length How many samples there are.
+     * @param[in] scale Scale; when NULL, -32768..32767.
+     * @param[out] columns Location where the columns will be stored.
+     * @param[in] width How many columns there is room for; usually the waveform width.
+     * @return How many columns were stored; "width", or "length" when there are fewer samples. Zero on error.
+     */
+    size_t nextion_waveform_decimate_i16(const int16_t *samples,
+                                         size_t length,
+                                         const nextion_waveform_scale_t *scale,
+                                         nextion_waveform_column_t *columns,
+                                         size_t width);
+
+    /**
+     * @brief Reduce floating point samples to a min/max envelope per pixel column.
+     * @param[in] samples Samples, from the oldest. NaN samples are ignored, unless a column has nothing else.
+     * @param[in] length How many samples there are.
+     * @param[in] scale Scale; when NULL, -1..1.
+     * @param[out] columns Location where the columns will be stored.
+     * @param[in] width How many columns there is room for; usually the waveform width.
+     * @return How many columns were stored; "width", or "length" when there are fewer samples. Zero on error.
+     */
+    size_t nextion_waveform_decimate_float(const float *samples,
+                                           size_t length,
+                                           const nextion_waveform_scale_t *scale,
+                                           nextion_waveform_column_t *columns,
+                                           size_t width);
+
+    /**
+     * @brief Pick one value per column so the line the display draws spans each envelope.
+     * @details The display joins consecutive values with a line. Each column takes
+     * the end of its envelope farther from the value before it, so the line sweeps
+     * across the column and neither the highs nor the lows are lost.
+     * @param[in] columns Columns.
+     * @param[in] count How many columns there are.
+     * @param[in] previous Last value on the graph; where the line starts from.
+     * @param[out] values Location where the values will be stored; room for "count".
+     * @return How many values were stored. Zero on error.
+     */
+    size_t nextion_waveform_columns_trace(const nextion_waveform_column_t *columns,
+                                          size_t count,
+                                          uint8_t previous,
+                                          uint8_t *values);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,105 @@
+#ifndef __ESP32_DRIVER_NEXTION_WAVEFORM_PUMP_H__
+#define __ESP32_DRIVER_NEXTION_WAVEFORM_PUMP_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "base/types.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Most channels a waveform has.
+ */
+#define NEX_WAVEFORM_PUMP_MAX_CHANNELS 4U
+
+    /**
+     * A pump streams live samples to a waveform. Producers push values
+     * into a lock-free ring per channel, without waiting on the display;
+     * a task drains the rings on a fixed cadence, each channel in one
+     * "addt" transaction.
+     *
+     * The values sent per cycle follow the measured link capacity. When
+     * the link falls behind, the oldest values are dropped so the graph
+     * stays live, and counted.
+     */
+
+    /**
+     * @typedef nextion_waveform_pump_t
+     * @brief Waveform pump.
+     */
+    typedef struct nextion_waveform_pump_t nextion_waveform_pump_t;
+
+    /**
+     * @typedef nextion_waveform_pump_config_t
+     * @brief Waveform pump configuration.
+     */
+    typedef struct
+    {
+        uint8_t waveform_id;   /** @brief Waveform id. */
+        uint8_t channel_count; /** @brief Channels fed, from 0; up to NEX_WAVEFORM_PUMP_MAX_CHANNELS. */
+        uint32_t period_ms;    /** @brief How often the rings are drained. */
+        size_t ring_size;      /** @brief How many values each channel ring holds. */
+    } nextion_waveform_pump_config_t;
+
+    /**
+     * @typedef nextion_waveform_pump_stats_t
+     * @brief Waveform pump counters, summed over the channels.
+     */
+    typedef struct
+    {
+        uint32_t samples_queued;         /** @brief Values accepted by "nextion_waveform_pump_push". */
+        uint32_t samples_sent;           /** @brief Values added to the waveform. */
+        uint32_t samples_dropped_full;   /** @brief Values refused because their ring was full. */
+        uint32_t samples_dropped_behind; /** @brief Oldest values dropped because the link fell behind. */
+        uint32_t samples_failed;         /** @brief Values lost in failed transactions. */
+        uint32_t transactions;           /** @brief Transactions completed. */
+        uint32_t transactions_failed;    /** @brief Transactions failed. */
+        uint32_t batch_limit;            /** @brief Most values currently sent per channel and cycle. */
+        uint32_t link_values_per_sec;    /** @brief Measured link capacity, the fixed cost of each transaction aside; zero until measured. */
+    } nextion_waveform_pump_stats_t;
+
+    /**
+     * @brief Create a pump and start its task.
+     * @note The driver must outlive the pump.
+     * @param[in] handle Nextion context pointer.
+     * @param[in] config Configuration.
+     * @return Pump pointer, or NULL on failure.
+     */
+    nextion_waveform_pump_t *nextion_waveform_pump_create(nextion_t *handle, const nextion_waveform_pump_config_t *config);
+
+    /**
+     * @brief Stop the pump task, after its current cycle, and free the pump.
+     * @note Values still in the rings are discarded.
+     * @param[in] pump Pump pointer.
+     * @return True if success, otherwise false.
+     */
+    bool nextion_waveform_pump_delete(nextion_waveform_pump_t *pump);
+
+    /**
+     * @brief Queue values on a channel. Never blocks.
+     * @note Each channel takes a single producer at a time. Values that do not fit are
+     * dropped and counted in "samples_dropped_full".
+     * @param[in] pump Pump pointer.
+     * @param[in] channel_id Channel id.
+     * @param[in] values Values.
+     * @param[in] length How many values there are.
+     * @return How many values were queued, from the first.
+     */
+    size_t nextion_waveform_pump_push(nextion_waveform_pump_t *pump, uint8_t channel_id, const uint8_t *values, size_t length);
+
+    /**
+     * @brief Get a copy of the pump counters.
+     * @param[in] pump Pump pointer.
+     * @param[out] stats Location where the counters will be stored.
+     * @return True if success, otherwise false.
+     */
+    bool nextion_waveform_pump_stats_get(nextion_waveform_pump_t *pump, nextion_waveform_pump_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
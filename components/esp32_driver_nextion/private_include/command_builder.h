@@ -0,0 +1,130 @@
+#ifndef __ESP32_DRIVER_NEXTION_COMMAND_BUILDER_H__
+#define __ESP32_DRIVER_NEXTION_COMMAND_BUILDER_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdarg.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @typedef nextion_command_builder_flush_t
+     * @brief Called when the builder buffer is full, to write what it holds.
+     * @param context Pointer given when the builder was initialized.
+     * @param data Bytes to write.
+     * @param length How many bytes there are.
+     * @return True if success, otherwise false.
+     */
+    typedef bool (*nextion_command_builder_flush_t)(void *context, const char *data, size_t length);
+
+    /**
+     * @typedef nextion_command_builder_t
+     * @brief Writes commands piece by piece straight into a buffer.
+     * @details When the buffer fills up it is handed to the flush function and
+     * reused, so commands are never truncated; without a flush function the
+     * builder fails instead.
+     */
+    typedef struct
+    {
+        char *buffer;                          /** @brief Where bytes are written. */
+        size_t capacity;                       /** @brief Buffer length. */
+        size_t length;                         /** @brief How many bytes of the buffer are used. */
+        nextion_command_builder_flush_t flush; /** @brief Called when the buffer is full; can be NULL. */
+        void *context;                         /** @brief Pointer passed to the flush function. */
+        bool failed;                           /** @brief If any append or flush failed; further appends are ignored. */
+    } nextion_command_builder_t;
+
+    /**
+     * @brief Initialize a builder.
+     * @param[in] builder Builder pointer.
+     * @param[in] buffer Where bytes are written.
+     * @param[in] capacity Buffer length.
+     * @param[in] length How many bytes of the buffer are already used.
+     * @param[in] flush Called when the buffer is full; can be NULL.
+     * @param[in] context Pointer passed to the flush function.
+     */
+    void nextion_command_builder_init(nextion_command_builder_t *builder,
+                                      char *buffer,
+                                      size_t capacity,
+                                      size_t length,
+                                      nextion_command_builder_flush_t flush,
+                                      void *context);
+
+    /**
+     * @brief Append a single character.
+     * @param[in] builder Builder pointer.
+     * @param[in] value Character.
+     * @return True if success, otherwise false.
+     */
+    bool nextion_command_builder_append_char(nextion_command_builder_t *builder, char value);
+
+    /**
+     * @brief Append an identifier (e.g. "b0", "page0" or "val"), or any text, as it is.
+     * @param[in] builder Builder pointer.
+     * @param[in] text Null-terminated text.
+     * @return True if success, otherwise false.
+     */
+    bool nextion_command_builder_append_identifier(nextion_command_builder_t *builder, const char *text);
+
+    /**
+     * @brief Append a signed integer in decimal.
+     * @param[in] builder Builder pointer.
+     * @param[in] value Integer.
+     * @return True if success, otherwise false.
+     */
+    bool nextion_command_builder_append_int(nextion_command_builder_t *builder, int32_t value);
+
+    /**
+     * @brief Append an unsigned integer in decimal.
+     * @param[in] builder Builder pointer.
+     * @param[in] value Integer.
+     * @return True if success, otherwise false.
+     */
+    bool nextion_command_builder_append_uint(nextion_command_builder_t *builder, uint32_t value);
+
+    /**
+     * @brief Append a string literal, between double quotes.
+     * @details Double quotes are escaped and line breaks become "\r". A backslash
+     * and the character after it are kept as they are, so text the caller already
+     * escaped is not escaped twice; only a trailing backslash is doubled.
+     * @param[in] builder Builder pointer.
+     * @param[in] text Null-terminated text.
+     * @return True if success, otherwise false.
+     */
+    bool nextion_command_builder_append_quoted(nextion_command_builder_t *builder, const char *text);
+
+    /**
+     * @brief Append a formatted text.
+     * @details Takes printf conversions, "%n" aside. "%s", "%d", "%i", "%u", "%c"
+     * and "%%", with an optional "l" length, are appended directly; the others go
+     * through snprintf, each up to 63 characters. A "%s" between double quotes is
+     * appended as with "nextion_command_builder_append_quoted".
+     * @param[in] builder Builder pointer.
+     * @param[in] format Null-terminated format.
+     * @param[in] args Format arguments.
+     * @return True if success, otherwise false.
+     */
+    bool nextion_command_builder_append_format(nextion_command_builder_t *builder, const char *format, va_list args);
+
+    /**
+     * @brief Append the command termination.
+     * @param[in] builder Builder pointer.
+     * @return True if success, otherwise false.
+     */
+    bool nextion_command_builder_append_end(nextion_command_builder_t *builder);
+
+    /**
+     * @brief Hand whatever the buffer holds to the flush function.
+     * @param[in] builder Builder pointer.
+     * @return True if success or if there is nothing to write, otherwise false.
+     */
+    bool nextion_command_builder_flush(nextion_command_builder_t *builder);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
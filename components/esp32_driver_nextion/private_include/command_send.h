@@ -0,0 +1,48 @@
+#ifndef __ESP32_DRIVER_NEXTION_COMMAND_SEND_H__
+#define __ESP32_DRIVER_NEXTION_COMMAND_SEND_H__
+
+#include "esp32_driver_nextion/base/codes.h"
+#include "esp32_driver_nextion/base/types.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief Send a command the display only answers on failure, as "add" and "rest".
+     * @details When it times out, no late response is expected, so the next one is not dropped.
+     * @param[in] handle Nextion context pointer.
+     * @param[in] command Command format.
+     * @param[in] ... Command format arguments.
+     * @return NEX_OK or NEX_FAIL | NEX_TIMEOUT | NEX_DVC_ERR_* codes; NEX_TIMEOUT when not answered.
+     */
+    nex_err_t nextion_command_send_quiet(nextion_t *handle, const char *command, ...);
+
+    /**
+     * @brief Send a command that is already built, as "nextion_command_send" does.
+     * @details The command is copied as it is; nothing is formatted.
+     * @param[in] handle Nextion context pointer.
+     * @param[in] command Null-terminated command, without termination.
+     * @return NEX_OK or NEX_FAIL | NEX_DVC_ERR_* codes.
+     */
+    nex_err_t nextion_command_send_built(nextion_t *handle, const char *command);
+
+    /**
+     * @brief Send a command that is already built, as "nextion_command_send_async" does.
+     * @details The command is copied as it is; nothing is formatted.
+     * @param[in] handle Nextion context pointer.
+     * @param[in] callback Called when completed; can be NULL.
+     * @param[in] context Pointer passed to the callback.
+     * @param[in] command Null-terminated command, without termination.
+     * @return NEX_OK or NEX_FAIL.
+     */
+    nex_err_t nextion_command_send_built_async(nextion_t *handle,
+                                               command_callback_on_complete callback,
+                                               void *context,
+                                               const char *command);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,177 @@
+#ifndef __ESP32_DRIVER_NEXTION_COMPONENT_CACHE_H__
+#define __ESP32_DRIVER_NEXTION_COMPONENT_CACHE_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+#include "esp32_driver_nextion/base/constants.h"
+#include "esp32_driver_nextion/base/types.h"
+#include "config.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Maximum length of a property name kept in the cache.
+ */
+#define NEX_COMPONENT_CACHE_PROPERTY_MAX_LENGTH 8U
+
+    /**
+     * @typedef nextion_component_cache_kind_t
+     * @brief What a cache entry holds.
+     */
+    typedef enum
+    {
+        NEX_COMPONENT_CACHE_NUMBER = 0,    /** @brief A numeric property. */
+        NEX_COMPONENT_CACHE_TEXT = 1,      /** @brief A text property. */
+        NEX_COMPONENT_CACHE_VISIBILITY = 2 /** @brief The component visibility; it has no property name. */
+    } nextion_component_cache_kind_t;
+
+    /**
+     * @typedef nextion_component_cache_entry_t
+     * @brief Last value written to a component property.
+     */
+    typedef struct
+    {
+        char component[NEX_DVC_COMPONENT_MAX_NAME_LENGTH + 1];     /** @brief Component name; the only form kept. */
+        char page[NEX_DVC_PAGE_MAX_NAME_LENGTH + 1];                /** @brief Page the value was written on, or empty if unknown. */
+        char property[NEX_COMPONENT_CACHE_PROPERTY_MAX_LENGTH + 1]; /** @brief Property name. */
+        char text[CONFIG_NEX_COMPONENT_CACHE_TEXT_SIZE];            /** @brief Value, when it is a text. */
+        int32_t number;                                             /** @brief Value, when it is a number or visibility. */
+        uint32_t last_used;                                         /** @brief When it was last used; the oldest is replaced first. */
+        nextion_component_cache_kind_t kind;                        /** @brief What the entry holds. */
+        bool is_used;                                               /** @brief If the entry holds a value. */
+    } nextion_component_cache_entry_t;
+
+    /**
+     * @typedef nextion_component_cache_t
+     * @brief Fixed size, write-through shadow of component properties.
+     * @details Components are given as "name" or "page.name"; a plain name is on the page
+     * last set. A property has one entry, holding the page its value was written on, and
+     * is only found on that page. Ids, as "3" or "b[3]", cannot be told apart from names:
+     * they are never kept, and writing through one forgets the property of every component.
+     * Pages are kept by id when it is known, so "0" and the name last set for page 0 are
+     * the same page.
+     */
+    typedef struct
+    {
+        nextion_component_cache_entry_t entries[CONFIG_NEX_COMPONENT_CACHE_SIZE > 0 ? CONFIG_NEX_COMPONENT_CACHE_SIZE : 1]; /** @brief Cache entries. */
+        char page[NEX_DVC_PAGE_MAX_NAME_LENGTH + 1];                                                                        /** @brief Page last set, by id when known, or empty if unknown. */
+        char page_name[NEX_DVC_PAGE_MAX_NAME_LENGTH + 1];                                                                   /** @brief Name the page last set was given by, or empty if it was an id. */
+        nextion_component_cache_stats_t stats;                                                                              /** @brief Counters. */
+        uint32_t clock;                                                                                                     /** @brief Incremented on every use. */
+        portMUX_TYPE lock;                                                                                                  /** @brief Lock used for entry control. */
+    } nextion_component_cache_t;
+
+    /**
+     * @brief Get the component cache of a Nextion context.
+     * @param[in] handle Nextion context pointer.
+     * @return Cache pointer.
+     */
+    nextion_component_cache_t *nextion_component_cache_of(nextion_t *handle);
+
+    /**
+     * @brief Initialize a cache, with all entries empty and counters zeroed.
+     * @param[in] cache Cache pointer.
+     */
+    void nextion_component_cache_init(nextion_component_cache_t *cache);
+
+    /**
+     * @brief Check if a property already holds a value, counting a hit or a miss.
+     * @param[in] cache Cache pointer.
+     * @param[in] kind What the property holds.
+     * @param[in] component Component name, "page.name" or id.
+     * @param[in] property Property name; ignored for visibility.
+     * @param[in] number Value, when it is a number or visibility.
+     * @param[in] text Value, when it is a text.
+     * @return True if the value is the same last written, on the same page, otherwise false.
+     */
+    bool nextion_component_cache_contains(nextion_component_cache_t *cache,
+                                          nextion_component_cache_kind_t kind,
+                                          const char *component,
+                                          const char *property,
+                                          int32_t number,
+                                          const char *text);
+
+    /**
+     * @brief Keep the value written to a property, replacing the least
+     * recently used entry if the cache is full.
+     * @note Ids, names or texts too long to fit are not kept; the entries they might
+     * stand for are removed.
+     * @param[in] cache Cache pointer.
+     * @param[in] kind What the property holds.
+     * @param[in] component Component name, "page.name" or id.
+     * @param[in] property Property name; ignored for visibility.
+     * @param[in] number Value, when it is a number or visibility.
+     * @param[in] text Value, when it is a text.
+     */
+    void nextion_component_cache_store(nextion_component_cache_t *cache,
+                                       nextion_component_cache_kind_t kind,
+                                       const char *component,
+                                       const char *property,
+                                       int32_t number,
+                                       const char *text);
+
+    /**
+     * @brief Check if the value written to a property can be kept.
+     * @param[in] cache Cache pointer.
+     * @param[in] kind What the property holds.
+     * @param[in] component Component name, "page.name" or id.
+     * @param[in] property Property name; ignored for visibility.
+     * @param[in] text Value, when it is a text.
+     * @return True if it fits an entry, false if it is an id or too long, or the cache is disabled.
+     */
+    bool nextion_component_cache_can_keep(nextion_component_cache_t *cache,
+                                          nextion_component_cache_kind_t kind,
+                                          const char *component,
+                                          const char *property,
+                                          const char *text);
+
+    /**
+     * @brief Forget the value of a property, e.g. when writing it failed.
+     * @param[in] cache Cache pointer.
+     * @param[in] kind What the property holds.
+     * @param[in] component Component name, "page.name" or id; an id forgets it for every component.
+     * @param[in] property Property name; ignored for visibility.
+     */
+    void nextion_component_cache_remove(nextion_component_cache_t *cache,
+                                        nextion_component_cache_kind_t kind,
+                                        const char *component,
+                                        const char *property);
+
+    /**
+     * @brief Keep the page last set.
+     * @note Call it after the cache was invalidated for the page change.
+     * @param[in] cache Cache pointer.
+     * @param[in] page Page name or id.
+     */
+    void nextion_component_cache_store_page(nextion_component_cache_t *cache, const char *page);
+
+    /**
+     * @brief Keep the id of the page last set by name, as reported by the display.
+     * @note Ignored if the cache was invalidated since the page was set.
+     * @param[in] cache Cache pointer.
+     * @param[in] page_id Page id.
+     */
+    void nextion_component_cache_store_page_id(nextion_component_cache_t *cache, uint8_t page_id);
+
+    /**
+     * @brief Check if a page was the last one set.
+     * @param[in] cache Cache pointer.
+     * @param[in] page Page name or id.
+     * @return True if it is the current page, otherwise false.
+     */
+    bool nextion_component_cache_contains_page(nextion_component_cache_t *cache, const char *page);
+
+    /**
+     * @brief Forget all values and the current page; the device state is no longer known.
+     * @param[in] cache Cache pointer.
+     */
+    void nextion_component_cache_invalidate(nextion_component_cache_t *cache);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -8,6 +8,13 @@ extern "C"
 {
 #endif
 
+#ifndef CONFIG_NEX_UART_BAUD_RATE_TARGET
+/**
+ * @brief Highest negotiated baud rate.
+ */
+#define CONFIG_NEX_UART_BAUD_RATE_TARGET 921600
+#endif
+
 #ifndef CONFIG_NEX_UART_MUTEX_WAIT_TIME_MS
 /**
  * @brief Mutex acquire wait time(ms).
@@ -36,6 +43,20 @@ extern "C"
 #define CONFIG_NEX_UART_RECV_BUFFER_SIZE 256
 #endif
 
+#ifndef CONFIG_NEX_UART_RECV_READ_SIZE
+/**
+ * @brief UART receiver bulk read size (bytes).
+ */
+#define CONFIG_NEX_UART_RECV_READ_SIZE 128
+#endif
+
+#ifndef CONFIG_NEX_UART_RECV_FRAME_BUFFER_SIZE
+/**
+ * @brief UART receiver frame buffer size (bytes).
+ */
+#define CONFIG_NEX_UART_RECV_FRAME_BUFFER_SIZE 128
+#endif
+
 #ifndef CONFIG_NEX_UART_TRANS_COMMAND_FORMAT_BUFFER_SIZE
 /**
  * @brief UART command format buffer size (bytes).
@@ -43,6 +64,48 @@ extern "C"
 #define CONFIG_NEX_UART_TRANS_COMMAND_FORMAT_BUFFER_SIZE 256
 #endif
 
+#ifndef CONFIG_NEX_UART_COMMAND_QUEUE_SIZE
+/**
+ * @brief How many commands can wait for a response at the same time.
+ */
+#define CONFIG_NEX_UART_COMMAND_QUEUE_SIZE 16
+#endif
+
+#ifndef CONFIG_NEX_UART_BATCH_BUFFER_SIZE
+/**
+ * @brief Command batch buffer size (bytes).
+ */
+#define CONFIG_NEX_UART_BATCH_BUFFER_SIZE 512
+#endif
+
+#ifndef CONFIG_NEX_COMPONENT_CACHE_SIZE
+/**
+ * @brief Component property cache size (entries); zero disables it.
+ */
+#define CONFIG_NEX_COMPONENT_CACHE_SIZE 16
+#endif
+
+#ifndef CONFIG_NEX_COMPONENT_CACHE_TEXT_SIZE
+/**
+ * @brief Longest text kept in the component property cache (bytes).
+ */
+#define CONFIG_NEX_COMPONENT_CACHE_TEXT_SIZE 24
+#endif
+
+#ifndef CONFIG_NEX_EEPROM_CACHE_BLOCKS
+/**
+ * @brief EEPROM cache size (32 bytes blocks); zero disables it.
+ */
+#define CONFIG_NEX_EEPROM_CACHE_BLOCKS 0
+#endif
+
+#ifndef CONFIG_NEX_EEPROM_CACHE_FLUSH_DELAY_MS
+/**
+ * @brief EEPROM cache flush delay (ms); zero flushes only when asked.
+ */
+#define CONFIG_NEX_EEPROM_CACHE_FLUSH_DELAY_MS 1000
+#endif
+
 #ifndef CONFIG_NEX_UART_TASK_PRIORITY
 /**
  * @brief UART task priority.
@@ -50,6 +113,69 @@ extern "C"
 #define CONFIG_NEX_UART_TASK_PRIORITY 1
 #endif
 
+#ifndef CONFIG_NEX_UART_SHARED_TASK_MAX_DISPLAYS
+/**
+ * @brief How many displays the shared UART task serves.
+ */
+#define CONFIG_NEX_UART_SHARED_TASK_MAX_DISPLAYS 2
+#endif
+
+#ifndef CONFIG_NEX_EVENT_QUEUE_SIZE
+/**
+ * @brief How many received events can wait for their callbacks.
+ */
+#define CONFIG_NEX_EVENT_QUEUE_SIZE 16
+#endif
+
+#ifndef CONFIG_NEX_EVENT_TASK_PRIORITY
+/**
+ * @brief Event task priority.
+ */
+#define CONFIG_NEX_EVENT_TASK_PRIORITY 1
+#endif
+
+#ifndef CONFIG_NEX_EVENT_TASK_STACK_SIZE
+/**
+ * @brief Event task stack size (bytes).
+ */
+#define CONFIG_NEX_EVENT_TASK_STACK_SIZE 2048
+#endif
+
+#ifndef CONFIG_NEX_WAVEFORM_PUMP_TASK_PRIORITY
+/**
+ * @brief Waveform pump task priority.
+ */
+#define CONFIG_NEX_WAVEFORM_PUMP_TASK_PRIORITY 1
+#endif
+
+#ifndef CONFIG_NEX_WAVEFORM_PUMP_TASK_STACK_SIZE
+/**
+ * @brief Waveform pump task stack size (bytes).
+ */
+#define CONFIG_NEX_WAVEFORM_PUMP_TASK_STACK_SIZE 3072
+#endif
+
+#ifndef CONFIG_NEX_ANIMATION_TASK_PRIORITY
+/**
+ * @brief Animation task priority.
+ */
+#define CONFIG_NEX_ANIMATION_TASK_PRIORITY 1
+#endif
+
+#ifndef CONFIG_NEX_ANIMATION_TASK_STACK_SIZE
+/**
+ * @brief Animation task stack size (bytes).
+ */
+#define CONFIG_NEX_ANIMATION_TASK_STACK_SIZE 3072
+#endif
+
+#ifndef CONFIG_NEX_WIRE_CAPTURE_SIZE
+/**
+ * @brief Wire capture size (bytes); zero disables it.
+ */
+#define CONFIG_NEX_WIRE_CAPTURE_SIZE 0
+#endif
+
 #ifdef __cplusplus
 }
 #endif
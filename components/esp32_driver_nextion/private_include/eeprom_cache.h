@@ -0,0 +1,199 @@
+#ifndef __ESP32_DRIVER_NEXTION_EEPROM_CACHE_H__
+#define __ESP32_DRIVER_NEXTION_EEPROM_CACHE_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp32_driver_nextion/base/constants.h"
+#include "esp32_driver_nextion/base/types.h"
+#include "config.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Bytes a cache block holds; one bit per byte in its masks.
+ */
+#define NEX_EEPROM_CACHE_BLOCK_SIZE 32U
+
+    /**
+     * @typedef nextion_eeprom_cache_block_t
+     * @brief Cached copy of an aligned EEPROM block.
+     */
+    typedef struct
+    {
+        uint8_t bytes[NEX_EEPROM_CACHE_BLOCK_SIZE]; /** @brief Block bytes. */
+        uint32_t valid;                             /** @brief Bit "n" set if byte "n" is known. */
+        uint32_t dirty;                             /** @brief Bit "n" set if byte "n" was written and not flushed. */
+        uint16_t index;                             /** @brief Block index; its address divided by the block size. */
+        uint32_t last_used;                         /** @brief When it was last used; the oldest clean block is replaced first. */
+        bool is_used;                               /** @brief If the block holds bytes. */
+    } nextion_eeprom_cache_block_t;
+
+    /**
+     * @typedef nextion_eeprom_cache_t
+     * @brief Fixed size, write-back cache of EEPROM blocks.
+     * @details Operations and the device commands they send are serialized by "sync";
+     * the block functions below expect it to be held. Only the flush schedule is read
+     * without it, by the task flushing on time, under "lock".
+     */
+    typedef struct
+    {
+        nextion_eeprom_cache_block_t blocks[CONFIG_NEX_EEPROM_CACHE_BLOCKS > 0 ? CONFIG_NEX_EEPROM_CACHE_BLOCKS : 1]; /** @brief Cache blocks. */
+        nextion_eeprom_cache_stats_t stats;                                                                          /** @brief Counters. */
+        uint32_t clock;                                                                                              /** @brief Incremented on every use. */
+        bool is_dirty;                                                                                               /** @brief If any byte waits to be flushed. */
+        TickType_t dirty_since;                                                                                      /** @brief When the cache became dirty, or the last flush failed. */
+        nex_err_t flush_result;                                                                                      /** @brief Failure of the last timed flush, until reported by a write; NEX_OK for none. */
+        TaskHandle_t flusher;                                                                                        /** @brief Task notified when the cache becomes dirty; NULL for none. */
+        SemaphoreHandle_t sync;                                                                                      /** @brief Held during an operation. */
+        portMUX_TYPE lock;                                                                                           /** @brief Lock used for the flush schedule. */
+    } nextion_eeprom_cache_t;
+
+    /**
+     * @brief Get the EEPROM cache of a Nextion context.
+     * @param[in] handle Nextion context pointer.
+     * @return Cache pointer.
+     */
+    nextion_eeprom_cache_t *nextion_eeprom_cache_of(nextion_t *handle);
+
+    /**
+     * @brief Flush the EEPROM cache of a Nextion context once it is due.
+     * @details Called by the task flushing on time; a failure is kept
+     * for the next write to report.
+     * @param[in] handle Nextion context pointer.
+     */
+    void nextion_eeprom_flush_on_time(nextion_t *handle);
+
+    /**
+     * @brief Initialize an empty cache, with counters zeroed.
+     * @param[in] cache Cache pointer.
+     */
+    void nextion_eeprom_cache_init(nextion_eeprom_cache_t *cache);
+
+    /**
+     * @brief Release the cache resources.
+     * @param[in] cache Cache pointer.
+     */
+    void nextion_eeprom_cache_deinit(nextion_eeprom_cache_t *cache);
+
+    /**
+     * @brief Take the cache for an operation.
+     * @param[in] cache Cache pointer.
+     * @return True if taken, otherwise false.
+     */
+    bool nextion_eeprom_cache_acquire(nextion_eeprom_cache_t *cache);
+
+    /**
+     * @brief Give the cache back.
+     * @param[in] cache Cache pointer.
+     */
+    void nextion_eeprom_cache_release(nextion_eeprom_cache_t *cache);
+
+    /**
+     * @brief Copy known bytes.
+     * @param[in] cache Cache pointer.
+     * @param[in] address Starting address.
+     * @param[out] bytes Location where the bytes will be stored; unknown ones are left as they are.
+     * @param[in] length How many bytes.
+     * @return True if all bytes were known, otherwise false.
+     */
+    bool nextion_eeprom_cache_read(nextion_eeprom_cache_t *cache, uint16_t address, uint8_t *bytes, size_t length);
+
+    /**
+     * @brief Get the smallest span of whole blocks holding every unknown byte of a range.
+     * @param[in] cache Cache pointer.
+     * @param[in] address Starting address.
+     * @param[in] length How many bytes.
+     * @param[out] span_address Location where the span address will be stored.
+     * @param[out] span_length Location where the span length will be stored.
+     * @return True if any byte is unknown, otherwise false.
+     */
+    bool nextion_eeprom_cache_missing(nextion_eeprom_cache_t *cache,
+                                      uint16_t address,
+                                      size_t length,
+                                      uint16_t *span_address,
+                                      size_t *span_length);
+
+    /**
+     * @brief Keep bytes read from the device; bytes written and not flushed are kept instead.
+     * @param[in] cache Cache pointer.
+     * @param[in] address Starting address.
+     * @param[in] bytes Bytes read.
+     * @param[in] length How many bytes.
+     * @return True if kept, false if there was no room; then nothing is kept.
+     */
+    bool nextion_eeprom_cache_fill(nextion_eeprom_cache_t *cache, uint16_t address, const uint8_t *bytes, size_t length);
+
+    /**
+     * @brief Keep bytes written, to be flushed later.
+     * @param[in] cache Cache pointer.
+     * @param[in] address Starting address.
+     * @param[in] bytes Bytes written.
+     * @param[in] length How many bytes.
+     * @return True if kept, false if there was no room without flushing; then nothing is kept.
+     */
+    bool nextion_eeprom_cache_write(nextion_eeprom_cache_t *cache, uint16_t address, const uint8_t *bytes, size_t length);
+
+    /**
+     * @brief Forget a range, written bytes included, e.g. when it is written around the cache.
+     * @param[in] cache Cache pointer.
+     * @param[in] address Starting address.
+     * @param[in] length How many bytes.
+     */
+    void nextion_eeprom_cache_discard(nextion_eeprom_cache_t *cache, uint16_t address, size_t length);
+
+    /**
+     * @brief Forget everything, written bytes included.
+     * @param[in] cache Cache pointer.
+     */
+    void nextion_eeprom_cache_invalidate(nextion_eeprom_cache_t *cache);
+
+    /**
+     * @brief Find the next range to be flushed.
+     * @details Written bytes separated only by known bytes are joined in one range;
+     * writing the known bytes back is cheaper than another transaction.
+     * @param[in] cache Cache pointer.
+     * @param[in] from Lowest address to look from.
+     * @param[in] max_length Longest range.
+     * @param[out] address Location where the range address will be stored.
+     * @param[out] length Location where the range length will be stored.
+     * @return True if found, otherwise false.
+     */
+    bool nextion_eeprom_cache_next_run(nextion_eeprom_cache_t *cache,
+                                       uint16_t from,
+                                       size_t max_length,
+                                       uint16_t *address,
+                                       size_t *length);
+
+    /**
+     * @brief Mark a flushed range as clean.
+     * @param[in] cache Cache pointer.
+     * @param[in] address Starting address.
+     * @param[in] length How many bytes.
+     */
+    void nextion_eeprom_cache_clean(nextion_eeprom_cache_t *cache, uint16_t address, size_t length);
+
+    /**
+     * @brief Try flushing on time again after a delay, e.g. when flushing failed.
+     * @param[in] cache Cache pointer.
+     */
+    void nextion_eeprom_cache_postpone(nextion_eeprom_cache_t *cache);
+
+    /**
+     * @brief Get how long until the cache must be flushed.
+     * @param[in] cache Cache pointer.
+     * @param[out] wait Location where the time left will be stored; zero when due.
+     * @return True if it must be flushed on time, otherwise false.
+     */
+    bool nextion_eeprom_cache_flush_wait(nextion_eeprom_cache_t *cache, TickType_t *wait);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,64 @@
+#ifndef __ESP32_DRIVER_NEXTION_EVENT_RING_H__
+#define __ESP32_DRIVER_NEXTION_EVENT_RING_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include "esp32_driver_nextion/base/constants.h"
+#include "config.h"
+#include "ring.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @typedef nextion_event_ring_entry_t
+     * @brief A received event frame.
+     */
+    typedef struct
+    {
+        uint8_t frame[NEX_DVC_EVT_MAX_RESPONSE_LENGTH]; /** @brief Event frame, including its termination. */
+        uint8_t length;                                 /** @brief Frame length. */
+    } nextion_event_ring_entry_t;
+
+    /**
+     * @typedef nextion_event_ring_t
+     * @brief Lock-free ring of events, with a single producer and a single consumer.
+     */
+    typedef struct
+    {
+        nextion_event_ring_entry_t entries[CONFIG_NEX_EVENT_QUEUE_SIZE + 1]; /** @brief Ring slots. */
+        nextion_ring_t ring;                                                  /** @brief Ring over the slots. */
+        atomic_uint_least32_t dropped;                                        /** @brief How many events did not fit. */
+    } nextion_event_ring_t;
+
+    /**
+     * @brief Initialize an empty ring.
+     * @param[in] ring Ring pointer.
+     */
+    void nextion_event_ring_init(nextion_event_ring_t *ring);
+
+    /**
+     * @brief Add an event. Called only by the producer.
+     * @param[in] ring Ring pointer.
+     * @param[in] frame Event frame.
+     * @param[in] length Frame length; longer frames are truncated to NEX_DVC_EVT_MAX_RESPONSE_LENGTH.
+     * @return True if added, false if the ring is full.
+     */
+    bool nextion_event_ring_push(nextion_event_ring_t *ring, const uint8_t *frame, size_t length);
+
+    /**
+     * @brief Remove the oldest event. Called only by the consumer.
+     * @param[in] ring Ring pointer.
+     * @param[out] entry Location where the event will be stored.
+     * @return True if an event was removed, false if the ring is empty.
+     */
+    bool nextion_event_ring_pop(nextion_event_ring_t *ring, nextion_event_ring_entry_t *entry);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
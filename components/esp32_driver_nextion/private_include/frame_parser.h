@@ -0,0 +1,77 @@
+#ifndef __ESP32_DRIVER_NEXTION_FRAME_PARSER_H__
+#define __ESP32_DRIVER_NEXTION_FRAME_PARSER_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "config.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @typedef nextion_frame_parser_state_t
+     * @brief Frame parser state.
+     */
+    typedef enum
+    {
+        NEX_FRAME_PARSER_IDLE = 0,       /** @brief Waiting for the first byte of a frame. */
+        NEX_FRAME_PARSER_AMBIGUOUS = 1,  /** @brief Read a 0x00; the next byte tells if it is a failure or a reset. */
+        NEX_FRAME_PARSER_FIXED = 2,      /** @brief Reading a frame with a known length. */
+        NEX_FRAME_PARSER_VARIABLE = 3,   /** @brief Reading a frame until its termination. */
+        NEX_FRAME_PARSER_RESYNC = 4      /** @brief Discarding bytes until a termination is found. */
+    } nextion_frame_parser_state_t;
+
+    /**
+     * @typedef nextion_frame_parser_t
+     * @brief Incremental parser of device frames (responses and events).
+     * @details Bytes can be fed as they arrive; a partial frame is kept
+     * between calls. Frames with a known length are read by length, so
+     * payload bytes equal to 0xFF are not taken as termination.
+     */
+    typedef struct
+    {
+        uint8_t frame[CONFIG_NEX_UART_RECV_FRAME_BUFFER_SIZE]; /** @brief Current frame, including its termination when complete. */
+        size_t length;                                         /** @brief Current frame length. */
+        size_t expected_length;                                /** @brief Frame length, when known by its code. */
+        size_t ends_found;                                     /** @brief How many consecutive termination bytes were found. */
+        size_t discarded;                                      /** @brief How many bytes were discarded due to corruption. */
+        nextion_frame_parser_state_t state;                    /** @brief Parser state. */
+        bool is_truncated;                                     /** @brief If the frame did not fit in the buffer. */
+    } nextion_frame_parser_t;
+
+    /**
+     * @brief Initialize or reset a parser, discarding any partial frame.
+     * @param[in] parser Parser pointer.
+     */
+    void nextion_frame_parser_reset(nextion_frame_parser_t *parser);
+
+    /**
+     * @brief Feed a byte into a parser.
+     * @param[in] parser Parser pointer.
+     * @param[in] byte Received byte.
+     * @return True if a frame was completed; it is available in "frame"
+     * and "length" until the next call.
+     */
+    bool nextion_frame_parser_feed(nextion_frame_parser_t *parser, uint8_t byte);
+
+    /**
+     * @brief Check if a parser is in the middle of a frame.
+     * @param[in] parser Parser pointer.
+     * @return True if a partial frame is kept, otherwise false.
+     */
+    bool nextion_frame_parser_is_busy(const nextion_frame_parser_t *parser);
+
+    /**
+     * @brief Get the length of a frame by its code.
+     * @param[in] code Frame code, its first byte.
+     * @return Frame length including termination, or 0 if it has variable length.
+     */
+    size_t nextion_frame_parser_length_by_code(uint8_t code);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,71 @@
+#ifndef __ESP32_DRIVER_NEXTION_RING_H__
+#define __ESP32_DRIVER_NEXTION_RING_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Bytes of the slots of a ring holding "capacity" items of "item_size" bytes.
+ */
+#define NEX_RING_SLOTS_SIZE(item_size, capacity) ((item_size) * ((capacity) + 1U))
+
+    /**
+     * @typedef nextion_ring_t
+     * @brief Lock-free ring of fixed size items, with a single producer and a single consumer.
+     * @details The producer only writes "head" and the consumer only writes "tail";
+     * one slot is always kept empty to tell a full ring from an empty one.
+     */
+    typedef struct
+    {
+        uint8_t *slots;     /** @brief Ring slots; NEX_RING_SLOTS_SIZE bytes. */
+        size_t item_size;   /** @brief Bytes of an item. */
+        size_t slot_count;  /** @brief How many slots there are; the capacity plus one. */
+        atomic_size_t head; /** @brief Next slot to be written. */
+        atomic_size_t tail; /** @brief Next slot to be read. */
+    } nextion_ring_t;
+
+    /**
+     * @brief Initialize an empty ring.
+     * @param[in] ring Ring pointer.
+     * @param[in] slots Ring slots, of NEX_RING_SLOTS_SIZE(item_size, capacity) bytes; owned by the caller.
+     * @param[in] item_size Bytes of an item.
+     * @param[in] capacity How many items it holds.
+     */
+    void nextion_ring_init(nextion_ring_t *ring, void *slots, size_t item_size, size_t capacity);
+
+    /**
+     * @brief Add items; those that do not fit are left out. Called only by the producer.
+     * @param[in] ring Ring pointer.
+     * @param[in] items Items.
+     * @param[in] count How many items there are.
+     * @return How many items were added, from the first.
+     */
+    size_t nextion_ring_push(nextion_ring_t *ring, const void *items, size_t count);
+
+    /**
+     * @brief Get how many items can be removed. Called only by the consumer.
+     * @param[in] ring Ring pointer.
+     * @return How many items there are.
+     */
+    size_t nextion_ring_count(nextion_ring_t *ring);
+
+    /**
+     * @brief Remove the oldest items. Called only by the consumer.
+     * @param[in] ring Ring pointer.
+     * @param[out] items Location where the items will be stored; NULL discards them.
+     * @param[in] count Most items to be removed.
+     * @return How many items were removed.
+     */
+    size_t nextion_ring_pop(nextion_ring_t *ring, void *items, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,144 @@
+#ifndef __ESP32_DRIVER_NEXTION_TRANSPORT_STATS_H__
+#define __ESP32_DRIVER_NEXTION_TRANSPORT_STATS_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+#include "esp32_driver_nextion/base/types.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @typedef nextion_transport_stats_t
+     * @brief Transport counters, updated by the UART task and the callers.
+     */
+    typedef struct
+    {
+        nextion_stats_t counters; /** @brief Counters. */
+        portMUX_TYPE lock;        /** @brief Lock used for counter control. */
+    } nextion_transport_stats_t;
+
+    /**
+     * @brief Initialize the counters, zeroed.
+     * @param[in] stats Stats pointer.
+     */
+    void nextion_transport_stats_init(nextion_transport_stats_t *stats);
+
+    /**
+     * @brief Zero the counters.
+     * @param[in] stats Stats pointer.
+     */
+    void nextion_transport_stats_reset(nextion_transport_stats_t *stats);
+
+    /**
+     * @brief Get a copy of the counters.
+     * @param[in] stats Stats pointer.
+     * @param[out] counters Location where the counters will be stored.
+     */
+    void nextion_transport_stats_get(nextion_transport_stats_t *stats, nextion_stats_t *counters);
+
+    /**
+     * @brief Count written commands.
+     * @param[in] stats Stats pointer.
+     * @param[in] count How many commands were written.
+     */
+    void nextion_transport_stats_on_commands(nextion_transport_stats_t *stats, size_t count);
+
+    /**
+     * @brief Count written bytes.
+     * @param[in] stats Stats pointer.
+     * @param[in] length How many bytes were written.
+     */
+    void nextion_transport_stats_on_write(nextion_transport_stats_t *stats, size_t length);
+
+    /**
+     * @brief Count read bytes.
+     * @param[in] stats Stats pointer.
+     * @param[in] length How many bytes were read.
+     */
+    void nextion_transport_stats_on_read(nextion_transport_stats_t *stats, size_t length);
+
+    /**
+     * @brief Count a simple response (ACK) matched to a command.
+     * @param[in] stats Stats pointer.
+     * @param[in] code Response code.
+     * @param[in] latency_us Time since the command was queued.
+     */
+    void nextion_transport_stats_on_ack(nextion_transport_stats_t *stats, uint8_t code, uint32_t latency_us);
+
+    /**
+     * @brief Count a response carrying data matched to a command.
+     * @param[in] stats Stats pointer.
+     * @param[in] latency_us Time since the command was queued.
+     */
+    void nextion_transport_stats_on_data(nextion_transport_stats_t *stats, uint32_t latency_us);
+
+    /**
+     * @brief Count a response received while no command was waiting.
+     * @param[in] stats Stats pointer.
+     */
+    void nextion_transport_stats_on_unexpected(nextion_transport_stats_t *stats);
+
+    /**
+     * @brief Count a command completed with NEX_TIMEOUT.
+     * @param[in] stats Stats pointer.
+     */
+    void nextion_transport_stats_on_timeout(nextion_transport_stats_t *stats);
+
+    /**
+     * @brief Count an event received while a command was waiting for its response.
+     * @param[in] stats Stats pointer.
+     */
+    void nextion_transport_stats_on_event_parsed(nextion_transport_stats_t *stats);
+
+    /**
+     * @brief Count an event handed to the callbacks.
+     * @param[in] stats Stats pointer.
+     * @param[in] type Event type.
+     */
+    void nextion_transport_stats_on_event_dispatched(nextion_transport_stats_t *stats, nextion_stats_event_type_t type);
+
+    /**
+     * @brief Count a UART overflow; UART_FIFO_OVF or UART_BUFFER_FULL.
+     * @param[in] stats Stats pointer.
+     * @param[in] is_fifo If it was the hardware FIFO; otherwise the ring buffer.
+     */
+    void nextion_transport_stats_on_overflow(nextion_transport_stats_t *stats, bool is_fifo);
+
+    /**
+     * @brief Count received bytes discarded by a flush.
+     * @param[in] stats Stats pointer.
+     * @param[in] length How many bytes were discarded.
+     */
+    void nextion_transport_stats_on_flush(nextion_transport_stats_t *stats, size_t length);
+
+    /**
+     * @brief Count received bytes discarded by the frame parser.
+     * @param[in] stats Stats pointer.
+     * @param[in] length How many bytes were discarded.
+     */
+    void nextion_transport_stats_on_discard(nextion_transport_stats_t *stats, size_t length);
+
+    /**
+     * @brief Count a command mutex acquisition.
+     * @param[in] stats Stats pointer.
+     * @param[in] wait_us Time waited.
+     * @param[in] is_acquired If it was acquired; otherwise it timed out.
+     */
+    void nextion_transport_stats_on_sync(nextion_transport_stats_t *stats, uint32_t wait_us, bool is_acquired);
+
+    /**
+     * @brief Add a value to a histogram.
+     * @param[in] histogram Histogram pointer.
+     * @param[in] value_us Value, in microseconds.
+     */
+    void nextion_stats_histogram_add(nextion_stats_histogram_t *histogram, uint32_t value_us);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
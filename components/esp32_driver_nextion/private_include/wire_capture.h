@@ -0,0 +1,112 @@
+#ifndef __ESP32_DRIVER_NEXTION_WIRE_CAPTURE_H__
+#define __ESP32_DRIVER_NEXTION_WIRE_CAPTURE_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+#include "config.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Bytes a record header takes: a 64 bits timestamp, then the length and direction in 16 bits.
+ */
+#define NEX_WIRE_CAPTURE_HEADER_LENGTH 10U
+
+/**
+ * @brief Longest run of bytes a single record holds; longer runs take several records.
+ */
+#define NEX_WIRE_CAPTURE_MAX_RUN_LENGTH 0x7FFFU
+
+/**
+ * @brief Longest piece of a record handed to a visitor.
+ */
+#define NEX_WIRE_CAPTURE_VISIT_LENGTH 32U
+
+    /**
+     * @typedef nextion_wire_capture_direction_t
+     * @brief Which way captured bytes went.
+     */
+    typedef enum
+    {
+        NEX_WIRE_CAPTURE_TX = 0, /** @brief Written to the display. */
+        NEX_WIRE_CAPTURE_RX = 1  /** @brief Read from the display. */
+    } nextion_wire_capture_direction_t;
+
+    /**
+     * @typedef nextion_wire_capture_visitor_t
+     * @brief Receives the captured records, from the oldest.
+     * @details Records longer than NEX_WIRE_CAPTURE_VISIT_LENGTH are handed in pieces with the same timestamp.
+     * @param context Visitor context.
+     * @param direction Which way the bytes went.
+     * @param timestamp_us When the bytes were written or read, in microseconds since boot.
+     * @param bytes Captured bytes.
+     * @param length How many bytes there are.
+     */
+    typedef void (*nextion_wire_capture_visitor_t)(void *context,
+                                                   nextion_wire_capture_direction_t direction,
+                                                   int64_t timestamp_us,
+                                                   const uint8_t *bytes,
+                                                   size_t length);
+
+    /**
+     * @typedef nextion_wire_capture_t
+     * @brief Fixed size ring of timestamped byte runs; the oldest are overwritten when it is full.
+     */
+    typedef struct
+    {
+        uint8_t buffer[CONFIG_NEX_WIRE_CAPTURE_SIZE > 0 ? CONFIG_NEX_WIRE_CAPTURE_SIZE : 1]; /** @brief Serialized records. */
+        size_t head;                                                                         /** @brief Offset of the oldest record. */
+        size_t used;                                                                         /** @brief How many bytes the records take. */
+        uint32_t records;                                                                    /** @brief How many records are kept. */
+        uint32_t overwritten;                                                                /** @brief How many records were overwritten to make room. */
+        uint32_t skipped;                                                                    /** @brief How many runs were not captured because the ring was being read. */
+        bool is_reading;                                                                     /** @brief If the ring is being read; nothing is captured meanwhile. */
+        portMUX_TYPE lock;                                                                   /** @brief Lock used for ring control. */
+    } nextion_wire_capture_t;
+
+    /**
+     * @brief Initialize an empty ring.
+     * @param[in] capture Ring pointer.
+     */
+    void nextion_wire_capture_init(nextion_wire_capture_t *capture);
+
+    /**
+     * @brief Discard every record and zero the counters.
+     * @param[in] capture Ring pointer.
+     */
+    void nextion_wire_capture_clear(nextion_wire_capture_t *capture);
+
+    /**
+     * @brief Add a run of bytes. Does nothing when the capture is disabled.
+     * @param[in] capture Ring pointer.
+     * @param[in] direction Which way the bytes went.
+     * @param[in] timestamp_us When the bytes were written or read.
+     * @param[in] bytes Bytes.
+     * @param[in] length How many bytes there are.
+     */
+    void nextion_wire_capture_record(nextion_wire_capture_t *capture,
+                                     nextion_wire_capture_direction_t direction,
+                                     int64_t timestamp_us,
+                                     const uint8_t *bytes,
+                                     size_t length);
+
+    /**
+     * @brief Hand every record to a visitor, from the oldest.
+     * @details Runs arriving meanwhile are not captured, so the visitor
+     * can take its time; they are counted in "skipped".
+     * @param[in] capture Ring pointer.
+     * @param[in] visitor Visitor.
+     * @param[in] context Visitor context.
+     * @return How many records were visited.
+     */
+    size_t nextion_wire_capture_read(nextion_wire_capture_t *capture, nextion_wire_capture_visitor_t visitor, void *context);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,496 @@
+#include <stdlib.h>
+#include <stdatomic.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_timer.h"
+#include "esp32_driver_nextion/nextion.h"
+#include "esp32_driver_nextion/animation.h"
+#include "assertion.h"
+#include "config.h"
+#include "command_builder.h"
+#include "command_send.h"
+
+/**
+ * @brief Share of the link the frames are planned to take, in percent.
+ * The rest is left to the other commands.
+ */
+#define NEX_ANIMATION_LINK_LOAD_PERCENT 50U
+
+/**
+ * @brief Bytes of a frame besides its command: termination and simple response.
+ */
+#define NEX_ANIMATION_COMMAND_OVERHEAD 7U
+
+/**
+ * @brief How many arguments the frame command takes.
+ */
+#define NEX_ANIMATION_COMMAND_ARGUMENTS 7
+
+/**
+ * @brief Longest frame command: "xpic ", each argument with its separator and a null-terminator.
+ */
+#define NEX_ANIMATION_COMMAND_MAX_LENGTH (5 + NEX_ANIMATION_COMMAND_ARGUMENTS * 12 + 1)
+
+struct nextion_animation_t
+{
+    nextion_t *handle;                           /*!< Driver the frames are sent through. */
+    nextion_animation_config_t config;           /*!< Configuration. */
+    int32_t shown;                               /*!< Frame on the screen; -1 when unknown. */
+    int32_t last_due;                            /*!< Frame due on the previous tick; -1 before the first. */
+    int64_t credit;                              /*!< Bytes that can be sent now. */
+    bool is_waiting;                             /*!< If a frame waits for its response. */
+    bool is_certain;                             /*!< If its response will surely arrive; not so when sending failed. */
+    TickType_t wait_deadline;                    /*!< When an uncertain response is given up on. */
+    int32_t waiting;                             /*!< Frame waiting for its response. */
+    uint32_t seen_generation;                    /*!< Generation the task last played. */
+    atomic_bool is_running;                      /*!< If the task keeps going; cleared to stop it. */
+    atomic_bool is_playing;                      /*!< If frames are sent. */
+    atomic_uint_least32_t generation;            /*!< Incremented by every start. */
+    _Atomic int64_t started_us;                  /*!< When the first frame was due. */
+    atomic_int response_code;                    /*!< Response of the last frame; written before "responded" is given. */
+    TaskHandle_t task;                           /*!< Task that sends the frames. */
+    SemaphoreHandle_t responded;                 /*!< Given when a frame receives its response. */
+    SemaphoreHandle_t stopped;                   /*!< Given by the task when it is about to exit. */
+    atomic_uint_least32_t frames_sent;           /*!< See nextion_animation_stats_t. */
+    atomic_uint_least32_t frames_dropped_busy;   /*!< See nextion_animation_stats_t. */
+    atomic_uint_least32_t frames_dropped_budget; /*!< See nextion_animation_stats_t. */
+    atomic_uint_least32_t frames_failed;         /*!< See nextion_animation_stats_t. */
+    atomic_uint_least32_t bytes_per_period;      /*!< See nextion_animation_stats_t. */
+};
+
+static void nextion_animation_task(void *pvParameters);
+static void nextion_animation_tick(nextion_animation_t *animation);
+static bool nextion_animation_collect(nextion_animation_t *animation, TickType_t wait);
+static int32_t nextion_animation_due(nextion_animation_t *animation);
+static uint32_t nextion_animation_budget(nextion_animation_t *animation);
+static bool nextion_animation_send(nextion_animation_t *animation, int32_t frame, uint32_t budget);
+static void nextion_animation_on_response(nextion_t *handle, nex_err_t code, void *context);
+static void nextion_animation_free(nextion_animation_t *animation);
+
+nextion_animation_t *nextion_animation_create(nextion_t *handle, const nextion_animation_config_t *config)
+{
+    CMP_CHECK_HANDLE(handle, NULL)
+    CMP_CHECK((config != NULL), "config error(NULL)", NULL)
+    CMP_CHECK((config->frame_width > 0 && config->frame_height > 0), "frame size error(0)", NULL)
+    CMP_CHECK((config->columns > 0), "columns error(<1)", NULL)
+    CMP_CHECK((config->frame_count > 0), "frame_count error(<1)", NULL)
+    CMP_CHECK((config->frame_period_ms > 0), "frame_period_ms error(<1)", NULL)
+
+    nextion_animation_t *animation = (nextion_animation_t *)calloc(1, sizeof(nextion_animation_t));
+
+    CMP_CHECK((animation != NULL), "animation error(no memory)", NULL)
+
+    animation->handle = handle;
+    animation->config = *config;
+    animation->shown = -1;
+    animation->last_due = -1;
+
+    atomic_init(&animation->is_running, true);
+    atomic_init(&animation->is_playing, false);
+
+    animation->responded = xSemaphoreCreateBinary();
+    animation->stopped = xSemaphoreCreateBinary();
+
+    if (animation->responded == NULL || animation->stopped == NULL)
+    {
+        CMP_LOGE("failed creating animation semaphores");
+
+        nextion_animation_free(animation);
+
+        return NULL;
+    }
+
+    if (xTaskCreate(&nextion_animation_task,
+                    "nextion_anim",
+                    CONFIG_NEX_ANIMATION_TASK_STACK_SIZE,
+                    (void *)animation,
+                    CONFIG_NEX_ANIMATION_TASK_PRIORITY,
+                    &animation->task) != pdPASS)
+    {
+        CMP_LOGE("failed creating animation task");
+
+        nextion_animation_free(animation);
+
+        return NULL;
+    }
+
+    return animation;
+}
+
+bool nextion_animation_delete(nextion_animation_t *animation)
+{
+    CMP_CHECK((animation != NULL), "animation error(NULL)", false)
+
+    // The task is not deleted from here: a response could still call back into it.
+    atomic_store(&animation->is_running, false);
+
+    xTaskNotifyGive(animation->task);
+    xSemaphoreTake(animation->stopped, portMAX_DELAY);
+
+    nextion_animation_free(animation);
+
+    return true;
+}
+
+nex_err_t nextion_animation_start(nextion_animation_t *animation)
+{
+    CMP_CHECK((animation != NULL), "animation error(NULL)", NEX_FAIL)
+
+    atomic_store(&animation->started_us, esp_timer_get_time());
+    atomic_fetch_add(&animation->generation, 1);
+    atomic_store(&animation->is_playing, true);
+
+    xTaskNotifyGive(animation->task);
+
+    return NEX_OK;
+}
+
+nex_err_t nextion_animation_stop(nextion_animation_t *animation)
+{
+    CMP_CHECK((animation != NULL), "animation error(NULL)", NEX_FAIL)
+
+    atomic_store(&animation->is_playing, false);
+
+    return NEX_OK;
+}
+
+bool nextion_animation_is_playing(nextion_animation_t *animation)
+{
+    CMP_CHECK((animation != NULL), "animation error(NULL)", false)
+
+    return atomic_load(&animation->is_playing);
+}
+
+bool nextion_animation_stats_get(nextion_animation_t *animation, nextion_animation_stats_t *stats)
+{
+    CMP_CHECK((animation != NULL), "animation error(NULL)", false)
+    CMP_CHECK((stats != NULL), "stats error(NULL)", false)
+
+    stats->frames_sent = atomic_load_explicit(&animation->frames_sent, memory_order_relaxed);
+    stats->frames_dropped_busy = atomic_load_explicit(&animation->frames_dropped_busy, memory_order_relaxed);
+    stats->frames_dropped_budget = atomic_load_explicit(&animation->frames_dropped_budget, memory_order_relaxed);
+    stats->frames_failed = atomic_load_explicit(&animation->frames_failed, memory_order_relaxed);
+    stats->bytes_per_period = atomic_load_explicit(&animation->bytes_per_period, memory_order_relaxed);
+
+    return true;
+}
+
+/**
+ * @brief Send the due frame every frame period while playing, until stopped.
+ * @param pvParameters Animation pointer.
+ */
+static void nextion_animation_task(void *pvParameters)
+{
+    nextion_animation_t *animation = (nextion_animation_t *)pvParameters;
+    const TickType_t period = pdMS_TO_TICKS(animation->config.frame_period_ms) > 0 ? pdMS_TO_TICKS(animation->config.frame_period_ms) : 1;
+    TickType_t next_wake = xTaskGetTickCount();
+
+    for (;;)
+    {
+        TickType_t now = xTaskGetTickCount();
+
+        if (!atomic_load(&animation->is_playing))
+        {
+            // Woken to start or to stop.
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+            next_wake = xTaskGetTickCount();
+        }
+        else if ((int32_t)(next_wake - now) > 0)
+        {
+            ulTaskNotifyTake(pdTRUE, next_wake - now);
+        }
+
+        if (!atomic_load(&animation->is_running))
+        {
+            break;
+        }
+
+        now = xTaskGetTickCount();
+
+        if ((int32_t)(next_wake - now) > 0 || !atomic_load(&animation->is_playing))
+        {
+            continue;
+        }
+
+        // A late tick is not made up for: frames follow the clock.
+        next_wake = (int32_t)(now - next_wake) >= (int32_t)period ? now + period : next_wake + period;
+
+        nextion_animation_tick(animation);
+    }
+
+    // The response would call back into freed memory.
+    if (animation->is_waiting)
+    {
+        TickType_t now = xTaskGetTickCount();
+        TickType_t wait = portMAX_DELAY;
+
+        if (!animation->is_certain)
+        {
+            wait = (int32_t)(animation->wait_deadline - now) > 0 ? animation->wait_deadline - now : 0;
+        }
+
+        nextion_animation_collect(animation, wait);
+    }
+
+    xSemaphoreGive(animation->stopped);
+
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief Send the due frame when the previous one was answered and the budget allows it.
+ * @param animation Animation pointer.
+ */
+static void nextion_animation_tick(nextion_animation_t *animation)
+{
+    uint32_t generation = atomic_load(&animation->generation);
+
+    // Started over: the first frame is sent whatever is on the screen.
+    if (generation != animation->seen_generation)
+    {
+        animation->seen_generation = generation;
+        animation->shown = -1;
+        animation->last_due = -1;
+    }
+
+    const uint32_t budget = nextion_animation_budget(animation);
+    const int32_t due = nextion_animation_due(animation);
+    const bool is_new = due != animation->last_due;
+
+    animation->last_due = due;
+
+    nextion_animation_collect(animation, 0);
+
+    if (due == animation->shown && !animation->is_waiting)
+    {
+        if (!animation->config.is_looping && due == animation->config.frame_count - 1)
+        {
+            atomic_store(&animation->is_playing, false);
+        }
+
+        return;
+    }
+
+    if (animation->is_waiting)
+    {
+        if (is_new && due != animation->waiting)
+        {
+            atomic_fetch_add_explicit(&animation->frames_dropped_busy, 1, memory_order_relaxed);
+        }
+
+        return;
+    }
+
+    if (!nextion_animation_send(animation, due, budget) && is_new)
+    {
+        atomic_fetch_add_explicit(&animation->frames_dropped_budget, 1, memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Take the response of the frame waiting for it.
+ * @param animation Animation pointer.
+ * @param wait How long to wait for it.
+ * @return True if there is no frame waiting anymore, otherwise false.
+ */
+static bool nextion_animation_collect(nextion_animation_t *animation, TickType_t wait)
+{
+    if (!animation->is_waiting)
+    {
+        return true;
+    }
+
+    if (xSemaphoreTake(animation->responded, wait) == pdTRUE)
+    {
+        animation->is_waiting = false;
+
+        if (atomic_load(&animation->response_code) == NEX_OK)
+        {
+            animation->shown = animation->waiting;
+        }
+        else
+        {
+            // Sent again, whatever is on the screen.
+            animation->shown = -1;
+
+            // Not sending was counted already.
+            if (animation->is_certain)
+            {
+                atomic_fetch_add_explicit(&animation->frames_failed, 1, memory_order_relaxed);
+            }
+        }
+
+        return true;
+    }
+
+    // A command that was never queued is never answered.
+    if (!animation->is_certain && (int32_t)(xTaskGetTickCount() - animation->wait_deadline) >= 0)
+    {
+        animation->is_waiting = false;
+        animation->shown = -1;
+
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Get the frame due now.
+ * @param animation Animation pointer.
+ * @return Frame index; the last one once a non-looping animation is over.
+ */
+static int32_t nextion_animation_due(nextion_animation_t *animation)
+{
+    const int64_t elapsed_us = esp_timer_get_time() - atomic_load(&animation->started_us);
+    const int64_t period_us = (int64_t)animation->config.frame_period_ms * 1000;
+    int64_t frame = elapsed_us > 0 ? elapsed_us / period_us : 0;
+
+    if (animation->config.is_looping)
+    {
+        return (int32_t)(frame % animation->config.frame_count);
+    }
+
+    return frame < animation->config.frame_count ? (int32_t)frame : animation->config.frame_count - 1;
+}
+
+/**
+ * @brief Add the bytes of a frame period to the credit.
+ * @details The credit holds at most a period, or a frame when it takes longer:
+ * frames dropped on a busy link are not made up for with a burst.
+ * @param animation Animation pointer.
+ * @return Bytes of a frame period.
+ */
+static uint32_t nextion_animation_budget(nextion_animation_t *animation)
+{
+    nextion_link_info_t info = {0};
+
+    nextion_link_get_info(animation->handle, &info);
+
+    // Ten bits per byte when not measured yet.
+    const uint64_t rate = info.throughput > 0 ? info.throughput : info.baud_rate / 10U;
+    const uint32_t budget = (uint32_t)(rate * animation->config.frame_period_ms * NEX_ANIMATION_LINK_LOAD_PERCENT / 100000U);
+
+    animation->credit += budget;
+
+    atomic_store_explicit(&animation->bytes_per_period, budget, memory_order_relaxed);
+
+    return budget;
+}
+
+/**
+ * @brief Send a frame if the credit holds its bytes.
+ * @param animation Animation pointer.
+ * @param frame Frame index.
+ * @param budget Bytes of a frame period.
+ * @return True if it was sent or failed, false if it did not fit.
+ */
+static bool nextion_animation_send(nextion_animation_t *animation, int32_t frame, uint32_t budget)
+{
+    const nextion_animation_config_t *config = &animation->config;
+    // Same command as "nextion_draw_crop_picture", sent without waiting.
+    const int32_t arguments[NEX_ANIMATION_COMMAND_ARGUMENTS] = {
+        config->origin.x + (frame % config->columns) * config->frame_width,
+        config->origin.y + (frame / config->columns) * config->frame_height,
+        config->frame_width,
+        config->frame_height,
+        config->destination.x,
+        config->destination.y,
+        config->picture_id};
+    char command[NEX_ANIMATION_COMMAND_MAX_LENGTH];
+    nextion_command_builder_t builder;
+
+    nextion_command_builder_init(&builder, command, sizeof(command), 0, NULL, NULL);
+    nextion_command_builder_append_identifier(&builder, "xpic ");
+
+    for (int i = 0; i < NEX_ANIMATION_COMMAND_ARGUMENTS; i++)
+    {
+        if (i > 0)
+        {
+            nextion_command_builder_append_char(&builder, ',');
+        }
+
+        nextion_command_builder_append_int(&builder, arguments[i]);
+    }
+
+    const size_t length = builder.length;
+
+    nextion_command_builder_append_char(&builder, '\0');
+
+    const int64_t cost = length + NEX_ANIMATION_COMMAND_OVERHEAD;
+    const int64_t limit = cost > budget ? cost : budget;
+
+    if (animation->credit > limit)
+    {
+        animation->credit = limit;
+    }
+
+    if (animation->credit < cost)
+    {
+        return false;
+    }
+
+    animation->credit -= cost;
+
+    nex_err_t code = nextion_command_send_built_async(animation->handle,
+                                                      &nextion_animation_on_response,
+                                                      animation,
+                                                      command);
+
+    animation->is_waiting = true;
+    animation->is_certain = code == NEX_OK;
+    animation->waiting = frame;
+
+    if (code == NEX_OK)
+    {
+        atomic_fetch_add_explicit(&animation->frames_sent, 1, memory_order_relaxed);
+    }
+    else
+    {
+        // It can still be answered, with the failure.
+        animation->wait_deadline = xTaskGetTickCount() + pdMS_TO_TICKS(2 * CONFIG_NEX_UART_RECV_WAIT_TIME_MS);
+
+        atomic_fetch_add_explicit(&animation->frames_failed, 1, memory_order_relaxed);
+
+        CMP_LOGW("frame %d not sent", frame);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Called from the UART task when a frame receives its response.
+ * @param handle Nextion context pointer.
+ * @param code Response.
+ * @param context Animation pointer.
+ */
+static void nextion_animation_on_response(nextion_t *handle, nex_err_t code, void *context)
+{
+    nextion_animation_t *animation = (nextion_animation_t *)context;
+
+    atomic_store(&animation->response_code, code);
+
+    // Last access: the animation can be freed right after.
+    xSemaphoreGive(animation->responded);
+}
+
+/**
+ * @brief Free the animation and its semaphores.
+ * @param animation Animation pointer.
+ */
+static void nextion_animation_free(nextion_animation_t *animation)
+{
+    if (animation->responded != NULL)
+    {
+        vSemaphoreDelete(animation->responded);
+    }
+
+    if (animation->stopped != NULL)
+    {
+        vSemaphoreDelete(animation->stopped);
+    }
+
+    free(animation);
+}
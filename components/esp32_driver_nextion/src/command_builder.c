@@ -0,0 +1,553 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "esp32_driver_nextion/base/constants.h"
+#include "command_builder.h"
+
+/**
+ * @brief Longest decimal representation of a 32-bit integer, without sign.
+ */
+#define NEX_COMMAND_BUILDER_DIGITS_MAX 10
+
+/**
+ * @brief Longest conversion specification handed to snprintf, "*" widths written out included.
+ */
+#define NEX_COMMAND_BUILDER_SPEC_MAX 40
+
+/**
+ * @brief Longest text a conversion handed to snprintf can produce.
+ */
+#define NEX_COMMAND_BUILDER_CONVERSION_MAX 64
+
+static bool nextion_command_builder_append_digits(nextion_command_builder_t *builder, uint32_t value);
+static const char *nextion_command_builder_append_conversion(nextion_command_builder_t *builder, const char *conversion, va_list *args);
+static bool nextion_command_builder_append_padded(nextion_command_builder_t *builder, const char *text, int width, int precision, bool is_left);
+static bool nextion_command_builder_spec_append_int(char *spec, size_t *length, int value);
+
+void nextion_command_builder_init(nextion_command_builder_t *builder,
+                                  char *buffer,
+                                  size_t capacity,
+                                  size_t length,
+                                  nextion_command_builder_flush_t flush,
+                                  void *context)
+{
+    builder->buffer = buffer;
+    builder->capacity = capacity;
+    builder->length = length;
+    builder->flush = flush;
+    builder->context = context;
+    builder->failed = false;
+}
+
+bool nextion_command_builder_append_char(nextion_command_builder_t *builder, char value)
+{
+    if (builder->failed)
+    {
+        return false;
+    }
+
+    if (builder->length == builder->capacity && (builder->flush == NULL || !nextion_command_builder_flush(builder)))
+    {
+        builder->failed = true;
+
+        return false;
+    }
+
+    builder->buffer[builder->length++] = value;
+
+    return true;
+}
+
+bool nextion_command_builder_append_identifier(nextion_command_builder_t *builder, const char *text)
+{
+    if (text == NULL)
+    {
+        builder->failed = true;
+
+        return false;
+    }
+
+    while (*text != '\0')
+    {
+        if (!nextion_command_builder_append_char(builder, *text++))
+        {
+            return false;
+        }
+    }
+
+    return !builder->failed;
+}
+
+bool nextion_command_builder_append_int(nextion_command_builder_t *builder, int32_t value)
+{
+    if (value < 0)
+    {
+        if (!nextion_command_builder_append_char(builder, '-'))
+        {
+            return false;
+        }
+
+        // Negating as unsigned also works for INT32_MIN.
+        return nextion_command_builder_append_digits(builder, 0U - (uint32_t)value);
+    }
+
+    return nextion_command_builder_append_digits(builder, (uint32_t)value);
+}
+
+bool nextion_command_builder_append_uint(nextion_command_builder_t *builder, uint32_t value)
+{
+    return nextion_command_builder_append_digits(builder, value);
+}
+
+bool nextion_command_builder_append_quoted(nextion_command_builder_t *builder, const char *text)
+{
+    if (text == NULL)
+    {
+        builder->failed = true;
+
+        return false;
+    }
+
+    nextion_command_builder_append_char(builder, '"');
+
+    for (; *text != '\0'; text++)
+    {
+        switch (*text)
+        {
+        case '\\':
+            // An escape sequence written by the caller goes as it is, so escaped text is not escaped twice.
+            nextion_command_builder_append_char(builder, '\\');
+
+            if (text[1] == '\0')
+            {
+                // A lone backslash would escape the closing quote.
+                nextion_command_builder_append_char(builder, '\\');
+            }
+            else
+            {
+                nextion_command_builder_append_char(builder, *++text);
+            }
+            break;
+        case '"':
+            nextion_command_builder_append_char(builder, '\\');
+            nextion_command_builder_append_char(builder, '"');
+            break;
+        case '\n':
+            nextion_command_builder_append_char(builder, '\\');
+            nextion_command_builder_append_char(builder, 'r');
+            break;
+        case '\r':
+            // A "\r\n" pair is a single line break.
+            if (text[1] != '\n')
+            {
+                nextion_command_builder_append_char(builder, '\\');
+                nextion_command_builder_append_char(builder, 'r');
+            }
+            break;
+        default:
+            nextion_command_builder_append_char(builder, *text);
+            break;
+        }
+    }
+
+    return nextion_command_builder_append_char(builder, '"');
+}
+
+bool nextion_command_builder_append_format(nextion_command_builder_t *builder, const char *format, va_list args)
+{
+    if (format == NULL)
+    {
+        builder->failed = true;
+
+        return false;
+    }
+
+    va_list list;
+
+    // A copy can be passed on by pointer; a "va_list" parameter cannot on every ABI.
+    va_copy(list, args);
+
+    for (const char *c = format; *c != '\0' && !builder->failed; c++)
+    {
+        // A string argument between double quotes is a string literal.
+        if (c[0] == '"' && c[1] == '%' && c[2] == 's' && c[3] == '"')
+        {
+            nextion_command_builder_append_quoted(builder, va_arg(list, const char *));
+
+            c += 3;
+            continue;
+        }
+
+        if (*c != '%')
+        {
+            nextion_command_builder_append_char(builder, *c);
+            continue;
+        }
+
+        const char *conversion = c + 1;
+        bool is_long = *conversion == 'l';
+
+        if (is_long)
+        {
+            conversion++;
+        }
+
+        // The usual conversions skip snprintf; anything else is handed to it.
+        switch (*conversion)
+        {
+        case 's':
+            nextion_command_builder_append_identifier(builder, va_arg(list, const char *));
+            break;
+        case 'd':
+        case 'i':
+            nextion_command_builder_append_int(builder, is_long ? (int32_t)va_arg(list, long) : (int32_t)va_arg(list, int));
+            break;
+        case 'u':
+            nextion_command_builder_append_uint(builder, is_long ? (uint32_t)va_arg(list, unsigned long) : (uint32_t)va_arg(list, unsigned int));
+            break;
+        case 'c':
+            nextion_command_builder_append_char(builder, (char)va_arg(list, int));
+            break;
+        case '%':
+            nextion_command_builder_append_char(builder, '%');
+            break;
+        default:
+            conversion = nextion_command_builder_append_conversion(builder, c, &list);
+            break;
+        }
+
+        if (conversion == NULL || *conversion == '\0')
+        {
+            break;
+        }
+
+        c = conversion;
+    }
+
+    va_end(list);
+
+    return !builder->failed;
+}
+
+bool nextion_command_builder_append_end(nextion_command_builder_t *builder)
+{
+    for (size_t i = 0; i < NEX_DVC_CMD_END_LENGTH; i++)
+    {
+        nextion_command_builder_append_char(builder, (char)NEX_DVC_CMD_END_VALUE);
+    }
+
+    return !builder->failed;
+}
+
+bool nextion_command_builder_flush(nextion_command_builder_t *builder)
+{
+    if (builder->length == 0)
+    {
+        return true;
+    }
+
+    if (builder->flush == NULL || !builder->flush(builder->context, builder->buffer, builder->length))
+    {
+        builder->failed = true;
+
+        return false;
+    }
+
+    builder->length = 0;
+
+    return true;
+}
+
+/**
+ * @brief Append an integer in decimal, without locale or format parsing.
+ * @param builder Builder pointer.
+ * @param value Integer.
+ * @return True if success, otherwise false.
+ */
+static bool nextion_command_builder_append_digits(nextion_command_builder_t *builder, uint32_t value)
+{
+    char digits[NEX_COMMAND_BUILDER_DIGITS_MAX];
+    size_t count = 0;
+
+    do
+    {
+        digits[count++] = (char)('0' + value % 10U);
+        value /= 10U;
+    } while (value > 0);
+
+    while (count > 0)
+    {
+        nextion_command_builder_append_char(builder, digits[--count]);
+    }
+
+    return !builder->failed;
+}
+
+/**
+ * @brief Append any other printf conversion, through snprintf.
+ * @details Flags, widths, precisions and length modifiers are understood; "%n" is not.
+ * @param builder Builder pointer.
+ * @param conversion Conversion specification, from its "%".
+ * @param args Format arguments.
+ * @return Pointer to the conversion character, or NULL if it failed; then
+ * the builder failed too, since the following arguments cannot be found.
+ */
+static const char *nextion_command_builder_append_conversion(nextion_command_builder_t *builder, const char *conversion, va_list *args)
+{
+    char spec[NEX_COMMAND_BUILDER_SPEC_MAX];
+    char piece[NEX_COMMAND_BUILDER_CONVERSION_MAX];
+    size_t length = 0;
+    const char *c = conversion + 1;
+    int width = 0;
+    int precision = -1;
+    bool is_left = false;
+
+    spec[length++] = '%';
+
+    for (; *c != '\0' && strchr("-+ #0", *c) != NULL && length < sizeof(spec); c++)
+    {
+        is_left = is_left || *c == '-';
+        spec[length++] = *c;
+    }
+
+    if (*c == '*')
+    {
+        width = va_arg(*args, int);
+
+        // A negative width is a "-" flag.
+        is_left = is_left || width < 0;
+        width = width < 0 ? -width : width;
+
+        if (!nextion_command_builder_spec_append_int(spec, &length, width))
+        {
+            builder->failed = true;
+
+            return NULL;
+        }
+
+        c++;
+    }
+    else
+    {
+        for (; *c >= '0' && *c <= '9' && length < sizeof(spec); c++)
+        {
+            width = width * 10 + (*c - '0');
+            spec[length++] = *c;
+        }
+    }
+
+    if (*c == '.' && length < sizeof(spec))
+    {
+        spec[length++] = *c++;
+        precision = 0;
+
+        if (*c == '*')
+        {
+            precision = va_arg(*args, int);
+
+            // A negative precision is taken as if omitted.
+            if (precision < 0)
+            {
+                precision = -1;
+                length--;
+            }
+            else if (!nextion_command_builder_spec_append_int(spec, &length, precision))
+            {
+                builder->failed = true;
+
+                return NULL;
+            }
+
+            c++;
+        }
+        else
+        {
+            for (; *c >= '0' && *c <= '9' && length < sizeof(spec); c++)
+            {
+                precision = precision * 10 + (*c - '0');
+                spec[length++] = *c;
+            }
+        }
+    }
+
+    const char *modifier = c;
+
+    for (; *c != '\0' && strchr("hljztL", *c) != NULL && length < sizeof(spec); c++)
+    {
+        spec[length++] = *c;
+    }
+
+    const size_t modifier_length = (size_t)(c - modifier);
+
+    if (*c == '\0' || modifier_length > 2 || length + 2 > sizeof(spec))
+    {
+        builder->failed = true;
+
+        return NULL;
+    }
+
+    spec[length++] = *c;
+    spec[length] = '\0';
+
+    const char first = modifier_length > 0 ? modifier[0] : '\0';
+    const bool is_double = modifier_length == 2;
+    int printed;
+
+    switch (*c)
+    {
+    case 's':
+        // Texts can be longer than any piece; padded here instead.
+        return nextion_command_builder_append_padded(builder, va_arg(*args, const char *), width, precision, is_left) ? c : NULL;
+    case 'd':
+    case 'i':
+        if (first == 'l')
+        {
+            printed = is_double ? snprintf(piece, sizeof(piece), spec, va_arg(*args, long long)) : snprintf(piece, sizeof(piece), spec, va_arg(*args, long));
+        }
+        else if (first == 'j')
+        {
+            printed = snprintf(piece, sizeof(piece), spec, va_arg(*args, intmax_t));
+        }
+        else if (first == 'z')
+        {
+            printed = snprintf(piece, sizeof(piece), spec, va_arg(*args, size_t));
+        }
+        else if (first == 't')
+        {
+            printed = snprintf(piece, sizeof(piece), spec, va_arg(*args, ptrdiff_t));
+        }
+        else
+        {
+            // "h" and "hh" arguments are promoted to int.
+            printed = snprintf(piece, sizeof(piece), spec, va_arg(*args, int));
+        }
+        break;
+    case 'u':
+    case 'o':
+    case 'x':
+    case 'X':
+        if (first == 'l')
+        {
+            printed = is_double ? snprintf(piece, sizeof(piece), spec, va_arg(*args, unsigned long long)) : snprintf(piece, sizeof(piece), spec, va_arg(*args, unsigned long));
+        }
+        else if (first == 'j')
+        {
+            printed = snprintf(piece, sizeof(piece), spec, va_arg(*args, uintmax_t));
+        }
+        else if (first == 'z')
+        {
+            printed = snprintf(piece, sizeof(piece), spec, va_arg(*args, size_t));
+        }
+        else if (first == 't')
+        {
+            printed = snprintf(piece, sizeof(piece), spec, va_arg(*args, ptrdiff_t));
+        }
+        else
+        {
+            printed = snprintf(piece, sizeof(piece), spec, va_arg(*args, unsigned int));
+        }
+        break;
+    case 'c':
+        printed = snprintf(piece, sizeof(piece), spec, va_arg(*args, int));
+        break;
+    case 'p':
+        printed = snprintf(piece, sizeof(piece), spec, va_arg(*args, void *));
+        break;
+    case 'f':
+    case 'F':
+    case 'e':
+    case 'E':
+    case 'g':
+    case 'G':
+    case 'a':
+    case 'A':
+        printed = first == 'L' ? snprintf(piece, sizeof(piece), spec, va_arg(*args, long double)) : snprintf(piece, sizeof(piece), spec, va_arg(*args, double));
+        break;
+    default:
+        // Skipping an unknown conversion would misplace every following argument.
+        printed = -1;
+        break;
+    }
+
+    // A piece cut short would be sent as if it were whole.
+    if (printed < 0 || (size_t)printed >= sizeof(piece))
+    {
+        builder->failed = true;
+
+        return NULL;
+    }
+
+    for (int i = 0; i < printed; i++)
+    {
+        nextion_command_builder_append_char(builder, piece[i]);
+    }
+
+    return builder->failed ? NULL : c;
+}
+
+/**
+ * @brief Append a text as "%*.*s" would.
+ * @param builder Builder pointer.
+ * @param text Null-terminated text.
+ * @param width Least characters appended, padded with spaces.
+ * @param precision Most characters of the text appended; negative for all.
+ * @param is_left If the padding goes after the text.
+ * @return True if success, otherwise false.
+ */
+static bool nextion_command_builder_append_padded(nextion_command_builder_t *builder, const char *text, int width, int precision, bool is_left)
+{
+    if (text == NULL)
+    {
+        builder->failed = true;
+
+        return false;
+    }
+
+    size_t count = 0;
+
+    while (text[count] != '\0' && (precision < 0 || count < (size_t)precision))
+    {
+        count++;
+    }
+
+    size_t padding = (size_t)width > count ? (size_t)width - count : 0;
+
+    for (size_t i = 0; !is_left && i < padding; i++)
+    {
+        nextion_command_builder_append_char(builder, ' ');
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        nextion_command_builder_append_char(builder, text[i]);
+    }
+
+    for (size_t i = 0; is_left && i < padding; i++)
+    {
+        nextion_command_builder_append_char(builder, ' ');
+    }
+
+    return !builder->failed;
+}
+
+/**
+ * @brief Write a "*" width or precision into a conversion specification.
+ * @param spec Conversion specification.
+ * @param length How many characters it holds; updated.
+ * @param value Width or precision; not negative.
+ * @return True if success, false if it does not fit.
+ */
+static bool nextion_command_builder_spec_append_int(char *spec, size_t *length, int value)
+{
+    int written = snprintf(spec + *length, NEX_COMMAND_BUILDER_SPEC_MAX - *length, "%d", value);
+
+    if (written < 0 || (size_t)written >= NEX_COMMAND_BUILDER_SPEC_MAX - *length)
+    {
+        return false;
+    }
+
+    *length += (size_t)written;
+
+    return true;
+}
@@ -1,7 +1,29 @@
+#include <string.h>
 #include "esp32_driver_nextion/nextion.h"
 #include "esp32_driver_nextion/system.h"
 #include "esp32_driver_nextion/component.h"
 #include "assertion.h"
+#include "component_cache.h"
+#include "command_builder.h"
+#include "command_send.h"
+
+/**
+ * @brief Longest "get" command: "get " + reference + "." + property + null-terminator.
+ */
+#define NEX_COMPONENT_GET_COMMAND_MAX_LENGTH (10 + NEX_DVC_REFERENCE_MAX_LENGTH)
+
+/**
+ * @brief Longest "set" command built on the stack: a "get" command with
+ * room for a value. Longer texts are formatted as they are written.
+ */
+#define NEX_COMPONENT_SET_COMMAND_MAX_LENGTH (NEX_COMPONENT_GET_COMMAND_MAX_LENGTH + 64)
+
+static nex_err_t nextion_component_visibility_apply(nextion_t *handle, const char *key, const char *reference, bool is_visible);
+static nex_err_t nextion_component_text_apply(nextion_t *handle, const char *key, const char *reference, const char *property_name, const char *text);
+static nex_err_t nextion_component_number_apply(nextion_t *handle, const char *key, const char *reference, const char *property_name, int32_t number);
+static const char *nextion_component_key(const nextion_component_t *component);
+static void nextion_component_build_set(nextion_command_builder_t *builder, const char *reference, const char *property_name);
+static bool nextion_component_build_get(char *command, size_t capacity, const char *component_name, const char *property_name);
 
 nex_err_t nextion_component_refresh(nextion_t *handle, const char *component_name_or_id)
 {
@@ -16,13 +38,16 @@ nex_err_t nextion_component_set_visibility(nextion_t *handle, const char *compon
     CMP_CHECK_HANDLE(handle, NEX_FAIL)
     CMP_CHECK((component_name_or_id != NULL), "component_name_or_id error(NULL)", NEX_FAIL)
 
-    return nextion_command_send(handle, "vis %s,%d", component_name_or_id, is_visible);
+    return nextion_component_visibility_apply(handle, component_name_or_id, component_name_or_id, is_visible);
 }
 
 nex_err_t nextion_component_set_visibility_all(nextion_t *handle, bool is_visible)
 {
     CMP_CHECK_HANDLE(handle, NEX_FAIL)
 
+    // Shadowed visibilities no longer hold.
+    nextion_component_cache_invalidate(nextion_component_cache_of(handle));
+
     return nextion_command_send(handle, "vis 255,%d", is_visible);
 }
 
@@ -91,10 +116,9 @@ nex_err_t nextion_component_get_property_text(nextion_t *handle,
     CMP_CHECK((buffer != NULL), "buffer error(NULL)", NEX_FAIL)
     CMP_CHECK((expected_length != NULL), "expected_length error(NULL)", NEX_FAIL)
 
-    size_t command_length = 10 + NEX_DVC_COMPONENT_MAX_NAME_LENGTH;
-    char command[10 + NEX_DVC_COMPONENT_MAX_NAME_LENGTH];
+    char command[NEX_COMPONENT_GET_COMMAND_MAX_LENGTH];
 
-    snprintf(command, command_length, "get %s.%s", component_name, property_name);
+    CMP_CHECK((nextion_component_build_get(command, sizeof(command), component_name, property_name)), "component_name error(too long)", NEX_FAIL)
 
     return nextion_system_get_text(handle, command, buffer, expected_length);
 }
@@ -109,10 +133,9 @@ nex_err_t nextion_component_get_property_number(nextion_t *handle,
     CMP_CHECK((property_name != NULL), "property_name error(NULL)", NEX_FAIL)
     CMP_CHECK((number != NULL), "number error(NULL)", NEX_FAIL)
 
-    size_t command_length = 10 + NEX_DVC_COMPONENT_MAX_NAME_LENGTH;
-    char command[10 + NEX_DVC_COMPONENT_MAX_NAME_LENGTH];
+    char command[NEX_COMPONENT_GET_COMMAND_MAX_LENGTH];
 
-    snprintf(command, command_length, "get %s.%s", component_name, property_name);
+    CMP_CHECK((nextion_component_build_get(command, sizeof(command), component_name, property_name)), "component_name error(too long)", NEX_FAIL)
 
     return nextion_system_get_number(handle, command, number);
 }
@@ -127,7 +150,7 @@ nex_err_t nextion_component_set_property_text(nextion_t *handle,
     CMP_CHECK((property_name != NULL), "property_name error(NULL)", NEX_FAIL)
     CMP_CHECK((text != NULL), "text error(NULL)", NEX_FAIL)
 
-    return nextion_command_send(handle, "%s.%s=\"%s\"", component_name, property_name, text);
+    return nextion_component_text_apply(handle, component_name, component_name, property_name, text);
 }
 
 nex_err_t nextion_component_set_property_number(nextion_t *handle,
@@ -139,5 +162,380 @@ nex_err_t nextion_component_set_property_number(nextion_t *handle,
     CMP_CHECK((component_name != NULL), "component_name error(NULL)", NEX_FAIL)
     CMP_CHECK((property_name != NULL), "property_name error(NULL)", NEX_FAIL)
 
-    return nextion_command_send(handle, "%s.%s=%d", component_name, property_name, number);
-}
\ No newline at end of file
+    return nextion_component_number_apply(handle, component_name, component_name, property_name, number);
+}
+
+nex_err_t nextion_component_bind(nextion_t *handle,
+                                 const char *page_name,
+                                 const char *component_name,
+                                 nextion_component_t *component)
+{
+    CMP_CHECK_HANDLE(handle, NEX_FAIL)
+    CMP_CHECK((component_name != NULL), "component_name error(NULL)", NEX_FAIL)
+    CMP_CHECK((component != NULL), "component error(NULL)", NEX_FAIL)
+    CMP_CHECK((strlen(component_name) <= NEX_DVC_COMPONENT_MAX_NAME_LENGTH), "component_name error(too long)", NEX_FAIL)
+    CMP_CHECK((page_name == NULL || strlen(page_name) <= NEX_DVC_PAGE_MAX_NAME_LENGTH), "page_name error(too long)", NEX_FAIL)
+
+    char command[NEX_COMPONENT_GET_COMMAND_MAX_LENGTH];
+    nextion_command_builder_t builder;
+
+    nextion_command_builder_init(&builder, command, sizeof(command), 0, NULL, NULL);
+    nextion_command_builder_append_identifier(&builder, "get ");
+
+    if (page_name != NULL)
+    {
+        nextion_command_builder_append_identifier(&builder, page_name);
+        nextion_command_builder_append_char(&builder, '.');
+    }
+
+    nextion_command_builder_append_identifier(&builder, component_name);
+    nextion_command_builder_append_identifier(&builder, ".id");
+    nextion_command_builder_append_char(&builder, '\0');
+
+    int32_t id = 0;
+    nex_err_t code = nextion_system_get_number(handle, command, &id);
+
+    if (code != NEX_OK)
+    {
+        return code;
+    }
+
+    CMP_CHECK((id >= 0 && id <= UINT8_MAX), "id error(out of range)", NEX_FAIL)
+
+    strcpy(component->name, component_name);
+    strcpy(component->page, page_name == NULL ? "" : page_name);
+
+    component->id = (uint8_t)id;
+
+    // The current page may change; only "page.name" keeps pointing at this one.
+    if (page_name != NULL)
+    {
+        nextion_command_builder_init(&builder, component->reference, sizeof(component->reference), 0, NULL, NULL);
+        nextion_command_builder_append_identifier(&builder, page_name);
+        nextion_command_builder_append_char(&builder, '.');
+        nextion_command_builder_append_identifier(&builder, component_name);
+        nextion_command_builder_append_char(&builder, '\0');
+
+        component->object[0] = '\0';
+
+        return NEX_OK;
+    }
+
+    // Use whichever of "name" and "b[id]" is shorter on the wire.
+
+    nextion_command_builder_init(&builder, component->reference, sizeof(component->reference), 0, NULL, NULL);
+    nextion_command_builder_append_identifier(&builder, "b[");
+    nextion_command_builder_append_uint(&builder, component->id);
+    nextion_command_builder_append_char(&builder, ']');
+
+    if (builder.length >= strlen(component_name))
+    {
+        strcpy(component->reference, component_name);
+    }
+    else
+    {
+        component->reference[builder.length] = '\0';
+    }
+
+    // Ids are shorter than names from two characters on.
+    if (component->id < 10 && strlen(component_name) > 1)
+    {
+        component->object[0] = (char)('0' + component->id);
+        component->object[1] = '\0';
+    }
+    else if (component->id < 100 && strlen(component_name) > 2)
+    {
+        component->object[0] = (char)('0' + component->id / 10);
+        component->object[1] = (char)('0' + component->id % 10);
+        component->object[2] = '\0';
+    }
+    else
+    {
+        strcpy(component->object, component_name);
+    }
+
+    return NEX_OK;
+}
+
+nex_err_t nextion_component_bound_set_visibility(nextion_t *handle, const nextion_component_t *component, bool is_visible)
+{
+    CMP_CHECK_HANDLE(handle, NEX_FAIL)
+    CMP_CHECK((component != NULL), "component error(NULL)", NEX_FAIL)
+    CMP_CHECK((component->object[0] != '\0'), "component error(bound to a page)", NEX_FAIL)
+
+    return nextion_component_visibility_apply(handle, component->name, component->object, is_visible);
+}
+
+nex_err_t nextion_component_bound_get_property_text(nextion_t *handle,
+                                                    const nextion_component_t *component,
+                                                    const char *property_name,
+                                                    char *buffer,
+                                                    size_t *expected_length)
+{
+    CMP_CHECK_HANDLE(handle, NEX_FAIL)
+    CMP_CHECK((component != NULL), "component error(NULL)", NEX_FAIL)
+
+    char command[NEX_COMPONENT_GET_COMMAND_MAX_LENGTH];
+
+    CMP_CHECK((nextion_component_build_get(command, sizeof(command), component->reference, property_name)), "property_name error(NULL or too long)", NEX_FAIL)
+
+    return nextion_system_get_text(handle, command, buffer, expected_length);
+}
+
+nex_err_t nextion_component_bound_get_property_number(nextion_t *handle,
+                                                      const nextion_component_t *component,
+                                                      const char *property_name,
+                                                      int32_t *number)
+{
+    CMP_CHECK_HANDLE(handle, NEX_FAIL)
+    CMP_CHECK((component != NULL), "component error(NULL)", NEX_FAIL)
+
+    char command[NEX_COMPONENT_GET_COMMAND_MAX_LENGTH];
+
+    CMP_CHECK((nextion_component_build_get(command, sizeof(command), component->reference, property_name)), "property_name error(NULL or too long)", NEX_FAIL)
+
+    return nextion_system_get_number(handle, command, number);
+}
+
+nex_err_t nextion_component_bound_set_property_text(nextion_t *handle,
+                                                    const nextion_component_t *component,
+                                                    const char *property_name,
+                                                    const char *text)
+{
+    CMP_CHECK_HANDLE(handle, NEX_FAIL)
+    CMP_CHECK((component != NULL), "component error(NULL)", NEX_FAIL)
+    CMP_CHECK((property_name != NULL), "property_name error(NULL)", NEX_FAIL)
+    CMP_CHECK((text != NULL), "text error(NULL)", NEX_FAIL)
+
+    return nextion_component_text_apply(handle, nextion_component_key(component), component->reference, property_name, text);
+}
+
+nex_err_t nextion_component_bound_set_property_number(nextion_t *handle,
+                                                      const nextion_component_t *component,
+                                                      const char *property_name,
+                                                      int32_t number)
+{
+    CMP_CHECK_HANDLE(handle, NEX_FAIL)
+    CMP_CHECK((component != NULL), "component error(NULL)", NEX_FAIL)
+    CMP_CHECK((property_name != NULL), "property_name error(NULL)", NEX_FAIL)
+
+    return nextion_component_number_apply(handle, nextion_component_key(component), component->reference, property_name, number);
+}
+
+nex_err_t nextion_component_bound_get_text(nextion_t *handle,
+                                           const nextion_component_t *component,
+                                           char *buffer,
+                                           size_t *expected_length)
+{
+    return nextion_component_bound_get_property_text(handle, component, "txt", buffer, expected_length);
+}
+
+nex_err_t nextion_component_bound_get_value(nextion_t *handle, const nextion_component_t *component, int32_t *number)
+{
+    return nextion_component_bound_get_property_number(handle, component, "val", number);
+}
+
+nex_err_t nextion_component_bound_set_text(nextion_t *handle, const nextion_component_t *component, const char *text)
+{
+    return nextion_component_bound_set_property_text(handle, component, "txt", text);
+}
+
+nex_err_t nextion_component_bound_set_value(nextion_t *handle, const nextion_component_t *component, int32_t number)
+{
+    return nextion_component_bound_set_property_number(handle, component, "val", number);
+}
+
+nex_err_t nextion_component_cache_clear(nextion_t *handle)
+{
+    CMP_CHECK_HANDLE(handle, NEX_FAIL)
+
+    nextion_component_cache_invalidate(nextion_component_cache_of(handle));
+
+    return NEX_OK;
+}
+
+nex_err_t nextion_component_cache_get_stats(nextion_t *handle, nextion_component_cache_stats_t *stats)
+{
+    CMP_CHECK_HANDLE(handle, NEX_FAIL)
+    CMP_CHECK((stats != NULL), "stats error(NULL)", NEX_FAIL)
+
+    nextion_component_cache_t *cache = nextion_component_cache_of(handle);
+
+    portENTER_CRITICAL(&cache->lock);
+
+    *stats = cache->stats;
+
+    portEXIT_CRITICAL(&cache->lock);
+
+    return NEX_OK;
+}
+
+/**
+ * @brief Set a component visibility, unless the cache says it is already set.
+ * @param handle Nextion context pointer.
+ * @param key Component name or id the cache is keyed by.
+ * @param reference Component name or id sent.
+ * @param is_visible True make it visible; false make it invisible.
+ * @return NEX_OK or NEX_FAIL | NEX_DVC_ERR_INVALID_COMPONENT.
+ */
+static nex_err_t nextion_component_visibility_apply(nextion_t *handle, const char *key, const char *reference, bool is_visible)
+{
+    nextion_component_cache_t *cache = nextion_component_cache_of(handle);
+
+    if (nextion_component_cache_contains(cache, NEX_COMPONENT_CACHE_VISIBILITY, key, NULL, is_visible, NULL))
+    {
+        return NEX_OK;
+    }
+
+    char command[NEX_COMPONENT_SET_COMMAND_MAX_LENGTH];
+    nextion_command_builder_t builder;
+
+    nextion_command_builder_init(&builder, command, sizeof(command), 0, NULL, NULL);
+    nextion_command_builder_append_identifier(&builder, "vis ");
+    nextion_command_builder_append_identifier(&builder, reference);
+    nextion_command_builder_append_char(&builder, ',');
+    nextion_command_builder_append_int(&builder, is_visible);
+
+    CMP_CHECK((nextion_command_builder_append_char(&builder, '\0')), "reference error(too long)", NEX_FAIL)
+
+    nex_err_t code = nextion_command_send_built(handle, command);
+
+    if (code == NEX_OK)
+    {
+        nextion_component_cache_store(cache, NEX_COMPONENT_CACHE_VISIBILITY, key, NULL, is_visible, NULL);
+    }
+    else
+    {
+        nextion_component_cache_remove(cache, NEX_COMPONENT_CACHE_VISIBILITY, key, NULL);
+    }
+
+    return code;
+}
+
+/**
+ * @brief Set a component text property, unless the cache says it is already set.
+ * @param handle Nextion context pointer.
+ * @param key Component name the cache is keyed by.
+ * @param reference Component reference sent.
+ * @param property_name Property name.
+ * @param text Text.
+ * @return NEX_OK or NEX_FAIL | NEX_DVC_ERR_INVALID_VARIABLE_OR_ATTRIBUTE | NEX_DVC_ERR_INVALID_COMPONENT.
+ */
+static nex_err_t nextion_component_text_apply(nextion_t *handle, const char *key, const char *reference, const char *property_name, const char *text)
+{
+    nextion_component_cache_t *cache = nextion_component_cache_of(handle);
+
+    if (nextion_component_cache_contains(cache, NEX_COMPONENT_CACHE_TEXT, key, property_name, 0, text))
+    {
+        return NEX_OK;
+    }
+
+    char command[NEX_COMPONENT_SET_COMMAND_MAX_LENGTH];
+    nextion_command_builder_t builder;
+
+    nextion_command_builder_init(&builder, command, sizeof(command), 0, NULL, NULL);
+    nextion_component_build_set(&builder, reference, property_name);
+    nextion_command_builder_append_quoted(&builder, text);
+
+    nex_err_t code = nextion_command_builder_append_char(&builder, '\0')
+                         ? nextion_command_send_built(handle, command)
+                         : nextion_command_send(handle, "%s.%s=\"%s\"", reference, property_name, text);
+
+    if (code == NEX_OK)
+    {
+        nextion_component_cache_store(cache, NEX_COMPONENT_CACHE_TEXT, key, property_name, 0, text);
+    }
+    else
+    {
+        nextion_component_cache_remove(cache, NEX_COMPONENT_CACHE_TEXT, key, property_name);
+    }
+
+    return code;
+}
+
+/**
+ * @brief Set a component numeric property, unless the cache says it is already set.
+ * @param handle Nextion context pointer.
+ * @param key Component name the cache is keyed by.
+ * @param reference Component reference sent.
+ * @param property_name Property name.
+ * @param number Value.
+ * @return NEX_OK or NEX_FAIL | NEX_DVC_ERR_INVALID_VARIABLE_OR_ATTRIBUTE | NEX_DVC_ERR_INVALID_COMPONENT.
+ */
+static nex_err_t nextion_component_number_apply(nextion_t *handle, const char *key, const char *reference, const char *property_name, int32_t number)
+{
+    nextion_component_cache_t *cache = nextion_component_cache_of(handle);
+
+    if (nextion_component_cache_contains(cache, NEX_COMPONENT_CACHE_NUMBER, key, property_name, number, NULL))
+    {
+        return NEX_OK;
+    }
+
+    char command[NEX_COMPONENT_SET_COMMAND_MAX_LENGTH];
+    nextion_command_builder_t builder;
+
+    nextion_command_builder_init(&builder, command, sizeof(command), 0, NULL, NULL);
+    nextion_component_build_set(&builder, reference, property_name);
+    nextion_command_builder_append_int(&builder, number);
+
+    CMP_CHECK((nextion_command_builder_append_char(&builder, '\0')), "property_name error(too long)", NEX_FAIL)
+
+    nex_err_t code = nextion_command_send_built(handle, command);
+
+    if (code == NEX_OK)
+    {
+        nextion_component_cache_store(cache, NEX_COMPONENT_CACHE_NUMBER, key, property_name, number, NULL);
+    }
+    else
+    {
+        nextion_component_cache_remove(cache, NEX_COMPONENT_CACHE_NUMBER, key, property_name);
+    }
+
+    return code;
+}
+
+/**
+ * @brief Get the key the cache holds a bound component under.
+ * @param component Bound component.
+ * @return Its name, or "page.name" when bound to a page; the cache takes
+ * both for the same value while that page is the one last set.
+ */
+static const char *nextion_component_key(const nextion_component_t *component)
+{
+    return component->page[0] == '\0' ? component->name : component->reference;
+}
+
+/**
+ * @brief Start a "set" command: "reference.property=".
+ * @param builder Builder initialized on the command buffer.
+ * @param reference Component reference.
+ * @param property_name Property name.
+ */
+static void nextion_component_build_set(nextion_command_builder_t *builder, const char *reference, const char *property_name)
+{
+    nextion_command_builder_append_identifier(builder, reference);
+    nextion_command_builder_append_char(builder, '.');
+    nextion_command_builder_append_identifier(builder, property_name);
+    nextion_command_builder_append_char(builder, '=');
+}
+
+/**
+ * @brief Build a null-terminated "get" command for a component property.
+ * @param command Location where the command will be stored.
+ * @param capacity Command buffer length.
+ * @param component_name Component name.
+ * @param property_name Property name.
+ * @return True if success, false if the command does not fit.
+ */
+static bool nextion_component_build_get(char *command, size_t capacity, const char *component_name, const char *property_name)
+{
+    nextion_command_builder_t builder;
+
+    nextion_command_builder_init(&builder, command, capacity, 0, NULL, NULL);
+    nextion_command_builder_append_identifier(&builder, "get ");
+    nextion_command_builder_append_identifier(&builder, component_name);
+    nextion_command_builder_append_char(&builder, '.');
+    nextion_command_builder_append_identifier(&builder, property_name);
+
+    return nextion_command_builder_append_char(&builder, '\0');
+}
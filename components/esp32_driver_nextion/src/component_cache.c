@@ -0,0 +1,422 @@
+#include <stdio.h>
+#include <string.h>
+#include "component_cache.h"
+
+#define NEX_COMPONENT_CACHE_ENTRY_COUNT (CONFIG_NEX_COMPONENT_CACHE_SIZE > 0 ? CONFIG_NEX_COMPONENT_CACHE_SIZE : 1)
+
+static bool nextion_component_cache_resolve(const nextion_component_cache_t *cache, const char *component, char *page, char *name);
+static bool nextion_component_cache_page_is_id(const char *page, size_t length);
+static void nextion_component_cache_page_resolve(const nextion_component_cache_t *cache, const char *page, size_t length, char *resolved);
+static nextion_component_cache_entry_t *nextion_component_cache_find(nextion_component_cache_t *cache,
+                                                                     nextion_component_cache_kind_t kind,
+                                                                     const char *component,
+                                                                     const char *property);
+static void nextion_component_cache_forget(nextion_component_cache_t *cache,
+                                           nextion_component_cache_kind_t kind,
+                                           const char *component,
+                                           const char *property);
+
+void nextion_component_cache_init(nextion_component_cache_t *cache)
+{
+    memset(cache, 0, sizeof(nextion_component_cache_t));
+
+    portMUX_INITIALIZE(&cache->lock);
+}
+
+bool nextion_component_cache_contains(nextion_component_cache_t *cache,
+                                      nextion_component_cache_kind_t kind,
+                                      const char *component,
+                                      const char *property,
+                                      int32_t number,
+                                      const char *text)
+{
+    if (CONFIG_NEX_COMPONENT_CACHE_SIZE == 0)
+    {
+        return false;
+    }
+
+    char page[NEX_DVC_PAGE_MAX_NAME_LENGTH + 1];
+    char name[NEX_DVC_COMPONENT_MAX_NAME_LENGTH + 1];
+
+    portENTER_CRITICAL(&cache->lock);
+
+    nextion_component_cache_entry_t *entry = NULL;
+    bool found = false;
+
+    if (nextion_component_cache_resolve(cache, component, page, name))
+    {
+        entry = nextion_component_cache_find(cache, kind, name, property);
+    }
+
+    if (entry != NULL)
+    {
+        // A value written while another page was shown is not the one of this page.
+        found = strcmp(entry->page, page) == 0 &&
+                (kind == NEX_COMPONENT_CACHE_TEXT ? strcmp(entry->text, text) == 0 : entry->number == number);
+
+        entry->last_used = ++cache->clock;
+    }
+
+    if (found)
+    {
+        cache->stats.hits++;
+    }
+    else
+    {
+        cache->stats.misses++;
+    }
+
+    portEXIT_CRITICAL(&cache->lock);
+
+    return found;
+}
+
+void nextion_component_cache_store(nextion_component_cache_t *cache,
+                                   nextion_component_cache_kind_t kind,
+                                   const char *component,
+                                   const char *property,
+                                   int32_t number,
+                                   const char *text)
+{
+    if (CONFIG_NEX_COMPONENT_CACHE_SIZE == 0)
+    {
+        return;
+    }
+
+    if (kind == NEX_COMPONENT_CACHE_VISIBILITY)
+    {
+        property = "";
+    }
+
+    char page[NEX_DVC_PAGE_MAX_NAME_LENGTH + 1];
+    char name[NEX_DVC_COMPONENT_MAX_NAME_LENGTH + 1];
+
+    portENTER_CRITICAL(&cache->lock);
+
+    // What does not fit cannot be compared later.
+    if (!nextion_component_cache_resolve(cache, component, page, name) ||
+        strlen(property) > NEX_COMPONENT_CACHE_PROPERTY_MAX_LENGTH ||
+        (kind == NEX_COMPONENT_CACHE_TEXT && strlen(text) >= CONFIG_NEX_COMPONENT_CACHE_TEXT_SIZE))
+    {
+        nextion_component_cache_forget(cache, kind, component, property);
+
+        portEXIT_CRITICAL(&cache->lock);
+
+        return;
+    }
+
+    nextion_component_cache_entry_t *entry = nextion_component_cache_find(cache, kind, name, property);
+
+    if (entry == NULL)
+    {
+        // Take a free entry or, if there is none, the least recently used.
+
+        entry = &cache->entries[0];
+
+        for (size_t i = 0; i < NEX_COMPONENT_CACHE_ENTRY_COUNT; i++)
+        {
+            nextion_component_cache_entry_t *candidate = &cache->entries[i];
+
+            if (!candidate->is_used)
+            {
+                entry = candidate;
+                break;
+            }
+
+            if ((int32_t)(candidate->last_used - entry->last_used) < 0)
+            {
+                entry = candidate;
+            }
+        }
+
+        if (entry->is_used)
+        {
+            cache->stats.evictions++;
+        }
+
+        strcpy(entry->component, name);
+        strcpy(entry->property, property);
+
+        entry->kind = kind;
+        entry->is_used = true;
+    }
+
+    strcpy(entry->page, page);
+
+    if (kind == NEX_COMPONENT_CACHE_TEXT)
+    {
+        strcpy(entry->text, text);
+    }
+    else
+    {
+        entry->number = number;
+    }
+
+    entry->last_used = ++cache->clock;
+
+    portEXIT_CRITICAL(&cache->lock);
+}
+
+bool nextion_component_cache_can_keep(nextion_component_cache_t *cache,
+                                      nextion_component_cache_kind_t kind,
+                                      const char *component,
+                                      const char *property,
+                                      const char *text)
+{
+    if (CONFIG_NEX_COMPONENT_CACHE_SIZE == 0)
+    {
+        return false;
+    }
+
+    if (kind == NEX_COMPONENT_CACHE_VISIBILITY)
+    {
+        property = "";
+    }
+
+    char page[NEX_DVC_PAGE_MAX_NAME_LENGTH + 1];
+    char name[NEX_DVC_COMPONENT_MAX_NAME_LENGTH + 1];
+
+    portENTER_CRITICAL(&cache->lock);
+
+    bool is_resolved = nextion_component_cache_resolve(cache, component, page, name);
+
+    portEXIT_CRITICAL(&cache->lock);
+
+    return is_resolved &&
+           strlen(property) <= NEX_COMPONENT_CACHE_PROPERTY_MAX_LENGTH &&
+           (kind != NEX_COMPONENT_CACHE_TEXT || strlen(text) < CONFIG_NEX_COMPONENT_CACHE_TEXT_SIZE);
+}
+
+void nextion_component_cache_remove(nextion_component_cache_t *cache,
+                                    nextion_component_cache_kind_t kind,
+                                    const char *component,
+                                    const char *property)
+{
+    portENTER_CRITICAL(&cache->lock);
+
+    nextion_component_cache_forget(cache, kind, component, property);
+
+    portEXIT_CRITICAL(&cache->lock);
+}
+
+void nextion_component_cache_store_page(nextion_component_cache_t *cache, const char *page)
+{
+    if (CONFIG_NEX_COMPONENT_CACHE_SIZE == 0 || strlen(page) > NEX_DVC_PAGE_MAX_NAME_LENGTH)
+    {
+        return;
+    }
+
+    size_t length = strlen(page);
+    bool is_id = nextion_component_cache_page_is_id(page, length);
+
+    portENTER_CRITICAL(&cache->lock);
+
+    // Until the display reports its id, a page set by name is kept by name.
+    cache->page_name[0] = '\0';
+
+    nextion_component_cache_page_resolve(cache, page, length, cache->page);
+
+    if (!is_id)
+    {
+        strcpy(cache->page_name, page);
+    }
+
+    portEXIT_CRITICAL(&cache->lock);
+}
+
+void nextion_component_cache_store_page_id(nextion_component_cache_t *cache, uint8_t page_id)
+{
+    portENTER_CRITICAL(&cache->lock);
+
+    if (cache->page_name[0] != '\0')
+    {
+        snprintf(cache->page, sizeof(cache->page), "%u", (unsigned int)page_id);
+    }
+
+    portEXIT_CRITICAL(&cache->lock);
+}
+
+bool nextion_component_cache_contains_page(nextion_component_cache_t *cache, const char *page)
+{
+    size_t length = strlen(page);
+    char resolved[NEX_DVC_PAGE_MAX_NAME_LENGTH + 1];
+
+    if (length > NEX_DVC_PAGE_MAX_NAME_LENGTH)
+    {
+        return false;
+    }
+
+    portENTER_CRITICAL(&cache->lock);
+
+    nextion_component_cache_page_resolve(cache, page, length, resolved);
+
+    bool found = cache->page[0] != '\0' && strcmp(cache->page, resolved) == 0;
+
+    portEXIT_CRITICAL(&cache->lock);
+
+    return found;
+}
+
+void nextion_component_cache_invalidate(nextion_component_cache_t *cache)
+{
+    portENTER_CRITICAL(&cache->lock);
+
+    cache->page[0] = '\0';
+    cache->page_name[0] = '\0';
+
+    for (size_t i = 0; i < NEX_COMPONENT_CACHE_ENTRY_COUNT; i++)
+    {
+        cache->entries[i].is_used = false;
+    }
+
+    cache->stats.invalidations++;
+
+    portEXIT_CRITICAL(&cache->lock);
+}
+
+/**
+ * @brief Split a component reference into the page and the name it is kept under.
+ * @note The cache lock must be held.
+ * @param cache Cache pointer.
+ * @param component Component name, "page.name" or id.
+ * @param page Location where the page is stored; the page last set for a plain name.
+ * @param name Location where the name is stored.
+ * @return True if it can be kept, false if it is an id or does not fit.
+ */
+static bool nextion_component_cache_resolve(const nextion_component_cache_t *cache, const char *component, char *page, char *name)
+{
+    const char *separator = strchr(component, '.');
+    const char *short_name = separator != NULL ? separator + 1 : component;
+    size_t page_length = separator != NULL ? (size_t)(separator - component) : strlen(cache->page);
+
+    // Names never start with a digit; "3" and "b[3]" are ids.
+    if ((short_name[0] >= '0' && short_name[0] <= '9') ||
+        strchr(short_name, '[') != NULL ||
+        strlen(short_name) > NEX_DVC_COMPONENT_MAX_NAME_LENGTH ||
+        page_length > NEX_DVC_PAGE_MAX_NAME_LENGTH)
+    {
+        return false;
+    }
+
+    if (separator != NULL)
+    {
+        nextion_component_cache_page_resolve(cache, component, page_length, page);
+    }
+    else
+    {
+        strcpy(page, cache->page);
+    }
+
+    strcpy(name, short_name);
+
+    return true;
+}
+
+/**
+ * @brief Check if a page reference is an id.
+ * @param page Page name or id; need not be null terminated.
+ * @param length Reference length.
+ * @return True if it is an id, false if it is a name.
+ */
+static bool nextion_component_cache_page_is_id(const char *page, size_t length)
+{
+    // Names never start with a digit.
+    return length > 0 && page[0] >= '0' && page[0] <= '9';
+}
+
+/**
+ * @brief Get the form a page reference is kept under: its id when known, otherwise its name.
+ * @note The cache lock must be held.
+ * @param cache Cache pointer.
+ * @param page Page name or id; need not be null terminated.
+ * @param length Reference length; must not exceed NEX_DVC_PAGE_MAX_NAME_LENGTH.
+ * @param resolved Location where the page is stored.
+ */
+static void nextion_component_cache_page_resolve(const nextion_component_cache_t *cache, const char *page, size_t length, char *resolved)
+{
+    if (nextion_component_cache_page_is_id(page, length))
+    {
+        // "00" and "0" are the same id.
+        while (length > 1 && page[0] == '0')
+        {
+            page++;
+            length--;
+        }
+    }
+    else if (cache->page_name[0] != '\0' && strlen(cache->page_name) == length && strncmp(cache->page_name, page, length) == 0)
+    {
+        strcpy(resolved, cache->page);
+
+        return;
+    }
+
+    memcpy(resolved, page, length);
+    resolved[length] = '\0';
+}
+
+/**
+ * @brief Find the entry of a property.
+ * @note The cache lock must be held.
+ * @param cache Cache pointer.
+ * @param kind What the property holds.
+ * @param component Component name.
+ * @param property Property name; ignored for visibility.
+ * @return Entry pointer, or NULL if not found.
+ */
+static nextion_component_cache_entry_t *nextion_component_cache_find(nextion_component_cache_t *cache,
+                                                                     nextion_component_cache_kind_t kind,
+                                                                     const char *component,
+                                                                     const char *property)
+{
+    for (size_t i = 0; i < NEX_COMPONENT_CACHE_ENTRY_COUNT; i++)
+    {
+        nextion_component_cache_entry_t *entry = &cache->entries[i];
+
+        if (!entry->is_used || entry->kind != kind || strcmp(entry->component, component) != 0)
+        {
+            continue;
+        }
+
+        if (kind == NEX_COMPONENT_CACHE_VISIBILITY || strcmp(entry->property, property) == 0)
+        {
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Remove the entries a component reference might stand for.
+ * @note The cache lock must be held.
+ * @param cache Cache pointer.
+ * @param kind What the property holds.
+ * @param component Component name, "page.name" or id; an id or a name that does
+ * not fit might be any component, so the property of all of them is removed.
+ * @param property Property name; ignored for visibility.
+ */
+static void nextion_component_cache_forget(nextion_component_cache_t *cache,
+                                           nextion_component_cache_kind_t kind,
+                                           const char *component,
+                                           const char *property)
+{
+    char page[NEX_DVC_PAGE_MAX_NAME_LENGTH + 1];
+    char name[NEX_DVC_COMPONENT_MAX_NAME_LENGTH + 1];
+
+    bool is_name = nextion_component_cache_resolve(cache, component, page, name);
+
+    for (size_t i = 0; i < NEX_COMPONENT_CACHE_ENTRY_COUNT; i++)
+    {
+        nextion_component_cache_entry_t *entry = &cache->entries[i];
+
+        if (!entry->is_used || entry->kind != kind || (is_name && strcmp(entry->component, name) != 0))
+        {
+            continue;
+        }
+
+        if (kind == NEX_COMPONENT_CACHE_VISIBILITY || strcmp(entry->property, property) == 0)
+        {
+            entry->is_used = false;
+        }
+    }
+}
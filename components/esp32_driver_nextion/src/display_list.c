@@ -0,0 +1,449 @@
+#include <string.h>
+#include "esp32_driver_nextion/nextion.h"
+#include "esp32_driver_nextion/drawing.h"
+#include "esp32_driver_nextion/display_list.h"
+#include "assertion.h"
+
+/**
+ * @brief Longest primitive; a text with 255 characters.
+ */
+#define NEX_DISPLAY_LIST_MAX_OP_LENGTH (19U + 255U)
+
+/**
+ * @typedef nextion_display_list_op_t
+ * @brief First byte of each primitive; its 16 bits arguments follow, little endian.
+ */
+typedef enum
+{
+    NEX_DISPLAY_LIST_OP_FILL_SCREEN = 1,  /*!< Color. */
+    NEX_DISPLAY_LIST_OP_FILL_AREA = 2,    /*!< Area and color. */
+    NEX_DISPLAY_LIST_OP_FILL_CIRCLE = 3,  /*!< Center, radius and color. */
+    NEX_DISPLAY_LIST_OP_LINE = 4,         /*!< Area and color. */
+    NEX_DISPLAY_LIST_OP_RECTANGLE = 5,    /*!< Area and color. */
+    NEX_DISPLAY_LIST_OP_CIRCLE = 6,       /*!< Center, radius and color. */
+    NEX_DISPLAY_LIST_OP_PICTURE = 7,      /*!< Origin, then the picture id byte. */
+    NEX_DISPLAY_LIST_OP_CROP_PICTURE = 8, /*!< Crop area and destination, then the picture id byte. */
+    NEX_DISPLAY_LIST_OP_TEXT = 9          /*!< Area, font color, background color, then the font id, picture id,
+                                               fill mode, horizontal and vertical alignment and text length bytes, and the text. */
+} nextion_display_list_op_t;
+
+static nex_err_t nextion_display_list_append(nextion_display_list_t *list, const uint8_t *op, size_t length);
+static bool nextion_display_list_merge_fill(uint8_t *last, const uint8_t *op);
+static size_t nextion_display_list_op_length(const uint8_t *bytes, size_t available);
+static nex_err_t nextion_display_list_draw(nextion_t *handle, const uint8_t *op);
+static uint8_t *nextion_display_list_put(uint8_t *at, uint16_t value);
+static uint16_t nextion_display_list_get(const uint8_t *at, size_t index);
+static uint8_t *nextion_display_list_put_area(uint8_t *at, area_t area);
+static area_t nextion_display_list_get_area(const uint8_t *at, size_t index);
+
+nex_err_t nextion_display_list_init(nextion_display_list_t *list, uint8_t *buffer, size_t capacity)
+{
+    CMP_CHECK((list != NULL), "list error(NULL)", NEX_FAIL)
+    CMP_CHECK((buffer != NULL || capacity == 0), "buffer error(NULL)", NEX_FAIL)
+
+    list->buffer = buffer;
+    list->capacity = capacity;
+    list->length = 0;
+    list->last = 0;
+
+    return NEX_OK;
+}
+
+nex_err_t nextion_display_list_fill_screen(nextion_display_list_t *list, rgb565_t color)
+{
+    CMP_CHECK((list != NULL), "list error(NULL)", NEX_FAIL)
+
+    uint8_t op[3] = {NEX_DISPLAY_LIST_OP_FILL_SCREEN};
+
+    nextion_display_list_put(op + 1, color);
+
+    // Everything drawn before is covered.
+    list->length = 0;
+
+    return nextion_display_list_append(list, op, sizeof(op));
+}
+
+nex_err_t nextion_display_list_fill_area(nextion_display_list_t *list, area_t area, rgb565_t color)
+{
+    CMP_CHECK((list != NULL), "list error(NULL)", NEX_FAIL)
+
+    uint8_t op[11] = {NEX_DISPLAY_LIST_OP_FILL_AREA};
+
+    nextion_display_list_put(nextion_display_list_put_area(op + 1, area), color);
+
+    return nextion_display_list_append(list, op, sizeof(op));
+}
+
+nex_err_t nextion_display_list_fill_circle(nextion_display_list_t *list, point_t center, uint16_t radius, rgb565_t color)
+{
+    CMP_CHECK((list != NULL), "list error(NULL)", NEX_FAIL)
+
+    uint8_t op[9] = {NEX_DISPLAY_LIST_OP_FILL_CIRCLE};
+
+    nextion_display_list_put(nextion_display_list_put(nextion_display_list_put(nextion_display_list_put(op + 1, center.x), center.y), radius), color);
+
+    return nextion_display_list_append(list, op, sizeof(op));
+}
+
+nex_err_t nextion_display_list_line(nextion_display_list_t *list, area_t area, rgb565_t color)
+{
+    CMP_CHECK((list != NULL), "list error(NULL)", NEX_FAIL)
+
+    uint8_t op[11] = {NEX_DISPLAY_LIST_OP_LINE};
+
+    nextion_display_list_put(nextion_display_list_put_area(op + 1, area), color);
+
+    return nextion_display_list_append(list, op, sizeof(op));
+}
+
+nex_err_t nextion_display_list_rectangle(nextion_display_list_t *list, area_t area, rgb565_t color)
+{
+    CMP_CHECK((list != NULL), "list error(NULL)", NEX_FAIL)
+
+    uint8_t op[11] = {NEX_DISPLAY_LIST_OP_RECTANGLE};
+
+    nextion_display_list_put(nextion_display_list_put_area(op + 1, area), color);
+
+    return nextion_display_list_append(list, op, sizeof(op));
+}
+
+nex_err_t nextion_display_list_circle(nextion_display_list_t *list, point_t center, uint16_t radius, rgb565_t color)
+{
+    CMP_CHECK((list != NULL), "list error(NULL)", NEX_FAIL)
+
+    uint8_t op[9] = {NEX_DISPLAY_LIST_OP_CIRCLE};
+
+    nextion_display_list_put(nextion_display_list_put(nextion_display_list_put(nextion_display_list_put(op + 1, center.x), center.y), radius), color);
+
+    return nextion_display_list_append(list, op, sizeof(op));
+}
+
+nex_err_t nextion_display_list_picture(nextion_display_list_t *list, uint8_t picture_id, point_t origin)
+{
+    CMP_CHECK((list != NULL), "list error(NULL)", NEX_FAIL)
+
+    uint8_t op[6] = {NEX_DISPLAY_LIST_OP_PICTURE};
+
+    nextion_display_list_put(nextion_display_list_put(op + 1, origin.x), origin.y)[0] = picture_id;
+
+    return nextion_display_list_append(list, op, sizeof(op));
+}
+
+nex_err_t nextion_display_list_crop_picture(nextion_display_list_t *list, uint8_t picture_id, area_t crop_area, point_t destination)
+{
+    CMP_CHECK((list != NULL), "list error(NULL)", NEX_FAIL)
+
+    uint8_t op[14] = {NEX_DISPLAY_LIST_OP_CROP_PICTURE};
+    uint8_t *at = nextion_display_list_put_area(op + 1, crop_area);
+
+    nextion_display_list_put(nextion_display_list_put(at, destination.x), destination.y)[0] = picture_id;
+
+    return nextion_display_list_append(list, op, sizeof(op));
+}
+
+nex_err_t nextion_display_list_text(nextion_display_list_t *list,
+                                    area_t area,
+                                    font_t font,
+                                    background_t background,
+                                    text_alignment_t alignment,
+                                    const char *text)
+{
+    CMP_CHECK((list != NULL), "list error(NULL)", NEX_FAIL)
+    CMP_CHECK((text != NULL), "text error(NULL)", NEX_FAIL)
+
+    size_t text_length = strlen(text);
+
+    CMP_CHECK((text_length <= UINT8_MAX), "text error(longer than 255)", NEX_FAIL)
+
+    uint8_t op[NEX_DISPLAY_LIST_MAX_OP_LENGTH] = {NEX_DISPLAY_LIST_OP_TEXT};
+    uint8_t *at = nextion_display_list_put(nextion_display_list_put(nextion_display_list_put_area(op + 1, area), font.color), background.color);
+
+    at[0] = font.id;
+    at[1] = background.picture_id;
+    at[2] = (uint8_t)background.fill_mode;
+    at[3] = (uint8_t)alignment.horizontal;
+    at[4] = (uint8_t)alignment.vertical;
+    at[5] = (uint8_t)text_length;
+
+    memcpy(at + 6, text, text_length);
+
+    return nextion_display_list_append(list, op, (size_t)(at + 6 - op) + text_length);
+}
+
+nex_err_t nextion_display_list_replay(nextion_t *handle, const uint8_t *bytes, size_t length)
+{
+    CMP_CHECK_HANDLE(handle, NEX_FAIL)
+    CMP_CHECK((bytes != NULL || length == 0), "bytes error(NULL)", NEX_FAIL)
+    CMP_CHECK((nextion_batch_begin(handle) == NEX_OK), "batch error(not started)", NEX_FAIL)
+
+    nex_err_t code = NEX_OK;
+
+    for (size_t offset = 0; offset < length;)
+    {
+        size_t op_length = nextion_display_list_op_length(bytes + offset, length - offset);
+
+        if (op_length == 0)
+        {
+            CMP_LOGE("list error(malformed at %u)", (unsigned int)offset);
+
+            code = NEX_FAIL;
+            break;
+        }
+
+        nex_err_t op_code = nextion_display_list_draw(handle, bytes + offset);
+
+        if (op_code != NEX_OK && code == NEX_OK)
+        {
+            code = op_code;
+        }
+
+        offset += op_length;
+    }
+
+    nex_err_t batch_code = nextion_batch_end(handle);
+
+    return code != NEX_OK ? code : batch_code;
+}
+
+/**
+ * @brief Record a primitive, unless it merges with the last one.
+ * @param list List pointer.
+ * @param op Primitive bytes.
+ * @param length How many bytes.
+ * @return NEX_OK, or NEX_FAIL when there is no room left.
+ */
+static nex_err_t nextion_display_list_append(nextion_display_list_t *list, const uint8_t *op, size_t length)
+{
+    if (list->length > 0)
+    {
+        uint8_t *last = list->buffer + list->last;
+
+        if (op[0] != NEX_DISPLAY_LIST_OP_TEXT && list->length - list->last == length && memcmp(last, op, length) == 0)
+        {
+            return NEX_OK;
+        }
+
+        if (op[0] == NEX_DISPLAY_LIST_OP_FILL_AREA && last[0] == NEX_DISPLAY_LIST_OP_FILL_AREA &&
+            nextion_display_list_merge_fill(last, op))
+        {
+            return NEX_OK;
+        }
+    }
+
+    CMP_CHECK((list->length + length <= list->capacity), "list error(full)", NEX_FAIL)
+
+    memcpy(list->buffer + list->length, op, length);
+
+    list->last = list->length;
+    list->length += length;
+
+    return NEX_OK;
+}
+
+/**
+ * @brief Merge a fill into the previous one, when the result paints the same pixels.
+ * @param last Previous fill; updated when merged.
+ * @param op New fill.
+ * @return True if merged, otherwise false.
+ */
+static bool nextion_display_list_merge_fill(uint8_t *last, const uint8_t *op)
+{
+    area_t a = nextion_display_list_get_area(last, 0);
+    area_t b = nextion_display_list_get_area(op, 0);
+
+    // The new fill hides the previous one, whatever its color.
+    if (b.upper_left.x <= a.upper_left.x && b.upper_left.y <= a.upper_left.y &&
+        b.bottom_right.x >= a.bottom_right.x && b.bottom_right.y >= a.bottom_right.y)
+    {
+        memcpy(last, op, 11);
+
+        return true;
+    }
+
+    if (nextion_display_list_get(last, 4) != nextion_display_list_get(op, 4))
+    {
+        return false;
+    }
+
+    bool same_rows = a.upper_left.y == b.upper_left.y && a.bottom_right.y == b.bottom_right.y;
+    bool same_columns = a.upper_left.x == b.upper_left.x && a.bottom_right.x == b.bottom_right.x;
+
+    if (same_rows && a.bottom_right.x == b.upper_left.x)
+    {
+        a.bottom_right.x = b.bottom_right.x;
+    }
+    else if (same_rows && b.bottom_right.x == a.upper_left.x)
+    {
+        a.upper_left.x = b.upper_left.x;
+    }
+    else if (same_columns && a.bottom_right.y == b.upper_left.y)
+    {
+        a.bottom_right.y = b.bottom_right.y;
+    }
+    else if (same_columns && b.bottom_right.y == a.upper_left.y)
+    {
+        a.upper_left.y = b.upper_left.y;
+    }
+    else
+    {
+        return false;
+    }
+
+    nextion_display_list_put_area(last + 1, a);
+
+    return true;
+}
+
+/**
+ * @brief Get the length of the primitive starting the bytes.
+ * @param bytes Bytes.
+ * @param available How many bytes there are.
+ * @return Primitive length, or zero if unknown or cut.
+ */
+static size_t nextion_display_list_op_length(const uint8_t *bytes, size_t available)
+{
+    size_t length;
+
+    switch (bytes[0])
+    {
+    case NEX_DISPLAY_LIST_OP_FILL_SCREEN:
+        length = 3;
+        break;
+    case NEX_DISPLAY_LIST_OP_FILL_AREA:
+    case NEX_DISPLAY_LIST_OP_LINE:
+    case NEX_DISPLAY_LIST_OP_RECTANGLE:
+        length = 11;
+        break;
+    case NEX_DISPLAY_LIST_OP_FILL_CIRCLE:
+    case NEX_DISPLAY_LIST_OP_CIRCLE:
+        length = 9;
+        break;
+    case NEX_DISPLAY_LIST_OP_PICTURE:
+        length = 6;
+        break;
+    case NEX_DISPLAY_LIST_OP_CROP_PICTURE:
+        length = 14;
+        break;
+    case NEX_DISPLAY_LIST_OP_TEXT:
+        length = available >= 19 ? 19 + (size_t)bytes[18] : 19;
+        break;
+    default:
+        return 0;
+    }
+
+    return length <= available ? length : 0;
+}
+
+/**
+ * @brief Draw a primitive.
+ * @param handle Nextion context pointer.
+ * @param op Primitive bytes; checked to be complete.
+ * @return NEX_OK if success, otherwise NEX_FAIL.
+ */
+static nex_err_t nextion_display_list_draw(nextion_t *handle, const uint8_t *op)
+{
+    switch (op[0])
+    {
+    case NEX_DISPLAY_LIST_OP_FILL_SCREEN:
+        return nextion_draw_fill_screen(handle, nextion_display_list_get(op, 0));
+    case NEX_DISPLAY_LIST_OP_FILL_AREA:
+        return nextion_draw_fill_area(handle, nextion_display_list_get_area(op, 0), nextion_display_list_get(op, 4));
+    case NEX_DISPLAY_LIST_OP_LINE:
+        return nextion_draw_line(handle, nextion_display_list_get_area(op, 0), nextion_display_list_get(op, 4));
+    case NEX_DISPLAY_LIST_OP_RECTANGLE:
+        return nextion_draw_rectangle(handle, nextion_display_list_get_area(op, 0), nextion_display_list_get(op, 4));
+    case NEX_DISPLAY_LIST_OP_FILL_CIRCLE:
+    case NEX_DISPLAY_LIST_OP_CIRCLE:
+    {
+        point_t center = {.x = nextion_display_list_get(op, 0), .y = nextion_display_list_get(op, 1)};
+
+        if (op[0] == NEX_DISPLAY_LIST_OP_FILL_CIRCLE)
+        {
+            return nextion_draw_fill_circle(handle, center, nextion_display_list_get(op, 2), nextion_display_list_get(op, 3));
+        }
+
+        return nextion_draw_circle(handle, center, nextion_display_list_get(op, 2), nextion_display_list_get(op, 3));
+    }
+    case NEX_DISPLAY_LIST_OP_PICTURE:
+    {
+        point_t origin = {.x = nextion_display_list_get(op, 0), .y = nextion_display_list_get(op, 1)};
+
+        return nextion_draw_picture(handle, op[5], origin);
+    }
+    case NEX_DISPLAY_LIST_OP_CROP_PICTURE:
+    {
+        point_t destination = {.x = nextion_display_list_get(op, 4), .y = nextion_display_list_get(op, 5)};
+
+        return nextion_draw_crop_picture(handle, op[13], nextion_display_list_get_area(op, 0), destination);
+    }
+    case NEX_DISPLAY_LIST_OP_TEXT:
+    {
+        const font_t font = {.color = nextion_display_list_get(op, 4), .id = op[13]};
+        const background_t background = {.color = nextion_display_list_get(op, 5), .picture_id = op[14], .fill_mode = (background_fill_mode_t)op[15]};
+        const text_alignment_t alignment = {.horizontal = (horizontal_align_t)op[16], .vertical = (vertical_align_t)op[17]};
+        char text[UINT8_MAX + 1];
+
+        memcpy(text, op + 19, op[18]);
+        text[op[18]] = '\0';
+
+        return nextion_draw_text(handle, nextion_display_list_get_area(op, 0), font, background, alignment, text);
+    }
+    default:
+        return NEX_FAIL;
+    }
+}
+
+/**
+ * @brief Store a 16 bits value, little endian.
+ * @param at Where to store it.
+ * @param value Value.
+ * @return Where the next value goes.
+ */
+static uint8_t *nextion_display_list_put(uint8_t *at, uint16_t value)
+{
+    at[0] = (uint8_t)value;
+    at[1] = (uint8_t)(value >> 8);
+
+    return at + 2;
+}
+
+/**
+ * @brief Get a 16 bits argument of a primitive.
+ * @param at Primitive bytes.
+ * @param index Argument index.
+ * @return Value.
+ */
+static uint16_t nextion_display_list_get(const uint8_t *at, size_t index)
+{
+    return (uint16_t)(at[1 + 2 * index] | (at[2 + 2 * index] << 8));
+}
+
+/**
+ * @brief Store an area, as its two corners.
+ * @param at Where to store it.
+ * @param area Area.
+ * @return Where the next value goes.
+ */
+static uint8_t *nextion_display_list_put_area(uint8_t *at, area_t area)
+{
+    at = nextion_display_list_put(at, area.upper_left.x);
+    at = nextion_display_list_put(at, area.upper_left.y);
+    at = nextion_display_list_put(at, area.bottom_right.x);
+
+    return nextion_display_list_put(at, area.bottom_right.y);
+}
+
+/**
+ * @brief Get an area argument of a primitive.
+ * @param at Primitive bytes.
+ * @param index Index of its first argument.
+ * @return Area.
+ */
+static area_t nextion_display_list_get_area(const uint8_t *at, size_t index)
+{
+    area_t area = {
+        .upper_left = {.x = nextion_display_list_get(at, index), .y = nextion_display_list_get(at, index + 1)},
+        .bottom_right = {.x = nextion_display_list_get(at, index + 2), .y = nextion_display_list_get(at, index + 3)}};
+
+    return area;
+}
@@ -1,10 +1,23 @@
+#include <string.h>
 #include "esp32_driver_nextion/nextion.h"
 #include "esp32_driver_nextion/eeprom.h"
 #include "assertion.h"
+#include "eeprom_cache.h"
 
 #define CMP_CHECK_EEPROM_ADDRESS(address) CMP_CHECK((address < NEX_DVC_EEPROM_SIZE), "address error(address > NEX_DVC_EEPROM_MAX_ADDRESS)", NEX_FAIL)
 #define CMP_CHECK_EEPROM_END_ADDRESS(address) CMP_CHECK(((address) < NEX_DVC_EEPROM_SIZE), "address error(end address > NEX_DVC_EEPROM_MAX_ADDRESS)", NEX_FAIL)
 
+/**
+ * @brief Most bytes fetched by a single "rept" filling the cache.
+ */
+#define NEX_EEPROM_CACHE_FETCH_SIZE (4U * NEX_EEPROM_CACHE_BLOCK_SIZE)
+
+static bool nextion_eeprom_write_cached(nextion_t *handle, uint16_t address, const uint8_t *bytes, size_t length, nex_err_t *code);
+static nex_err_t nextion_eeprom_read_cached(nextion_t *handle, uint16_t address, uint8_t *buffer, size_t length);
+static nex_err_t nextion_eeprom_read_device(nextion_t *handle, uint16_t address, uint8_t *buffer, size_t length);
+static nex_err_t nextion_eeprom_flush_cached(nextion_t *handle, nextion_eeprom_cache_t *cache);
+static nex_err_t nextion_eeprom_flush_run(nextion_t *handle, nextion_eeprom_cache_t *cache, uint16_t address, size_t length);
+
 nex_err_t nextion_eeprom_write_text(nextion_t *handle,
                                     uint16_t address,
                                     const char *text,
@@ -15,6 +28,14 @@ nex_err_t nextion_eeprom_write_text(nextion_t *handle,
     CMP_CHECK_EEPROM_END_ADDRESS(address + text_length)
     CMP_CHECK((text != NULL), "text error(NULL)", NEX_FAIL)
 
+    nex_err_t code;
+
+    // The display writes the text with its terminator.
+    if (nextion_eeprom_write_cached(handle, address, (const uint8_t *)text, strlen(text) + 1, &code))
+    {
+        return code;
+    }
+
     return nextion_command_send(handle, "wepo \"%s\",%d", text, address);
 }
 
@@ -24,7 +45,16 @@ nex_err_t nextion_eeprom_write_number(nextion_t *handle,
 {
     CMP_CHECK_HANDLE(handle, NEX_FAIL)
     CMP_CHECK_EEPROM_ADDRESS(address)
-    CMP_CHECK_EEPROM_END_ADDRESS(address + 4)
+    CMP_CHECK_EEPROM_END_ADDRESS(address + 4U)
+
+    // Number: 4 bytes, little endian.
+    const uint8_t bytes[4] = {(uint8_t)value, (uint8_t)((uint32_t)value >> 8), (uint8_t)((uint32_t)value >> 16), (uint8_t)((uint32_t)value >> 24)};
+    nex_err_t code;
+
+    if (nextion_eeprom_write_cached(handle, address, bytes, sizeof(bytes), &code))
+    {
+        return code;
+    }
 
     return nextion_command_send(handle, "wepo %d,%d", value, address);
 }
@@ -49,7 +79,7 @@ nex_err_t nextion_eeprom_read_number(nextion_t *handle,
 {
     CMP_CHECK_HANDLE(handle, NEX_FAIL)
     CMP_CHECK_EEPROM_ADDRESS(address)
-    CMP_CHECK_EEPROM_END_ADDRESS(address + 4)
+    CMP_CHECK_EEPROM_END_ADDRESS(address + 4U)
 
     uint8_t buffer[4];
 
@@ -72,17 +102,93 @@ nex_err_t nextion_eeprom_read_bytes(nextion_t *handle,
     CMP_CHECK_EEPROM_ADDRESS(address)
     CMP_CHECK_EEPROM_END_ADDRESS(address + buffer_length)
 
-    size_t length = buffer_length;
+    if (CONFIG_NEX_EEPROM_CACHE_BLOCKS > 0)
+    {
+        return nextion_eeprom_read_cached(handle, address, buffer, buffer_length);
+    }
 
-    // It is no use updating "buffer_length" because it will always read
-    // exactly what it is asked.
+    return nextion_eeprom_read_device(handle, address, buffer, buffer_length);
+}
+
+nex_err_t nextion_eeprom_flush(nextion_t *handle)
+{
+    CMP_CHECK_HANDLE(handle, NEX_FAIL)
+
+    if (CONFIG_NEX_EEPROM_CACHE_BLOCKS == 0)
+    {
+        return NEX_OK;
+    }
+
+    nextion_eeprom_cache_t *cache = nextion_eeprom_cache_of(handle);
+
+    if (!nextion_eeprom_cache_acquire(cache))
+    {
+        CMP_LOGE("sync error(not acquired)");
+
+        nextion_eeprom_cache_postpone(cache);
+
+        return NEX_FAIL;
+    }
+
+    nex_err_t code = nextion_eeprom_flush_cached(handle, cache);
+
+    nextion_eeprom_cache_release(cache);
+
+    return code;
+}
+
+void nextion_eeprom_flush_on_time(nextion_t *handle)
+{
+    nextion_eeprom_cache_t *cache = nextion_eeprom_cache_of(handle);
+
+    if (!nextion_eeprom_cache_acquire(cache))
+    {
+        // Busy with another operation; tried again later.
+        nextion_eeprom_cache_postpone(cache);
+
+        return;
+    }
+
+    nex_err_t code = nextion_eeprom_flush_cached(handle, cache);
+
+    // Nobody waits for this flush; the next write reports it.
+    if (code != NEX_OK)
+    {
+        cache->flush_result = code;
+    }
+
+    nextion_eeprom_cache_release(cache);
+}
+
+nex_err_t nextion_eeprom_cache_clear(nextion_t *handle)
+{
+    CMP_CHECK_HANDLE(handle, NEX_FAIL)
+
+    nextion_eeprom_cache_t *cache = nextion_eeprom_cache_of(handle);
+
+    CMP_CHECK((nextion_eeprom_cache_acquire(cache)), "sync error(not acquired)", NEX_FAIL)
+
+    nextion_eeprom_cache_invalidate(cache);
+
+    nextion_eeprom_cache_release(cache);
+
+    return NEX_OK;
+}
+
+nex_err_t nextion_eeprom_cache_get_stats(nextion_t *handle, nextion_eeprom_cache_stats_t *stats)
+{
+    CMP_CHECK_HANDLE(handle, NEX_FAIL)
+    CMP_CHECK((stats != NULL), "stats error(NULL)", NEX_FAIL)
+
+    nextion_eeprom_cache_t *cache = nextion_eeprom_cache_of(handle);
+
+    CMP_CHECK((nextion_eeprom_cache_acquire(cache)), "sync error(not acquired)", NEX_FAIL)
+
+    *stats = cache->stats;
+
+    nextion_eeprom_cache_release(cache);
 
-    return nextion_command_send_get_bytes(handle,
-                                          buffer,
-                                          &length,
-                                          "rept %d,%d",
-                                          address,
-                                          length);
+    return NEX_OK;
 }
 
 nex_err_t nextion_eeprom_stream_begin(nextion_t *handle, uint16_t address, size_t value_count)
@@ -92,6 +198,18 @@ nex_err_t nextion_eeprom_stream_begin(nextion_t *handle, uint16_t address, size_
     CMP_CHECK_EEPROM_END_ADDRESS(address + value_count)
     CMP_CHECK((value_count < (NEX_DVC_TRANSPARENT_DATA_MAX_DATA_SIZE - 20)), "value_count error(>=NEX_DVC_TRANSPARENT_DATA_MAX_DATA_SIZE-20)", NEX_FAIL)
 
+    if (CONFIG_NEX_EEPROM_CACHE_BLOCKS > 0)
+    {
+        nextion_eeprom_cache_t *cache = nextion_eeprom_cache_of(handle);
+
+        CMP_CHECK((nextion_eeprom_cache_acquire(cache)), "sync error(not acquired)", NEX_FAIL)
+
+        // The stream replaces whatever the cache holds for its range.
+        nextion_eeprom_cache_discard(cache, address, value_count);
+
+        nextion_eeprom_cache_release(cache);
+    }
+
     return nextion_transparent_data_mode_begin(handle,
                                                value_count,
                                                "wept %d,%d",
@@ -106,9 +224,279 @@ nex_err_t nextion_eeprom_stream_write(nextion_t *handle, uint8_t value)
     return nextion_transparent_data_mode_write(handle, value);
 }
 
+nex_err_t nextion_eeprom_stream_write_buffer(nextion_t *handle, const uint8_t *values, size_t length)
+{
+    CMP_CHECK_HANDLE(handle, NEX_FAIL)
+
+    return nextion_transparent_data_mode_write_buffer(handle, values, length);
+}
+
 nex_err_t nextion_eeprom_stream_end(nextion_t *handle)
 {
     CMP_CHECK_HANDLE(handle, NEX_FAIL)
 
     return nextion_transparent_data_mode_end(handle);
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Keep written bytes in the cache, flushing it first when it is full of written bytes.
+ * @details A failed timed flush is reported here, once.
+ * @param handle Nextion context pointer.
+ * @param address Starting address.
+ * @param bytes Bytes written.
+ * @param length How many bytes.
+ * @param code Location where the result will be stored, when handled.
+ * @return True if handled, false if the bytes must be written to the device right away.
+ */
+static bool nextion_eeprom_write_cached(nextion_t *handle, uint16_t address, const uint8_t *bytes, size_t length, nex_err_t *code)
+{
+    // Let the device refuse what does not fit.
+    if (CONFIG_NEX_EEPROM_CACHE_BLOCKS == 0 || address + length > NEX_DVC_EEPROM_SIZE)
+    {
+        return false;
+    }
+
+    nextion_eeprom_cache_t *cache = nextion_eeprom_cache_of(handle);
+
+    if (!nextion_eeprom_cache_acquire(cache))
+    {
+        CMP_LOGE("sync error(not acquired)");
+
+        *code = NEX_FAIL;
+
+        return true;
+    }
+
+    bool is_handled = true;
+
+    *code = NEX_OK;
+
+    if (!nextion_eeprom_cache_write(cache, address, bytes, length))
+    {
+        *code = nextion_eeprom_flush_cached(handle, cache);
+
+        // Only what is larger than the whole cache does not fit once it is clean.
+        if (*code == NEX_OK && !nextion_eeprom_cache_write(cache, address, bytes, length))
+        {
+            nextion_eeprom_cache_discard(cache, address, length);
+
+            is_handled = false;
+        }
+    }
+
+    // The bytes are kept either way; the caller learns earlier ones are not on the device yet.
+    if (is_handled && *code == NEX_OK && cache->flush_result != NEX_OK)
+    {
+        *code = cache->flush_result;
+        cache->flush_result = NEX_OK;
+    }
+
+    nextion_eeprom_cache_release(cache);
+
+    return is_handled;
+}
+
+/**
+ * @brief Read bytes through the cache, fetching the blocks it misses.
+ * @param handle Nextion context pointer.
+ * @param address Starting address.
+ * @param buffer Location where the bytes will be stored.
+ * @param length How many bytes.
+ * @return NEX_OK if success, otherwise NEX_FAIL.
+ */
+static nex_err_t nextion_eeprom_read_cached(nextion_t *handle, uint16_t address, uint8_t *buffer, size_t length)
+{
+    nextion_eeprom_cache_t *cache = nextion_eeprom_cache_of(handle);
+
+    CMP_CHECK((nextion_eeprom_cache_acquire(cache)), "sync error(not acquired)", NEX_FAIL)
+
+    uint16_t span_address;
+    size_t span_length;
+    nex_err_t code = NEX_OK;
+
+    if (!nextion_eeprom_cache_missing(cache, address, length, &span_address, &span_length))
+    {
+        cache->stats.hits++;
+
+        nextion_eeprom_cache_read(cache, address, buffer, length);
+        nextion_eeprom_cache_release(cache);
+
+        return NEX_OK;
+    }
+
+    cache->stats.misses++;
+
+    // Whole blocks are fetched, so neighbouring reads hit.
+
+    for (size_t done = 0; done < span_length && code == NEX_OK;)
+    {
+        uint8_t chunk[NEX_EEPROM_CACHE_FETCH_SIZE];
+        uint16_t chunk_address = (uint16_t)(span_address + done);
+        size_t chunk_length = span_length - done < sizeof(chunk) ? span_length - done : sizeof(chunk);
+
+        code = nextion_eeprom_read_device(handle, chunk_address, chunk, chunk_length);
+
+        if (code == NEX_OK)
+        {
+            cache->stats.fetches++;
+
+            size_t begin = chunk_address > address ? chunk_address : address;
+            size_t end = chunk_address + chunk_length < address + length ? chunk_address + chunk_length : address + length;
+
+            if (begin < end)
+            {
+                memcpy(buffer + (begin - address), chunk + (begin - chunk_address), end - begin);
+            }
+
+            // Without room the bytes are not kept, but still returned.
+            nextion_eeprom_cache_fill(cache, chunk_address, chunk, chunk_length);
+        }
+
+        done += chunk_length;
+    }
+
+    // Bytes written and not flushed are newer than the device ones.
+    if (code == NEX_OK)
+    {
+        nextion_eeprom_cache_read(cache, address, buffer, length);
+    }
+
+    nextion_eeprom_cache_release(cache);
+
+    return code;
+}
+
+/**
+ * @brief Read bytes from the device.
+ * @param handle Nextion context pointer.
+ * @param address Starting address.
+ * @param buffer Location where the bytes will be stored.
+ * @param buffer_length How many bytes.
+ * @return NEX_OK if success, otherwise NEX_FAIL.
+ */
+static nex_err_t nextion_eeprom_read_device(nextion_t *handle, uint16_t address, uint8_t *buffer, size_t buffer_length)
+{
+    size_t length = buffer_length;
+
+    // It is no use updating "buffer_length" because it will always read
+    // exactly what it is asked.
+
+    // The bytes come as they are; no code nor termination.
+
+    return nextion_command_send_get_raw_bytes(handle,
+                                              buffer,
+                                              &length,
+                                              "rept %d,%d",
+                                              address,
+                                              length);
+}
+
+/**
+ * @brief Write every dirty range back, each in a "wept" stream.
+ * @details Each stream is begun while the display still consumes the previous one;
+ * a range is clean only once the display reported it finished.
+ * @param handle Nextion context pointer.
+ * @param cache Cache pointer; must be held.
+ * @return NEX_OK if success, otherwise NEX_FAIL or any NEX_DVC_ERR_* value.
+ */
+static nex_err_t nextion_eeprom_flush_cached(nextion_t *handle, nextion_eeprom_cache_t *cache)
+{
+    uint16_t from = 0;
+    uint16_t address;
+    size_t length;
+    uint16_t open_address = 0;
+    size_t open_length = 0; // Zero if no stream waits for its end.
+    nex_err_t code = NEX_OK;
+
+    while (nextion_eeprom_cache_next_run(cache, from, NEX_EEPROM_STREAM_MAX_VALUES, &address, &length))
+    {
+        if (open_length == 0)
+        {
+            code = nextion_transparent_data_mode_begin(handle, length, "wept %d,%d", address, length);
+        }
+        else
+        {
+            nex_err_t end_code;
+
+            code = nextion_transparent_data_mode_restart(handle, &end_code, length, "wept %d,%d", address, length);
+
+            if (end_code == NEX_OK)
+            {
+                nextion_eeprom_cache_clean(cache, open_address, open_length);
+            }
+
+            open_length = 0;
+        }
+
+        if (code == NEX_OK)
+        {
+            code = nextion_eeprom_flush_run(handle, cache, address, length);
+        }
+
+        if (code != NEX_OK)
+        {
+            break;
+        }
+
+        open_address = address;
+        open_length = length;
+        from = (uint16_t)(address + length);
+    }
+
+    if (open_length > 0)
+    {
+        code = nextion_transparent_data_mode_end(handle);
+
+        if (code == NEX_OK)
+        {
+            nextion_eeprom_cache_clean(cache, open_address, open_length);
+        }
+    }
+
+    // What was not flushed is tried again later.
+    if (code != NEX_OK)
+    {
+        CMP_LOGE("failed flushing EEPROM cache");
+
+        cache->stats.flush_failures++;
+
+        nextion_eeprom_cache_postpone(cache);
+    }
+    else
+    {
+        // Every written byte reached the device, those of a failed timed flush included.
+        cache->flush_result = NEX_OK;
+    }
+
+    return code;
+}
+
+/**
+ * @brief Write the bytes of a range onto the begun stream.
+ * @param handle Nextion context pointer.
+ * @param cache Cache pointer; must be held.
+ * @param address Starting address.
+ * @param length How many bytes; all must be known.
+ * @return NEX_OK if success, otherwise NEX_FAIL.
+ */
+static nex_err_t nextion_eeprom_flush_run(nextion_t *handle, nextion_eeprom_cache_t *cache, uint16_t address, size_t length)
+{
+    for (size_t done = 0; done < length;)
+    {
+        uint8_t piece[NEX_EEPROM_CACHE_BLOCK_SIZE];
+        size_t count = length - done < sizeof(piece) ? length - done : sizeof(piece);
+
+        nextion_eeprom_cache_read(cache, (uint16_t)(address + done), piece, count);
+
+        nex_err_t code = nextion_transparent_data_mode_write_buffer(handle, piece, count);
+
+        if (code != NEX_OK)
+        {
+            return code;
+        }
+
+        done += count;
+    }
+
+    return NEX_OK;
+}
@@ -0,0 +1,470 @@
+#include <string.h>
+#include "eeprom_cache.h"
+
+#define NEX_EEPROM_CACHE_BLOCK_COUNT (CONFIG_NEX_EEPROM_CACHE_BLOCKS > 0 ? CONFIG_NEX_EEPROM_CACHE_BLOCKS : 1)
+#define NEX_EEPROM_CACHE_INDEX_COUNT (NEX_DVC_EEPROM_SIZE / NEX_EEPROM_CACHE_BLOCK_SIZE)
+
+static nextion_eeprom_cache_block_t *nextion_eeprom_cache_find(nextion_eeprom_cache_t *cache, uint16_t index);
+static bool nextion_eeprom_cache_reserve(nextion_eeprom_cache_t *cache, uint16_t address, size_t length);
+static nextion_eeprom_cache_block_t *nextion_eeprom_cache_take(nextion_eeprom_cache_t *cache, uint16_t index, uint16_t first, uint16_t last);
+static uint32_t nextion_eeprom_cache_mask(size_t offset, size_t count);
+static void nextion_eeprom_cache_update_dirty(nextion_eeprom_cache_t *cache);
+
+void nextion_eeprom_cache_init(nextion_eeprom_cache_t *cache)
+{
+    memset(cache, 0, sizeof(nextion_eeprom_cache_t));
+
+    cache->sync = xSemaphoreCreateMutex();
+    cache->flush_result = NEX_OK;
+
+    portMUX_INITIALIZE(&cache->lock);
+}
+
+void nextion_eeprom_cache_deinit(nextion_eeprom_cache_t *cache)
+{
+    vSemaphoreDelete(cache->sync);
+}
+
+bool nextion_eeprom_cache_acquire(nextion_eeprom_cache_t *cache)
+{
+    return xSemaphoreTake(cache->sync, pdMS_TO_TICKS(CONFIG_NEX_UART_MUTEX_WAIT_TIME_MS)) == pdTRUE;
+}
+
+void nextion_eeprom_cache_release(nextion_eeprom_cache_t *cache)
+{
+    xSemaphoreGive(cache->sync);
+}
+
+bool nextion_eeprom_cache_read(nextion_eeprom_cache_t *cache, uint16_t address, uint8_t *bytes, size_t length)
+{
+    bool is_known = true;
+
+    for (size_t done = 0; done < length;)
+    {
+        size_t offset = (address + done) % NEX_EEPROM_CACHE_BLOCK_SIZE;
+        size_t count = NEX_EEPROM_CACHE_BLOCK_SIZE - offset < length - done ? NEX_EEPROM_CACHE_BLOCK_SIZE - offset : length - done;
+        nextion_eeprom_cache_block_t *block = nextion_eeprom_cache_find(cache, (address + done) / NEX_EEPROM_CACHE_BLOCK_SIZE);
+
+        if (block == NULL)
+        {
+            is_known = false;
+        }
+        else
+        {
+            block->last_used = ++cache->clock;
+
+            for (size_t i = 0; i < count; i++)
+            {
+                if (block->valid & (1U << (offset + i)))
+                {
+                    bytes[done + i] = block->bytes[offset + i];
+                }
+                else
+                {
+                    is_known = false;
+                }
+            }
+        }
+
+        done += count;
+    }
+
+    return is_known;
+}
+
+bool nextion_eeprom_cache_missing(nextion_eeprom_cache_t *cache,
+                                  uint16_t address,
+                                  size_t length,
+                                  uint16_t *span_address,
+                                  size_t *span_length)
+{
+    size_t first = NEX_EEPROM_CACHE_INDEX_COUNT;
+    size_t last = 0;
+
+    for (size_t done = 0; done < length;)
+    {
+        size_t offset = (address + done) % NEX_EEPROM_CACHE_BLOCK_SIZE;
+        size_t count = NEX_EEPROM_CACHE_BLOCK_SIZE - offset < length - done ? NEX_EEPROM_CACHE_BLOCK_SIZE - offset : length - done;
+        size_t index = (address + done) / NEX_EEPROM_CACHE_BLOCK_SIZE;
+        nextion_eeprom_cache_block_t *block = nextion_eeprom_cache_find(cache, (uint16_t)index);
+        uint32_t mask = nextion_eeprom_cache_mask(offset, count);
+
+        if (block == NULL || (block->valid & mask) != mask)
+        {
+            first = index < first ? index : first;
+            last = index;
+        }
+
+        done += count;
+    }
+
+    if (first == NEX_EEPROM_CACHE_INDEX_COUNT)
+    {
+        return false;
+    }
+
+    *span_address = (uint16_t)(first * NEX_EEPROM_CACHE_BLOCK_SIZE);
+    *span_length = (last - first + 1) * NEX_EEPROM_CACHE_BLOCK_SIZE;
+
+    return true;
+}
+
+bool nextion_eeprom_cache_fill(nextion_eeprom_cache_t *cache, uint16_t address, const uint8_t *bytes, size_t length)
+{
+    if (CONFIG_NEX_EEPROM_CACHE_BLOCKS == 0 || !nextion_eeprom_cache_reserve(cache, address, length))
+    {
+        return false;
+    }
+
+    for (size_t done = 0; done < length;)
+    {
+        size_t offset = (address + done) % NEX_EEPROM_CACHE_BLOCK_SIZE;
+        size_t count = NEX_EEPROM_CACHE_BLOCK_SIZE - offset < length - done ? NEX_EEPROM_CACHE_BLOCK_SIZE - offset : length - done;
+        nextion_eeprom_cache_block_t *block = nextion_eeprom_cache_find(cache, (address + done) / NEX_EEPROM_CACHE_BLOCK_SIZE);
+
+        for (size_t i = 0; i < count; i++)
+        {
+            // Written bytes are newer than the device ones.
+            if (!(block->dirty & (1U << (offset + i))))
+            {
+                block->bytes[offset + i] = bytes[done + i];
+            }
+        }
+
+        block->valid |= nextion_eeprom_cache_mask(offset, count);
+        done += count;
+    }
+
+    return true;
+}
+
+bool nextion_eeprom_cache_write(nextion_eeprom_cache_t *cache, uint16_t address, const uint8_t *bytes, size_t length)
+{
+    if (CONFIG_NEX_EEPROM_CACHE_BLOCKS == 0 || !nextion_eeprom_cache_reserve(cache, address, length))
+    {
+        return false;
+    }
+
+    for (size_t done = 0; done < length;)
+    {
+        size_t offset = (address + done) % NEX_EEPROM_CACHE_BLOCK_SIZE;
+        size_t count = NEX_EEPROM_CACHE_BLOCK_SIZE - offset < length - done ? NEX_EEPROM_CACHE_BLOCK_SIZE - offset : length - done;
+        nextion_eeprom_cache_block_t *block = nextion_eeprom_cache_find(cache, (address + done) / NEX_EEPROM_CACHE_BLOCK_SIZE);
+        uint32_t mask = nextion_eeprom_cache_mask(offset, count);
+
+        memcpy(block->bytes + offset, bytes + done, count);
+
+        block->valid |= mask;
+        block->dirty |= mask;
+        done += count;
+    }
+
+    portENTER_CRITICAL(&cache->lock);
+
+    bool was_dirty = cache->is_dirty;
+
+    if (!was_dirty)
+    {
+        cache->is_dirty = true;
+        cache->dirty_since = xTaskGetTickCount();
+    }
+
+    portEXIT_CRITICAL(&cache->lock);
+
+    // The flusher waits forever while the cache is clean.
+    if (!was_dirty && cache->flusher != NULL)
+    {
+        xTaskNotifyGive(cache->flusher);
+    }
+
+    return true;
+}
+
+void nextion_eeprom_cache_discard(nextion_eeprom_cache_t *cache, uint16_t address, size_t length)
+{
+    for (size_t done = 0; done < length;)
+    {
+        size_t offset = (address + done) % NEX_EEPROM_CACHE_BLOCK_SIZE;
+        size_t count = NEX_EEPROM_CACHE_BLOCK_SIZE - offset < length - done ? NEX_EEPROM_CACHE_BLOCK_SIZE - offset : length - done;
+        nextion_eeprom_cache_block_t *block = nextion_eeprom_cache_find(cache, (address + done) / NEX_EEPROM_CACHE_BLOCK_SIZE);
+
+        if (block != NULL)
+        {
+            block->valid &= ~nextion_eeprom_cache_mask(offset, count);
+            block->dirty &= block->valid;
+            block->is_used = block->valid != 0;
+        }
+
+        done += count;
+    }
+
+    nextion_eeprom_cache_update_dirty(cache);
+}
+
+void nextion_eeprom_cache_invalidate(nextion_eeprom_cache_t *cache)
+{
+    for (size_t i = 0; i < NEX_EEPROM_CACHE_BLOCK_COUNT; i++)
+    {
+        cache->blocks[i].is_used = false;
+        cache->blocks[i].valid = 0;
+        cache->blocks[i].dirty = 0;
+    }
+
+    nextion_eeprom_cache_update_dirty(cache);
+}
+
+bool nextion_eeprom_cache_next_run(nextion_eeprom_cache_t *cache,
+                                   uint16_t from,
+                                   size_t max_length,
+                                   uint16_t *address,
+                                   size_t *length)
+{
+    // Block of each index, so bytes are looked up in address order.
+    nextion_eeprom_cache_block_t *blocks[NEX_EEPROM_CACHE_INDEX_COUNT] = {NULL};
+
+    for (size_t i = 0; i < NEX_EEPROM_CACHE_BLOCK_COUNT; i++)
+    {
+        if (cache->blocks[i].is_used)
+        {
+            blocks[cache->blocks[i].index] = &cache->blocks[i];
+        }
+    }
+
+    size_t begin = NEX_DVC_EEPROM_SIZE;
+
+    for (size_t a = from; a < NEX_DVC_EEPROM_SIZE && begin == NEX_DVC_EEPROM_SIZE; a++)
+    {
+        nextion_eeprom_cache_block_t *block = blocks[a / NEX_EEPROM_CACHE_BLOCK_SIZE];
+
+        if (block != NULL && (block->dirty & (1U << (a % NEX_EEPROM_CACHE_BLOCK_SIZE))))
+        {
+            begin = a;
+        }
+    }
+
+    if (begin == NEX_DVC_EEPROM_SIZE)
+    {
+        return false;
+    }
+
+    size_t end = begin + 1;
+
+    for (size_t a = begin + 1; a < NEX_DVC_EEPROM_SIZE && a - begin < max_length; a++)
+    {
+        nextion_eeprom_cache_block_t *block = blocks[a / NEX_EEPROM_CACHE_BLOCK_SIZE];
+        uint32_t bit = 1U << (a % NEX_EEPROM_CACHE_BLOCK_SIZE);
+
+        // An unknown byte cannot be written back.
+        if (block == NULL || !(block->valid & bit))
+        {
+            break;
+        }
+
+        if (block->dirty & bit)
+        {
+            end = a + 1;
+        }
+    }
+
+    *address = (uint16_t)begin;
+    *length = end - begin;
+
+    return true;
+}
+
+void nextion_eeprom_cache_clean(nextion_eeprom_cache_t *cache, uint16_t address, size_t length)
+{
+    for (size_t done = 0; done < length;)
+    {
+        size_t offset = (address + done) % NEX_EEPROM_CACHE_BLOCK_SIZE;
+        size_t count = NEX_EEPROM_CACHE_BLOCK_SIZE - offset < length - done ? NEX_EEPROM_CACHE_BLOCK_SIZE - offset : length - done;
+        nextion_eeprom_cache_block_t *block = nextion_eeprom_cache_find(cache, (address + done) / NEX_EEPROM_CACHE_BLOCK_SIZE);
+
+        if (block != NULL)
+        {
+            block->dirty &= ~nextion_eeprom_cache_mask(offset, count);
+        }
+
+        done += count;
+    }
+
+    cache->stats.flushes++;
+
+    nextion_eeprom_cache_update_dirty(cache);
+}
+
+void nextion_eeprom_cache_postpone(nextion_eeprom_cache_t *cache)
+{
+    portENTER_CRITICAL(&cache->lock);
+
+    cache->dirty_since = xTaskGetTickCount();
+
+    portEXIT_CRITICAL(&cache->lock);
+}
+
+bool nextion_eeprom_cache_flush_wait(nextion_eeprom_cache_t *cache, TickType_t *wait)
+{
+    if (CONFIG_NEX_EEPROM_CACHE_FLUSH_DELAY_MS == 0)
+    {
+        return false;
+    }
+
+    const TickType_t delay = pdMS_TO_TICKS(CONFIG_NEX_EEPROM_CACHE_FLUSH_DELAY_MS);
+
+    portENTER_CRITICAL(&cache->lock);
+
+    bool is_dirty = cache->is_dirty;
+    TickType_t elapsed = xTaskGetTickCount() - cache->dirty_since;
+
+    portEXIT_CRITICAL(&cache->lock);
+
+    *wait = elapsed >= delay ? 0 : delay - elapsed;
+
+    return is_dirty;
+}
+
+/**
+ * @brief Find the block of an index.
+ * @param cache Cache pointer.
+ * @param index Block index.
+ * @return Block pointer, or NULL if not cached.
+ */
+static nextion_eeprom_cache_block_t *nextion_eeprom_cache_find(nextion_eeprom_cache_t *cache, uint16_t index)
+{
+    for (size_t i = 0; i < NEX_EEPROM_CACHE_BLOCK_COUNT; i++)
+    {
+        if (cache->blocks[i].is_used && cache->blocks[i].index == index)
+        {
+            return &cache->blocks[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Make sure every block of a range is cached, replacing clean blocks.
+ * @details Nothing is replaced unless all of them fit.
+ * @param cache Cache pointer.
+ * @param address Starting address.
+ * @param length How many bytes.
+ * @return True if they are cached, false if there is not enough room.
+ */
+static bool nextion_eeprom_cache_reserve(nextion_eeprom_cache_t *cache, uint16_t address, size_t length)
+{
+    if (length == 0)
+    {
+        return true;
+    }
+
+    uint16_t first = address / NEX_EEPROM_CACHE_BLOCK_SIZE;
+    uint16_t last = (uint16_t)((address + length - 1) / NEX_EEPROM_CACHE_BLOCK_SIZE);
+    size_t needed = 0;
+    size_t available = 0;
+
+    for (uint16_t index = first; index <= last; index++)
+    {
+        needed += nextion_eeprom_cache_find(cache, index) == NULL;
+    }
+
+    for (size_t i = 0; i < NEX_EEPROM_CACHE_BLOCK_COUNT; i++)
+    {
+        const nextion_eeprom_cache_block_t *block = &cache->blocks[i];
+
+        available += !block->is_used || (block->dirty == 0 && (block->index < first || block->index > last));
+    }
+
+    if (needed > available)
+    {
+        return false;
+    }
+
+    for (uint16_t index = first; index <= last; index++)
+    {
+        nextion_eeprom_cache_block_t *block = nextion_eeprom_cache_find(cache, index);
+
+        if (block == NULL)
+        {
+            block = nextion_eeprom_cache_take(cache, index, first, last);
+        }
+
+        block->last_used = ++cache->clock;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Take a free block, or the least recently used clean one, for an index.
+ * @param cache Cache pointer.
+ * @param index Block index.
+ * @param first First index of the range being reserved; its blocks are not taken.
+ * @param last Last index of the range being reserved.
+ * @return Block pointer; there must be one.
+ */
+static nextion_eeprom_cache_block_t *nextion_eeprom_cache_take(nextion_eeprom_cache_t *cache, uint16_t index, uint16_t first, uint16_t last)
+{
+    nextion_eeprom_cache_block_t *victim = NULL;
+
+    for (size_t i = 0; i < NEX_EEPROM_CACHE_BLOCK_COUNT; i++)
+    {
+        nextion_eeprom_cache_block_t *block = &cache->blocks[i];
+
+        if (!block->is_used)
+        {
+            victim = block;
+            break;
+        }
+
+        if (block->dirty == 0 && (block->index < first || block->index > last) &&
+            (victim == NULL || block->last_used < victim->last_used))
+        {
+            victim = block;
+        }
+    }
+
+    if (victim->is_used)
+    {
+        cache->stats.evictions++;
+    }
+
+    victim->index = index;
+    victim->valid = 0;
+    victim->dirty = 0;
+    victim->is_used = true;
+
+    return victim;
+}
+
+/**
+ * @brief Get the mask of a range of bytes inside a block.
+ * @param offset First byte.
+ * @param count How many bytes.
+ * @return Mask.
+ */
+static uint32_t nextion_eeprom_cache_mask(size_t offset, size_t count)
+{
+    uint32_t bits = count >= 32 ? 0xFFFFFFFFU : (1U << count) - 1U;
+
+    return bits << offset;
+}
+
+/**
+ * @brief Clear the dirty state when no written byte is left.
+ * @param cache Cache pointer.
+ */
+static void nextion_eeprom_cache_update_dirty(nextion_eeprom_cache_t *cache)
+{
+    bool is_dirty = false;
+
+    for (size_t i = 0; i < NEX_EEPROM_CACHE_BLOCK_COUNT; i++)
+    {
+        is_dirty = is_dirty || (cache->blocks[i].is_used && cache->blocks[i].dirty != 0);
+    }
+
+    portENTER_CRITICAL(&cache->lock);
+
+    cache->is_dirty = is_dirty;
+
+    portEXIT_CRITICAL(&cache->lock);
+}
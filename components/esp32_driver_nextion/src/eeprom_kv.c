@@ -0,0 +1,602 @@
+#include <stdlib.h>
+#include <string.h>
+#include "esp32_driver_nextion/eeprom.h"
+#include "esp32_driver_nextion/eeprom_kv.h"
+#include "assertion.h"
+
+/**
+ * @brief Half header: "NK", generation and CRC, little endian.
+ */
+#define NEX_EEPROM_KV_HEADER_LENGTH 6U
+
+/**
+ * @brief Record bytes besides its key and value: key length, value length and CRC.
+ */
+#define NEX_EEPROM_KV_RECORD_OVERHEAD 4U
+
+/**
+ * @brief Set on the key length of a record removing its key.
+ */
+#define NEX_EEPROM_KV_RECORD_ERASED 0x80U
+
+/**
+ * @brief Value of erased EEPROM bytes; ends the log.
+ */
+#define NEX_EEPROM_KV_ERASED_BYTE 0xFFU
+
+struct nextion_eeprom_kv_t
+{
+    nextion_t *handle;                         /*!< Driver the area is read and written through. */
+    uint16_t address;                          /*!< Starting address of the area. */
+    size_t half_size;                          /*!< Size of each half. */
+    uint8_t *area;                             /*!< Both halves, read at mount. */
+    uint8_t *image;                            /*!< Copy of the half holding the log. */
+    uint8_t *spare;                            /*!< Where the other half is built when compacting. */
+    uint8_t active;                            /*!< Half holding the log. */
+    uint16_t generation;                       /*!< Generation of the log; incremented by every compaction. */
+    bool is_formatted;                         /*!< If the log half has a header; false until the first change. */
+    size_t tail;                               /*!< Where the next record goes. */
+    uint16_t records[NEX_EEPROM_KV_MAX_KEYS];  /*!< Offset of the live record of each key, in "image". */
+    size_t count;                              /*!< How many keys there are. */
+};
+
+static uint16_t nextion_eeprom_kv_crc(uint16_t crc, const uint8_t *bytes, size_t length);
+static bool nextion_eeprom_kv_header_parse(const uint8_t *half, uint16_t *generation);
+static void nextion_eeprom_kv_header_build(uint8_t *half, uint16_t generation);
+static size_t nextion_eeprom_kv_record_parse(const uint8_t *half, size_t offset, size_t half_size, uint16_t generation);
+static size_t nextion_eeprom_kv_record_build(uint8_t *record,
+                                             uint16_t generation,
+                                             const char *key,
+                                             size_t key_length,
+                                             const uint8_t *value,
+                                             size_t value_length,
+                                             bool is_erased);
+static size_t nextion_eeprom_kv_find(const nextion_eeprom_kv_t *kv, const uint8_t *half, const char *key, size_t key_length);
+static bool nextion_eeprom_kv_index(nextion_eeprom_kv_t *kv, const uint8_t *half, size_t offset);
+static nex_err_t nextion_eeprom_kv_change(nextion_eeprom_kv_t *kv, const char *key, const uint8_t *value, size_t value_length, bool is_erased);
+static nex_err_t nextion_eeprom_kv_rewrite(nextion_eeprom_kv_t *kv, const char *key, const uint8_t *value, size_t value_length, bool is_erased);
+static nex_err_t nextion_eeprom_kv_write(nextion_eeprom_kv_t *kv, uint8_t half, size_t offset, const uint8_t *bytes, size_t length);
+
+nextion_eeprom_kv_t *nextion_eeprom_kv_mount(nextion_t *handle, uint16_t address, size_t size)
+{
+    CMP_CHECK_HANDLE(handle, NULL)
+    CMP_CHECK((size >= NEX_EEPROM_KV_MIN_SIZE), "size error(<NEX_EEPROM_KV_MIN_SIZE)", NULL)
+    CMP_CHECK((size % 2 == 0), "size error(odd)", NULL)
+    CMP_CHECK((address + size <= NEX_DVC_EEPROM_SIZE), "size error(end address > NEX_DVC_EEPROM_MAX_ADDRESS)", NULL)
+
+    nextion_eeprom_kv_t *kv = (nextion_eeprom_kv_t *)calloc(1, sizeof(nextion_eeprom_kv_t));
+
+    CMP_CHECK((kv != NULL), "kv error(no memory)", NULL)
+
+    kv->handle = handle;
+    kv->address = address;
+    kv->half_size = size / 2;
+    kv->area = (uint8_t *)malloc(size);
+
+    if (kv->area == NULL)
+    {
+        CMP_LOGE("failed allocating area copy");
+
+        free(kv);
+
+        return NULL;
+    }
+
+    // One read for the whole area; everything else comes from the copy.
+    if (nextion_eeprom_read_bytes(handle, address, kv->area, size) != NEX_OK)
+    {
+        CMP_LOGE("failed reading area");
+
+        nextion_eeprom_kv_unmount(kv);
+
+        return NULL;
+    }
+
+    uint16_t generations[2];
+    bool is_valid[2];
+
+    for (uint8_t h = 0; h < 2; h++)
+    {
+        is_valid[h] = nextion_eeprom_kv_header_parse(kv->area + h * kv->half_size, &generations[h]);
+    }
+
+    if (is_valid[0] || is_valid[1])
+    {
+        // Generations wrap; the newest is the one ahead.
+        kv->active = !is_valid[0] || (is_valid[1] && (int16_t)(generations[1] - generations[0]) > 0);
+        kv->generation = generations[kv->active];
+        kv->is_formatted = true;
+    }
+    else
+    {
+        // The first change compacts into half 0, with generation 0.
+        kv->active = 1;
+        kv->generation = 0xFFFFU;
+        kv->is_formatted = false;
+    }
+
+    kv->image = kv->area + kv->active * kv->half_size;
+    kv->spare = kv->area + (1 - kv->active) * kv->half_size;
+    kv->tail = NEX_EEPROM_KV_HEADER_LENGTH;
+
+    if (kv->is_formatted)
+    {
+        size_t length;
+
+        // The log ends at the first record that does not check; e.g. erased
+        // bytes, an interrupted append or a record of an older generation.
+        while ((length = nextion_eeprom_kv_record_parse(kv->image, kv->tail, kv->half_size, kv->generation)) > 0 &&
+               nextion_eeprom_kv_index(kv, kv->image, kv->tail))
+        {
+            kv->tail += length;
+        }
+    }
+
+    return kv;
+}
+
+bool nextion_eeprom_kv_unmount(nextion_eeprom_kv_t *kv)
+{
+    CMP_CHECK((kv != NULL), "kv error(NULL)", false)
+
+    free(kv->area);
+    free(kv);
+
+    return true;
+}
+
+nex_err_t nextion_eeprom_kv_get(nextion_eeprom_kv_t *kv,
+                                const char *key,
+                                void *value,
+                                size_t value_capacity,
+                                size_t *value_length)
+{
+    CMP_CHECK((kv != NULL), "kv error(NULL)", NEX_FAIL)
+    CMP_CHECK((key != NULL), "key error(NULL)", NEX_FAIL)
+
+    size_t i = nextion_eeprom_kv_find(kv, kv->image, key, strlen(key));
+
+    if (i == kv->count)
+    {
+        return NEX_FAIL;
+    }
+
+    const uint8_t *record = kv->image + kv->records[i];
+    size_t key_length = record[0];
+    size_t length = record[1];
+
+    CMP_CHECK((length <= value_capacity), "value_capacity error(too small)", NEX_FAIL)
+    CMP_CHECK((value != NULL || length == 0), "value error(NULL)", NEX_FAIL)
+
+    if (length > 0)
+    {
+        memcpy(value, record + 2 + key_length, length);
+    }
+
+    if (value_length != NULL)
+    {
+        *value_length = length;
+    }
+
+    return NEX_OK;
+}
+
+nex_err_t nextion_eeprom_kv_set(nextion_eeprom_kv_t *kv, const char *key, const void *value, size_t value_length)
+{
+    CMP_CHECK((kv != NULL), "kv error(NULL)", NEX_FAIL)
+    CMP_CHECK((key != NULL), "key error(NULL)", NEX_FAIL)
+    CMP_CHECK((value != NULL || value_length == 0), "value error(NULL)", NEX_FAIL)
+    CMP_CHECK((value_length <= NEX_EEPROM_KV_MAX_VALUE_LENGTH), "value_length error(>NEX_EEPROM_KV_MAX_VALUE_LENGTH)", NEX_FAIL)
+
+    size_t key_length = strlen(key);
+
+    CMP_CHECK((key_length > 0), "key error(empty)", NEX_FAIL)
+    CMP_CHECK((key_length <= NEX_EEPROM_KV_MAX_KEY_LENGTH), "key error(longer than NEX_EEPROM_KV_MAX_KEY_LENGTH)", NEX_FAIL)
+
+    size_t i = nextion_eeprom_kv_find(kv, kv->image, key, key_length);
+
+    if (i < kv->count)
+    {
+        const uint8_t *record = kv->image + kv->records[i];
+
+        if (record[1] == value_length && (value_length == 0 || memcmp(record + 2 + key_length, value, value_length) == 0))
+        {
+            return NEX_OK;
+        }
+    }
+    else
+    {
+        CMP_CHECK((kv->count < NEX_EEPROM_KV_MAX_KEYS), "kv error(NEX_EEPROM_KV_MAX_KEYS reached)", NEX_FAIL)
+    }
+
+    return nextion_eeprom_kv_change(kv, key, (const uint8_t *)value, value_length, false);
+}
+
+nex_err_t nextion_eeprom_kv_erase(nextion_eeprom_kv_t *kv, const char *key)
+{
+    CMP_CHECK((kv != NULL), "kv error(NULL)", NEX_FAIL)
+    CMP_CHECK((key != NULL), "key error(NULL)", NEX_FAIL)
+
+    size_t key_length = strlen(key);
+
+    if (nextion_eeprom_kv_find(kv, kv->image, key, key_length) == kv->count)
+    {
+        return NEX_OK;
+    }
+
+    return nextion_eeprom_kv_change(kv, key, NULL, 0, true);
+}
+
+nex_err_t nextion_eeprom_kv_compact(nextion_eeprom_kv_t *kv)
+{
+    CMP_CHECK((kv != NULL), "kv error(NULL)", NEX_FAIL)
+
+    return nextion_eeprom_kv_rewrite(kv, NULL, NULL, 0, false);
+}
+
+size_t nextion_eeprom_kv_count(nextion_eeprom_kv_t *kv)
+{
+    CMP_CHECK((kv != NULL), "kv error(NULL)", 0)
+
+    return kv->count;
+}
+
+/**
+ * @brief Update a CRC-16/CCITT-FALSE.
+ * @param crc CRC so far; 0xFFFF to start.
+ * @param bytes Bytes.
+ * @param length How many bytes.
+ * @return Updated CRC.
+ */
+static uint16_t nextion_eeprom_kv_crc(uint16_t crc, const uint8_t *bytes, size_t length)
+{
+    for (size_t i = 0; i < length; i++)
+    {
+        crc ^= (uint16_t)(bytes[i] << 8);
+
+        for (int b = 0; b < 8; b++)
+        {
+            crc = (crc & 0x8000U) ? (uint16_t)((crc << 1) ^ 0x1021U) : (uint16_t)(crc << 1);
+        }
+    }
+
+    return crc;
+}
+
+/**
+ * @brief Check the header of a half.
+ * @param half Half bytes.
+ * @param generation Location where the generation will be stored.
+ * @return True if valid, otherwise false.
+ */
+static bool nextion_eeprom_kv_header_parse(const uint8_t *half, uint16_t *generation)
+{
+    uint16_t crc = (uint16_t)(half[4] | (half[5] << 8));
+
+    if (half[0] != 'N' || half[1] != 'K' || nextion_eeprom_kv_crc(0xFFFFU, half, 4) != crc)
+    {
+        return false;
+    }
+
+    *generation = (uint16_t)(half[2] | (half[3] << 8));
+
+    return true;
+}
+
+/**
+ * @brief Build the header of a half.
+ * @param half Half bytes.
+ * @param generation Generation.
+ */
+static void nextion_eeprom_kv_header_build(uint8_t *half, uint16_t generation)
+{
+    half[0] = 'N';
+    half[1] = 'K';
+    half[2] = (uint8_t)generation;
+    half[3] = (uint8_t)(generation >> 8);
+
+    uint16_t crc = nextion_eeprom_kv_crc(0xFFFFU, half, 4);
+
+    half[4] = (uint8_t)crc;
+    half[5] = (uint8_t)(crc >> 8);
+}
+
+/**
+ * @brief Check a record.
+ * @details The CRC covers the generation, so records left by an older log in the
+ * same half do not check.
+ * @param half Half bytes.
+ * @param offset Record offset.
+ * @param half_size Half size.
+ * @param generation Generation of the log.
+ * @return Record length, or zero if there is no valid record.
+ */
+static size_t nextion_eeprom_kv_record_parse(const uint8_t *half, size_t offset, size_t half_size, uint16_t generation)
+{
+    if (offset + NEX_EEPROM_KV_RECORD_OVERHEAD > half_size || half[offset] == NEX_EEPROM_KV_ERASED_BYTE)
+    {
+        return 0;
+    }
+
+    size_t key_length = half[offset] & ~NEX_EEPROM_KV_RECORD_ERASED;
+    size_t value_length = half[offset + 1];
+    size_t length = key_length + value_length + NEX_EEPROM_KV_RECORD_OVERHEAD;
+
+    if (key_length == 0 || key_length > NEX_EEPROM_KV_MAX_KEY_LENGTH ||
+        value_length > NEX_EEPROM_KV_MAX_VALUE_LENGTH || offset + length > half_size)
+    {
+        return 0;
+    }
+
+    const uint8_t prefix[2] = {(uint8_t)generation, (uint8_t)(generation >> 8)};
+    uint16_t crc = nextion_eeprom_kv_crc(nextion_eeprom_kv_crc(0xFFFFU, prefix, 2), half + offset, length - 2);
+
+    if ((uint16_t)(half[offset + length - 2] | (half[offset + length - 1] << 8)) != crc)
+    {
+        return 0;
+    }
+
+    return length;
+}
+
+/**
+ * @brief Build a record.
+ * @param record Location where the record will be stored.
+ * @param generation Generation of the log it goes in.
+ * @param key Key.
+ * @param key_length Key length.
+ * @param value Value.
+ * @param value_length Value length.
+ * @param is_erased If it removes the key.
+ * @return Record length.
+ */
+static size_t nextion_eeprom_kv_record_build(uint8_t *record,
+                                             uint16_t generation,
+                                             const char *key,
+                                             size_t key_length,
+                                             const uint8_t *value,
+                                             size_t value_length,
+                                             bool is_erased)
+{
+    size_t length = key_length + value_length + NEX_EEPROM_KV_RECORD_OVERHEAD;
+
+    record[0] = (uint8_t)(key_length | (is_erased ? NEX_EEPROM_KV_RECORD_ERASED : 0));
+    record[1] = (uint8_t)value_length;
+
+    memcpy(record + 2, key, key_length);
+
+    if (value_length > 0)
+    {
+        memcpy(record + 2 + key_length, value, value_length);
+    }
+
+    const uint8_t prefix[2] = {(uint8_t)generation, (uint8_t)(generation >> 8)};
+    uint16_t crc = nextion_eeprom_kv_crc(nextion_eeprom_kv_crc(0xFFFFU, prefix, 2), record, length - 2);
+
+    record[length - 2] = (uint8_t)crc;
+    record[length - 1] = (uint8_t)(crc >> 8);
+
+    return length;
+}
+
+/**
+ * @brief Find the live record of a key.
+ * @param kv Store pointer.
+ * @param half Half the record offsets point into.
+ * @param key Key.
+ * @param key_length Key length.
+ * @return Index in "records", or "count" if missing.
+ */
+static size_t nextion_eeprom_kv_find(const nextion_eeprom_kv_t *kv, const uint8_t *half, const char *key, size_t key_length)
+{
+    for (size_t i = 0; i < kv->count; i++)
+    {
+        const uint8_t *record = half + kv->records[i];
+
+        if (record[0] == key_length && memcmp(record + 2, key, key_length) == 0)
+        {
+            return i;
+        }
+    }
+
+    return kv->count;
+}
+
+/**
+ * @brief Apply a valid record to the index.
+ * @param kv Store pointer.
+ * @param half Half holding the record.
+ * @param offset Record offset.
+ * @return True if applied, false if there was no room for its key.
+ */
+static bool nextion_eeprom_kv_index(nextion_eeprom_kv_t *kv, const uint8_t *half, size_t offset)
+{
+    const uint8_t *record = half + offset;
+    size_t key_length = record[0] & ~NEX_EEPROM_KV_RECORD_ERASED;
+    size_t i = nextion_eeprom_kv_find(kv, half, (const char *)record + 2, key_length);
+
+    if (record[0] & NEX_EEPROM_KV_RECORD_ERASED)
+    {
+        if (i < kv->count)
+        {
+            // Order is kept, so compaction keeps the keys as they were added.
+            memmove(&kv->records[i], &kv->records[i + 1], (kv->count - i - 1) * sizeof(kv->records[0]));
+            kv->count--;
+        }
+
+        return true;
+    }
+
+    if (i == kv->count)
+    {
+        if (kv->count == NEX_EEPROM_KV_MAX_KEYS)
+        {
+            return false;
+        }
+
+        kv->count++;
+    }
+
+    kv->records[i] = (uint16_t)offset;
+
+    return true;
+}
+
+/**
+ * @brief Append a change to the log, or compact when it does not fit.
+ * @param kv Store pointer.
+ * @param key Key.
+ * @param value Value.
+ * @param value_length Value length.
+ * @param is_erased If the key is removed.
+ * @return NEX_OK if success, otherwise NEX_FAIL.
+ */
+static nex_err_t nextion_eeprom_kv_change(nextion_eeprom_kv_t *kv, const char *key, const uint8_t *value, size_t value_length, bool is_erased)
+{
+    size_t key_length = strlen(key);
+
+    if (!kv->is_formatted || kv->tail + key_length + value_length + NEX_EEPROM_KV_RECORD_OVERHEAD > kv->half_size)
+    {
+        return nextion_eeprom_kv_rewrite(kv, key, value, value_length, is_erased);
+    }
+
+    size_t length = nextion_eeprom_kv_record_build(kv->image + kv->tail, kv->generation, key, key_length, value, value_length, is_erased);
+    nex_err_t code = nextion_eeprom_kv_write(kv, kv->active, kv->tail, kv->image + kv->tail, length);
+
+    // A failed append is overwritten by the next one.
+    if (code == NEX_OK)
+    {
+        nextion_eeprom_kv_index(kv, kv->image, kv->tail);
+
+        kv->tail += length;
+    }
+
+    return code;
+}
+
+/**
+ * @brief Write the live records, and an optional change, as a new log in the other half.
+ * @details The header goes last; until it is written, the current log stays the newest.
+ * @param kv Store pointer.
+ * @param key Key changed; NULL for none.
+ * @param value Value.
+ * @param value_length Value length.
+ * @param is_erased If the key is removed.
+ * @return NEX_OK if success, otherwise NEX_FAIL.
+ */
+static nex_err_t nextion_eeprom_kv_rewrite(nextion_eeprom_kv_t *kv, const char *key, const uint8_t *value, size_t value_length, bool is_erased)
+{
+    const uint16_t generation = (uint16_t)(kv->generation + 1);
+    const uint8_t target = 1 - kv->active;
+    size_t key_length = key != NULL ? strlen(key) : 0;
+    size_t changed = key != NULL ? nextion_eeprom_kv_find(kv, kv->image, key, key_length) : kv->count;
+    size_t tail = NEX_EEPROM_KV_HEADER_LENGTH;
+
+    for (size_t i = 0; i <= kv->count; i++)
+    {
+        const char *record_key;
+        size_t record_key_length;
+        const uint8_t *record_value;
+        size_t record_value_length;
+
+        // The change replaces its key's record, or goes last when the key is new.
+        if (key != NULL && i == changed)
+        {
+            if (is_erased)
+            {
+                continue;
+            }
+
+            record_key = key;
+            record_key_length = key_length;
+            record_value = value;
+            record_value_length = value_length;
+        }
+        else if (i < kv->count)
+        {
+            const uint8_t *record = kv->image + kv->records[i];
+
+            record_key = (const char *)record + 2;
+            record_key_length = record[0];
+            record_value = record + 2 + record[0];
+            record_value_length = record[1];
+        }
+        else
+        {
+            continue;
+        }
+
+        CMP_CHECK((tail + record_key_length + record_value_length + NEX_EEPROM_KV_RECORD_OVERHEAD <= kv->half_size), "kv error(full)", NEX_FAIL)
+
+        tail += nextion_eeprom_kv_record_build(kv->spare + tail,
+                                               generation,
+                                               record_key,
+                                               record_key_length,
+                                               record_value,
+                                               record_value_length,
+                                               false);
+    }
+
+    nextion_eeprom_kv_header_build(kv->spare, generation);
+
+    nex_err_t code = NEX_OK;
+
+    if (tail > NEX_EEPROM_KV_HEADER_LENGTH)
+    {
+        code = nextion_eeprom_kv_write(kv, target, NEX_EEPROM_KV_HEADER_LENGTH, kv->spare + NEX_EEPROM_KV_HEADER_LENGTH, tail - NEX_EEPROM_KV_HEADER_LENGTH);
+    }
+
+    if (code == NEX_OK)
+    {
+        code = nextion_eeprom_kv_write(kv, target, 0, kv->spare, NEX_EEPROM_KV_HEADER_LENGTH);
+    }
+
+    if (code != NEX_OK)
+    {
+        return code;
+    }
+
+    uint8_t *image = kv->image;
+
+    kv->image = kv->spare;
+    kv->spare = image;
+    kv->active = target;
+    kv->generation = generation;
+    kv->is_formatted = true;
+    kv->count = 0;
+
+    for (kv->tail = NEX_EEPROM_KV_HEADER_LENGTH; kv->tail < tail;)
+    {
+        nextion_eeprom_kv_index(kv, kv->image, kv->tail);
+
+        kv->tail += nextion_eeprom_kv_record_parse(kv->image, kv->tail, kv->half_size, kv->generation);
+    }
+
+    return NEX_OK;
+}
+
+/**
+ * @brief Write bytes of a half to the device, in a single stream.
+ * @param kv Store pointer.
+ * @param half Half written.
+ * @param offset Offset in the half.
+ * @param bytes Bytes.
+ * @param length How many bytes.
+ * @return NEX_OK if success, otherwise NEX_FAIL.
+ */
+static nex_err_t nextion_eeprom_kv_write(nextion_eeprom_kv_t *kv, uint8_t half, size_t offset, const uint8_t *bytes, size_t length)
+{
+    uint16_t address = (uint16_t)(kv->address + half * kv->half_size + offset);
+    nex_err_t code = nextion_eeprom_stream_begin(kv->handle, address, length);
+
+    if (code != NEX_OK)
+    {
+        return code;
+    }
+
+    code = nextion_eeprom_stream_write_buffer(kv->handle, bytes, length);
+
+    nex_err_t end_code = nextion_eeprom_stream_end(kv->handle);
+
+    return code != NEX_OK ? code : end_code;
+}
@@ -0,0 +1,30 @@
+#include <string.h>
+#include "event_ring.h"
+
+void nextion_event_ring_init(nextion_event_ring_t *ring)
+{
+    nextion_ring_init(&ring->ring, ring->entries, sizeof(nextion_event_ring_entry_t), CONFIG_NEX_EVENT_QUEUE_SIZE);
+
+    atomic_init(&ring->dropped, 0);
+}
+
+bool nextion_event_ring_push(nextion_event_ring_t *ring, const uint8_t *frame, size_t length)
+{
+    nextion_event_ring_entry_t entry;
+
+    if (length > NEX_DVC_EVT_MAX_RESPONSE_LENGTH)
+    {
+        length = NEX_DVC_EVT_MAX_RESPONSE_LENGTH;
+    }
+
+    memcpy(entry.frame, frame, length);
+
+    entry.length = (uint8_t)length;
+
+    return nextion_ring_push(&ring->ring, &entry, 1) == 1;
+}
+
+bool nextion_event_ring_pop(nextion_event_ring_t *ring, nextion_event_ring_entry_t *entry)
+{
+    return nextion_ring_pop(&ring->ring, entry, 1) == 1;
+}
@@ -0,0 +1,335 @@
+#include <string.h>
+#include "esp32_driver_nextion/font_metrics.h"
+#include "assertion.h"
+
+/**
+ * @brief Header length of a ".zi" file; the font names follow it.
+ */
+#define NEX_FONT_METRICS_ZI_HEADER_LENGTH 0x2CU
+
+/**
+ * @brief Header offsets: line height, first and last character codes,
+ * file version, length of the font names and character count.
+ */
+#define NEX_FONT_METRICS_ZI_HEIGHT 0x07U
+#define NEX_FONT_METRICS_ZI_FIRST 0x0AU
+#define NEX_FONT_METRICS_ZI_LAST 0x0BU
+#define NEX_FONT_METRICS_ZI_VERSION 0x10U
+#define NEX_FONT_METRICS_ZI_NAMES_LENGTH 0x11U
+#define NEX_FONT_METRICS_ZI_COUNT 0x24U
+
+/**
+ * @brief Supported file version.
+ */
+#define NEX_FONT_METRICS_ZI_SUPPORTED_VERSION 6U
+
+/**
+ * @brief Character entry: code, width, kerning, data offset and data length.
+ */
+#define NEX_FONT_METRICS_ZI_ENTRY_LENGTH 10U
+
+/**
+ * @brief Appended to truncated texts.
+ */
+#define NEX_FONT_METRICS_ELLIPSIS "..."
+
+static const uint8_t NEX_FONT_METRICS_ZI_MAGIC[] = {0x04, 0xFF, 0x00, 0x0A};
+
+static uint8_t nextion_font_metrics_char_width(const nextion_font_metrics_t *metrics, char c);
+static size_t nextion_font_metrics_skip_spaces(const char *text, size_t index);
+
+nex_err_t nextion_font_metrics_parse(const uint8_t *zi,
+                                     size_t length,
+                                     uint8_t *widths,
+                                     size_t capacity,
+                                     nextion_font_metrics_t *metrics)
+{
+    CMP_CHECK((zi != NULL), "zi error(NULL)", NEX_FAIL)
+    CMP_CHECK((widths != NULL), "widths error(NULL)", NEX_FAIL)
+    CMP_CHECK((metrics != NULL), "metrics error(NULL)", NEX_FAIL)
+    CMP_CHECK((length >= NEX_FONT_METRICS_ZI_HEADER_LENGTH), "length error(no header)", NEX_FAIL)
+    CMP_CHECK((memcmp(zi, NEX_FONT_METRICS_ZI_MAGIC, sizeof(NEX_FONT_METRICS_ZI_MAGIC)) == 0), "zi error(not a font)", NEX_FAIL)
+    CMP_CHECK((zi[NEX_FONT_METRICS_ZI_VERSION] == NEX_FONT_METRICS_ZI_SUPPORTED_VERSION), "zi error(unsupported version)", NEX_FAIL)
+
+    const uint8_t first = zi[NEX_FONT_METRICS_ZI_FIRST];
+    const uint8_t last = zi[NEX_FONT_METRICS_ZI_LAST];
+
+    CMP_CHECK((first <= last), "zi error(no character)", NEX_FAIL)
+    CMP_CHECK((capacity >= (size_t)(last - first) + 1), "capacity error(too small)", NEX_FAIL)
+
+    const uint32_t count = (uint32_t)zi[NEX_FONT_METRICS_ZI_COUNT] |
+                           ((uint32_t)zi[NEX_FONT_METRICS_ZI_COUNT + 1] << 8) |
+                           ((uint32_t)zi[NEX_FONT_METRICS_ZI_COUNT + 2] << 16) |
+                           ((uint32_t)zi[NEX_FONT_METRICS_ZI_COUNT + 3] << 24);
+    const size_t table = NEX_FONT_METRICS_ZI_HEADER_LENGTH + zi[NEX_FONT_METRICS_ZI_NAMES_LENGTH];
+
+    CMP_CHECK((count <= NEX_FONT_METRICS_MAX_CHARACTERS), "zi error(not a single-byte font)", NEX_FAIL)
+    CMP_CHECK((length >= table + count * NEX_FONT_METRICS_ZI_ENTRY_LENGTH), "length error(truncated table)", NEX_FAIL)
+
+    uint16_t top = first;
+
+    memset(widths, 0, (size_t)(last - first) + 1);
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        const uint8_t *entry = &zi[table + i * NEX_FONT_METRICS_ZI_ENTRY_LENGTH];
+        const uint16_t code = (uint16_t)entry[0] | ((uint16_t)entry[1] << 8);
+
+        CMP_CHECK((code >= first && code <= last), "zi error(character out of range)", NEX_FAIL)
+
+        widths[code - first] = entry[2];
+
+        if (code > top)
+        {
+            top = code;
+        }
+    }
+
+    metrics->height = zi[NEX_FONT_METRICS_ZI_HEIGHT];
+    metrics->first = first;
+    // Characters past the last one the font has are left out of the table.
+    metrics->count = (uint16_t)(top - first) + 1;
+    metrics->widths = widths;
+
+    return NEX_OK;
+}
+
+uint16_t nextion_font_metrics_text_width(const nextion_font_metrics_t *metrics, const char *text)
+{
+    CMP_CHECK((metrics != NULL), "metrics error(NULL)", 0)
+    CMP_CHECK((text != NULL), "text error(NULL)", 0)
+
+    uint32_t width = 0;
+
+    for (size_t i = 0; text[i] != '\0'; i++)
+    {
+        width += nextion_font_metrics_char_width(metrics, text[i]);
+    }
+
+    return width > UINT16_MAX ? UINT16_MAX : (uint16_t)width;
+}
+
+uint16_t nextion_font_metrics_text_height(const nextion_font_metrics_t *metrics, const char *text, uint16_t max_width)
+{
+    CMP_CHECK((metrics != NULL), "metrics error(NULL)", 0)
+    CMP_CHECK((text != NULL), "text error(NULL)", 0)
+
+    uint32_t lines = 0;
+    size_t start = 0;
+
+    while (text[start] != '\0')
+    {
+        size_t next;
+
+        nextion_font_metrics_wrap(metrics, &text[start], max_width, &next);
+
+        start += next;
+        lines++;
+    }
+
+    const uint32_t height = lines * metrics->height;
+
+    return height > UINT16_MAX ? UINT16_MAX : (uint16_t)height;
+}
+
+size_t nextion_font_metrics_fit(const nextion_font_metrics_t *metrics, const char *text, uint16_t max_width)
+{
+    CMP_CHECK((metrics != NULL), "metrics error(NULL)", 0)
+    CMP_CHECK((text != NULL), "text error(NULL)", 0)
+
+    uint32_t width = 0;
+    size_t i;
+
+    for (i = 0; text[i] != '\0'; i++)
+    {
+        width += nextion_font_metrics_char_width(metrics, text[i]);
+
+        if (width > max_width)
+        {
+            break;
+        }
+    }
+
+    return i;
+}
+
+size_t nextion_font_metrics_wrap(const nextion_font_metrics_t *metrics, const char *text, uint16_t max_width, size_t *next)
+{
+    CMP_CHECK((metrics != NULL), "metrics error(NULL)", 0)
+    CMP_CHECK((text != NULL), "text error(NULL)", 0)
+    CMP_CHECK((next != NULL), "next error(NULL)", 0)
+
+    uint32_t width = 0;
+    size_t space = 0;
+    bool has_space = false;
+    size_t i;
+
+    for (i = 0; text[i] != '\0'; i++)
+    {
+        if (text[i] == '\n')
+        {
+            *next = i + 1;
+
+            return i;
+        }
+
+        if (text[i] == ' ')
+        {
+            space = i;
+            has_space = true;
+        }
+
+        width += nextion_font_metrics_char_width(metrics, text[i]);
+
+        if (width > max_width)
+        {
+            size_t line;
+
+            if (has_space && space > 0)
+            {
+                line = space;
+            }
+            else
+            {
+                // A word longer than a line; at least a character, to go on.
+                line = i > 0 ? i : 1;
+            }
+
+            *next = nextion_font_metrics_skip_spaces(text, line);
+
+            while (line > 0 && text[line - 1] == ' ')
+            {
+                line--;
+            }
+
+            return line;
+        }
+    }
+
+    *next = i;
+
+    return i;
+}
+
+size_t nextion_font_metrics_truncate(const nextion_font_metrics_t *metrics,
+                                     const char *text,
+                                     uint16_t max_width,
+                                     char *buffer,
+                                     size_t capacity)
+{
+    CMP_CHECK((metrics != NULL), "metrics error(NULL)", 0)
+    CMP_CHECK((text != NULL), "text error(NULL)", 0)
+    CMP_CHECK((buffer != NULL && capacity > 0), "buffer error(NULL or empty)", 0)
+
+    size_t length = strlen(text);
+    size_t kept = nextion_font_metrics_fit(metrics, text, max_width);
+    const char *suffix = "";
+
+    if (kept < length)
+    {
+        const uint16_t ellipsis_width = nextion_font_metrics_text_width(metrics, NEX_FONT_METRICS_ELLIPSIS);
+
+        // Without room for the ellipsis, the text is only cut.
+        if (ellipsis_width <= max_width)
+        {
+            kept = nextion_font_metrics_fit(metrics, text, max_width - ellipsis_width);
+            suffix = NEX_FONT_METRICS_ELLIPSIS;
+        }
+    }
+
+    const size_t suffix_length = strlen(suffix);
+
+    if (kept + suffix_length > capacity - 1)
+    {
+        kept = capacity - 1 > suffix_length ? capacity - 1 - suffix_length : 0;
+    }
+
+    length = kept;
+
+    memcpy(buffer, text, kept);
+
+    for (size_t i = 0; i < suffix_length && length < capacity - 1; i++)
+    {
+        buffer[length++] = suffix[i];
+    }
+
+    buffer[length] = '\0';
+
+    return length;
+}
+
+area_t nextion_font_metrics_text_area(const nextion_font_metrics_t *metrics,
+                                      area_t area,
+                                      text_alignment_t alignment,
+                                      const char *text)
+{
+    area_t covered = {.upper_left = area.upper_left, .bottom_right = area.upper_left};
+
+    CMP_CHECK((metrics != NULL), "metrics error(NULL)", covered)
+    CMP_CHECK((text != NULL), "text error(NULL)", covered)
+
+    const uint16_t area_width = area.bottom_right.x > area.upper_left.x ? area.bottom_right.x - area.upper_left.x : 0;
+    const uint16_t area_height = area.bottom_right.y > area.upper_left.y ? area.bottom_right.y - area.upper_left.y : 0;
+    uint16_t width = nextion_font_metrics_text_width(metrics, text);
+    uint16_t height = width > 0 ? metrics->height : 0;
+
+    width = width < area_width ? width : area_width;
+    height = height < area_height ? height : area_height;
+
+    if (alignment.horizontal == HORZ_ALIGN_CENTER)
+    {
+        covered.upper_left.x += (area_width - width) / 2;
+    }
+    else if (alignment.horizontal == HORZ_ALIGN_RIGHT)
+    {
+        covered.upper_left.x += area_width - width;
+    }
+
+    if (alignment.vertical == VERT_ALIGN_CENTER)
+    {
+        covered.upper_left.y += (area_height - height) / 2;
+    }
+    else if (alignment.vertical == VERT_ALIGN_BOTTOM)
+    {
+        covered.upper_left.y += area_height - height;
+    }
+
+    covered.bottom_right.x = covered.upper_left.x + width;
+    covered.bottom_right.y = covered.upper_left.y + height;
+
+    return covered;
+}
+
+/**
+ * @brief Get the width of a character.
+ * @param metrics Font metrics.
+ * @param c Character.
+ * @return Width; 0 when the font lacks it.
+ */
+static uint8_t nextion_font_metrics_char_width(const nextion_font_metrics_t *metrics, char c)
+{
+    const uint8_t code = (uint8_t)c;
+
+    if (code < metrics->first || code - metrics->first >= metrics->count)
+    {
+        return 0;
+    }
+
+    return metrics->widths[code - metrics->first];
+}
+
+/**
+ * @brief Skip the spaces at an index.
+ * @param text Text.
+ * @param index Index.
+ * @return Index of the first other character.
+ */
+static size_t nextion_font_metrics_skip_spaces(const char *text, size_t index)
+{
+    while (text[index] == ' ')
+    {
+        index++;
+    }
+
+    return index;
+}
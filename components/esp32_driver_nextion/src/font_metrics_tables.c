@@ -0,0 +1,65 @@
+#include "esp32_driver_nextion/font_metrics.h"
+
+// Generated with the host tool "nextion_font_table" from "nextion/Sans Serif 16.zi",
+// "nextion/Sans Serif 32.zi" and "test/hmi/arial.zi"; regenerate when a font changes.
+
+static const uint8_t NEX_FONT_METRICS_SANS_SERIF_16_WIDTHS[] = {
+    4, 4, 5, 8, 8, 12, 9, 3, 5, 5, 6, 8, 4, 5, 4, 4,
+    8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 4, 4, 8, 8, 8, 8,
+    14, 9, 9, 10, 10, 9, 9, 11, 10, 4, 7, 9, 8, 12, 10, 11,
+    9, 11, 10, 9, 9, 10, 9, 13, 9, 9, 9, 4, 4, 4, 7, 8,
+    5, 8, 8, 7, 8, 8, 4, 8, 8, 4, 4, 7, 4, 12, 8, 8,
+    8, 8, 5, 7, 4, 8, 7, 10, 7, 7, 7, 5, 4, 5, 8, 8,
+    4, 4, 4, 4, 4, 1, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+    4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+    4, 4, 8, 8, 8, 8, 4, 8, 5, 10, 5, 8, 8, 1, 10, 7,
+    6, 8, 5, 5, 5, 8, 8, 4, 5, 5, 5, 8, 12, 12, 12, 8,
+    9, 9, 9, 9, 9, 9, 14, 10, 9, 9, 9, 9, 4, 4, 4, 4,
+    10, 10, 11, 11, 11, 11, 11, 8, 11, 10, 10, 10, 10, 9, 9, 9,
+    8, 8, 8, 8, 8, 8, 12, 7, 8, 8, 8, 8, 4, 4, 4, 4,
+    8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 7, 8, 7,
+};
+
+const nextion_font_metrics_t NEX_FONT_METRICS_SANS_SERIF_16 = {
+    .height = 16,
+    .first = 0x20,
+    .count = sizeof(NEX_FONT_METRICS_SANS_SERIF_16_WIDTHS),
+    .widths = NEX_FONT_METRICS_SANS_SERIF_16_WIDTHS};
+
+static const uint8_t NEX_FONT_METRICS_SANS_SERIF_32_WIDTHS[] = {
+    8, 8, 10, 16, 16, 25, 19, 6, 10, 10, 11, 17, 8, 10, 8, 8,
+    16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 8, 8, 17, 17, 17, 16,
+    28, 19, 19, 20, 20, 19, 17, 22, 20, 8, 14, 19, 16, 23, 20, 22,
+    19, 22, 20, 19, 17, 20, 19, 26, 19, 19, 17, 8, 8, 8, 13, 16,
+    10, 16, 16, 14, 16, 16, 8, 16, 16, 7, 7, 14, 7, 23, 16, 16,
+    16, 16, 10, 14, 8, 16, 14, 20, 14, 14, 14, 10, 8, 10, 17, 16,
+    9, 9, 9, 9, 8, 1, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+    9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+    8, 8, 16, 16, 16, 16, 8, 16, 10, 21, 11, 16, 17, 1, 21, 14,
+    11, 17, 10, 10, 10, 16, 15, 8, 10, 10, 11, 16, 23, 23, 23, 16,
+    19, 19, 19, 19, 19, 19, 28, 20, 19, 19, 19, 19, 8, 8, 8, 8,
+    20, 20, 22, 22, 22, 22, 22, 17, 22, 20, 20, 20, 20, 19, 19, 17,
+    16, 16, 16, 16, 16, 16, 25, 14, 16, 16, 16, 16, 7, 7, 7, 7,
+    16, 16, 16, 16, 16, 16, 16, 17, 16, 16, 16, 16, 16, 14, 16, 14,
+};
+
+const nextion_font_metrics_t NEX_FONT_METRICS_SANS_SERIF_32 = {
+    .height = 32,
+    .first = 0x20,
+    .count = sizeof(NEX_FONT_METRICS_SANS_SERIF_32_WIDTHS),
+    .widths = NEX_FONT_METRICS_SANS_SERIF_32_WIDTHS};
+
+static const uint8_t NEX_FONT_METRICS_ARIAL_16_WIDTHS[] = {
+    4, 4, 5, 8, 8, 12, 9, 3, 5, 5, 6, 8, 4, 5, 4, 4,
+    8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 4, 4, 8, 8, 8, 8,
+    14, 9, 9, 10, 10, 9, 9, 11, 10, 4, 7, 9, 8, 12, 10, 11,
+    9, 11, 10, 9, 9, 10, 9, 13, 9, 9, 9, 4, 4, 4, 7, 8,
+    5, 8, 8, 7, 8, 8, 4, 8, 8, 3, 3, 7, 3, 12, 8, 8,
+    8, 8, 5, 7, 4, 8, 7, 10, 7, 7, 7, 5, 4, 5, 8,
+};
+
+const nextion_font_metrics_t NEX_FONT_METRICS_ARIAL_16 = {
+    .height = 16,
+    .first = 0x20,
+    .count = sizeof(NEX_FONT_METRICS_ARIAL_16_WIDTHS),
+    .widths = NEX_FONT_METRICS_ARIAL_16_WIDTHS};
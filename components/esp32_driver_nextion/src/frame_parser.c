@@ -0,0 +1,181 @@
+#include <string.h>
+#include "esp32_driver_nextion/base/constants.h"
+#include "esp32_driver_nextion/base/codes.h"
+#include "frame_parser.h"
+
+static bool nextion_frame_parser_append(nextion_frame_parser_t *parser, uint8_t byte);
+static bool nextion_frame_parser_complete(nextion_frame_parser_t *parser);
+
+void nextion_frame_parser_reset(nextion_frame_parser_t *parser)
+{
+    parser->length = 0;
+    parser->expected_length = 0;
+    parser->ends_found = 0;
+    parser->state = NEX_FRAME_PARSER_IDLE;
+    parser->is_truncated = false;
+}
+
+bool nextion_frame_parser_feed(nextion_frame_parser_t *parser, uint8_t byte)
+{
+    switch (parser->state)
+    {
+    case NEX_FRAME_PARSER_IDLE:
+        nextion_frame_parser_reset(parser);
+
+        parser->frame[0] = byte;
+        parser->length = 1;
+
+        if (byte == NEX_DVC_EVT_HARDWARE_START_RESET)
+        {
+            // 0x00 is both "instruction failed" (0x00 0xFF 0xFF 0xFF)
+            // and "started or reset" (0x00 0x00 0x00 0xFF 0xFF 0xFF).
+            parser->state = NEX_FRAME_PARSER_AMBIGUOUS;
+
+            return false;
+        }
+
+        parser->expected_length = nextion_frame_parser_length_by_code(byte);
+        parser->state = parser->expected_length > 0 ? NEX_FRAME_PARSER_FIXED : NEX_FRAME_PARSER_VARIABLE;
+
+        return false;
+    case NEX_FRAME_PARSER_AMBIGUOUS:
+        parser->expected_length = byte == NEX_DVC_CMD_END_VALUE ? NEX_DVC_CMD_ACK_LENGTH : 6;
+        parser->state = NEX_FRAME_PARSER_FIXED;
+
+        return nextion_frame_parser_append(parser, byte);
+    case NEX_FRAME_PARSER_FIXED:
+    case NEX_FRAME_PARSER_VARIABLE:
+        return nextion_frame_parser_append(parser, byte);
+    case NEX_FRAME_PARSER_RESYNC:
+    default:
+        parser->discarded++;
+        parser->ends_found = byte == NEX_DVC_CMD_END_VALUE ? parser->ends_found + 1 : 0;
+
+        if (parser->ends_found == NEX_DVC_CMD_END_LENGTH)
+        {
+            nextion_frame_parser_reset(parser);
+        }
+
+        return false;
+    }
+}
+
+bool nextion_frame_parser_is_busy(const nextion_frame_parser_t *parser)
+{
+    return parser->state != NEX_FRAME_PARSER_IDLE;
+}
+
+size_t nextion_frame_parser_length_by_code(uint8_t code)
+{
+    switch (code)
+    {
+    case NEX_DVC_EVT_TOUCH_OCCURRED:
+        return 7;
+    case NEX_DVC_RSP_SENDME_RESULT:
+        return 5;
+    case NEX_DVC_EVT_TOUCH_COORDINATE_AWAKE:
+    case NEX_DVC_EVT_TOUCH_COORDINATE_ASLEEP:
+        return 9;
+    case NEX_DVC_RSP_GET_NUMBER:
+        return 8;
+    case NEX_DVC_RSP_GET_STRING:
+        return 0;
+    case NEX_DVC_EVT_HARDWARE_AUTO_SLEEP:
+    case NEX_DVC_EVT_HARDWARE_AUTO_WAKE:
+    case NEX_DVC_EVT_HARDWARE_READY:
+    case NEX_DVC_EVT_HARDWARE_UPGRADE:
+    case NEX_DVC_RSP_TRANSPARENT_DATA_FINISHED:
+    case NEX_DVC_RSP_TRANSPARENT_DATA_READY:
+        return NEX_DVC_CMD_ACK_LENGTH;
+    default:
+        // Instruction results and error codes.
+        if (code <= NEX_DVC_ERR_REFERENCE_NAME_TOO_LONG)
+        {
+            return NEX_DVC_CMD_ACK_LENGTH;
+        }
+
+        return 0;
+    }
+}
+
+/**
+ * @brief Append a byte to the current frame, completing it when possible.
+ * @param parser Parser pointer.
+ * @param byte Received byte.
+ * @return True if the frame was completed, otherwise false.
+ */
+static bool nextion_frame_parser_append(nextion_frame_parser_t *parser, uint8_t byte)
+{
+    // Past the buffer size, only termination bytes are kept; the frame
+    // is still read until its end, but its payload is truncated.
+    if (parser->length < CONFIG_NEX_UART_RECV_FRAME_BUFFER_SIZE - NEX_DVC_CMD_END_LENGTH ||
+        (byte == NEX_DVC_CMD_END_VALUE && parser->length < CONFIG_NEX_UART_RECV_FRAME_BUFFER_SIZE))
+    {
+        parser->frame[parser->length] = byte;
+    }
+    else
+    {
+        parser->is_truncated = true;
+    }
+
+    parser->length++;
+    parser->ends_found = byte == NEX_DVC_CMD_END_VALUE ? parser->ends_found + 1 : 0;
+
+    if (parser->state == NEX_FRAME_PARSER_FIXED)
+    {
+        if (parser->length < parser->expected_length)
+        {
+            return false;
+        }
+
+        if (parser->ends_found >= NEX_DVC_CMD_END_LENGTH)
+        {
+            return nextion_frame_parser_complete(parser);
+        }
+
+        // Not terminated where it should; drop it and wait for
+        // the next termination. Trailing termination bytes count.
+
+        size_t ends_found = parser->ends_found;
+
+        parser->discarded += parser->length;
+
+        nextion_frame_parser_reset(parser);
+
+        parser->state = NEX_FRAME_PARSER_RESYNC;
+        parser->ends_found = ends_found;
+
+        return false;
+    }
+
+    if (parser->ends_found < NEX_DVC_CMD_END_LENGTH)
+    {
+        return false;
+    }
+
+    return nextion_frame_parser_complete(parser);
+}
+
+/**
+ * @brief Finish the current frame, making sure it ends with a termination.
+ * @param parser Parser pointer.
+ * @return Always true.
+ */
+static bool nextion_frame_parser_complete(nextion_frame_parser_t *parser)
+{
+    const uint8_t END_SEQUENCE[NEX_DVC_CMD_END_LENGTH] = {NEX_DVC_CMD_END_SEQUENCE};
+
+    if (parser->length > CONFIG_NEX_UART_RECV_FRAME_BUFFER_SIZE)
+    {
+        parser->length = CONFIG_NEX_UART_RECV_FRAME_BUFFER_SIZE;
+    }
+
+    if (parser->is_truncated)
+    {
+        memcpy(parser->frame + parser->length - NEX_DVC_CMD_END_LENGTH, END_SEQUENCE, NEX_DVC_CMD_END_LENGTH);
+    }
+
+    parser->state = NEX_FRAME_PARSER_IDLE;
+
+    return true;
+}
@@ -1,10 +1,21 @@
 #include <malloc.h>
+#include <string.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/semphr.h"
+#include "esp_timer.h"
 #include "esp32_driver_nextion/nextion.h"
 #include "esp32_driver_nextion/system.h"
+#include "esp32_driver_nextion/eeprom.h"
 #include "assertion.h"
 #include "config.h"
+#include "frame_parser.h"
+#include "component_cache.h"
+#include "eeprom_cache.h"
+#include "event_ring.h"
+#include "command_builder.h"
+#include "command_send.h"
+#include "transport_stats.h"
+#include "wire_capture.h"
 
 #define CMP_CHECK_SEND_COMMAND_HANDLE_STATE(handle)                                \
     CMP_CHECK_HANDLE(handle, NEX_FAIL)                                             \
@@ -12,15 +23,184 @@
     CMP_CHECK((handle->is_initialized), "driver error(not initialized)", NEX_FAIL) \
     CMP_CHECK((handle->in_transparent_data_mode == false), "state error(in transparent data mode)", NEX_FAIL)
 
+/**
+ * @brief Time to wait for the UART task to complete a synchronous command.
+ * @details Every command ahead in the queue can take up to a response wait time.
+ */
+#define NEX_COMMAND_COMPLETION_WAIT_TIME_MS (CONFIG_NEX_UART_RECV_WAIT_TIME_MS * (CONFIG_NEX_UART_COMMAND_QUEUE_SIZE + 2))
+
+/**
+ * @brief How long after a command timed out a response is still taken as its own (ms).
+ */
+#define NEX_COMMAND_LATE_WAIT_TIME_MS CONFIG_NEX_UART_RECV_WAIT_TIME_MS
+
+/**
+ * @brief Command used to check that the display understands what is sent at the current baud rate.
+ */
+#define NEX_LINK_PROBE_COMMAND "bkcmd=3"
+
+/**
+ * @brief Bytes exchanged by a probe: the command, its termination and the ACK.
+ */
+#define NEX_LINK_PROBE_BYTES (sizeof(NEX_LINK_PROBE_COMMAND) - 1 + NEX_DVC_CMD_END_LENGTH + NEX_DVC_CMD_ACK_LENGTH)
+
+/**
+ * @brief How many times a probe is tried before the link is considered broken.
+ * @details The first response after a baud rate change can arrive garbled.
+ */
+#define NEX_LINK_PROBE_ATTEMPTS 2
+
+/**
+ * @brief How many probes are timed to measure the effective throughput.
+ */
+#define NEX_LINK_MEASURE_COUNT 8
+
+/**
+ * @brief Time the display takes to apply a new baud rate.
+ */
+#define NEX_LINK_SETTLE_TIME_MS 50
+
+/**
+ * @brief Stack size of the UART task.
+ */
+#define NEX_UART_TASK_STACK_SIZE 2048
+
+/**
+ * @brief Stack size of the task flushing the EEPROM cache on time.
+ */
+#define NEX_EEPROM_FLUSH_TASK_STACK_SIZE 2048
+
+/**
+ * @brief Priority of the task flushing the EEPROM cache on time.
+ */
+#define NEX_EEPROM_FLUSH_TASK_PRIORITY 1
+
+/**
+ * @brief How many events the UART driver queues.
+ */
+#define NEX_UART_EVENT_QUEUE_SIZE 10
+
+/**
+ * @brief How many times a UART queue is emptied to join or leave the queue set.
+ * @details Both need an empty queue; the UART interrupt can post in between.
+ */
+#define NEX_UART_QUEUE_SET_ATTEMPTS 3
+
+/**
+ * @brief How often the UART task retries queueing an event while the event queue is full (ms).
+ */
+#define NEX_EVENT_RETRY_TIME_MS 10
+
+/**
+ * @brief Baud rates supported by the display, from the fastest.
+ */
+static const uint32_t NEX_LINK_BAUD_RATES[] = {
+    NEXTION_BAUD_RATE_921600,
+    NEXTION_BAUD_RATE_512000,
+    NEXTION_BAUD_RATE_256000,
+    NEXTION_BAUD_RATE_250000,
+    NEXTION_BAUD_RATE_230400,
+    NEXTION_BAUD_RATE_115200,
+    NEXTION_BAUD_RATE_57600,
+    NEXTION_BAUD_RATE_38400,
+    NEXTION_BAUD_RATE_31250,
+    NEXTION_BAUD_RATE_19200,
+    NEXTION_BAUD_RATE_9600,
+    NEXTION_BAUD_RATE_4800,
+    NEXTION_BAUD_RATE_2400};
+
+#define NEX_LINK_BAUD_RATE_COUNT (sizeof(NEX_LINK_BAUD_RATES) / sizeof(NEX_LINK_BAUD_RATES[0]))
+
+/**
+ * @brief Format standing for a command already built; told apart by its address,
+ * its single argument is copied as it is instead of being parsed.
+ */
+static const char NEX_COMMAND_BUILT_FORMAT[] = "%s";
+
+/**
+ * @struct nextion_pending_command_t
+ * @brief A command that was sent and is waiting for its response.
+ */
+typedef struct
+{
+    command_callback_on_complete callback; /*!< Called when completed. Not used by synchronous commands. */
+    void *context;                         /*!< Pointer passed to the callback. */
+    uint8_t *buffer;                       /*!< Where response bytes are stored; NULL when waiting for a simple response (ACK) or abandoned. */
+    size_t *length;                        /*!< Updated with the received bytes count. */
+    size_t capacity;                       /*!< Buffer length. */
+    size_t received;                       /*!< How many bytes were stored in the buffer. */
+    TickType_t deadline;                   /*!< When it times out. Restarted when it reaches the queue head. */
+    int64_t queued_at;                     /*!< When it was queued or, in a batch, written; in microseconds. */
+    uint32_t sequence;                     /*!< Submission sequence number. */
+    bool is_sync;                          /*!< If a caller is blocked waiting for it. */
+    bool is_raw;                           /*!< If the response is raw bytes, without code or termination. */
+    bool is_quiet;                         /*!< If it is only answered on failure; no late response is expected when it times out. */
+    bool is_deferred;                      /*!< If it is in a batch that was not written yet; it cannot time out. */
+    bool write_failed;                     /*!< If the command could not be written. */
+} nextion_pending_command_t;
+
 static bool nextion_core_command_sync_acquire(nextion_t *handle, TickType_t timeout);
 static void nextion_core_command_sync_release(nextion_t *handle);
+static nex_err_t nextion_core_command_code_normalize(nex_err_t code);
+static bool nextion_core_command_enqueue(nextion_t *handle, nextion_pending_command_t *pending);
+static void nextion_core_command_set_write_failed(nextion_t *handle, uint32_t sequence);
+static void nextion_core_command_extend_deadline(nextion_t *handle, uint32_t sequence, TickType_t ticks);
+static void nextion_core_command_abandon(nextion_t *handle, uint32_t sequence);
+static nex_err_t nextion_core_command_wait(nextion_t *handle, uint32_t sequence);
+static bool nextion_core_command_build(nextion_command_builder_t *builder, const char *format, va_list args);
+static nex_err_t nextion_core_command_submit_sync(nextion_t *handle, uint8_t *buffer, size_t *length, bool is_raw, bool is_quiet, const char *format, va_list args);
+static nex_err_t nextion_core_command_send_variadic(nextion_t *handle, bool is_quiet, const char *format, va_list args);
+static nex_err_t nextion_core_command_send_get_bytes_variadic(nextion_t *handle, uint8_t *buffer, size_t *length, bool is_raw, const char *format, va_list args);
+static size_t nextion_core_command_store(nextion_t *handle, const uint8_t *data, size_t length);
+static void nextion_core_command_complete(nextion_t *handle, nex_err_t code);
+static bool nextion_core_command_head(nextion_t *handle, nextion_pending_command_t *pending);
+static void nextion_core_command_restart_timeout(nextion_t *handle);
+static void nextion_core_command_check_timeout(nextion_t *handle);
+static void nextion_core_command_expect_late(nextion_t *handle, const nextion_pending_command_t *pending);
+static bool nextion_core_command_drop_late(nextion_t *handle, const nextion_pending_command_t *head);
+static void nextion_core_command_forget_late(nextion_t *handle);
+static bool nextion_core_transparent_data_mode_fill(nextion_t *handle, size_t left, bool is_end_queued);
+static bool nextion_core_batch_is_owner(const nextion_t *handle);
+static bool nextion_core_batch_append(nextion_t *handle, nextion_pending_command_t *pending, const char *format, va_list args);
+static bool nextion_core_batch_build(nextion_t *handle, const char *format, va_list args);
+static bool nextion_core_batch_write(void *context, const char *data, size_t length);
+static bool nextion_core_batch_discard(void *context, const char *data, size_t length);
+static bool nextion_core_batch_flush(nextion_t *handle);
 static bool nextion_core_event_dispatch(nextion_t *handle, const uint8_t *buffer, const size_t buffer_length);
-static bool nextion_core_event_process(nextion_t *handle);
+static bool nextion_core_event_release(nextion_t *handle);
+static void nextion_core_event_enqueue(nextion_t *handle, const uint8_t *frame, size_t length);
+static void nextion_core_event_task(void *pvParameters);
+static void nextion_core_eeprom_flush_task(void *pvParameters);
+static bool nextion_core_link_is_supported(uint32_t baud_rate);
+static bool nextion_core_link_detect(nextion_t *handle);
+static void nextion_core_link_negotiate(nextion_t *handle);
+static bool nextion_core_link_switch(nextion_t *handle, uint32_t baud_rate);
+static bool nextion_core_link_set_local(nextion_t *handle, uint32_t baud_rate);
+static bool nextion_core_link_probe(nextion_t *handle);
+static void nextion_core_link_measure(nextion_t *handle);
+static void nextion_core_uart_process(nextion_t *handle);
+static bool nextion_core_uart_resume(nextion_t *handle);
+static size_t nextion_core_uart_consume(nextion_t *handle, const uint8_t *bytes, size_t count);
+static bool nextion_core_uart_frame_process(nextion_t *handle, const nextion_pending_command_t *head);
+static void nextion_core_uart_parser_reset(nextion_t *handle);
+#ifndef CONFIG_NEX_UART_SHARED_TASK
 static void nextion_core_uart_task(void *pvParameters);
-static int32_t nextion_core_uart_read_as_byte(const nextion_t *handle, uint8_t *buffer, size_t length);
-static nex_err_t nextion_core_uart_read_as_simple_result(nextion_t *handle);
-static bool nextion_core_uart_write_as_byte(const nextion_t *handle, const char *bytes, size_t length);
+#endif
+static TickType_t nextion_core_uart_wait_time(nextion_t *handle);
+static void nextion_core_uart_event_process(nextion_t *handle, const uart_event_t *event);
+static void nextion_core_uart_serve(nextion_t *handle, bool is_served);
+static void nextion_core_uart_flush(nextion_t *handle);
+static void nextion_core_capture_print(void *context, nextion_wire_capture_direction_t direction, int64_t timestamp_us, const uint8_t *bytes, size_t length);
+static bool nextion_core_uart_write_as_byte(nextion_t *handle, const char *bytes, size_t length);
 static bool nextion_core_uart_write_as_command(nextion_t *handle, const char *format, va_list args);
+static bool nextion_core_uart_write_staged(void *context, const char *data, size_t length);
+#ifdef CONFIG_NEX_UART_SHARED_TASK
+static bool nextion_core_hub_attach(nextion_t *handle);
+static void nextion_core_hub_detach(nextion_t *handle);
+static nextion_t *nextion_core_hub_acquire(size_t slot, bool *is_served);
+static void nextion_core_hub_release(void);
+static void nextion_core_hub_task(void *pvParameters);
+#endif
 
 /**
  * @struct nextion_t
@@ -28,25 +208,78 @@ static bool nextion_core_uart_write_as_command(nextion_t *handle, const char *fo
  */
 struct nextion_t
 {
-    char command_format_buffer[CONFIG_NEX_UART_TRANS_COMMAND_FORMAT_BUFFER_SIZE]; /*!< Buffer used for formating commands. */
+    char command_format_buffer[CONFIG_NEX_UART_TRANS_COMMAND_FORMAT_BUFFER_SIZE]; /*!< Staging buffer commands are formatted into before being written. */
+    uint8_t recv_buffer[CONFIG_NEX_UART_RECV_READ_SIZE];                          /*!< Buffer the UART is drained into. */
+    nextion_frame_parser_t recv_parser;                                           /*!< Parser of received frames; keeps partial frames between reads. */
+    bool recv_resync;                                                             /*!< If the parser must be reset before the next read; set when the baud rate changes. */
+    size_t recv_offset;                                                           /*!< Index of the first byte of the receive buffer not parsed yet. */
+    size_t recv_length;                                                           /*!< How many bytes of the receive buffer were read. */
+    bool recv_stalled;                                                            /*!< If the parser holds an event the event queue has no room for; the UART is not read meanwhile. */
+    nextion_component_cache_t component_cache;                                    /*!< Last values written to component properties. */
+    nextion_eeprom_cache_t eeprom_cache;                                          /*!< EEPROM blocks read or written, when enabled. */
+    nextion_transport_stats_t stats;                                              /*!< Transport counters. */
+    nextion_wire_capture_t capture;                                               /*!< Last bytes written and read, when enabled. */
+    nextion_event_ring_t event_ring;                                              /*!< Events waiting for their callbacks; written by the UART task only. */
+    nextion_event_ring_entry_t event_held;                                        /*!< Event received while the event ring was full, waiting for room. */
+    bool is_event_held;                                                           /*!< If an event is held. */
+    TaskHandle_t event_task;                                                      /*!< Task that runs the event callbacks. */
+    TaskHandle_t eeprom_flush_task;                                               /*!< Task that flushes the EEPROM cache on time, or NULL. */
+    char batch_buffer[CONFIG_NEX_UART_BATCH_BUFFER_SIZE];                         /*!< Buffer holding the formatted commands of a batch. */
+    size_t batch_length;                                                          /*!< How many bytes of the batch buffer are used. */
+    TaskHandle_t batch_owner;                                                     /*!< Task that began a batch, or NULL. */
     event_callback_on_touch event_callback_on_touch;                              /*!< Callbacks for 'on touch' events. */
     event_callback_on_touch_coord event_callback_on_touch_coord;                  /*!< Callbacks for 'on touch with coordinates' events. */
     event_callback_on_device event_callback_on_device;                            /*!< Callbacks for 'on device' events. */
+    nextion_pending_command_t pending[CONFIG_NEX_UART_COMMAND_QUEUE_SIZE];        /*!< Commands waiting for a response, in the order they were sent. */
+    size_t pending_head;                                                          /*!< Index of the oldest pending command. */
+    size_t pending_count;                                                         /*!< How many commands are pending. */
+    uint32_t pending_sequence;                                                    /*!< Sequence number of the last submitted command. */
+    uint32_t completed_sequence;                                                  /*!< Sequence number of the last completed synchronous command. */
+    nex_err_t completed_result;                                                   /*!< Result of the last completed synchronous command. */
+    nex_err_t async_result;                                                       /*!< First failure of an asynchronous command since the last wait. */
+    size_t late_count;                                                            /*!< How many timed out commands might still be answered; their responses are dropped. */
+    TickType_t late_deadline;                                                     /*!< When those responses are no longer waited for. */
+    uint32_t late_dropped_sequence;                                               /*!< Sequence number of the head command when a late response was last dropped. */
+    portMUX_TYPE pending_lock;                                                    /*!< Lock used for pending command control. */
+    SemaphoreHandle_t pending_slots;                                              /*!< Counts free pending command slots. */
+    SemaphoreHandle_t command_done;                                               /*!< Signaled when a synchronous command completes or the queue empties. */
     SemaphoreHandle_t command_sync;                                               /*!< Mutex used command control. */
     QueueHandle_t uart_queue;                                                     /*!< Queue used for UART event. */
-    TaskHandle_t uart_task;                                                       /*!< Task used for UART queue handling. */
+    TaskHandle_t uart_task;                                                       /*!< Task used for UART queue handling; shared by every display with CONFIG_NEX_UART_SHARED_TASK. */
     size_t transparent_data_mode_size;                                            /*!< How many bytes are expected to be written while in "Transparent Data Mode". */
+    uint32_t transparent_data_mode_sequence;                                      /*!< Sequence number of the command waiting for the "Transparent Data Mode" end. */
+    nex_err_t transparent_data_mode_result;                                       /*!< Result of that command; kept apart since the next begin can complete before it is read. */
     uart_port_t uart_num;                                                         /*!< UART port number. */
+    uint32_t baud_rate;                                                           /*!< Current baud rate of both ends. */
+    uint32_t throughput;                                                          /*!< Last measured effective throughput, in bytes per second. */
     bool is_installed;                                                            /*!< If the driver was installed. */
     bool is_initialized;                                                          /*!< If the driver was initialized. */
     bool in_transparent_data_mode;                                                /*!< If it is in Transparent Data mode. */
 };
 
+#ifdef CONFIG_NEX_UART_SHARED_TASK
+/**
+ * @struct nextion_core_hub_t
+ * @brief The UART task shared by every display, and the displays it serves.
+ */
+typedef struct
+{
+    portMUX_TYPE lock;                                            /*!< Guards the fields below. */
+    nextion_t *drivers[CONFIG_NEX_UART_SHARED_TASK_MAX_DISPLAYS]; /*!< Attached drivers; NULL for a free slot. */
+    bool is_served[CONFIG_NEX_UART_SHARED_TASK_MAX_DISPLAYS];     /*!< If the driver of a slot is initialized; events of the others are dropped. */
+    nextion_t *busy;                                              /*!< Driver the task is working for, or NULL; it cannot be freed meanwhile. */
+    QueueSetHandle_t queue_set;                                   /*!< UART event queues of the attached drivers. */
+    TaskHandle_t task;                                            /*!< Shared UART task. */
+} nextion_core_hub_t;
+
+static nextion_core_hub_t nextion_core_hub = {.lock = portMUX_INITIALIZER_UNLOCKED};
+#endif
+
 nextion_t *nextion_driver_install(uart_port_t uart_num, uint32_t baud_rate, gpio_num_t tx_io_num, gpio_num_t rx_io_num)
 {
-    CMP_CHECK((baud_rate >= NEX_SERIAL_BAUD_RATE_MIN || baud_rate <= NEX_SERIAL_BAUD_RATE_MAX), "baud_rate error", NULL)
+    CMP_CHECK((baud_rate >= NEX_SERIAL_BAUD_RATE_MIN && baud_rate <= NEX_SERIAL_BAUD_RATE_MAX), "baud_rate error", NULL)
 
-    CMP_LOGI("installing driver on uart %d with baud rate %lu", uart_num, baud_rate);
+    CMP_LOGI("installing driver on uart %d with baud rate %lu", uart_num, (unsigned long)baud_rate);
 
     const uart_config_t uart_config = {
         .baud_rate = (int)baud_rate,
@@ -65,21 +298,43 @@ nextion_t *nextion_driver_install(uart_port_t uart_num, uint32_t baud_rate, gpio
 
     nextion_t *driver = (nextion_t *)calloc(1, sizeof(nextion_t));
     driver->uart_num = uart_num;
+    driver->baud_rate = baud_rate;
     driver->is_installed = true;
     driver->is_initialized = false;
     driver->in_transparent_data_mode = false;
+    driver->is_event_held = false;
     driver->command_sync = xSemaphoreCreateBinary();
+    driver->command_done = xSemaphoreCreateBinary();
+    driver->pending_slots = xSemaphoreCreateCounting(CONFIG_NEX_UART_COMMAND_QUEUE_SIZE, CONFIG_NEX_UART_COMMAND_QUEUE_SIZE);
+    driver->async_result = NEX_OK;
+
+    nextion_frame_parser_reset(&driver->recv_parser);
+    nextion_component_cache_init(&driver->component_cache);
+    nextion_eeprom_cache_init(&driver->eeprom_cache);
+    nextion_transport_stats_init(&driver->stats);
+    nextion_wire_capture_init(&driver->capture);
+    nextion_event_ring_init(&driver->event_ring);
+
+    portMUX_INITIALIZE(&driver->pending_lock);
 
     ESP_ERROR_CHECK(uart_driver_install(uart_num,
                                         CONFIG_NEX_UART_RECV_BUFFER_SIZE, // Receive buffer size.
                                         0,                                // Transmit buffer size.
-                                        10,                               // Queue size.
+                                        NEX_UART_EVENT_QUEUE_SIZE,        // Queue size.
                                         &driver->uart_queue,              // Queue pointer.
                                         0));                              // Allocation flags.
 
+#ifdef CONFIG_NEX_UART_SHARED_TASK
+    if (!nextion_core_hub_attach(driver))
+    {
+        CMP_LOGE("failed attaching to the shared UART task");
+
+        abort();
+    }
+#else
     if (xTaskCreate(&nextion_core_uart_task,
                     "nextion",
-                    2048,
+                    NEX_UART_TASK_STACK_SIZE,
                     (void *)driver,
                     CONFIG_NEX_UART_TASK_PRIORITY,
                     &driver->uart_task) != pdPASS)
@@ -88,6 +343,37 @@ nextion_t *nextion_driver_install(uart_port_t uart_num, uint32_t baud_rate, gpio
 
         abort();
     }
+#endif
+
+    if (xTaskCreate(&nextion_core_event_task,
+                    "nextion_event",
+                    CONFIG_NEX_EVENT_TASK_STACK_SIZE,
+                    (void *)driver,
+                    CONFIG_NEX_EVENT_TASK_PRIORITY,
+                    &driver->event_task) != pdPASS)
+    {
+        CMP_LOGE("failed creating event callback task");
+
+        abort();
+    }
+
+    // Flushing blocks on the device for a while; the event task must not wait for it.
+    if (CONFIG_NEX_EEPROM_CACHE_BLOCKS > 0 && CONFIG_NEX_EEPROM_CACHE_FLUSH_DELAY_MS > 0)
+    {
+        if (xTaskCreate(&nextion_core_eeprom_flush_task,
+                        "nextion_eeprom",
+                        NEX_EEPROM_FLUSH_TASK_STACK_SIZE,
+                        (void *)driver,
+                        NEX_EEPROM_FLUSH_TASK_PRIORITY,
+                        &driver->eeprom_flush_task) != pdPASS)
+        {
+            CMP_LOGE("failed creating EEPROM flush task");
+
+            abort();
+        }
+
+        driver->eeprom_cache.flusher = driver->eeprom_flush_task;
+    }
 
     CMP_LOGI("driver installed");
 
@@ -107,12 +393,26 @@ bool nextion_driver_delete(nextion_t *handle)
 
     CMP_LOGI("deleting driver");
 
+#ifdef CONFIG_NEX_UART_SHARED_TASK
+    // The task serves the other displays; it only lets go of this one.
+    nextion_core_hub_detach(handle);
+#else
     vTaskDelete(handle->uart_task);
+#endif
+    vTaskDelete(handle->event_task);
+
+    if (handle->eeprom_flush_task != NULL)
+    {
+        vTaskDelete(handle->eeprom_flush_task);
+    }
 
     // Will also free the queue.
     ESP_ERROR_CHECK(uart_driver_delete(handle->uart_num));
 
     vSemaphoreDelete(handle->command_sync);
+    vSemaphoreDelete(handle->command_done);
+    vSemaphoreDelete(handle->pending_slots);
+    nextion_eeprom_cache_deinit(&handle->eeprom_cache);
 
     free(handle);
 
@@ -161,519 +461,2560 @@ nex_err_t nextion_init(nextion_t *handle)
     // Set up the semaphore.
     nextion_core_command_sync_release(handle);
 
-    // Resume the UART task.
-    vTaskResume(handle->uart_task);
+    // Start reading the UART.
+    nextion_core_uart_serve(handle, true);
 
     // As "bkcmd" is not set, we cannot garantee what will come.
     // Just try to wake up, as the device cannot receive commands
     // when sleeping. Any failure will come when setting "bkcmd".
-    nextion_system_wakeup(handle);
+    if (nextion_system_wakeup(handle) == NEX_TIMEOUT)
+    {
+        // It might still be answered, or never; wait that out,
+        // so neither way its answer is taken for the next one.
+        vTaskDelay(pdMS_TO_TICKS(NEX_COMMAND_LATE_WAIT_TIME_MS));
+
+        nextion_core_command_forget_late(handle);
+    }
 
     // All logic relies on receiving responses at all times.
-    if (nextion_command_send(handle, "bkcmd=3") != NEX_OK)
+    // A display left at another baud rate (e.g. after an MCU
+    // reset) does not understand it; look for that rate.
+    if (nextion_command_send(handle, "bkcmd=3") != NEX_OK && !nextion_core_link_detect(handle))
     {
         handle->is_initialized = false;
 
-        vTaskSuspend(handle->uart_task);
+        nextion_core_uart_serve(handle, false);
 
         CMP_LOGE("failed initializing display");
 
         return NEX_FAIL;
     }
 
+#ifdef CONFIG_NEX_UART_BAUD_RATE_NEGOTIATE
+    nextion_core_link_negotiate(handle);
+    nextion_core_link_measure(handle);
+#endif
+
     CMP_LOGI("driver initialized");
 
     return NEX_OK;
 }
 
-nex_err_t nextion_command_send_get_bytes(nextion_t *handle, uint8_t *buffer, size_t *length, const char *command, ...)
+nex_err_t nextion_baud_rate_set(nextion_t *handle, uint32_t baud_rate)
 {
     CMP_CHECK_SEND_COMMAND_HANDLE_STATE(handle)
-    CMP_CHECK((command != NULL), "command error(NULL)", NEX_FAIL)
-    CMP_CHECK((nextion_core_command_sync_acquire(handle, pdMS_TO_TICKS(CONFIG_NEX_UART_MUTEX_WAIT_TIME_MS))), "sync error(not acquired)", NEX_FAIL)
+    CMP_CHECK((nextion_core_link_is_supported(baud_rate)), "baud_rate error(not supported)", NEX_FAIL)
+    CMP_CHECK((handle->batch_owner == NULL), "state error(in batch)", NEX_FAIL)
 
-    nex_err_t code = NEX_OK;
-    va_list args;
-    va_start(args, command);
+    nextion_pending_command_t head;
 
-    if (!nextion_core_uart_write_as_command(handle, command, args))
-    {
-        CMP_LOGE("failed sending command");
+    // Responses to pending commands would arrive at the new baud rate.
+    CMP_CHECK((!nextion_core_command_head(handle, &head)), "state error(commands pending)", NEX_FAIL)
 
-        code = NEX_FAIL;
-    }
-    else
+    if (baud_rate == handle->baud_rate)
     {
-        *length = (int)nextion_core_uart_read_as_byte(handle, buffer, *length);
-
-        if (*length == -1)
-        {
-            code = NEX_TIMEOUT;
-        }
+        return NEX_OK;
     }
 
-    nextion_core_command_sync_release(handle);
+    uint32_t previous = handle->baud_rate;
 
-    va_end(args);
+    if (nextion_core_link_switch(handle, baud_rate))
+    {
+        nextion_core_link_measure(handle);
 
-    return code;
-}
+        return NEX_OK;
+    }
 
-nex_err_t nextion_command_send_variadic(nextion_t *handle, const char *command, va_list args)
-{
-    CMP_CHECK_SEND_COMMAND_HANDLE_STATE(handle)
-    CMP_CHECK((command != NULL), "command error(NULL)", NEX_FAIL)
-    CMP_CHECK((nextion_core_command_sync_acquire(handle, pdMS_TO_TICKS(CONFIG_NEX_UART_MUTEX_WAIT_TIME_MS))), "sync error(not acquired)", NEX_FAIL)
+    CMP_LOGW("baud rate %lu not sustained, falling back to %lu", (unsigned long)baud_rate, (unsigned long)previous);
 
-    nex_err_t code = NEX_DVC_INSTRUCTION_FAIL;
+    // The display either refused the new rate or cannot be heard at it.
 
-    if (!nextion_core_uart_write_as_command(handle, command, args))
-    {
-        CMP_LOGE("failed sending command");
-    }
-    else
+    if (nextion_core_link_set_local(handle, previous) && nextion_core_link_probe(handle))
     {
-        code = nextion_core_uart_read_as_simple_result(handle);
+        return NEX_FAIL;
     }
 
-    nextion_core_command_sync_release(handle);
-
-    if (code == NEX_DVC_INSTRUCTION_FAIL)
+    if (nextion_core_link_set_local(handle, baud_rate) && nextion_core_link_switch(handle, previous))
     {
-        CMP_LOGW("device returned failure");
-
         return NEX_FAIL;
     }
 
-    if (code == NEX_DVC_INSTRUCTION_OK)
-    {
-        return NEX_OK;
-    }
+    CMP_LOGE("link lost while changing baud rate");
 
-    return code;
+    return NEX_FAIL;
 }
 
-nex_err_t nextion_command_send(nextion_t *handle, const char *command, ...)
+nex_err_t nextion_link_get_info(nextion_t *handle, nextion_link_info_t *info)
 {
-    va_list args;
-    va_start(args, command);
-
-    nex_err_t result = nextion_command_send_variadic(handle, command, args);
+    CMP_CHECK_HANDLE(handle, NEX_FAIL)
+    CMP_CHECK((info != NULL), "info error(NULL)", NEX_FAIL)
 
-    va_end(args);
+    info->baud_rate = handle->baud_rate;
+    info->throughput = handle->throughput;
 
-    return result;
+    return NEX_OK;
 }
 
-nex_err_t nextion_transparent_data_mode_begin(nextion_t *handle,
-                                              size_t data_size,
-                                              const char *command,
-                                              ...)
+nex_err_t nextion_stats_get(nextion_t *handle, nextion_stats_t *stats)
 {
     CMP_CHECK_HANDLE(handle, NEX_FAIL)
-    CMP_CHECK((command != NULL), "command error(NULL)", NEX_FAIL)
-    CMP_CHECK((handle->in_transparent_data_mode == false), "state error(in transparent data mode)", NEX_FAIL)
-    CMP_CHECK((data_size > 0), "data_size error(<1)", NEX_FAIL)
-    CMP_CHECK((data_size < NEX_DVC_TRANSPARENT_DATA_MAX_DATA_SIZE), "data_size error(>NEX_DVC_TRANSPARENT_DATA_MAX_DATA_SIZE)", NEX_FAIL)
+    CMP_CHECK((stats != NULL), "stats error(NULL)", NEX_FAIL)
 
-    va_list args;
-    va_start(args, command);
+    nextion_transport_stats_get(&handle->stats, stats);
 
-    nex_err_t result = nextion_command_send_variadic(handle, command, args);
+    stats->events_dropped = (uint32_t)atomic_load(&handle->event_ring.dropped);
 
-    va_end(args);
+    return NEX_OK;
+}
 
-    if (result != NEX_DVC_RSP_TRANSPARENT_DATA_READY)
-    {
-        return result;
-    }
+nex_err_t nextion_stats_reset(nextion_t *handle)
+{
+    CMP_CHECK_HANDLE(handle, NEX_FAIL)
 
-    handle->in_transparent_data_mode = true;
-    handle->transparent_data_mode_size = data_size;
+    nextion_transport_stats_reset(&handle->stats);
+
+    atomic_store(&handle->event_ring.dropped, 0);
 
     return NEX_OK;
 }
 
-nex_err_t nextion_transparent_data_mode_write(nextion_t *handle, uint8_t value)
+nex_err_t nextion_capture_dump(nextion_t *handle, FILE *stream)
 {
     CMP_CHECK_HANDLE(handle, NEX_FAIL)
-    CMP_CHECK((handle->in_transparent_data_mode), "state error(not in transparent data mode)", NEX_FAIL)
-    CMP_CHECK((handle->transparent_data_mode_size > 0), "state error(all data was written)", NEX_FAIL)
-
-    const uint8_t buffer[1] = {value};
+    CMP_CHECK((stream != NULL), "stream error(NULL)", NEX_FAIL)
+    CMP_CHECK((CONFIG_NEX_WIRE_CAPTURE_SIZE > 0), "capture error(disabled)", NEX_FAIL)
 
-    if (!nextion_core_uart_write_as_byte(handle, (const char *)buffer, 1))
-    {
-        CMP_LOGE("failed writing to the communication port");
+    fprintf(stream, "nexcap begin\n");
 
-        return NEX_FAIL;
-    }
+    size_t records = nextion_wire_capture_read(&handle->capture, nextion_core_capture_print, stream);
 
-    handle->transparent_data_mode_size--;
+    fprintf(stream, "nexcap end %u %lu %lu\n",
+            (unsigned)records,
+            (unsigned long)handle->capture.overwritten,
+            (unsigned long)handle->capture.skipped);
 
     return NEX_OK;
 }
 
-nex_err_t nextion_transparent_data_mode_end(nextion_t *handle)
+nex_err_t nextion_capture_clear(nextion_t *handle)
 {
     CMP_CHECK_HANDLE(handle, NEX_FAIL)
-    CMP_CHECK((handle->in_transparent_data_mode), "state error(not in transparent data mode)", NEX_FAIL)
-    CMP_CHECK((handle->transparent_data_mode_size == 0), "state error(not all data was written)", NEX_FAIL)
 
-    uint8_t code = 0;
-    uint8_t buffer[NEX_DVC_CMD_ACK_LENGTH];
-    size_t bytes_read = (size_t)nextion_core_uart_read_as_byte(handle, buffer, NEX_DVC_CMD_ACK_LENGTH);
+    nextion_wire_capture_clear(&handle->capture);
 
-    if (bytes_read < 1)
-    {
-        CMP_LOGE("failed reading response");
+    return NEX_OK;
+}
 
-        return NEX_FAIL;
-    }
+nex_err_t nextion_command_send_get_bytes(nextion_t *handle, uint8_t *buffer, size_t *length, const char *command, ...)
+{
+    va_list args;
+    va_start(args, command);
 
-    if (bytes_read < NEX_DVC_CMD_ACK_LENGTH)
-    {
-        CMP_LOGE("invalid response length, expected %d but received %d", NEX_DVC_CMD_ACK_LENGTH, bytes_read);
+    nex_err_t code = nextion_core_command_send_get_bytes_variadic(handle, buffer, length, false, command, args);
 
-        return NEX_FAIL;
-    }
+    va_end(args);
 
-    code = buffer[0];
+    return code;
+}
 
-    // Here we must have a response message indicating end.
+nex_err_t nextion_command_send_get_raw_bytes(nextion_t *handle, uint8_t *buffer, size_t *length, const char *command, ...)
+{
+    va_list args;
+    va_start(args, command);
 
-    if (!NEX_DVC_CODE_IS_RESPONSE(code, bytes_read))
-    {
-        CMP_LOGE("response code not expected");
+    nex_err_t code = nextion_core_command_send_get_bytes_variadic(handle, buffer, length, true, command, args);
 
-        return NEX_FAIL;
-    }
+    va_end(args);
 
-    if (code != NEX_DVC_RSP_TRANSPARENT_DATA_FINISHED)
-    {
-        CMP_LOGE("response code is not data finished");
+    return code;
+}
 
-        return NEX_FAIL;
-    }
+nex_err_t nextion_command_send_variadic(nextion_t *handle, const char *command, va_list args)
+{
+    return nextion_core_command_send_variadic(handle, false, command, args);
+}
 
-    handle->in_transparent_data_mode = false;
+nex_err_t nextion_command_send(nextion_t *handle, const char *command, ...)
+{
+    va_list args;
+    va_start(args, command);
 
-    return NEX_OK;
-}
+    nex_err_t result = nextion_command_send_variadic(handle, command, args);
 
-/* ======================
- *     Core Methods
- *======================= */
+    va_end(args);
 
-static void nextion_core_uart_task(void *pvParameters)
+    return result;
+}
+
+nex_err_t nextion_command_send_quiet(nextion_t *handle, const char *command, ...)
 {
-    vTaskSuspend(NULL);
+    va_list args;
+    va_start(args, command);
 
-    nextion_t *handle = (nextion_t *)pvParameters;
-    QueueHandle_t queue = handle->uart_queue;
-    uart_port_t uart = handle->uart_num;
+    nex_err_t result = nextion_core_command_send_variadic(handle, true, command, args);
 
-    CMP_LOGI("installed queue for UART %d", uart);
+    va_end(args);
 
-    uart_event_t event;
+    return result;
+}
 
-    for (;;)
-    {
-        if (xQueueReceive(queue, (void *)&event, portMAX_DELAY) == pdFALSE)
-        {
-            CMP_LOGE("failed receiving from UART queue");
-            break;
-        }
+nex_err_t nextion_command_send_async(nextion_t *handle,
+                                     command_callback_on_complete callback,
+                                     void *context,
+                                     const char *command,
+                                     ...)
+{
+    CMP_CHECK_SEND_COMMAND_HANDLE_STATE(handle)
+    CMP_CHECK((command != NULL), "command error(NULL)", NEX_FAIL)
+    CMP_CHECK((nextion_core_command_sync_acquire(handle, pdMS_TO_TICKS(CONFIG_NEX_UART_MUTEX_WAIT_TIME_MS))), "sync error(not acquired)", NEX_FAIL)
 
-        switch (event.type)
-        {
-        case UART_DATA:
-            CMP_LOGD("UART data size: %d", event.size);
+    nextion_pending_command_t pending = {
+        .callback = callback,
+        .context = context,
+        .is_sync = false};
 
-            // If we can acquire a semaphore it means the event was sent by the device
-            // automatically. It will only fail to acquire the semaphore when a command
-            // was called. For commands and Transparent Data mode, we do nothing,
-            // let them handle the bytes.
+    bool sent = false;
 
-            if (!handle->in_transparent_data_mode && nextion_core_command_sync_acquire(handle, 0))
-            {
-                CMP_LOGD("processing events");
+    if (nextion_core_batch_is_owner(handle))
+    {
+        va_list args;
+        va_start(args, command);
 
-                nextion_core_event_process(handle);
-                nextion_core_command_sync_release(handle);
-            }
-            break;
-        case UART_FIFO_OVF:
-            CMP_LOGW("UART hw fifo overflow");
+        sent = nextion_core_batch_append(handle, &pending, command, args);
 
-            uart_flush_input(uart);
+        va_end(args);
+    }
+    else if (nextion_core_command_enqueue(handle, &pending))
+    {
+        va_list args;
+        va_start(args, command);
 
-            xQueueReset(queue);
-            break;
-        case UART_BUFFER_FULL:
-            CMP_LOGW("UART buffer full");
+        sent = nextion_core_uart_write_as_command(handle, command, args);
 
-            uart_flush_input(uart);
+        va_end(args);
 
-            xQueueReset(queue);
-            break;
-        default:
-            break;
+        if (!sent)
+        {
+            CMP_LOGE("failed sending command");
+
+            nextion_core_command_set_write_failed(handle, pending.sequence);
         }
     }
+
+    nextion_core_command_sync_release(handle);
+
+    return sent ? NEX_OK : NEX_FAIL;
 }
 
-static bool nextion_core_event_process(nextion_t *handle)
+nex_err_t nextion_command_send_built(nextion_t *handle, const char *command)
 {
-    CMP_CHECK_HANDLE(handle, false)
-    CMP_CHECK((handle->in_transparent_data_mode == false), "state error(in transparent data mode)", false)
-    CMP_CHECK((handle->is_installed), "driver error(not installed)", false)
-    CMP_CHECK((handle->is_initialized), "driver error(not initialized)", false)
+    CMP_CHECK((command != NULL), "command error(NULL)", NEX_FAIL)
 
-    uint8_t buffer[NEX_DVC_EVT_MAX_RESPONSE_LENGTH];
-    int bytes_read = (int)nextion_core_uart_read_as_byte(handle, buffer, NEX_DVC_EVT_MAX_RESPONSE_LENGTH);
+    return nextion_command_send(handle, NEX_COMMAND_BUILT_FORMAT, command);
+}
+
+nex_err_t nextion_command_send_built_async(nextion_t *handle,
+                                           command_callback_on_complete callback,
+                                           void *context,
+                                           const char *command)
+{
+    CMP_CHECK((command != NULL), "command error(NULL)", NEX_FAIL)
+
+    return nextion_command_send_async(handle, callback, context, NEX_COMMAND_BUILT_FORMAT, command);
+}
+
+nex_err_t nextion_command_wait_all(nextion_t *handle)
+{
+    CMP_CHECK_HANDLE(handle, NEX_FAIL)
+    CMP_CHECK((nextion_core_command_sync_acquire(handle, pdMS_TO_TICKS(CONFIG_NEX_UART_MUTEX_WAIT_TIME_MS))), "sync error(not acquired)", NEX_FAIL)
+
+    const TickType_t started_at = xTaskGetTickCount();
+    const TickType_t wait_time = pdMS_TO_TICKS(NEX_COMMAND_COMPLETION_WAIT_TIME_MS);
+    nex_err_t code = NEX_OK;
+
+    // Commands of an unfinished batch would never be answered.
+    nextion_core_batch_flush(handle);
+
+    for (;;)
+    {
+        portENTER_CRITICAL(&handle->pending_lock);
+        size_t count = handle->pending_count;
+        portEXIT_CRITICAL(&handle->pending_lock);
+
+        if (count == 0)
+        {
+            break;
+        }
+
+        TickType_t elapsed = xTaskGetTickCount() - started_at;
+
+        if (elapsed >= wait_time || xSemaphoreTake(handle->command_done, wait_time - elapsed) != pdTRUE)
+        {
+            CMP_LOGE("failed waiting pending commands");
+
+            code = NEX_TIMEOUT;
+            break;
+        }
+    }
+
+    portENTER_CRITICAL(&handle->pending_lock);
+
+    if (code == NEX_OK)
+    {
+        code = handle->async_result;
+    }
+
+    handle->async_result = NEX_OK;
+
+    portEXIT_CRITICAL(&handle->pending_lock);
+
+    // Cached values were kept before their responses; any of them might not be set.
+    if (code != NEX_OK)
+    {
+        nextion_component_cache_invalidate(&handle->component_cache);
+    }
+
+    nextion_core_command_sync_release(handle);
+
+    return code;
+}
+
+nex_err_t nextion_batch_begin(nextion_t *handle)
+{
+    CMP_CHECK_SEND_COMMAND_HANDLE_STATE(handle)
+    CMP_CHECK((!nextion_core_batch_is_owner(handle)), "state error(already in batch)", NEX_FAIL)
+    CMP_CHECK((nextion_core_command_sync_acquire(handle, pdMS_TO_TICKS(CONFIG_NEX_UART_MUTEX_WAIT_TIME_MS))), "sync error(not acquired)", NEX_FAIL)
+
+    // The command sync is held until the batch ends; only the owner can send.
+
+    handle->batch_length = 0;
+    handle->batch_owner = xTaskGetCurrentTaskHandle();
+
+    return NEX_OK;
+}
+
+nex_err_t nextion_batch_end(nextion_t *handle)
+{
+    CMP_CHECK_HANDLE(handle, NEX_FAIL)
+    CMP_CHECK((nextion_core_batch_is_owner(handle)), "state error(not in batch)", NEX_FAIL)
+
+    bool written = nextion_core_batch_flush(handle);
+
+    // Still the owner, so no other task sends until the batch responses are in.
+    nex_err_t code = nextion_command_wait_all(handle);
+
+    handle->batch_owner = NULL;
+
+    nextion_core_command_sync_release(handle);
+
+    if (!written)
+    {
+        return NEX_FAIL;
+    }
+
+    return code;
+}
+
+nex_err_t nextion_transparent_data_mode_begin(nextion_t *handle,
+                                              size_t data_size,
+                                              const char *command,
+                                              ...)
+{
+    CMP_CHECK_HANDLE(handle, NEX_FAIL)
+    CMP_CHECK((command != NULL), "command error(NULL)", NEX_FAIL)
+    CMP_CHECK((handle->in_transparent_data_mode == false), "state error(in transparent data mode)", NEX_FAIL)
+    CMP_CHECK((data_size > 0), "data_size error(<1)", NEX_FAIL)
+    CMP_CHECK((data_size < NEX_DVC_TRANSPARENT_DATA_MAX_DATA_SIZE), "data_size error(>NEX_DVC_TRANSPARENT_DATA_MAX_DATA_SIZE)", NEX_FAIL)
+    CMP_CHECK((!nextion_core_batch_is_owner(handle)), "state error(in batch)", NEX_FAIL)
+
+    va_list args;
+    va_start(args, command);
+
+    nex_err_t result = nextion_command_send_variadic(handle, command, args);
+
+    va_end(args);
+
+    if (result != NEX_DVC_RSP_TRANSPARENT_DATA_READY)
+    {
+        return result;
+    }
+
+    handle->in_transparent_data_mode = true;
+    handle->transparent_data_mode_size = data_size;
+
+    return NEX_OK;
+}
+
+nex_err_t nextion_transparent_data_mode_write(nextion_t *handle, uint8_t value)
+{
+    CMP_CHECK_HANDLE(handle, NEX_FAIL)
+    CMP_CHECK((handle->in_transparent_data_mode), "state error(not in transparent data mode)", NEX_FAIL)
+    CMP_CHECK((handle->transparent_data_mode_size > 0), "state error(all data was written)", NEX_FAIL)
+
+    const uint8_t buffer[1] = {value};
+
+    return nextion_transparent_data_mode_write_buffer(handle, buffer, 1);
+}
+
+nex_err_t nextion_transparent_data_mode_write_buffer(nextion_t *handle, const uint8_t *buffer, size_t length)
+{
+    CMP_CHECK_HANDLE(handle, NEX_FAIL)
+    CMP_CHECK((buffer != NULL), "buffer error(NULL)", NEX_FAIL)
+    CMP_CHECK((handle->in_transparent_data_mode), "state error(not in transparent data mode)", NEX_FAIL)
+    CMP_CHECK((length <= handle->transparent_data_mode_size), "length error(>data left to be written)", NEX_FAIL)
+
+    if (length == 0)
+    {
+        return NEX_OK;
+    }
+
+    CMP_CHECK((nextion_core_command_sync_acquire(handle, pdMS_TO_TICKS(CONFIG_NEX_UART_MUTEX_WAIT_TIME_MS))), "sync error(not acquired)", NEX_FAIL)
+
+    // The end response is triggered by the last byte and can arrive
+    // before the write returns, so it must be waited for beforehand.
+
+    bool is_last = length == handle->transparent_data_mode_size;
+
+    if (is_last)
+    {
+        nextion_pending_command_t pending = {.is_sync = true};
+
+        portENTER_CRITICAL(&handle->pending_lock);
+        handle->transparent_data_mode_result = NEX_TIMEOUT;
+        portEXIT_CRITICAL(&handle->pending_lock);
+
+        if (!nextion_core_command_enqueue(handle, &pending))
+        {
+            nextion_core_command_sync_release(handle);
+
+            CMP_LOGE("queue error(full)");
+
+            return NEX_FAIL;
+        }
+
+        handle->transparent_data_mode_sequence = pending.sequence;
+
+        // Long buffers take longer than the response wait to write at low baud rates.
+        nextion_core_command_extend_deadline(handle,
+                                             pending.sequence,
+                                             pdMS_TO_TICKS((uint64_t)length * 10U * 1000U / handle->baud_rate) + 1);
+    }
+
+    // One write and one transmission wait for the whole buffer.
+    bool is_queued = nextion_core_uart_write_staged(handle, (const char *)buffer, length);
+
+    if (is_queued && uart_wait_tx_done(handle->uart_num, pdMS_TO_TICKS(CONFIG_NEX_UART_TRANS_WAIT_TIME_MS)) == ESP_OK)
+    {
+        handle->transparent_data_mode_size -= length;
+
+        nextion_core_command_sync_release(handle);
+
+        return NEX_OK;
+    }
+
+    CMP_LOGE("failed writing to the communication port");
+
+    // Queued bytes still reach the display; the rest of the transaction cannot be
+    // completed anymore, but the display waits for it and would take the next
+    // command as data. It is filled up, so the mode is left either way.
+
+    size_t left = handle->transparent_data_mode_size - (is_queued ? length : 0);
+
+    handle->in_transparent_data_mode = false;
+
+    bool has_left = nextion_core_transparent_data_mode_fill(handle, left, is_last);
+
+    nextion_core_command_sync_release(handle);
+
+    if (!has_left)
+    {
+        CMP_LOGE("failed leaving transparent data mode");
+
+        return NEX_TIMEOUT;
+    }
+
+    return NEX_FAIL;
+}
+
+nex_err_t nextion_transparent_data_mode_end(nextion_t *handle)
+{
+    CMP_CHECK_HANDLE(handle, NEX_FAIL)
+    CMP_CHECK((handle->in_transparent_data_mode), "state error(not in transparent data mode)", NEX_FAIL)
+    CMP_CHECK((handle->transparent_data_mode_size == 0), "state error(not all data was written)", NEX_FAIL)
+
+    CMP_CHECK((nextion_core_command_sync_acquire(handle, pdMS_TO_TICKS(CONFIG_NEX_UART_MUTEX_WAIT_TIME_MS))), "sync error(not acquired)", NEX_FAIL)
+
+    // Here we must have a response message indicating end.
+    // Nothing is written; the response was triggered by the data.
+
+    nex_err_t code = nextion_core_command_wait(handle, handle->transparent_data_mode_sequence);
+
+    nextion_core_command_sync_release(handle);
+
+    // Either way the transaction is over; a new one can be tried.
+    handle->in_transparent_data_mode = false;
+
+    if (code == NEX_TIMEOUT)
+    {
+        CMP_LOGE("failed reading response");
+
+        return NEX_FAIL;
+    }
+
+    if (code != NEX_DVC_RSP_TRANSPARENT_DATA_FINISHED)
+    {
+        CMP_LOGE("response code is not data finished");
+
+        return NEX_FAIL;
+    }
+
+    return NEX_OK;
+}
+
+nex_err_t nextion_transparent_data_mode_restart(nextion_t *handle,
+                                                nex_err_t *end_code,
+                                                size_t data_size,
+                                                const char *command,
+                                                ...)
+{
+    CMP_CHECK_HANDLE(handle, NEX_FAIL)
+    CMP_CHECK((end_code != NULL), "end_code error(NULL)", NEX_FAIL)
+    CMP_CHECK((command != NULL), "command error(NULL)", NEX_FAIL)
+    CMP_CHECK((handle->in_transparent_data_mode), "state error(not in transparent data mode)", NEX_FAIL)
+    CMP_CHECK((handle->transparent_data_mode_size == 0), "state error(not all data was written)", NEX_FAIL)
+    CMP_CHECK((data_size > 0), "data_size error(<1)", NEX_FAIL)
+    CMP_CHECK((data_size < NEX_DVC_TRANSPARENT_DATA_MAX_DATA_SIZE), "data_size error(>NEX_DVC_TRANSPARENT_DATA_MAX_DATA_SIZE)", NEX_FAIL)
+    CMP_CHECK((!nextion_core_batch_is_owner(handle)), "state error(in batch)", NEX_FAIL)
+    CMP_CHECK((nextion_core_command_sync_acquire(handle, pdMS_TO_TICKS(CONFIG_NEX_UART_MUTEX_WAIT_TIME_MS))), "sync error(not acquired)", NEX_FAIL)
+
+    // The end response is ahead in the queue, so it completes first.
+
+    va_list args;
+    va_start(args, command);
+
+    nex_err_t code = nextion_core_command_submit_sync(handle, NULL, NULL, false, false, command, args);
+
+    va_end(args);
+
+    nextion_core_command_sync_release(handle);
+
+    portENTER_CRITICAL(&handle->pending_lock);
+    nex_err_t ended = handle->transparent_data_mode_result;
+    portEXIT_CRITICAL(&handle->pending_lock);
+
+    handle->in_transparent_data_mode = false;
+
+    if (code == NEX_DVC_RSP_TRANSPARENT_DATA_READY)
+    {
+        // The display reads commands again only once the data is consumed.
+        if (ended != NEX_DVC_RSP_TRANSPARENT_DATA_FINISHED)
+        {
+            CMP_LOGW("data finished response lost, the next transaction began anyway");
+        }
+
+        *end_code = NEX_OK;
+
+        handle->in_transparent_data_mode = true;
+        handle->transparent_data_mode_size = data_size;
+
+        return NEX_OK;
+    }
+
+    *end_code = ended == NEX_DVC_RSP_TRANSPARENT_DATA_FINISHED ? NEX_OK : NEX_FAIL;
+
+    if (*end_code != NEX_OK)
+    {
+        CMP_LOGE("response code is not data finished");
+    }
+
+    return nextion_core_command_code_normalize(code);
+}
+
+nextion_component_cache_t *nextion_component_cache_of(nextion_t *handle)
+{
+    return &handle->component_cache;
+}
+
+nextion_eeprom_cache_t *nextion_eeprom_cache_of(nextion_t *handle)
+{
+    return &handle->eeprom_cache;
+}
+
+/* ======================
+ *     Core Methods
+ *======================= */
+
+#ifndef CONFIG_NEX_UART_SHARED_TASK
+static void nextion_core_uart_task(void *pvParameters)
+{
+    vTaskSuspend(NULL);
+
+    nextion_t *handle = (nextion_t *)pvParameters;
+    QueueHandle_t queue = handle->uart_queue;
+    uart_port_t uart = handle->uart_num;
+
+    CMP_LOGI("installed queue for UART %d", uart);
+
+    uart_event_t event;
+
+    for (;;)
+    {
+        if (xQueueReceive(queue, (void *)&event, nextion_core_uart_wait_time(handle)) == pdFALSE)
+        {
+            if (handle->is_event_held)
+            {
+                nextion_core_uart_process(handle);
+            }
+
+            nextion_core_command_check_timeout(handle);
+            continue;
+        }
+
+        nextion_core_uart_event_process(handle, &event);
+
+        if (event.type == UART_FIFO_OVF || event.type == UART_BUFFER_FULL)
+        {
+            // Events queued before the flush refer to bytes that are gone.
+            xQueueReset(queue);
+        }
+
+        nextion_core_command_check_timeout(handle);
+    }
+}
+#endif
+
+/**
+ * @brief Get how long the UART task can wait for an event.
+ * @details When commands are pending, it wakes up in time to expire the oldest one.
+ * While an event waits for room in the event queue, it wakes up to retry.
+ * @param handle Nextion context pointer.
+ * @return Ticks to wait.
+ */
+static TickType_t nextion_core_uart_wait_time(nextion_t *handle)
+{
+    TickType_t wait_time = pdMS_TO_TICKS(handle->is_event_held ? NEX_EVENT_RETRY_TIME_MS : CONFIG_NEX_UART_RECV_WAIT_TIME_MS);
+    nextion_pending_command_t head;
+
+    if (nextion_core_command_head(handle, &head) && !head.is_deferred)
+    {
+        TickType_t now = xTaskGetTickCount();
+
+        TickType_t head_wait_time = (int32_t)(head.deadline - now) > 0 ? head.deadline - now : 0;
+
+        wait_time = head_wait_time < wait_time ? head_wait_time : wait_time;
+    }
+
+    return wait_time;
+}
+
+/**
+ * @brief Handle a UART event.
+ * @param handle Nextion context pointer.
+ * @param event UART event.
+ */
+static void nextion_core_uart_event_process(nextion_t *handle, const uart_event_t *event)
+{
+    switch (event->type)
+    {
+    case UART_DATA:
+        CMP_LOGD("UART data size: %u", (unsigned int)event->size);
+
+        // This task is the only UART reader. Responses are matched
+        // to the oldest pending command; anything else is an event.
+
+        nextion_core_uart_process(handle);
+        break;
+    case UART_FIFO_OVF:
+        CMP_LOGW("UART hw fifo overflow");
+
+        nextion_transport_stats_on_overflow(&handle->stats, true);
+        nextion_core_uart_flush(handle);
+        nextion_core_uart_parser_reset(handle);
+        break;
+    case UART_BUFFER_FULL:
+        CMP_LOGW("UART buffer full");
+
+        nextion_transport_stats_on_overflow(&handle->stats, false);
+        nextion_core_uart_flush(handle);
+        nextion_core_uart_parser_reset(handle);
+        break;
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief Start or stop reading the UART of a display.
+ * @param handle Nextion context pointer.
+ * @param is_served If the UART events must be processed.
+ */
+static void nextion_core_uart_serve(nextion_t *handle, bool is_served)
+{
+#ifdef CONFIG_NEX_UART_SHARED_TASK
+    portENTER_CRITICAL(&nextion_core_hub.lock);
+
+    for (size_t slot = 0; slot < CONFIG_NEX_UART_SHARED_TASK_MAX_DISPLAYS; slot++)
+    {
+        if (nextion_core_hub.drivers[slot] == handle)
+        {
+            nextion_core_hub.is_served[slot] = is_served;
+        }
+    }
+
+    portEXIT_CRITICAL(&nextion_core_hub.lock);
+#else
+    if (is_served)
+    {
+        vTaskResume(handle->uart_task);
+    }
+    else
+    {
+        vTaskSuspend(handle->uart_task);
+    }
+#endif
+}
+
+#ifdef CONFIG_NEX_UART_SHARED_TASK
+/**
+ * @brief Attach a driver to the shared UART task, starting the task with the first one.
+ * @note Drivers are installed and deleted by one task at a time.
+ * @param handle Nextion context pointer; its UART must be installed.
+ * @return True if success, otherwise false.
+ */
+static bool nextion_core_hub_attach(nextion_t *handle)
+{
+    // Kept once created: an interrupt could still post to a queue of the set.
+    if (nextion_core_hub.task == NULL)
+    {
+        // Room for every queue, and for the entries a deleted display might leave.
+        nextion_core_hub.queue_set = xQueueCreateSet(NEX_UART_EVENT_QUEUE_SIZE * (CONFIG_NEX_UART_SHARED_TASK_MAX_DISPLAYS + 1));
+
+        if (nextion_core_hub.queue_set == NULL ||
+            xTaskCreate(&nextion_core_hub_task,
+                        "nextion",
+                        NEX_UART_TASK_STACK_SIZE,
+                        NULL,
+                        CONFIG_NEX_UART_TASK_PRIORITY,
+                        &nextion_core_hub.task) != pdPASS)
+        {
+            CMP_LOGE("failed creating shared UART task");
+
+            return false;
+        }
+    }
+
+    size_t slot = CONFIG_NEX_UART_SHARED_TASK_MAX_DISPLAYS;
+
+    portENTER_CRITICAL(&nextion_core_hub.lock);
+
+    for (size_t i = 0; i < CONFIG_NEX_UART_SHARED_TASK_MAX_DISPLAYS && slot == CONFIG_NEX_UART_SHARED_TASK_MAX_DISPLAYS; i++)
+    {
+        if (nextion_core_hub.drivers[i] == NULL)
+        {
+            nextion_core_hub.drivers[i] = handle;
+            nextion_core_hub.is_served[i] = false;
+            slot = i;
+        }
+    }
+
+    portEXIT_CRITICAL(&nextion_core_hub.lock);
+
+    CMP_CHECK((slot < CONFIG_NEX_UART_SHARED_TASK_MAX_DISPLAYS), "displays error(too many for the shared UART task)", false)
+
+    // Only an empty queue can join; bytes already received stay buffered.
+    bool is_added = false;
+
+    for (int i = 0; i < NEX_UART_QUEUE_SET_ATTEMPTS && !is_added; i++)
+    {
+        xQueueReset(handle->uart_queue);
+
+        is_added = xQueueAddToSet(handle->uart_queue, nextion_core_hub.queue_set) == pdPASS;
+    }
+
+    if (!is_added)
+    {
+        portENTER_CRITICAL(&nextion_core_hub.lock);
+
+        nextion_core_hub.drivers[slot] = NULL;
+
+        portEXIT_CRITICAL(&nextion_core_hub.lock);
+
+        CMP_LOGE("failed adding UART queue to the set");
+
+        return false;
+    }
+
+    handle->uart_task = nextion_core_hub.task;
+
+    CMP_LOGI("UART %d served by the shared task", handle->uart_num);
+
+    return true;
+}
+
+/**
+ * @brief Detach a driver from the shared UART task, once the task is done with it.
+ * @param handle Nextion context pointer.
+ */
+static void nextion_core_hub_detach(nextion_t *handle)
+{
+    bool is_busy;
+
+    portENTER_CRITICAL(&nextion_core_hub.lock);
+
+    for (size_t slot = 0; slot < CONFIG_NEX_UART_SHARED_TASK_MAX_DISPLAYS; slot++)
+    {
+        if (nextion_core_hub.drivers[slot] == handle)
+        {
+            nextion_core_hub.drivers[slot] = NULL;
+            nextion_core_hub.is_served[slot] = false;
+        }
+    }
+
+    portEXIT_CRITICAL(&nextion_core_hub.lock);
+
+    do
+    {
+        portENTER_CRITICAL(&nextion_core_hub.lock);
+
+        is_busy = nextion_core_hub.busy == handle;
+
+        portEXIT_CRITICAL(&nextion_core_hub.lock);
+
+        if (is_busy)
+        {
+            vTaskDelay(1);
+        }
+    } while (is_busy);
+
+    // Entries the set still has for the queue no longer match a driver; the task skips them.
+    bool is_removed = false;
+
+    for (int i = 0; i < NEX_UART_QUEUE_SET_ATTEMPTS && !is_removed; i++)
+    {
+        xQueueReset(handle->uart_queue);
+
+        is_removed = xQueueRemoveFromSet(handle->uart_queue, nextion_core_hub.queue_set) == pdPASS;
+    }
+
+    if (!is_removed)
+    {
+        CMP_LOGW("failed removing UART queue from the set");
+    }
+}
+
+/**
+ * @brief Get the driver of a slot; it cannot be detached until released.
+ * @param slot Slot index.
+ * @param is_served Location where the served state will be stored.
+ * @return Driver, or NULL when the slot is free; then there is nothing to release.
+ */
+static nextion_t *nextion_core_hub_acquire(size_t slot, bool *is_served)
+{
+    portENTER_CRITICAL(&nextion_core_hub.lock);
+
+    nextion_t *handle = nextion_core_hub.drivers[slot];
+
+    *is_served = nextion_core_hub.is_served[slot];
+    nextion_core_hub.busy = handle;
+
+    portEXIT_CRITICAL(&nextion_core_hub.lock);
+
+    return handle;
+}
+
+/**
+ * @brief Release the driver last acquired.
+ */
+static void nextion_core_hub_release(void)
+{
+    portENTER_CRITICAL(&nextion_core_hub.lock);
+
+    nextion_core_hub.busy = NULL;
+
+    portEXIT_CRITICAL(&nextion_core_hub.lock);
+}
+
+/**
+ * @brief Serve the UARTs of every attached driver, waiting on their event queues at once.
+ * @param pvParameters Not used.
+ */
+static void nextion_core_hub_task(void *pvParameters)
+{
+    TickType_t wait_time = pdMS_TO_TICKS(CONFIG_NEX_UART_RECV_WAIT_TIME_MS);
+    uart_event_t event;
+
+    for (;;)
+    {
+        QueueSetMemberHandle_t queue = xQueueSelectFromSet(nextion_core_hub.queue_set, wait_time);
+
+        for (size_t slot = 0; slot < CONFIG_NEX_UART_SHARED_TASK_MAX_DISPLAYS && queue != NULL; slot++)
+        {
+            bool is_served;
+            nextion_t *handle = nextion_core_hub_acquire(slot, &is_served);
+
+            if (handle == NULL)
+            {
+                continue;
+            }
+
+            if (handle->uart_queue == queue)
+            {
+                // Events of a display not initialized yet are dropped; its bytes stay buffered.
+                if (xQueueReceive(queue, (void *)&event, 0) == pdTRUE && is_served)
+                {
+                    nextion_core_uart_event_process(handle, &event);
+                }
+
+                queue = NULL;
+            }
+
+            nextion_core_hub_release();
+        }
+
+        // Every display waits for its own commands; the nearest deadline wins.
+        wait_time = pdMS_TO_TICKS(CONFIG_NEX_UART_RECV_WAIT_TIME_MS);
+
+        for (size_t slot = 0; slot < CONFIG_NEX_UART_SHARED_TASK_MAX_DISPLAYS; slot++)
+        {
+            bool is_served;
+            nextion_t *handle = nextion_core_hub_acquire(slot, &is_served);
+
+            if (handle == NULL)
+            {
+                continue;
+            }
+
+            if (is_served)
+            {
+                if (handle->is_event_held)
+                {
+                    nextion_core_uart_process(handle);
+                }
+
+                nextion_core_command_check_timeout(handle);
+
+                TickType_t handle_wait_time = nextion_core_uart_wait_time(handle);
+
+                wait_time = handle_wait_time < wait_time ? handle_wait_time : wait_time;
+            }
+
+            nextion_core_hub_release();
+        }
+    }
+}
+#endif
+
+static bool nextion_core_link_is_supported(uint32_t baud_rate)
+{
+    for (size_t i = 0; i < NEX_LINK_BAUD_RATE_COUNT; i++)
+    {
+        if (NEX_LINK_BAUD_RATES[i] == baud_rate)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Look for the baud rate the display is using, trying every supported one.
+ * @param handle Nextion context pointer.
+ * @return True if found, otherwise false and the UART is back at the installed baud rate.
+ */
+static bool nextion_core_link_detect(nextion_t *handle)
+{
+    uint32_t installed = handle->baud_rate;
+
+    for (size_t i = 0; i < NEX_LINK_BAUD_RATE_COUNT; i++)
+    {
+        if (NEX_LINK_BAUD_RATES[i] == installed || !nextion_core_link_set_local(handle, NEX_LINK_BAUD_RATES[i]))
+        {
+            continue;
+        }
+
+        nextion_system_wakeup(handle);
+
+        if (nextion_core_link_probe(handle))
+        {
+            CMP_LOGI("display found at baud rate %lu", (unsigned long)handle->baud_rate);
+
+            return true;
+        }
+    }
+
+    nextion_core_link_set_local(handle, installed);
+
+    return false;
+}
+
+/**
+ * @brief Move the link to the fastest baud rate it sustains, up to CONFIG_NEX_UART_BAUD_RATE_TARGET.
+ * @param handle Nextion context pointer.
+ */
+static void nextion_core_link_negotiate(nextion_t *handle)
+{
+    for (size_t i = 0; i < NEX_LINK_BAUD_RATE_COUNT; i++)
+    {
+        uint32_t baud_rate = NEX_LINK_BAUD_RATES[i];
+
+        if (baud_rate > CONFIG_NEX_UART_BAUD_RATE_TARGET)
+        {
+            continue;
+        }
+
+        // Rates are sorted; nothing below is faster than the current one.
+        if (baud_rate <= handle->baud_rate || nextion_baud_rate_set(handle, baud_rate) == NEX_OK)
+        {
+            break;
+        }
+    }
+
+    CMP_LOGI("negotiated baud rate %lu", (unsigned long)handle->baud_rate);
+}
+
+/**
+ * @brief Ask the display to change its baud rate, follow it and check that it answers.
+ * @note The display answers "baud" at an unknown rate, so it is written without waiting for a response.
+ * @param handle Nextion context pointer.
+ * @param baud_rate New baud rate.
+ * @return True if the display answers at the new baud rate, otherwise false.
+ */
+static bool nextion_core_link_switch(nextion_t *handle, uint32_t baud_rate)
+{
+    char command[16];
+    nextion_command_builder_t builder;
+
+    nextion_command_builder_init(&builder, command, sizeof(command), 0, NULL, NULL);
+    nextion_command_builder_append_identifier(&builder, "baud=");
+    nextion_command_builder_append_uint(&builder, baud_rate);
+    nextion_command_builder_append_end(&builder);
+
+    if (!nextion_core_command_sync_acquire(handle, pdMS_TO_TICKS(CONFIG_NEX_UART_MUTEX_WAIT_TIME_MS)))
+    {
+        CMP_LOGE("failed to take command mutex");
+
+        return false;
+    }
+
+    bool is_written = nextion_core_uart_write_as_byte(handle, command, builder.length);
+
+    nextion_core_command_sync_release(handle);
+
+    if (!is_written)
+    {
+        return false;
+    }
+
+    nextion_transport_stats_on_commands(&handle->stats, 1);
+
+    vTaskDelay(pdMS_TO_TICKS(NEX_LINK_SETTLE_TIME_MS));
+
+    return nextion_core_link_set_local(handle, baud_rate) && nextion_core_link_probe(handle);
+}
+
+/**
+ * @brief Change the ESP32 side of the link, discarding what was received at the previous baud rate.
+ * @param handle Nextion context pointer.
+ * @param baud_rate New baud rate.
+ * @return True if success, otherwise false.
+ */
+static bool nextion_core_link_set_local(nextion_t *handle, uint32_t baud_rate)
+{
+    if (uart_set_baudrate(handle->uart_num, baud_rate) != ESP_OK)
+    {
+        CMP_LOGE("failed setting baud rate %lu", (unsigned long)baud_rate);
+
+        return false;
+    }
+
+    nextion_core_uart_flush(handle);
+
+    portENTER_CRITICAL(&handle->pending_lock);
+
+    handle->recv_resync = true;
+
+    portEXIT_CRITICAL(&handle->pending_lock);
+
+    // Responses of the previous rate are gone with the flush.
+    nextion_core_command_forget_late(handle);
+
+    handle->baud_rate = baud_rate;
+
+    return true;
+}
+
+static bool nextion_core_link_probe(nextion_t *handle)
+{
+    for (int i = 0; i < NEX_LINK_PROBE_ATTEMPTS; i++)
+    {
+        if (nextion_command_send(handle, NEX_LINK_PROBE_COMMAND) == NEX_OK)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Measure the effective throughput with timed probes, round trips included.
+ * @param handle Nextion context pointer.
+ */
+static void nextion_core_link_measure(nextion_t *handle)
+{
+    int64_t start = esp_timer_get_time();
+
+    for (int i = 0; i < NEX_LINK_MEASURE_COUNT; i++)
+    {
+        if (nextion_command_send(handle, NEX_LINK_PROBE_COMMAND) != NEX_OK)
+        {
+            CMP_LOGW("failed measuring throughput");
+
+            return;
+        }
+    }
+
+    int64_t elapsed = esp_timer_get_time() - start;
+
+    handle->throughput = elapsed > 0 ? (uint32_t)((int64_t)NEX_LINK_PROBE_BYTES * NEX_LINK_MEASURE_COUNT * 1000000 / elapsed) : 0;
+
+    CMP_LOGI("baud rate %lu, effective throughput %lu bytes/s", (unsigned long)handle->baud_rate, (unsigned long)handle->throughput);
+}
+
+/**
+ * @brief Drain everything buffered on the UART in bulk reads, completing
+ * pending commands and dispatching events.
+ * @param handle Nextion context pointer.
+ */
+static void nextion_core_uart_process(nextion_t *handle)
+{
+    size_t buffered = 0;
+
+    portENTER_CRITICAL(&handle->pending_lock);
+
+    bool resync = handle->recv_resync;
+    handle->recv_resync = false;
+
+    portEXIT_CRITICAL(&handle->pending_lock);
+
+    // Bytes of a partial frame were sent at the previous baud rate.
+    if (resync)
+    {
+        nextion_core_uart_parser_reset(handle);
+    }
+
+    // While the event queue is full, the bytes stay buffered on the UART.
+    bool is_resumed = nextion_core_event_release(handle) && nextion_core_uart_resume(handle);
+
+    while (is_resumed && uart_get_buffered_data_len(handle->uart_num, &buffered) == ESP_OK && buffered > 0)
+    {
+        size_t size = buffered < CONFIG_NEX_UART_RECV_READ_SIZE ? buffered : CONFIG_NEX_UART_RECV_READ_SIZE;
+
+        // The data is already buffered; do not wait for more.
+        int bytes_read = uart_read_bytes(handle->uart_num, handle->recv_buffer, size, 0);
+
+        if (bytes_read < 0)
+        {
+            CMP_LOGE("failed reading UART");
+            break;
+        }
+
+        if (bytes_read == 0)
+        {
+            break;
+        }
+
+        CMP_LOGD("UART read %d bytes", bytes_read);
+
+        nextion_transport_stats_on_read(&handle->stats, (size_t)bytes_read);
+        nextion_wire_capture_record(&handle->capture, NEX_WIRE_CAPTURE_RX, esp_timer_get_time(), handle->recv_buffer, (size_t)bytes_read);
+
+        handle->recv_offset = 0;
+        handle->recv_length = (size_t)bytes_read;
+
+        is_resumed = nextion_core_uart_resume(handle);
+
+        // A response still arriving is not late; it is just long.
+        nextion_core_command_restart_timeout(handle);
+    }
+
+    if (handle->recv_parser.discarded > 0)
+    {
+        nextion_transport_stats_on_discard(&handle->stats, handle->recv_parser.discarded);
+
+        handle->recv_parser.discarded = 0;
+    }
+}
+
+/**
+ * @brief Parse the bytes read but not parsed yet, starting with the frame a stall left in the parser.
+ * @param handle Nextion context pointer.
+ * @return True if every byte was parsed, false if parsing stalled on a full event queue.
+ */
+static bool nextion_core_uart_resume(nextion_t *handle)
+{
+    if (handle->recv_stalled)
+    {
+        nextion_pending_command_t head;
+        bool has_head = nextion_core_command_head(handle, &head) && !head.is_deferred;
+
+        if (!nextion_core_uart_frame_process(handle, has_head ? &head : NULL))
+        {
+            return false;
+        }
+
+        handle->recv_stalled = false;
+    }
+
+    while (handle->recv_offset < handle->recv_length)
+    {
+        handle->recv_offset += nextion_core_uart_consume(handle, handle->recv_buffer + handle->recv_offset, handle->recv_length - handle->recv_offset);
+
+        if (handle->recv_stalled)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Consume received bytes until a pending command or frame completes.
+ * @param handle Nextion context pointer.
+ * @param bytes Received bytes.
+ * @param count How many bytes were received; must be greater than zero.
+ * @return How many bytes were consumed.
+ */
+static size_t nextion_core_uart_consume(nextion_t *handle, const uint8_t *bytes, size_t count)
+{
+    nextion_pending_command_t head;
+
+    // Commands of a batch not yet written cannot have a response.
+    bool has_head = nextion_core_command_head(handle, &head) && !head.is_deferred;
+
+    if (has_head && head.is_raw && !nextion_frame_parser_is_busy(&handle->recv_parser))
+    {
+        // Raw bytes have no code or termination; they are
+        // counted straight into the command buffer.
+
+        size_t size = head.capacity - head.received;
+
+        if (size > count)
+        {
+            size = count;
+        }
+
+        if (nextion_core_command_store(handle, bytes, size) >= head.capacity)
+        {
+            nextion_transport_stats_on_data(&handle->stats, (uint32_t)(esp_timer_get_time() - head.queued_at));
+            nextion_core_command_complete(handle, NEX_OK);
+        }
+
+        return size;
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        if (nextion_frame_parser_feed(&handle->recv_parser, bytes[i]))
+        {
+            // The head might change with this frame; look it up again for the next bytes.
+
+            // A stalled frame stays in the parser until the event queue has room.
+            handle->recv_stalled = !nextion_core_uart_frame_process(handle, has_head ? &head : NULL);
+
+            return i + 1;
+        }
+    }
+
+    return count;
+}
+
+/**
+ * @brief Discard the partial frame and the bytes read but not parsed yet.
+ * @note A held event is complete; it is kept.
+ * @param handle Nextion context pointer.
+ */
+static void nextion_core_uart_parser_reset(nextion_t *handle)
+{
+    nextion_frame_parser_reset(&handle->recv_parser);
+
+    handle->recv_offset = 0;
+    handle->recv_length = 0;
+    handle->recv_stalled = false;
+}
+
+/**
+ * @brief Handle the frame completed by the parser, either as an event
+ * or as the response of the oldest pending command.
+ * @param handle Nextion context pointer.
+ * @param head Oldest pending command, or NULL if there is none.
+ * @return True if the frame was handled, false if it is an event and the event queue is full.
+ */
+static bool nextion_core_uart_frame_process(nextion_t *handle, const nextion_pending_command_t *head)
+{
+    const uint8_t *frame = handle->recv_parser.frame;
+    const size_t length = handle->recv_parser.length;
+
+    CMP_LOGD("parsed frame %d with size %u", frame[0], (unsigned int)length);
+
+    if (NEX_DVC_CODE_IS_EVENT(frame[0], length))
+    {
+        // One event can wait for room on the side, so responses behind it
+        // still complete; another one has to wait in the parser.
+        if (!nextion_core_event_release(handle))
+        {
+            return false;
+        }
+
+        // Events can arrive at any time, even between a command and its
+        // response. Their callbacks run on the event task, so they neither
+        // delay responses nor are delayed by them.
+
+        // The device forgot everything it was told; commands after
+        // this one must not rely on the cache.
+        if (frame[0] == NEX_DVC_EVT_HARDWARE_START_RESET || frame[0] == NEX_DVC_EVT_HARDWARE_READY)
+        {
+            nextion_component_cache_invalidate(&handle->component_cache);
+            nextion_core_command_forget_late(handle);
+        }
+
+        if (head != NULL)
+        {
+            nextion_transport_stats_on_event_parsed(&handle->stats);
+        }
+
+        nextion_core_event_enqueue(handle, frame, length);
+
+        return true;
+    }
+
+    // Pages using "sendme" report the page change by themselves.
+    bool is_page_report = head == NULL && frame[0] == NEX_DVC_RSP_SENDME_RESULT;
+
+    if (!is_page_report && nextion_core_command_drop_late(handle, head))
+    {
+        return true;
+    }
+
+    if (head == NULL)
+    {
+        if (is_page_report)
+        {
+            nextion_component_cache_invalidate(&handle->component_cache);
+
+            return true;
+        }
+
+        CMP_LOGW("response code %d was not expected, some data might be corrupted", frame[0]);
+
+        nextion_transport_stats_on_unexpected(&handle->stats);
+
+        return true;
+    }
+
+    uint32_t latency = (uint32_t)(esp_timer_get_time() - head->queued_at);
+
+    if (head->buffer != NULL && !head->is_raw)
+    {
+        nextion_transport_stats_on_data(&handle->stats, latency);
+        nextion_core_command_store(handle, frame, length);
+        nextion_core_command_complete(handle, NEX_OK);
+
+        return true;
+    }
+
+    nextion_transport_stats_on_ack(&handle->stats, frame[0], latency);
+
+    if (length != NEX_DVC_CMD_ACK_LENGTH)
+    {
+        CMP_LOGE("invalid response size, expected %d but received %u", NEX_DVC_CMD_ACK_LENGTH, (unsigned int)length);
+
+        nextion_core_command_complete(handle, NEX_DVC_INSTRUCTION_FAIL);
+
+        return true;
+    }
+
+    nextion_core_command_complete(handle, frame[0]);
+
+    return true;
+}
+
+/**
+ * @brief Queue the held event, if any.
+ * @note Must be called by the UART task; it is the only producer.
+ * @param handle Nextion context pointer.
+ * @return True if no event is held anymore, false if the event queue is still full.
+ */
+static bool nextion_core_event_release(nextion_t *handle)
+{
+    if (!handle->is_event_held)
+    {
+        return true;
+    }
+
+    if (!nextion_event_ring_push(&handle->event_ring, handle->event_held.frame, handle->event_held.length))
+    {
+        return false;
+    }
+
+    handle->is_event_held = false;
+
+    xTaskNotifyGive(handle->event_task);
+
+    return true;
+}
+
+#ifdef CONFIG_NEX_EVENT_DROP_WHEN_FULL
+/**
+ * @brief Queue an event for the event task. Waits up to a response
+ * wait time for room before dropping it; with a shared UART task, it is
+ * dropped at once, since waiting would stall the other displays.
+ * @note Must be called by the UART task; it is the only producer.
+ * @param handle Nextion context pointer.
+ * @param frame Event frame.
+ * @param length Frame length.
+ */
+static void nextion_core_event_enqueue(nextion_t *handle, const uint8_t *frame, size_t length)
+{
+    const TickType_t started_at = xTaskGetTickCount();
+#ifdef CONFIG_NEX_UART_SHARED_TASK
+    const TickType_t wait_time = 0;
+#else
+    const TickType_t wait_time = pdMS_TO_TICKS(CONFIG_NEX_UART_RECV_WAIT_TIME_MS);
+#endif
+
+    while (!nextion_event_ring_push(&handle->event_ring, frame, length))
+    {
+        // The event task notifies this task whenever it makes room.
+
+        TickType_t elapsed = xTaskGetTickCount() - started_at;
+
+        if (elapsed >= wait_time || ulTaskNotifyTake(pdTRUE, wait_time - elapsed) == 0)
+        {
+            atomic_fetch_add(&handle->event_ring.dropped, 1);
+
+            CMP_LOGW("event queue full, event %d dropped", frame[0]);
+
+            return;
+        }
+    }
+
+    xTaskNotifyGive(handle->event_task);
+}
+#else
+/**
+ * @brief Queue an event for the event task, or hold it until there is room.
+ * @note Must be called by the UART task, with no event held.
+ * @param handle Nextion context pointer.
+ * @param frame Event frame.
+ * @param length Frame length.
+ */
+static void nextion_core_event_enqueue(nextion_t *handle, const uint8_t *frame, size_t length)
+{
+    if (nextion_event_ring_push(&handle->event_ring, frame, length))
+    {
+        xTaskNotifyGive(handle->event_task);
+
+        return;
+    }
+
+    CMP_LOGD("event queue full, event %d held", frame[0]);
+
+    if (length > NEX_DVC_EVT_MAX_RESPONSE_LENGTH)
+    {
+        length = NEX_DVC_EVT_MAX_RESPONSE_LENGTH;
+    }
+
+    memcpy(handle->event_held.frame, frame, length);
+
+    handle->event_held.length = (uint8_t)length;
+    handle->is_event_held = true;
+}
+#endif
+
+/**
+ * @brief Run the callbacks of queued events, outside of the UART task.
+ * @param pvParameters Nextion context pointer.
+ */
+static void nextion_core_event_task(void *pvParameters)
+{
+    nextion_t *handle = (nextion_t *)pvParameters;
+    nextion_event_ring_entry_t entry;
+
+    for (;;)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        while (nextion_event_ring_pop(&handle->event_ring, &entry))
+        {
+#if defined(CONFIG_NEX_EVENT_DROP_WHEN_FULL) && !defined(CONFIG_NEX_UART_SHARED_TASK)
+            // The UART task might be waiting for room.
+            xTaskNotifyGive(handle->uart_task);
+#endif
+
+            if (!nextion_core_event_dispatch(handle, entry.frame, entry.length))
+            {
+                CMP_LOGW("failure dispatching event %d", entry.frame[0]);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Flush the EEPROM cache once it has been dirty for the flush delay.
+ * @param pvParameters Nextion context pointer.
+ */
+static void nextion_core_eeprom_flush_task(void *pvParameters)
+{
+    nextion_t *handle = (nextion_t *)pvParameters;
+
+    for (;;)
+    {
+        TickType_t flush_wait;
+
+        // Notified when the cache becomes dirty.
+        if (!nextion_eeprom_cache_flush_wait(&handle->eeprom_cache, &flush_wait))
+        {
+            flush_wait = portMAX_DELAY;
+        }
+
+        if (flush_wait > 0)
+        {
+            ulTaskNotifyTake(pdTRUE, flush_wait);
+        }
+
+        if (nextion_eeprom_cache_flush_wait(&handle->eeprom_cache, &flush_wait) && flush_wait == 0)
+        {
+            // A failure postpones the next try.
+            nextion_eeprom_flush_on_time(handle);
+        }
+    }
+}
+
+/**
+ * @brief Dispatches an event to a callback.
+ * @param handle Nextion context pointer.
+ * @param buffer Buffer containing event data.
+ * @param buffer_length Buffer length.
+ * @return True if success, otherwise, false.
+ */
+static bool nextion_core_event_dispatch(nextion_t *handle, const uint8_t *buffer, const size_t buffer_length)
+{
+    CMP_CHECK((buffer_length >= NEX_DVC_CMD_ACK_LENGTH), "buffer length error(<NEX_DVC_CMD_ACK_LENGTH)", false)
+
+    const uint8_t code = buffer[0];
+
+    CMP_LOGD("preparing event %d", code);
+
+    switch (code)
+    {
+    case NEX_DVC_EVT_TOUCH_OCCURRED:
+        nextion_transport_stats_on_event_dispatched(&handle->stats, NEXTION_STATS_EVENT_TOUCH);
+
+        if (buffer_length == 7 && handle->event_callback_on_touch != NULL)
+        {
+            nextion_on_touch_event_t event = {
+                .handle = handle,
+                .page_id = buffer[1],
+                .component_id = buffer[2],
+                .state = buffer[3]};
+
+            CMP_LOGD("dispatching 'on touch' event");
+
+            handle->event_callback_on_touch(event);
+        }
+        break;
+    case NEX_DVC_EVT_TOUCH_COORDINATE_AWAKE:
+    case NEX_DVC_EVT_TOUCH_COORDINATE_ASLEEP:
+        nextion_transport_stats_on_event_dispatched(&handle->stats, NEXTION_STATS_EVENT_TOUCH_COORD);
+
+        if (handle->event_callback_on_touch_coord != NULL && buffer_length == 9)
+        {
+            // Coordinates: 2 bytes and unsigned = uint16_t.
+            // Sent in big endian format.
+            nextion_on_touch_coord_event_t event = {
+                .handle = handle,
+                .x = (uint16_t)(((uint16_t)buffer[1] << 8) | (uint16_t)buffer[2]),
+                .y = (uint16_t)(((uint16_t)buffer[3] << 8) | (uint16_t)buffer[4]),
+                .state = buffer[5],
+                .exited_sleep = code == NEX_DVC_EVT_TOUCH_COORDINATE_ASLEEP};
+
+            CMP_LOGD("dispatching 'on touch coord' event");
+
+            handle->event_callback_on_touch_coord(event);
+        }
+        break;
+    default:
+        nextion_transport_stats_on_event_dispatched(&handle->stats, NEXTION_STATS_EVENT_DEVICE);
+
+        if (handle->event_callback_on_device != NULL)
+        {
+            nextion_on_device_event_t event = {
+                .handle = handle,
+                .state = code};
+
+            CMP_LOGD("dispatching 'on device' event");
+
+            handle->event_callback_on_device(event);
+        }
+    }
+
+    return true;
+}
+
+static bool nextion_core_command_sync_acquire(nextion_t *handle, TickType_t timeout)
+{
+    // The batch owner holds the sync until the batch ends.
+    if (nextion_core_batch_is_owner(handle))
+    {
+        return true;
+    }
+
+    // Only the UART task completes commands; from a completion callback it would wait for itself.
+    if (xTaskGetCurrentTaskHandle() == handle->uart_task)
+    {
+        CMP_LOGE("sync error(called from the UART task)");
+
+        return false;
+    }
+
+    int64_t started_at = esp_timer_get_time();
+    bool is_acquired = xSemaphoreTake(handle->command_sync, timeout) == pdTRUE;
+
+    nextion_transport_stats_on_sync(&handle->stats, (uint32_t)(esp_timer_get_time() - started_at), is_acquired);
+
+    return is_acquired;
+}
+
+static void nextion_core_command_sync_release(nextion_t *handle)
+{
+    if (nextion_core_batch_is_owner(handle))
+    {
+        return;
+    }
+
+    xSemaphoreGive(handle->command_sync);
+}
+
+static bool nextion_core_batch_is_owner(const nextion_t *handle)
+{
+    return handle->batch_owner != NULL && handle->batch_owner == xTaskGetCurrentTaskHandle();
+}
+
+/**
+ * @brief Format a command at the end of the batch buffer and queue it as
+ * deferred. The buffer is written first if there is no room for the command
+ * or no free slot in the command queue.
+ * @details Only whole commands reach the wire: one is added to the buffer
+ * once formatted with its termination, and one longer than the buffer is
+ * formatted once without writing anything before being written in pieces.
+ * @note Must be called by the batch owner.
+ * @param handle Nextion context pointer.
+ * @param pending Pending command data.
+ * @param format Command format.
+ * @param args Command format arguments.
+ * @return True if success, otherwise false.
+ */
+static bool nextion_core_batch_append(nextion_t *handle, nextion_pending_command_t *pending, const char *format, va_list args)
+{
+    // Queued commands are only answered after being written;
+    // waiting for a free slot would never end.
+    if (uxSemaphoreGetCount(handle->pending_slots) == 0 && !nextion_core_batch_flush(handle))
+    {
+        return false;
+    }
+
+    pending->is_deferred = true;
+
+    size_t start = handle->batch_length;
+    bool is_added = nextion_core_batch_build(handle, format, args);
+
+    if (!is_added)
+    {
+        if (!nextion_core_batch_flush(handle))
+        {
+            return false;
+        }
+
+        start = 0;
+        is_added = nextion_core_batch_build(handle, format, args);
+    }
+
+    // Nothing is written while building, so it can be queued afterwards.
+    if (is_added)
+    {
+        if (!nextion_core_command_enqueue(handle, pending))
+        {
+            // Unanswerable without its pending command.
+            handle->batch_length = start;
+
+            return false;
+        }
+
+        return true;
+    }
+
+    // Not even the whole buffer holds it; make sure it formats before writing any piece.
+
+    nextion_command_builder_t builder;
+    va_list copy;
+
+    nextion_command_builder_init(&builder,
+                                 handle->command_format_buffer,
+                                 CONFIG_NEX_UART_TRANS_COMMAND_FORMAT_BUFFER_SIZE,
+                                 0,
+                                 &nextion_core_batch_discard,
+                                 NULL);
+
+    va_copy(copy, args);
+
+    bool is_valid = nextion_core_command_build(&builder, format, copy);
+
+    va_end(copy);
+
+    if (!is_valid)
+    {
+        CMP_LOGE("failed formatting command");
+
+        return false;
+    }
+
+    // A command written in pieces cannot be answered before its termination is written.
+
+    nextion_command_builder_init(&builder,
+                                 handle->batch_buffer,
+                                 CONFIG_NEX_UART_BATCH_BUFFER_SIZE,
+                                 handle->batch_length,
+                                 &nextion_core_batch_write,
+                                 (void *)handle);
+
+    va_copy(copy, args);
+
+    bool is_built = nextion_core_command_build(&builder, format, copy);
+
+    va_end(copy);
+
+    handle->batch_length = builder.length;
+
+    if (!is_built || !nextion_core_command_enqueue(handle, pending))
+    {
+        return false;
+    }
+
+    bool is_ended = nextion_command_builder_append_end(&builder);
+
+    handle->batch_length = builder.length;
+
+    return is_ended;
+}
+
+/**
+ * @brief Format a whole command, with its termination, in the room left in the batch buffer.
+ * @param handle Nextion context pointer.
+ * @param format Command format.
+ * @param args Command format arguments.
+ * @return True if it was added, false if it does not fit or does not format; then the buffer is as it was.
+ */
+static bool nextion_core_batch_build(nextion_t *handle, const char *format, va_list args)
+{
+    nextion_command_builder_t builder;
+    va_list copy;
+
+    nextion_command_builder_init(&builder,
+                                 handle->batch_buffer,
+                                 CONFIG_NEX_UART_BATCH_BUFFER_SIZE,
+                                 handle->batch_length,
+                                 NULL,
+                                 NULL);
+
+    va_copy(copy, args);
+
+    bool is_built = nextion_core_command_build(&builder, format, copy) && nextion_command_builder_append_end(&builder);
+
+    va_end(copy);
+
+    if (is_built)
+    {
+        handle->batch_length = builder.length;
+    }
+
+    return is_built;
+}
+
+/**
+ * @brief Flush function of the batch builder.
+ * @param context Nextion context pointer.
+ * @param data The batch buffer.
+ * @param length How many bytes of the batch buffer are used.
+ * @return True if success, otherwise false.
+ */
+static bool nextion_core_batch_write(void *context, const char *data, size_t length)
+{
+    nextion_t *handle = (nextion_t *)context;
+
+    handle->batch_length = length;
+
+    return nextion_core_batch_flush(handle);
+}
+
+/**
+ * @brief Flush function that only checks a command formats, writing nothing.
+ * @param context Unused.
+ * @param data Unused.
+ * @param length Unused.
+ * @return Always true.
+ */
+static bool nextion_core_batch_discard(void *context, const char *data, size_t length)
+{
+    return true;
+}
+
+/**
+ * @brief Write the batch buffer at once and release its deferred commands,
+ * so they can time out.
+ * @param handle Nextion context pointer.
+ * @return True if success or if there is nothing to write, otherwise false.
+ */
+static bool nextion_core_batch_flush(nextion_t *handle)
+{
+    if (handle->batch_length == 0)
+    {
+        return true;
+    }
+
+    // Responses can arrive before the write returns, so the commands are
+    // released first; their deadlines include the time to write the batch.
+
+    TickType_t write_time = pdMS_TO_TICKS((uint64_t)handle->batch_length * 10U * 1000U / handle->baud_rate) + 1;
+    uint32_t first_sequence = 0;
+    size_t released = 0;
+
+    portENTER_CRITICAL(&handle->pending_lock);
+
+    TickType_t now = xTaskGetTickCount();
+    int64_t now_us = esp_timer_get_time();
+
+    for (size_t i = 0; i < handle->pending_count; i++)
+    {
+        nextion_pending_command_t *pending = &handle->pending[(handle->pending_head + i) % CONFIG_NEX_UART_COMMAND_QUEUE_SIZE];
+
+        if (!pending->is_deferred)
+        {
+            continue;
+        }
+
+        if (released++ == 0)
+        {
+            first_sequence = pending->sequence;
+        }
+
+        pending->is_deferred = false;
+        pending->deadline = now + write_time + pdMS_TO_TICKS(CONFIG_NEX_UART_RECV_WAIT_TIME_MS);
+        pending->queued_at = now_us;
+    }
+
+    portEXIT_CRITICAL(&handle->pending_lock);
+
+    bool written = nextion_core_uart_write_as_byte(handle, handle->batch_buffer, handle->batch_length);
+
+    handle->batch_length = 0;
+
+    if (written)
+    {
+        nextion_transport_stats_on_commands(&handle->stats, released);
+    }
+    else
+    {
+        for (size_t i = 0; i < released; i++)
+        {
+            nextion_core_command_set_write_failed(handle, first_sequence + i);
+        }
+    }
+
+    return written;
+}
+
+static nex_err_t nextion_core_command_code_normalize(nex_err_t code)
+{
+    if (code == NEX_DVC_INSTRUCTION_FAIL)
+    {
+        return NEX_FAIL;
+    }
+
+    if (code == NEX_DVC_INSTRUCTION_OK)
+    {
+        return NEX_OK;
+    }
+
+    return code;
+}
+
+/**
+ * @brief Queue a pending command. Blocks while the queue is full.
+ * @note The command sync must be held, and the command must be written
+ * right after; the response might arrive before the write returns.
+ * @param handle Nextion context pointer.
+ * @param pending Pending command data; the deadline and sequence are set here.
+ * @return True if queued, otherwise false.
+ */
+static bool nextion_core_command_enqueue(nextion_t *handle, nextion_pending_command_t *pending)
+{
+    if (xSemaphoreTake(handle->pending_slots, pdMS_TO_TICKS(NEX_COMMAND_COMPLETION_WAIT_TIME_MS)) != pdTRUE)
+    {
+        CMP_LOGE("failed queueing command(queue full)");
+
+        return false;
+    }
+
+    portENTER_CRITICAL(&handle->pending_lock);
+
+    size_t index = (handle->pending_head + handle->pending_count) % CONFIG_NEX_UART_COMMAND_QUEUE_SIZE;
+
+    pending->sequence = ++handle->pending_sequence;
+    pending->deadline = xTaskGetTickCount() + pdMS_TO_TICKS(CONFIG_NEX_UART_RECV_WAIT_TIME_MS);
+    pending->queued_at = esp_timer_get_time();
+    pending->write_failed = false;
+
+    handle->pending[index] = *pending;
+    handle->pending_count++;
+
+    portEXIT_CRITICAL(&handle->pending_lock);
+
+    return true;
+}
+
+/**
+ * @brief Mark a queued command as not written, so the UART task
+ * completes it with failure right away.
+ * @param handle Nextion context pointer.
+ * @param sequence Sequence number of the command.
+ */
+static void nextion_core_command_set_write_failed(nextion_t *handle, uint32_t sequence)
+{
+    portENTER_CRITICAL(&handle->pending_lock);
+
+    for (size_t i = 0; i < handle->pending_count; i++)
+    {
+        nextion_pending_command_t *pending = &handle->pending[(handle->pending_head + i) % CONFIG_NEX_UART_COMMAND_QUEUE_SIZE];
+
+        if (pending->sequence == sequence)
+        {
+            pending->write_failed = true;
+            pending->deadline = xTaskGetTickCount();
+            break;
+        }
+    }
+
+    portEXIT_CRITICAL(&handle->pending_lock);
+}
+
+/**
+ * @brief Give a queued command more time to be answered.
+ * @param handle Nextion context pointer.
+ * @param sequence Sequence number of the command.
+ * @param ticks Time added to its deadline.
+ */
+static void nextion_core_command_extend_deadline(nextion_t *handle, uint32_t sequence, TickType_t ticks)
+{
+    portENTER_CRITICAL(&handle->pending_lock);
+
+    for (size_t i = 0; i < handle->pending_count; i++)
+    {
+        nextion_pending_command_t *pending = &handle->pending[(handle->pending_head + i) % CONFIG_NEX_UART_COMMAND_QUEUE_SIZE];
+
+        if (pending->sequence == sequence)
+        {
+            pending->deadline += ticks;
+            break;
+        }
+    }
+
+    portEXIT_CRITICAL(&handle->pending_lock);
+}
+
+/**
+ * @brief Detach a queued command from its caller buffer, so the
+ * UART task does not write to it.
+ * @param handle Nextion context pointer.
+ * @param sequence Sequence number of the command.
+ */
+static void nextion_core_command_abandon(nextion_t *handle, uint32_t sequence)
+{
+    portENTER_CRITICAL(&handle->pending_lock);
+
+    for (size_t i = 0; i < handle->pending_count; i++)
+    {
+        nextion_pending_command_t *pending = &handle->pending[(handle->pending_head + i) % CONFIG_NEX_UART_COMMAND_QUEUE_SIZE];
+
+        if (pending->sequence == sequence)
+        {
+            pending->buffer = NULL;
+            pending->length = NULL;
+            break;
+        }
+    }
+
+    portEXIT_CRITICAL(&handle->pending_lock);
+}
+
+/**
+ * @brief Wait for a synchronous command to be completed by the UART task.
+ * @note The command sync must be held.
+ * @param handle Nextion context pointer.
+ * @param sequence Sequence number of the command.
+ * @return The response code, NEX_TIMEOUT or NEX_FAIL.
+ */
+static nex_err_t nextion_core_command_wait(nextion_t *handle, uint32_t sequence)
+{
+    const TickType_t started_at = xTaskGetTickCount();
+    const TickType_t wait_time = pdMS_TO_TICKS(NEX_COMMAND_COMPLETION_WAIT_TIME_MS);
+
+    for (;;)
+    {
+        portENTER_CRITICAL(&handle->pending_lock);
+        bool completed = handle->completed_sequence == sequence;
+        nex_err_t code = handle->completed_result;
+        portEXIT_CRITICAL(&handle->pending_lock);
+
+        if (completed)
+        {
+            return code;
+        }
+
+        // "command_done" might have been given by an older command;
+        // keep waiting until ours is completed.
+
+        TickType_t elapsed = xTaskGetTickCount() - started_at;
+
+        if (elapsed >= wait_time || xSemaphoreTake(handle->command_done, wait_time - elapsed) != pdTRUE)
+        {
+            CMP_LOGE("failed waiting command completion");
+
+            // The caller buffer might be gone by the time a response arrives.
+            nextion_core_command_abandon(handle, sequence);
+
+            return NEX_TIMEOUT;
+        }
+    }
+}
+
+/**
+ * @brief Append a command to a builder.
+ * @param builder Builder pointer.
+ * @param format Command format, or "NEX_COMMAND_BUILT_FORMAT" for a command already built.
+ * @param args Command format arguments.
+ * @return True if success, otherwise false.
+ */
+static bool nextion_core_command_build(nextion_command_builder_t *builder, const char *format, va_list args)
+{
+    if (format == NEX_COMMAND_BUILT_FORMAT)
+    {
+        return nextion_command_builder_append_identifier(builder, va_arg(args, const char *));
+    }
+
+    return nextion_command_builder_append_format(builder, format, args);
+}
+
+/**
+ * @brief Queue a command, write it and wait for its response.
+ * @note The command sync must be held.
+ * @param handle Nextion context pointer.
+ * @param buffer Where the response bytes will be stored; NULL to wait for a simple response (ACK).
+ * @param length Buffer length. Updated with the received bytes count.
+ * @param is_raw If the response is raw bytes, without code or termination.
+ * @param is_quiet If it is only answered on failure.
+ * @param format Command format.
+ * @param args Command format arguments.
+ * @return The response code, NEX_TIMEOUT or NEX_FAIL.
+ */
+static nex_err_t nextion_core_command_submit_sync(nextion_t *handle, uint8_t *buffer, size_t *length, bool is_raw, bool is_quiet, const char *format, va_list args)
+{
+    nextion_pending_command_t pending = {
+        .buffer = buffer,
+        .length = length,
+        .capacity = length != NULL ? *length : 0,
+        .is_sync = true,
+        .is_raw = is_raw,
+        .is_quiet = is_quiet};
+
+    // Inside a batch, the commands before this one must be written first.
+    if (nextion_core_batch_is_owner(handle) && !nextion_core_batch_flush(handle))
+    {
+        return NEX_FAIL;
+    }
+
+    if (!nextion_core_command_enqueue(handle, &pending))
+    {
+        return NEX_FAIL;
+    }
 
-    while (bytes_read > -1)
+    if (!nextion_core_uart_write_as_command(handle, format, args))
     {
-        CMP_LOGD("parsed event %d with size %d", buffer[0], bytes_read);
+        CMP_LOGE("failed sending command");
 
-        if (!NEX_DVC_CODE_IS_EVENT(buffer[0], bytes_read))
-        {
-            CMP_LOGW("response code %d was not an event, some data might be corrupted", buffer[0]);
+        nextion_core_command_set_write_failed(handle, pending.sequence);
+    }
 
-            return false;
-        }
+    return nextion_core_command_wait(handle, pending.sequence);
+}
 
-        if (!nextion_core_event_dispatch(handle, buffer, bytes_read))
-        {
-            CMP_LOGW("failure dispatching event from event handler");
+/**
+ * @brief Send a command and wait for its response; inside a batch, it is only added.
+ * @param handle Nextion context pointer.
+ * @param is_quiet If it is only answered on failure.
+ * @param command Command format.
+ * @param args Command format arguments.
+ * @return NEX_OK or NEX_FAIL | NEX_TIMEOUT | NEX_DVC_ERR_* codes.
+ */
+static nex_err_t nextion_core_command_send_variadic(nextion_t *handle, bool is_quiet, const char *command, va_list args)
+{
+    CMP_CHECK_SEND_COMMAND_HANDLE_STATE(handle)
+    CMP_CHECK((command != NULL), "command error(NULL)", NEX_FAIL)
+    CMP_CHECK((nextion_core_command_sync_acquire(handle, pdMS_TO_TICKS(CONFIG_NEX_UART_MUTEX_WAIT_TIME_MS))), "sync error(not acquired)", NEX_FAIL)
 
-            return false;
-        }
+    if (nextion_core_batch_is_owner(handle))
+    {
+        // The response will be checked when the batch ends.
+
+        nextion_pending_command_t pending = {
+            .is_sync = false,
+            .is_quiet = is_quiet};
 
-        bytes_read = (int)nextion_core_uart_read_as_byte(handle, buffer, NEX_DVC_EVT_MAX_RESPONSE_LENGTH);
+        return nextion_core_batch_append(handle, &pending, command, args) ? NEX_OK : NEX_FAIL;
     }
 
-    return true;
+    nex_err_t code = nextion_core_command_submit_sync(handle, NULL, NULL, false, is_quiet, command, args);
+
+    nextion_core_command_sync_release(handle);
+
+    if (code == NEX_DVC_INSTRUCTION_FAIL)
+    {
+        CMP_LOGW("device returned failure");
+    }
+
+    return nextion_core_command_code_normalize(code);
 }
 
 /**
- * @brief Dispatches an event to a callback.
+ * @brief Send a command and wait for the bytes it returns.
  * @param handle Nextion context pointer.
- * @param buffer Buffer containing event data.
- * @param buffer_length Buffer length.
- * @return True if success, otherwise, false.
+ * @param buffer Where the response bytes will be stored.
+ * @param length Buffer length. Updated with the received bytes count.
+ * @param is_raw If the response is raw bytes, without code or termination.
+ * @param format Command format.
+ * @param args Command format arguments.
+ * @return The response code, NEX_TIMEOUT or NEX_FAIL.
  */
-static bool nextion_core_event_dispatch(nextion_t *handle, const uint8_t *buffer, const size_t buffer_length)
+static nex_err_t nextion_core_command_send_get_bytes_variadic(nextion_t *handle, uint8_t *buffer, size_t *length, bool is_raw, const char *format, va_list args)
 {
-    CMP_CHECK((buffer_length >= NEX_DVC_CMD_ACK_LENGTH), "buffer length error(<NEX_DVC_CMD_ACK_LENGTH)", false)
+    CMP_CHECK_SEND_COMMAND_HANDLE_STATE(handle)
+    CMP_CHECK((format != NULL), "command error(NULL)", NEX_FAIL)
+    CMP_CHECK((buffer != NULL), "buffer error(NULL)", NEX_FAIL)
+    CMP_CHECK((length != NULL), "length error(NULL)", NEX_FAIL)
+    CMP_CHECK((*length > 0), "length error(0)", NEX_FAIL)
+    CMP_CHECK((nextion_core_command_sync_acquire(handle, pdMS_TO_TICKS(CONFIG_NEX_UART_MUTEX_WAIT_TIME_MS))), "sync error(not acquired)", NEX_FAIL)
 
-    const uint8_t code = buffer[0];
+    nex_err_t code = nextion_core_command_submit_sync(handle, buffer, length, is_raw, false, format, args);
 
-    CMP_LOGD("preparing event %d", code);
+    nextion_core_command_sync_release(handle);
 
-    switch (code)
+    return code;
+}
+
+/**
+ * @brief Append received bytes to the buffer of the oldest pending command.
+ * @details Bytes that do not fit, or whose command was abandoned, are dropped.
+ * @param handle Nextion context pointer.
+ * @param data Received bytes.
+ * @param length How many bytes were received.
+ * @return How many bytes the command received so far, including dropped ones.
+ */
+static size_t nextion_core_command_store(nextion_t *handle, const uint8_t *data, size_t length)
+{
+    portENTER_CRITICAL(&handle->pending_lock);
+
+    if (handle->pending_count == 0)
     {
-    case NEX_DVC_EVT_TOUCH_OCCURRED:
-        if (buffer_length == 7 && handle->event_callback_on_touch != NULL)
-        {
-            nextion_on_touch_event_t event = {
-                .handle = handle,
-                .page_id = buffer[1],
-                .component_id = buffer[2],
-                .state = buffer[3]};
+        portEXIT_CRITICAL(&handle->pending_lock);
+        return 0;
+    }
 
-            CMP_LOGD("dispatching 'on touch' event");
+    nextion_pending_command_t *pending = &handle->pending[handle->pending_head];
 
-            handle->event_callback_on_touch(event);
-        }
-        break;
-    case NEX_DVC_EVT_TOUCH_COORDINATE_AWAKE:
-    case NEX_DVC_EVT_TOUCH_COORDINATE_ASLEEP:
-        if (handle->event_callback_on_touch_coord != NULL && buffer_length == 9)
-        {
-            // Coordinates: 2 bytes and unsigned = uint16_t.
-            // Sent in big endian format.
-            nextion_on_touch_coord_event_t event = {
-                .handle = handle,
-                .x = (uint16_t)(((uint16_t)buffer[1] << 8) | (uint16_t)buffer[2]),
-                .y = (uint16_t)(((uint16_t)buffer[3] << 8) | (uint16_t)buffer[4]),
-                .state = buffer[5],
-                .exited_sleep = code == NEX_DVC_EVT_TOUCH_COORDINATE_ASLEEP};
+    if (pending->buffer != NULL && pending->received < pending->capacity)
+    {
+        size_t size = pending->capacity - pending->received;
 
-            CMP_LOGD("dispatching 'on touch coord' event");
+        memcpy(pending->buffer + pending->received, data, size < length ? size : length);
+    }
 
-            handle->event_callback_on_touch_coord(event);
+    pending->received += length;
+
+    size_t received = pending->received;
+
+    portEXIT_CRITICAL(&handle->pending_lock);
+
+    return received;
+}
+
+/**
+ * @brief Complete the oldest pending command.
+ * @param handle Nextion context pointer.
+ * @param code Response code.
+ */
+static void nextion_core_command_complete(nextion_t *handle, nex_err_t code)
+{
+    portENTER_CRITICAL(&handle->pending_lock);
+
+    if (handle->pending_count == 0)
+    {
+        portEXIT_CRITICAL(&handle->pending_lock);
+        return;
+    }
+
+    nextion_pending_command_t pending = handle->pending[handle->pending_head];
+
+    handle->pending_head = (handle->pending_head + 1) % CONFIG_NEX_UART_COMMAND_QUEUE_SIZE;
+    handle->pending_count--;
+
+    // The next command had its response delayed by this one;
+    // restart its timeout.
+    if (handle->pending_count > 0)
+    {
+        handle->pending[handle->pending_head].deadline = xTaskGetTickCount() + pdMS_TO_TICKS(CONFIG_NEX_UART_RECV_WAIT_TIME_MS);
+    }
+
+    if (pending.write_failed)
+    {
+        code = NEX_FAIL;
+    }
+
+    if (pending.length != NULL)
+    {
+        *pending.length = pending.received < pending.capacity ? pending.received : pending.capacity;
+    }
+
+    if (pending.is_sync)
+    {
+        handle->completed_sequence = pending.sequence;
+        handle->completed_result = code;
+
+        if (pending.sequence == handle->transparent_data_mode_sequence)
+        {
+            handle->transparent_data_mode_result = code;
         }
-        break;
-    default:
-        if (handle->event_callback_on_device != NULL)
+    }
+    else
+    {
+        code = nextion_core_command_code_normalize(code);
+
+        if (code != NEX_OK && handle->async_result == NEX_OK)
         {
-            nextion_on_device_event_t event = {
-                .handle = handle,
-                .state = code};
+            handle->async_result = code;
+        }
+    }
 
-            CMP_LOGD("dispatching 'on device' event");
+    bool signal = pending.is_sync || handle->pending_count == 0;
 
-            handle->event_callback_on_device(event);
-        }
+    portEXIT_CRITICAL(&handle->pending_lock);
+
+    if (!pending.is_sync && pending.callback != NULL)
+    {
+        pending.callback(handle, code, pending.context);
     }
 
-    return true;
-}
+    xSemaphoreGive(handle->pending_slots);
 
-static bool nextion_core_command_sync_acquire(nextion_t *handle, TickType_t timeout)
-{
-    return xSemaphoreTake(handle->command_sync, timeout) == pdTRUE;
+    if (signal)
+    {
+        xSemaphoreGive(handle->command_done);
+    }
 }
 
-static void nextion_core_command_sync_release(nextion_t *handle)
+/**
+ * @brief Get a copy of the oldest pending command.
+ * @param handle Nextion context pointer.
+ * @param pending Location where the copy will be stored.
+ * @return True if there is a pending command, otherwise false.
+ */
+static bool nextion_core_command_head(nextion_t *handle, nextion_pending_command_t *pending)
 {
-    xSemaphoreGive(handle->command_sync);
+    portENTER_CRITICAL(&handle->pending_lock);
+
+    bool found = handle->pending_count > 0;
+
+    if (found)
+    {
+        *pending = handle->pending[handle->pending_head];
+    }
+
+    portEXIT_CRITICAL(&handle->pending_lock);
+
+    return found;
 }
 
-static nex_err_t nextion_core_uart_read_as_simple_result(nextion_t *handle)
+/**
+ * @brief Complete the oldest pending command with NEX_TIMEOUT if its deadline passed.
+ * @param handle Nextion context pointer.
+ */
+static void nextion_core_command_check_timeout(nextion_t *handle)
 {
-    uint8_t buffer[NEX_DVC_EVT_MAX_RESPONSE_LENGTH];
+    nextion_pending_command_t head;
 
-    int bytes_read = 0;
+    if (!nextion_core_command_head(handle, &head) || head.is_deferred)
+    {
+        return;
+    }
 
-    do
+    if ((int32_t)(xTaskGetTickCount() - head.deadline) >= 0)
     {
-        bytes_read = (int)nextion_core_uart_read_as_byte(handle, buffer, NEX_DVC_EVT_MAX_RESPONSE_LENGTH);
+        // Some commands only return data on failure.
+        // That's why this is a debug; too much noise.
 
-        if (bytes_read == -1)
-        {
-            // Some commands only return data on failure.
-            // Event processing will throw this too when no event response is found.
-            // That's why this is a debug; too much noise.
+        CMP_LOGD("response timed out");
 
-            CMP_LOGD("response timed out");
+        // A partial frame will never be completed; the next byte starts a new one.
+        if (nextion_frame_parser_is_busy(&handle->recv_parser))
+        {
+            nextion_transport_stats_on_discard(&handle->stats, handle->recv_parser.length);
 
-            return NEX_TIMEOUT;
+            nextion_frame_parser_reset(&handle->recv_parser);
         }
 
-        // Depending on how much device events we're receiving,
-        // it may happen that an event response will be read.
-        // Dispatch it and read the next response until ours
-        // is found.
+        // The raw bytes length is sometimes an estimation;
+        // let the caller decide if there is enough data or not.
 
-        if (NEX_DVC_CODE_IS_EVENT(buffer[0], bytes_read))
+        if (head.is_raw && head.received > 0)
+        {
+            nextion_transport_stats_on_data(&handle->stats, (uint32_t)(esp_timer_get_time() - head.queued_at));
+            nextion_core_command_complete(handle, NEX_OK);
+        }
+        else
         {
-            CMP_LOGW("parsed the event %d on command handler", buffer[0]);
+            nextion_transport_stats_on_timeout(&handle->stats);
+            nextion_core_command_expect_late(handle, &head);
+            nextion_core_command_complete(handle, NEX_TIMEOUT);
+        }
+    }
+}
 
-            if (!nextion_core_event_dispatch(handle, buffer, bytes_read))
-            {
-                CMP_LOGW("failure dispatching event %d from command handler", buffer[0]);
-            }
+/**
+ * @brief Expect the response of a command that timed out to still arrive, for a while.
+ * @details Responses carry no command reference; without this, a late one would be
+ * taken for the next command, and every result after it would be shifted by one.
+ * @param handle Nextion context pointer.
+ * @param pending The command that timed out.
+ */
+static void nextion_core_command_expect_late(nextion_t *handle, const nextion_pending_command_t *pending)
+{
+    // Raw bytes are not framed, and quiet commands or those not written are not answered. When a late
+    // response was dropped while this command waited, it might have been this one's.
+    if (pending->is_raw || pending->is_quiet || pending->write_failed || pending->sequence == handle->late_dropped_sequence)
+    {
+        return;
+    }
 
-            continue;
-        }
+    portENTER_CRITICAL(&handle->pending_lock);
 
-        break;
-    } while (true);
+    if (handle->late_count < CONFIG_NEX_UART_COMMAND_QUEUE_SIZE)
+    {
+        handle->late_count++;
+    }
+
+    handle->late_deadline = xTaskGetTickCount() + pdMS_TO_TICKS(NEX_COMMAND_LATE_WAIT_TIME_MS);
+
+    portEXIT_CRITICAL(&handle->pending_lock);
+}
+
+/**
+ * @brief Drop a response if it is the late one of a command that timed out.
+ * @param handle Nextion context pointer.
+ * @param head Oldest pending command, or NULL if there is none.
+ * @return True if it was dropped, otherwise false.
+ */
+static bool nextion_core_command_drop_late(nextion_t *handle, const nextion_pending_command_t *head)
+{
+    portENTER_CRITICAL(&handle->pending_lock);
+
+    if (handle->late_count > 0 && (int32_t)(xTaskGetTickCount() - handle->late_deadline) >= 0)
+    {
+        handle->late_count = 0;
+    }
+
+    bool is_late = handle->late_count > 0;
+
+    if (is_late)
+    {
+        handle->late_count--;
+        handle->late_dropped_sequence = head != NULL ? head->sequence : 0;
+    }
 
-    if (bytes_read != NEX_DVC_CMD_ACK_LENGTH)
+    portEXIT_CRITICAL(&handle->pending_lock);
+
+    if (is_late)
     {
-        CMP_LOGE("invalid response size, expected %d but received %d", NEX_DVC_CMD_ACK_LENGTH, bytes_read);
+        CMP_LOGW("late response dropped");
 
-        return NEX_DVC_INSTRUCTION_FAIL;
+        nextion_transport_stats_on_unexpected(&handle->stats);
     }
 
-    return buffer[0];
+    return is_late;
 }
 
-static int32_t nextion_core_uart_read_as_byte(const nextion_t *handle, uint8_t *buffer, size_t length)
+/**
+ * @brief Stop expecting late responses.
+ * @param handle Nextion context pointer.
+ */
+static void nextion_core_command_forget_late(nextion_t *handle)
 {
-    uint8_t *movable_buffer = buffer;
-    int ends_found = 0; // Some commands use NEX_DVC_CMD_END_LENGTH chars as end response.
-    int bytes_read = 0;
-    int result = 0;
+    portENTER_CRITICAL(&handle->pending_lock);
 
-    for (size_t i = 0; i < length; i++)
+    handle->late_count = 0;
+
+    portEXIT_CRITICAL(&handle->pending_lock);
+}
+
+/**
+ * @brief Fill a "Transparent Data Mode" transaction that failed, so the display leaves the mode.
+ * @details The display reads commands again only once it has all the announced bytes;
+ * zeros are written for those it did not get, then its end response is waited for.
+ * @note The command sync must be held.
+ * @param handle Nextion context pointer.
+ * @param left How many bytes the display still waits for.
+ * @param is_end_queued If the end response is already queued.
+ * @return True if the display left the mode, otherwise false.
+ */
+static bool nextion_core_transparent_data_mode_fill(nextion_t *handle, size_t left, bool is_end_queued)
+{
+    if (!is_end_queued)
     {
-        result = uart_read_bytes(handle->uart_num, movable_buffer, 1, pdMS_TO_TICKS(CONFIG_NEX_UART_RECV_WAIT_TIME_MS));
+        nextion_pending_command_t pending = {.is_sync = true};
 
-        if (result > 0) // We got something.
+        portENTER_CRITICAL(&handle->pending_lock);
+        handle->transparent_data_mode_result = NEX_TIMEOUT;
+        portEXIT_CRITICAL(&handle->pending_lock);
+
+        if (!nextion_core_command_enqueue(handle, &pending))
         {
-            if (buffer[i] == NEX_DVC_CMD_END_VALUE)
-            {
-                ends_found++;
-            }
+            return false;
+        }
 
-            movable_buffer++;
-            bytes_read++;
+        handle->transparent_data_mode_sequence = pending.sequence;
+    }
 
-            // Stop when finding a command ending.
-            // Not every read byte request will have a
-            // command ending.
-            if (ends_found == NEX_DVC_CMD_END_LENGTH)
-            {
-                break;
-            }
+    if (left > 0)
+    {
+        static const char filler[32] = {0};
 
-            continue;
-        }
+        nextion_core_command_extend_deadline(handle,
+                                             handle->transparent_data_mode_sequence,
+                                             pdMS_TO_TICKS((uint64_t)left * 10U * 1000U / handle->baud_rate) + 1);
 
-        if (result == 0) // It's a timeout.
+        for (size_t written = 0; written < left;)
         {
-            // If we have read something before the timeout,
-            // we do not send an error. The "length" parameter
-            // sometimes is an estimation; let the caller decide
-            // if there is enough data or not.
+            size_t length = left - written < sizeof(filler) ? left - written : sizeof(filler);
 
-            if (bytes_read > 0)
+            if (!nextion_core_uart_write_as_byte(handle, filler, length))
             {
-                return bytes_read;
+                nextion_core_command_set_write_failed(handle, handle->transparent_data_mode_sequence);
+
+                return false;
             }
 
-            // Some commands only return data on failure.
-            // Event processing will throw this too when no event response is found.
-            // That's why this is a debug; too much noise.
+            written += length;
+        }
+    }
+
+    return nextion_core_command_wait(handle, handle->transparent_data_mode_sequence) == NEX_DVC_RSP_TRANSPARENT_DATA_FINISHED;
+}
+
+/**
+ * @brief Restart the timeout of the oldest pending command if its response is being received.
+ * @param handle Nextion context pointer.
+ */
+static void nextion_core_command_restart_timeout(nextion_t *handle)
+{
+    bool in_frame = nextion_frame_parser_is_busy(&handle->recv_parser);
 
-            CMP_LOGD("response timed out");
+    portENTER_CRITICAL(&handle->pending_lock);
 
-            return -1;
-        }
+    if (handle->pending_count > 0)
+    {
+        nextion_pending_command_t *pending = &handle->pending[handle->pending_head];
 
-        if (result == -1) // UART error.
+        if (!pending->is_deferred && (in_frame || (pending->is_raw && pending->received > 0)))
         {
-            CMP_LOGE("failed reading UART");
-            return -1;
+            pending->deadline = xTaskGetTickCount() + pdMS_TO_TICKS(CONFIG_NEX_UART_RECV_WAIT_TIME_MS);
         }
     }
 
-    return bytes_read;
+    portEXIT_CRITICAL(&handle->pending_lock);
 }
 
 static bool nextion_core_uart_write_as_command(nextion_t *handle, const char *format, va_list args)
 {
-    const char END_SEQUENCE[NEX_DVC_CMD_END_LENGTH] = {NEX_DVC_CMD_END_SEQUENCE};
+    // Formatted straight into the staging buffer, which is
+    // written whenever it fills up; nothing is truncated.
 
-    int size = vsnprintf(handle->command_format_buffer, CONFIG_NEX_UART_TRANS_COMMAND_FORMAT_BUFFER_SIZE, format, args);
+    nextion_command_builder_t builder;
 
-    uart_port_t uart = handle->uart_num;
+    nextion_command_builder_init(&builder,
+                                 handle->command_format_buffer,
+                                 CONFIG_NEX_UART_TRANS_COMMAND_FORMAT_BUFFER_SIZE,
+                                 0,
+                                 &nextion_core_uart_write_staged,
+                                 (void *)handle);
 
-    if (uart_write_bytes(uart, handle->command_format_buffer, size) < 0 || uart_write_bytes(uart, END_SEQUENCE, NEX_DVC_CMD_END_LENGTH) < 0)
+    if (!nextion_core_command_build(&builder, format, args) ||
+        !nextion_command_builder_append_end(&builder) ||
+        !nextion_command_builder_flush(&builder))
     {
         CMP_LOGE("failed writing command");
 
         return false;
     }
 
-    if (uart_wait_tx_done(uart, pdMS_TO_TICKS(CONFIG_NEX_UART_TRANS_WAIT_TIME_MS)) != ESP_OK)
+    if (uart_wait_tx_done(handle->uart_num, pdMS_TO_TICKS(CONFIG_NEX_UART_TRANS_WAIT_TIME_MS)) != ESP_OK)
     {
         CMP_LOGE("failed waiting transmission");
 
         return false;
     }
 
+    nextion_transport_stats_on_commands(&handle->stats, 1);
+
+    return true;
+}
+
+/**
+ * @brief Flush function of the command builder; queues bytes for transmission.
+ * @param context Nextion context pointer.
+ * @param data Bytes to write.
+ * @param length How many bytes there are.
+ * @return True if success, otherwise false.
+ */
+static bool nextion_core_uart_write_staged(void *context, const char *data, size_t length)
+{
+    nextion_t *handle = (nextion_t *)context;
+    int64_t started_at = esp_timer_get_time();
+
+    if (uart_write_bytes(handle->uart_num, data, length) < 0)
+    {
+        return false;
+    }
+
+    nextion_transport_stats_on_write(&handle->stats, length);
+    nextion_wire_capture_record(&handle->capture, NEX_WIRE_CAPTURE_TX, started_at, (const uint8_t *)data, length);
+
     return true;
 }
 
-static bool nextion_core_uart_write_as_byte(const nextion_t *handle, const char *bytes, size_t length)
+static bool nextion_core_uart_write_as_byte(nextion_t *handle, const char *bytes, size_t length)
 {
     uart_port_t uart = handle->uart_num;
+    int64_t started_at = esp_timer_get_time();
 
     if (uart_write_bytes(uart, bytes, length) < 0)
     {
@@ -682,6 +3023,9 @@ static bool nextion_core_uart_write_as_byte(const nextion_t *handle, const char
         return false;
     }
 
+    nextion_transport_stats_on_write(&handle->stats, length);
+    nextion_wire_capture_record(&handle->capture, NEX_WIRE_CAPTURE_TX, started_at, (const uint8_t *)bytes, length);
+
     if (uart_wait_tx_done(uart, pdMS_TO_TICKS(CONFIG_NEX_UART_TRANS_WAIT_TIME_MS)) != ESP_OK)
     {
         CMP_LOGE("failed waiting transmission");
@@ -691,3 +3035,43 @@ static bool nextion_core_uart_write_as_byte(const nextion_t *handle, const char
 
     return true;
 }
+
+/**
+ * @brief Discard everything received and not read yet, counting it.
+ * @param handle Nextion context pointer.
+ */
+static void nextion_core_uart_flush(nextion_t *handle)
+{
+    size_t buffered = 0;
+
+    if (uart_get_buffered_data_len(handle->uart_num, &buffered) != ESP_OK)
+    {
+        buffered = 0;
+    }
+
+    uart_flush_input(handle->uart_num);
+
+    nextion_transport_stats_on_flush(&handle->stats, buffered);
+}
+
+/**
+ * @brief Print a captured run of bytes as a "nexcap" line.
+ * @param context Stream pointer.
+ * @param direction Which way the bytes went.
+ * @param timestamp_us When the bytes were written or read.
+ * @param bytes Captured bytes.
+ * @param length How many bytes there are.
+ */
+static void nextion_core_capture_print(void *context, nextion_wire_capture_direction_t direction, int64_t timestamp_us, const uint8_t *bytes, size_t length)
+{
+    FILE *stream = (FILE *)context;
+
+    fprintf(stream, "nexcap %lld %s ", (long long)timestamp_us, direction == NEX_WIRE_CAPTURE_TX ? "tx" : "rx");
+
+    for (size_t i = 0; i < length; i++)
+    {
+        fprintf(stream, "%02X", bytes[i]);
+    }
+
+    fprintf(stream, "\n");
+}
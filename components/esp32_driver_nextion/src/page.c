@@ -1,6 +1,7 @@
 #include "esp32_driver_nextion/nextion.h"
 #include "esp32_driver_nextion/page.h"
 #include "assertion.h"
+#include "component_cache.h"
 
 nex_err_t nextion_page_get(nextion_t *handle, uint8_t *page_id)
 {
@@ -34,7 +35,33 @@ nex_err_t nextion_page_set(nextion_t *handle, const char *page_name_or_id)
 {
     CMP_CHECK_HANDLE(handle, NEX_FAIL)
 
-    return nextion_command_send(handle, "page %s", page_name_or_id);
+    // Components of the new page start with the values from the editor.
+    nextion_component_cache_t *cache = nextion_component_cache_of(handle);
+
+    nextion_component_cache_invalidate(cache);
+
+    nex_err_t code = nextion_command_send(handle, "page %s", page_name_or_id);
+
+    if (code != NEX_OK)
+    {
+        return code;
+    }
+
+    nextion_component_cache_store_page(cache, page_name_or_id);
+
+    // Names never start with a digit. Kept by id, the page is the
+    // same whether it is later given by name or by id.
+    if (page_name_or_id[0] < '0' || page_name_or_id[0] > '9')
+    {
+        uint8_t page_id;
+
+        if (nextion_page_get(handle, &page_id) == NEX_OK)
+        {
+            nextion_component_cache_store_page_id(cache, page_id);
+        }
+    }
+
+    return NEX_OK;
 }
 
 nex_err_t nextion_page_refresh(nextion_t *handle)
@@ -1,6 +1,312 @@
+#include <stdbool.h>
 #include "esp32_driver_nextion/rgb565/rgb565.h"
 
+/**
+ * @brief Fraction bits of the ramp steps.
+ */
+#define RGB565_RAMP_FRACTION_BITS 16
+
+/**
+ * @brief Hue span of each of the six HSV sectors, with a full turn being 256.
+ */
+#define RGB565_HSV_SECTOR 43
+
+/**
+ * @brief Dithering state, carried from pixel to pixel.
+ */
+typedef struct
+{
+    const rgb565_convert_config_t *config; /*!< Options. */
+    uint16_t width;                        /*!< Pixels in a row. */
+    uint16_t x;                            /*!< Column of the next pixel. */
+    uint16_t y;                            /*!< Row of the next pixel, modulo the matrix size. */
+    int16_t error[3];                      /*!< Error left by the previous pixel of the row, per channel. */
+} rgb565_ditherer_t;
+
+/**
+ * @brief 4x4 Bayer matrix, thresholds from 0 to 15.
+ */
+static const uint8_t RGB565_BAYER_4X4[4][4] = {
+    {0, 8, 2, 10},
+    {12, 4, 14, 6},
+    {3, 11, 1, 9},
+    {15, 7, 13, 5}};
+
+const uint8_t RGB565_GAMMA_22[256] = {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01,
+    0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,
+    0x03, 0x03, 0x03, 0x03, 0x03, 0x04, 0x04, 0x04, 0x04, 0x05, 0x05, 0x05, 0x05, 0x06, 0x06, 0x06,
+    0x06, 0x07, 0x07, 0x07, 0x08, 0x08, 0x08, 0x09, 0x09, 0x09, 0x0A, 0x0A, 0x0B, 0x0B, 0x0B, 0x0C,
+    0x0C, 0x0D, 0x0D, 0x0D, 0x0E, 0x0E, 0x0F, 0x0F, 0x10, 0x10, 0x11, 0x11, 0x12, 0x12, 0x13, 0x13,
+    0x14, 0x14, 0x15, 0x16, 0x16, 0x17, 0x17, 0x18, 0x19, 0x19, 0x1A, 0x1A, 0x1B, 0x1C, 0x1C, 0x1D,
+    0x1E, 0x1E, 0x1F, 0x20, 0x21, 0x21, 0x22, 0x23, 0x23, 0x24, 0x25, 0x26, 0x27, 0x27, 0x28, 0x29,
+    0x2A, 0x2B, 0x2B, 0x2C, 0x2D, 0x2E, 0x2F, 0x30, 0x31, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37,
+    0x38, 0x39, 0x3A, 0x3B, 0x3C, 0x3D, 0x3E, 0x3F, 0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47,
+    0x49, 0x4A, 0x4B, 0x4C, 0x4D, 0x4E, 0x4F, 0x51, 0x52, 0x53, 0x54, 0x55, 0x57, 0x58, 0x59, 0x5A,
+    0x5B, 0x5D, 0x5E, 0x5F, 0x61, 0x62, 0x63, 0x64, 0x66, 0x67, 0x69, 0x6A, 0x6B, 0x6D, 0x6E, 0x6F,
+    0x71, 0x72, 0x74, 0x75, 0x77, 0x78, 0x79, 0x7B, 0x7C, 0x7E, 0x7F, 0x81, 0x82, 0x84, 0x85, 0x87,
+    0x89, 0x8A, 0x8C, 0x8D, 0x8F, 0x91, 0x92, 0x94, 0x95, 0x97, 0x99, 0x9A, 0x9C, 0x9E, 0x9F, 0xA1,
+    0xA3, 0xA5, 0xA6, 0xA8, 0xAA, 0xAC, 0xAD, 0xAF, 0xB1, 0xB3, 0xB5, 0xB6, 0xB8, 0xBA, 0xBC, 0xBE,
+    0xC0, 0xC2, 0xC4, 0xC5, 0xC7, 0xC9, 0xCB, 0xCD, 0xCF, 0xD1, 0xD3, 0xD5, 0xD7, 0xD9, 0xDB, 0xDD,
+    0xDF, 0xE1, 0xE3, 0xE5, 0xE7, 0xEA, 0xEC, 0xEE, 0xF0, 0xF2, 0xF4, 0xF6, 0xF8, 0xFB, 0xFD, 0xFF};
+
+static bool rgb565_is_plain(const rgb565_convert_config_t *config);
+static void rgb565_ditherer_init(rgb565_ditherer_t *ditherer, const rgb565_convert_config_t *config, size_t count);
+static inline rgb565_t rgb565_ditherer_convert(rgb565_ditherer_t *ditherer, uint8_t red, uint8_t green, uint8_t blue);
+static inline uint8_t rgb565_dither_channel(uint8_t value, uint8_t mask, uint8_t offset, int16_t *error, rgb565_dither_t dither);
+static inline void rgb565_hsv_to_888(const uint8_t *hsv, uint8_t *red, uint8_t *green, uint8_t *blue);
+
 rgb565_t rgb565_convert_from_888(uint8_t red, uint8_t green, uint8_t blue)
 {
-    return (rgb565_t)(((red & 0b11111000) << 8) + ((green & 0b11111100) << 3) + (blue >> 3));
+    return RGB565_FROM_888(red, green, blue);
+}
+
+void rgb565_convert_buffer_from_888(const uint8_t *rgb, rgb565_t *colors, size_t count, const rgb565_convert_config_t *config)
+{
+    if (rgb == NULL || colors == NULL)
+    {
+        return;
+    }
+
+    if (rgb565_is_plain(config))
+    {
+        for (size_t i = 0; i < count; i++, rgb += 3)
+        {
+            colors[i] = RGB565_FROM_888(rgb[0], rgb[1], rgb[2]);
+        }
+
+        return;
+    }
+
+    rgb565_ditherer_t ditherer;
+
+    rgb565_ditherer_init(&ditherer, config, count);
+
+    for (size_t i = 0; i < count; i++, rgb += 3)
+    {
+        colors[i] = rgb565_ditherer_convert(&ditherer, rgb[0], rgb[1], rgb[2]);
+    }
+}
+
+void rgb565_convert_buffer_from_hsv(const uint8_t *hsv, rgb565_t *colors, size_t count, const rgb565_convert_config_t *config)
+{
+    if (hsv == NULL || colors == NULL)
+    {
+        return;
+    }
+
+    const bool is_plain = rgb565_is_plain(config);
+    rgb565_ditherer_t ditherer;
+
+    rgb565_ditherer_init(&ditherer, config, count);
+
+    for (size_t i = 0; i < count; i++, hsv += 3)
+    {
+        uint8_t red;
+        uint8_t green;
+        uint8_t blue;
+
+        rgb565_hsv_to_888(hsv, &red, &green, &blue);
+
+        colors[i] = is_plain ? RGB565_FROM_888(red, green, blue) : rgb565_ditherer_convert(&ditherer, red, green, blue);
+    }
+}
+
+void rgb565_ramp(uint32_t from, uint32_t to, rgb565_t *colors, size_t count, const rgb565_convert_config_t *config)
+{
+    if (colors == NULL || count == 0)
+    {
+        return;
+    }
+
+    const bool is_plain = rgb565_is_plain(config);
+    const int32_t divisor = count > 1 ? (int32_t)(count - 1) : 1;
+    int32_t channels[3];
+    int32_t steps[3];
+    rgb565_ditherer_t ditherer;
+
+    // Fixed point, so each color is an addition instead of a division.
+    for (int c = 0; c < 3; c++)
+    {
+        const int32_t first = (int32_t)((from >> (16 - c * 8)) & 0xFF);
+        const int32_t last = (int32_t)((to >> (16 - c * 8)) & 0xFF);
+
+        channels[c] = (first << RGB565_RAMP_FRACTION_BITS) + (1 << (RGB565_RAMP_FRACTION_BITS - 1));
+        steps[c] = ((last - first) * (1 << RGB565_RAMP_FRACTION_BITS)) / divisor;
+    }
+
+    rgb565_ditherer_init(&ditherer, config, count);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        const uint8_t red = (uint8_t)(channels[0] >> RGB565_RAMP_FRACTION_BITS);
+        const uint8_t green = (uint8_t)(channels[1] >> RGB565_RAMP_FRACTION_BITS);
+        const uint8_t blue = (uint8_t)(channels[2] >> RGB565_RAMP_FRACTION_BITS);
+
+        colors[i] = is_plain ? RGB565_FROM_888(red, green, blue) : rgb565_ditherer_convert(&ditherer, red, green, blue);
+
+        channels[0] += steps[0];
+        channels[1] += steps[1];
+        channels[2] += steps[2];
+    }
+}
+
+/**
+ * @brief Check if a conversion only truncates.
+ * @param config Options.
+ * @return True if neither dithering nor gamma are asked for, otherwise false.
+ */
+static bool rgb565_is_plain(const rgb565_convert_config_t *config)
+{
+    return config == NULL || (config->dither == RGB565_DITHER_NONE && config->gamma == NULL);
+}
+
+/**
+ * @brief Start dithering a buffer at its first pixel.
+ * @param ditherer Ditherer.
+ * @param config Options.
+ * @param count Pixels in the buffer, the row width when the options have none.
+ */
+static void rgb565_ditherer_init(rgb565_ditherer_t *ditherer, const rgb565_convert_config_t *config, size_t count)
+{
+    static const rgb565_convert_config_t NONE = {.dither = RGB565_DITHER_NONE, .width = 0, .gamma = NULL};
+
+    ditherer->config = config == NULL ? &NONE : config;
+    ditherer->width = ditherer->config->width > 0 ? ditherer->config->width : (count > UINT16_MAX ? UINT16_MAX : (uint16_t)count);
+    ditherer->x = 0;
+    ditherer->y = 0;
+    ditherer->error[0] = 0;
+    ditherer->error[1] = 0;
+    ditherer->error[2] = 0;
+}
+
+/**
+ * @brief Convert the next pixel of a buffer.
+ * @param ditherer Ditherer.
+ * @param red Red value, from 0 to 255.
+ * @param green Green value, from 0 to 255.
+ * @param blue Blue value, from 0 to 255.
+ * @return RGB565 color.
+ */
+static inline rgb565_t rgb565_ditherer_convert(rgb565_ditherer_t *ditherer, uint8_t red, uint8_t green, uint8_t blue)
+{
+    const rgb565_convert_config_t *config = ditherer->config;
+
+    if (config->gamma != NULL)
+    {
+        red = config->gamma[red];
+        green = config->gamma[green];
+        blue = config->gamma[blue];
+    }
+
+    // Red and blue lose 3 bits, green 2: the threshold is scaled to each.
+    const uint8_t threshold = RGB565_BAYER_4X4[ditherer->y][ditherer->x & 3];
+
+    red = rgb565_dither_channel(red, 0b11111000, threshold >> 1, &ditherer->error[0], config->dither);
+    green = rgb565_dither_channel(green, 0b11111100, threshold >> 2, &ditherer->error[1], config->dither);
+    blue = rgb565_dither_channel(blue, 0b11111000, threshold >> 1, &ditherer->error[2], config->dither);
+
+    if (++ditherer->x >= ditherer->width)
+    {
+        // The error of a row is not carried to the next one.
+        ditherer->x = 0;
+        ditherer->y = (ditherer->y + 1) & 3;
+        ditherer->error[0] = 0;
+        ditherer->error[1] = 0;
+        ditherer->error[2] = 0;
+    }
+
+    return RGB565_FROM_888(red, green, blue);
+}
+
+/**
+ * @brief Dither a channel before it is truncated.
+ * @param value Channel value.
+ * @param mask Bits kept by the truncation.
+ * @param offset Ordered dithering offset.
+ * @param error Error carried by the diffusion, updated.
+ * @param dither Dithering.
+ * @return Channel value to truncate.
+ */
+static inline uint8_t rgb565_dither_channel(uint8_t value, uint8_t mask, uint8_t offset, int16_t *error, rgb565_dither_t dither)
+{
+    int16_t dithered = value;
+
+    if (dither == RGB565_DITHER_ORDERED)
+    {
+        dithered += offset;
+    }
+    else if (dither == RGB565_DITHER_DIFFUSION)
+    {
+        dithered += *error;
+    }
+
+    dithered = dithered < 0 ? 0 : (dithered > 0xFF ? 0xFF : dithered);
+
+    if (dither == RGB565_DITHER_DIFFUSION)
+    {
+        *error = dithered - (dithered & mask);
+    }
+
+    return (uint8_t)dithered;
+}
+
+/**
+ * @brief Convert an HSV pixel into 24 bits RGB, without divisions.
+ * @param hsv Pixel: hue, saturation and value.
+ * @param red Location where the red value will be stored.
+ * @param green Location where the green value will be stored.
+ * @param blue Location where the blue value will be stored.
+ */
+static inline void rgb565_hsv_to_888(const uint8_t *hsv, uint8_t *red, uint8_t *green, uint8_t *blue)
+{
+    const uint16_t saturation = hsv[1];
+    const uint16_t value = hsv[2];
+
+    if (saturation == 0)
+    {
+        *red = *green = *blue = (uint8_t)value;
+
+        return;
+    }
+
+    const uint8_t sector = hsv[0] / RGB565_HSV_SECTOR;
+    const uint16_t remainder = (uint16_t)(hsv[0] - sector * RGB565_HSV_SECTOR) * 6;
+    const uint8_t p = (uint8_t)((value * (255 - saturation)) >> 8);
+    const uint8_t q = (uint8_t)((value * (255 - ((saturation * remainder) >> 8))) >> 8);
+    const uint8_t t = (uint8_t)((value * (255 - ((saturation * (255 - remainder)) >> 8))) >> 8);
+
+    switch (sector)
+    {
+    case 0:
+        *red = (uint8_t)value;
+        *green = t;
+        *blue = p;
+        break;
+    case 1:
+        *red = q;
+        *green = (uint8_t)value;
+        *blue = p;
+        break;
+    case 2:
+        *red = p;
+        *green = (uint8_t)value;
+        *blue = t;
+        break;
+    case 3:
+        *red = p;
+        *green = q;
+        *blue = (uint8_t)value;
+        break;
+    case 4:
+        *red = t;
+        *green = p;
+        *blue = (uint8_t)value;
+        break;
+    default:
+        *red = (uint8_t)value;
+        *green = p;
+        *blue = q;
+        break;
+    }
 }
@@ -0,0 +1,80 @@
+#include <string.h>
+#include "ring.h"
+
+void nextion_ring_init(nextion_ring_t *ring, void *slots, size_t item_size, size_t capacity)
+{
+    ring->slots = (uint8_t *)slots;
+    ring->item_size = item_size;
+    ring->slot_count = capacity + 1;
+
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+}
+
+size_t nextion_ring_push(nextion_ring_t *ring, const void *items, size_t count)
+{
+    const uint8_t *bytes = (const uint8_t *)items;
+    size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+
+    // Acquire pairs with the consumer release: the slots were fully read.
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    size_t room = (tail + ring->slot_count - head - 1) % ring->slot_count;
+
+    if (count > room)
+    {
+        count = room;
+    }
+
+    size_t first = ring->slot_count - head;
+
+    if (first > count)
+    {
+        first = count;
+    }
+
+    memcpy(ring->slots + head * ring->item_size, bytes, first * ring->item_size);
+    memcpy(ring->slots, bytes + first * ring->item_size, (count - first) * ring->item_size);
+
+    // Release: the slots are visible before the new head.
+    atomic_store_explicit(&ring->head, (head + count) % ring->slot_count, memory_order_release);
+
+    return count;
+}
+
+size_t nextion_ring_count(nextion_ring_t *ring)
+{
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    size_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+
+    return (head + ring->slot_count - tail) % ring->slot_count;
+}
+
+size_t nextion_ring_pop(nextion_ring_t *ring, void *items, size_t count)
+{
+    uint8_t *bytes = (uint8_t *)items;
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    size_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    size_t available = (head + ring->slot_count - tail) % ring->slot_count;
+
+    if (count > available)
+    {
+        count = available;
+    }
+
+    if (bytes != NULL)
+    {
+        size_t first = ring->slot_count - tail;
+
+        if (first > count)
+        {
+            first = count;
+        }
+
+        memcpy(bytes, ring->slots + tail * ring->item_size, first * ring->item_size);
+        memcpy(bytes + first * ring->item_size, ring->slots, (count - first) * ring->item_size);
+    }
+
+    atomic_store_explicit(&ring->tail, (tail + count) % ring->slot_count, memory_order_release);
+
+    return count;
+}
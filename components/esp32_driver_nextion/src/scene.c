@@ -0,0 +1,572 @@
+#include <stdlib.h>
+#include <string.h>
+#include "esp32_driver_nextion/nextion.h"
+#include "esp32_driver_nextion/drawing.h"
+#include "esp32_driver_nextion/scene.h"
+#include "assertion.h"
+
+/**
+ * @typedef nextion_scene_slot_t
+ * @brief Object held by a scene.
+ */
+typedef struct
+{
+    nextion_scene_object_t object;            /*!< Object; its text points to "text". */
+    char text[NEX_SCENE_MAX_TEXT_LENGTH + 1]; /*!< Copy of the object text. */
+    bool is_used;                             /*!< If the slot holds an object. */
+    bool is_visible;                          /*!< If the object is drawn. */
+} nextion_scene_slot_t;
+
+struct nextion_scene_t
+{
+    nextion_t *handle;                       /*!< Driver the scene is drawn through. */
+    nextion_scene_config_t config;           /*!< Configuration. */
+    nextion_scene_slot_t *slots;             /*!< Objects, by id. */
+    area_t dirty[NEX_SCENE_MAX_DIRTY_AREAS]; /*!< Areas to be redrawn; they do not overlap. */
+    size_t dirty_count;                      /*!< How many areas there are. */
+};
+
+static bool nextion_scene_object_check(const nextion_scene_object_t *object);
+static bool nextion_scene_object_equals(const nextion_scene_object_t *a, const nextion_scene_object_t *b);
+static void nextion_scene_slot_store(nextion_scene_slot_t *slot, const nextion_scene_object_t *object);
+static area_t nextion_scene_bounds(const nextion_scene_t *scene, const nextion_scene_object_t *object);
+static void nextion_scene_mark(nextion_scene_t *scene, area_t area);
+static void nextion_scene_close(nextion_scene_t *scene);
+static nex_err_t nextion_scene_draw(nextion_t *handle, const nextion_scene_object_t *object);
+static nex_err_t nextion_scene_restore(nextion_scene_t *scene, area_t area);
+static bool nextion_scene_area_is_empty(area_t area);
+static bool nextion_scene_area_overlaps(area_t a, area_t b);
+static bool nextion_scene_area_contains(area_t outer, area_t inner);
+static area_t nextion_scene_area_unite(area_t a, area_t b);
+static uint32_t nextion_scene_area_size(area_t area);
+
+nextion_scene_t *nextion_scene_create(nextion_t *handle, const nextion_scene_config_t *config)
+{
+    CMP_CHECK_HANDLE(handle, NULL)
+    CMP_CHECK((config != NULL), "config error(NULL)", NULL)
+    CMP_CHECK((config->width > 0 && config->height > 0), "size error(0)", NULL)
+    CMP_CHECK((config->max_objects > 0), "max_objects error(<1)", NULL)
+    CMP_CHECK((config->fill_mode == BACKG_FILL_COLOR || config->fill_mode == BACKG_FILL_IMAGE), "fill_mode error(not color nor image)", NULL)
+
+    nextion_scene_t *scene = (nextion_scene_t *)calloc(1, sizeof(nextion_scene_t));
+
+    CMP_CHECK((scene != NULL), "scene error(no memory)", NULL)
+
+    scene->slots = (nextion_scene_slot_t *)calloc(config->max_objects, sizeof(nextion_scene_slot_t));
+
+    if (scene->slots == NULL)
+    {
+        CMP_LOGE("failed allocating objects");
+
+        free(scene);
+
+        return NULL;
+    }
+
+    scene->handle = handle;
+    scene->config = *config;
+
+    nextion_scene_invalidate(scene);
+
+    return scene;
+}
+
+bool nextion_scene_delete(nextion_scene_t *scene)
+{
+    CMP_CHECK((scene != NULL), "scene error(NULL)", false)
+
+    free(scene->slots);
+    free(scene);
+
+    return true;
+}
+
+nex_err_t nextion_scene_add(nextion_scene_t *scene, const nextion_scene_object_t *object, size_t *id)
+{
+    CMP_CHECK((scene != NULL), "scene error(NULL)", NEX_FAIL)
+    CMP_CHECK((id != NULL), "id error(NULL)", NEX_FAIL)
+    CMP_CHECK((nextion_scene_object_check(object)), "object error(invalid)", NEX_FAIL)
+
+    for (size_t i = 0; i < scene->config.max_objects; i++)
+    {
+        nextion_scene_slot_t *slot = &scene->slots[i];
+
+        if (!slot->is_used)
+        {
+            nextion_scene_slot_store(slot, object);
+
+            slot->is_used = true;
+            slot->is_visible = true;
+
+            nextion_scene_mark(scene, nextion_scene_bounds(scene, &slot->object));
+
+            *id = i;
+
+            return NEX_OK;
+        }
+    }
+
+    CMP_LOGE("scene error(max_objects reached)");
+
+    return NEX_FAIL;
+}
+
+nex_err_t nextion_scene_update(nextion_scene_t *scene, size_t id, const nextion_scene_object_t *object)
+{
+    CMP_CHECK((scene != NULL), "scene error(NULL)", NEX_FAIL)
+    CMP_CHECK((id < scene->config.max_objects && scene->slots[id].is_used), "id error(unknown)", NEX_FAIL)
+    CMP_CHECK((nextion_scene_object_check(object)), "object error(invalid)", NEX_FAIL)
+
+    nextion_scene_slot_t *slot = &scene->slots[id];
+
+    if (nextion_scene_object_equals(&slot->object, object))
+    {
+        return NEX_OK;
+    }
+
+    if (slot->is_visible)
+    {
+        nextion_scene_mark(scene, nextion_scene_bounds(scene, &slot->object));
+    }
+
+    nextion_scene_slot_store(slot, object);
+
+    if (slot->is_visible)
+    {
+        nextion_scene_mark(scene, nextion_scene_bounds(scene, &slot->object));
+    }
+
+    return NEX_OK;
+}
+
+nex_err_t nextion_scene_set_visibility(nextion_scene_t *scene, size_t id, bool is_visible)
+{
+    CMP_CHECK((scene != NULL), "scene error(NULL)", NEX_FAIL)
+    CMP_CHECK((id < scene->config.max_objects && scene->slots[id].is_used), "id error(unknown)", NEX_FAIL)
+
+    nextion_scene_slot_t *slot = &scene->slots[id];
+
+    if (slot->is_visible != is_visible)
+    {
+        slot->is_visible = is_visible;
+
+        nextion_scene_mark(scene, nextion_scene_bounds(scene, &slot->object));
+    }
+
+    return NEX_OK;
+}
+
+nex_err_t nextion_scene_remove(nextion_scene_t *scene, size_t id)
+{
+    CMP_CHECK((scene != NULL), "scene error(NULL)", NEX_FAIL)
+    CMP_CHECK((id < scene->config.max_objects && scene->slots[id].is_used), "id error(unknown)", NEX_FAIL)
+
+    nextion_scene_slot_t *slot = &scene->slots[id];
+
+    if (slot->is_visible)
+    {
+        nextion_scene_mark(scene, nextion_scene_bounds(scene, &slot->object));
+    }
+
+    slot->is_used = false;
+
+    return NEX_OK;
+}
+
+nex_err_t nextion_scene_invalidate(nextion_scene_t *scene)
+{
+    CMP_CHECK((scene != NULL), "scene error(NULL)", NEX_FAIL)
+
+    const area_t screen = {.upper_left = {.x = 0, .y = 0}, .bottom_right = {.x = scene->config.width, .y = scene->config.height}};
+
+    scene->dirty[0] = screen;
+    scene->dirty_count = 1;
+
+    return NEX_OK;
+}
+
+nex_err_t nextion_scene_render(nextion_scene_t *scene)
+{
+    CMP_CHECK((scene != NULL), "scene error(NULL)", NEX_FAIL)
+
+    if (scene->dirty_count == 0)
+    {
+        return NEX_OK;
+    }
+
+    nextion_scene_close(scene);
+
+    CMP_CHECK((nextion_batch_begin(scene->handle) == NEX_OK), "batch error(not started)", NEX_FAIL)
+
+    nex_err_t code = NEX_OK;
+
+    for (size_t d = 0; d < scene->dirty_count && code == NEX_OK; d++)
+    {
+        code = nextion_scene_restore(scene, scene->dirty[d]);
+
+        // Objects overlapping an area are inside it, so each is drawn once.
+        for (size_t i = 0; i < scene->config.max_objects && code == NEX_OK; i++)
+        {
+            const nextion_scene_slot_t *slot = &scene->slots[i];
+
+            if (slot->is_used && slot->is_visible &&
+                nextion_scene_area_overlaps(nextion_scene_bounds(scene, &slot->object), scene->dirty[d]))
+            {
+                code = nextion_scene_draw(scene->handle, &slot->object);
+            }
+        }
+    }
+
+    nex_err_t batch_code = nextion_batch_end(scene->handle);
+
+    if (code == NEX_OK)
+    {
+        code = batch_code;
+    }
+
+    // Kept for the next render otherwise.
+    if (code == NEX_OK)
+    {
+        scene->dirty_count = 0;
+    }
+
+    return code;
+}
+
+/**
+ * @brief Check that an object can be drawn.
+ * @param object Object.
+ * @return True if valid, otherwise false.
+ */
+static bool nextion_scene_object_check(const nextion_scene_object_t *object)
+{
+    if (object == NULL || object->kind > NEX_SCENE_OBJECT_TEXT)
+    {
+        return false;
+    }
+
+    if (object->kind == NEX_SCENE_OBJECT_TEXT)
+    {
+        return object->text != NULL && strlen(object->text) <= NEX_SCENE_MAX_TEXT_LENGTH;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Compare the fields two objects draw with.
+ * @param a Object.
+ * @param b Object.
+ * @return True if they draw the same, otherwise false.
+ */
+static bool nextion_scene_object_equals(const nextion_scene_object_t *a, const nextion_scene_object_t *b)
+{
+    const bool same_area = a->area.upper_left.x == b->area.upper_left.x && a->area.upper_left.y == b->area.upper_left.y &&
+                           a->area.bottom_right.x == b->area.bottom_right.x && a->area.bottom_right.y == b->area.bottom_right.y;
+    const bool same_position = a->position.x == b->position.x && a->position.y == b->position.y;
+
+    if (a->kind != b->kind)
+    {
+        return false;
+    }
+
+    switch (a->kind)
+    {
+    case NEX_SCENE_OBJECT_FILL_AREA:
+    case NEX_SCENE_OBJECT_LINE:
+    case NEX_SCENE_OBJECT_RECTANGLE:
+        return same_area && a->color == b->color;
+    case NEX_SCENE_OBJECT_FILL_CIRCLE:
+    case NEX_SCENE_OBJECT_CIRCLE:
+        return same_position && a->radius == b->radius && a->color == b->color;
+    case NEX_SCENE_OBJECT_PICTURE:
+        return same_area && a->picture_id == b->picture_id;
+    case NEX_SCENE_OBJECT_CROP_PICTURE:
+        return same_area && same_position && a->picture_id == b->picture_id;
+    case NEX_SCENE_OBJECT_TEXT:
+        return same_area && a->font.id == b->font.id && a->font.color == b->font.color &&
+               a->background.fill_mode == b->background.fill_mode && a->background.color == b->background.color &&
+               a->background.picture_id == b->background.picture_id &&
+               a->alignment.horizontal == b->alignment.horizontal && a->alignment.vertical == b->alignment.vertical &&
+               strcmp(a->text, b->text) == 0;
+    default:
+        return false;
+    }
+}
+
+/**
+ * @brief Keep a copy of an object.
+ * @param slot Slot.
+ * @param object Object; checked.
+ */
+static void nextion_scene_slot_store(nextion_scene_slot_t *slot, const nextion_scene_object_t *object)
+{
+    slot->object = *object;
+    slot->object.text = NULL;
+
+    if (object->kind == NEX_SCENE_OBJECT_TEXT)
+    {
+        strcpy(slot->text, object->text);
+
+        slot->object.text = slot->text;
+    }
+}
+
+/**
+ * @brief Get the pixels an object can draw on, within the screen.
+ * @details Areas exclude their bottom right corner, as "fill" does.
+ * @param scene Scene pointer.
+ * @param object Object.
+ * @return Bounds; empty when off screen.
+ */
+static area_t nextion_scene_bounds(const nextion_scene_t *scene, const nextion_scene_object_t *object)
+{
+    const area_t *area = &object->area;
+    area_t bounds = *area;
+
+    switch (object->kind)
+    {
+    case NEX_SCENE_OBJECT_LINE:
+    case NEX_SCENE_OBJECT_RECTANGLE:
+        // Both corners are drawn, in any order.
+        bounds.upper_left.x = area->upper_left.x < area->bottom_right.x ? area->upper_left.x : area->bottom_right.x;
+        bounds.upper_left.y = area->upper_left.y < area->bottom_right.y ? area->upper_left.y : area->bottom_right.y;
+        bounds.bottom_right.x = (area->upper_left.x > area->bottom_right.x ? area->upper_left.x : area->bottom_right.x) + 1;
+        bounds.bottom_right.y = (area->upper_left.y > area->bottom_right.y ? area->upper_left.y : area->bottom_right.y) + 1;
+        break;
+    case NEX_SCENE_OBJECT_FILL_CIRCLE:
+    case NEX_SCENE_OBJECT_CIRCLE:
+        bounds.upper_left.x = object->position.x > object->radius ? object->position.x - object->radius : 0;
+        bounds.upper_left.y = object->position.y > object->radius ? object->position.y - object->radius : 0;
+        bounds.bottom_right.x = object->position.x + object->radius + 1;
+        bounds.bottom_right.y = object->position.y + object->radius + 1;
+        break;
+    case NEX_SCENE_OBJECT_CROP_PICTURE:
+        bounds.upper_left = object->position;
+        bounds.bottom_right.x = object->position.x + (area->bottom_right.x - area->upper_left.x);
+        bounds.bottom_right.y = object->position.y + (area->bottom_right.y - area->upper_left.y);
+        break;
+    default:
+        break;
+    }
+
+    if (bounds.bottom_right.x > scene->config.width)
+    {
+        bounds.bottom_right.x = scene->config.width;
+    }
+
+    if (bounds.bottom_right.y > scene->config.height)
+    {
+        bounds.bottom_right.y = scene->config.height;
+    }
+
+    return bounds;
+}
+
+/**
+ * @brief Add an area to be redrawn, merging it with the ones it overlaps.
+ * @details When there is no room for another area, it is merged with the one
+ * growing the least.
+ * @param scene Scene pointer.
+ * @param area Area.
+ */
+static void nextion_scene_mark(nextion_scene_t *scene, area_t area)
+{
+    if (nextion_scene_area_is_empty(area))
+    {
+        return;
+    }
+
+    for (size_t d = 0; d < scene->dirty_count;)
+    {
+        if (nextion_scene_area_overlaps(scene->dirty[d], area))
+        {
+            // The union can overlap areas already looked at.
+            area = nextion_scene_area_unite(scene->dirty[d], area);
+            scene->dirty[d] = scene->dirty[--scene->dirty_count];
+            d = 0;
+        }
+        else
+        {
+            d++;
+        }
+    }
+
+    if (scene->dirty_count == NEX_SCENE_MAX_DIRTY_AREAS)
+    {
+        size_t best = 0;
+        uint32_t best_growth = UINT32_MAX;
+
+        for (size_t d = 0; d < scene->dirty_count; d++)
+        {
+            uint32_t growth = nextion_scene_area_size(nextion_scene_area_unite(scene->dirty[d], area)) - nextion_scene_area_size(scene->dirty[d]);
+
+            if (growth < best_growth)
+            {
+                best = d;
+                best_growth = growth;
+            }
+        }
+
+        area = nextion_scene_area_unite(scene->dirty[best], area);
+        scene->dirty[best] = scene->dirty[--scene->dirty_count];
+
+        nextion_scene_mark(scene, area);
+
+        return;
+    }
+
+    scene->dirty[scene->dirty_count++] = area;
+}
+
+/**
+ * @brief Grow the areas to be redrawn until they hold every object they overlap.
+ * @details The display does not clip: an object partly redrawn would paint over
+ * the objects above it outside the area.
+ * @param scene Scene pointer.
+ */
+static void nextion_scene_close(nextion_scene_t *scene)
+{
+    bool is_grown;
+
+    do
+    {
+        is_grown = false;
+
+        for (size_t d = 0; d < scene->dirty_count && !is_grown; d++)
+        {
+            for (size_t i = 0; i < scene->config.max_objects && !is_grown; i++)
+            {
+                const nextion_scene_slot_t *slot = &scene->slots[i];
+
+                if (!slot->is_used || !slot->is_visible)
+                {
+                    continue;
+                }
+
+                area_t bounds = nextion_scene_bounds(scene, &slot->object);
+
+                if (nextion_scene_area_overlaps(bounds, scene->dirty[d]) && !nextion_scene_area_contains(scene->dirty[d], bounds))
+                {
+                    area_t area = nextion_scene_area_unite(scene->dirty[d], bounds);
+
+                    scene->dirty[d] = scene->dirty[--scene->dirty_count];
+
+                    nextion_scene_mark(scene, area);
+
+                    is_grown = true;
+                }
+            }
+        }
+    } while (is_grown);
+}
+
+/**
+ * @brief Draw an object.
+ * @param handle Nextion context pointer.
+ * @param object Object.
+ * @return NEX_OK if success, otherwise NEX_FAIL.
+ */
+static nex_err_t nextion_scene_draw(nextion_t *handle, const nextion_scene_object_t *object)
+{
+    switch (object->kind)
+    {
+    case NEX_SCENE_OBJECT_FILL_AREA:
+        return nextion_draw_fill_area(handle, object->area, object->color);
+    case NEX_SCENE_OBJECT_FILL_CIRCLE:
+        return nextion_draw_fill_circle(handle, object->position, object->radius, object->color);
+    case NEX_SCENE_OBJECT_LINE:
+        return nextion_draw_line(handle, object->area, object->color);
+    case NEX_SCENE_OBJECT_RECTANGLE:
+        return nextion_draw_rectangle(handle, object->area, object->color);
+    case NEX_SCENE_OBJECT_CIRCLE:
+        return nextion_draw_circle(handle, object->position, object->radius, object->color);
+    case NEX_SCENE_OBJECT_PICTURE:
+        return nextion_draw_picture(handle, object->picture_id, object->area.upper_left);
+    case NEX_SCENE_OBJECT_CROP_PICTURE:
+        return nextion_draw_crop_picture(handle, object->picture_id, object->area, object->position);
+    case NEX_SCENE_OBJECT_TEXT:
+        return nextion_draw_text(handle, object->area, object->font, object->background, object->alignment, object->text);
+    default:
+        return NEX_FAIL;
+    }
+}
+
+/**
+ * @brief Draw the background over an area.
+ * @param scene Scene pointer.
+ * @param area Area.
+ * @return NEX_OK if success, otherwise NEX_FAIL.
+ */
+static nex_err_t nextion_scene_restore(nextion_scene_t *scene, area_t area)
+{
+    if (scene->config.fill_mode == BACKG_FILL_IMAGE)
+    {
+        // The same part of a full screen picture.
+        return nextion_draw_crop_picture(scene->handle, scene->config.picture_id, area, area.upper_left);
+    }
+
+    return nextion_draw_fill_area(scene->handle, area, scene->config.color);
+}
+
+/**
+ * @brief Check if an area holds no pixel.
+ * @param area Area.
+ * @return True if empty, otherwise false.
+ */
+static bool nextion_scene_area_is_empty(area_t area)
+{
+    return area.upper_left.x >= area.bottom_right.x || area.upper_left.y >= area.bottom_right.y;
+}
+
+/**
+ * @brief Check if two areas share a pixel.
+ * @param a Area.
+ * @param b Area.
+ * @return True if they overlap, otherwise false.
+ */
+static bool nextion_scene_area_overlaps(area_t a, area_t b)
+{
+    return !nextion_scene_area_is_empty(a) && !nextion_scene_area_is_empty(b) &&
+           a.upper_left.x < b.bottom_right.x && b.upper_left.x < a.bottom_right.x &&
+           a.upper_left.y < b.bottom_right.y && b.upper_left.y < a.bottom_right.y;
+}
+
+/**
+ * @brief Check if an area holds another.
+ * @param outer Area.
+ * @param inner Area.
+ * @return True if "inner" is inside "outer", otherwise false.
+ */
+static bool nextion_scene_area_contains(area_t outer, area_t inner)
+{
+    return outer.upper_left.x <= inner.upper_left.x && outer.upper_left.y <= inner.upper_left.y &&
+           outer.bottom_right.x >= inner.bottom_right.x && outer.bottom_right.y >= inner.bottom_right.y;
+}
+
+/**
+ * @brief Get the smallest area holding two areas.
+ * @param a Area.
+ * @param b Area.
+ * @return Union.
+ */
+static area_t nextion_scene_area_unite(area_t a, area_t b)
+{
+    area_t area = {
+        .upper_left = {.x = a.upper_left.x < b.upper_left.x ? a.upper_left.x : b.upper_left.x,
+                       .y = a.upper_left.y < b.upper_left.y ? a.upper_left.y : b.upper_left.y},
+        .bottom_right = {.x = a.bottom_right.x > b.bottom_right.x ? a.bottom_right.x : b.bottom_right.x,
+                         .y = a.bottom_right.y > b.bottom_right.y ? a.bottom_right.y : b.bottom_right.y}};
+
+    return area;
+}
+
+/**
+ * @brief Get how many pixels an area holds.
+ * @param area Area.
+ * @return Pixels.
+ */
+static uint32_t nextion_scene_area_size(area_t area)
+{
+    return (uint32_t)(area.bottom_right.x - area.upper_left.x) * (uint32_t)(area.bottom_right.y - area.upper_left.y);
+}
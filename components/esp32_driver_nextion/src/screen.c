@@ -0,0 +1,105 @@
+#include "esp32_driver_nextion/nextion.h"
+#include "esp32_driver_nextion/page.h"
+#include "esp32_driver_nextion/component.h"
+#include "esp32_driver_nextion/screen.h"
+#include "assertion.h"
+#include "component_cache.h"
+
+static bool nextion_screen_item_can_keep(nextion_t *handle, const nextion_screen_item_t *item);
+static nex_err_t nextion_screen_item_apply(nextion_t *handle, const nextion_screen_item_t *item);
+
+nex_err_t nextion_screen_apply(nextion_t *handle, const nextion_screen_t *desired)
+{
+    CMP_CHECK_HANDLE(handle, NEX_FAIL)
+    CMP_CHECK((desired != NULL), "desired error(NULL)", NEX_FAIL)
+    CMP_CHECK((desired->items != NULL || desired->item_count == 0), "items error(NULL)", NEX_FAIL)
+    CMP_CHECK((desired->item_count <= CONFIG_NEX_COMPONENT_CACHE_SIZE), "items error(more than the component cache holds)", NEX_FAIL)
+
+    // The last applied state is the one kept by the component cache;
+    // an item it cannot keep would be sent every time.
+    for (size_t i = 0; i < desired->item_count; i++)
+    {
+        CMP_CHECK(nextion_screen_item_can_keep(handle, &desired->items[i]), "item error(does not fit the component cache)", NEX_FAIL)
+    }
+
+    CMP_CHECK((nextion_batch_begin(handle) == NEX_OK), "batch error(not started)", NEX_FAIL)
+
+    nex_err_t code = NEX_OK;
+
+    // A page given by name is asked back for its id, which writes it ahead of the items.
+    if (desired->page != NULL && !nextion_component_cache_contains_page(nextion_component_cache_of(handle), desired->page))
+    {
+        code = nextion_page_set(handle, desired->page);
+    }
+
+    // Unchanged items are skipped by the component functions.
+
+    for (size_t i = 0; i < desired->item_count; i++)
+    {
+        nex_err_t item_code = nextion_screen_item_apply(handle, &desired->items[i]);
+
+        if (item_code != NEX_OK && code == NEX_OK)
+        {
+            code = item_code;
+        }
+    }
+
+    nex_err_t batch_code = nextion_batch_end(handle);
+
+    return code != NEX_OK ? code : batch_code;
+}
+
+/**
+ * @brief Check if the component cache can keep the value of an item.
+ * @param handle Nextion context pointer.
+ * @param item Desired item state.
+ * @return True if it can, otherwise false.
+ */
+static bool nextion_screen_item_can_keep(nextion_t *handle, const nextion_screen_item_t *item)
+{
+    nextion_component_cache_t *cache = nextion_component_cache_of(handle);
+
+    // Invalid items are left to be reported when they are applied.
+    if (item->component == NULL)
+    {
+        return true;
+    }
+
+    switch (item->kind)
+    {
+    case NEX_SCREEN_ITEM_VISIBILITY:
+        return nextion_component_cache_can_keep(cache, NEX_COMPONENT_CACHE_VISIBILITY, item->component, NULL, NULL);
+    case NEX_SCREEN_ITEM_NUMBER:
+        return item->property == NULL || nextion_component_cache_can_keep(cache, NEX_COMPONENT_CACHE_NUMBER, item->component, item->property, NULL);
+    case NEX_SCREEN_ITEM_TEXT:
+        return item->property == NULL || item->text == NULL ||
+               nextion_component_cache_can_keep(cache, NEX_COMPONENT_CACHE_TEXT, item->component, item->property, item->text);
+    default:
+        return true;
+    }
+}
+
+/**
+ * @brief Set a single item, unless it already holds the desired value.
+ * @param handle Nextion context pointer.
+ * @param item Desired item state.
+ * @return NEX_OK if success, otherwise NEX_FAIL.
+ */
+static nex_err_t nextion_screen_item_apply(nextion_t *handle, const nextion_screen_item_t *item)
+{
+    CMP_CHECK((item->component != NULL), "component error(NULL)", NEX_FAIL)
+
+    switch (item->kind)
+    {
+    case NEX_SCREEN_ITEM_VISIBILITY:
+        return nextion_component_set_visibility(handle, item->component, item->is_visible);
+    case NEX_SCREEN_ITEM_NUMBER:
+        return nextion_component_set_property_number(handle, item->component, item->property, item->number);
+    case NEX_SCREEN_ITEM_TEXT:
+        return nextion_component_set_property_text(handle, item->component, item->property, (char *)item->text);
+    default:
+        CMP_LOGE("item kind error(unknown)");
+
+        return NEX_FAIL;
+    }
+}
@@ -3,6 +3,8 @@
 #include "esp32_driver_nextion/nextion.h"
 #include "esp32_driver_nextion/system.h"
 #include "assertion.h"
+#include "component_cache.h"
+#include "command_send.h"
 
 nex_err_t nextion_system_get_text(nextion_t *handle,
                                   const char *command,
@@ -95,7 +97,9 @@ nex_err_t nextion_system_reset(nextion_t *handle)
 {
     CMP_CHECK_HANDLE(handle, NEX_FAIL)
 
-    nex_err_t code = nextion_command_send(handle, "rest");
+    nextion_component_cache_invalidate(nextion_component_cache_of(handle));
+
+    nex_err_t code = nextion_command_send_quiet(handle, "rest");
 
     // The "rest" command returns no response;
     // timeout is success.
@@ -0,0 +1,188 @@
+#include <string.h>
+#include "transport_stats.h"
+
+void nextion_transport_stats_init(nextion_transport_stats_t *stats)
+{
+    memset(stats, 0, sizeof(nextion_transport_stats_t));
+
+    portMUX_INITIALIZE(&stats->lock);
+}
+
+void nextion_transport_stats_reset(nextion_transport_stats_t *stats)
+{
+    portENTER_CRITICAL(&stats->lock);
+
+    memset(&stats->counters, 0, sizeof(nextion_stats_t));
+
+    portEXIT_CRITICAL(&stats->lock);
+}
+
+void nextion_transport_stats_get(nextion_transport_stats_t *stats, nextion_stats_t *counters)
+{
+    portENTER_CRITICAL(&stats->lock);
+
+    *counters = stats->counters;
+
+    portEXIT_CRITICAL(&stats->lock);
+}
+
+void nextion_transport_stats_on_commands(nextion_transport_stats_t *stats, size_t count)
+{
+    portENTER_CRITICAL(&stats->lock);
+
+    stats->counters.commands_sent += (uint32_t)count;
+
+    portEXIT_CRITICAL(&stats->lock);
+}
+
+void nextion_transport_stats_on_write(nextion_transport_stats_t *stats, size_t length)
+{
+    portENTER_CRITICAL(&stats->lock);
+
+    stats->counters.bytes_sent += (uint32_t)length;
+
+    portEXIT_CRITICAL(&stats->lock);
+}
+
+void nextion_transport_stats_on_read(nextion_transport_stats_t *stats, size_t length)
+{
+    portENTER_CRITICAL(&stats->lock);
+
+    stats->counters.bytes_received += (uint32_t)length;
+
+    portEXIT_CRITICAL(&stats->lock);
+}
+
+void nextion_transport_stats_on_ack(nextion_transport_stats_t *stats, uint8_t code, uint32_t latency_us)
+{
+    size_t index = code < NEXTION_STATS_ACK_CODE_COUNT - 1 ? code : NEXTION_STATS_ACK_CODE_COUNT - 1;
+
+    portENTER_CRITICAL(&stats->lock);
+
+    stats->counters.acks[index]++;
+
+    nextion_stats_histogram_add(&stats->counters.command_latency, latency_us);
+
+    portEXIT_CRITICAL(&stats->lock);
+}
+
+void nextion_transport_stats_on_data(nextion_transport_stats_t *stats, uint32_t latency_us)
+{
+    portENTER_CRITICAL(&stats->lock);
+
+    stats->counters.data_responses++;
+
+    nextion_stats_histogram_add(&stats->counters.command_latency, latency_us);
+
+    portEXIT_CRITICAL(&stats->lock);
+}
+
+void nextion_transport_stats_on_unexpected(nextion_transport_stats_t *stats)
+{
+    portENTER_CRITICAL(&stats->lock);
+
+    stats->counters.unexpected_responses++;
+
+    portEXIT_CRITICAL(&stats->lock);
+}
+
+void nextion_transport_stats_on_timeout(nextion_transport_stats_t *stats)
+{
+    portENTER_CRITICAL(&stats->lock);
+
+    stats->counters.timeouts++;
+
+    portEXIT_CRITICAL(&stats->lock);
+}
+
+void nextion_transport_stats_on_event_parsed(nextion_transport_stats_t *stats)
+{
+    portENTER_CRITICAL(&stats->lock);
+
+    stats->counters.events_parsed_on_command_path++;
+
+    portEXIT_CRITICAL(&stats->lock);
+}
+
+void nextion_transport_stats_on_event_dispatched(nextion_transport_stats_t *stats, nextion_stats_event_type_t type)
+{
+    if (type >= NEXTION_STATS_EVENT_TYPE_COUNT)
+    {
+        return;
+    }
+
+    portENTER_CRITICAL(&stats->lock);
+
+    stats->counters.events_dispatched[type]++;
+
+    portEXIT_CRITICAL(&stats->lock);
+}
+
+void nextion_transport_stats_on_overflow(nextion_transport_stats_t *stats, bool is_fifo)
+{
+    portENTER_CRITICAL(&stats->lock);
+
+    if (is_fifo)
+    {
+        stats->counters.uart_fifo_overflows++;
+    }
+    else
+    {
+        stats->counters.uart_buffer_full++;
+    }
+
+    portEXIT_CRITICAL(&stats->lock);
+}
+
+void nextion_transport_stats_on_flush(nextion_transport_stats_t *stats, size_t length)
+{
+    portENTER_CRITICAL(&stats->lock);
+
+    stats->counters.bytes_flushed += (uint32_t)length;
+
+    portEXIT_CRITICAL(&stats->lock);
+}
+
+void nextion_transport_stats_on_discard(nextion_transport_stats_t *stats, size_t length)
+{
+    portENTER_CRITICAL(&stats->lock);
+
+    stats->counters.bytes_discarded += (uint32_t)length;
+
+    portEXIT_CRITICAL(&stats->lock);
+}
+
+void nextion_transport_stats_on_sync(nextion_transport_stats_t *stats, uint32_t wait_us, bool is_acquired)
+{
+    portENTER_CRITICAL(&stats->lock);
+
+    if (!is_acquired)
+    {
+        stats->counters.sync_timeouts++;
+    }
+
+    nextion_stats_histogram_add(&stats->counters.sync_wait, wait_us);
+
+    portEXIT_CRITICAL(&stats->lock);
+}
+
+void nextion_stats_histogram_add(nextion_stats_histogram_t *histogram, uint32_t value_us)
+{
+    size_t bucket = 0;
+    uint32_t bound = NEXTION_STATS_HISTOGRAM_FIRST_BOUND_US;
+
+    while (bucket < NEXTION_STATS_HISTOGRAM_BUCKET_COUNT - 1 && value_us >= bound)
+    {
+        bucket++;
+        bound <<= 1;
+    }
+
+    histogram->buckets[bucket]++;
+    histogram->count++;
+    histogram->total_us += value_us;
+
+    if (value_us > histogram->max_us)
+    {
+        histogram->max_us = value_us;
+    }
+}
@@ -1,6 +1,9 @@
 #include "esp32_driver_nextion/nextion.h"
 #include "esp32_driver_nextion/waveform.h"
 #include "assertion.h"
+#include "command_send.h"
+
+static bool nextion_waveform_is_retryable(nex_err_t code);
 
 nex_err_t nextion_waveform_start_refesh(nextion_t *handle)
 {
@@ -23,7 +26,7 @@ nex_err_t nextion_waveform_add_value(nextion_t *handle,
 {
     CMP_CHECK_HANDLE(handle, NEX_FAIL)
 
-    nex_err_t code = nextion_command_send(handle, "add %d,%d,%d", waveform_id, channel_id, value);
+    nex_err_t code = nextion_command_send_quiet(handle, "add %d,%d,%d", waveform_id, channel_id, value);
 
     // This operation does not respects the "bkcmd" value.
     // Will only return in case of failure.
@@ -75,9 +78,110 @@ nex_err_t nextion_waveform_stream_write(nextion_t *handle, uint8_t value)
     return nextion_transparent_data_mode_write(handle, value);
 }
 
+nex_err_t nextion_waveform_stream_write_buffer(nextion_t *handle, const uint8_t *values, size_t length)
+{
+    CMP_CHECK_HANDLE(handle, NEX_FAIL)
+
+    return nextion_transparent_data_mode_write_buffer(handle, values, length);
+}
+
 nex_err_t nextion_waveform_stream_end(nextion_t *handle)
 {
     CMP_CHECK_HANDLE(handle, NEX_FAIL)
 
     return nextion_transparent_data_mode_end(handle);
-}
\ No newline at end of file
+}
+
+nex_err_t nextion_waveform_push_series(nextion_t *handle,
+                                       uint8_t waveform_id,
+                                       uint8_t channel_id,
+                                       const uint8_t *values,
+                                       size_t length)
+{
+    CMP_CHECK_HANDLE(handle, NEX_FAIL)
+    CMP_CHECK((values != NULL), "values error(NULL)", NEX_FAIL)
+
+    size_t applied = 0;    // Values the display reported as added.
+    size_t open_start = 0; // First value of the transaction whose end was not waited for yet.
+    size_t open_count = 0; // How many values it has; zero if there is none.
+    size_t failures = 0;
+
+    while (applied < length || open_count > 0)
+    {
+        size_t next_start = open_count > 0 ? open_start + open_count : applied;
+        size_t next_count = length - next_start < NEX_WAVEFORM_STREAM_MAX_VALUES ? length - next_start : NEX_WAVEFORM_STREAM_MAX_VALUES;
+        nex_err_t end_code = NEX_OK;
+        nex_err_t code;
+
+        if (open_count == 0)
+        {
+            code = nextion_transparent_data_mode_begin(handle, next_count, "addt %d,%d,%d", waveform_id, channel_id, next_count);
+        }
+        else if (next_count == 0)
+        {
+            code = nextion_transparent_data_mode_end(handle);
+            end_code = code;
+        }
+        else
+        {
+            // The next command is written while the display still consumes the previous data.
+            code = nextion_transparent_data_mode_restart(handle, &end_code, next_count, "addt %d,%d,%d", waveform_id, channel_id, next_count);
+        }
+
+        if (open_count > 0 && end_code == NEX_OK)
+        {
+            applied = open_start + open_count;
+        }
+
+        open_count = 0;
+
+        if (code == NEX_OK && next_count > 0)
+        {
+            code = nextion_transparent_data_mode_write_buffer(handle, values + next_start, next_count);
+
+            if (code == NEX_OK)
+            {
+                open_start = next_start;
+                open_count = next_count;
+            }
+            else if (code != NEX_FAIL)
+            {
+                // The display might still wait for data; a new "addt" would be drawn.
+                CMP_LOGE("failed pushing series, %u of %u values added", (unsigned int)applied, (unsigned int)length);
+
+                return code;
+            }
+        }
+
+        if (code == NEX_OK)
+        {
+            failures = 0;
+            continue;
+        }
+
+        // Not applied values are sent again in a new transaction.
+
+        if (!nextion_waveform_is_retryable(code) || ++failures >= NEX_WAVEFORM_PUSH_ATTEMPTS)
+        {
+            CMP_LOGE("failed pushing series, %u of %u values added", (unsigned int)applied, (unsigned int)length);
+
+            return code;
+        }
+
+        CMP_LOGW("transaction failed, resuming at value %u", (unsigned int)applied);
+    }
+
+    return NEX_OK;
+}
+
+/**
+ * @brief Check if a failed transaction can be tried again.
+ * @details A lost response or a late end response of an interrupted transaction can be;
+ * a device error, as an invalid waveform, cannot.
+ * @param code Transaction result.
+ * @return True if it can be tried again, otherwise false.
+ */
+static bool nextion_waveform_is_retryable(nex_err_t code)
+{
+    return code == NEX_FAIL || code == NEX_TIMEOUT || code == NEX_DVC_RSP_TRANSPARENT_DATA_FINISHED;
+}
@@ -0,0 +1,208 @@
+#include <stdbool.h>
+#include "esp32_driver_nextion/waveform_decimation.h"
+#include "assertion.h"
+
+static bool nextion_waveform_scale_is_valid(const nextion_waveform_scale_t *scale);
+static size_t nextion_waveform_column_begin(size_t length, size_t width, size_t column);
+static uint8_t nextion_waveform_scale_value(float value, float low, float gain);
+static void nextion_waveform_column_set(nextion_waveform_column_t *column, float minimum, float maximum, const nextion_waveform_scale_t *scale);
+
+static const nextion_waveform_scale_t NEX_WAVEFORM_SCALE_U8 = {.low = 0.0f, .high = 255.0f};
+static const nextion_waveform_scale_t NEX_WAVEFORM_SCALE_I16 = {.low = -32768.0f, .high = 32767.0f};
+static const nextion_waveform_scale_t NEX_WAVEFORM_SCALE_FLOAT = {.low = -1.0f, .high = 1.0f};
+
+// The reduction loops are kept branchless, on the sample type, so the compiler
+// can vectorize them; only the two extremes of each column are scaled.
+
+size_t nextion_waveform_decimate_u8(const uint8_t *samples,
+                                    size_t length,
+                                    const nextion_waveform_scale_t *scale,
+                                    nextion_waveform_column_t *columns,
+                                    size_t width)
+{
+    CMP_CHECK((samples != NULL), "samples error(NULL)", 0)
+    CMP_CHECK((columns != NULL), "columns error(NULL)", 0)
+    CMP_CHECK((width > 0), "width error(<1)", 0)
+    CMP_CHECK((scale == NULL || nextion_waveform_scale_is_valid(scale)), "scale error(empty range)", 0)
+
+    scale = scale != NULL ? scale : &NEX_WAVEFORM_SCALE_U8;
+    width = length < width ? length : width;
+
+    for (size_t c = 0; c < width; c++)
+    {
+        size_t begin = nextion_waveform_column_begin(length, width, c);
+        size_t end = nextion_waveform_column_begin(length, width, c + 1);
+        uint8_t minimum = samples[begin];
+        uint8_t maximum = samples[begin];
+
+        for (size_t i = begin + 1; i < end; i++)
+        {
+            minimum = samples[i] < minimum ? samples[i] : minimum;
+            maximum = samples[i] > maximum ? samples[i] : maximum;
+        }
+
+        nextion_waveform_column_set(&columns[c], minimum, maximum, scale);
+    }
+
+    return width;
+}
+
+size_t nextion_waveform_decimate_i16(const int16_t *samples,
+                                     size_t length,
+                                     const nextion_waveform_scale_t *scale,
+                                     nextion_waveform_column_t *columns,
+                                     size_t width)
+{
+    CMP_CHECK((samples != NULL), "samples error(NULL)", 0)
+    CMP_CHECK((columns != NULL), "columns error(NULL)", 0)
+    CMP_CHECK((width > 0), "width error(<1)", 0)
+    CMP_CHECK((scale == NULL || nextion_waveform_scale_is_valid(scale)), "scale error(empty range)", 0)
+
+    scale = scale != NULL ? scale : &NEX_WAVEFORM_SCALE_I16;
+    width = length < width ? length : width;
+
+    for (size_t c = 0; c < width; c++)
+    {
+        size_t begin = nextion_waveform_column_begin(length, width, c);
+        size_t end = nextion_waveform_column_begin(length, width, c + 1);
+        int16_t minimum = samples[begin];
+        int16_t maximum = samples[begin];
+
+        for (size_t i = begin + 1; i < end; i++)
+        {
+            minimum = samples[i] < minimum ? samples[i] : minimum;
+            maximum = samples[i] > maximum ? samples[i] : maximum;
+        }
+
+        nextion_waveform_column_set(&columns[c], minimum, maximum, scale);
+    }
+
+    return width;
+}
+
+size_t nextion_waveform_decimate_float(const float *samples,
+                                       size_t length,
+                                       const nextion_waveform_scale_t *scale,
+                                       nextion_waveform_column_t *columns,
+                                       size_t width)
+{
+    CMP_CHECK((samples != NULL), "samples error(NULL)", 0)
+    CMP_CHECK((columns != NULL), "columns error(NULL)", 0)
+    CMP_CHECK((width > 0), "width error(<1)", 0)
+    CMP_CHECK((scale == NULL || nextion_waveform_scale_is_valid(scale)), "scale error(empty range)", 0)
+
+    scale = scale != NULL ? scale : &NEX_WAVEFORM_SCALE_FLOAT;
+    width = length < width ? length : width;
+
+    for (size_t c = 0; c < width; c++)
+    {
+        size_t begin = nextion_waveform_column_begin(length, width, c);
+        size_t end = nextion_waveform_column_begin(length, width, c + 1);
+
+        // Start from the first number; NaNs after it never compare.
+        while (begin + 1 < end && samples[begin] != samples[begin])
+        {
+            begin++;
+        }
+
+        float minimum = samples[begin];
+        float maximum = samples[begin];
+
+        for (size_t i = begin + 1; i < end; i++)
+        {
+            minimum = samples[i] < minimum ? samples[i] : minimum;
+            maximum = samples[i] > maximum ? samples[i] : maximum;
+        }
+
+        nextion_waveform_column_set(&columns[c], minimum, maximum, scale);
+    }
+
+    return width;
+}
+
+size_t nextion_waveform_columns_trace(const nextion_waveform_column_t *columns,
+                                      size_t count,
+                                      uint8_t previous,
+                                      uint8_t *values)
+{
+    CMP_CHECK((columns != NULL), "columns error(NULL)", 0)
+    CMP_CHECK((values != NULL), "values error(NULL)", 0)
+
+    int last = previous;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        int rise = columns[i].max - last;
+        int fall = last - columns[i].min;
+
+        last = rise >= fall ? columns[i].max : columns[i].min;
+        values[i] = (uint8_t)last;
+    }
+
+    return count;
+}
+
+/**
+ * @brief Check if a scale maps a non-empty range.
+ * @param scale Scale.
+ * @return True if valid, otherwise false.
+ */
+static bool nextion_waveform_scale_is_valid(const nextion_waveform_scale_t *scale)
+{
+    // Also false when either bound is NaN.
+    return scale->low < scale->high || scale->low > scale->high;
+}
+
+/**
+ * @brief Get the first sample of a column; columns split the samples as evenly as possible.
+ * @param length How many samples there are.
+ * @param width How many columns there are; not more than the samples.
+ * @param column Column index; "width" gives the end of the last column.
+ * @return Sample index.
+ */
+static size_t nextion_waveform_column_begin(size_t length, size_t width, size_t column)
+{
+    return (size_t)((uint64_t)column * length / width);
+}
+
+/**
+ * @brief Map a sample value to 0..255, rounded and clamped.
+ * @param value Sample value.
+ * @param low Sample value drawn at 0.
+ * @param gain Steps per sample unit; negative when drawn upside down.
+ * @return Scaled value; 0 for NaN.
+ */
+static uint8_t nextion_waveform_scale_value(float value, float low, float gain)
+{
+    float scaled = (value - low) * gain + 0.5f;
+
+    if (!(scaled > 0.0f))
+    {
+        return 0;
+    }
+
+    if (scaled >= 255.0f)
+    {
+        return 255;
+    }
+
+    return (uint8_t)scaled;
+}
+
+/**
+ * @brief Scale the extremes of a column.
+ * @param column Column to be set.
+ * @param minimum Lowest sample.
+ * @param maximum Highest sample.
+ * @param scale Scale.
+ */
+static void nextion_waveform_column_set(nextion_waveform_column_t *column, float minimum, float maximum, const nextion_waveform_scale_t *scale)
+{
+    float gain = 255.0f / (scale->high - scale->low);
+    uint8_t a = nextion_waveform_scale_value(minimum, scale->low, gain);
+    uint8_t b = nextion_waveform_scale_value(maximum, scale->low, gain);
+
+    // Upside down, the lowest sample is drawn the highest.
+    column->min = a < b ? a : b;
+    column->max = a < b ? b : a;
+}
@@ -0,0 +1,370 @@
+#include <stdlib.h>
+#include <stdatomic.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_timer.h"
+#include "esp32_driver_nextion/nextion.h"
+#include "esp32_driver_nextion/waveform.h"
+#include "esp32_driver_nextion/waveform_pump.h"
+#include "ring.h"
+#include "assertion.h"
+#include "config.h"
+
+/**
+ * @brief Share of each period the transactions are planned to take, in percent.
+ * The rest absorbs jitter and other commands.
+ */
+#define NEX_WAVEFORM_PUMP_LINK_LOAD_PERCENT 75U
+
+/**
+ * @brief Weight kept by the past transactions each time one is added to the cost fit.
+ */
+#define NEX_WAVEFORM_PUMP_FIT_DECAY 0.875f
+
+/**
+ * @brief Least spread of the transaction sizes, as a variance in values squared,
+ * for the fit to tell the cost of a value from the fixed cost of a transaction.
+ */
+#define NEX_WAVEFORM_PUMP_FIT_MIN_VARIANCE 4.0f
+
+struct nextion_waveform_pump_t
+{
+    nextion_t *handle;                                        /*!< Driver the values are sent through. */
+    nextion_waveform_pump_config_t config;                    /*!< Configuration. */
+    nextion_ring_t rings[NEX_WAVEFORM_PUMP_MAX_CHANNELS];     /*!< Queued values of each channel. */
+    uint8_t *ring_slots;                                      /*!< Slots of every channel ring, one after the other. */
+    uint8_t batch[NEX_WAVEFORM_STREAM_MAX_VALUES];            /*!< Values of the transaction being sent. */
+    float fit_weight;                                         /*!< Decayed count of the transactions in the cost fit. */
+    float fit_sum_x;                                          /*!< Decayed sum of their sizes, in values. */
+    float fit_sum_y;                                          /*!< Decayed sum of their times, in microseconds. */
+    float fit_sum_xx;                                         /*!< Decayed sum of their sizes squared. */
+    float fit_sum_xy;                                         /*!< Decayed sum of their sizes times their times. */
+    atomic_bool is_running;                                   /*!< If the task keeps going; cleared to stop it. */
+    TaskHandle_t task;                                        /*!< Task that drains the rings. */
+    SemaphoreHandle_t stopped;                                /*!< Given by the task when it is about to exit. */
+    atomic_uint_least32_t samples_queued;                     /*!< See nextion_waveform_pump_stats_t. */
+    atomic_uint_least32_t samples_sent;                       /*!< See nextion_waveform_pump_stats_t. */
+    atomic_uint_least32_t samples_dropped_full;               /*!< See nextion_waveform_pump_stats_t. */
+    atomic_uint_least32_t samples_dropped_behind;             /*!< See nextion_waveform_pump_stats_t. */
+    atomic_uint_least32_t samples_failed;                     /*!< See nextion_waveform_pump_stats_t. */
+    atomic_uint_least32_t transactions;                       /*!< See nextion_waveform_pump_stats_t. */
+    atomic_uint_least32_t transactions_failed;                /*!< See nextion_waveform_pump_stats_t. */
+    atomic_uint_least32_t batch_limit;                        /*!< See nextion_waveform_pump_stats_t. */
+    atomic_uint_least32_t link_rate;                          /*!< See nextion_waveform_pump_stats_t. */
+};
+
+static void nextion_waveform_pump_task(void *pvParameters);
+static void nextion_waveform_pump_cycle(nextion_waveform_pump_t *pump);
+static void nextion_waveform_pump_observe(nextion_waveform_pump_t *pump, size_t length, int64_t elapsed_us);
+static void nextion_waveform_pump_plan(nextion_waveform_pump_t *pump, size_t active);
+static void nextion_waveform_pump_free(nextion_waveform_pump_t *pump);
+
+nextion_waveform_pump_t *nextion_waveform_pump_create(nextion_t *handle, const nextion_waveform_pump_config_t *config)
+{
+    CMP_CHECK_HANDLE(handle, NULL)
+    CMP_CHECK((config != NULL), "config error(NULL)", NULL)
+    CMP_CHECK((config->channel_count > 0), "channel_count error(<1)", NULL)
+    CMP_CHECK((config->channel_count <= NEX_WAVEFORM_PUMP_MAX_CHANNELS), "channel_count error(>NEX_WAVEFORM_PUMP_MAX_CHANNELS)", NULL)
+    CMP_CHECK((config->period_ms > 0), "period_ms error(<1)", NULL)
+    CMP_CHECK((config->ring_size > 0), "ring_size error(<1)", NULL)
+
+    nextion_waveform_pump_t *pump = (nextion_waveform_pump_t *)calloc(1, sizeof(nextion_waveform_pump_t));
+
+    CMP_CHECK((pump != NULL), "pump error(no memory)", NULL)
+
+    pump->handle = handle;
+    pump->config = *config;
+
+    atomic_init(&pump->is_running, true);
+    atomic_init(&pump->batch_limit, NEX_WAVEFORM_STREAM_MAX_VALUES);
+
+    const size_t slots_size = NEX_RING_SLOTS_SIZE(1U, config->ring_size);
+
+    pump->ring_slots = (uint8_t *)malloc(slots_size * config->channel_count);
+
+    if (pump->ring_slots == NULL)
+    {
+        CMP_LOGE("failed allocating channel rings");
+
+        nextion_waveform_pump_free(pump);
+
+        return NULL;
+    }
+
+    for (size_t c = 0; c < config->channel_count; c++)
+    {
+        nextion_ring_init(&pump->rings[c], pump->ring_slots + c * slots_size, 1U, config->ring_size);
+    }
+
+    pump->stopped = xSemaphoreCreateBinary();
+
+    if (xTaskCreate(&nextion_waveform_pump_task,
+                    "nextion_pump",
+                    CONFIG_NEX_WAVEFORM_PUMP_TASK_STACK_SIZE,
+                    (void *)pump,
+                    CONFIG_NEX_WAVEFORM_PUMP_TASK_PRIORITY,
+                    &pump->task) != pdPASS)
+    {
+        CMP_LOGE("failed creating waveform pump task");
+
+        nextion_waveform_pump_free(pump);
+
+        return NULL;
+    }
+
+    return pump;
+}
+
+bool nextion_waveform_pump_delete(nextion_waveform_pump_t *pump)
+{
+    CMP_CHECK((pump != NULL), "pump error(NULL)", false)
+
+    // The task is not deleted from here: it could be holding the driver.
+    atomic_store(&pump->is_running, false);
+
+    xTaskNotifyGive(pump->task);
+    xSemaphoreTake(pump->stopped, portMAX_DELAY);
+
+    nextion_waveform_pump_free(pump);
+
+    return true;
+}
+
+size_t nextion_waveform_pump_push(nextion_waveform_pump_t *pump, uint8_t channel_id, const uint8_t *values, size_t length)
+{
+    CMP_CHECK((pump != NULL), "pump error(NULL)", 0)
+    CMP_CHECK((values != NULL), "values error(NULL)", 0)
+    CMP_CHECK((channel_id < pump->config.channel_count), "channel_id error(>=channel_count)", 0)
+
+    size_t queued = nextion_ring_push(&pump->rings[channel_id], values, length);
+
+    atomic_fetch_add_explicit(&pump->samples_queued, (uint32_t)queued, memory_order_relaxed);
+    atomic_fetch_add_explicit(&pump->samples_dropped_full, (uint32_t)(length - queued), memory_order_relaxed);
+
+    return queued;
+}
+
+bool nextion_waveform_pump_stats_get(nextion_waveform_pump_t *pump, nextion_waveform_pump_stats_t *stats)
+{
+    CMP_CHECK((pump != NULL), "pump error(NULL)", false)
+    CMP_CHECK((stats != NULL), "stats error(NULL)", false)
+
+    stats->samples_queued = atomic_load_explicit(&pump->samples_queued, memory_order_relaxed);
+    stats->samples_sent = atomic_load_explicit(&pump->samples_sent, memory_order_relaxed);
+    stats->samples_dropped_full = atomic_load_explicit(&pump->samples_dropped_full, memory_order_relaxed);
+    stats->samples_dropped_behind = atomic_load_explicit(&pump->samples_dropped_behind, memory_order_relaxed);
+    stats->samples_failed = atomic_load_explicit(&pump->samples_failed, memory_order_relaxed);
+    stats->transactions = atomic_load_explicit(&pump->transactions, memory_order_relaxed);
+    stats->transactions_failed = atomic_load_explicit(&pump->transactions_failed, memory_order_relaxed);
+    stats->batch_limit = atomic_load_explicit(&pump->batch_limit, memory_order_relaxed);
+    stats->link_values_per_sec = atomic_load_explicit(&pump->link_rate, memory_order_relaxed);
+
+    return true;
+}
+
+/**
+ * @brief Drain the rings every period, until stopped.
+ * @param pvParameters Pump pointer.
+ */
+static void nextion_waveform_pump_task(void *pvParameters)
+{
+    nextion_waveform_pump_t *pump = (nextion_waveform_pump_t *)pvParameters;
+    const TickType_t period = pdMS_TO_TICKS(pump->config.period_ms) > 0 ? pdMS_TO_TICKS(pump->config.period_ms) : 1;
+    TickType_t next_wake = xTaskGetTickCount() + period;
+
+    for (;;)
+    {
+        TickType_t now = xTaskGetTickCount();
+
+        // Woken early only to stop.
+        if ((int32_t)(next_wake - now) > 0)
+        {
+            ulTaskNotifyTake(pdTRUE, next_wake - now);
+        }
+
+        if (!atomic_load(&pump->is_running))
+        {
+            break;
+        }
+
+        now = xTaskGetTickCount();
+
+        if ((int32_t)(next_wake - now) > 0)
+        {
+            continue;
+        }
+
+        // A late cycle is not made up for with a burst.
+        next_wake = (int32_t)(now - next_wake) >= (int32_t)period ? now + period : next_wake + period;
+
+        nextion_waveform_pump_cycle(pump);
+    }
+
+    xSemaphoreGive(pump->stopped);
+
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief Send the queued values of every channel, up to the batch limit each.
+ * @param pump Pump pointer.
+ */
+static void nextion_waveform_pump_cycle(nextion_waveform_pump_t *pump)
+{
+    size_t active = 0;
+
+    for (size_t c = 0; c < pump->config.channel_count; c++)
+    {
+        active += nextion_ring_count(&pump->rings[c]) > 0;
+    }
+
+    if (active == 0)
+    {
+        return;
+    }
+
+    size_t limit = atomic_load_explicit(&pump->batch_limit, memory_order_relaxed);
+
+    for (size_t c = 0; c < pump->config.channel_count; c++)
+    {
+        nextion_ring_t *ring = &pump->rings[c];
+        size_t count = nextion_ring_count(ring);
+
+        if (count == 0)
+        {
+            continue;
+        }
+
+        // Behind: the oldest values are dropped so the graph stays live.
+        if (count > limit)
+        {
+            size_t dropped = nextion_ring_pop(ring, NULL, count - limit);
+
+            atomic_fetch_add_explicit(&pump->samples_dropped_behind, (uint32_t)dropped, memory_order_relaxed);
+
+            CMP_LOGD("channel %u behind, dropped %u values", (unsigned int)c, (unsigned int)dropped);
+        }
+
+        size_t length = nextion_ring_pop(ring, pump->batch, limit);
+        int64_t started = esp_timer_get_time();
+        nex_err_t code = nextion_waveform_push_series(pump->handle, pump->config.waveform_id, (uint8_t)c, pump->batch, length);
+
+        if (code == NEX_OK)
+        {
+            nextion_waveform_pump_observe(pump, length, esp_timer_get_time() - started);
+
+            atomic_fetch_add_explicit(&pump->samples_sent, (uint32_t)length, memory_order_relaxed);
+            atomic_fetch_add_explicit(&pump->transactions, 1, memory_order_relaxed);
+        }
+        else
+        {
+            // Failures take the time of a timeout; they say nothing about the costs.
+
+            atomic_fetch_add_explicit(&pump->samples_failed, (uint32_t)length, memory_order_relaxed);
+            atomic_fetch_add_explicit(&pump->transactions_failed, 1, memory_order_relaxed);
+
+            CMP_LOGW("channel %u transaction failed(%d)", (unsigned int)c, code);
+        }
+    }
+
+    nextion_waveform_pump_plan(pump, active);
+}
+
+/**
+ * @brief Add a transaction to the cost fit.
+ * @param pump Pump pointer.
+ * @param length How many values it sent.
+ * @param elapsed_us How long it took.
+ */
+static void nextion_waveform_pump_observe(nextion_waveform_pump_t *pump, size_t length, int64_t elapsed_us)
+{
+    if (length == 0 || elapsed_us <= 0)
+    {
+        return;
+    }
+
+    const float x = (float)length;
+    const float y = (float)elapsed_us;
+
+    // Decayed, so the fit follows baud rate and load changes.
+    pump->fit_weight = pump->fit_weight * NEX_WAVEFORM_PUMP_FIT_DECAY + 1.0f;
+    pump->fit_sum_x = pump->fit_sum_x * NEX_WAVEFORM_PUMP_FIT_DECAY + x;
+    pump->fit_sum_y = pump->fit_sum_y * NEX_WAVEFORM_PUMP_FIT_DECAY + y;
+    pump->fit_sum_xx = pump->fit_sum_xx * NEX_WAVEFORM_PUMP_FIT_DECAY + x * x;
+    pump->fit_sum_xy = pump->fit_sum_xy * NEX_WAVEFORM_PUMP_FIT_DECAY + x * y;
+}
+
+/**
+ * @brief Update the link capacity and the batch limit with the cost fit.
+ * @details A transaction takes a fixed time, for its "addt" handshake, plus a time per
+ * value; a line fitted over the transaction sizes tells them apart. While the sizes are
+ * all alike, as when every batch is full, the time per value is taken from the link
+ * instead. The limit is what each active channel can send in its share of the period
+ * once its fixed time is paid, so it grows as long as the period has room.
+ * @param pump Pump pointer.
+ * @param active How many channels had values.
+ */
+static void nextion_waveform_pump_plan(nextion_waveform_pump_t *pump, size_t active)
+{
+    if (pump->fit_weight <= 0.0f)
+    {
+        return;
+    }
+
+    nextion_link_info_t info = {0};
+
+    nextion_link_get_info(pump->handle, &info);
+
+    // One byte per value; ten bits per byte when not measured yet.
+    const uint32_t bytes_per_sec = info.throughput > 0 ? info.throughput : info.baud_rate / 10U;
+    const float mean_x = pump->fit_sum_x / pump->fit_weight;
+    const float mean_y = pump->fit_sum_y / pump->fit_weight;
+    const float variance = pump->fit_sum_xx / pump->fit_weight - mean_x * mean_x;
+    float value_us = bytes_per_sec > 0 ? 1000000.0f / (float)bytes_per_sec : 0.0f;
+
+    if (variance >= NEX_WAVEFORM_PUMP_FIT_MIN_VARIANCE)
+    {
+        const float slope = (pump->fit_sum_xy / pump->fit_weight - mean_x * mean_y) / variance;
+
+        if (slope > 0.0f)
+        {
+            value_us = slope;
+        }
+    }
+
+    if (value_us <= 0.0f)
+    {
+        return;
+    }
+
+    float overhead_us = mean_y - value_us * mean_x;
+
+    if (overhead_us < 0.0f)
+    {
+        overhead_us = 0.0f;
+    }
+
+    const float share_us = (float)pump->config.period_ms * 1000.0f * NEX_WAVEFORM_PUMP_LINK_LOAD_PERCENT / 100.0f / (float)active;
+    const float fitting = (share_us - overhead_us) / value_us;
+    uint32_t limit = fitting < 1.0f ? 1U : fitting > (float)NEX_WAVEFORM_STREAM_MAX_VALUES ? NEX_WAVEFORM_STREAM_MAX_VALUES : (uint32_t)fitting;
+
+    atomic_store_explicit(&pump->link_rate, (uint32_t)(1000000.0f / value_us), memory_order_relaxed);
+    atomic_store_explicit(&pump->batch_limit, limit, memory_order_relaxed);
+}
+
+/**
+ * @brief Free the pump and its rings.
+ * @param pump Pump pointer.
+ */
+static void nextion_waveform_pump_free(nextion_waveform_pump_t *pump)
+{
+    free(pump->ring_slots);
+
+    if (pump->stopped != NULL)
+    {
+        vSemaphoreDelete(pump->stopped);
+    }
+
+    free(pump);
+}
@@ -0,0 +1,219 @@
+#include <string.h>
+#include "wire_capture.h"
+
+#define NEX_WIRE_CAPTURE_CAPACITY sizeof(((nextion_wire_capture_t *)0)->buffer)
+
+static void nextion_wire_capture_copy_in(nextion_wire_capture_t *capture, size_t offset, const uint8_t *bytes, size_t length);
+static void nextion_wire_capture_copy_out(const nextion_wire_capture_t *capture, size_t offset, uint8_t *bytes, size_t length);
+static size_t nextion_wire_capture_record_length(const nextion_wire_capture_t *capture, size_t offset);
+static void nextion_wire_capture_drop_oldest(nextion_wire_capture_t *capture);
+
+void nextion_wire_capture_init(nextion_wire_capture_t *capture)
+{
+    memset(capture, 0, sizeof(nextion_wire_capture_t));
+
+    portMUX_INITIALIZE(&capture->lock);
+}
+
+void nextion_wire_capture_clear(nextion_wire_capture_t *capture)
+{
+    portENTER_CRITICAL(&capture->lock);
+
+    capture->head = 0;
+    capture->used = 0;
+    capture->records = 0;
+    capture->overwritten = 0;
+    capture->skipped = 0;
+
+    portEXIT_CRITICAL(&capture->lock);
+}
+
+void nextion_wire_capture_record(nextion_wire_capture_t *capture,
+                                 nextion_wire_capture_direction_t direction,
+                                 int64_t timestamp_us,
+                                 const uint8_t *bytes,
+                                 size_t length)
+{
+    if (CONFIG_NEX_WIRE_CAPTURE_SIZE <= NEX_WIRE_CAPTURE_HEADER_LENGTH)
+    {
+        return;
+    }
+
+    const size_t max_run = NEX_WIRE_CAPTURE_CAPACITY - NEX_WIRE_CAPTURE_HEADER_LENGTH < NEX_WIRE_CAPTURE_MAX_RUN_LENGTH
+                               ? NEX_WIRE_CAPTURE_CAPACITY - NEX_WIRE_CAPTURE_HEADER_LENGTH
+                               : NEX_WIRE_CAPTURE_MAX_RUN_LENGTH;
+
+    portENTER_CRITICAL(&capture->lock);
+
+    if (capture->is_reading)
+    {
+        capture->skipped++;
+
+        portEXIT_CRITICAL(&capture->lock);
+
+        return;
+    }
+
+    while (length > 0)
+    {
+        size_t run = length < max_run ? length : max_run;
+        uint8_t header[NEX_WIRE_CAPTURE_HEADER_LENGTH];
+        uint16_t info = (uint16_t)(run | (direction == NEX_WIRE_CAPTURE_RX ? 0x8000U : 0U));
+
+        for (size_t i = 0; i < 8; i++)
+        {
+            header[i] = (uint8_t)((uint64_t)timestamp_us >> (8 * i));
+        }
+
+        header[8] = (uint8_t)info;
+        header[9] = (uint8_t)(info >> 8);
+
+        while (NEX_WIRE_CAPTURE_CAPACITY - capture->used < NEX_WIRE_CAPTURE_HEADER_LENGTH + run)
+        {
+            nextion_wire_capture_drop_oldest(capture);
+        }
+
+        size_t tail = (capture->head + capture->used) % NEX_WIRE_CAPTURE_CAPACITY;
+
+        nextion_wire_capture_copy_in(capture, tail, header, NEX_WIRE_CAPTURE_HEADER_LENGTH);
+        nextion_wire_capture_copy_in(capture, (tail + NEX_WIRE_CAPTURE_HEADER_LENGTH) % NEX_WIRE_CAPTURE_CAPACITY, bytes, run);
+
+        capture->used += NEX_WIRE_CAPTURE_HEADER_LENGTH + run;
+        capture->records++;
+
+        bytes += run;
+        length -= run;
+    }
+
+    portEXIT_CRITICAL(&capture->lock);
+}
+
+size_t nextion_wire_capture_read(nextion_wire_capture_t *capture, nextion_wire_capture_visitor_t visitor, void *context)
+{
+    portENTER_CRITICAL(&capture->lock);
+
+    if (capture->is_reading)
+    {
+        portEXIT_CRITICAL(&capture->lock);
+
+        return 0;
+    }
+
+    // Writers skip while reading, so the records stay put without holding the lock.
+    capture->is_reading = true;
+
+    size_t offset = capture->head;
+    uint32_t records = capture->records;
+
+    portEXIT_CRITICAL(&capture->lock);
+
+    for (uint32_t i = 0; i < records; i++)
+    {
+        uint8_t header[NEX_WIRE_CAPTURE_HEADER_LENGTH];
+        uint8_t piece[NEX_WIRE_CAPTURE_VISIT_LENGTH];
+        uint64_t timestamp = 0;
+
+        nextion_wire_capture_copy_out(capture, offset, header, NEX_WIRE_CAPTURE_HEADER_LENGTH);
+
+        for (size_t b = 0; b < 8; b++)
+        {
+            timestamp |= (uint64_t)header[b] << (8 * b);
+        }
+
+        uint16_t info = (uint16_t)(header[8] | (header[9] << 8));
+        size_t length = info & NEX_WIRE_CAPTURE_MAX_RUN_LENGTH;
+        nextion_wire_capture_direction_t direction = (info & 0x8000U) ? NEX_WIRE_CAPTURE_RX : NEX_WIRE_CAPTURE_TX;
+        size_t position = (offset + NEX_WIRE_CAPTURE_HEADER_LENGTH) % NEX_WIRE_CAPTURE_CAPACITY;
+
+        for (size_t done = 0; done < length;)
+        {
+            size_t size = length - done < NEX_WIRE_CAPTURE_VISIT_LENGTH ? length - done : NEX_WIRE_CAPTURE_VISIT_LENGTH;
+
+            nextion_wire_capture_copy_out(capture, position, piece, size);
+
+            visitor(context, direction, (int64_t)timestamp, piece, size);
+
+            position = (position + size) % NEX_WIRE_CAPTURE_CAPACITY;
+            done += size;
+        }
+
+        offset = position;
+    }
+
+    portENTER_CRITICAL(&capture->lock);
+
+    capture->is_reading = false;
+
+    portEXIT_CRITICAL(&capture->lock);
+
+    return records;
+}
+
+/**
+ * @brief Write bytes into the ring, wrapping at its end.
+ * @param capture Ring pointer.
+ * @param offset Where to start writing.
+ * @param bytes Bytes.
+ * @param length How many bytes there are; must fit in the ring.
+ */
+static void nextion_wire_capture_copy_in(nextion_wire_capture_t *capture, size_t offset, const uint8_t *bytes, size_t length)
+{
+    size_t first = NEX_WIRE_CAPTURE_CAPACITY - offset;
+
+    if (first > length)
+    {
+        first = length;
+    }
+
+    memcpy(capture->buffer + offset, bytes, first);
+    memcpy(capture->buffer, bytes + first, length - first);
+}
+
+/**
+ * @brief Read bytes from the ring, wrapping at its end.
+ * @param capture Ring pointer.
+ * @param offset Where to start reading.
+ * @param bytes Location where the bytes will be stored.
+ * @param length How many bytes to read.
+ */
+static void nextion_wire_capture_copy_out(const nextion_wire_capture_t *capture, size_t offset, uint8_t *bytes, size_t length)
+{
+    size_t first = NEX_WIRE_CAPTURE_CAPACITY - offset;
+
+    if (first > length)
+    {
+        first = length;
+    }
+
+    memcpy(bytes, capture->buffer + offset, first);
+    memcpy(bytes + first, capture->buffer, length - first);
+}
+
+/**
+ * @brief Get how many bytes a record takes, header included.
+ * @param capture Ring pointer.
+ * @param offset Where the record starts.
+ * @return Record length.
+ */
+static size_t nextion_wire_capture_record_length(const nextion_wire_capture_t *capture, size_t offset)
+{
+    uint8_t info[2];
+
+    nextion_wire_capture_copy_out(capture, (offset + 8) % NEX_WIRE_CAPTURE_CAPACITY, info, sizeof(info));
+
+    return NEX_WIRE_CAPTURE_HEADER_LENGTH + ((info[0] | (info[1] << 8)) & NEX_WIRE_CAPTURE_MAX_RUN_LENGTH);
+}
+
+/**
+ * @brief Discard the oldest record.
+ * @param capture Ring pointer; must hold a record.
+ */
+static void nextion_wire_capture_drop_oldest(nextion_wire_capture_t *capture)
+{
+    size_t length = nextion_wire_capture_record_length(capture, capture->head);
+
+    capture->head = (capture->head + length) % NEX_WIRE_CAPTURE_CAPACITY;
+    capture->used -= length;
+    capture->records--;
+    capture->overwritten++;
+}
@@ -0,0 +1,146 @@
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp32_driver_nextion/animation.h"
+#include "common_infra_test.h"
+
+#define TEST_ANIMATION_WAIT_MS 2000U
+
+/**
+ * @brief Ten frames in two rows of picture 0 of the test HMI, 170x97.
+ */
+static const nextion_animation_config_t TEST_ANIMATION_CONFIG = {
+    .picture_id = 0,
+    .origin = {.x = 0, .y = 0},
+    .frame_width = 34,
+    .frame_height = 48,
+    .columns = 5,
+    .frame_count = 10,
+    .destination = {.x = 200, .y = 100},
+    .frame_period_ms = 20,
+    .is_looping = true};
+
+TEST_CASE("Animation drops frames beyond the link budget", "[animation]")
+{
+    nextion_link_info_t info;
+    nextion_animation_stats_t stats;
+
+    nextion_link_get_info(handle, &info);
+
+    // A period holds less than a frame.
+    CHECK_NEX_OK(nextion_baud_rate_set(handle, NEXTION_BAUD_RATE_9600));
+
+    nextion_animation_t *animation = nextion_animation_create(handle, &TEST_ANIMATION_CONFIG);
+
+    CHECK_NOT_NULL(animation);
+
+    CHECK_NEX_OK(nextion_animation_start(animation));
+    CHECK_TRUE(nextion_animation_is_playing(animation));
+
+    vTaskDelay(pdMS_TO_TICKS(1000));
+
+    CHECK_NEX_OK(nextion_animation_stop(animation));
+    CHECK_TRUE(nextion_animation_stats_get(animation, &stats));
+    CHECK_TRUE(nextion_animation_delete(animation));
+
+    nextion_baud_rate_set(handle, info.baud_rate);
+
+    // Frames take at least 30 bytes; the first one is sent right away.
+    CHECK_TRUE(stats.bytes_per_period > 0);
+    CHECK_TRUE(stats.bytes_per_period < 30);
+    CHECK_TRUE(stats.frames_sent >= 2);
+    CHECK_TRUE(stats.frames_sent * 30 <= 1000 / TEST_ANIMATION_CONFIG.frame_period_ms * stats.bytes_per_period + 30);
+    CHECK_TRUE(stats.frames_dropped_budget > 0);
+    SIZET_EQUAL(0, stats.frames_failed);
+}
+
+TEST_CASE("Animation stops at its last frame", "[animation]")
+{
+    nextion_animation_config_t config = TEST_ANIMATION_CONFIG;
+    nextion_animation_stats_t stats;
+
+    config.frame_count = 3;
+    config.frame_period_ms = 100;
+    config.is_looping = false;
+
+    nextion_animation_t *animation = nextion_animation_create(handle, &config);
+
+    CHECK_NOT_NULL(animation);
+
+    CHECK_NEX_OK(nextion_animation_start(animation));
+
+    for (uint32_t waited = 0; nextion_animation_is_playing(animation) && waited < TEST_ANIMATION_WAIT_MS; waited += 50)
+    {
+        vTaskDelay(pdMS_TO_TICKS(50));
+    }
+
+    CHECK_FALSE(nextion_animation_is_playing(animation));
+    CHECK_TRUE(nextion_animation_stats_get(animation, &stats));
+    CHECK_TRUE(nextion_animation_delete(animation));
+
+    CHECK_TRUE(stats.frames_sent >= 1);
+    CHECK_TRUE(stats.frames_sent <= 3);
+    SIZET_EQUAL(0, stats.frames_failed);
+}
+
+TEST_CASE("Stopped animation sends nothing", "[animation]")
+{
+    nextion_stats_t before;
+    nextion_stats_t after;
+    nextion_animation_t *animation = nextion_animation_create(handle, &TEST_ANIMATION_CONFIG);
+
+    CHECK_NOT_NULL(animation);
+
+    CHECK_NEX_OK(nextion_animation_start(animation));
+
+    vTaskDelay(pdMS_TO_TICKS(200));
+
+    CHECK_NEX_OK(nextion_animation_stop(animation));
+
+    // A frame already sent is still answered.
+    vTaskDelay(pdMS_TO_TICKS(100));
+
+    CHECK_NEX_OK(nextion_stats_get(handle, &before));
+
+    vTaskDelay(pdMS_TO_TICKS(200));
+
+    CHECK_NEX_OK(nextion_stats_get(handle, &after));
+    CHECK_TRUE(nextion_animation_delete(animation));
+
+    SIZET_EQUAL(before.commands_sent, after.commands_sent);
+}
+
+TEST_CASE("Other commands run while animating", "[animation]")
+{
+    nextion_animation_stats_t stats;
+    const area_t area = {.upper_left = {.x = 0, .y = 0}, .bottom_right = {.x = 10, .y = 10}};
+    nextion_animation_t *animation = nextion_animation_create(handle, &TEST_ANIMATION_CONFIG);
+
+    CHECK_NOT_NULL(animation);
+
+    CHECK_NEX_OK(nextion_animation_start(animation));
+
+    for (int i = 0; i < 10; i++)
+    {
+        CHECK_NEX_OK(nextion_draw_fill_area(handle, area, RGB565_COLOR_RED));
+    }
+
+    CHECK_TRUE(nextion_animation_stats_get(animation, &stats));
+    CHECK_TRUE(nextion_animation_delete(animation));
+
+    SIZET_EQUAL(0, stats.frames_failed);
+}
+
+TEST_CASE("Cannot create animation without frames", "[animation]")
+{
+    nextion_animation_config_t config = TEST_ANIMATION_CONFIG;
+
+    config.frame_count = 0;
+
+    CHECK_NULL(nextion_animation_create(handle, &config));
+    CHECK_NULL(nextion_animation_create(handle, NULL));
+
+    config = TEST_ANIMATION_CONFIG;
+    config.columns = 0;
+
+    CHECK_NULL(nextion_animation_create(handle, &config));
+}
@@ -0,0 +1,172 @@
+#include <string.h>
+#include "command_builder.h"
+#include "common_infra_test.h"
+
+typedef struct
+{
+    char data[64];
+    size_t length;
+    size_t flushes;
+} command_builder_sink_t;
+
+static bool command_builder_test_flush(void *context, const char *data, size_t length)
+{
+    command_builder_sink_t *sink = (command_builder_sink_t *)context;
+
+    memcpy(sink->data + sink->length, data, length);
+
+    sink->length += length;
+    sink->flushes++;
+
+    return true;
+}
+
+static bool command_builder_test_format(nextion_command_builder_t *builder, const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+
+    bool result = nextion_command_builder_append_format(builder, format, args);
+
+    va_end(args);
+
+    return result;
+}
+
+TEST_CASE("Build command with typed appends", "[command_builder]")
+{
+    char buffer[32];
+    nextion_command_builder_t builder;
+
+    nextion_command_builder_init(&builder, buffer, sizeof(buffer), 0, NULL, NULL);
+    nextion_command_builder_append_identifier(&builder, "n0");
+    nextion_command_builder_append_char(&builder, '.');
+    nextion_command_builder_append_identifier(&builder, "val");
+    nextion_command_builder_append_char(&builder, '=');
+    nextion_command_builder_append_int(&builder, -2147483647 - 1);
+
+    bool result = nextion_command_builder_append_end(&builder);
+
+    CHECK_TRUE(result);
+    SIZET_EQUAL(21, builder.length);
+    TEST_ASSERT_EQUAL_MEMORY("n0.val=-2147483648\xFF\xFF\xFF", buffer, 21);
+}
+
+TEST_CASE("Build unsigned integers", "[command_builder]")
+{
+    char buffer[32];
+    nextion_command_builder_t builder;
+
+    nextion_command_builder_init(&builder, buffer, sizeof(buffer), 0, NULL, NULL);
+    nextion_command_builder_append_uint(&builder, 0);
+    nextion_command_builder_append_char(&builder, ',');
+    nextion_command_builder_append_uint(&builder, 4294967295U);
+
+    SIZET_EQUAL(12, builder.length);
+    TEST_ASSERT_EQUAL_MEMORY("0,4294967295", buffer, 12);
+}
+
+TEST_CASE("Build quoted text with escapes", "[command_builder]")
+{
+    char buffer[32];
+    nextion_command_builder_t builder;
+
+    nextion_command_builder_init(&builder, buffer, sizeof(buffer), 0, NULL, NULL);
+
+    bool result = nextion_command_builder_append_quoted(&builder, "a\"b\r\nc\nd\\r");
+
+    CHECK_TRUE(result);
+    SIZET_EQUAL(14, builder.length);
+    TEST_ASSERT_EQUAL_MEMORY("\"a\\\"b\\rc\\rd\\r\"", buffer, 14);
+}
+
+TEST_CASE("Build formatted command", "[command_builder]")
+{
+    char buffer[48];
+    nextion_command_builder_t builder;
+
+    nextion_command_builder_init(&builder, buffer, sizeof(buffer), 0, NULL, NULL);
+
+    bool result = command_builder_test_format(&builder, "%s.%s=\"%s\" %d,%lu%%%c", "t0", "txt", "say \"hi\"", -5, 7UL, 'x');
+
+    CHECK_TRUE(result);
+    SIZET_EQUAL(26, builder.length);
+    TEST_ASSERT_EQUAL_MEMORY("t0.txt=\"say \\\"hi\\\"\" -5,7%x", buffer, 26);
+}
+
+TEST_CASE("Build other printf conversions", "[command_builder]")
+{
+    char buffer[64];
+    nextion_command_builder_t builder;
+
+    nextion_command_builder_init(&builder, buffer, sizeof(buffer), 0, NULL, NULL);
+
+    bool result = command_builder_test_format(&builder, "%x,%04X,%.2f,%5d,%-3s|,%.2s,%*d,%lld,%zu",
+                                              255U, 0xABU, 1.5, -12, "a", "xyz", 3, 7, -9000000000LL, (size_t)42);
+
+    CHECK_TRUE(result);
+    SIZET_EQUAL(45, builder.length);
+    TEST_ASSERT_EQUAL_MEMORY("ff,00AB,1.50,  -12,a  |,xy,  7,-9000000000,42", buffer, 45);
+}
+
+TEST_CASE("Quoted text keeps escapes written by the caller", "[command_builder]")
+{
+    char buffer[48];
+    nextion_command_builder_t builder;
+
+    nextion_command_builder_init(&builder, buffer, sizeof(buffer), 0, NULL, NULL);
+
+    // Already escaped, then raw: both end up escaped once.
+    bool result = command_builder_test_format(&builder, "t0.txt=\"%s\"+\"%s\"", "say \\\"hi\\\"", "say \"hi\"\\");
+
+    CHECK_TRUE(result);
+    SIZET_EQUAL(34, builder.length);
+    TEST_ASSERT_EQUAL_MEMORY("t0.txt=\"say \\\"hi\\\"\"+\"say \\\"hi\\\"\\\\\"", buffer, 34);
+}
+
+TEST_CASE("Cannot build unknown conversion", "[command_builder]")
+{
+    char buffer[32];
+    nextion_command_builder_t builder;
+    int count = 0;
+
+    nextion_command_builder_init(&builder, buffer, sizeof(buffer), 0, NULL, NULL);
+
+    bool result = command_builder_test_format(&builder, "x=%n", &count);
+
+    CHECK_FALSE(result);
+}
+
+TEST_CASE("Cannot build past the buffer without flush", "[command_builder]")
+{
+    char buffer[4];
+    nextion_command_builder_t builder;
+
+    nextion_command_builder_init(&builder, buffer, sizeof(buffer), 0, NULL, NULL);
+
+    bool result = nextion_command_builder_append_identifier(&builder, "page0");
+
+    CHECK_FALSE(result);
+    CHECK_TRUE(builder.failed);
+}
+
+TEST_CASE("Build long command in pieces", "[command_builder]")
+{
+    char buffer[8];
+    command_builder_sink_t sink = {.length = 0, .flushes = 0};
+    nextion_command_builder_t builder;
+
+    nextion_command_builder_init(&builder, buffer, sizeof(buffer), 2, &command_builder_test_flush, &sink);
+
+    buffer[0] = 'a';
+    buffer[1] = 'b';
+
+    nextion_command_builder_append_identifier(&builder, "cdefghijklmnopq");
+
+    bool result = nextion_command_builder_flush(&builder);
+
+    CHECK_TRUE(result);
+    SIZET_EQUAL(3, sink.flushes);
+    SIZET_EQUAL(17, sink.length);
+    TEST_ASSERT_EQUAL_MEMORY("abcdefghijklmnopq", sink.data, 17);
+}
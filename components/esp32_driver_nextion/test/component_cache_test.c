@@ -0,0 +1,169 @@
+#include <stdio.h>
+#include <string.h>
+#include "component_cache.h"
+#include "common_infra_test.h"
+
+static nextion_component_cache_t cache;
+
+TEST_CASE("Cache misses unknown property", "[cache]")
+{
+    nextion_component_cache_init(&cache);
+
+    CHECK_FALSE(nextion_component_cache_contains(&cache, NEX_COMPONENT_CACHE_NUMBER, "n0", "val", 10, NULL));
+    SIZET_EQUAL(1, cache.stats.misses);
+}
+
+TEST_CASE("Cache hits stored number", "[cache]")
+{
+    nextion_component_cache_init(&cache);
+    nextion_component_cache_store(&cache, NEX_COMPONENT_CACHE_NUMBER, "n0", "val", 10, NULL);
+
+    CHECK_TRUE(nextion_component_cache_contains(&cache, NEX_COMPONENT_CACHE_NUMBER, "n0", "val", 10, NULL));
+    CHECK_FALSE(nextion_component_cache_contains(&cache, NEX_COMPONENT_CACHE_NUMBER, "n0", "val", 11, NULL));
+    CHECK_FALSE(nextion_component_cache_contains(&cache, NEX_COMPONENT_CACHE_NUMBER, "n0", "pco", 10, NULL));
+    SIZET_EQUAL(1, cache.stats.hits);
+    SIZET_EQUAL(2, cache.stats.misses);
+}
+
+TEST_CASE("Cache hits stored text", "[cache]")
+{
+    nextion_component_cache_init(&cache);
+    nextion_component_cache_store(&cache, NEX_COMPONENT_CACHE_TEXT, "t0", "txt", 0, "abc");
+
+    CHECK_TRUE(nextion_component_cache_contains(&cache, NEX_COMPONENT_CACHE_TEXT, "t0", "txt", 0, "abc"));
+    CHECK_FALSE(nextion_component_cache_contains(&cache, NEX_COMPONENT_CACHE_TEXT, "t0", "txt", 0, "abd"));
+}
+
+TEST_CASE("Cache does not keep long text", "[cache]")
+{
+    char text[CONFIG_NEX_COMPONENT_CACHE_TEXT_SIZE + 1];
+
+    memset(text, 'a', CONFIG_NEX_COMPONENT_CACHE_TEXT_SIZE);
+    text[CONFIG_NEX_COMPONENT_CACHE_TEXT_SIZE] = '\0';
+
+    nextion_component_cache_init(&cache);
+    nextion_component_cache_store(&cache, NEX_COMPONENT_CACHE_TEXT, "t0", "txt", 0, "abc");
+    nextion_component_cache_store(&cache, NEX_COMPONENT_CACHE_TEXT, "t0", "txt", 0, text);
+
+    CHECK_FALSE(nextion_component_cache_contains(&cache, NEX_COMPONENT_CACHE_TEXT, "t0", "txt", 0, text));
+    CHECK_FALSE(nextion_component_cache_contains(&cache, NEX_COMPONENT_CACHE_TEXT, "t0", "txt", 0, "abc"));
+}
+
+TEST_CASE("Cache keeps visibility apart from properties", "[cache]")
+{
+    nextion_component_cache_init(&cache);
+    nextion_component_cache_store(&cache, NEX_COMPONENT_CACHE_VISIBILITY, "b0", NULL, 1, NULL);
+
+    CHECK_TRUE(nextion_component_cache_contains(&cache, NEX_COMPONENT_CACHE_VISIBILITY, "b0", NULL, 1, NULL));
+    CHECK_FALSE(nextion_component_cache_contains(&cache, NEX_COMPONENT_CACHE_NUMBER, "b0", "val", 1, NULL));
+}
+
+TEST_CASE("Cache replaces least recently used", "[cache]")
+{
+    char name[8];
+
+    nextion_component_cache_init(&cache);
+
+    for (int i = 0; i < CONFIG_NEX_COMPONENT_CACHE_SIZE; i++)
+    {
+        snprintf(name, sizeof(name), "n%d", i);
+        nextion_component_cache_store(&cache, NEX_COMPONENT_CACHE_NUMBER, name, "val", i, NULL);
+    }
+
+    // Use the first, so the second is the oldest.
+    nextion_component_cache_contains(&cache, NEX_COMPONENT_CACHE_NUMBER, "n0", "val", 0, NULL);
+    nextion_component_cache_store(&cache, NEX_COMPONENT_CACHE_NUMBER, "x0", "val", 1, NULL);
+
+    SIZET_EQUAL(1, cache.stats.evictions);
+    CHECK_TRUE(nextion_component_cache_contains(&cache, NEX_COMPONENT_CACHE_NUMBER, "n0", "val", 0, NULL));
+    CHECK_TRUE(nextion_component_cache_contains(&cache, NEX_COMPONENT_CACHE_NUMBER, "x0", "val", 1, NULL));
+    CHECK_FALSE(nextion_component_cache_contains(&cache, NEX_COMPONENT_CACHE_NUMBER, "n1", "val", 1, NULL));
+}
+
+TEST_CASE("Cache forgets everything when invalidated", "[cache]")
+{
+    nextion_component_cache_init(&cache);
+    nextion_component_cache_store(&cache, NEX_COMPONENT_CACHE_NUMBER, "n0", "val", 10, NULL);
+    nextion_component_cache_invalidate(&cache);
+
+    CHECK_FALSE(nextion_component_cache_contains(&cache, NEX_COMPONENT_CACHE_NUMBER, "n0", "val", 10, NULL));
+    SIZET_EQUAL(1, cache.stats.invalidations);
+}
+
+TEST_CASE("Cache misses value written on another page", "[cache]")
+{
+    nextion_component_cache_init(&cache);
+    nextion_component_cache_store_page(&cache, "page0");
+    nextion_component_cache_store(&cache, NEX_COMPONENT_CACHE_NUMBER, "n0", "val", 10, NULL);
+    nextion_component_cache_store_page(&cache, "page1");
+
+    CHECK_FALSE(nextion_component_cache_contains(&cache, NEX_COMPONENT_CACHE_NUMBER, "n0", "val", 10, NULL));
+    CHECK_TRUE(nextion_component_cache_contains(&cache, NEX_COMPONENT_CACHE_NUMBER, "page0.n0", "val", 10, NULL));
+}
+
+TEST_CASE("Cache keeps a name and its page form in one entry", "[cache]")
+{
+    nextion_component_cache_init(&cache);
+    nextion_component_cache_store_page(&cache, "page0");
+    nextion_component_cache_store(&cache, NEX_COMPONENT_CACHE_NUMBER, "page0.n0", "val", 10, NULL);
+
+    CHECK_TRUE(nextion_component_cache_contains(&cache, NEX_COMPONENT_CACHE_NUMBER, "n0", "val", 10, NULL));
+
+    nextion_component_cache_store(&cache, NEX_COMPONENT_CACHE_NUMBER, "n0", "val", 11, NULL);
+
+    CHECK_FALSE(nextion_component_cache_contains(&cache, NEX_COMPONENT_CACHE_NUMBER, "page0.n0", "val", 10, NULL));
+}
+
+TEST_CASE("Cache keeps a page by id once the display reports it", "[cache]")
+{
+    nextion_component_cache_init(&cache);
+    nextion_component_cache_store_page(&cache, "page0");
+    nextion_component_cache_store_page_id(&cache, 0);
+    nextion_component_cache_store(&cache, NEX_COMPONENT_CACHE_NUMBER, "page0.n0", "val", 10, NULL);
+
+    CHECK_TRUE(nextion_component_cache_contains_page(&cache, "0"));
+    CHECK_TRUE(nextion_component_cache_contains_page(&cache, "00"));
+    CHECK_TRUE(nextion_component_cache_contains_page(&cache, "page0"));
+    CHECK_FALSE(nextion_component_cache_contains_page(&cache, "1"));
+    CHECK_TRUE(nextion_component_cache_contains(&cache, NEX_COMPONENT_CACHE_NUMBER, "0.n0", "val", 10, NULL));
+    CHECK_TRUE(nextion_component_cache_contains(&cache, NEX_COMPONENT_CACHE_NUMBER, "n0", "val", 10, NULL));
+}
+
+TEST_CASE("Cache ignores a page id reported after invalidation", "[cache]")
+{
+    nextion_component_cache_init(&cache);
+    nextion_component_cache_store_page(&cache, "page1");
+    nextion_component_cache_invalidate(&cache);
+    nextion_component_cache_store_page_id(&cache, 1);
+
+    CHECK_FALSE(nextion_component_cache_contains_page(&cache, "1"));
+}
+
+TEST_CASE("Cache cannot keep ids or values that do not fit", "[cache]")
+{
+    char text[CONFIG_NEX_COMPONENT_CACHE_TEXT_SIZE + 1];
+
+    memset(text, 'a', sizeof(text) - 1);
+    text[sizeof(text) - 1] = '\0';
+
+    nextion_component_cache_init(&cache);
+
+    CHECK_TRUE(nextion_component_cache_can_keep(&cache, NEX_COMPONENT_CACHE_VISIBILITY, "b0", NULL, NULL));
+    CHECK_TRUE(nextion_component_cache_can_keep(&cache, NEX_COMPONENT_CACHE_TEXT, "page0.t0", "txt", "Hello"));
+    CHECK_FALSE(nextion_component_cache_can_keep(&cache, NEX_COMPONENT_CACHE_NUMBER, "b[3]", "val", NULL));
+    CHECK_FALSE(nextion_component_cache_can_keep(&cache, NEX_COMPONENT_CACHE_VISIBILITY, "3", NULL, NULL));
+    CHECK_FALSE(nextion_component_cache_can_keep(&cache, NEX_COMPONENT_CACHE_TEXT, "t0", "txt", text));
+}
+
+TEST_CASE("Cache forgets names written through an id", "[cache]")
+{
+    nextion_component_cache_init(&cache);
+    nextion_component_cache_store(&cache, NEX_COMPONENT_CACHE_NUMBER, "n0", "val", 10, NULL);
+    nextion_component_cache_store(&cache, NEX_COMPONENT_CACHE_VISIBILITY, "b0", NULL, 1, NULL);
+    nextion_component_cache_store(&cache, NEX_COMPONENT_CACHE_NUMBER, "b[3]", "val", 10, NULL);
+    nextion_component_cache_store(&cache, NEX_COMPONENT_CACHE_VISIBILITY, "3", NULL, 1, NULL);
+
+    CHECK_FALSE(nextion_component_cache_contains(&cache, NEX_COMPONENT_CACHE_NUMBER, "n0", "val", 10, NULL));
+    CHECK_FALSE(nextion_component_cache_contains(&cache, NEX_COMPONENT_CACHE_NUMBER, "b[3]", "val", 10, NULL));
+    CHECK_FALSE(nextion_component_cache_contains(&cache, NEX_COMPONENT_CACHE_VISIBILITY, "b0", NULL, 1, NULL));
+}
@@ -1,4 +1,6 @@
+#include <stdio.h>
 #include "esp32_driver_nextion/component.h"
+#include "esp32_driver_nextion/page.h"
 #include "common_infra_test.h"
 
 TEST_CASE("Refresh component", "[component]")
@@ -171,4 +173,157 @@ TEST_CASE("Set component property number", "[component]")
 
     CHECK_NEX_OK(code);
     LONGS_EQUAL(100, number);
-}
\ No newline at end of file
+}
+TEST_CASE("Set same component value again is not sent", "[component]")
+{
+    nextion_component_cache_stats_t before;
+    nextion_component_cache_stats_t after;
+
+    nextion_component_set_value(handle, "x0", 200);
+    nextion_component_cache_get_stats(handle, &before);
+
+    nex_err_t code = nextion_component_set_value(handle, "x0", 200);
+
+    nextion_component_cache_get_stats(handle, &after);
+
+    CHECK_NEX_OK(code);
+    SIZET_EQUAL(before.hits + 1, after.hits);
+    SIZET_EQUAL(before.misses, after.misses);
+}
+
+TEST_CASE("Component cache is cleared on page change", "[component]")
+{
+    nextion_component_cache_stats_t before;
+    nextion_component_cache_stats_t after;
+
+    nextion_component_set_value(handle, "x0", 300);
+    nextion_page_set(handle, "0");
+    nextion_component_cache_get_stats(handle, &before);
+
+    nex_err_t code = nextion_component_set_value(handle, "x0", 300);
+
+    nextion_component_cache_get_stats(handle, &after);
+
+    CHECK_NEX_OK(code);
+    SIZET_EQUAL(before.hits, after.hits);
+    SIZET_EQUAL(before.misses + 1, after.misses);
+}
+
+TEST_CASE("Bind component", "[component]")
+{
+    nextion_component_t component;
+
+    nex_err_t code = nextion_component_bind(handle, NULL, "x0", &component);
+
+    CHECK_NEX_OK(code);
+    STRCMP_EQUAL("x0", component.name);
+    STRCMP_EQUAL("x0", component.reference);
+}
+
+TEST_CASE("Component bound to a page is reached from another page", "[component]")
+{
+    nextion_component_t component;
+    int32_t number = 0;
+
+    CHECK_NEX_OK(nextion_component_bind(handle, "page0", "x0", &component));
+    STRCMP_EQUAL("page0.x0", component.reference);
+
+    nextion_page_set(handle, "1");
+
+    nex_err_t code = nextion_component_bound_set_value(handle, &component, 190);
+
+    nextion_component_bound_get_value(handle, &component, &number);
+    nextion_page_set(handle, "0");
+
+    CHECK_NEX_OK(code);
+    LONGS_EQUAL(190, number);
+}
+
+TEST_CASE("Cannot set visibility of a component bound to a page", "[component]")
+{
+    nextion_component_t component;
+
+    CHECK_NEX_OK(nextion_component_bind(handle, "page0", "x0", &component));
+
+    nex_err_t code = nextion_component_bound_set_visibility(handle, &component, true);
+
+    CHECK_TRUE(code != NEX_OK);
+}
+
+TEST_CASE("Cannot bind invalid component", "[component]")
+{
+    nextion_component_t component;
+
+    nex_err_t code = nextion_component_bind(handle, NULL, "x99", &component);
+
+    CHECK_TRUE(code != NEX_OK);
+}
+
+TEST_CASE("Set and get bound component value", "[component]")
+{
+    nextion_component_t component;
+    int32_t number = 0;
+
+    nextion_component_bind(handle, NULL, "x0", &component);
+
+    nex_err_t code = nextion_component_bound_set_value(handle, &component, 175);
+
+    nextion_component_bound_get_value(handle, &component, &number);
+
+    CHECK_NEX_OK(code);
+    LONGS_EQUAL(175, number);
+}
+
+TEST_CASE("Bound and named component share the cache", "[component]")
+{
+    nextion_component_t component;
+    nextion_component_cache_stats_t before;
+    nextion_component_cache_stats_t after;
+
+    nextion_component_bind(handle, NULL, "x0", &component);
+    nextion_component_set_value(handle, "x0", 180);
+    nextion_component_cache_get_stats(handle, &before);
+
+    nex_err_t code = nextion_component_bound_set_value(handle, &component, 180);
+
+    nextion_component_cache_get_stats(handle, &after);
+
+    CHECK_NEX_OK(code);
+    SIZET_EQUAL(before.hits + 1, after.hits);
+}
+
+TEST_CASE("Component written by id is sent again by name", "[component]")
+{
+    nextion_component_t component;
+    char reference[8];
+    int32_t number = 0;
+
+    CHECK_NEX_OK(nextion_component_bind(handle, NULL, "x0", &component));
+    snprintf(reference, sizeof(reference), "b[%d]", component.id);
+
+    nextion_component_set_value(handle, "x0", 220);
+    nextion_component_set_value(handle, reference, 230);
+
+    nex_err_t code = nextion_component_set_value(handle, "x0", 220);
+
+    nextion_component_get_value(handle, "x0", &number);
+
+    CHECK_NEX_OK(code);
+    LONGS_EQUAL(220, number);
+}
+
+TEST_CASE("Set and get bound component text", "[component]")
+{
+    nextion_component_t component;
+    char buffer[10];
+    size_t length = 9;
+
+    nextion_component_bind(handle, NULL, "b0", &component);
+
+    nex_err_t code = nextion_component_bound_set_text(handle, &component, "bound");
+
+    nextion_component_bound_get_text(handle, &component, buffer, &length);
+
+    CHECK_NEX_OK(code);
+    STRCMP_EQUAL("bound", buffer);
+}
@@ -0,0 +1,139 @@
+#include "esp32_driver_nextion/display_list.h"
+#include "common_infra_test.h"
+
+/**
+ * @brief Fill of the whole first row, in flash.
+ */
+static const uint8_t STORED_LIST[] = {
+    0x01, 0x00, 0x00,                                                 // cls 0
+    0x02, 0x00, 0x00, 0x00, 0x00, 0x40, 0x01, 0x14, 0x00, 0x1F, 0x00, // fill 0,0,320,20,31
+};
+
+static area_t display_list_test_area(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2)
+{
+    area_t area = {.upper_left = {.x = x1, .y = y1}, .bottom_right = {.x = x2, .y = y2}};
+
+    return area;
+}
+
+TEST_CASE("Display list merges abutting fills", "[display_list]")
+{
+    uint8_t buffer[64];
+    nextion_display_list_t list;
+
+    CHECK_NEX_OK(nextion_display_list_init(&list, buffer, sizeof(buffer)));
+
+    for (uint16_t x = 0; x < 100; x += 10)
+    {
+        CHECK_NEX_OK(nextion_display_list_fill_area(&list, display_list_test_area(x, 0, x + 10, 10), RGB565_COLOR_GREEN));
+    }
+
+    // A second row under the first.
+    CHECK_NEX_OK(nextion_display_list_fill_area(&list, display_list_test_area(0, 10, 100, 20), RGB565_COLOR_GREEN));
+
+    SIZET_EQUAL(11, list.length);
+
+    // Another color is kept apart.
+    CHECK_NEX_OK(nextion_display_list_fill_area(&list, display_list_test_area(0, 20, 100, 30), RGB565_COLOR_RED));
+
+    SIZET_EQUAL(22, list.length);
+}
+
+TEST_CASE("Display list drops what is covered or repeated", "[display_list]")
+{
+    uint8_t buffer[64];
+    nextion_display_list_t list;
+    const point_t center = {.x = 50, .y = 50};
+
+    CHECK_NEX_OK(nextion_display_list_init(&list, buffer, sizeof(buffer)));
+
+    CHECK_NEX_OK(nextion_display_list_circle(&list, center, 10, RGB565_COLOR_RED));
+    CHECK_NEX_OK(nextion_display_list_fill_screen(&list, RGB565_COLOR_BLACK));
+    CHECK_NEX_OK(nextion_display_list_fill_screen(&list, RGB565_COLOR_WHITE));
+
+    SIZET_EQUAL(3, list.length);
+
+    CHECK_NEX_OK(nextion_display_list_circle(&list, center, 10, RGB565_COLOR_RED));
+    CHECK_NEX_OK(nextion_display_list_circle(&list, center, 10, RGB565_COLOR_RED));
+
+    SIZET_EQUAL(12, list.length);
+
+    CHECK_NEX_OK(nextion_display_list_fill_area(&list, display_list_test_area(10, 10, 20, 20), RGB565_COLOR_RED));
+    CHECK_NEX_OK(nextion_display_list_fill_area(&list, display_list_test_area(0, 0, 30, 30), RGB565_COLOR_BLUE));
+
+    SIZET_EQUAL(23, list.length);
+}
+
+TEST_CASE("Display list keeps repeated text", "[display_list]")
+{
+    uint8_t buffer[64];
+    nextion_display_list_t list;
+    const font_t font = {.color = RGB565_COLOR_WHITE, .id = 0};
+    const background_t background = {.fill_mode = BACKG_FILL_NONE};
+    const text_alignment_t alignment = {.horizontal = HORZ_ALIGN_CENTER, .vertical = VERT_ALIGN_CENTER};
+    const area_t area = display_list_test_area(0, 0, 100, 30);
+
+    CHECK_NEX_OK(nextion_display_list_init(&list, buffer, sizeof(buffer)));
+
+    CHECK_NEX_OK(nextion_display_list_text(&list, area, font, background, alignment, "Hi"));
+    CHECK_NEX_OK(nextion_display_list_text(&list, area, font, background, alignment, "Hi"));
+
+    SIZET_EQUAL(42, list.length);
+}
+
+TEST_CASE("Display list refuses what does not fit", "[display_list]")
+{
+    uint8_t buffer[16];
+    nextion_display_list_t list;
+    const point_t origin = {.x = 0, .y = 0};
+
+    CHECK_NEX_OK(nextion_display_list_init(&list, buffer, sizeof(buffer)));
+
+    CHECK_NEX_OK(nextion_display_list_picture(&list, 0, origin));
+    CHECK_NEX_OK(nextion_display_list_picture(&list, 1, origin));
+    CHECK_NEX_FAIL(nextion_display_list_picture(&list, 2, origin));
+
+    SIZET_EQUAL(12, list.length);
+}
+
+TEST_CASE("Display list replays in a single batch", "[display_list]")
+{
+    uint8_t buffer[128];
+    nextion_display_list_t list;
+    nextion_stats_t before;
+    nextion_stats_t after;
+    const point_t center = {.x = 100, .y = 100};
+    const font_t font = {.color = RGB565_COLOR_WHITE, .id = 0};
+    const background_t background = {.fill_mode = BACKG_FILL_COLOR, .color = RGB565_COLOR_BLACK};
+    const text_alignment_t alignment = {.horizontal = HORZ_ALIGN_LEFT, .vertical = VERT_ALIGN_TOP};
+
+    CHECK_NEX_OK(nextion_display_list_init(&list, buffer, sizeof(buffer)));
+
+    CHECK_NEX_OK(nextion_display_list_fill_screen(&list, RGB565_COLOR_BLACK));
+    CHECK_NEX_OK(nextion_display_list_fill_area(&list, display_list_test_area(0, 0, 50, 10), RGB565_COLOR_GREEN));
+    CHECK_NEX_OK(nextion_display_list_fill_area(&list, display_list_test_area(50, 0, 100, 10), RGB565_COLOR_GREEN));
+    CHECK_NEX_OK(nextion_display_list_line(&list, display_list_test_area(0, 20, 100, 20), RGB565_COLOR_RED));
+    CHECK_NEX_OK(nextion_display_list_rectangle(&list, display_list_test_area(10, 30, 90, 60), RGB565_COLOR_RED));
+    CHECK_NEX_OK(nextion_display_list_fill_circle(&list, center, 10, RGB565_COLOR_BLUE));
+    CHECK_NEX_OK(nextion_display_list_circle(&list, center, 20, RGB565_COLOR_BLUE));
+    CHECK_NEX_OK(nextion_display_list_text(&list, display_list_test_area(0, 70, 100, 90), font, background, alignment, "Replay"));
+
+    CHECK_NEX_OK(nextion_stats_get(handle, &before));
+    CHECK_NEX_OK(nextion_display_list_replay(handle, list.buffer, list.length));
+    CHECK_NEX_OK(nextion_stats_get(handle, &after));
+
+    SIZET_EQUAL(7, after.commands_sent - before.commands_sent);
+}
+
+TEST_CASE("Display list replays from flash", "[display_list]")
+{
+    CHECK_NEX_OK(nextion_display_list_replay(handle, STORED_LIST, sizeof(STORED_LIST)));
+}
+
+TEST_CASE("Cannot replay malformed display list", "[display_list]")
+{
+    const uint8_t unknown[] = {0x7F};
+
+    CHECK_NEX_FAIL(nextion_display_list_replay(handle, unknown, sizeof(unknown)));
+    CHECK_NEX_FAIL(nextion_display_list_replay(handle, STORED_LIST, sizeof(STORED_LIST) - 1));
+}
@@ -0,0 +1,187 @@
+#include <string.h>
+#include "eeprom_cache.h"
+#include "common_infra_test.h"
+
+#if CONFIG_NEX_EEPROM_CACHE_BLOCKS > 0
+TEST_CASE("EEPROM cache reads back written bytes", "[eeprom_cache]")
+{
+    nextion_eeprom_cache_t cache;
+    const uint8_t written[] = {1, 2, 3};
+    uint8_t read[3] = {0};
+
+    nextion_eeprom_cache_init(&cache);
+
+    CHECK_FALSE(nextion_eeprom_cache_read(&cache, 10, read, sizeof(read)));
+    CHECK_TRUE(nextion_eeprom_cache_write(&cache, 10, written, sizeof(written)));
+    CHECK_TRUE(nextion_eeprom_cache_read(&cache, 10, read, sizeof(read)));
+
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(written, read, sizeof(written));
+
+    nextion_eeprom_cache_deinit(&cache);
+}
+
+TEST_CASE("EEPROM cache gets the blocks of unknown bytes", "[eeprom_cache]")
+{
+    nextion_eeprom_cache_t cache;
+    const uint8_t written[4] = {0};
+    uint16_t span_address;
+    size_t span_length;
+
+    nextion_eeprom_cache_init(&cache);
+
+    CHECK_TRUE(nextion_eeprom_cache_missing(&cache, 40, 30, &span_address, &span_length));
+    SIZET_EQUAL(32, span_address);
+    SIZET_EQUAL(64, span_length);
+
+    CHECK_TRUE(nextion_eeprom_cache_write(&cache, 40, written, sizeof(written)));
+    CHECK_FALSE(nextion_eeprom_cache_missing(&cache, 40, 4, &span_address, &span_length));
+
+    nextion_eeprom_cache_deinit(&cache);
+}
+
+TEST_CASE("EEPROM cache fill keeps written bytes", "[eeprom_cache]")
+{
+    nextion_eeprom_cache_t cache;
+    const uint8_t written[] = {9};
+    const uint8_t fetched[] = {1, 2, 3, 4};
+    const uint8_t expected[] = {1, 9, 3, 4};
+    uint8_t read[4] = {0};
+
+    nextion_eeprom_cache_init(&cache);
+
+    CHECK_TRUE(nextion_eeprom_cache_write(&cache, 1, written, sizeof(written)));
+    CHECK_TRUE(nextion_eeprom_cache_fill(&cache, 0, fetched, sizeof(fetched)));
+    CHECK_TRUE(nextion_eeprom_cache_read(&cache, 0, read, sizeof(read)));
+
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, read, sizeof(expected));
+
+    nextion_eeprom_cache_deinit(&cache);
+}
+
+TEST_CASE("EEPROM cache joins writes across known bytes", "[eeprom_cache]")
+{
+    nextion_eeprom_cache_t cache;
+    const uint8_t fetched[64] = {0};
+    const uint8_t written[] = {1, 2};
+    uint16_t address;
+    size_t length;
+
+    nextion_eeprom_cache_init(&cache);
+
+    CHECK_TRUE(nextion_eeprom_cache_fill(&cache, 0, fetched, sizeof(fetched)));
+    CHECK_TRUE(nextion_eeprom_cache_write(&cache, 10, written, sizeof(written)));
+    CHECK_TRUE(nextion_eeprom_cache_write(&cache, 40, written, sizeof(written)));
+
+    CHECK_TRUE(nextion_eeprom_cache_next_run(&cache, 0, 256, &address, &length));
+    SIZET_EQUAL(10, address);
+    SIZET_EQUAL(32, length);
+
+    // Too long to be joined.
+    CHECK_TRUE(nextion_eeprom_cache_next_run(&cache, 0, 16, &address, &length));
+    SIZET_EQUAL(10, address);
+    SIZET_EQUAL(2, length);
+
+    nextion_eeprom_cache_deinit(&cache);
+}
+
+TEST_CASE("EEPROM cache splits writes at unknown bytes", "[eeprom_cache]")
+{
+    nextion_eeprom_cache_t cache;
+    const uint8_t written[] = {1, 2};
+    uint16_t address;
+    size_t length;
+
+    nextion_eeprom_cache_init(&cache);
+
+    CHECK_TRUE(nextion_eeprom_cache_write(&cache, 10, written, sizeof(written)));
+    CHECK_TRUE(nextion_eeprom_cache_write(&cache, 20, written, sizeof(written)));
+
+    CHECK_TRUE(nextion_eeprom_cache_next_run(&cache, 0, 256, &address, &length));
+    SIZET_EQUAL(10, address);
+    SIZET_EQUAL(2, length);
+
+    nextion_eeprom_cache_clean(&cache, address, length);
+
+    CHECK_TRUE(nextion_eeprom_cache_next_run(&cache, 12, 256, &address, &length));
+    SIZET_EQUAL(20, address);
+    SIZET_EQUAL(2, length);
+
+    nextion_eeprom_cache_clean(&cache, address, length);
+
+    CHECK_FALSE(nextion_eeprom_cache_next_run(&cache, 0, 256, &address, &length));
+    SIZET_EQUAL(2, cache.stats.flushes);
+
+    nextion_eeprom_cache_deinit(&cache);
+}
+
+TEST_CASE("EEPROM cache refuses writes when all blocks are dirty", "[eeprom_cache]")
+{
+    nextion_eeprom_cache_t cache;
+    const uint8_t written[] = {1};
+    uint8_t read[1];
+
+    nextion_eeprom_cache_init(&cache);
+
+    for (size_t i = 0; i < CONFIG_NEX_EEPROM_CACHE_BLOCKS; i++)
+    {
+        CHECK_TRUE(nextion_eeprom_cache_write(&cache, (uint16_t)(i * NEX_EEPROM_CACHE_BLOCK_SIZE), written, sizeof(written)));
+    }
+
+    const uint16_t next = CONFIG_NEX_EEPROM_CACHE_BLOCKS * NEX_EEPROM_CACHE_BLOCK_SIZE;
+
+    CHECK_FALSE(nextion_eeprom_cache_write(&cache, next, written, sizeof(written)));
+    CHECK_FALSE(nextion_eeprom_cache_fill(&cache, next, written, sizeof(written)));
+    CHECK_FALSE(nextion_eeprom_cache_read(&cache, next, read, sizeof(read)));
+
+    nextion_eeprom_cache_deinit(&cache);
+}
+
+TEST_CASE("EEPROM cache replaces the oldest clean block", "[eeprom_cache]")
+{
+    nextion_eeprom_cache_t cache;
+    const uint8_t fetched[] = {1};
+    uint8_t read[1];
+
+    nextion_eeprom_cache_init(&cache);
+
+    for (size_t i = 0; i < CONFIG_NEX_EEPROM_CACHE_BLOCKS; i++)
+    {
+        CHECK_TRUE(nextion_eeprom_cache_fill(&cache, (uint16_t)(i * NEX_EEPROM_CACHE_BLOCK_SIZE), fetched, sizeof(fetched)));
+    }
+
+    // Block 0 is now the most recently used.
+    CHECK_TRUE(nextion_eeprom_cache_write(&cache, 0, fetched, sizeof(fetched)));
+    nextion_eeprom_cache_clean(&cache, 0, 1);
+
+    const uint16_t next = CONFIG_NEX_EEPROM_CACHE_BLOCKS * NEX_EEPROM_CACHE_BLOCK_SIZE;
+
+    CHECK_TRUE(nextion_eeprom_cache_fill(&cache, next, fetched, sizeof(fetched)));
+    SIZET_EQUAL(1, cache.stats.evictions);
+
+    CHECK_TRUE(nextion_eeprom_cache_read(&cache, 0, read, sizeof(read)));
+    CHECK_FALSE(nextion_eeprom_cache_read(&cache, NEX_EEPROM_CACHE_BLOCK_SIZE, read, sizeof(read)));
+
+    nextion_eeprom_cache_deinit(&cache);
+}
+
+TEST_CASE("EEPROM cache forgets discarded writes", "[eeprom_cache]")
+{
+    nextion_eeprom_cache_t cache;
+    const uint8_t written[] = {1, 2, 3};
+    uint16_t address;
+    size_t length;
+    TickType_t wait;
+
+    nextion_eeprom_cache_init(&cache);
+
+    CHECK_TRUE(nextion_eeprom_cache_write(&cache, 5, written, sizeof(written)));
+    CHECK_TRUE(nextion_eeprom_cache_flush_wait(&cache, &wait));
+
+    nextion_eeprom_cache_discard(&cache, 5, sizeof(written));
+
+    CHECK_FALSE(nextion_eeprom_cache_next_run(&cache, 0, 256, &address, &length));
+    CHECK_FALSE(nextion_eeprom_cache_flush_wait(&cache, &wait));
+
+    nextion_eeprom_cache_deinit(&cache);
+}
+#endif
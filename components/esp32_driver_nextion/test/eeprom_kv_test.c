@@ -0,0 +1,238 @@
+#include <string.h>
+#include "esp32_driver_nextion/eeprom.h"
+#include "esp32_driver_nextion/eeprom_kv.h"
+#include "common_infra_test.h"
+
+#define KV_ADDRESS 512
+#define KV_SIZE 128
+
+/**
+ * @brief Fill an area with erased bytes.
+ */
+static void kv_test_wipe(uint16_t address, size_t size)
+{
+    uint8_t erased[KV_SIZE];
+
+    memset(erased, 0xFF, sizeof(erased));
+
+    CHECK_NEX_OK(nextion_eeprom_stream_begin(handle, address, size));
+    CHECK_NEX_OK(nextion_eeprom_stream_write_buffer(handle, erased, size));
+    CHECK_NEX_OK(nextion_eeprom_stream_end(handle));
+}
+
+/**
+ * @brief Mount the test area again, as after a restart.
+ */
+static nextion_eeprom_kv_t *kv_test_remount(nextion_eeprom_kv_t *kv)
+{
+    CHECK_TRUE(nextion_eeprom_kv_unmount(kv));
+
+    kv = nextion_eeprom_kv_mount(handle, KV_ADDRESS, KV_SIZE);
+
+    CHECK_NOT_NULL(kv);
+
+    return kv;
+}
+
+TEST_CASE("KV store mounts empty", "[eeprom_kv]")
+{
+    kv_test_wipe(KV_ADDRESS, KV_SIZE);
+
+    nextion_eeprom_kv_t *kv = nextion_eeprom_kv_mount(handle, KV_ADDRESS, KV_SIZE);
+    uint8_t value;
+
+    CHECK_NOT_NULL(kv);
+    SIZET_EQUAL(0, nextion_eeprom_kv_count(kv));
+    CHECK_NEX_FAIL(nextion_eeprom_kv_get(kv, "missing", &value, sizeof(value), NULL));
+
+    nextion_eeprom_kv_unmount(kv);
+}
+
+TEST_CASE("Cannot mount KV store past the EEPROM end", "[eeprom_kv]")
+{
+    CHECK_NULL(nextion_eeprom_kv_mount(handle, NEX_DVC_EEPROM_SIZE - KV_SIZE + 2, KV_SIZE));
+    CHECK_NULL(nextion_eeprom_kv_mount(handle, 0, NEX_EEPROM_KV_MIN_SIZE - 2));
+    CHECK_NULL(nextion_eeprom_kv_mount(handle, 0, NEX_EEPROM_KV_MIN_SIZE + 1));
+}
+
+TEST_CASE("KV store keeps values across mounts", "[eeprom_kv]")
+{
+    kv_test_wipe(KV_ADDRESS, KV_SIZE);
+
+    nextion_eeprom_kv_t *kv = nextion_eeprom_kv_mount(handle, KV_ADDRESS, KV_SIZE);
+    const int32_t exposure = -3;
+    int32_t value = 0;
+    size_t length = 0;
+
+    CHECK_NEX_OK(nextion_eeprom_kv_set(kv, "exposure", &exposure, sizeof(exposure)));
+    CHECK_NEX_OK(nextion_eeprom_kv_set(kv, "iso", "800", 4));
+
+    kv = kv_test_remount(kv);
+
+    SIZET_EQUAL(2, nextion_eeprom_kv_count(kv));
+    CHECK_NEX_OK(nextion_eeprom_kv_get(kv, "exposure", &value, sizeof(value), &length));
+    LONGS_EQUAL(exposure, value);
+    SIZET_EQUAL(sizeof(exposure), length);
+
+    char text[8];
+
+    CHECK_NEX_OK(nextion_eeprom_kv_get(kv, "iso", text, sizeof(text), NULL));
+    STRCMP_EQUAL("800", text);
+
+    nextion_eeprom_kv_unmount(kv);
+}
+
+TEST_CASE("KV store keeps the last value set", "[eeprom_kv]")
+{
+    kv_test_wipe(KV_ADDRESS, KV_SIZE);
+
+    nextion_eeprom_kv_t *kv = nextion_eeprom_kv_mount(handle, KV_ADDRESS, KV_SIZE);
+    uint8_t value;
+
+    for (uint8_t i = 0; i < 5; i++)
+    {
+        CHECK_NEX_OK(nextion_eeprom_kv_set(kv, "mode", &i, sizeof(i)));
+    }
+
+    kv = kv_test_remount(kv);
+
+    SIZET_EQUAL(1, nextion_eeprom_kv_count(kv));
+    CHECK_NEX_OK(nextion_eeprom_kv_get(kv, "mode", &value, sizeof(value), NULL));
+    LONGS_EQUAL(4, value);
+
+    nextion_eeprom_kv_unmount(kv);
+}
+
+TEST_CASE("KV store forgets erased keys", "[eeprom_kv]")
+{
+    kv_test_wipe(KV_ADDRESS, KV_SIZE);
+
+    nextion_eeprom_kv_t *kv = nextion_eeprom_kv_mount(handle, KV_ADDRESS, KV_SIZE);
+    const uint8_t one = 1;
+    uint8_t value;
+
+    CHECK_NEX_OK(nextion_eeprom_kv_set(kv, "a", &one, 1));
+    CHECK_NEX_OK(nextion_eeprom_kv_set(kv, "b", &one, 1));
+    CHECK_NEX_OK(nextion_eeprom_kv_erase(kv, "a"));
+    CHECK_NEX_OK(nextion_eeprom_kv_erase(kv, "missing"));
+
+    kv = kv_test_remount(kv);
+
+    SIZET_EQUAL(1, nextion_eeprom_kv_count(kv));
+    CHECK_NEX_FAIL(nextion_eeprom_kv_get(kv, "a", &value, sizeof(value), NULL));
+    CHECK_NEX_OK(nextion_eeprom_kv_get(kv, "b", &value, sizeof(value), NULL));
+
+    nextion_eeprom_kv_unmount(kv);
+}
+
+TEST_CASE("KV store compacts when the log is full", "[eeprom_kv]")
+{
+    kv_test_wipe(KV_ADDRESS, KV_SIZE);
+
+    nextion_eeprom_kv_t *kv = nextion_eeprom_kv_mount(handle, KV_ADDRESS, KV_SIZE);
+    const uint8_t fixed = 42;
+    uint16_t value;
+
+    CHECK_NEX_OK(nextion_eeprom_kv_set(kv, "fixed", &fixed, sizeof(fixed)));
+
+    // Far more records than a half holds.
+    for (uint16_t i = 0; i < 40; i++)
+    {
+        CHECK_NEX_OK(nextion_eeprom_kv_set(kv, "counter", &i, sizeof(i)));
+    }
+
+    kv = kv_test_remount(kv);
+
+    SIZET_EQUAL(2, nextion_eeprom_kv_count(kv));
+    CHECK_NEX_OK(nextion_eeprom_kv_get(kv, "counter", &value, sizeof(value), NULL));
+    LONGS_EQUAL(39, value);
+    CHECK_NEX_OK(nextion_eeprom_kv_get(kv, "fixed", &value, 1, NULL));
+    LONGS_EQUAL(fixed, (uint8_t)value);
+
+    nextion_eeprom_kv_unmount(kv);
+}
+
+TEST_CASE("KV store ignores an interrupted append", "[eeprom_kv]")
+{
+    kv_test_wipe(KV_ADDRESS, KV_SIZE);
+
+    nextion_eeprom_kv_t *kv = nextion_eeprom_kv_mount(handle, KV_ADDRESS, KV_SIZE);
+    const uint8_t one = 1;
+    const uint8_t two = 2;
+    uint8_t value;
+
+    CHECK_NEX_OK(nextion_eeprom_kv_set(kv, "a", &one, 1));
+
+    // Half a record after the first one: header, then "a" with one byte.
+    const uint8_t torn[] = {0x01, 0x01, 'a'};
+    const uint16_t tail = KV_ADDRESS + 6 + 1 + 1 + 4;
+
+    CHECK_NEX_OK(nextion_eeprom_stream_begin(handle, tail, sizeof(torn)));
+    CHECK_NEX_OK(nextion_eeprom_stream_write_buffer(handle, torn, sizeof(torn)));
+    CHECK_NEX_OK(nextion_eeprom_stream_end(handle));
+
+    kv = kv_test_remount(kv);
+
+    CHECK_NEX_OK(nextion_eeprom_kv_get(kv, "a", &value, sizeof(value), NULL));
+    LONGS_EQUAL(1, value);
+
+    CHECK_NEX_OK(nextion_eeprom_kv_set(kv, "a", &two, 1));
+
+    kv = kv_test_remount(kv);
+
+    CHECK_NEX_OK(nextion_eeprom_kv_get(kv, "a", &value, sizeof(value), NULL));
+    LONGS_EQUAL(2, value);
+
+    nextion_eeprom_kv_unmount(kv);
+}
+
+TEST_CASE("KV store lookups and unchanged values send nothing", "[eeprom_kv]")
+{
+    kv_test_wipe(KV_ADDRESS, KV_SIZE);
+
+    nextion_eeprom_kv_t *kv = nextion_eeprom_kv_mount(handle, KV_ADDRESS, KV_SIZE);
+    const uint8_t one = 1;
+    nextion_stats_t before;
+    nextion_stats_t after;
+    uint8_t value;
+
+    CHECK_NEX_OK(nextion_eeprom_kv_set(kv, "a", &one, 1));
+    CHECK_NEX_OK(nextion_stats_get(handle, &before));
+
+    for (int i = 0; i < 10; i++)
+    {
+        CHECK_NEX_OK(nextion_eeprom_kv_get(kv, "a", &value, sizeof(value), NULL));
+    }
+
+    CHECK_NEX_OK(nextion_eeprom_kv_set(kv, "a", &one, 1));
+    CHECK_NEX_OK(nextion_stats_get(handle, &after));
+
+    SIZET_EQUAL(before.commands_sent, after.commands_sent);
+
+    nextion_eeprom_kv_unmount(kv);
+}
+
+TEST_CASE("KV store refuses what does not fit", "[eeprom_kv]")
+{
+    kv_test_wipe(KV_ADDRESS, KV_SIZE);
+
+    nextion_eeprom_kv_t *kv = nextion_eeprom_kv_mount(handle, KV_ADDRESS, KV_SIZE);
+    uint8_t big[NEX_EEPROM_KV_MAX_VALUE_LENGTH + 1] = {0};
+    uint8_t small[2];
+
+    CHECK_NEX_FAIL(nextion_eeprom_kv_set(kv, "big", big, sizeof(big)));
+    CHECK_NEX_FAIL(nextion_eeprom_kv_set(kv, "a_key_that_is_too_long", big, 1));
+    CHECK_NEX_FAIL(nextion_eeprom_kv_set(kv, "", big, 1));
+
+    // Two values of the largest size do not fit a 64 bytes half.
+    CHECK_NEX_OK(nextion_eeprom_kv_set(kv, "first", big, 40));
+    CHECK_NEX_FAIL(nextion_eeprom_kv_set(kv, "second", big, 40));
+
+    CHECK_NEX_FAIL(nextion_eeprom_kv_get(kv, "first", small, sizeof(small), NULL));
+
+    kv = kv_test_remount(kv);
+
+    SIZET_EQUAL(1, nextion_eeprom_kv_count(kv));
+
+    nextion_eeprom_kv_unmount(kv);
+}
@@ -1,3 +1,5 @@
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 #include "esp32_driver_nextion/eeprom.h"
 #include "common_infra_test.h"
 
@@ -6,6 +8,7 @@ TEST_CASE("Write text", "[eeprom]")
     nex_err_t result = nextion_eeprom_write_text(handle, 0, "text", 4);
 
     CHECK_NEX_OK(result);
+    CHECK_NEX_OK(nextion_eeprom_flush(handle));
 }
 
 TEST_CASE("Write number", "[eeprom]")
@@ -13,6 +16,7 @@ TEST_CASE("Write number", "[eeprom]")
     nex_err_t result = nextion_eeprom_write_number(handle, 20, 18);
 
     CHECK_NEX_OK(result);
+    CHECK_NEX_OK(nextion_eeprom_flush(handle));
 }
 
 TEST_CASE("Read text", "[eeprom]")
@@ -26,6 +30,7 @@ TEST_CASE("Read text", "[eeprom]")
 
     CHECK_NEX_OK(result);
     STRCMP_EQUAL(text, returned_text);
+    CHECK_NEX_OK(nextion_eeprom_flush(handle));
 }
 
 TEST_CASE("Read number", "[eeprom]")
@@ -39,6 +44,7 @@ TEST_CASE("Read number", "[eeprom]")
 
     CHECK_NEX_OK(result);
     LONGS_EQUAL(number, returned_number);
+    CHECK_NEX_OK(nextion_eeprom_flush(handle));
 }
 
 TEST_CASE("Stream works", "[eeprom]")
@@ -64,6 +70,37 @@ TEST_CASE("Stream works", "[eeprom]")
     }
 }
 
+TEST_CASE("Stream buffer works", "[eeprom]")
+{
+    uint8_t values[50];
+    uint8_t read[50] = {0};
+
+    for (int i = 0; i < 50; i++)
+    {
+        values[i] = i;
+    }
+
+    if (nextion_eeprom_stream_begin(handle, 0, 50) != NEX_OK)
+    {
+        FAIL_TEST("Could not start streaming");
+    }
+
+    if (nextion_eeprom_stream_write_buffer(handle, values, 50) == NEX_FAIL)
+    {
+        nextion_eeprom_stream_end(handle);
+
+        FAIL_TEST("Could not write values to stream");
+    }
+
+    if (nextion_eeprom_stream_end(handle) == NEX_FAIL)
+    {
+        FAIL_TEST("Could not end stream");
+    }
+
+    CHECK_NEX_OK(nextion_eeprom_read_bytes(handle, 0, read, 50));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(values, read, 50);
+}
+
 TEST_CASE("Cannot start stream with invalid address", "[eeprom]")
 {
     nex_err_t code = nextion_eeprom_stream_begin(handle, NEX_DVC_EEPROM_MAX_ADDRESS + 1, 0);
@@ -90,4 +127,117 @@ TEST_CASE("Cannot end unstarted stream", "[eeprom]")
     nex_err_t code = nextion_eeprom_stream_end(handle);
 
     CHECK_NEX_FAIL(code);
-}
\ No newline at end of file
+}
+
+TEST_CASE("Flush with nothing written", "[eeprom]")
+{
+    CHECK_NEX_OK(nextion_eeprom_flush(handle));
+}
+
+#if CONFIG_NEX_EEPROM_CACHE_BLOCKS > 0
+TEST_CASE("Cached read sends nothing", "[eeprom]")
+{
+    nextion_eeprom_cache_stats_t before;
+    nextion_eeprom_cache_stats_t after;
+    int32_t number;
+
+    CHECK_NEX_OK(nextion_eeprom_cache_clear(handle));
+    CHECK_NEX_OK(nextion_eeprom_read_number(handle, 100, &number));
+    CHECK_NEX_OK(nextion_eeprom_cache_get_stats(handle, &before));
+
+    // Same block.
+    CHECK_NEX_OK(nextion_eeprom_read_number(handle, 104, &number));
+    CHECK_NEX_OK(nextion_eeprom_cache_get_stats(handle, &after));
+
+    SIZET_EQUAL(before.fetches, after.fetches);
+    SIZET_EQUAL(before.hits + 1, after.hits);
+}
+
+TEST_CASE("Cached write is read back before flushing", "[eeprom]")
+{
+    int32_t number = 0;
+
+    CHECK_NEX_OK(nextion_eeprom_write_number(handle, 132, -5));
+    CHECK_NEX_OK(nextion_eeprom_read_number(handle, 132, &number));
+    LONGS_EQUAL(-5, number);
+
+    CHECK_NEX_OK(nextion_eeprom_flush(handle));
+}
+
+TEST_CASE("Flush joins nearby writes in one stream", "[eeprom]")
+{
+    nextion_eeprom_cache_stats_t before;
+    nextion_eeprom_cache_stats_t after;
+    int32_t number;
+
+    CHECK_NEX_OK(nextion_eeprom_cache_clear(handle));
+    CHECK_NEX_OK(nextion_eeprom_read_number(handle, 300, &number));
+    CHECK_NEX_OK(nextion_eeprom_write_number(handle, 300, 1));
+    CHECK_NEX_OK(nextion_eeprom_write_number(handle, 310, 2));
+    CHECK_NEX_OK(nextion_eeprom_cache_get_stats(handle, &before));
+    CHECK_NEX_OK(nextion_eeprom_flush(handle));
+    CHECK_NEX_OK(nextion_eeprom_cache_get_stats(handle, &after));
+
+    SIZET_EQUAL(before.flushes + 1, after.flushes);
+
+    // Read from the device.
+    CHECK_NEX_OK(nextion_eeprom_cache_clear(handle));
+    CHECK_NEX_OK(nextion_eeprom_read_number(handle, 300, &number));
+    LONGS_EQUAL(1, number);
+    CHECK_NEX_OK(nextion_eeprom_read_number(handle, 310, &number));
+    LONGS_EQUAL(2, number);
+}
+
+TEST_CASE("Flush writes distant ranges", "[eeprom]")
+{
+    int32_t number;
+
+    CHECK_NEX_OK(nextion_eeprom_write_number(handle, 400, 4));
+    CHECK_NEX_OK(nextion_eeprom_write_number(handle, 900, 9));
+    CHECK_NEX_OK(nextion_eeprom_flush(handle));
+
+    CHECK_NEX_OK(nextion_eeprom_cache_clear(handle));
+    CHECK_NEX_OK(nextion_eeprom_read_number(handle, 400, &number));
+    LONGS_EQUAL(4, number);
+    CHECK_NEX_OK(nextion_eeprom_read_number(handle, 900, &number));
+    LONGS_EQUAL(9, number);
+}
+
+TEST_CASE("Cache flushes by itself", "[eeprom]")
+{
+    nextion_eeprom_cache_stats_t before;
+    nextion_eeprom_cache_stats_t after;
+
+    CHECK_NEX_OK(nextion_eeprom_cache_get_stats(handle, &before));
+    CHECK_NEX_OK(nextion_eeprom_write_number(handle, 500, 77));
+
+    for (int i = 0; i < 20; i++)
+    {
+        vTaskDelay(pdMS_TO_TICKS(CONFIG_NEX_EEPROM_CACHE_FLUSH_DELAY_MS / 4));
+
+        CHECK_NEX_OK(nextion_eeprom_cache_get_stats(handle, &after));
+
+        if (after.flushes > before.flushes)
+        {
+            return;
+        }
+    }
+
+    FAIL_TEST("Cache was not flushed");
+}
+
+TEST_CASE("Stream replaces cached bytes", "[eeprom]")
+{
+    const uint8_t values[4] = {1, 0, 0, 0};
+    int32_t number;
+
+    CHECK_NEX_OK(nextion_eeprom_write_number(handle, 600, 50));
+    CHECK_NEX_OK(nextion_eeprom_stream_begin(handle, 600, 4));
+    CHECK_NEX_OK(nextion_eeprom_stream_write_buffer(handle, values, 4));
+    CHECK_NEX_OK(nextion_eeprom_stream_end(handle));
+    CHECK_NEX_OK(nextion_eeprom_flush(handle));
+
+    CHECK_NEX_OK(nextion_eeprom_read_number(handle, 600, &number));
+    LONGS_EQUAL(1, number);
+}
+#endif
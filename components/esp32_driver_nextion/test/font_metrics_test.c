@@ -0,0 +1,158 @@
+#include <string.h>
+#include "esp32_driver_nextion/font_metrics.h"
+#include "common_infra_test.h"
+
+/**
+ * @brief Font of "A", "B" and "D", 16 pixels high, declaring "A" to "Z".
+ */
+static const uint8_t SMALL_ZI[] = {
+    0x04, 0xFF, 0x00, 0x0A, 0x03, 0x00, 0x00, 0x10, 0x00, 0x00, 'A', 'Z', 0x03, 0x00, 0x00, 0x00,
+    0x06, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x2C, 0x00, 0x00, 0x00, 0xFF, 0x00, 0x01, 0x01,
+    0x01, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 'a', 'b',
+    'A', 0x00, 0x05, 0x00, 0x00, 0x1E, 0x00, 0x00, 0x00, 0x00, // code, width, kerning, offset, length
+    'B', 0x00, 0x06, 0x00, 0x00, 0x1E, 0x00, 0x00, 0x00, 0x00,
+    'D', 0x00, 0x07, 0x00, 0x00, 0x1E, 0x00, 0x00, 0x00, 0x00};
+
+static area_t font_metrics_test_area(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2)
+{
+    area_t area = {.upper_left = {.x = x1, .y = y1}, .bottom_right = {.x = x2, .y = y2}};
+
+    return area;
+}
+
+#define CHECK_AREA(x1, y1, x2, y2, area)         \
+    do                                           \
+    {                                            \
+        area_t _area = (area);                   \
+        LONGS_EQUAL((x1), _area.upper_left.x);   \
+        LONGS_EQUAL((y1), _area.upper_left.y);   \
+        LONGS_EQUAL((x2), _area.bottom_right.x); \
+        LONGS_EQUAL((y2), _area.bottom_right.y); \
+    } while (0)
+
+TEST_CASE("Parse font file", "[font_metrics]")
+{
+    uint8_t widths[NEX_FONT_METRICS_MAX_CHARACTERS];
+    nextion_font_metrics_t metrics;
+
+    CHECK_NEX_OK(nextion_font_metrics_parse(SMALL_ZI, sizeof(SMALL_ZI), widths, sizeof(widths), &metrics));
+
+    LONGS_EQUAL(16, metrics.height);
+    LONGS_EQUAL('A', metrics.first);
+    // Up to "D", the last character it has.
+    LONGS_EQUAL(4, metrics.count);
+
+    LONGS_EQUAL(18, nextion_font_metrics_text_width(&metrics, "ABD"));
+    // "C" and "Z" are missing.
+    LONGS_EQUAL(5, nextion_font_metrics_text_width(&metrics, "ACZ"));
+}
+
+TEST_CASE("Cannot parse what is not a font file", "[font_metrics]")
+{
+    uint8_t zi[sizeof(SMALL_ZI)];
+    uint8_t widths[NEX_FONT_METRICS_MAX_CHARACTERS];
+    nextion_font_metrics_t metrics;
+
+    CHECK_NEX_FAIL(nextion_font_metrics_parse(SMALL_ZI, sizeof(SMALL_ZI) - 1, widths, sizeof(widths), &metrics));
+    CHECK_NEX_FAIL(nextion_font_metrics_parse(SMALL_ZI, sizeof(SMALL_ZI), widths, 4, &metrics));
+
+    memcpy(zi, SMALL_ZI, sizeof(zi));
+    zi[1] = 0x00;
+
+    CHECK_NEX_FAIL(nextion_font_metrics_parse(zi, sizeof(zi), widths, sizeof(widths), &metrics));
+
+    // A character outside the declared ones.
+    memcpy(zi, SMALL_ZI, sizeof(zi));
+    zi[sizeof(zi) - 10] = 'a';
+
+    CHECK_NEX_FAIL(nextion_font_metrics_parse(zi, sizeof(zi), widths, sizeof(widths), &metrics));
+}
+
+TEST_CASE("Flash tables match the fonts", "[font_metrics]")
+{
+    LONGS_EQUAL(16, NEX_FONT_METRICS_SANS_SERIF_16.height);
+    LONGS_EQUAL(224, NEX_FONT_METRICS_SANS_SERIF_16.count);
+    LONGS_EQUAL(32, NEX_FONT_METRICS_SANS_SERIF_32.height);
+    LONGS_EQUAL(224, NEX_FONT_METRICS_SANS_SERIF_32.count);
+    LONGS_EQUAL(16, NEX_FONT_METRICS_ARIAL_16.height);
+    LONGS_EQUAL(95, NEX_FONT_METRICS_ARIAL_16.count);
+
+    LONGS_EQUAL(70, nextion_font_metrics_text_width(&NEX_FONT_METRICS_ARIAL_16, "Hello world"));
+    LONGS_EQUAL(0, nextion_font_metrics_text_width(&NEX_FONT_METRICS_ARIAL_16, ""));
+    // Latin-1 "e" with acute accent; only the 8859-1 fonts have it.
+    LONGS_EQUAL(32, nextion_font_metrics_text_width(&NEX_FONT_METRICS_ARIAL_16, "Hello\xE9"));
+    LONGS_EQUAL(42, nextion_font_metrics_text_width(&NEX_FONT_METRICS_SANS_SERIF_16, "Hello\xE9"));
+}
+
+TEST_CASE("Fit and truncate text", "[font_metrics]")
+{
+    const nextion_font_metrics_t *metrics = &NEX_FONT_METRICS_ARIAL_16;
+    char buffer[16];
+
+    SIZET_EQUAL(5, nextion_font_metrics_fit(metrics, "Hello world", 32));
+    SIZET_EQUAL(4, nextion_font_metrics_fit(metrics, "Hello world", 31));
+    SIZET_EQUAL(0, nextion_font_metrics_fit(metrics, "", 10));
+
+    SIZET_EQUAL(5, nextion_font_metrics_truncate(metrics, "Hello", 40, buffer, sizeof(buffer)));
+    STRCMP_EQUAL("Hello", buffer);
+
+    SIZET_EQUAL(7, nextion_font_metrics_truncate(metrics, "Hello world", 40, buffer, sizeof(buffer)));
+    STRCMP_EQUAL("Hell...", buffer);
+    CHECK_TRUE(nextion_font_metrics_text_width(metrics, buffer) <= 40);
+
+    // No room for the ellipsis.
+    SIZET_EQUAL(1, nextion_font_metrics_truncate(metrics, "Hello", 10, buffer, sizeof(buffer)));
+    STRCMP_EQUAL("H", buffer);
+
+    // Nor in the buffer.
+    SIZET_EQUAL(4, nextion_font_metrics_truncate(metrics, "Hello world", 40, buffer, 5));
+    STRCMP_EQUAL("H...", buffer);
+}
+
+TEST_CASE("Wrap text", "[font_metrics]")
+{
+    const nextion_font_metrics_t *metrics = &NEX_FONT_METRICS_ARIAL_16;
+    const char *text = "The quick brown fox";
+    size_t next;
+
+    SIZET_EQUAL(9, nextion_font_metrics_wrap(metrics, text, 70, &next));
+    SIZET_EQUAL(10, next);
+    SIZET_EQUAL(9, nextion_font_metrics_wrap(metrics, &text[10], 70, &next));
+    SIZET_EQUAL(9, next);
+
+    LONGS_EQUAL(32, nextion_font_metrics_text_height(metrics, text, 70));
+    LONGS_EQUAL(16, nextion_font_metrics_text_height(metrics, text, 200));
+    LONGS_EQUAL(0, nextion_font_metrics_text_height(metrics, "", 200));
+
+    // Words longer than a line are cut.
+    SIZET_EQUAL(2, nextion_font_metrics_wrap(metrics, "Hello", 20, &next));
+    SIZET_EQUAL(2, next);
+    SIZET_EQUAL(1, nextion_font_metrics_wrap(metrics, "Hello", 5, &next));
+    SIZET_EQUAL(1, next);
+
+    SIZET_EQUAL(2, nextion_font_metrics_wrap(metrics, "ab\ncd", 200, &next));
+    SIZET_EQUAL(3, next);
+}
+
+TEST_CASE("Get area covered by text", "[font_metrics]")
+{
+    const nextion_font_metrics_t *metrics = &NEX_FONT_METRICS_ARIAL_16;
+    const area_t area = font_metrics_test_area(10, 20, 110, 60);
+    text_alignment_t alignment = {.horizontal = HORZ_ALIGN_LEFT, .vertical = VERT_ALIGN_TOP};
+
+    CHECK_AREA(10, 20, 42, 36, nextion_font_metrics_text_area(metrics, area, alignment, "Hello"));
+
+    alignment.horizontal = HORZ_ALIGN_CENTER;
+    alignment.vertical = VERT_ALIGN_CENTER;
+
+    CHECK_AREA(44, 32, 76, 48, nextion_font_metrics_text_area(metrics, area, alignment, "Hello"));
+
+    alignment.horizontal = HORZ_ALIGN_RIGHT;
+    alignment.vertical = VERT_ALIGN_BOTTOM;
+
+    CHECK_AREA(78, 44, 110, 60, nextion_font_metrics_text_area(metrics, area, alignment, "Hello"));
+
+    // Clipped to the area.
+    CHECK_AREA(90, 44, 110, 60, nextion_font_metrics_text_area(metrics, font_metrics_test_area(90, 20, 110, 60), alignment, "Hello"));
+    CHECK_AREA(110, 60, 110, 60, nextion_font_metrics_text_area(metrics, area, alignment, ""));
+}
@@ -0,0 +1,137 @@
+#include <string.h>
+#include "frame_parser.h"
+#include "common_infra_test.h"
+
+/**
+ * @brief Feed bytes into a parser.
+ * @return How many frames were completed.
+ */
+static int feed_bytes(nextion_frame_parser_t *parser, const uint8_t *bytes, size_t length)
+{
+    int frames = 0;
+
+    for (size_t i = 0; i < length; i++)
+    {
+        if (nextion_frame_parser_feed(parser, bytes[i]))
+        {
+            frames++;
+        }
+    }
+
+    return frames;
+}
+
+TEST_CASE("Parse simple response", "[parser]")
+{
+    const uint8_t bytes[] = {0x01, 0xFF, 0xFF, 0xFF};
+    nextion_frame_parser_t parser = {0};
+
+    nextion_frame_parser_reset(&parser);
+
+    TEST_ASSERT_EQUAL_INT(1, feed_bytes(&parser, bytes, sizeof(bytes)));
+    TEST_ASSERT_EQUAL_UINT(4, parser.length);
+    TEST_ASSERT_EQUAL_UINT8(NEX_DVC_INSTRUCTION_OK, parser.frame[0]);
+    TEST_ASSERT_FALSE(nextion_frame_parser_is_busy(&parser));
+}
+
+TEST_CASE("Parse number with 0xFF in its payload", "[parser]")
+{
+    // -1 is sent as 0xFF 0xFF 0xFF 0xFF.
+    const uint8_t bytes[] = {0x71, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+    nextion_frame_parser_t parser = {0};
+
+    nextion_frame_parser_reset(&parser);
+
+    TEST_ASSERT_EQUAL_INT(1, feed_bytes(&parser, bytes, sizeof(bytes)));
+    TEST_ASSERT_EQUAL_UINT(8, parser.length);
+    TEST_ASSERT_EQUAL_UINT8(NEX_DVC_RSP_GET_NUMBER, parser.frame[0]);
+}
+
+TEST_CASE("Parse instruction failure and device reset", "[parser]")
+{
+    const uint8_t failure[] = {0x00, 0xFF, 0xFF, 0xFF};
+    const uint8_t reset[] = {0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF};
+    nextion_frame_parser_t parser = {0};
+
+    nextion_frame_parser_reset(&parser);
+
+    TEST_ASSERT_EQUAL_INT(1, feed_bytes(&parser, failure, sizeof(failure)));
+    TEST_ASSERT_EQUAL_UINT(4, parser.length);
+
+    TEST_ASSERT_EQUAL_INT(1, feed_bytes(&parser, reset, sizeof(reset)));
+    TEST_ASSERT_EQUAL_UINT(6, parser.length);
+    TEST_ASSERT_TRUE(NEX_DVC_CODE_IS_EVENT(parser.frame[0], parser.length));
+}
+
+TEST_CASE("Parse text", "[parser]")
+{
+    const uint8_t bytes[] = {0x70, 'a', 'b', 'c', 0xFF, 0xFF, 0xFF};
+    nextion_frame_parser_t parser = {0};
+
+    nextion_frame_parser_reset(&parser);
+
+    TEST_ASSERT_EQUAL_INT(1, feed_bytes(&parser, bytes, sizeof(bytes)));
+    TEST_ASSERT_EQUAL_UINT(7, parser.length);
+    TEST_ASSERT_EQUAL_MEMORY(bytes, parser.frame, sizeof(bytes));
+}
+
+TEST_CASE("Parse truncated text", "[parser]")
+{
+    uint8_t bytes[CONFIG_NEX_UART_RECV_FRAME_BUFFER_SIZE + 10];
+    nextion_frame_parser_t parser = {0};
+
+    memset(bytes, 'a', sizeof(bytes));
+
+    bytes[0] = NEX_DVC_RSP_GET_STRING;
+    bytes[sizeof(bytes) - 3] = 0xFF;
+    bytes[sizeof(bytes) - 2] = 0xFF;
+    bytes[sizeof(bytes) - 1] = 0xFF;
+
+    nextion_frame_parser_reset(&parser);
+
+    TEST_ASSERT_EQUAL_INT(1, feed_bytes(&parser, bytes, sizeof(bytes)));
+    TEST_ASSERT_EQUAL_UINT(CONFIG_NEX_UART_RECV_FRAME_BUFFER_SIZE, parser.length);
+    TEST_ASSERT_EQUAL_UINT8(0xFF, parser.frame[parser.length - 1]);
+    TEST_ASSERT_EQUAL_UINT8(0xFF, parser.frame[parser.length - 2]);
+    TEST_ASSERT_EQUAL_UINT8(0xFF, parser.frame[parser.length - 3]);
+}
+
+TEST_CASE("Parse frame fed in parts", "[parser]")
+{
+    const uint8_t bytes[] = {0x65, 0x00, 0x02, 0x01, 0xFF, 0xFF, 0xFF};
+    nextion_frame_parser_t parser = {0};
+
+    nextion_frame_parser_reset(&parser);
+
+    TEST_ASSERT_EQUAL_INT(0, feed_bytes(&parser, bytes, 3));
+    TEST_ASSERT_TRUE(nextion_frame_parser_is_busy(&parser));
+    TEST_ASSERT_EQUAL_INT(1, feed_bytes(&parser, bytes + 3, sizeof(bytes) - 3));
+    TEST_ASSERT_EQUAL_UINT(7, parser.length);
+    TEST_ASSERT_EQUAL_UINT8(0x02, parser.frame[2]);
+}
+
+TEST_CASE("Parse frames back to back", "[parser]")
+{
+    const uint8_t bytes[] = {0x01, 0xFF, 0xFF, 0xFF, 0x66, 0x03, 0xFF, 0xFF, 0xFF};
+    nextion_frame_parser_t parser = {0};
+
+    nextion_frame_parser_reset(&parser);
+
+    TEST_ASSERT_EQUAL_INT(2, feed_bytes(&parser, bytes, sizeof(bytes)));
+    TEST_ASSERT_EQUAL_UINT8(NEX_DVC_RSP_SENDME_RESULT, parser.frame[0]);
+    TEST_ASSERT_EQUAL_UINT8(0x03, parser.frame[1]);
+}
+
+TEST_CASE("Resync after corrupted frame", "[parser]")
+{
+    // A touch event missing a byte, followed by a valid response.
+    const uint8_t bytes[] = {0x65, 0x00, 0x02, 0xFF, 0xFF, 0xFF, 0x01, 0xFF, 0xFF, 0xFF, 0x01, 0xFF, 0xFF, 0xFF};
+    nextion_frame_parser_t parser = {0};
+
+    nextion_frame_parser_reset(&parser);
+
+    TEST_ASSERT_EQUAL_INT(1, feed_bytes(&parser, bytes, sizeof(bytes)));
+    TEST_ASSERT_EQUAL_UINT(4, parser.length);
+    TEST_ASSERT_EQUAL_UINT8(NEX_DVC_INSTRUCTION_OK, parser.frame[0]);
+    TEST_ASSERT_TRUE(parser.discarded > 0);
+}
@@ -1,5 +1,8 @@
+#include <string.h>
 #include "esp32_driver_nextion/nextion.h"
+#include "esp32_driver_nextion/system.h"
 #include "common_infra_test.h"
+#include "config.h"
 
 TEST_CASE("Cannot init null context", "[core]")
 {
@@ -29,6 +32,20 @@ TEST_CASE("Cannot send null command", "[core]")
     CHECK_NEX_FAIL(result);
 }
 
+TEST_CASE("Late response is not taken for the next command", "[core]")
+{
+    uint8_t percentage = 0;
+
+    // Answered after the response wait time.
+    nex_err_t late = nextion_command_send(handle, "delay=%d", CONFIG_NEX_UART_RECV_WAIT_TIME_MS + 100);
+    nex_err_t code = nextion_system_get_brightness(handle, false, &percentage);
+
+    LONGS_EQUAL(NEX_TIMEOUT, late);
+    CHECK_NEX_OK(code);
+    TEST_ASSERT_EQUAL_UINT8(100, percentage);
+    CHECK_NEX_OK(nextion_command_send(handle, "page 0"));
+}
+
 TEST_CASE("Transparent data mode begin", "[core]")
 {
     nex_err_t result = nextion_transparent_data_mode_begin(handle, 1, "wept 0,1");
@@ -76,6 +93,37 @@ TEST_CASE("Transparent data mode end", "[core]")
     CHECK_NEX_OK(result);
 }
 
+TEST_CASE("Transparent data mode restart", "[core]")
+{
+    nex_err_t end_code = NEX_FAIL;
+
+    nextion_transparent_data_mode_begin(handle, 1, "wept 0,1");
+    nextion_transparent_data_mode_write(handle, 0);
+
+    nex_err_t result = nextion_transparent_data_mode_restart(handle, &end_code, 1, "wept 1,1");
+
+    nextion_transparent_data_mode_write(handle, 0);
+    nextion_transparent_data_mode_end(handle);
+
+    CHECK_NEX_OK(result);
+    CHECK_NEX_OK(end_code);
+}
+
+TEST_CASE("Cannot restart transparent data mode before all data is written", "[core]")
+{
+    nex_err_t end_code = NEX_OK;
+
+    nextion_transparent_data_mode_begin(handle, 2, "wept 0,2");
+    nextion_transparent_data_mode_write(handle, 0);
+
+    nex_err_t result = nextion_transparent_data_mode_restart(handle, &end_code, 1, "wept 1,1");
+
+    nextion_transparent_data_mode_write(handle, 0);
+    nextion_transparent_data_mode_end(handle);
+
+    CHECK_NEX_FAIL(result);
+}
+
 TEST_CASE("Cannot end unstarted transparent data mode", "[core]")
 {
     nex_err_t result = nextion_transparent_data_mode_end(handle);
@@ -94,3 +142,222 @@ TEST_CASE("Cannot send command when in transparent data mode", "[core]")
 
     CHECK_NEX_FAIL(result);
 }
+
+static void async_command_callback(nextion_t *handle, nex_err_t code, void *context)
+{
+    *((nex_err_t *)context) = code;
+}
+
+TEST_CASE("Send command asynchronously", "[core]")
+{
+    nex_err_t result = nextion_command_send_async(handle, NULL, NULL, "page 0");
+
+    CHECK_NEX_OK(result);
+    CHECK_NEX_OK(nextion_command_wait_all(handle));
+}
+
+TEST_CASE("Asynchronous command calls back with response", "[core]")
+{
+    nex_err_t callback_code = NEX_FAIL;
+
+    nextion_command_send_async(handle, async_command_callback, &callback_code, "page 0");
+    nextion_command_wait_all(handle);
+
+    CHECK_NEX_OK(callback_code);
+}
+
+static void async_command_callback_send(nextion_t *handle, nex_err_t code, void *context)
+{
+    *((nex_err_t *)context) = nextion_command_send(handle, "page 0");
+}
+
+TEST_CASE("Cannot send command from an asynchronous callback", "[core]")
+{
+    nex_err_t callback_code = NEX_OK;
+
+    nextion_command_send_async(handle, async_command_callback_send, &callback_code, "page 0");
+    nextion_command_wait_all(handle);
+
+    CHECK_NEX_FAIL(callback_code);
+}
+
+TEST_CASE("Wait returns first asynchronous failure", "[core]")
+{
+    nextion_command_send_async(handle, NULL, NULL, "page 0");
+    nextion_command_send_async(handle, NULL, NULL, "page 99");
+    nextion_command_send_async(handle, NULL, NULL, "page 0");
+
+    nex_err_t result = nextion_command_wait_all(handle);
+
+    NEX_CODES_EQUAL(NEX_DVC_ERR_INVALID_PAGE, result);
+}
+
+TEST_CASE("Cannot send asynchronous command with null handle", "[core]")
+{
+    nex_err_t result = nextion_command_send_async(NULL, NULL, NULL, "");
+
+    CHECK_NEX_FAIL(result);
+}
+
+TEST_CASE("Cannot send null asynchronous command", "[core]")
+{
+    nex_err_t result = nextion_command_send_async(handle, NULL, NULL, NULL);
+
+    CHECK_NEX_FAIL(result);
+}
+
+TEST_CASE("Send batch", "[core]")
+{
+    CHECK_NEX_OK(nextion_batch_begin(handle));
+
+    nextion_command_send(handle, "page 0");
+    nextion_command_send(handle, "vis 255,1");
+
+    nex_err_t result = nextion_batch_end(handle);
+
+    CHECK_NEX_OK(result);
+}
+
+TEST_CASE("Batch end returns first failure", "[core]")
+{
+    nextion_batch_begin(handle);
+
+    nextion_command_send(handle, "page 0");
+    nextion_command_send(handle, "page 99");
+
+    nex_err_t result = nextion_batch_end(handle);
+
+    NEX_CODES_EQUAL(NEX_DVC_ERR_INVALID_PAGE, result);
+}
+
+TEST_CASE("Batch bigger than the command queue", "[core]")
+{
+    nextion_batch_begin(handle);
+
+    for (int i = 0; i < CONFIG_NEX_UART_COMMAND_QUEUE_SIZE * 2; i++)
+    {
+        nextion_command_send(handle, "page 0");
+    }
+
+    nex_err_t result = nextion_batch_end(handle);
+
+    CHECK_NEX_OK(result);
+}
+
+TEST_CASE("Batch writes nothing of a command that fails to format", "[core]")
+{
+    // Longer than the batch buffer, so it would be written in pieces.
+    char zeros[CONFIG_NEX_UART_BATCH_BUFFER_SIZE + 1];
+    int count = 0;
+    int32_t number = 0;
+
+    memset(zeros, '0', sizeof(zeros) - 1);
+    zeros[sizeof(zeros) - 1] = '\0';
+
+    nextion_batch_begin(handle);
+
+    nex_err_t failed = nextion_command_send(handle, "sys0=%s%n", zeros, &count);
+
+    nextion_command_send(handle, "sys0=7");
+
+    nex_err_t result = nextion_batch_end(handle);
+
+    nextion_system_get_number(handle, "get sys0", &number);
+
+    CHECK_NEX_FAIL(failed);
+    CHECK_NEX_OK(result);
+    LONGS_EQUAL(7, number);
+}
+
+TEST_CASE("Cannot begin nested batch", "[core]")
+{
+    nextion_batch_begin(handle);
+
+    nex_err_t result = nextion_batch_begin(handle);
+
+    nextion_batch_end(handle);
+
+    CHECK_NEX_FAIL(result);
+}
+
+TEST_CASE("Cannot end unstarted batch", "[core]")
+{
+    nex_err_t result = nextion_batch_end(handle);
+
+    CHECK_NEX_FAIL(result);
+}
+
+TEST_CASE("Get link info", "[core]")
+{
+    nextion_link_info_t info;
+
+    nex_err_t result = nextion_link_get_info(handle, &info);
+
+    CHECK_NEX_OK(result);
+    CHECK_TRUE(info.baud_rate >= NEX_SERIAL_BAUD_RATE_MIN);
+    CHECK_TRUE(info.throughput > 0);
+}
+
+TEST_CASE("Set baud rate", "[core]")
+{
+    nextion_link_info_t before;
+    nextion_link_info_t after;
+
+    nextion_link_get_info(handle, &before);
+
+    nex_err_t result = nextion_baud_rate_set(handle, NEXTION_BAUD_RATE_115200);
+
+    nextion_link_get_info(handle, &after);
+    nextion_baud_rate_set(handle, before.baud_rate);
+
+    CHECK_NEX_OK(result);
+    SIZET_EQUAL(NEXTION_BAUD_RATE_115200, after.baud_rate);
+}
+
+TEST_CASE("Cannot set unsupported baud rate", "[core]")
+{
+    nex_err_t result = nextion_baud_rate_set(handle, 100000);
+
+    CHECK_NEX_FAIL(result);
+}
+
+TEST_CASE("Get stats", "[core]")
+{
+    nextion_stats_t stats;
+
+    nextion_stats_reset(handle);
+    nextion_command_send(handle, "page 0");
+
+    nex_err_t result = nextion_stats_get(handle, &stats);
+
+    CHECK_NEX_OK(result);
+    SIZET_EQUAL(1, stats.commands_sent);
+    SIZET_EQUAL(9, stats.bytes_sent);
+    SIZET_EQUAL(1, stats.acks[NEX_DVC_INSTRUCTION_OK]);
+    SIZET_EQUAL(1, stats.command_latency.count);
+    SIZET_EQUAL(0, stats.timeouts);
+}
+
+TEST_CASE("Reset stats", "[core]")
+{
+    nextion_stats_t stats;
+
+    nextion_command_send(handle, "page 0");
+
+    nex_err_t result = nextion_stats_reset(handle);
+
+    nextion_stats_get(handle, &stats);
+
+    CHECK_NEX_OK(result);
+    SIZET_EQUAL(0, stats.commands_sent);
+    SIZET_EQUAL(0, stats.bytes_received);
+}
+
+TEST_CASE("Cannot get stats with null handle", "[core]")
+{
+    nextion_stats_t stats;
+
+    nex_err_t result = nextion_stats_get(NULL, &stats);
+
+    CHECK_NEX_FAIL(result);
+}
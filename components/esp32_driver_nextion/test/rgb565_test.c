@@ -15,3 +15,109 @@ TEST_CASE("Convert from 888 blue", "[rgb565]")
 {
     RGB565_EQUAL(RGB565_COLOR_BLUE, rgb565_convert_from_888(0, 0, 255));
 }
+
+TEST_CASE("Convert 888 buffer", "[rgb565]")
+{
+    const uint8_t rgb[] = {255, 0, 0, 0, 255, 0, 0, 0, 255, 0x12, 0x34, 0x56};
+    rgb565_t colors[4];
+
+    rgb565_convert_buffer_from_888(rgb, colors, 4, NULL);
+
+    RGB565_EQUAL(RGB565_COLOR_RED, colors[0]);
+    RGB565_EQUAL(RGB565_COLOR_GREEN, colors[1]);
+    RGB565_EQUAL(RGB565_COLOR_BLUE, colors[2]);
+    RGB565_EQUAL(rgb565_convert_from_888(0x12, 0x34, 0x56), colors[3]);
+}
+
+TEST_CASE("Convert HSV buffer", "[rgb565]")
+{
+    const uint8_t hsv[] = {0, 255, 255, 85, 255, 255, 171, 255, 255, 42, 0, 255, 99, 255, 0};
+    rgb565_t colors[5];
+
+    rgb565_convert_buffer_from_hsv(hsv, colors, 5, NULL);
+
+    RGB565_EQUAL(RGB565_COLOR_RED, colors[0]);
+    RGB565_EQUAL(RGB565_COLOR_GREEN, colors[1]);
+    RGB565_EQUAL(RGB565_COLOR_BLUE, colors[2]);
+    RGB565_EQUAL(RGB565_COLOR_WHITE, colors[3]);
+    RGB565_EQUAL(RGB565_COLOR_BLACK, colors[4]);
+}
+
+TEST_CASE("Apply gamma", "[rgb565]")
+{
+    const uint8_t rgb[] = {128, 0, 255};
+    const rgb565_convert_config_t config = {.dither = RGB565_DITHER_NONE, .width = 0, .gamma = RGB565_GAMMA_22};
+    rgb565_t color;
+
+    rgb565_convert_buffer_from_888(rgb, &color, 1, &config);
+
+    RGB565_EQUAL(rgb565_convert_from_888(56, 0, 255), color);
+}
+
+TEST_CASE("Dither a flat color", "[rgb565]")
+{
+    // Half a red step: truncating loses it, dithering lights half the pixels.
+    uint8_t rgb[16 * 3] = {0};
+    rgb565_t colors[16];
+    rgb565_convert_config_t config = {.dither = RGB565_DITHER_ORDERED, .width = 4, .gamma = NULL};
+    size_t lit = 0;
+
+    for (size_t i = 0; i < 16; i++)
+    {
+        rgb[i * 3] = 4;
+    }
+
+    rgb565_convert_buffer_from_888(rgb, colors, 16, NULL);
+
+    for (size_t i = 0; i < 16; i++)
+    {
+        RGB565_EQUAL(RGB565_COLOR_BLACK, colors[i]);
+    }
+
+    rgb565_convert_buffer_from_888(rgb, colors, 16, &config);
+
+    for (size_t i = 0; i < 16; i++)
+    {
+        lit += colors[i] == rgb565_convert_from_888(8, 0, 0) ? 1 : 0;
+    }
+
+    SIZET_EQUAL(8, lit);
+
+    config.dither = RGB565_DITHER_DIFFUSION;
+    lit = 0;
+
+    rgb565_convert_buffer_from_888(rgb, colors, 16, &config);
+
+    for (size_t i = 0; i < 16; i++)
+    {
+        lit += colors[i] == rgb565_convert_from_888(8, 0, 0) ? 1 : 0;
+    }
+
+    SIZET_EQUAL(8, lit);
+}
+
+TEST_CASE("Ramp matches the constant table", "[rgb565]")
+{
+    static const rgb565_t GRAYS[] = RGB565_RAMP_16(0, 0, 0, 255, 255, 255);
+    static const rgb565_t FADE[] = RGB565_RAMP_16(255, 0, 0, 0, 0, 255);
+    rgb565_t colors[16];
+
+    RGB565_EQUAL(RGB565_COLOR_BLACK, GRAYS[0]);
+    RGB565_EQUAL(RGB565_COLOR_WHITE, GRAYS[15]);
+    RGB565_EQUAL(RGB565_COLOR_RED, FADE[0]);
+    RGB565_EQUAL(RGB565_COLOR_BLUE, FADE[15]);
+
+    rgb565_ramp(0x000000, 0xFFFFFF, colors, 16, NULL);
+
+    for (size_t i = 0; i < 16; i++)
+    {
+        RGB565_EQUAL(GRAYS[i], colors[i]);
+    }
+
+    rgb565_ramp(0xFF0000, 0x0000FF, colors, 16, NULL);
+
+    for (size_t i = 0; i < 16; i++)
+    {
+        RGB565_EQUAL(FADE[i], colors[i]);
+    }
+}
@@ -0,0 +1,123 @@
+#include "ring.h"
+#include "event_ring.h"
+#include "common_infra_test.h"
+
+static nextion_event_ring_t event_ring;
+
+TEST_CASE("Ring starts empty", "[ring]")
+{
+    uint8_t slots[NEX_RING_SLOTS_SIZE(1U, 4U)];
+    nextion_ring_t ring;
+    uint8_t value;
+
+    nextion_ring_init(&ring, slots, 1U, 4U);
+
+    SIZET_EQUAL(0, nextion_ring_count(&ring));
+    SIZET_EQUAL(0, nextion_ring_pop(&ring, &value, 1));
+}
+
+TEST_CASE("Ring keeps order across its end", "[ring]")
+{
+    const uint8_t first[] = {1, 2, 3};
+    const uint8_t second[] = {4, 5, 6};
+    const uint8_t expected[] = {3, 4, 5, 6};
+    uint8_t slots[NEX_RING_SLOTS_SIZE(1U, 4U)];
+    nextion_ring_t ring;
+    uint8_t values[4];
+
+    nextion_ring_init(&ring, slots, 1U, 4U);
+
+    SIZET_EQUAL(3, nextion_ring_push(&ring, first, 3));
+    SIZET_EQUAL(2, nextion_ring_pop(&ring, values, 2));
+    SIZET_EQUAL(3, nextion_ring_push(&ring, second, 3));
+    SIZET_EQUAL(4, nextion_ring_count(&ring));
+    SIZET_EQUAL(4, nextion_ring_pop(&ring, values, sizeof(values)));
+
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, values, sizeof(expected));
+}
+
+TEST_CASE("Ring leaves out what does not fit", "[ring]")
+{
+    const uint8_t values[] = {1, 2, 3, 4, 5, 6};
+    uint8_t slots[NEX_RING_SLOTS_SIZE(1U, 4U)];
+    nextion_ring_t ring;
+
+    nextion_ring_init(&ring, slots, 1U, 4U);
+
+    SIZET_EQUAL(4, nextion_ring_push(&ring, values, sizeof(values)));
+    SIZET_EQUAL(0, nextion_ring_push(&ring, values, 1));
+}
+
+TEST_CASE("Ring discards the oldest", "[ring]")
+{
+    const uint8_t values[] = {1, 2, 3, 4};
+    uint8_t slots[NEX_RING_SLOTS_SIZE(1U, 4U)];
+    nextion_ring_t ring;
+    uint8_t value;
+
+    nextion_ring_init(&ring, slots, 1U, 4U);
+    nextion_ring_push(&ring, values, sizeof(values));
+
+    SIZET_EQUAL(3, nextion_ring_pop(&ring, NULL, 3));
+    SIZET_EQUAL(1, nextion_ring_pop(&ring, &value, 1));
+    LONGS_EQUAL(4, value);
+}
+
+TEST_CASE("Ring copies whole items across its end", "[ring]")
+{
+    const uint32_t items[] = {0x01020304, 0x05060708, 0x090A0B0C};
+    uint32_t slots[3];
+    nextion_ring_t ring;
+    uint32_t item;
+
+    nextion_ring_init(&ring, slots, sizeof(uint32_t), 2U);
+
+    for (size_t i = 0; i < 3 * sizeof(items) / sizeof(items[0]); i++)
+    {
+        SIZET_EQUAL(1, nextion_ring_push(&ring, &items[i % 3], 1));
+        SIZET_EQUAL(1, nextion_ring_pop(&ring, &item, 1));
+        LONGS_EQUAL(items[i % 3], item);
+    }
+}
+
+TEST_CASE("Event ring keeps order", "[ring]")
+{
+    const uint8_t first[] = {0x65, 0x00, 0x01, 0x01, 0xFF, 0xFF, 0xFF};
+    const uint8_t second[] = {0x86, 0xFF, 0xFF, 0xFF};
+    nextion_event_ring_entry_t entry;
+
+    nextion_event_ring_init(&event_ring);
+
+    CHECK_FALSE(nextion_event_ring_pop(&event_ring, &entry));
+    CHECK_TRUE(nextion_event_ring_push(&event_ring, first, sizeof(first)));
+    CHECK_TRUE(nextion_event_ring_push(&event_ring, second, sizeof(second)));
+
+    CHECK_TRUE(nextion_event_ring_pop(&event_ring, &entry));
+    SIZET_EQUAL(sizeof(first), entry.length);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(first, entry.frame, sizeof(first));
+
+    CHECK_TRUE(nextion_event_ring_pop(&event_ring, &entry));
+    SIZET_EQUAL(sizeof(second), entry.length);
+    TEST_ASSERT_EQUAL_UINT8(0x86, entry.frame[0]);
+
+    CHECK_FALSE(nextion_event_ring_pop(&event_ring, &entry));
+}
+
+TEST_CASE("Event ring rejects when full", "[ring]")
+{
+    const uint8_t event[] = {0x87, 0xFF, 0xFF, 0xFF};
+    nextion_event_ring_entry_t entry;
+
+    nextion_event_ring_init(&event_ring);
+
+    for (int i = 0; i < CONFIG_NEX_EVENT_QUEUE_SIZE; i++)
+    {
+        CHECK_TRUE(nextion_event_ring_push(&event_ring, event, sizeof(event)));
+    }
+
+    CHECK_FALSE(nextion_event_ring_push(&event_ring, event, sizeof(event)));
+
+    // Room is made by the consumer.
+    CHECK_TRUE(nextion_event_ring_pop(&event_ring, &entry));
+    CHECK_TRUE(nextion_event_ring_push(&event_ring, event, sizeof(event)));
+}
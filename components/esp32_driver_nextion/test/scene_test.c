@@ -0,0 +1,240 @@
+#include "esp32_driver_nextion/scene.h"
+#include "common_infra_test.h"
+
+static const nextion_scene_config_t SCENE_CONFIG = {
+    .width = 320,
+    .height = 240,
+    .max_objects = 4,
+    .fill_mode = BACKG_FILL_COLOR,
+    .color = RGB565_COLOR_BLACK,
+};
+
+static nextion_scene_object_t scene_test_fill(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, rgb565_t color)
+{
+    nextion_scene_object_t object = {
+        .kind = NEX_SCENE_OBJECT_FILL_AREA,
+        .area = {.upper_left = {.x = x1, .y = y1}, .bottom_right = {.x = x2, .y = y2}},
+        .color = color,
+    };
+
+    return object;
+}
+
+static size_t scene_test_render(nextion_scene_t *scene)
+{
+    nextion_stats_t before;
+    nextion_stats_t after;
+
+    CHECK_NEX_OK(nextion_stats_get(handle, &before));
+    CHECK_NEX_OK(nextion_scene_render(scene));
+    CHECK_NEX_OK(nextion_stats_get(handle, &after));
+
+    return after.commands_sent - before.commands_sent;
+}
+
+TEST_CASE("Scene draws everything first", "[scene]")
+{
+    nextion_scene_t *scene = nextion_scene_create(handle, &SCENE_CONFIG);
+    nextion_scene_object_t first = scene_test_fill(10, 10, 50, 50, RGB565_COLOR_RED);
+    nextion_scene_object_t second = scene_test_fill(100, 10, 150, 50, RGB565_COLOR_GREEN);
+    size_t id;
+
+    CHECK_NOT_NULL(scene);
+
+    CHECK_NEX_OK(nextion_scene_add(scene, &first, &id));
+    SIZET_EQUAL(0, id);
+    CHECK_NEX_OK(nextion_scene_add(scene, &second, &id));
+    SIZET_EQUAL(1, id);
+
+    // Background and both objects.
+    SIZET_EQUAL(3, scene_test_render(scene));
+    SIZET_EQUAL(0, scene_test_render(scene));
+
+    CHECK_TRUE(nextion_scene_delete(scene));
+}
+
+TEST_CASE("Scene redraws only what changed", "[scene]")
+{
+    nextion_scene_t *scene = nextion_scene_create(handle, &SCENE_CONFIG);
+    nextion_scene_object_t first = scene_test_fill(10, 10, 50, 50, RGB565_COLOR_RED);
+    nextion_scene_object_t second = scene_test_fill(100, 10, 150, 50, RGB565_COLOR_GREEN);
+    size_t first_id;
+    size_t second_id;
+
+    CHECK_NOT_NULL(scene);
+
+    CHECK_NEX_OK(nextion_scene_add(scene, &first, &first_id));
+    CHECK_NEX_OK(nextion_scene_add(scene, &second, &second_id));
+    scene_test_render(scene);
+
+    // The same object changes nothing.
+    CHECK_NEX_OK(nextion_scene_update(scene, first_id, &first));
+    SIZET_EQUAL(0, scene_test_render(scene));
+
+    // Background under it and the object.
+    first.color = RGB565_COLOR_BLUE;
+    CHECK_NEX_OK(nextion_scene_update(scene, first_id, &first));
+    SIZET_EQUAL(2, scene_test_render(scene));
+
+    CHECK_TRUE(nextion_scene_delete(scene));
+}
+
+TEST_CASE("Scene redraws overlapping objects whole", "[scene]")
+{
+    nextion_scene_t *scene = nextion_scene_create(handle, &SCENE_CONFIG);
+    nextion_scene_object_t below = scene_test_fill(10, 10, 50, 50, RGB565_COLOR_RED);
+    nextion_scene_object_t above = scene_test_fill(40, 40, 80, 80, RGB565_COLOR_GREEN);
+    nextion_scene_object_t apart = scene_test_fill(200, 200, 220, 220, RGB565_COLOR_BLUE);
+    size_t below_id;
+    size_t id;
+
+    CHECK_NOT_NULL(scene);
+
+    CHECK_NEX_OK(nextion_scene_add(scene, &below, &below_id));
+    CHECK_NEX_OK(nextion_scene_add(scene, &above, &id));
+    CHECK_NEX_OK(nextion_scene_add(scene, &apart, &id));
+    scene_test_render(scene);
+
+    // Background, the object and the one above it; not the one apart.
+    below.color = RGB565_COLOR_WHITE;
+    CHECK_NEX_OK(nextion_scene_update(scene, below_id, &below));
+    SIZET_EQUAL(3, scene_test_render(scene));
+
+    CHECK_TRUE(nextion_scene_delete(scene));
+}
+
+TEST_CASE("Scene merges changes in one area", "[scene]")
+{
+    nextion_scene_t *scene = nextion_scene_create(handle, &SCENE_CONFIG);
+    nextion_scene_object_t object = scene_test_fill(10, 10, 50, 50, RGB565_COLOR_RED);
+    size_t id;
+
+    CHECK_NOT_NULL(scene);
+
+    CHECK_NEX_OK(nextion_scene_add(scene, &object, &id));
+    scene_test_render(scene);
+
+    // Old and new bounds overlap: a single area.
+    object.area.upper_left.x = 20;
+    object.area.bottom_right.x = 60;
+    CHECK_NEX_OK(nextion_scene_update(scene, id, &object));
+    SIZET_EQUAL(2, scene_test_render(scene));
+
+    // Old and new bounds apart: two areas.
+    object.area.upper_left.x = 200;
+    object.area.bottom_right.x = 240;
+    CHECK_NEX_OK(nextion_scene_update(scene, id, &object));
+    SIZET_EQUAL(3, scene_test_render(scene));
+
+    CHECK_TRUE(nextion_scene_delete(scene));
+}
+
+TEST_CASE("Scene restores background of hidden objects", "[scene]")
+{
+    nextion_scene_t *scene = nextion_scene_create(handle, &SCENE_CONFIG);
+    nextion_scene_object_t object = scene_test_fill(10, 10, 50, 50, RGB565_COLOR_RED);
+    size_t id;
+
+    CHECK_NOT_NULL(scene);
+
+    CHECK_NEX_OK(nextion_scene_add(scene, &object, &id));
+    scene_test_render(scene);
+
+    CHECK_NEX_OK(nextion_scene_set_visibility(scene, id, false));
+    SIZET_EQUAL(1, scene_test_render(scene));
+
+    CHECK_NEX_OK(nextion_scene_set_visibility(scene, id, true));
+    SIZET_EQUAL(2, scene_test_render(scene));
+
+    CHECK_NEX_OK(nextion_scene_remove(scene, id));
+    SIZET_EQUAL(1, scene_test_render(scene));
+
+    CHECK_TRUE(nextion_scene_delete(scene));
+}
+
+TEST_CASE("Scene draws text and shapes", "[scene]")
+{
+    nextion_scene_t *scene = nextion_scene_create(handle, &SCENE_CONFIG);
+    nextion_scene_object_t text = {
+        .kind = NEX_SCENE_OBJECT_TEXT,
+        .area = {.upper_left = {.x = 0, .y = 100}, .bottom_right = {.x = 100, .y = 130}},
+        .font = {.color = RGB565_COLOR_WHITE, .id = 0},
+        .background = {.fill_mode = BACKG_FILL_NONE},
+        .alignment = {.horizontal = HORZ_ALIGN_LEFT, .vertical = VERT_ALIGN_TOP},
+    };
+    nextion_scene_object_t circle = {
+        .kind = NEX_SCENE_OBJECT_CIRCLE,
+        .position = {.x = 5, .y = 5},
+        .radius = 10,
+        .color = RGB565_COLOR_RED,
+    };
+    nextion_scene_object_t line = {
+        .kind = NEX_SCENE_OBJECT_LINE,
+        .area = {.upper_left = {.x = 300, .y = 200}, .bottom_right = {.x = 250, .y = 150}},
+        .color = RGB565_COLOR_GREEN,
+    };
+    char value[8] = "12";
+    size_t text_id;
+    size_t id;
+
+    CHECK_NOT_NULL(scene);
+
+    text.text = value;
+
+    CHECK_NEX_OK(nextion_scene_add(scene, &text, &text_id));
+    CHECK_NEX_OK(nextion_scene_add(scene, &circle, &id));
+    CHECK_NEX_OK(nextion_scene_add(scene, &line, &id));
+    SIZET_EQUAL(4, scene_test_render(scene));
+
+    // The text was copied.
+    value[0] = '3';
+    SIZET_EQUAL(0, scene_test_render(scene));
+
+    text.text = "34";
+    CHECK_NEX_OK(nextion_scene_update(scene, text_id, &text));
+    SIZET_EQUAL(2, scene_test_render(scene));
+
+    CHECK_NEX_OK(nextion_scene_invalidate(scene));
+    SIZET_EQUAL(4, scene_test_render(scene));
+
+    CHECK_TRUE(nextion_scene_delete(scene));
+}
+
+TEST_CASE("Scene refuses invalid objects", "[scene]")
+{
+    nextion_scene_t *scene = nextion_scene_create(handle, &SCENE_CONFIG);
+    nextion_scene_object_t object = scene_test_fill(10, 10, 50, 50, RGB565_COLOR_RED);
+    nextion_scene_object_t text = {.kind = NEX_SCENE_OBJECT_TEXT, .text = NULL};
+    size_t id;
+
+    CHECK_NOT_NULL(scene);
+
+    CHECK_NEX_FAIL(nextion_scene_add(scene, &text, &id));
+    CHECK_NEX_FAIL(nextion_scene_update(scene, 0, &object));
+    CHECK_NEX_FAIL(nextion_scene_set_visibility(scene, 0, false));
+    CHECK_NEX_FAIL(nextion_scene_remove(scene, 0));
+
+    for (size_t i = 0; i < SCENE_CONFIG.max_objects; i++)
+    {
+        CHECK_NEX_OK(nextion_scene_add(scene, &object, &id));
+    }
+
+    CHECK_NEX_FAIL(nextion_scene_add(scene, &object, &id));
+
+    // Removed ids are given again.
+    CHECK_NEX_OK(nextion_scene_remove(scene, 2));
+    CHECK_NEX_OK(nextion_scene_add(scene, &object, &id));
+    SIZET_EQUAL(2, id);
+
+    CHECK_TRUE(nextion_scene_delete(scene));
+}
+
+TEST_CASE("Cannot create scene without size", "[scene]")
+{
+    nextion_scene_config_t config = SCENE_CONFIG;
+
+    config.width = 0;
+
+    CHECK_NULL(nextion_scene_create(handle, &config));
+    CHECK_NULL(nextion_scene_create(handle, NULL));
+}
@@ -0,0 +1,97 @@
+#include "esp32_driver_nextion/component.h"
+#include "esp32_driver_nextion/page.h"
+#include "esp32_driver_nextion/screen.h"
+#include "common_infra_test.h"
+
+TEST_CASE("Apply screen", "[screen]")
+{
+    int32_t number = 0;
+    const nextion_screen_item_t items[] = {
+        NEXTION_SCREEN_VISIBILITY("n0", true),
+        NEXTION_SCREEN_NUMBER("x0", "val", 150),
+        NEXTION_SCREEN_TEXT("b0", "txt", "Screen")};
+    const nextion_screen_t screen = {.page = "0", .items = items, .item_count = 3};
+
+    nex_err_t code = nextion_screen_apply(handle, &screen);
+
+    nextion_component_get_value(handle, "x0", &number);
+
+    CHECK_NEX_OK(code);
+    LONGS_EQUAL(150, number);
+}
+
+TEST_CASE("Apply same screen again sends nothing", "[screen]")
+{
+    nextion_component_cache_stats_t before;
+    nextion_component_cache_stats_t after;
+    const nextion_screen_item_t items[] = {
+        NEXTION_SCREEN_VISIBILITY("n0", true),
+        NEXTION_SCREEN_NUMBER("x0", "val", 160)};
+    const nextion_screen_t screen = {.page = "0", .items = items, .item_count = 2};
+
+    nextion_screen_apply(handle, &screen);
+    nextion_component_cache_get_stats(handle, &before);
+
+    nex_err_t code = nextion_screen_apply(handle, &screen);
+
+    nextion_component_cache_get_stats(handle, &after);
+
+    CHECK_NEX_OK(code);
+    SIZET_EQUAL(before.misses, after.misses);
+    SIZET_EQUAL(before.hits + 2, after.hits);
+    SIZET_EQUAL(before.invalidations, after.invalidations);
+}
+
+TEST_CASE("Cannot apply screen with invalid component", "[screen]")
+{
+    const nextion_screen_item_t items[] = {NEXTION_SCREEN_NUMBER("x99", "val", 1)};
+    const nextion_screen_t screen = {.items = items, .item_count = 1};
+
+    nex_err_t code = nextion_screen_apply(handle, &screen);
+
+    NEX_CODES_EQUAL(NEX_DVC_ERR_INVALID_VARIABLE_OR_ATTRIBUTE, code);
+}
+
+TEST_CASE("Apply screen by page id after its name keeps the page", "[screen]")
+{
+    nextion_component_cache_stats_t before;
+    nextion_component_cache_stats_t after;
+    const nextion_screen_item_t items[] = {NEXTION_SCREEN_NUMBER("x0", "val", 170)};
+    const nextion_screen_t by_name = {.page = "page0", .items = items, .item_count = 1};
+    const nextion_screen_t by_id = {.page = "0", .items = items, .item_count = 1};
+
+    nextion_page_set(handle, "1");
+    nextion_screen_apply(handle, &by_name);
+    nextion_component_cache_get_stats(handle, &before);
+
+    nex_err_t code = nextion_screen_apply(handle, &by_id);
+
+    nextion_component_cache_get_stats(handle, &after);
+
+    CHECK_NEX_OK(code);
+    SIZET_EQUAL(before.invalidations, after.invalidations);
+    SIZET_EQUAL(before.hits + 1, after.hits);
+}
+
+TEST_CASE("Cannot apply screen the component cache cannot hold", "[screen]")
+{
+    const nextion_screen_item_t by_id[] = {NEXTION_SCREEN_NUMBER("b[3]", "val", 1)};
+    const nextion_screen_item_t item = NEXTION_SCREEN_NUMBER("x0", "val", 1);
+    nextion_screen_item_t many[CONFIG_NEX_COMPONENT_CACHE_SIZE + 1];
+
+    for (size_t i = 0; i < sizeof(many) / sizeof(many[0]); i++)
+    {
+        many[i] = item;
+    }
+
+    const nextion_screen_t screen = {.items = by_id, .item_count = 1};
+    const nextion_screen_t too_large = {.items = many, .item_count = sizeof(many) / sizeof(many[0])};
+
+    nex_err_t code = nextion_screen_apply(handle, &screen);
+
+    NEX_CODES_EQUAL(NEX_FAIL, code);
+
+    code = nextion_screen_apply(handle, &too_large);
+
+    NEX_CODES_EQUAL(NEX_FAIL, code);
+}
@@ -0,0 +1,76 @@
+#include "transport_stats.h"
+#include "common_infra_test.h"
+
+static nextion_transport_stats_t stats;
+
+TEST_CASE("Transport stats start zeroed", "[transport_stats]")
+{
+    nextion_stats_t counters;
+
+    nextion_transport_stats_init(&stats);
+    nextion_transport_stats_get(&stats, &counters);
+
+    SIZET_EQUAL(0, counters.commands_sent);
+    SIZET_EQUAL(0, counters.command_latency.count);
+}
+
+TEST_CASE("Transport stats count acks by code", "[transport_stats]")
+{
+    nextion_stats_t counters;
+
+    nextion_transport_stats_init(&stats);
+    nextion_transport_stats_on_ack(&stats, NEX_DVC_INSTRUCTION_OK, 100);
+    nextion_transport_stats_on_ack(&stats, NEX_DVC_ERR_INVALID_PAGE, 100);
+    nextion_transport_stats_on_ack(&stats, 0xFE, 100);
+    nextion_transport_stats_get(&stats, &counters);
+
+    SIZET_EQUAL(1, counters.acks[NEX_DVC_INSTRUCTION_OK]);
+    SIZET_EQUAL(1, counters.acks[NEX_DVC_ERR_INVALID_PAGE]);
+    SIZET_EQUAL(1, counters.acks[NEXTION_STATS_ACK_CODE_COUNT - 1]);
+    SIZET_EQUAL(3, counters.command_latency.count);
+}
+
+TEST_CASE("Transport stats histogram buckets double", "[transport_stats]")
+{
+    nextion_stats_histogram_t histogram = {0};
+
+    nextion_stats_histogram_add(&histogram, 0);
+    nextion_stats_histogram_add(&histogram, NEXTION_STATS_HISTOGRAM_FIRST_BOUND_US - 1);
+    nextion_stats_histogram_add(&histogram, NEXTION_STATS_HISTOGRAM_FIRST_BOUND_US);
+    nextion_stats_histogram_add(&histogram, NEXTION_STATS_HISTOGRAM_FIRST_BOUND_US * 2);
+    nextion_stats_histogram_add(&histogram, UINT32_MAX);
+
+    SIZET_EQUAL(2, histogram.buckets[0]);
+    SIZET_EQUAL(1, histogram.buckets[1]);
+    SIZET_EQUAL(1, histogram.buckets[2]);
+    SIZET_EQUAL(1, histogram.buckets[NEXTION_STATS_HISTOGRAM_BUCKET_COUNT - 1]);
+    SIZET_EQUAL(5, histogram.count);
+    SIZET_EQUAL(UINT32_MAX, histogram.max_us);
+}
+
+TEST_CASE("Transport stats count sync timeouts", "[transport_stats]")
+{
+    nextion_stats_t counters;
+
+    nextion_transport_stats_init(&stats);
+    nextion_transport_stats_on_sync(&stats, 10, true);
+    nextion_transport_stats_on_sync(&stats, 1000, false);
+    nextion_transport_stats_get(&stats, &counters);
+
+    SIZET_EQUAL(1, counters.sync_timeouts);
+    SIZET_EQUAL(2, counters.sync_wait.count);
+}
+
+TEST_CASE("Transport stats reset", "[transport_stats]")
+{
+    nextion_stats_t counters;
+
+    nextion_transport_stats_init(&stats);
+    nextion_transport_stats_on_commands(&stats, 3);
+    nextion_transport_stats_on_write(&stats, 30);
+    nextion_transport_stats_reset(&stats);
+    nextion_transport_stats_get(&stats, &counters);
+
+    SIZET_EQUAL(0, counters.commands_sent);
+    SIZET_EQUAL(0, counters.bytes_sent);
+}
@@ -0,0 +1,137 @@
+#include <math.h>
+#include "esp32_driver_nextion/waveform_decimation.h"
+#include "common_infra_test.h"
+
+TEST_CASE("Decimate 8 bits samples keeps the peaks", "[waveform_decimation]")
+{
+    const uint8_t samples[] = {10, 200, 30, 40, 5, 60, 70, 80, 90};
+    nextion_waveform_column_t columns[3];
+
+    SIZET_EQUAL(3, nextion_waveform_decimate_u8(samples, sizeof(samples), NULL, columns, 3));
+
+    LONGS_EQUAL(10, columns[0].min);
+    LONGS_EQUAL(200, columns[0].max);
+    LONGS_EQUAL(5, columns[1].min);
+    LONGS_EQUAL(60, columns[1].max);
+    LONGS_EQUAL(70, columns[2].min);
+    LONGS_EQUAL(90, columns[2].max);
+}
+
+TEST_CASE("Decimate 16 bits samples with the full range", "[waveform_decimation]")
+{
+    const int16_t samples[] = {-32768, 0, 32767, 100};
+    nextion_waveform_column_t columns[2];
+
+    SIZET_EQUAL(2, nextion_waveform_decimate_i16(samples, 4, NULL, columns, 2));
+
+    LONGS_EQUAL(0, columns[0].min);
+    LONGS_EQUAL(128, columns[0].max);
+    LONGS_EQUAL(128, columns[1].min);
+    LONGS_EQUAL(255, columns[1].max);
+}
+
+TEST_CASE("Decimate 16 bits samples over 10 kS into 320 columns", "[waveform_decimation]")
+{
+    static int16_t samples[10000];
+    nextion_waveform_column_t columns[320];
+
+    for (size_t i = 0; i < 10000; i++)
+    {
+        samples[i] = 0;
+    }
+
+    // A single sample spike must survive.
+    samples[5003] = 32767;
+
+    SIZET_EQUAL(320, nextion_waveform_decimate_i16(samples, 10000, NULL, columns, 320));
+
+    size_t spikes = 0;
+
+    for (size_t c = 0; c < 320; c++)
+    {
+        spikes += columns[c].max == 255;
+    }
+
+    SIZET_EQUAL(1, spikes);
+    LONGS_EQUAL(255, columns[5003 * 320 / 10000].max);
+}
+
+TEST_CASE("Decimate float samples with a custom scale", "[waveform_decimation]")
+{
+    const float samples[] = {0.0f, 5.0f, 10.0f, 20.0f};
+    const nextion_waveform_scale_t scale = {.low = 0.0f, .high = 10.0f};
+    nextion_waveform_column_t columns[2];
+
+    SIZET_EQUAL(2, nextion_waveform_decimate_float(samples, 4, &scale, columns, 2));
+
+    LONGS_EQUAL(0, columns[0].min);
+    LONGS_EQUAL(128, columns[0].max);
+    LONGS_EQUAL(255, columns[1].min);
+    LONGS_EQUAL(255, columns[1].max);
+}
+
+TEST_CASE("Decimate float samples ignores NaN", "[waveform_decimation]")
+{
+    const float samples[] = {NAN, 0.5f, NAN, -0.5f};
+    nextion_waveform_column_t columns[1];
+
+    SIZET_EQUAL(1, nextion_waveform_decimate_float(samples, 4, NULL, columns, 1));
+
+    LONGS_EQUAL(64, columns[0].min);
+    LONGS_EQUAL(191, columns[0].max);
+}
+
+TEST_CASE("Decimate upside down", "[waveform_decimation]")
+{
+    const uint8_t samples[] = {0, 55};
+    const nextion_waveform_scale_t scale = {.low = 255.0f, .high = 0.0f};
+    nextion_waveform_column_t columns[1];
+
+    SIZET_EQUAL(1, nextion_waveform_decimate_u8(samples, 2, &scale, columns, 1));
+
+    LONGS_EQUAL(200, columns[0].min);
+    LONGS_EQUAL(255, columns[0].max);
+}
+
+TEST_CASE("Decimate fewer samples than columns", "[waveform_decimation]")
+{
+    const uint8_t samples[] = {1, 2, 3};
+    nextion_waveform_column_t columns[8];
+
+    SIZET_EQUAL(3, nextion_waveform_decimate_u8(samples, 3, NULL, columns, 8));
+
+    for (size_t c = 0; c < 3; c++)
+    {
+        LONGS_EQUAL(c + 1, columns[c].min);
+        LONGS_EQUAL(c + 1, columns[c].max);
+    }
+}
+
+TEST_CASE("Cannot decimate with an empty scale", "[waveform_decimation]")
+{
+    const uint8_t samples[] = {1, 2};
+    const nextion_waveform_scale_t scale = {.low = 1.0f, .high = 1.0f};
+    nextion_waveform_column_t columns[1];
+
+    SIZET_EQUAL(0, nextion_waveform_decimate_u8(samples, 2, &scale, columns, 1));
+}
+
+TEST_CASE("Cannot decimate into zero columns", "[waveform_decimation]")
+{
+    const uint8_t samples[] = {1, 2};
+    nextion_waveform_column_t columns[1];
+
+    SIZET_EQUAL(0, nextion_waveform_decimate_u8(samples, 2, NULL, columns, 0));
+}
+
+TEST_CASE("Trace sweeps each column", "[waveform_decimation]")
+{
+    const nextion_waveform_column_t columns[] = {{.min = 10, .max = 200}, {.min = 20, .max = 190}, {.min = 100, .max = 100}};
+    uint8_t values[3];
+
+    SIZET_EQUAL(3, nextion_waveform_columns_trace(columns, 3, 0, values));
+
+    LONGS_EQUAL(200, values[0]);
+    LONGS_EQUAL(20, values[1]);
+    LONGS_EQUAL(100, values[2]);
+}
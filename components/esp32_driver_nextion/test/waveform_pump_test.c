@@ -0,0 +1,146 @@
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp32_driver_nextion/waveform.h"
+#include "esp32_driver_nextion/waveform_pump.h"
+#include "common_infra_test.h"
+
+#define TEST_WAVEFORM_ID 7U
+#define TEST_PUMP_PERIOD_MS 50U
+#define TEST_PUMP_WAIT_MS 2000U
+
+static bool test_pump_wait_transactions(nextion_waveform_pump_t *pump, uint32_t transactions, nextion_waveform_pump_stats_t *stats);
+
+TEST_CASE("Pump values to a waveform", "[waveform_pump]")
+{
+    const nextion_waveform_pump_config_t config = {.waveform_id = TEST_WAVEFORM_ID, .channel_count = 2, .period_ms = TEST_PUMP_PERIOD_MS, .ring_size = 64};
+    uint8_t values[40];
+    nextion_waveform_pump_stats_t stats;
+
+    for (size_t i = 0; i < sizeof(values); i++)
+    {
+        values[i] = (uint8_t)i;
+    }
+
+    nextion_waveform_pump_t *pump = nextion_waveform_pump_create(handle, &config);
+
+    CHECK_NOT_NULL(pump);
+
+    SIZET_EQUAL(sizeof(values), nextion_waveform_pump_push(pump, 0, values, sizeof(values)));
+    SIZET_EQUAL(10, nextion_waveform_pump_push(pump, 1, values, 10));
+
+    CHECK_TRUE(test_pump_wait_transactions(pump, 2, &stats));
+    CHECK_TRUE(nextion_waveform_pump_delete(pump));
+
+    SIZET_EQUAL(50, stats.samples_queued);
+    SIZET_EQUAL(50, stats.samples_sent);
+    SIZET_EQUAL(0, stats.samples_dropped_full);
+    SIZET_EQUAL(0, stats.samples_dropped_behind);
+    SIZET_EQUAL(0, stats.transactions_failed);
+    CHECK_TRUE(stats.link_values_per_sec > 0);
+}
+
+TEST_CASE("Pump drops values not fitting the ring", "[waveform_pump]")
+{
+    const nextion_waveform_pump_config_t config = {.waveform_id = TEST_WAVEFORM_ID, .channel_count = 1, .period_ms = TEST_PUMP_PERIOD_MS, .ring_size = 8};
+    const uint8_t values[20] = {0};
+    nextion_waveform_pump_stats_t stats;
+
+    nextion_waveform_pump_t *pump = nextion_waveform_pump_create(handle, &config);
+
+    CHECK_NOT_NULL(pump);
+
+    SIZET_EQUAL(8, nextion_waveform_pump_push(pump, 0, values, sizeof(values)));
+
+    CHECK_TRUE(test_pump_wait_transactions(pump, 1, &stats));
+    CHECK_TRUE(nextion_waveform_pump_delete(pump));
+
+    SIZET_EQUAL(8, stats.samples_sent);
+    SIZET_EQUAL(12, stats.samples_dropped_full);
+}
+
+TEST_CASE("Pump drops the oldest values when behind", "[waveform_pump]")
+{
+    const nextion_waveform_pump_config_t config = {.waveform_id = TEST_WAVEFORM_ID, .channel_count = 1, .period_ms = TEST_PUMP_PERIOD_MS, .ring_size = 3 * NEX_WAVEFORM_STREAM_MAX_VALUES};
+    static uint8_t values[3 * NEX_WAVEFORM_STREAM_MAX_VALUES];
+    nextion_waveform_pump_stats_t stats;
+
+    nextion_waveform_pump_t *pump = nextion_waveform_pump_create(handle, &config);
+
+    CHECK_NOT_NULL(pump);
+
+    SIZET_EQUAL(sizeof(values), nextion_waveform_pump_push(pump, 0, values, sizeof(values)));
+
+    CHECK_TRUE(test_pump_wait_transactions(pump, 1, &stats));
+    CHECK_TRUE(nextion_waveform_pump_delete(pump));
+
+    // The first cycle sends at most one stream.
+    SIZET_EQUAL(sizeof(values), stats.samples_sent + stats.samples_dropped_behind);
+    CHECK_TRUE(stats.samples_dropped_behind >= 2 * NEX_WAVEFORM_STREAM_MAX_VALUES);
+    CHECK_TRUE(stats.batch_limit <= NEX_WAVEFORM_STREAM_MAX_VALUES);
+}
+
+TEST_CASE("Pump limit is not held down by small batches", "[waveform_pump]")
+{
+    const nextion_waveform_pump_config_t config = {.waveform_id = TEST_WAVEFORM_ID, .channel_count = 2, .period_ms = 20 * TEST_PUMP_PERIOD_MS, .ring_size = 8};
+    const uint8_t values[2] = {0};
+    nextion_waveform_pump_stats_t stats;
+
+    nextion_waveform_pump_t *pump = nextion_waveform_pump_create(handle, &config);
+
+    CHECK_NOT_NULL(pump);
+
+    SIZET_EQUAL(2, nextion_waveform_pump_push(pump, 0, values, 2));
+    SIZET_EQUAL(2, nextion_waveform_pump_push(pump, 1, values, 2));
+
+    CHECK_TRUE(test_pump_wait_transactions(pump, 2, &stats));
+    CHECK_TRUE(nextion_waveform_pump_delete(pump));
+
+    // Most of their time is the fixed cost of a transaction, not the values;
+    // counted as value cost, it would hold the limit near a hundred.
+    CHECK_TRUE(stats.batch_limit > 300);
+}
+
+TEST_CASE("Cannot pump to a channel not configured", "[waveform_pump]")
+{
+    const nextion_waveform_pump_config_t config = {.waveform_id = TEST_WAVEFORM_ID, .channel_count = 1, .period_ms = TEST_PUMP_PERIOD_MS, .ring_size = 8};
+    const uint8_t values[1] = {0};
+
+    nextion_waveform_pump_t *pump = nextion_waveform_pump_create(handle, &config);
+
+    CHECK_NOT_NULL(pump);
+
+    SIZET_EQUAL(0, nextion_waveform_pump_push(pump, 1, values, 1));
+
+    CHECK_TRUE(nextion_waveform_pump_delete(pump));
+}
+
+TEST_CASE("Cannot create pump with too many channels", "[waveform_pump]")
+{
+    const nextion_waveform_pump_config_t config = {.waveform_id = TEST_WAVEFORM_ID, .channel_count = NEX_WAVEFORM_PUMP_MAX_CHANNELS + 1, .period_ms = TEST_PUMP_PERIOD_MS, .ring_size = 8};
+
+    CHECK_NULL(nextion_waveform_pump_create(handle, &config));
+}
+
+/**
+ * @brief Wait until a pump completed some transactions.
+ * @param pump Pump pointer.
+ * @param transactions How many transactions to wait for.
+ * @param stats Location where the pump counters will be stored.
+ * @return True if they completed in time, otherwise false.
+ */
+static bool test_pump_wait_transactions(nextion_waveform_pump_t *pump, uint32_t transactions, nextion_waveform_pump_stats_t *stats)
+{
+    for (uint32_t waited = 0; waited < TEST_PUMP_WAIT_MS; waited += TEST_PUMP_PERIOD_MS)
+    {
+        vTaskDelay(pdMS_TO_TICKS(TEST_PUMP_PERIOD_MS));
+
+        nextion_waveform_pump_stats_get(pump, stats);
+
+        if (stats->transactions + stats->transactions_failed >= transactions)
+        {
+            return stats->transactions_failed == 0;
+        }
+    }
+
+    return false;
+}
@@ -95,6 +95,47 @@ TEST_CASE("Stream works", "[waveform]")
     nextion_waveform_stream_end(handle);
 }
 
+TEST_CASE("Stream buffer works", "[waveform]")
+{
+    uint8_t values[50];
+
+    for (int i = 0; i < 50; i++)
+    {
+        values[i] = i;
+    }
+
+    if (nextion_waveform_stream_begin(handle, TEST_WAVEFORM_ID, 0, 50) != NEX_OK)
+    {
+        FAIL_TEST("could not start streaming");
+    }
+
+    if (nextion_waveform_stream_write_buffer(handle, values, 50) == NEX_FAIL)
+    {
+        nextion_waveform_stream_end(handle);
+
+        FAIL_TEST("could not write values to stream");
+    }
+
+    CHECK_NEX_OK(nextion_waveform_stream_end(handle));
+}
+
+TEST_CASE("Cannot write more than expected to stream buffer", "[waveform]")
+{
+    uint8_t values[10] = {0};
+
+    if (nextion_waveform_stream_begin(handle, TEST_WAVEFORM_ID, 0, 5) != NEX_OK)
+    {
+        FAIL_TEST("could not start streaming");
+    }
+
+    nex_err_t code = nextion_waveform_stream_write_buffer(handle, values, 10);
+
+    nextion_waveform_stream_write_buffer(handle, values, 5);
+    nextion_waveform_stream_end(handle);
+
+    CHECK_NEX_FAIL(code);
+}
+
 TEST_CASE("Cannot start stream with invalid waveform", "[waveform]")
 {
     nex_err_t code = nextion_waveform_stream_begin(handle, 50, 0, 50);
@@ -128,4 +169,52 @@ TEST_CASE("Cannot end unstarted stream", "[waveform]")
     nex_err_t code = nextion_waveform_stream_end(handle);
 
     CHECK_NEX_FAIL(code);
-}
\ No newline at end of file
+}
+TEST_CASE("Push series longer than a stream", "[waveform]")
+{
+    static uint8_t values[NEX_WAVEFORM_STREAM_MAX_VALUES * 2 + 100];
+
+    for (size_t i = 0; i < sizeof(values); i++)
+    {
+        values[i] = (uint8_t)i;
+    }
+
+    nex_err_t code = nextion_waveform_push_series(handle, TEST_WAVEFORM_ID, 0, values, sizeof(values));
+
+    CHECK_NEX_OK(code);
+    CHECK_NEX_OK(nextion_command_send(handle, "page 0"));
+}
+
+TEST_CASE("Push series shorter than a stream", "[waveform]")
+{
+    const uint8_t values[] = {10, 20, 30};
+
+    nex_err_t code = nextion_waveform_push_series(handle, TEST_WAVEFORM_ID, 1, values, sizeof(values));
+
+    CHECK_NEX_OK(code);
+}
+
+TEST_CASE("Push empty series", "[waveform]")
+{
+    const uint8_t values[] = {0};
+
+    nex_err_t code = nextion_waveform_push_series(handle, TEST_WAVEFORM_ID, 0, values, 0);
+
+    CHECK_NEX_OK(code);
+}
+
+TEST_CASE("Cannot push series to invalid waveform", "[waveform]")
+{
+    const uint8_t values[] = {10, 20, 30};
+
+    nex_err_t code = nextion_waveform_push_series(handle, 50, 0, values, sizeof(values));
+
+    NEX_CODES_EQUAL(NEX_DVC_ERR_INVALID_WAVEFORM, code);
+}
+
+TEST_CASE("Cannot push null series", "[waveform]")
+{
+    nex_err_t code = nextion_waveform_push_series(handle, TEST_WAVEFORM_ID, 0, NULL, 10);
+
+    CHECK_NEX_FAIL(code);
+}
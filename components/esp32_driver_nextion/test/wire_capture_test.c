@@ -0,0 +1,148 @@
+#include <stdlib.h>
+#include <string.h>
+#include "wire_capture.h"
+#include "common_infra_test.h"
+
+// The ring holds nothing when the capture is disabled.
+#if CONFIG_NEX_WIRE_CAPTURE_SIZE > 0
+
+/**
+ * @brief What the visitor of the tests saw.
+ */
+typedef struct
+{
+    size_t calls;
+    size_t bytes;
+    int64_t first_timestamp;
+    nextion_wire_capture_direction_t directions[4];
+    uint8_t data[64];
+} wire_capture_seen_t;
+
+static nextion_wire_capture_t capture;
+
+static void wire_capture_visit(void *context, nextion_wire_capture_direction_t direction, int64_t timestamp_us, const uint8_t *bytes, size_t length)
+{
+    wire_capture_seen_t *seen = (wire_capture_seen_t *)context;
+
+    if (seen->calls == 0)
+    {
+        seen->first_timestamp = timestamp_us;
+    }
+
+    if (seen->calls < 4)
+    {
+        seen->directions[seen->calls] = direction;
+    }
+
+    if (seen->bytes + length <= sizeof(seen->data))
+    {
+        memcpy(seen->data + seen->bytes, bytes, length);
+    }
+
+    seen->calls++;
+    seen->bytes += length;
+}
+
+TEST_CASE("Wire capture starts empty", "[wire_capture]")
+{
+    wire_capture_seen_t seen = {0};
+
+    nextion_wire_capture_init(&capture);
+
+    SIZET_EQUAL(0, nextion_wire_capture_read(&capture, wire_capture_visit, &seen));
+    SIZET_EQUAL(0, seen.calls);
+}
+
+TEST_CASE("Wire capture keeps order and direction", "[wire_capture]")
+{
+    const uint8_t command[] = {'p', 'a', 'g', 'e', ' ', '0', 0xFF, 0xFF, 0xFF};
+    const uint8_t ack[] = {0x01, 0xFF, 0xFF, 0xFF};
+    wire_capture_seen_t seen = {0};
+
+    nextion_wire_capture_init(&capture);
+    nextion_wire_capture_record(&capture, NEX_WIRE_CAPTURE_TX, 1000, command, sizeof(command));
+    nextion_wire_capture_record(&capture, NEX_WIRE_CAPTURE_RX, 2000, ack, sizeof(ack));
+
+    SIZET_EQUAL(2, nextion_wire_capture_read(&capture, wire_capture_visit, &seen));
+    SIZET_EQUAL(2, seen.calls);
+    LONGS_EQUAL(1000, seen.first_timestamp);
+    LONGS_EQUAL(NEX_WIRE_CAPTURE_TX, seen.directions[0]);
+    LONGS_EQUAL(NEX_WIRE_CAPTURE_RX, seen.directions[1]);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(command, seen.data, sizeof(command));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(ack, seen.data + sizeof(command), sizeof(ack));
+}
+
+TEST_CASE("Wire capture hands long runs in pieces", "[wire_capture]")
+{
+    uint8_t run[NEX_WIRE_CAPTURE_VISIT_LENGTH + 8];
+    wire_capture_seen_t seen = {0};
+
+    for (size_t i = 0; i < sizeof(run); i++)
+    {
+        run[i] = (uint8_t)i;
+    }
+
+    nextion_wire_capture_init(&capture);
+    nextion_wire_capture_record(&capture, NEX_WIRE_CAPTURE_RX, 5, run, sizeof(run));
+
+    SIZET_EQUAL(1, nextion_wire_capture_read(&capture, wire_capture_visit, &seen));
+    SIZET_EQUAL(2, seen.calls);
+    SIZET_EQUAL(sizeof(run), seen.bytes);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(run, seen.data, sizeof(run));
+}
+
+TEST_CASE("Wire capture overwrites the oldest", "[wire_capture]")
+{
+    uint8_t run[100] = {0};
+    const size_t total = CONFIG_NEX_WIRE_CAPTURE_SIZE / sizeof(run) * 2;
+    wire_capture_seen_t seen = {0};
+
+    nextion_wire_capture_init(&capture);
+
+    for (size_t i = 0; i < total; i++)
+    {
+        nextion_wire_capture_record(&capture, NEX_WIRE_CAPTURE_TX, (int64_t)i, run, sizeof(run));
+    }
+
+    size_t records = nextion_wire_capture_read(&capture, wire_capture_visit, &seen);
+
+    CHECK_TRUE(records > 0);
+    SIZET_EQUAL(total, records + capture.overwritten);
+    LONGS_EQUAL(capture.overwritten, seen.first_timestamp);
+    CHECK_TRUE(capture.used <= CONFIG_NEX_WIRE_CAPTURE_SIZE);
+}
+
+TEST_CASE("Wire capture clear", "[wire_capture]")
+{
+    const uint8_t ack[] = {0x01, 0xFF, 0xFF, 0xFF};
+    wire_capture_seen_t seen = {0};
+
+    nextion_wire_capture_init(&capture);
+    nextion_wire_capture_record(&capture, NEX_WIRE_CAPTURE_RX, 1, ack, sizeof(ack));
+    nextion_wire_capture_clear(&capture);
+
+    SIZET_EQUAL(0, nextion_wire_capture_read(&capture, wire_capture_visit, &seen));
+}
+
+TEST_CASE("Dump wire capture", "[wire_capture]")
+{
+    char *output = NULL;
+    size_t size = 0;
+    FILE *stream = open_memstream(&output, &size);
+
+    nextion_command_send(handle, "page 0");
+
+    nex_err_t result = nextion_capture_dump(handle, stream);
+
+    fclose(stream);
+
+    CHECK_NEX_OK(result);
+    CHECK_NOT_NULL(strstr(output, "nexcap begin\n"));
+    CHECK_NOT_NULL(strstr(output, " tx 706167652030FFFFFF\n"));
+    CHECK_NOT_NULL(strstr(output, " rx 01FFFFFF\n"));
+    CHECK_NOT_NULL(strstr(output, "nexcap end "));
+
+    free(output);
+}
+
+#endif
@@ -47,6 +47,7 @@
 #include "esp32_driver_nextion/nextion.h"
 #include "esp32_driver_nextion/page.h"
 #include "esp32_driver_nextion/component.h"
+#include "esp32_driver_nextion/screen.h"
 
 #define TAG "app"
 
@@ -64,8 +65,10 @@ int time = 10;
 bool cal = false;
 static void callback_touch_event(nextion_on_touch_event_t event);
 static void process_callback_queue(void *pvParameters);
+static void show_exposure_screen(nextion_t *nextion_handle);
 
 bool isExposing = false;
+int progress = 0;
 
 void play_sound(void *pvParameters)
 {
@@ -99,21 +102,8 @@ void countdownTask(void *pvParameters)
             gpio_set_level(RELAY_PIN, 0);
             time = initialTime;
             isExposing = false;
-            int minutes = time / 60;
-            int seconds = time % 60;
-            nextion_component_set_value(nextion_handle, "n0", minutes);
-            nextion_component_set_value(nextion_handle, "n1", seconds);
-            nextion_component_set_text(nextion_handle, "b0", "Start Exposure");
-            nextion_component_set_visibility(nextion_handle, "b1", true);
-            nextion_component_set_visibility(nextion_handle, "b2", true);
-            nextion_component_set_visibility(nextion_handle, "b3", true);
-            nextion_component_set_visibility(nextion_handle, "b4", true);
-            nextion_component_set_visibility(nextion_handle, "b5", true);
-            nextion_component_set_visibility(nextion_handle, "b6", true);
-            nextion_component_set_visibility(nextion_handle, "b7", true);
-            nextion_component_set_visibility(nextion_handle, "bt0", true);
-            nextion_component_set_visibility(nextion_handle, "j0", false);
-            nextion_component_set_value(nextion_handle, "j0", 0);
+            progress = 0;
+            show_exposure_screen(nextion_handle);
 
             vTaskDelete(NULL);
         }
@@ -124,31 +114,15 @@ void countdownTask(void *pvParameters)
         }
         count++;
         time--;
-        nextion_component_set_value(nextion_handle, "j0", ((float)(initialTime - time)) / initialTime * 100);
-        int minutes = time / 60;
-        int seconds = time % 60;
-        nextion_component_set_value(nextion_handle, "n0", minutes);
-        nextion_component_set_value(nextion_handle, "n1", seconds);
+        progress = ((float)(initialTime - time)) / initialTime * 100;
+        show_exposure_screen(nextion_handle);
         vTaskDelay(1000 / portTICK_PERIOD_MS);
     }
     gpio_set_level(RELAY_PIN, 0);
     time = initialTime;
     isExposing = false;
-    int minutes = time / 60;
-    int seconds = time % 60;
-    nextion_component_set_value(nextion_handle, "n0", minutes);
-    nextion_component_set_value(nextion_handle, "n1", seconds);
-    nextion_component_set_text(nextion_handle, "b0", "Start Exposure");
-    nextion_component_set_visibility(nextion_handle, "b1", true);
-    nextion_component_set_visibility(nextion_handle, "b2", true);
-    nextion_component_set_visibility(nextion_handle, "b3", true);
-    nextion_component_set_visibility(nextion_handle, "b4", true);
-    nextion_component_set_visibility(nextion_handle, "b5", true);
-    nextion_component_set_visibility(nextion_handle, "b6", true);
-    nextion_component_set_visibility(nextion_handle, "b7", true);
-    nextion_component_set_visibility(nextion_handle, "bt0", true);
-    nextion_component_set_visibility(nextion_handle, "j0", false);
-    nextion_component_set_value(nextion_handle, "j0", 0);
+    progress = 0;
+    show_exposure_screen(nextion_handle);
     xTaskCreate(play_sound, "Play Sound", 2048, (void *)1, 5, NULL);
     vTaskDelete(NULL);
 }
@@ -213,11 +187,7 @@ void app_main()
                                         callback_touch_event);
 
     // Go to page with id 0.
-    nextion_page_set(nextion_handle, "0");
-    int minutes = time / 60;
-    int seconds = time % 60;
-    nextion_component_set_value(nextion_handle, "n0", minutes);
-    nextion_component_set_value(nextion_handle, "n1", seconds);
+    show_exposure_screen(nextion_handle);
 
     // Start a task that will handle touch notifications.
     xTaskCreate(process_callback_queue,
@@ -260,33 +230,12 @@ static void callback_touch_event(nextion_on_touch_event_t event)
         switch (button)
         {
         case 3:
+            isExposing = !isExposing;
+            progress = 0;
+            // Both ways the screen changes now; the countdown task only notices a stop on its next tick.
+            show_exposure_screen(nextion_handle);
             if (isExposing)
             {
-                nextion_component_set_text(nextion_handle, "b0", "Start Exposure");
-                nextion_component_set_visibility(nextion_handle, "b1", true);
-                nextion_component_set_visibility(nextion_handle, "b2", true);
-                nextion_component_set_visibility(nextion_handle, "b3", true);
-                nextion_component_set_visibility(nextion_handle, "b4", true);
-                nextion_component_set_visibility(nextion_handle, "b5", true);
-                nextion_component_set_visibility(nextion_handle, "b6", true);
-                nextion_component_set_visibility(nextion_handle, "b7", true);
-                nextion_component_set_visibility(nextion_handle, "bt0", true);
-                nextion_component_set_visibility(nextion_handle, "j0", false);
-                isExposing = !isExposing;
-            }
-            else
-            {
-                nextion_component_set_text(nextion_handle, "b0", "Stop Exposure");
-                nextion_component_set_visibility(nextion_handle, "b1", false);
-                nextion_component_set_visibility(nextion_handle, "b2", false);
-                nextion_component_set_visibility(nextion_handle, "b3", false);
-                nextion_component_set_visibility(nextion_handle, "b4", false);
-                nextion_component_set_visibility(nextion_handle, "b5", false);
-                nextion_component_set_visibility(nextion_handle, "b6", false);
-                nextion_component_set_visibility(nextion_handle, "b7", false);
-                nextion_component_set_visibility(nextion_handle, "bt0", false);
-                nextion_component_set_visibility(nextion_handle, "j0", true);
-                isExposing = !isExposing;
                 xTaskCreate(countdownTask, "Countdown Task", 2048, (void *)nextion_handle, 5, NULL);
             }
             break;
@@ -319,9 +268,32 @@ static void callback_touch_event(nextion_on_touch_event_t event)
         }
         ESP_LOGI(TAG, "Time: %d", time);
         nvs_set_i32(my_nvs_handle, "time", time);
-        int minutes = time / 60;
-        int seconds = time % 60;
-        nextion_component_set_value(nextion_handle, "n0", minutes);
-        nextion_component_set_value(nextion_handle, "n1", seconds);
+        show_exposure_screen(nextion_handle);
     }
 }
+
+// Shows the time setting buttons while idle, or the progress bar while exposing.
+// Only what changed since the last call is sent to the display.
+static void show_exposure_screen(nextion_t *nextion_handle)
+{
+    const nextion_screen_item_t items[] = {
+        NEXTION_SCREEN_TEXT("b0", "txt", isExposing ? "Stop Exposure" : "Start Exposure"),
+        NEXTION_SCREEN_VISIBILITY("b1", !isExposing),
+        NEXTION_SCREEN_VISIBILITY("b2", !isExposing),
+        NEXTION_SCREEN_VISIBILITY("b3", !isExposing),
+        NEXTION_SCREEN_VISIBILITY("b4", !isExposing),
+        NEXTION_SCREEN_VISIBILITY("b5", !isExposing),
+        NEXTION_SCREEN_VISIBILITY("b6", !isExposing),
+        NEXTION_SCREEN_VISIBILITY("b7", !isExposing),
+        NEXTION_SCREEN_VISIBILITY("bt0", !isExposing),
+        NEXTION_SCREEN_VISIBILITY("j0", isExposing),
+        NEXTION_SCREEN_NUMBER("j0", "val", progress),
+        NEXTION_SCREEN_NUMBER("n0", "val", time / 60),
+        NEXTION_SCREEN_NUMBER("n1", "val", time % 60)};
+    const nextion_screen_t screen = {
+        .page = "0",
+        .items = items,
+        .item_count = sizeof(items) / sizeof(items[0])};
+
+    nextion_screen_apply(nextion_handle, &screen);
+}